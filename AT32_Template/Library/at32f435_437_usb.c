@@ -381,6 +381,7 @@ void USB_Open_PHY_CLK(OTG_Global_Type *usbx) {
 
 /**
   * @brief  write data from user memory to usb buffer
+  * @note   4 字节对齐的缓冲区按字直接搬运, 收发大包时缓冲区应按字对齐
   * @param  pusr_buf: point to user buffer
   * @param  offset_Addr: endpoint tx offset address
   * @param  nbytes: number of bytes data write to usb buffer
@@ -390,6 +391,24 @@ void USB_Write_Packet(OTG_Global_Type *usbx, uint8_t *pusr_buf, uint16_t num, ui
     uint32_t n_index;
     uint32_t nhbytes = (nbytes + 3) / 4;
     uint32_t *pbuf = (uint32_t *)pusr_buf;
+    __IO uint32_t *pfifo = &USB_FIFO(usbx, num);
+
+    /* word aligned buffer: plain word copy, four words per loop */
+    if(((uint32_t)pusr_buf & 3) == 0) {
+        for(n_index = nhbytes >> 2; n_index > 0; n_index --) {
+            *pfifo = pbuf[0];
+            *pfifo = pbuf[1];
+            *pfifo = pbuf[2];
+            *pfifo = pbuf[3];
+            pbuf += 4;
+        }
+
+        for(n_index = nhbytes & 3; n_index > 0; n_index --) {
+            *pfifo = *pbuf ++;
+        }
+
+        return;
+    }
 
     for(n_index = 0; n_index < nhbytes; n_index ++) {
         #if defined (__ICCARM__) && (__VER__ < 7000000)
@@ -403,6 +422,7 @@ void USB_Write_Packet(OTG_Global_Type *usbx, uint8_t *pusr_buf, uint16_t num, ui
 
 /**
   * @brief  read data from usb buffer to user buffer
+  * @note   4 字节对齐的缓冲区按字直接搬运, 收发大包时缓冲区应按字对齐
   * @param  pusr_buf: point to user buffer
   * @param  offset_Addr: endpoint rx offset address
   * @param  nbytes: number of bytes data write to usb buffer
@@ -412,6 +432,24 @@ void USB_Read_Packet(OTG_Global_Type *usbx, uint8_t *pusr_buf, uint16_t num, uin
     uint32_t n_index;
     uint32_t nhbytes = (nbytes + 3) / 4;
     uint32_t *pbuf = (uint32_t *)pusr_buf;
+    __IO uint32_t *pfifo = &USB_FIFO(usbx, 0);
+
+    /* word aligned buffer: plain word copy, four words per loop */
+    if(((uint32_t)pusr_buf & 3) == 0) {
+        for(n_index = nhbytes >> 2; n_index > 0; n_index --) {
+            pbuf[0] = *pfifo;
+            pbuf[1] = *pfifo;
+            pbuf[2] = *pfifo;
+            pbuf[3] = *pfifo;
+            pbuf += 4;
+        }
+
+        for(n_index = nhbytes & 3; n_index > 0; n_index --) {
+            *pbuf ++ = *pfifo;
+        }
+
+        return;
+    }
 
     for(n_index = 0; n_index < nhbytes; n_index ++) {
         #if defined (__ICCARM__) && (__VER__ < 7000000)
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/usb_fifo.c 的主机测试: 用主机编译器编译 usb_fifo.c 和一个读标准输入的驱动,
+at32f435_437.h 换成只含端点类型/方向和 FIFO 寄存器的桩, USB_Set_RX_FIFO/USB_Set_TX_FIFO
+按 at32f435_437_usb.c 的方式累加起始地址.
+
+    usb_fifo_test.py [--cc gcc] [--seed 1] [--count 20000]
+        1. 手算的典型配置(只有端点 0、CDC、等时音频、非 4 字节整数倍的包长、等时优先、
+           FIFO RAM 放不下额外包)逐字比较分配结果;
+        2. 非法配置(端点号越界、包长为 0、批量包长 65、等时包长 1024、最低要求超过 FIFO RAM)
+           必须返回 ERROR;
+        3. 随机端点组合(包长 1~1023 含各种 4 字节对齐余数, FIFO RAM 48~1023 字)检查:
+           - 返回值: 配置合法且最低要求不超过 FIFO RAM 时 SUCCESS, 否则 ERROR;
+           - 每个 IN 端点至少一包(字数向上取整)且不小于 USBFIFO_TX_MIN, 未使用的为 0,
+             端点 0 总有发送 FIFO; 中断/控制端点不多分, 等时/批量端点按整包增加且不超过包数上限;
+           - 接收 FIFO 不小于手册公式; 各 FIFO 之和与 Used 都等于 FIFO RAM;
+           - 等时端点没分满时, 等时分配结束后剩余的空间放不下它的一包;
+             批量端点没分满时, 最后给接收 FIFO 的剩余空间放不下它的一包;
+           - USBFifo_Apply 后各 FIFO 起始地址首尾相接, 不重叠, 结束于 FIFO RAM 末尾.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 usb_fifo.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'User', 'BSP', 'usb_fifo.c')
+HEADER = os.path.join(ROOT, 'User', 'BSP', 'usb_fifo.h')
+USB_LIB = os.path.join(ROOT, 'Library', 'at32f435_437_usb.h')
+MAX_REPORT = 20
+ERROR, SUCCESS = 0, 1
+
+# 代替 at32f435_437.h, 端点类型/方向和 OTG_FIFO_SIZE 从库头文件中摘出
+STUB = r'''
+#ifndef __AT32F435_437_H
+#define __AT32F435_437_H
+#include <stdint.h>
+typedef enum {ERROR = 0, SUCCESS = !ERROR} error_status;
+%s
+typedef struct {
+    uint32_t grxfsiz;
+    uint32_t gnptxfsiz_ept0tx;
+    uint32_t dieptxfn[7];
+} OTG_Global_Type;
+void USB_Set_RX_FIFO(OTG_Global_Type *usbx, uint16_t size);
+void USB_Set_TX_FIFO(OTG_Global_Type *usbx, uint8_t txfifo, uint16_t size);
+void USB_Flush_TX_FIFO(OTG_Global_Type *usbx, uint32_t fifo_Num);
+void USB_Flush_RX_FIFO(OTG_Global_Type *usbx);
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include "usb_fifo.h"
+
+static int flushed;
+
+/* 与 at32f435_437_usb.c 相同: 起始地址为接收 FIFO 与前面各发送 FIFO 深度之和 */
+void USB_Set_RX_FIFO(OTG_Global_Type *usbx, uint16_t size) {
+    usbx->grxfsiz = size;
+}
+
+void USB_Set_TX_FIFO(OTG_Global_Type *usbx, uint8_t txfifo, uint16_t size) {
+    uint32_t offset = usbx->grxfsiz;
+    uint8_t i;
+
+    if (txfifo == 0) {
+        usbx->gnptxfsiz_ept0tx = offset | ((uint32_t)size << 16);
+    } else {
+        offset += usbx->gnptxfsiz_ept0tx >> 16;
+
+        for (i = 0; i < txfifo - 1; i++) {
+            offset += usbx->dieptxfn[i] >> 16;
+        }
+
+        usbx->dieptxfn[txfifo - 1] = offset | ((uint32_t)size << 16);
+    }
+}
+
+void USB_Flush_TX_FIFO(OTG_Global_Type *usbx, uint32_t fifo_Num) {
+    (void)usbx;
+    flushed |= fifo_Num == 16 ? 1 : 4;
+}
+
+void USB_Flush_RX_FIFO(OTG_Global_Type *usbx) {
+    (void)usbx;
+    flushed |= 2;
+}
+
+int main(void) {
+    USBFifo_Ept epts[32];
+    USBFifo_Layout layout;
+    OTG_Global_Type otg;
+    unsigned long total, num, a[4], i;
+    error_status ret;
+
+    while (scanf("%lu %lu", &total, &num) == 2) {
+        if (num > 32) return 2;
+
+        for (i = 0; i < num; i++) {
+            if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 2;
+            epts[i].Ept = (uint8_t)a[0];
+            epts[i].Dir = (uint8_t)a[1];
+            epts[i].Type = (uint8_t)a[2];
+            epts[i].MaxPacket = (uint16_t)a[3];
+        }
+
+        ret = USBFifo_Plan(epts, (uint8_t)num, (uint16_t)total, &layout);
+        printf("%d %u", ret == SUCCESS, layout.Rx);
+
+        for (i = 0; i < USBFIFO_EPT_NUM; i++) printf(" %u", layout.Tx[i]);
+
+        printf(" %u", layout.Used);
+
+        if (ret == SUCCESS) {
+            otg.grxfsiz = 0xFFFFU;
+            otg.gnptxfsiz_ept0tx = 0;
+            for (i = 0; i < 7; i++) otg.dieptxfn[i] = 0xFFFFFFFFUL;
+            flushed = 0;
+            USBFifo_Apply(&otg, &layout);
+            printf(" | %d %lu %lu", flushed, (unsigned long)otg.grxfsiz, (unsigned long)otg.gnptxfsiz_ept0tx);
+            for (i = 0; i < 7; i++) printf(" %lu", (unsigned long)otg.dieptxfn[i]);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}
+'''
+
+CTRL, ISO, BULK, INT = 0, 1, 2, 3
+IN, OUT = 0, 1
+
+
+def words(n):
+    return (n + 3) // 4
+
+
+def header_consts():
+    with open(HEADER, encoding='utf-8') as f:
+        text = f.read()
+    c = {k: int(v) for k, v in re.findall(r'#define\s+(USBFIFO_\w+)\s+(\d+)', text)}
+    return c['USBFIFO_EPT_NUM'], c['USBFIFO_TX_MIN'], c['USBFIFO_TX_PACKETS'], c['USBFIFO_RX_PACKETS']
+
+
+EPT_NUM, TX_MIN, TX_PACKETS, RX_PACKETS = header_consts()
+
+
+def ep0(mp=64):
+    return [(0, IN, CTRL, mp), (0, OUT, CTRL, mp)]
+
+
+# (名称, FIFO RAM, 端点, 期望结果 None 或 (Rx, Tx[0..7]))
+GOLDEN = [
+    ('只有端点 0', 320, ep0(), (304, [16, 0, 0, 0, 0, 0, 0, 0])),
+    ('CDC', 320, ep0() + [(1, IN, BULK, 64), (1, OUT, BULK, 64), (2, IN, INT, 8)],
+     (224, [16, 64, 16, 0, 0, 0, 0, 0])),
+    ('等时 IN 1023 字节', 320, ep0() + [(1, IN, ISO, 1023)], (48, [16, 256, 0, 0, 0, 0, 0, 0])),
+    ('非对齐包长', 320, ep0() + [(2, IN, ISO, 13), (3, IN, BULK, 63), (3, OUT, BULK, 61)],
+     (224, [16, 0, 16, 64, 0, 0, 0, 0])),
+    ('等时优先', 320, ep0() + [(1, IN, ISO, 100), (2, IN, BULK, 64)], (140, [16, 100, 64, 0, 0, 0, 0, 0])),
+    ('额外包放不下', 130, ep0() + [(1, IN, ISO, 100), (2, IN, BULK, 64)], (32, [16, 50, 32, 0, 0, 0, 0, 0])),
+    ('端点 0 只配 OUT', 64, [(0, OUT, CTRL, 8)], (48, [16, 0, 0, 0, 0, 0, 0, 0])),
+    ('等时 IN/OUT 各 1023 字节', 320, ep0() + [(1, IN, ISO, 1023), (1, OUT, ISO, 1023)], None),
+    ('端点号 8', 320, ep0() + [(8, IN, BULK, 64)], None),
+    ('包长 0', 320, ep0() + [(1, IN, INT, 0)], None),
+    ('批量包长 65', 320, ep0() + [(1, OUT, BULK, 65)], None),
+    ('等时包长 1024', 320, ep0() + [(1, IN, ISO, 1024)], None),
+]
+
+
+def query(total, epts):
+    return '%d %d\n' % (total, len(epts)) + ''.join('%d %d %d %d\n' % e for e in epts)
+
+
+def parse(line):
+    plan, _, apply = line.partition('|')
+    v = [int(x) for x in plan.split()]
+    return v[0], v[1], v[2:2 + EPT_NUM], v[2 + EPT_NUM], [int(x) for x in apply.split()]
+
+
+def expect_min(epts):
+    """按端点表求各 FIFO 的最低深度; 配置非法时返回 None"""
+    tx = [0] * EPT_NUM
+    base = {}
+    num_ctrl = num_out = max_out = 0
+    for ept, d, typ, mp in epts:
+        if ept >= EPT_NUM or mp == 0 or mp > (1023 if typ == ISO else 64):
+            return None
+        if d == IN:
+            tx[ept] = max(words(mp), TX_MIN)
+            base[ept] = (typ, words(mp), tx[ept])
+        else:
+            num_out += 1
+            num_ctrl += typ == CTRL
+            max_out = max(max_out, mp)
+    if tx[0] == 0:
+        tx[0] = TX_MIN
+    rx = (4 * num_ctrl + 6) + (words(max_out) + 1) + 2 * num_out + 1
+    return rx, tx, base
+
+
+def check_random(total, epts, res):
+    """返回差异描述列表"""
+    ok, rx, tx, used, regs = res
+    m = expect_min(epts)
+    errs = []
+    if m is None:
+        return ['非法配置返回 SUCCESS'] if ok else []
+    rx_min, tx_min, base = m
+    if rx_min + sum(tx_min) > total:
+        return ['最低要求 %d 字超过 %d 字却返回 SUCCESS' % (rx_min + sum(tx_min), total)] if ok else []
+    if not ok:
+        return ['合法配置返回 ERROR']
+    if rx + sum(tx) != total or used != total:
+        errs.append('总和 %d, Used %d, 应为 %d' % (rx + sum(tx), used, total))
+    if rx < rx_min:
+        errs.append('接收 FIFO %d 字小于最低 %d 字' % (rx, rx_min))
+    iso_extra = 0
+    short_iso, short_bulk = [], []
+    for i in range(EPT_NUM):
+        if i not in base:
+            if tx[i] != (TX_MIN if i == 0 else 0):
+                errs.append('未使用的端点 %d 发送 FIFO 为 %d 字' % (i, tx[i]))
+            continue
+        typ, pkt, lo = base[i]
+        if typ not in (ISO, BULK):
+            if tx[i] != lo:
+                errs.append('端点 %d 发送 FIFO %d 字, 应为 %d 字' % (i, tx[i], lo))
+            continue
+        extra = tx[i] - lo
+        packets = lo // pkt + extra // pkt
+        if extra < 0 or extra % pkt != 0 or (extra and packets > TX_PACKETS):
+            errs.append('端点 %d 发送 FIFO %d 字不是最低 %d 字加整包(%d 字)' % (i, tx[i], lo, pkt))
+            continue
+        if typ == ISO:
+            iso_extra += extra
+        if packets < TX_PACKETS:
+            (short_iso if typ == ISO else short_bulk).append((i, pkt))
+    free_after_iso = total - rx_min - sum(tx_min) - iso_extra
+    for i, pkt in short_iso:
+        if free_after_iso >= pkt:
+            errs.append('等时端点 %d 未分满, 但等时分配后还剩 %d 字' % (i, free_after_iso))
+    wb = max([words(e[3]) for e in epts if e[1] == OUT and e[2] in (ISO, BULK)] or [0])
+    for i, pkt in short_bulk:
+        left = [rx - rx_min - k * wb for k in range(RX_PACKETS) if rx - rx_min - k * wb >= 0]
+        if left and all(v >= pkt for v in left):
+            errs.append('批量端点 %d 未分满, 但最后剩余 %d 字' % (i, min(left)))
+    if len(regs) != 2 + EPT_NUM:
+        errs.append('USBFifo_Apply 输出异常')
+        return errs
+    flushed, grx, regs = regs[0], regs[1], regs[2:]
+    if flushed != 3:
+        errs.append('USBFifo_Apply 没有清空全部 FIFO')
+    if grx != rx:
+        errs.append('接收 FIFO 寄存器 %d, 应为 %d' % (grx, rx))
+    addr = rx
+    for i, r in enumerate(regs):
+        start, depth = r & 0xFFFF, r >> 16
+        if depth != tx[i] or start != addr:
+            errs.append('发送 FIFO %d 起始 %d 深度 %d, 应为 %d/%d' % (i, start, depth, addr, tx[i]))
+            break
+        addr += depth
+    if addr != total:
+        errs.append('FIFO 结束于 %d, 应为 %d' % (addr, total))
+    return errs
+
+
+def gen(rnd):
+    epts = [] if rnd.random() < 0.05 else ep0(rnd.choice((8, 16, 32, 64)))
+    for ept in rnd.sample(range(1, EPT_NUM), rnd.randrange(0, EPT_NUM)):
+        for d in (IN, OUT):
+            if rnd.random() < 0.5:
+                continue
+            typ = rnd.choice((ISO, BULK, BULK, INT))
+            limit = 1023 if typ == ISO else 64
+            mp = rnd.choice((rnd.randrange(1, limit + 1), limit, limit - 1, 4 * rnd.randrange(1, limit // 4 + 1) + 1))
+            if rnd.random() < 0.02:
+                mp = rnd.choice((0, limit + 1))
+            epts.append((ept, d, typ, min(mp, 0xFFFF)))
+    if rnd.random() < 0.02:
+        epts.append((rnd.choice((8, 15, 255)), IN, BULK, 64))
+    rnd.shuffle(epts)
+    return rnd.choice((64, 128, 320, 320, 512, rnd.randrange(48, 1024))), epts
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--count', type=int, default=20000)
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp()
+    try:
+        with open(USB_LIB, encoding='utf-8') as f:
+            lib = f.read()
+        consts = ['#define %s %s' % kv for kv in re.findall(
+            r'\b(EPT_(?:Control|ISO|BULK|INT)_Type|EPT_Dir_IN|EPT_Dir_Out)\s*=\s*(0x[0-9A-Fa-f]+|\d+)', lib)]
+        consts += re.findall(r'#define\s+OTG_FIFO_SIZE\s+\d+', lib)
+        with open(os.path.join(tmp, 'at32f435_437.h'), 'w', encoding='utf-8') as f:
+            f.write(STUB % '\n'.join(consts))
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'driver')
+        with open(driver, 'w', encoding='utf-8') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-Werror', '-I', tmp,
+               '-I', os.path.dirname(SOURCE), SOURCE, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        rnd = random.Random(args.seed)
+        cases = [(t, e) for _, t, e, _ in GOLDEN] + [gen(rnd) for _ in range(args.count)]
+        r = subprocess.run([exe], input=''.join(query(t, e) for t, e in cases), stdout=subprocess.PIPE,
+                           universal_newlines=True)
+        lines = r.stdout.splitlines()
+        if r.returncode != 0 or len(lines) != len(cases):
+            print('驱动异常退出: 返回 %d' % r.returncode)
+            return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    bad = 0
+    for (name, total, epts, want), line in zip(GOLDEN, lines):
+        ok, rx, tx, _, _ = parse(line)
+        got = (rx, tx) if ok else None
+        if got != want:
+            if bad < MAX_REPORT:
+                print('%s: 得到 %s, 应为 %s' % (name, got, want))
+            bad += 1
+    golden_bad = bad
+
+    stats = [0, 0]
+    for (total, epts), line in zip(cases, lines):
+        res = parse(line)
+        stats[res[0]] += 1
+        errs = check_random(total, epts, res)
+        if errs:
+            if bad < MAX_REPORT:
+                print('FIFO RAM %d 字, 端点 %s: %s' % (total, epts, '; '.join(errs)))
+            bad += 1
+
+    print('典型配置 %d 项, 差异 %d 项; 随机配置 %d 项(SUCCESS %d, ERROR %d), 差异 %d 项' % (
+        len(GOLDEN), golden_bad, len(cases), stats[1], stats[0], bad - golden_bad))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,600 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : cam_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DVP 摄像头采集引擎
+                   1. 帧模式: eDMA 普通模式, 一次传完一帧后在传输完成中断里切到另一块缓冲,
+                      帧消隐期内完成重装, 不丢数据; Cam_Process 正在使用的缓冲不会被 DMA 选中,
+                      两块都不可用时覆盖刚采完的帧并计一次丢帧;
+                   2. 行模式: eDMA 双缓冲模式, 每完成一块就把空闲的地址寄存器改到环里的下一块,
+                      DMA 自身不停; 环满时改写到丢弃区, 不阻塞 DVP;
+                   3. 每帧结束(DVP CFD)核对 DMA 位置, 帧长与配置不符时在消隐期重装 DMA,
+                      一帧错位不会带到后面的帧; FIFO 溢出丢了字, 本帧余下的数据整体错位,
+                      作废到帧结束再重装;
+                   4. 中断只做缓冲调度, 回调都在 Cam_Process(主循环)中执行.
+                   调度逻辑与 STM32_Template/Hardware/cam_capture.c 相同, 后者在主机上有
+                   寄存器模型测试(Tools/cam_pipeline_sim.py), 改动调度时两边同步.
+  * Function List:
+
+  **********************************************************
+ */
+#include "cam_capture.h"
+#include "string.h"
+
+/* 板级引脚(复用 13): PA4 HSYNC, PA6 PCLK, PB7 VSYNC, PC6/PC7/PC8/PC9/PC11 D0~D4, PB6 D5, PE5/PE6 D6/D7 */
+static GPIO_Type *const cam_pin_port[] = {GPIOA, GPIOA, GPIOB, GPIOC, GPIOC, GPIOC, GPIOC, GPIOC, GPIOB, GPIOE, GPIOE};
+static const uint8_t cam_pin_source[] = {4, 6, 7, 6, 7, 8, 9, 11, 6, 5, 6};
+
+static Cam_Config cam_cfg;
+static Cam_Stats cam_stats;
+static uint32_t cam_block_bytes;
+static uint32_t cam_xfer_words;                 //一次 DMA 传输的字数: 帧模式一帧, 行模式一块
+static volatile uint8_t cam_skip;               //FIFO 溢出后到帧结束前写满的数据作废
+static volatile uint8_t cam_snap;               //帧进行中收到的快照请求, 帧结束时补发
+
+/* 帧模式 */
+static int8_t cam_filling;                      //DMA 正在写的缓冲
+static volatile int8_t cam_ready;               //最新完整帧, -1 为无; 只由中断写
+static volatile uint32_t cam_ready_seq;
+static volatile int8_t cam_held;                //Cam_Process 正在使用的缓冲; 只由 Cam_Process 写
+static volatile uint32_t cam_taken_seq;         //最后交付的帧序号; 只由 Cam_Process 写
+
+/* 行模式: 块按编程顺序写完, cam_prog/cam_head/cam_tail 都是块序号(不取模) */
+static Cam_Block cam_block[CAM_RING_MAX];
+static uint32_t cam_prog;                       //已编程给 DMA 的块
+static volatile uint32_t cam_head;              //已写满的块; 只由中断写
+static volatile uint32_t cam_tail;              //已处理的块; 只由 Cam_Process 写
+static uint8_t cam_target[2];                   //M0/M1 当前指向的块, RingBlocks 为丢弃区
+static uint16_t cam_line;                       //本帧已写入的行
+static uint32_t cam_frame;
+static uint8_t cam_gap;
+
+#define CAM_BLOCK_DROP          0x80    //作废的块, 保持块序号连续, Cam_Process 跳过
+
+static uint8_t *Cam_BlockAddr(uint8_t Block) {
+    return cam_cfg.Ring + (uint32_t)Block * cam_block_bytes;
+}
+
+/**
+  * @Name    Cam_NextBlock
+  * @brief   取环中下一块给 DMA
+  * @param   None
+  * @retval  块号, 环满时为丢弃区
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          序号在 [cam_tail, cam_prog) 的块还没处理完, 个数不到 RingBlocks 时
+          cam_prog 对应的块一定空闲.
+ **/
+static uint8_t Cam_NextBlock(void) {
+    uint8_t block;
+
+    if(cam_prog - cam_tail >= cam_cfg.RingBlocks) return cam_cfg.RingBlocks;
+
+    block = (uint8_t)(cam_prog % cam_cfg.RingBlocks);
+    cam_prog++;
+    return block;
+}
+
+/**
+  * @Name    Cam_DMAStop
+  * @brief   关闭 eDMA 流并等待生效
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          重新使能前该流的全部标志都要清除, 半传输标志不开中断也会置位, 一并清掉.
+ **/
+static void Cam_DMAStop(void) {
+    eDMA_Stream_Enable(CAM_DMA_STREAM, FALSE);
+
+    while(eDMA_Stream_Status_Get(CAM_DMA_STREAM) != RESET);
+
+    eDMA_Flag_Clear(CAM_DMA_FLAG_ALL);
+}
+
+/**
+  * @Name    Cam_DMAArm
+  * @brief   从头装载 eDMA, 调用前流已关闭
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧模式写 cam_filling; 行模式按 cam_target[0]、cam_target[1] 的顺序写, 当前目标为 M0.
+ **/
+static void Cam_DMAArm(void) {
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        eDMA_Memory_Addr_Set(CAM_DMA_STREAM, (uint32_t)cam_cfg.Frame[cam_filling], EDMA_Memory_0);
+    } else {
+        eDMA_Memory_Addr_Set(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[0]), EDMA_Memory_0);
+        eDMA_Double_Buffer_Mode_Init(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[1]), EDMA_Memory_0);
+    }
+
+    eDMA_Data_Number_Set(CAM_DMA_STREAM, (uint16_t)cam_xfer_words);
+    eDMA_Stream_Enable(CAM_DMA_STREAM, TRUE);
+}
+
+/**
+  * @Name    Cam_Init
+  * @brief   初始化 DVP、引脚和 eDMA
+  * @param   Config: 采集配置, 内容被复制
+  * @retval  SUCCESS; 参数不合法时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          eDMA 使用 FIFO 和 4 拍突发写内存, 因此缓冲要 16 字节对齐、每次传输长度是 16 字节的整数倍.
+          DVP 与 eDMA 中断使用同一抢占优先级, 互不嵌套.
+ **/
+error_status Cam_Init(const Cam_Config *Config) {
+    GPIO_Init_Type gpio;
+    eDMA_Init_Type dma;
+    uint32_t line_bytes, i;
+
+    line_bytes = (uint32_t)Config->Width * Config->BytesPerPixel;
+
+    if(Config->Width == 0 || Config->Height == 0 || (line_bytes & 3) != 0 ||
+            (Config->BytesPerPixel != 1 && Config->BytesPerPixel != 2)) return ERROR;
+
+    if(Config->Mode == CAM_MODE_FRAME) {
+        cam_xfer_words = line_bytes * Config->Height / 4;
+
+        if(Config->Frame[0] == 0 || Config->Frame[1] == 0 || Config->FrameCallback == 0 ||
+                (((uint32_t)Config->Frame[0] | (uint32_t)Config->Frame[1]) & 15) != 0) return ERROR;
+    } else if(Config->Mode == CAM_MODE_LINES) {
+        if(Config->LinesPerBlock == 0 || Config->Height % Config->LinesPerBlock != 0 ||
+                Config->RingBlocks < 3 || Config->RingBlocks > CAM_RING_MAX ||
+                Config->Ring == 0 || ((uint32_t)Config->Ring & 15) != 0 ||
+                Config->LineCallback == 0) return ERROR;
+
+        cam_xfer_words = line_bytes * Config->LinesPerBlock / 4;
+    } else {
+        return ERROR;
+    }
+
+    if(cam_xfer_words > 0xFFFF || (cam_xfer_words & 3) != 0) return ERROR;
+
+    if(Config->Crop && line_bytes > 0x4000) return ERROR;
+
+    cam_cfg = *Config;
+    cam_block_bytes = cam_xfer_words * 4;
+
+    for(i = 0; i < cam_cfg.RingBlocks && cam_cfg.Mode == CAM_MODE_LINES; i++) {
+        cam_block[i].Data = Cam_BlockAddr((uint8_t)i);
+        cam_block[i].Lines = cam_cfg.LinesPerBlock;
+    }
+
+    CRM_Periph_Clock_Enable(CRM_GPIOA_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_GPIOB_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_GPIOC_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_GPIOE_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_EDMA_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_DVP_Periph_CLOCK, TRUE);
+
+    GPIO_Default_Para_Init(&gpio);
+    gpio.GPIO_Mode = GPIO_Mode_MUX;
+    gpio.GPIO_Out_Type = GPIO_OutPut_PUSH_PULL;
+    gpio.GPIO_Pull = GPIO_Pull_UP;
+    gpio.GPIO_Drive_Strength = GPIO_Drive_Strength_STRONGER;
+
+    for(i = 0; i < sizeof(cam_pin_source); i++) {
+        gpio.GPIO_Pins = (uint32_t)1 << cam_pin_source[i];
+        GPIO_Init(cam_pin_port[i], &gpio);
+        GPIO_Pin_Mux_Config(cam_pin_port[i], (GPIO_Pins_Source_Type)cam_pin_source[i], GPIO_MUX_13);
+    }
+
+    DVP_Reset();
+    DVP_Capture_Mode_Set(cam_cfg.Snapshot ? DVP_CAP_FUNC_Mode_SINGLE : DVP_CAP_FUNC_Mode_CONTINUOUS);
+    DVP_Sync_Mode_Set(DVP_Sync_Mode_HARDWARE);
+    DVP_PCLK_Polarity_Set(cam_cfg.PCKPolarity);
+    DVP_VSync_Polarity_Set(cam_cfg.VSPolarity);
+    DVP_HSync_Polarity_Set(cam_cfg.HSPolarity);
+    DVP_Basic_Frame_rate_Control_Set(DVP_BFRC_ALL);
+    DVP_Pixel_Data_Length_Set(DVP_Pixel_Data_Length_8);
+
+    if(cam_cfg.Crop) {
+        /* 8 位接口每个像素时钟一个字节, 库函数按 bytes 换算水平方向 */
+        DVP_Window_Crop_Set(cam_cfg.CropX, cam_cfg.CropY, cam_cfg.Width, cam_cfg.Height, cam_cfg.BytesPerPixel);
+        DVP_Window_Crop_Enable(TRUE);
+    }
+
+    eDMA_Reset(CAM_DMA_STREAM);
+    eDMA_Default_Para_Init(&dma);
+    dma.Peripheral_Base_Addr = (uint32_t)&DVP->dt;
+    dma.memory0_Base_Addr = cam_cfg.Mode == CAM_MODE_FRAME ? (uint32_t)cam_cfg.Frame[0] : (uint32_t)cam_cfg.Ring;
+    dma.direction = EDMA_Dir_PERIPHERAL_To_MEMORY;
+    dma.Buffer_Size = (uint16_t)cam_xfer_words;
+    dma.Peripheral_Inc_Enable = FALSE;
+    dma.Memory_Inc_Enable = TRUE;
+    dma.Peripheral_Data_Width = EDMA_Peripheral_Data_Width_WORD;
+    dma.Memory_Data_Width = EDMA_Memory_Data_Width_WORD;
+    dma.Loop_Mode_Enable = cam_cfg.Mode == CAM_MODE_FRAME ? FALSE : TRUE;
+    dma.priority = EDMA_Priority_HIGH;
+    dma.fifo_Mode_Enable = TRUE;
+    dma.fifo_threshold = EDMA_FIFO_Threshold_FULL;
+    dma.memory_Burst_Mode = EDMA_Memory_Burst_4;
+    dma.peripheral_Burst_Mode = EDMA_PERIPHERAL_SINGLE;
+    eDMA_Init(CAM_DMA_STREAM, &dma);
+
+    eDMAMUX_Enable(TRUE);
+    eDMAMUX_Init(CAM_DMAMUX_CHANNEL, EDMAMUX_DMAREQ_ID_DVP);
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        eDMA_Double_Buffer_Mode_Init(CAM_DMA_STREAM, (uint32_t)cam_cfg.Ring, EDMA_Memory_0);
+        eDMA_Double_Buffer_Mode_Enable(CAM_DMA_STREAM, TRUE);
+    }
+
+    eDMA_Interrupt_Enable(CAM_DMA_STREAM, EDMA_FDT_INT | EDMA_DTERR_INT, TRUE);
+
+    NVIC_IRQ_Enable(CAM_DMA_IRQn, CAM_IRQ_PRIORITY, 0);
+    NVIC_IRQ_Enable(DVP_IRQn, CAM_IRQ_PRIORITY, 0);
+
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    Cam_Start
+  * @brief   复位缓冲调度并开始采集
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          连续模式从下一个 VSYNC 开始采集; 快照模式只装好 DMA, 等 Cam_Snapshot.
+ **/
+void Cam_Start(void) {
+    memset(&cam_stats, 0, sizeof(cam_stats));
+    cam_filling = 0;
+    cam_ready = -1;
+    cam_ready_seq = 0;
+    cam_held = -1;
+    cam_taken_seq = 0;
+    cam_prog = 0;
+    cam_head = 0;
+    cam_tail = 0;
+    cam_line = 0;
+    cam_frame = 0;
+    cam_gap = 0;
+    cam_skip = 0;
+    cam_snap = 0;
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        cam_target[0] = Cam_NextBlock();
+        cam_target[1] = Cam_NextBlock();
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+
+    DVP_Flag_Clear(DVP_CFD_INT_FLAG | DVP_OVR_INT_FLAG);
+    DVP_Interrupt_Enable(DVP_CFD_INT | DVP_OVR_INT, TRUE);
+    DVP_Enable(TRUE);
+
+    if(!cam_cfg.Snapshot) DVP_Capture_Enable(TRUE);
+}
+
+/**
+  * @Name    Cam_Stop
+  * @brief   立即停止采集, 可再次 Cam_Start
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Cam_Stop(void) {
+    DVP_Capture_Enable(FALSE);
+    DVP_Interrupt_Enable(DVP_CFD_INT | DVP_OVR_INT, FALSE);
+    DVP_Enable(FALSE);
+    Cam_DMAStop();
+}
+
+/**
+  * @Name    Cam_Snapshot
+  * @brief   快照模式下采集下一帧
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DVP 等到下一个 VSYNC 开始, 一帧结束后自动清除 cap.
+          裁剪时最后一块在帧结束前就已交付, 此时 cap 仍置位, 直接置位会被帧结束清掉,
+          所以记下请求由帧结束中断补发. 检查期间屏蔽帧中断.
+ **/
+void Cam_Snapshot(void) {
+    DVP_Interrupt_Enable(DVP_CFD_INT, FALSE);
+
+    if(DVP->ctrl_bit.cap) {
+        cam_snap = 1;
+    } else {
+        DVP_Capture_Enable(TRUE);
+    }
+
+    DVP_Interrupt_Enable(DVP_CFD_INT, TRUE);
+}
+
+/**
+  * @Name    Cam_Corrupted
+  * @brief   本次传输是否含溢出后的错位数据
+  * @param   None
+  * @retval  1: 作废
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          传输完成中断先于 DVP 溢出中断处理时 cam_skip 还没置位, 直接看溢出事件标志.
+ **/
+static uint8_t Cam_Corrupted(void) {
+    return cam_skip || DVP_Flag_Get(DVP_OVR_EVT_FLAG) != RESET;
+}
+
+/**
+  * @Name    Cam_FrameDone
+  * @brief   帧模式: 一帧传完, 选下一块缓冲并重装 eDMA
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          另一块正被 Cam_Process 使用时只能覆盖刚采完的这块(丢弃它);
+          否则写另一块, 若那块是尚未交付的旧帧则它被丢弃. 溢出作废的帧原地重写.
+ **/
+static void Cam_FrameDone(void) {
+    int8_t done = cam_filling;
+    int8_t other = done ^ 1;
+
+    cam_stats.Frames++;
+
+    if(cam_held == other || Cam_Corrupted()) {
+        cam_stats.FramesDropped++;
+    } else {
+        if(cam_ready == other && cam_ready_seq != cam_taken_seq) cam_stats.FramesDropped++;
+
+        cam_ready_seq = cam_stats.Frames;
+        cam_ready = done;
+        cam_filling = other;
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+}
+
+/**
+  * @Name    Cam_BlockDone
+  * @brief   行模式: 一块写满, 登记并把空闲的地址寄存器改到下一块
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          当前目标已切换, 刚写满的是另一个寄存器指向的块, 改写空闲寄存器是双缓冲模式允许的.
+          溢出作废的块照常登记(块按编程顺序写满), 带 CAM_BLOCK_DROP, 由 Cam_Process 跳过.
+ **/
+static void Cam_BlockDone(void) {
+    uint32_t idle = eDMA_Memory_Target_Get(CAM_DMA_STREAM) ^ 1;
+    uint8_t done = cam_target[idle];
+    uint8_t flags = cam_line == 0 ? CAM_BLOCK_FIRST : 0;
+    uint8_t bad = Cam_Corrupted();
+    uint32_t backlog;
+
+    cam_line += cam_cfg.LinesPerBlock;
+
+    if(cam_line >= cam_cfg.Height) flags |= CAM_BLOCK_LAST;
+
+    if(done < cam_cfg.RingBlocks) {
+        cam_block[done].Frame = cam_frame;
+        cam_block[done].Line = (uint16_t)(cam_line - cam_cfg.LinesPerBlock);
+        cam_block[done].Flags = bad ? CAM_BLOCK_DROP : flags | (cam_gap ? CAM_BLOCK_GAP : 0);
+        cam_head++;
+        backlog = cam_head - cam_tail;
+
+        if(backlog > cam_stats.MaxBacklog) cam_stats.MaxBacklog = backlog;
+    }
+
+    if(done >= cam_cfg.RingBlocks || bad) {
+        cam_stats.BlocksDropped++;
+
+        if(!cam_gap) cam_stats.FramesDropped++;
+
+        cam_gap = 1;
+    }
+
+    if(flags & CAM_BLOCK_LAST) {
+        cam_stats.Frames++;
+        cam_frame++;
+        cam_line = 0;
+        cam_gap = 0;
+    }
+
+    cam_target[idle] = Cam_NextBlock();
+    eDMA_Memory_Addr_Set(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[idle]),
+                         idle ? EDMA_Memory_1 : EDMA_Memory_0);
+}
+
+/**
+  * @Name    Cam_DMA_IRQHandler
+  * @brief   eDMA 中断, 在 EDMA_Stream1_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          传输错误只在缓冲地址不可访问时出现, 此时流已被硬件关闭, 计一次对齐错误后从头重装.
+ **/
+void Cam_DMA_IRQHandler(void) {
+    if(eDMA_Flag_Get(CAM_DMA_DTERR_FLAG) != RESET) {
+        Cam_DMAStop();
+        cam_stats.SyncErrors++;
+        Cam_DMAArm();
+        return;
+    }
+
+    if(eDMA_Flag_Get(CAM_DMA_FDT_FLAG) == RESET) return;
+
+    eDMA_Flag_Clear(CAM_DMA_FDT_FLAG);
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        Cam_FrameDone();
+    } else {
+        Cam_BlockDone();
+    }
+}
+
+/**
+  * @Name    Cam_DVP_IRQHandler
+  * @brief   DVP 中断, 在 DVP_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧结束时 DMA 应该刚好传完(最多还差 FIFO 中的几个字, 其完成中断随后到来)
+          或已经重装好等下一帧; 其他位置说明帧比配置短或长, 此时处于消隐期,
+          关掉 DMA 从本帧开头重装. 行模式下已交付的块保留, 下一块带 CAM_BLOCK_FIRST.
+          先处理挂起的传输完成再核对位置. 本帧溢出过时不核对, 直接重装;
+          重装时关一下 DVP 清空其 FIFO.
+ **/
+void Cam_DVP_IRQHandler(void) {
+    uint32_t remain;
+    uint8_t ok;
+
+    if(DVP_Flag_Get(DVP_OVR_INT_FLAG) != RESET) {
+        DVP_Flag_Clear(DVP_OVR_INT_FLAG);
+        cam_stats.Overflows++;
+        cam_skip = 1;
+    }
+
+    if(DVP_Flag_Get(DVP_CFD_INT_FLAG) == RESET) return;
+
+    DVP_Flag_Clear(DVP_CFD_INT_FLAG);
+
+    if(cam_snap) {
+        cam_snap = 0;
+        DVP_Capture_Enable(TRUE);
+    }
+
+    if(eDMA_Flag_Get(CAM_DMA_FDT_FLAG) != RESET) Cam_DMA_IRQHandler();
+
+    remain = eDMA_Data_Number_Get(CAM_DMA_STREAM);
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        ok = remain == cam_xfer_words || remain <= CAM_FIFO_WORDS;
+    } else {
+        ok = (cam_line == 0 && remain == cam_xfer_words) ||
+             (cam_line == cam_cfg.Height - cam_cfg.LinesPerBlock && remain <= CAM_FIFO_WORDS);
+    }
+
+    if(ok && !cam_skip) return;
+
+    if(!cam_skip) cam_stats.SyncErrors++;
+
+    DVP_Enable(FALSE);
+    Cam_DMAStop();
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        /* 先编程的块放 M0, 保持块按编程顺序写满 */
+        uint32_t cur = eDMA_Memory_Target_Get(CAM_DMA_STREAM);
+        uint8_t first = cam_target[cur];
+
+        cam_target[1] = cam_target[cur ^ 1];
+        cam_target[0] = first;
+
+        if(cam_gap == 0 && (cam_line != 0 || cam_skip)) cam_stats.FramesDropped++;
+
+        cam_line = 0;
+        cam_gap = 0;
+        cam_frame++;
+    }
+
+    cam_skip = 0;
+    Cam_DMAArm();
+    DVP_Enable(TRUE);
+}
+
+/**
+  * @Name    Cam_Process
+  * @brief   把已采集的数据交给回调, 在主循环中调用
+  * @param   None
+  * @retval  交付的帧数(帧模式, 0 或 1)或块数(行模式)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧模式: 先登记 cam_held 再复查 cam_ready, 中断若在两者之间把这块选作 DMA 目标,
+          复查会发现 cam_ready 已变并重试; 登记之后中断不会再选它.
+          行模式: 回调返回后该块才归还, 回调期间 DMA 写的是环里的其他块;
+          只处理进入时已写满的块, 回调比传感器慢时也能回到主循环.
+ **/
+uint32_t Cam_Process(void) {
+    uint32_t n = 0, start, cycles, seq, head;
+    int8_t buf;
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        for(;;) {
+            buf = cam_ready;
+            seq = cam_ready_seq;
+
+            if(buf < 0 || seq == cam_taken_seq) return 0;
+
+            cam_held = buf;
+
+            if(cam_ready == buf && cam_ready_seq == seq) break;
+
+            cam_held = -1;
+        }
+
+        start = DWT->CYCCNT;
+        cam_cfg.FrameCallback(cam_cfg.Frame[buf], seq);
+        cycles = DWT->CYCCNT - start;
+        cam_taken_seq = seq;
+        cam_held = -1;
+        n = 1;
+    } else {
+        start = DWT->CYCCNT;
+        head = cam_head;
+
+        while(cam_tail != head) {
+            if(!(cam_block[cam_tail % cam_cfg.RingBlocks].Flags & CAM_BLOCK_DROP)) {
+                cam_cfg.LineCallback(&cam_block[cam_tail % cam_cfg.RingBlocks]);
+                n++;
+            }
+
+            cam_tail++;
+        }
+
+        if(n == 0) return 0;
+
+        cycles = DWT->CYCCNT - start;
+    }
+
+    cam_stats.Delivered += n;
+    cam_stats.LastCycles = cycles;
+
+    if(cycles > cam_stats.MaxCycles) cam_stats.MaxCycles = cycles;
+
+    return n;
+}
+
+/**
+  * @Name    Cam_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Cam_GetStats(Cam_Stats *Stats) {
+    *Stats = cam_stats;
+}
@@ -0,0 +1,272 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_bus.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 中断驱动的 CAN 收发, AT32 CAN 寄存器部分
+                   1. 接收中断直接读邮箱寄存器, 一次把硬件 FIFO(3 级)读空, 每帧读进
+                      CANQueue_RxSlot 给出的环形缓冲区空位;
+                   2. 发送完成中断清标志后把完成的邮箱交给 CANQueue_TxDone, 写邮箱和中止请求
+                      由 Common/can_queue.c 经回调发起.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_bus.h"
+#include "string.h"
+
+/* 寄存器位, 与 tsts/rf0/tmi/rfc 的位域定义一致 */
+#define CANBUS_TSTS_TCF0        ((uint32_t)0x00000001)
+#define CANBUS_TSTS_TSF0        ((uint32_t)0x00000002)
+#define CANBUS_TSTS_CT0         ((uint32_t)0x00000080)
+#define CANBUS_RF_MN            ((uint32_t)0x00000003)
+#define CANBUS_RF_OF            ((uint32_t)0x00000010)
+#define CANBUS_RF_R             ((uint32_t)0x00000020)
+#define CANBUS_TMI_SR           ((uint32_t)0x00000001)
+#define CANBUS_TMI_FRSEL        ((uint32_t)0x00000002)
+#define CANBUS_TMI_IDSEL        ((uint32_t)0x00000004)
+#define CANBUS_RFC_DTL          ((uint32_t)0x0000000F)
+#define CANBUS_RFC_FMN          ((uint32_t)0x0000FF00)
+
+static CANQueue cb_bus[2];
+static CAN_Type *const cb_can[2] = {CAN1, CAN2};
+
+static CANQueue *CANBus_Get(CAN_Type *CANx) {
+    return &cb_bus[CANx == CAN2 ? 1 : 0];
+}
+
+/**
+  * @Name    CANBus_Write
+  * @brief   写发送邮箱并请求发送
+  * @param   Q: 队列
+  * @param   Mailbox: 0~2
+  * @param   Frame: 帧
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void CANBus_Write(CANQueue *Q, uint8_t Mailbox, const CANBus_Frame *Frame) {
+    CAN_TX_mailbox_Type *box = &cb_can[Q - cb_bus]->tx_mailbox[Mailbox];
+    uint32_t word[2];
+
+    memcpy(word, Frame->Data, 8);
+
+    box->tmc = Frame->Dlc & 0x0F;
+    box->tmdtl = word[0];
+    box->tmdth = word[1];
+    box->tmi = (Frame->Ext ? ((Frame->Id << 3) | CANBUS_TMI_IDSEL) : (Frame->Id << 21)) |
+               (Frame->Rtr ? CANBUS_TMI_FRSEL : 0) | CANBUS_TMI_SR;
+}
+
+static void CANBus_Abort(CANQueue *Q, uint8_t Mailbox) {
+    cb_can[Q - cb_bus]->tsts = CANBUS_TSTS_CT0 << (8 * Mailbox);
+}
+
+static const CANQueue_Port cb_port = {CANBus_Write, CANBus_Abort};
+
+/**
+  * @Name    CANBus_Init
+  * @brief   初始化 CAN、过滤器组和中断
+  * @param   CANx: CAN1 或 CAN2
+  * @param   BaseStruct: 工作模式等参数, 直接传给 CAN_Base_Init
+  * @param   BaudrateStruct: 位时序, 直接传给 CAN_Baudrate_Set
+  * @param   Table: CANFilter_Compile 的结果, NULL 时接收全部帧到类别 0
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器组由 CANFilter_Load 从第 0 组开始装入, 其余组关闭.
+ **/
+error_status CANBus_Init(CAN_Type *CANx, CAN_Base_Type *BaseStruct, CAN_Baudrate_Type *BaudrateStruct,
+                         const CANFilter_Table *Table) {
+    IRQn_Type irq[3];
+    uint8_t i;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    CRM_Periph_Clock_Enable(CANx == CAN2 ? CRM_CAN2_Periph_CLOCK : CRM_CAN1_Periph_CLOCK, TRUE);
+
+    if(CAN_Base_Init(CANx, BaseStruct) != SUCCESS) return ERROR;
+
+    if(CAN_Baudrate_Set(CANx, BaudrateStruct) != SUCCESS) return ERROR;
+
+    if(CANFilter_Load(CANx, Table) != SUCCESS) return ERROR;
+
+    CANQueue_Init(CANBus_Get(CANx), &cb_port, Table, NULL);
+
+    if(CANx == CAN2) {
+        irq[0] = CAN2_RX0_IRQn;
+        irq[1] = CAN2_RX1_IRQn;
+        irq[2] = CAN2_TX_IRQn;
+    } else {
+        irq[0] = CAN1_RX0_IRQn;
+        irq[1] = CAN1_RX1_IRQn;
+        irq[2] = CAN1_TX_IRQn;
+    }
+
+    /* 三个中断同一优先级, 互不抢占 */
+    for(i = 0; i < 3; i++) {
+        NVIC_IRQ_Enable(irq[i], CANBUS_IRQ_PRIORITY, 0);
+    }
+
+    /* TCIEN 常开: 只有 TMxTCF 置位时才进中断 */
+    CANx->inten |= CAN_RF0MIEN_INT | CAN_RF0OIEN_INT | CAN_RF1MIEN_INT | CAN_RF1OIEN_INT | CAN_TCIEN_INT;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    CANBus_Send
+  * @brief   帧入发送队列
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Frame: 帧, Class 和 Time 不使用
+  * @retval  SUCCESS / ERROR(队列满)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只屏蔽本 CAN 的 TCIEN, 不关全局中断; 不可重入, 只能在一个上下文中调用.
+ **/
+error_status CANBus_Send(CAN_Type *CANx, const CANBus_Frame *Frame) {
+    error_status status;
+
+    CANx->inten &= ~CAN_TCIEN_INT;
+    status = CANQueue_Send(CANBus_Get(CANx), Frame) ? SUCCESS : ERROR;
+    CANx->inten |= CAN_TCIEN_INT;
+
+    return status;
+}
+
+/**
+  * @Name    CANBus_Receive
+  * @brief   取一帧, 类别 0 优先
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Frame: 输出
+  * @retval  1: 取到; 0: 无数据
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t CANBus_Receive(CAN_Type *CANx, CANBus_Frame *Frame) {
+    return CANQueue_Receive(CANBus_Get(CANx), Frame);
+}
+
+/**
+  * @Name    CANBus_Drain
+  * @brief   读空一个接收 FIFO
+  * @param   CANx: CAN1 或 CAN2
+  * @param   FIFO: 0 或 1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          环形缓冲区满时照样释放邮箱, 丢弃的帧由 CANQueue_RxSlot 计入 RxOverflow.
+ **/
+static void CANBus_Drain(CAN_Type *CANx, uint8_t FIFO) {
+    CANQueue *Q = CANBus_Get(CANx);
+    CAN_FIFO_mailbox_Type *box = &CANx->fifo_mailbox[FIFO];
+    __IO uint32_t *rfr = FIFO ? &CANx->rf1 : &CANx->rf0;
+    CANBus_Frame *f;
+    uint32_t rir, rdtr, word[2];
+
+    while(*rfr & CANBUS_RF_MN) {
+        rir = box->rfi;
+        rdtr = box->rfc;
+        f = CANQueue_RxSlot(Q, FIFO, (uint8_t)((rdtr & CANBUS_RFC_FMN) >> 8));
+
+        if(f) {
+            f->Ext = (rir & CANBUS_TMI_IDSEL) ? 1 : 0;
+            f->Id = f->Ext ? (rir >> 3) : (rir >> 21);
+            f->Rtr = (rir & CANBUS_TMI_FRSEL) ? 1 : 0;
+            f->Dlc = (uint8_t)(rdtr & CANBUS_RFC_DTL);
+            f->Time = (uint16_t)(rdtr >> 16);
+            word[0] = box->rfdtl;
+            word[1] = box->rfdth;
+            memcpy(f->Data, word, 8);
+
+            CANQueue_RxCommit(Q, f);
+        }
+
+        *rfr = CANBUS_RF_R;
+    }
+
+    if(*rfr & CANBUS_RF_OF) {
+        CANQueue_FifoOverrun(Q, FIFO);
+        *rfr = CANBUS_RF_OF;
+    }
+}
+
+/**
+  * @Name    CANBus_RX0_IRQHandler
+  * @brief   在 CANx_RX0_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_RX0_IRQHandler(CAN_Type *CANx) {
+    CANBus_Drain(CANx, 0);
+}
+
+/**
+  * @Name    CANBus_RX1_IRQHandler
+  * @brief   在 CANx_RX1_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_RX1_IRQHandler(CAN_Type *CANx) {
+    CANBus_Drain(CANx, 1);
+}
+
+/**
+  * @Name    CANBus_TX_IRQHandler
+  * @brief   在 CANx_TX_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          清除完成标志后交给 CANQueue_TxDone, 被中止的帧在那里重新入队.
+ **/
+void CANBus_TX_IRQHandler(CAN_Type *CANx) {
+    uint32_t tsr = CANx->tsts;
+    uint8_t mb, done = 0, ok = 0;
+
+    for(mb = 0; mb < 3; mb++) {
+        if(!(tsr & (CANBUS_TSTS_TCF0 << (8 * mb)))) continue;
+
+        /* 清 TMxTCF 同时清 TMxTSF/TMxALF/TMxTEF */
+        CANx->tsts = CANBUS_TSTS_TCF0 << (8 * mb);
+        done |= (uint8_t)(1U << mb);
+
+        if(tsr & (CANBUS_TSTS_TSF0 << (8 * mb))) ok |= (uint8_t)(1U << mb);
+    }
+
+    CANQueue_TxDone(CANBus_Get(CANx), done, ok);
+}
+
+/**
+  * @Name    CANBus_GetStats
+  * @brief   读取运行统计
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_GetStats(CAN_Type *CANx, CANBus_Stats *Stats) {
+    *Stats = CANBus_Get(CANx)->Stats;
+}
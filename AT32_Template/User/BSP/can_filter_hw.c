@@ -0,0 +1,70 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 过滤器组写入
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_filter_hw.h"
+#include "stddef.h"
+
+/**
+  * @Name    CANFilter_Load
+  * @brief   装入过滤器组
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Table: CANFilter_Compile 的结果, NULL 时用 CANFilter_AcceptAll
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          AT32F435/437 的两个 CAN 各有 28 个过滤器组, 从第 0 组开始装入, 其余组关闭,
+          所以 FMI 从 0 开始, 不需要偏移.
+ **/
+error_status CANFilter_Load(CAN_Type *CANx, const CANFilter_Table *Table) {
+    const CANFilter_Bank *b;
+    uint8_t bank;
+    uint32_t bit;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    if(Table->NumBanks > CANFILTER_MAX_BANKS) return ERROR;
+
+    CANx->fctrl_bit.fcs = TRUE;
+
+    for(bank = 0; bank < CANFILTER_MAX_BANKS; bank++) {
+        bit = 1U << bank;
+        CANx->facfg &= ~bit;
+
+        if(bank >= Table->NumBanks) continue;
+
+        b = &Table->Bank[bank];
+
+        if(b->Mode == CANFILTER_MODE_LIST) CANx->fmcfg |= bit;
+        else CANx->fmcfg &= ~bit;
+
+        if(b->Scale == CANFILTER_SCALE_32BIT) CANx->fbwcfg |= bit;
+        else CANx->fbwcfg &= ~bit;
+
+        if(b->FIFO) CANx->frf |= bit;
+        else CANx->frf &= ~bit;
+
+        CANx->ffb[bank].ffdb1 = b->FR1;
+        CANx->ffb[bank].ffdb2 = b->FR2;
+        CANx->facfg |= bit;
+    }
+
+    CANx->fctrl_bit.fcs = FALSE;
+
+    return SUCCESS;
+}
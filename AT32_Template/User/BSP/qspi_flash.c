@@ -0,0 +1,494 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : qspi_flash.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : QSPI 外部闪存
+                   1. XIP 读用 D 模式, 每次访问后按 QSPI_FLASH_PREFETCH 连续预读, 开启 XIP 缓存;
+                   2. 批量读走命令口 + DMA: 4 字节对齐、FIFO 阈值(32 字节)整数倍的部分用 DMA,
+                      头尾剩余部分由 CPU 按 FIFO 阈值分块读. 命令口读不经过 XIP 缓存, 不会把
+                      正在执行的代码挤出去; 退出命令口时硬件清空 XIP 缓存, 擦写后不会读到旧数据;
+                   3. 加密(KEYEN)在命令口模式下设置, 对本模块的编程和 XIP/命令口读同时生效,
+                      外部闪存中的内容须通过开启加密的本模块写入;
+                   4. AT32F435/437 的 QSPI 只支持单沿采样, 没有 DTR 模式, 器件表中只用四线 I/O.
+  * Function List:
+
+  **********************************************************
+ */
+#include "qspi_flash.h"
+#include "string.h"
+
+#define QSPI_FLASH_FIFO_CHUNK       32      //FIFO 阈值 8 字
+#define QSPI_FLASH_DMA_MAX          (0xFFFFUL * 4 & ~(uint32_t)(QSPI_FLASH_FIFO_CHUNK - 1))
+
+#define QSPI_FLASH_CMD_WREN         0x06
+#define QSPI_FLASH_CMD_RDSR1        0x05
+#define QSPI_FLASH_CMD_RDSR2        0x35
+#define QSPI_FLASH_CMD_WRSR1        0x01
+#define QSPI_FLASH_CMD_WRSR2        0x31
+#define QSPI_FLASH_CMD_RDID         0x9F
+#define QSPI_FLASH_CMD_RSTEN        0x66
+#define QSPI_FLASH_CMD_RST          0x99
+
+static const QSPI_Flash_Part qf_parts[] = {
+    /* JedecId    Size        Read  Dum Mode                    Addr Prog  Mode                    Erase QE                      ClkDiv */
+    {0xEF4017, 0x00800000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x32, QSPI_OPERATE_Mode_114, 0x20, QSPI_FLASH_QE_SR2_BIT1, QSPI_CLK_Div_3},  //W25Q64JV
+    {0xEF4018, 0x01000000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x32, QSPI_OPERATE_Mode_114, 0x20, QSPI_FLASH_QE_SR2_BIT1, QSPI_CLK_Div_3},  //W25Q128JV
+    {0xEF4019, 0x02000000, 0xEC, 6, QSPI_OPERATE_Mode_144, 4, 0x34, QSPI_OPERATE_Mode_114, 0x21, QSPI_FLASH_QE_SR2_BIT1, QSPI_CLK_Div_3},  //W25Q256JV
+    {0xC84017, 0x00800000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x32, QSPI_OPERATE_Mode_114, 0x20, QSPI_FLASH_QE_SR2_BIT1, QSPI_CLK_Div_3},  //GD25Q64
+    {0xC84018, 0x01000000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x32, QSPI_OPERATE_Mode_114, 0x20, QSPI_FLASH_QE_SR2_BIT1, QSPI_CLK_Div_3},  //GD25Q128
+    {0xC22018, 0x01000000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x38, QSPI_OPERATE_Mode_144, 0x20, QSPI_FLASH_QE_SR1_BIT6, QSPI_CLK_Div_4},  //MX25L128
+    {0xC22019, 0x02000000, 0xEC, 6, QSPI_OPERATE_Mode_144, 4, 0x3E, QSPI_OPERATE_Mode_144, 0x21, QSPI_FLASH_QE_SR1_BIT6, QSPI_CLK_Div_4},  //MX25L256
+    {0x9D6018, 0x01000000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x32, QSPI_OPERATE_Mode_114, 0x20, QSPI_FLASH_QE_SR1_BIT6, QSPI_CLK_Div_3},  //IS25LP128
+    {0x1C7018, 0x01000000, 0xEB, 6, QSPI_OPERATE_Mode_144, 3, 0x02, QSPI_OPERATE_Mode_111, 0x20, QSPI_FLASH_QE_NONE,     QSPI_CLK_Div_4},  //EN25QH128A
+};
+
+static const QSPI_Flash_Part *qf_part;
+static QSPI_Flash_Stats qf_stats;
+
+/**
+  * @Name    QSPI_Flash_Cmd
+  * @brief   发起一条命令口命令
+  * @param   Ins: 指令
+  * @param   Addr: 地址
+  * @param   AddrLen: 地址字节数, 0 表示无地址
+  * @param   Count: 数据字节数
+  * @param   Dummy: 空周期
+  * @param   Mode: QSPI_operate_Mode_Type
+  * @param   Write: TRUE 为写数据
+  * @retval  无
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void QSPI_Flash_Cmd(uint8_t Ins, uint32_t Addr, uint8_t AddrLen, uint32_t Count, uint8_t Dummy,
+                           uint8_t Mode, confirm_state Write) {
+    QSPI_CMD_Type cmd;
+
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.pe_Mode_Enable = FALSE;
+    cmd.instruction_code = Ins;
+    cmd.instruction_length = QSPI_CMD_INSLEN_1_BYTE;
+    cmd.address_code = Addr;
+    cmd.address_length = (QSPI_CMD_adrlen_Type)AddrLen;
+    cmd.data_counter = Count;
+    cmd.second_dummy_Cycle_Num = Dummy;
+    cmd.operation_Mode = (QSPI_operate_Mode_Type)Mode;
+    cmd.read_Status_Config = QSPI_RSTSC_HW_AUTO;
+    cmd.read_Status_Enable = FALSE;
+    cmd.write_Data_Enable = Write;
+    QSPI_CMD_Operation_kick(QSPI_FLASH_PORT, &cmd);
+}
+
+static void QSPI_Flash_WaitCmd(void) {
+    while(QSPI_Flag_Get(QSPI_FLASH_PORT, QSPI_CMDSTS_FLAG) == RESET);
+
+    QSPI_Flag_Clear(QSPI_FLASH_PORT, QSPI_CMDSTS_FLAG);
+}
+
+static void QSPI_Flash_Simple(uint8_t Ins) {
+    QSPI_Flash_Cmd(Ins, 0, 0, 0, 0, QSPI_OPERATE_Mode_111, FALSE);
+    QSPI_Flash_WaitCmd();
+}
+
+/**
+  * @Name    QSPI_Flash_WaitBusy
+  * @brief   等待闪存内部操作完成
+  * @param   无
+  * @retval  无
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          硬件自动循环读状态寄存器 1, 直到 QSPI_Busy_Config 指定的 WIP 位为 0, CPU 只等命令完成.
+ **/
+static void QSPI_Flash_WaitBusy(void) {
+    QSPI_CMD_Type cmd;
+
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.instruction_code = QSPI_FLASH_CMD_RDSR1;
+    cmd.instruction_length = QSPI_CMD_INSLEN_1_BYTE;
+    cmd.address_length = QSPI_CMD_ADRLEN_0_BYTE;
+    cmd.operation_Mode = QSPI_OPERATE_Mode_111;
+    cmd.read_Status_Config = QSPI_RSTSC_HW_AUTO;
+    cmd.read_Status_Enable = TRUE;
+    cmd.write_Data_Enable = FALSE;
+    QSPI_CMD_Operation_kick(QSPI_FLASH_PORT, &cmd);
+    QSPI_Flash_WaitCmd();
+}
+
+/**
+  * @Name    QSPI_Flash_CpuRead
+  * @brief   命令口读, CPU 取 FIFO
+  * @param   Ins/Addr/AddrLen/Dummy/Mode: 同 QSPI_Flash_Cmd
+  * @param   Buff: 缓冲区
+  * @param   Size: 字节数
+  * @retval  无
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          RXFIFORDY 表示 FIFO 中已有一个阈值的数据; 不足一个阈值的尾部等命令完成后再取.
+ **/
+static void QSPI_Flash_CpuRead(uint8_t Ins, uint32_t Addr, uint8_t AddrLen, uint8_t Dummy, uint8_t Mode,
+                               uint8_t *Buff, uint32_t Size) {
+    uint32_t i;
+    uint32_t total = Size;          //下面的循环会把 Size 减到尾部长度
+
+    QSPI_Flash_Cmd(Ins, Addr, AddrLen, Size, Dummy, Mode, FALSE);
+
+    while(Size >= QSPI_FLASH_FIFO_CHUNK) {
+        while(QSPI_Flag_Get(QSPI_FLASH_PORT, QSPI_RXFIFORDY_FLAG) == RESET);
+
+        for(i = 0; i < QSPI_FLASH_FIFO_CHUNK; i++) *Buff++ = QSPI_Byte_Read(QSPI_FLASH_PORT);
+
+        Size -= QSPI_FLASH_FIFO_CHUNK;
+    }
+
+    while(QSPI_Flag_Get(QSPI_FLASH_PORT, QSPI_CMDSTS_FLAG) == RESET);
+
+    for(i = 0; i < Size; i++) *Buff++ = QSPI_Byte_Read(QSPI_FLASH_PORT);
+
+    QSPI_Flag_Clear(QSPI_FLASH_PORT, QSPI_CMDSTS_FLAG);
+    qf_stats.CpuBytes += total;
+}
+
+static void QSPI_Flash_CpuWrite(uint8_t Ins, uint32_t Addr, uint8_t AddrLen, uint8_t Mode,
+                                const uint8_t *Data, uint32_t Size) {
+    uint32_t i, n;
+
+    QSPI_Flash_Cmd(Ins, Addr, AddrLen, Size, 0, Mode, TRUE);
+
+    while(Size) {
+        n = Size < QSPI_FLASH_FIFO_CHUNK ? Size : QSPI_FLASH_FIFO_CHUNK;
+
+        while(QSPI_Flag_Get(QSPI_FLASH_PORT, QSPI_TXFIFORDY_FLAG) == RESET);
+
+        for(i = 0; i < n; i++) QSPI_Byte_Write(QSPI_FLASH_PORT, *Data++);
+
+        Size -= n;
+    }
+
+    QSPI_Flash_WaitCmd();
+}
+
+/**
+  * @Name    QSPI_Flash_EnableQuad
+  * @brief   按器件设置 QE 位
+  * @param   Part: 器件参数
+  * @retval  SUCCESS / ERROR(回读 QE 仍为 0)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          QE 是非易失位, 已置位时不再写, 避免每次上电都磨损状态寄存器.
+ **/
+static error_status QSPI_Flash_EnableQuad(const QSPI_Flash_Part *Part) {
+    uint8_t rd, wr, bit, sr;
+
+    if(Part->QeMethod == QSPI_FLASH_QE_SR2_BIT1) {
+        rd = QSPI_FLASH_CMD_RDSR2;
+        wr = QSPI_FLASH_CMD_WRSR2;
+        bit = 0x02;
+    } else if(Part->QeMethod == QSPI_FLASH_QE_SR1_BIT6) {
+        rd = QSPI_FLASH_CMD_RDSR1;
+        wr = QSPI_FLASH_CMD_WRSR1;
+        bit = 0x40;
+    } else {
+        return SUCCESS;
+    }
+
+    QSPI_Flash_CpuRead(rd, 0, 0, 0, QSPI_OPERATE_Mode_111, &sr, 1);
+
+    if(sr & bit) return SUCCESS;
+
+    sr |= bit;
+    QSPI_Flash_Simple(QSPI_FLASH_CMD_WREN);
+    QSPI_Flash_CpuWrite(wr, 0, 0, QSPI_OPERATE_Mode_111, &sr, 1);
+    QSPI_Flash_WaitBusy();
+    QSPI_Flash_CpuRead(rd, 0, 0, 0, QSPI_OPERATE_Mode_111, &sr, 1);
+
+    return (sr & bit) ? SUCCESS : ERROR;
+}
+
+/**
+  * @Name    QSPI_Flash_Init
+  * @brief   识别外部闪存并进入 XIP 模式
+  * @param   Encrypt: TRUE 开启 QSPI 加密
+  * @retval  SUCCESS / ERROR(器件不在表中或 QE 置位失败, 此时停在命令口模式)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          先用 12 分频的单线模式复位闪存、读 JEDEC ID, 再切到表中的分频.
+ **/
+error_status QSPI_Flash_Init(confirm_state Encrypt) {
+    QSPI_Xip_Type xip;
+    uint8_t id[3];
+    uint32_t jedec, i;
+
+    CRM_Periph_Clock_Enable(QSPI_FLASH_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(QSPI_FLASH_DMA_CLOCK, TRUE);
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, FALSE);
+    QSPI_SCK_Mode_Set(QSPI_FLASH_PORT, QSPI_SCK_Mode_0);
+    QSPI_CLK_Division_Set(QSPI_FLASH_PORT, QSPI_CLK_Div_12);
+    QSPI_Busy_Config(QSPI_FLASH_PORT, QSPI_Busy_Offset_0);
+    QSPI_Encryption_Enable(QSPI_FLASH_PORT, FALSE);
+    QSPI_Interrupt_Enable(QSPI_FLASH_PORT, FALSE);
+
+    QSPI_Flash_Simple(QSPI_FLASH_CMD_RSTEN);
+    QSPI_Flash_Simple(QSPI_FLASH_CMD_RST);
+
+    /* 复位恢复时间 tRST 最长 30us */
+    for(i = SystemCoreClock / 100000; i > 0; i--) __NOP();
+
+    QSPI_Flash_CpuRead(QSPI_FLASH_CMD_RDID, 0, 0, 0, QSPI_OPERATE_Mode_111, id, 3);
+    jedec = ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+
+    qf_part = NULL;
+
+    for(i = 0; i < sizeof(qf_parts) / sizeof(qf_parts[0]); i++) {
+        if(qf_parts[i].JedecId == jedec) {
+            qf_part = &qf_parts[i];
+            break;
+        }
+    }
+
+    if(qf_part == NULL) return ERROR;
+
+    if(QSPI_Flash_EnableQuad(qf_part) != SUCCESS) {
+        qf_part = NULL;
+        return ERROR;
+    }
+
+    QSPI_CLK_Division_Set(QSPI_FLASH_PORT, (QSPI_CLK_Div_Type)qf_part->ClkDiv);
+    QSPI_Encryption_Enable(QSPI_FLASH_PORT, Encrypt);
+
+    xip.read_instruction_code = qf_part->ReadCmd;
+    xip.read_Address_length = qf_part->AddrLen == 4 ? QSPI_Xip_AddrLEN_4_BYTE : QSPI_Xip_AddrLEN_3_BYTE;
+    xip.read_Operation_Mode = (QSPI_operate_Mode_Type)qf_part->ReadMode;
+    xip.read_Second_dummy_Cycle_Num = qf_part->ReadDummy;
+    xip.read_Select_Mode = QSPI_XIPR_SEL_ModeD;
+    xip.read_Time_counter = 0x7F;
+    xip.read_Data_counter = QSPI_FLASH_PREFETCH;
+    /* XIP 写不会先发 WREN, 只保留合法配置, 写闪存用 QSPI_Flash_Program */
+    xip.write_instruction_code = qf_part->ProgCmd;
+    xip.write_Address_length = xip.read_Address_length;
+    xip.write_Operation_Mode = (QSPI_operate_Mode_Type)qf_part->ProgMode;
+    xip.write_Second_dummy_Cycle_Num = 0;
+    xip.write_Select_Mode = QSPI_XIPW_SEL_ModeD;
+    xip.write_Time_counter = 0x7F;
+    xip.write_Data_counter = 0x1F;
+    QSPI_Xip_Init(QSPI_FLASH_PORT, &xip);
+    QSPI_Xip_Cache_ByPass_Set(QSPI_FLASH_PORT, FALSE);
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, TRUE);
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    QSPI_Flash_GetPart
+  * @brief   当前器件参数
+  * @param   无
+  * @retval  未识别时为 NULL
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+const QSPI_Flash_Part *QSPI_Flash_GetPart(void) {
+    return qf_part;
+}
+
+/**
+  * @Name    QSPI_Flash_DmaRead
+  * @brief   一次命令口 DMA 读
+  * @param   Addr: 闪存地址
+  * @param   Buff: 4 字节对齐
+  * @param   Size: QSPI_FLASH_FIFO_CHUNK 的整数倍, 不大于 QSPI_FLASH_DMA_MAX
+  * @retval  SUCCESS / ERROR(DMA 传输错误)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DMA 请求在 FIFO 达到阈值时产生, 所以长度取阈值的整数倍, 不会有剩在 FIFO 里取不走的数据.
+ **/
+static error_status QSPI_Flash_DmaRead(uint32_t Addr, uint32_t *Buff, uint32_t Size) {
+    DMA_Init_Type dma;
+    error_status ret = SUCCESS;
+
+    DMA_Reset(QSPI_FLASH_DMA_CHANNEL);
+    DMA_Default_Para_Init(&dma);
+    dma.Peripheral_Base_Addr = (uint32_t)&QSPI_FLASH_PORT->dt;
+    dma.Memory_Base_Addr = (uint32_t)Buff;
+    dma.direction = DMA_Dir_PERIPHERAL_To_MEMORY;
+    dma.Buffer_Size = (uint16_t)(Size / 4);
+    dma.Peripheral_Inc_Enable = FALSE;
+    dma.Memory_Inc_Enable = TRUE;
+    dma.Peripheral_Data_Width = DMA_Peripheral_Data_Width_WORD;
+    dma.Memory_Data_Width = DMA_Memory_Data_Width_WORD;
+    dma.Loop_Mode_Enable = FALSE;
+    dma.priority = DMA_Priority_HIGH;
+    DMA_Init(QSPI_FLASH_DMA_CHANNEL, &dma);
+    DMA_Flexible_Config(QSPI_FLASH_DMA, QSPI_FLASH_DMAMUX_CHANNEL, QSPI_FLASH_DMAREQ);
+
+    QSPI_DMA_RX_Threshold_Set(QSPI_FLASH_PORT, QSPI_DMA_FIFO_THOD_WORD08);
+    QSPI_DMA_Enable(QSPI_FLASH_PORT, TRUE);
+    DMA_Channel_Enable(QSPI_FLASH_DMA_CHANNEL, TRUE);
+
+    QSPI_Flash_Cmd(qf_part->ReadCmd, Addr, qf_part->AddrLen, Size, qf_part->ReadDummy, qf_part->ReadMode, FALSE);
+
+    while(DMA_Flag_Get(QSPI_FLASH_DMA_FDT_FLAG) == RESET) {
+        if(DMA_Flag_Get(QSPI_FLASH_DMA_ERR_FLAG) != RESET) {
+            ret = ERROR;
+            break;
+        }
+    }
+
+    QSPI_Flash_WaitCmd();
+    DMA_Channel_Enable(QSPI_FLASH_DMA_CHANNEL, FALSE);
+    QSPI_DMA_Enable(QSPI_FLASH_PORT, FALSE);
+    DMA_Flag_Clear(QSPI_FLASH_DMA_GL_FLAG);
+
+    qf_stats.DmaReads++;
+    qf_stats.DmaBytes += Size;
+
+    return ret;
+}
+
+/**
+  * @Name    QSPI_Flash_Read
+  * @brief   批量读外部闪存(不经过 XIP 缓存)
+  * @param   Addr: 闪存内偏移地址(不是映射地址)
+  * @param   Buff: 缓冲区, 4 字节对齐时中间部分用 DMA
+  * @param   Size: 字节数
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          读的过程中 XIP 映射关闭, 调用者本身和期间可能进入的中断都不能在外部闪存中.
+          小块或随机访问的常量直接通过映射地址读更快, 本函数适合一次搬运几 KB 以上的资源.
+ **/
+error_status QSPI_Flash_Read(uint32_t Addr, void *Buff, uint32_t Size) {
+    uint8_t *p = (uint8_t *)Buff;
+    uint32_t n;
+    error_status ret = SUCCESS;
+
+    if(qf_part == NULL || Buff == NULL || Addr >= qf_part->Size || Size > qf_part->Size - Addr) return ERROR;
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, FALSE);
+
+    /* 先用 CPU 读到 4 字节对齐, 中间走 DMA, 尾部再用 CPU */
+    n = (4 - ((uint32_t)p & 3)) & 3;
+
+    if(n > Size) n = Size;
+
+    if(n) {
+        QSPI_Flash_CpuRead(qf_part->ReadCmd, Addr, qf_part->AddrLen, qf_part->ReadDummy, qf_part->ReadMode, p, n);
+        Addr += n;
+        p += n;
+        Size -= n;
+    }
+
+    while(ret == SUCCESS && Size >= QSPI_FLASH_FIFO_CHUNK) {
+        n = Size & ~(uint32_t)(QSPI_FLASH_FIFO_CHUNK - 1);
+
+        if(n > QSPI_FLASH_DMA_MAX) n = QSPI_FLASH_DMA_MAX;
+
+        ret = QSPI_Flash_DmaRead(Addr, (uint32_t *)p, n);
+        Addr += n;
+        p += n;
+        Size -= n;
+    }
+
+    if(ret == SUCCESS && Size) {
+        QSPI_Flash_CpuRead(qf_part->ReadCmd, Addr, qf_part->AddrLen, qf_part->ReadDummy, qf_part->ReadMode, p, Size);
+    }
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, TRUE);
+
+    return ret;
+}
+
+/**
+  * @Name    QSPI_Flash_EraseSector
+  * @brief   擦除 Addr 所在的 4KB 扇区
+  * @param   Addr: 闪存内偏移地址
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          擦除期间(几十毫秒) XIP 映射关闭, 限制同 QSPI_Flash_Read.
+ **/
+error_status QSPI_Flash_EraseSector(uint32_t Addr) {
+    if(qf_part == NULL || Addr >= qf_part->Size) return ERROR;
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, FALSE);
+    QSPI_Flash_Simple(QSPI_FLASH_CMD_WREN);
+    QSPI_Flash_Cmd(qf_part->EraseCmd, Addr & ~(uint32_t)(QSPI_FLASH_SECTOR_SIZE - 1), qf_part->AddrLen, 0, 0,
+                   QSPI_OPERATE_Mode_111, FALSE);
+    QSPI_Flash_WaitCmd();
+    QSPI_Flash_WaitBusy();
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, TRUE);
+
+    qf_stats.Erases++;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    QSPI_Flash_Program
+  * @brief   编程外部闪存, 按页边界拆分
+  * @param   Addr: 闪存内偏移地址
+  * @param   Data: 数据, 不能在外部闪存中
+  * @param   Size: 字节数
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          目标区域须已擦除. 开启加密时写入的是加密后的数据.
+ **/
+error_status QSPI_Flash_Program(uint32_t Addr, const void *Data, uint32_t Size) {
+    const uint8_t *p = (const uint8_t *)Data;
+    uint32_t n;
+
+    if(qf_part == NULL || Data == NULL || Addr >= qf_part->Size || Size > qf_part->Size - Addr) return ERROR;
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, FALSE);
+
+    while(Size) {
+        n = QSPI_FLASH_PAGE_SIZE - (Addr & (QSPI_FLASH_PAGE_SIZE - 1));
+
+        if(n > Size) n = Size;
+
+        QSPI_Flash_Simple(QSPI_FLASH_CMD_WREN);
+        QSPI_Flash_CpuWrite(qf_part->ProgCmd, Addr, qf_part->AddrLen, qf_part->ProgMode, p, n);
+        QSPI_Flash_WaitBusy();
+
+        Addr += n;
+        p += n;
+        Size -= n;
+        qf_stats.Programs++;
+    }
+
+    QSPI_Xip_Enable(QSPI_FLASH_PORT, TRUE);
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    QSPI_Flash_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  无
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void QSPI_Flash_GetStats(QSPI_Flash_Stats *Stats) {
+    *Stats = qf_stats;
+}
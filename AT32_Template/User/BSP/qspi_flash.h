@@ -0,0 +1,92 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : qspi_flash.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : QSPI 外部闪存: XIP 直接执行 + 命令口 DMA 批量读
+                   初始化时读 JEDEC ID 查表, 按器件设置四线 I/O 读指令、空周期、时钟分频和 QE 位,
+                   然后切到 XIP 模式, 外部闪存映射到 QSPI_FLASH_MEM_BASE.
+                   用 QSPI_FLASH_CODE / QSPI_FLASH_CONST 标记的函数和常量由 Project/Template.sct
+                   放到外部闪存; 中断服务函数和 QSPI_Flash_xxx 的调用链必须留在片内闪存,
+                   因为命令口操作期间 XIP 映射不可访问.
+                   QSPI 引脚复用由用户在调用 QSPI_Flash_Init 之前配置.
+  * Function List:
+                   QSPI_Flash_Init
+                   QSPI_Flash_GetPart
+                   QSPI_Flash_Read
+                   QSPI_Flash_EraseSector
+                   QSPI_Flash_Program
+                   QSPI_Flash_GetStats
+  ******************************************************
+**/
+
+#ifndef __QSPI_FLASH_H_
+#define __QSPI_FLASH_H_
+
+#include "at32f435_437.h"
+
+#define QSPI_FLASH_PORT             QSPI1
+#define QSPI_FLASH_CLOCK            CRM_QSPI1_Periph_CLOCK
+#define QSPI_FLASH_MEM_BASE         QSPI1_Mem_BASE
+#define QSPI_FLASH_DMAREQ           DMAMUX_DMAREQ_ID_QSPI1
+
+#define QSPI_FLASH_DMA              DMA2
+#define QSPI_FLASH_DMA_CLOCK        CRM_DMA2_Periph_CLOCK
+#define QSPI_FLASH_DMA_CHANNEL      DMA2_ChanneL1
+#define QSPI_FLASH_DMAMUX_CHANNEL   DMA2MUX_ChanneL1
+#define QSPI_FLASH_DMA_FDT_FLAG     DMA2_FDT1_FLAG
+#define QSPI_FLASH_DMA_ERR_FLAG     DMA2_DTERR1_FLAG
+#define QSPI_FLASH_DMA_GL_FLAG      DMA2_GL1_FLAG
+
+#define QSPI_FLASH_PREFETCH         0x1F    //XIP 读 D 模式: 每次取指/取数后预读的计数, 越大顺序执行越快
+#define QSPI_FLASH_PAGE_SIZE        256
+#define QSPI_FLASH_SECTOR_SIZE      4096
+
+/* 放到外部闪存的冷代码和大常量, 须在 QSPI_Flash_Init 成功之后才能访问 */
+#define QSPI_FLASH_CODE             __attribute__((section(".qspi_text"), noinline))
+#define QSPI_FLASH_CONST            __attribute__((section(".qspi_rodata")))
+
+/* QE 位设置方法 */
+#define QSPI_FLASH_QE_NONE          0       //不需要或出厂已置位
+#define QSPI_FLASH_QE_SR2_BIT1      1       //用 0x35/0x31 读写状态寄存器 2 的 bit1
+#define QSPI_FLASH_QE_SR1_BIT6      2       //用 0x05/0x01 读写状态寄存器 1 的 bit6
+
+/* 器件参数 */
+typedef struct {
+    uint32_t JedecId;           //厂商 ID << 16 | 存储类型 << 8 | 容量
+    uint32_t Size;              //字节数
+    uint8_t  ReadCmd;           //四线读指令, 3 字节地址用 0xEB, 4 字节地址用 0xEC
+    uint8_t  ReadDummy;         //地址之后的空周期, 含 2 个模式位周期
+    uint8_t  ReadMode;          //QSPI_operate_Mode_Type
+    uint8_t  AddrLen;           //3 或 4
+    uint8_t  ProgCmd;           //页编程指令
+    uint8_t  ProgMode;          //QSPI_operate_Mode_Type
+    uint8_t  EraseCmd;          //4KB 扇区擦除指令
+    uint8_t  QeMethod;
+    uint8_t  ClkDiv;            //QSPI_CLK_Div_Type, 按器件四线读的最高频率选
+} QSPI_Flash_Part;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t DmaReads;          //命令口 DMA 读次数
+    uint32_t DmaBytes;
+    uint32_t CpuBytes;          //DMA 读不了的头尾部分由 CPU 读
+    uint32_t Programs;
+    uint32_t Erases;
+} QSPI_Flash_Stats;
+
+error_status QSPI_Flash_Init(confirm_state Encrypt);
+const QSPI_Flash_Part *QSPI_Flash_GetPart(void);
+error_status QSPI_Flash_Read(uint32_t Addr, void *Buff, uint32_t Size);
+error_status QSPI_Flash_EraseSector(uint32_t Addr);
+error_status QSPI_Flash_Program(uint32_t Addr, const void *Data, uint32_t Size);
+void QSPI_Flash_GetStats(QSPI_Flash_Stats *Stats);
+
+#endif
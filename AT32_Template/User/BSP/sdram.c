@@ -0,0 +1,179 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : XMC 外部 SDRAM
+                   1. SDRAM 时钟 = HCLK / 分频(2/3/4), 取不超过 MaxHz 的最小分频;
+                   2. 时序由 SDRAM_PlanTiming 换算, 超过 16 个周期时返回 SDRAM_ERR_TIMING;
+                   3. 刷新计数 = 刷新间隔 - 20, 20 个周期留给正在进行的访问;
+                   4. 分配、查 bank 和测试过程在 Common/sdram_plan.c, 这里只负责寄存器、上电序列和 DWT 计时.
+  * Function List:
+
+  **********************************************************
+ */
+#include "sdram.h"
+#include "stddef.h"
+
+#define SDRAM_REFRESH_MIN       41      //刷新计数下限
+#define SDRAM_REFRESH_MAX       0x1FFF
+#define SDRAM_REFRESH_MARGIN    20
+
+static int32_t SDRAM_Command(XMC_Command_Type Cmd, XMC_SDRAM_bank_Type Bank, uint32_t Refresh, uint32_t Data) {
+    XMC_SDRAM_CMD_Type cmd;
+    uint32_t timeout = SDRAM_TIMEOUT;
+
+    cmd.cmd = Cmd;
+    cmd.cmd_banks = Bank == XMC_SDRAM_BANK1 ? XMC_CMD_BANK1 : XMC_CMD_BANK2;
+    cmd.auto_refresh = Refresh;
+    cmd.data = Data;
+    XMC_SDRAM_CMD(&cmd);
+
+    while(XMC_Flag_Status_Get(XMC_BANK5_6_SDRAM, XMC_Busy_FLAG) != RESET) {
+        if(--timeout == 0) return SDRAM_ERR_TIMEOUT;
+    }
+
+    return SDRAM_OK;
+}
+
+/**
+  * @Name    SDRAM_Setup
+  * @brief   按器件参数初始化 SDRAM
+  * @param   Config: 器件参数, Device 0 / 1 对应 XMC_SDRAM_BANK1 / XMC_SDRAM_BANK2
+  * @param   Info: 输出实际时钟、容量和刷新计数, 可以为 NULL
+  * @retval  SDRAM_OK / SDRAM_ERR_xxx
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在系统时钟配置完成后调用, 改变 HCLK 后须重新调用. 初始化会清空分配器.
+          支持列 8~11 位、行 11~13 位、8/16 位宽、CAS 1~3、ReadDelay 0~2.
+          模式寄存器: 突发长度 1、顺序突发、写为单次访问, 连续访问由控制器合并.
+ **/
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info) {
+    XMC_SDRAM_Init_Type init;
+    XMC_SDRAM_Timing_Type timing;
+    CRM_Clocks_Freq_Type clocks;
+    SDRAM_Timing t;
+    SDRAM_Info info;
+    XMC_SDRAM_bank_Type bank;
+    uint32_t hz, refresh, i;
+    int32_t ret;
+    uint8_t div;
+
+    (void)SDRAM_Attach(NULL);
+
+    if(Config->Device > 1 || Config->ColBits < 8 || Config->ColBits > 11 || Config->RowBits < 11 ||
+            Config->RowBits > 13 || (Config->Width != 8 && Config->Width != 16) || Config->Cas < 1 ||
+            Config->Cas > 3 || Config->ReadDelay > 2 || Config->tMRD < 1 || Config->tMRD > 16) return SDRAM_ERR_PARAM;
+
+    CRM_Clocks_Freq_Get(&clocks);
+
+    div = SDRAM_PickDiv(clocks.ahb_freq, Config->MaxHz, 2, 4);
+
+    if(div == 0) return SDRAM_ERR_CLOCK;
+
+    hz = clocks.ahb_freq / div;
+    ret = SDRAM_PlanTiming(Config, hz, &t);
+
+    if(ret != SDRAM_OK) return ret;
+
+    if(t.tRCD > 16 || t.tRP > 16 || t.tRC > 16 || t.tRAS > 16 || t.tXSR > 16 || t.tWR > 16) return SDRAM_ERR_TIMING;
+
+    if(t.Refresh < SDRAM_REFRESH_MIN + SDRAM_REFRESH_MARGIN) return SDRAM_ERR_REFRESH;
+
+    refresh = t.Refresh - SDRAM_REFRESH_MARGIN;
+
+    if(refresh > SDRAM_REFRESH_MAX) refresh = SDRAM_REFRESH_MAX;
+
+    bank = Config->Device == 0 ? XMC_SDRAM_BANK1 : XMC_SDRAM_BANK2;
+
+    CRM_Periph_Clock_Enable(CRM_XMC_Periph_CLOCK, TRUE);
+
+    XMC_SDRAM_Default_Para_Init(&init, &timing);
+    init.sdram_bank = bank;
+    init.internel_banks = Config->InBanks == 4 ? XMC_INBK_4 : XMC_INBK_2;
+    init.clkdiv = div == 2 ? XMC_CLKDIV_2 : (div == 3 ? XMC_CLKDIV_3 : XMC_CLKDIV_4);
+    init.write_protection = FALSE;
+    init.burst_Read = Config->ReadBurst ? TRUE : FALSE;
+    init.read_delay = Config->ReadDelay;
+    init.column_Address = (XMC_SDRAM_column_Type)(Config->ColBits - 8);
+    init.row_Address = (XMC_SDRAM_row_Type)(Config->RowBits - 11);
+    init.cas = (XMC_SDRAM_cas_Type)Config->Cas;
+    init.width = Config->Width == 16 ? XMC_Mem_Width_16 : XMC_Mem_Width_8;
+
+    timing.tmrd = (XMC_SDRAM_Delay_Type)(Config->tMRD - 1);
+    timing.txsr = (XMC_SDRAM_Delay_Type)(t.tXSR - 1);
+    timing.tras = (XMC_SDRAM_Delay_Type)(t.tRAS - 1);
+    timing.trc = (XMC_SDRAM_Delay_Type)(t.tRC - 1);
+    timing.twr = (XMC_SDRAM_Delay_Type)(t.tWR - 1);
+    timing.trp = (XMC_SDRAM_Delay_Type)(t.tRP - 1);
+    timing.trcd = (XMC_SDRAM_Delay_Type)(t.tRCD - 1);
+    XMC_SDRAM_Init(&init, &timing);
+
+    /* JEDEC 上电序列: 时钟稳定至少 100us 后预充电, 至少 2 次自动刷新(这里 8 次), 再装载模式寄存器 */
+    ret = SDRAM_Command(XMC_CMD_CLK, bank, 0, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    for(i = SystemCoreClock / 10000; i > 0; i--) __NOP();
+
+    ret = SDRAM_Command(XMC_CMD_PRECHARG_ALL, bank, 0, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    ret = SDRAM_Command(XMC_CMD_Auto_REFRESH, bank, 8, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    ret = SDRAM_Command(XMC_CMD_LOAD_Mode, bank, 0, 0x0200 | ((uint32_t)Config->Cas << 4));
+
+    if(ret != SDRAM_OK) return ret;
+
+    XMC_SDRAM_Refresh_Counter_Set(refresh);
+
+    info.Base = Config->Device == 0 ? SDRAM_BANK1_BASE : SDRAM_BANK2_BASE;
+    info.RowSize = (1UL << Config->ColBits) * (Config->Width / 8);
+    info.BankSize = info.RowSize << Config->RowBits;
+    info.Size = info.BankSize * Config->InBanks;
+    info.ClockHz = hz;
+    info.Refresh = (uint16_t)refresh;
+    info.Div = div;
+    info.InBanks = Config->InBanks;
+    info.Map = SDRAM_MAP_BANK_ROW_COL;
+
+    if(Info) *Info = info;
+
+    return SDRAM_Attach(&info);
+}
+
+/**
+  * @Name    SDRAM_Bench
+  * @brief   测量当前配置的带宽
+  * @param   Buf: 测试缓冲, 顺序写会改写其内容
+  * @param   Bytes: 测试缓冲大小, 每项测试访问 Bytes 字节
+  * @param   Result: 输出, 单位 KB/s
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          关中断后用 DWT 计数执行 SDRAM_BenchRun. 不同 ReadBurst/ReadDelay/CAS 或 HCLK 下分别初始化后
+          调用, 比较结果选择配置; SameBankRead 与 CrossBankRead 之差就是缓冲放在同一 bank 的代价.
+ **/
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result) {
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+
+    __Disable_irq();
+
+    SDRAM_BenchRun(Buf, Bytes, &DWT->CYCCNT, SystemCoreClock, Result);
+
+    __Enable_irq();
+}
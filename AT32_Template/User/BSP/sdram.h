@@ -0,0 +1,41 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : XMC 外部 SDRAM 初始化和带宽测试
+                   时序参数按器件手册填写纳秒值(SDRAM_Config, 见 Common/sdram_plan.h), 初始化时按 HCLK
+                   和分频换算成周期数并计算刷新计数, 然后执行 JEDEC 上电序列
+                   (时钟使能 -> 预充电 -> 自动刷新 -> 装载模式寄存器).
+                   XMC 地址映射为 [内部 bank][行][列], 每个内部 bank 是连续的 1/4(或 1/2) 空间,
+                   用 SDRAM_Alloc 把同时访问的缓冲放在不同 bank.
+                   Device 0 / 1 对应 XMC_SDRAM_BANK1(SDNE0) / XMC_SDRAM_BANK2(SDNE1).
+                   XMC 引脚复用由用户在调用 SDRAM_Setup 之前配置.
+  * Function List:
+                   SDRAM_Setup
+                   SDRAM_Bench
+  ******************************************************
+**/
+
+#ifndef __SDRAM_H_
+#define __SDRAM_H_
+
+#include "at32f435_437.h"
+#include "sdram_plan.h"
+
+#define SDRAM_BANK1_BASE        0xC0000000      //XMC_SDRAM_BANK1(SDNE0)
+#define SDRAM_BANK2_BASE        0xD0000000      //XMC_SDRAM_BANK2(SDNE1)
+
+#define SDRAM_TIMEOUT           0xFFFF
+
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info);
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result);
+
+#endif
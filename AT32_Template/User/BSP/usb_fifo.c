@@ -0,0 +1,151 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : usb_fifo.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : OTG 设备模式 FIFO 分配
+                   1. 接收 FIFO 所有 OUT 端点共用, 最低深度按内核手册公式:
+                      (4 * 控制端点数 + 6) + (最大 OUT 包长 / 4 + 1) + 2 * OUT 端点数 + 1,
+                      前两项为 SETUP 包和状态字, 后两项为每个端点的传输完成状态;
+                   2. 每个 IN 端点的发送 FIFO 至少能放一包且不小于 USBFIFO_TX_MIN;
+                   3. 剩余空间每轮给每个等时/批量 IN 端点加一包、给接收 FIFO 加一个最大
+                      等时/批量 OUT 包, 等时优先, 直到放不下或达到包数上限; 多出的全部给接收 FIFO.
+                      发送 FIFO 能放两包以上时, CPU 在上一包发送期间就能写入下一包.
+  * Function List:
+
+  **********************************************************
+ */
+#include "usb_fifo.h"
+#include "string.h"
+
+static uint16_t USBFifo_Words(uint16_t Bytes) {
+    return (uint16_t)((Bytes + 3) / 4);
+}
+
+/**
+  * @Name    USBFifo_Plan
+  * @brief   计算 FIFO 分配
+  * @param   Epts: 端点配置, 包括端点 0 的 IN 和 OUT
+  * @param   Num: 端点个数
+  * @param   TotalWords: FIFO RAM 大小, 一般为 OTG_FIFO_SIZE
+  * @param   Layout: 输出
+  * @retval  SUCCESS / ERROR(端点配置非法或最低要求已超过 FIFO RAM)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只做计算, 不访问寄存器, 可以在初始化前离线核对各种端点组合.
+ **/
+error_status USBFifo_Plan(const USBFifo_Ept *Epts, uint8_t Num, uint16_t TotalWords, USBFifo_Layout *Layout) {
+    uint16_t pkt[USBFIFO_EPT_NUM];      //等时/批量 IN 端点每包字数, 0 表示不参与分配
+    uint8_t iso[USBFIFO_EPT_NUM];
+    uint8_t cnt[USBFIFO_EPT_NUM];
+    uint16_t max_Out = 0, bulk_Out = 0;
+    uint8_t num_Ctrl = 0, num_Out = 0, rx_Cnt = 0, pass, grew;
+    uint32_t used, i;
+
+    memset(Layout, 0, sizeof(*Layout));
+    memset(pkt, 0, sizeof(pkt));
+    memset(iso, 0, sizeof(iso));
+    memset(cnt, 0, sizeof(cnt));
+
+    for(i = 0; i < Num; i++) {
+        if(Epts[i].Ept >= USBFIFO_EPT_NUM || Epts[i].MaxPacket == 0 ||
+                Epts[i].MaxPacket > (Epts[i].Type == EPT_ISO_Type ? 1023 : 64)) return ERROR;
+
+        if(Epts[i].Dir == EPT_Dir_IN) {
+            Layout->Tx[Epts[i].Ept] = USBFifo_Words(Epts[i].MaxPacket);
+
+            if(Layout->Tx[Epts[i].Ept] < USBFIFO_TX_MIN) Layout->Tx[Epts[i].Ept] = USBFIFO_TX_MIN;
+
+            if(Epts[i].Type == EPT_ISO_Type || Epts[i].Type == EPT_BULK_Type) {
+                pkt[Epts[i].Ept] = USBFifo_Words(Epts[i].MaxPacket);
+                iso[Epts[i].Ept] = (uint8_t)(Epts[i].Type == EPT_ISO_Type);
+                cnt[Epts[i].Ept] = (uint8_t)(Layout->Tx[Epts[i].Ept] / pkt[Epts[i].Ept]);
+            }
+        } else {
+            num_Out++;
+
+            if(Epts[i].Type == EPT_Control_Type) num_Ctrl++;
+
+            if(Epts[i].MaxPacket > max_Out) max_Out = Epts[i].MaxPacket;
+
+            if((Epts[i].Type == EPT_ISO_Type || Epts[i].Type == EPT_BULK_Type) && Epts[i].MaxPacket > bulk_Out) {
+                bulk_Out = Epts[i].MaxPacket;
+            }
+        }
+    }
+
+    if(Layout->Tx[0] == 0) Layout->Tx[0] = USBFIFO_TX_MIN;
+
+    Layout->Rx = (uint16_t)((4 * num_Ctrl + 6) + (USBFifo_Words(max_Out) + 1) + 2 * num_Out + 1);
+
+    used = Layout->Rx;
+
+    for(i = 0; i < USBFIFO_EPT_NUM; i++) used += Layout->Tx[i];
+
+    if(used > TotalWords) return ERROR;
+
+    /* 第 0 遍只给等时端点, 第 1 遍给批量端点和接收 FIFO */
+    for(pass = 0; pass < 2; pass++) {
+        do {
+            grew = 0;
+
+            for(i = 0; i < USBFIFO_EPT_NUM; i++) {
+                if(pkt[i] == 0 || iso[i] != (pass == 0) || cnt[i] >= USBFIFO_TX_PACKETS) continue;
+
+                if(used + pkt[i] > TotalWords) continue;
+
+                Layout->Tx[i] += pkt[i];
+                used += pkt[i];
+                cnt[i]++;
+                grew = 1;
+            }
+
+            if(pass == 1 && bulk_Out != 0 && rx_Cnt < USBFIFO_RX_PACKETS - 1 &&
+                    used + USBFifo_Words(bulk_Out) <= TotalWords) {
+                Layout->Rx += USBFifo_Words(bulk_Out);
+                used += USBFifo_Words(bulk_Out);
+                rx_Cnt++;
+                grew = 1;
+            }
+        } while(grew);
+    }
+
+    Layout->Rx += (uint16_t)(TotalWords - used);
+    Layout->Used = TotalWords;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    USBFifo_Apply
+  * @brief   把分配结果写入 OTG 并清空 FIFO
+  * @param   usbx: OTG1_GLOBAL 或 OTG2_GLOBAL
+  * @param   Layout: USBFifo_Plan 的结果
+  * @retval  无
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在 USB 复位或枚举前调用. USB_Set_TX_FIFO 按前面各 FIFO 的深度累加起始地址,
+          所以从接收 FIFO 开始按编号顺序全部写一遍.
+ **/
+void USBFifo_Apply(OTG_Global_Type *usbx, const USBFifo_Layout *Layout) {
+    uint8_t i;
+
+    USB_Set_RX_FIFO(usbx, Layout->Rx);
+
+    for(i = 0; i < USBFIFO_EPT_NUM; i++) {
+        USB_Set_TX_FIFO(usbx, i, Layout->Tx[i]);
+    }
+
+    USB_Flush_TX_FIFO(usbx, 16);
+    USB_Flush_RX_FIFO(usbx);
+}
@@ -0,0 +1,51 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : usb_fifo.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : OTG 设备模式 FIFO 分配
+                   按端点配置计算接收 FIFO 和每个 IN 端点专用发送 FIFO 的深度(单位: 字),
+                   先满足最低要求, 剩余空间按包长轮流分给等时/批量端点做多包缓冲,
+                   最后全部给接收 FIFO. 取代手工填写 USB_Set_RX_FIFO/USB_Set_TX_FIFO 的大小.
+  * Function List:
+                   USBFifo_Plan
+                   USBFifo_Apply
+  ******************************************************
+**/
+
+#ifndef __USB_FIFO_H_
+#define __USB_FIFO_H_
+
+#include "at32f435_437.h"
+
+#define USBFIFO_EPT_NUM         8       //端点 0~7, 发送 FIFO 编号与端点号相同(USB_EPT_Open)
+#define USBFIFO_TX_MIN          16      //每个发送 FIFO 的最小深度
+#define USBFIFO_TX_PACKETS      4       //等时/批量 IN 端点最多缓冲的包数, 再多全速下已无收益
+#define USBFIFO_RX_PACKETS      4       //接收 FIFO 为等时/批量 OUT 端点最多缓冲的包数
+
+/* 端点配置 */
+typedef struct {
+    uint8_t  Ept;               //端点号 0~7
+    uint8_t  Dir;               //EPT_Dir_IN / EPT_Dir_Out
+    uint8_t  Type;              //EPT_Control_Type / EPT_ISO_Type / EPT_BULK_Type / EPT_INT_Type
+    uint16_t MaxPacket;
+} USBFifo_Ept;
+
+/* 分配结果, 单位: 字 */
+typedef struct {
+    uint16_t Rx;
+    uint16_t Tx[USBFIFO_EPT_NUM];   //未使用的 IN 端点为 0, 端点 0 至少 USBFIFO_TX_MIN
+    uint16_t Used;
+} USBFifo_Layout;
+
+error_status USBFifo_Plan(const USBFifo_Ept *Epts, uint8_t Num, uint16_t TotalWords, USBFifo_Layout *Layout);
+void USBFifo_Apply(OTG_Global_Type *usbx, const USBFifo_Layout *Layout);
+
+#endif
@@ -0,0 +1,320 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 任意波形播放
+                   1. TMR6 溢出事件作 TRGO, 同时触发 DAC1/DAC2, 每次触发 DAC 发一次 DMA 请求;
+                   2. 双通道只用 DAC1 的 DMA 请求, 32 位写双通道 12 位右对齐寄存器同时装入两路数据;
+                   3. 改采样率只改分频和周期值, 两者都带缓冲, 在下一个溢出事件生效, 输出不中断;
+                   4. 流播放: DMA 在 2 * Samples 个样本上循环, 半传输中断时第 0 块播完,
+                      全传输中断时第 1 块播完; DMA 当前所在的块由剩余计数判断.
+  * Function List:
+
+  **********************************************************
+ */
+#include "wave_player.h"
+
+#define WAVE_TIMER              TMR6
+
+static uint8_t wave_channels;
+static DAC_Select_Type wave_dac;                //发 DMA 请求的 DAC
+static Wave_Stream wave_stream;
+
+/**
+  * @Name    Wave_TimerClock
+  * @brief   TMR6 计数时钟
+  * @param   None
+  * @retval  Hz
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          APB1 不分频(apb1div 小于 4)时等于 APB1, 分频时为 APB1 的 2 倍.
+ **/
+static uint32_t Wave_TimerClock(void) {
+    CRM_Clocks_Freq_Type clocks;
+
+    CRM_Clocks_Freq_Get(&clocks);
+
+    if(CRM->cfg_bit.apb1div < 4) return clocks.apb1_freq;
+
+    return clocks.apb1_freq * 2;
+}
+
+/**
+  * @Name    Wave_CheckUnderrun
+  * @brief   检查并恢复 DAC DMA 欠载
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          欠载后 DAC 不再发 DMA 请求, 清标志并重新使能 DMA 请求后继续.
+ **/
+static void Wave_CheckUnderrun(void) {
+    if(wave_channels == 0 || DAC_UDR_Flag_Get(wave_dac) == RESET) return;
+
+    DAC_UDR_Flag_Clear(wave_dac);
+    DAC_DMA_Enable(wave_dac, FALSE);
+    DAC_DMA_Enable(wave_dac, TRUE);
+    wave_stream.Stats.DacUnderruns++;
+}
+
+/**
+  * @Name    Wave_Init
+  * @brief   初始化引脚、DAC、TMR6 和 DMA 中断
+  * @param   Channels: WAVE_CH0 / WAVE_CH1 / WAVE_CH_BOTH
+  * @retval  WAVE_OK; 通道参数错误时 WAVE_ERR_PARAM
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int32_t Wave_Init(uint8_t Channels) {
+    GPIO_Init_Type gpio;
+
+    if(Channels == 0 || (Channels & ~WAVE_CH_BOTH) != 0) return WAVE_ERR_PARAM;
+
+    wave_channels = Channels;
+    wave_dac = Channels == WAVE_CH1 ? DAC2_Select : DAC1_Select;
+    wave_stream.Callback = 0;
+    wave_stream.Stats.DacUnderruns = 0;
+
+    CRM_Periph_Clock_Enable(CRM_GPIOA_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_DAC_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_TMR6_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_DMA1_Periph_CLOCK, TRUE);
+
+    GPIO_Default_Para_Init(&gpio);
+    gpio.GPIO_Pins = 0;
+
+    if(Channels & WAVE_CH0) gpio.GPIO_Pins |= GPIO_Pins_4;
+
+    if(Channels & WAVE_CH1) gpio.GPIO_Pins |= GPIO_Pins_5;
+
+    gpio.GPIO_Mode = GPIO_Mode_ANALOG;
+    gpio.GPIO_Pull = GPIO_Pull_NONE;
+    GPIO_Init(GPIOA, &gpio);
+
+    DAC_Reset();
+
+    if(Channels & WAVE_CH0) {
+        DAC_Trigger_Select(DAC1_Select, DAC_TMR6_Trgout_EVENT);
+        DAC_Trigger_Enable(DAC1_Select, TRUE);
+        DAC_OutPut_Buffer_Enable(DAC1_Select, TRUE);
+        DAC_Enable(DAC1_Select, TRUE);
+    }
+
+    if(Channels & WAVE_CH1) {
+        DAC_Trigger_Select(DAC2_Select, DAC_TMR6_Trgout_EVENT);
+        DAC_Trigger_Enable(DAC2_Select, TRUE);
+        DAC_OutPut_Buffer_Enable(DAC2_Select, TRUE);
+        DAC_Enable(DAC2_Select, TRUE);
+    }
+
+    TMR_Reset(WAVE_TIMER);
+    TMR_Base_Init(WAVE_TIMER, 0xFFFF, 0);
+    TMR_Period_Buffer_Enable(WAVE_TIMER, TRUE);
+    TMR_Primary_Mode_Select(WAVE_TIMER, TMR_Primary_SEL_OVERFLOW);
+
+    NVIC_IRQ_Enable(WAVE_DMA_IRQn, WAVE_IRQ_PRIORITY, 0);
+
+    return WAVE_OK;
+}
+
+/**
+  * @Name    Wave_SetRate
+  * @brief   设置采样率, 播放中也可调用
+  * @param   Rate: 采样率(Hz)
+  * @retval  实际采样率(Hz, 向下取整)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          分频 1~65536 任意, 由 Wave_PlanRate 换算.
+ **/
+uint32_t Wave_SetRate(uint32_t Rate) {
+    uint32_t div, period, actual;
+
+    actual = Wave_PlanRate(Wave_TimerClock(), Rate, 65536, 0, &div, &period);
+    TMR_Div_Value_Set(WAVE_TIMER, div - 1);
+    TMR_Period_Value_Set(WAVE_TIMER, period - 1);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_DMAStart
+  * @brief   配置并启动 DMA 和 TMR6
+  * @param   Buf: 循环播放的缓冲
+  * @param   Samples: 缓冲中的样本数
+  * @param   Stream: 1: 打开半传输和全传输中断
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void Wave_DMAStart(const void *Buf, uint32_t Samples, uint8_t Stream) {
+    DMA_Init_Type dma;
+
+    DMA_Reset(WAVE_DMA_CHANNEL);
+    DMA_Default_Para_Init(&dma);
+
+    if(wave_channels == WAVE_CH_BOTH) {
+        dma.Peripheral_Base_Addr = (uint32_t)DAC_Dual_12BIT_RIGHT;
+        dma.Peripheral_Data_Width = DMA_Peripheral_Data_Width_WORD;
+        dma.Memory_Data_Width = DMA_Memory_Data_Width_WORD;
+    } else {
+        dma.Peripheral_Base_Addr = wave_channels == WAVE_CH0 ? (uint32_t)DAC1_12BIT_RIGHT : (uint32_t)DAC2_12BIT_RIGHT;
+        dma.Peripheral_Data_Width = DMA_Peripheral_Data_Width_HALFWORD;
+        dma.Memory_Data_Width = DMA_Memory_Data_Width_HALFWORD;
+    }
+
+    dma.Memory_Base_Addr = (uint32_t)Buf;
+    dma.direction = DMA_Dir_Memory_To_PERIPHERAL;
+    dma.Buffer_Size = (uint16_t)Samples;
+    dma.Peripheral_Inc_Enable = FALSE;
+    dma.Memory_Inc_Enable = TRUE;
+    dma.Loop_Mode_Enable = TRUE;
+    dma.priority = DMA_Priority_VERY_HIGH;
+    DMA_Init(WAVE_DMA_CHANNEL, &dma);
+    DMA_Flexible_Config(WAVE_DMA, WAVE_DMAMUX_CHANNEL,
+                        wave_dac == DAC2_Select ? DMAMUX_DMAREQ_ID_DAC2 : DMAMUX_DMAREQ_ID_DAC1);
+
+    if(Stream) {
+        DMA_Flag_Clear(WAVE_DMA_HDT_FLAG | WAVE_DMA_FDT_FLAG);
+        DMA_Interrupt_Enable(WAVE_DMA_CHANNEL, DMA_HDT_INT | DMA_FDT_INT, TRUE);
+    }
+
+    DAC_UDR_Flag_Clear(wave_dac);
+    DMA_Channel_Enable(WAVE_DMA_CHANNEL, TRUE);
+    DAC_DMA_Enable(wave_dac, TRUE);
+
+    TMR_Counter_Value_Set(WAVE_TIMER, 0);
+    TMR_Counter_Enable(WAVE_TIMER, TRUE);
+}
+
+/**
+  * @Name    Wave_PlayTable
+  * @brief   循环播放一张波形表
+  * @param   Table: 单通道 uint16_t[], 双通道 uint32_t[](Wave_Pack 生成), 播放期间不得修改
+  * @param   Samples: 样本数, 1~WAVE_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz), 输出频率 = Rate / Samples
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Table == 0 || Samples == 0 || Samples > WAVE_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    wave_stream.Callback = 0;
+    actual = Wave_SetRate(Rate);
+    TMR_Event_SW_trigger(WAVE_TIMER, TMR_OverFlow_SWTRIG);
+    Wave_DMAStart(Table, Samples, 0);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_PlayStream
+  * @brief   双缓冲流播放
+  * @param   Buf: 连续的两块, 共 2 * Samples 个样本
+  * @param   Samples: 每块样本数, 1~WAVE_STREAM_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz)
+  * @param   Callback: 填块回调, 启动前先调用两次填满两块
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          回调必须在一块的播放时间(Samples / Rate)内返回.
+ **/
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Buf == 0 || Callback == 0 || Samples == 0 || Samples > WAVE_STREAM_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    Wave_StreamStart(&wave_stream, Buf, Samples, WAVE_SAMPLE_BYTES(wave_channels), Callback);
+
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+
+    actual = Wave_SetRate(Rate);
+    TMR_Event_SW_trigger(WAVE_TIMER, TMR_OverFlow_SWTRIG);
+    Wave_DMAStart(Buf, 2 * Samples, 1);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_Stop
+  * @brief   停止播放, 输出保持最后一个样本
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Wave_Stop(void) {
+    if(wave_channels == 0) return;
+
+    TMR_Counter_Enable(WAVE_TIMER, FALSE);
+    DAC_DMA_Enable(wave_dac, FALSE);
+    DMA_Interrupt_Enable(WAVE_DMA_CHANNEL, DMA_HDT_INT | DMA_FDT_INT, FALSE);
+    DMA_Channel_Enable(WAVE_DMA_CHANNEL, FALSE);
+    DMA_Flag_Clear(WAVE_DMA_HDT_FLAG | WAVE_DMA_FDT_FLAG);
+}
+
+static uint8_t Wave_Playing(void) {
+    return DMA_Data_Number_Get(WAVE_DMA_CHANNEL) <= wave_stream.Samples ? 1 : 0;
+}
+
+/**
+  * @Name    Wave_DMA_IRQHandler
+  * @brief   流播放的块完成中断, 在 DMA1_Channel1_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          半传输: 第 0 块播完; 全传输: 第 1 块播完. 两个标志都在时先处理第 0 块.
+ **/
+void Wave_DMA_IRQHandler(void) {
+    uint8_t half = DMA_Flag_Get(WAVE_DMA_HDT_FLAG) != RESET;
+    uint8_t full = DMA_Flag_Get(WAVE_DMA_FDT_FLAG) != RESET;
+
+    if(!half && !full) return;
+
+    DMA_Flag_Clear(WAVE_DMA_HDT_FLAG | WAVE_DMA_FDT_FLAG);
+    Wave_CheckUnderrun();
+
+    if(half) Wave_StreamDone(&wave_stream, 0, Wave_Playing, &DWT->CYCCNT);
+
+    if(full) Wave_StreamDone(&wave_stream, 1, Wave_Playing, &DWT->CYCCNT);
+}
+
+/**
+  * @Name    Wave_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          表播放不进中断, DAC 欠载在这里检查并恢复.
+ **/
+void Wave_GetStats(Wave_Stats *Stats) {
+    if(wave_stream.Callback == 0) Wave_CheckUnderrun();
+
+    *Stats = wave_stream.Stats;
+}
@@ -0,0 +1,59 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 任意波形播放(TMR6 定采样率, DMA1 通道1 搬运)
+                   接口与 STM32/GD32/HC32 模板的 wave_player.h 相同, 波形表生成、采样率换算和
+                   流播放的块管理在 Common/wave_gen.c.
+                   表播放: 循环 DMA 反复输出一张预先算好的表, 不占 CPU, 不进中断;
+                   流播放: 两块合成一个循环 DMA, 半传输和全传输中断各对应一块,
+                   每播完一块在中断里回调填这一块. AT32 的 DMA 没有双缓冲模式,
+                   两块共用一个 16 位计数, 每块不超过 WAVE_STREAM_MAX_SAMPLES.
+                   双通道时两路样本打包成一个字写入双通道 12 位右对齐寄存器, 由同一个 TRGO 触发,
+                   两路输出在同一时钟沿更新, 没有通道间偏移.
+                   引脚: PA4 = DAC1(WAVE_CH0), PA5 = DAC2(WAVE_CH1).
+  * Function List:
+                   Wave_Init
+                   Wave_PlayTable
+                   Wave_PlayStream
+                   Wave_SetRate
+                   Wave_Stop
+                   Wave_DMA_IRQHandler
+                   Wave_GetStats
+  ******************************************************
+**/
+
+#ifndef __WAVE_PLAYER_H_
+#define __WAVE_PLAYER_H_
+
+#include "at32f435_437.h"
+#include "wave_gen.h"
+
+/* DMA1 通道1 经 DMAMUX 接 DAC1 或 DAC2 的请求; 双通道只用 DAC1 的请求 */
+#define WAVE_DMA                DMA1
+#define WAVE_DMA_CHANNEL        DMA1_ChanneL1
+#define WAVE_DMAMUX_CHANNEL     DMA1MUX_ChanneL1
+#define WAVE_DMA_HDT_FLAG       DMA1_HDT1_FLAG
+#define WAVE_DMA_FDT_FLAG       DMA1_FDT1_FLAG
+#define WAVE_DMA_IRQn           DMA1_Channel1_IRQn
+#define WAVE_IRQ_PRIORITY       1
+
+#define WAVE_STREAM_MAX_SAMPLES (WAVE_MAX_SAMPLES / 2)
+
+int32_t Wave_Init(uint8_t Channels);
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate);
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback);
+uint32_t Wave_SetRate(uint32_t Rate);
+void Wave_Stop(void);
+void Wave_DMA_IRQHandler(void);
+void Wave_GetStats(Wave_Stats *Stats);
+
+#endif
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/calendar.c 的主机测试: 用主机编译器编译 calendar.c 和一个读标准输入的驱动,
+逐项与 Python datetime 的结果对照.
+
+    calendar_test.py [--cc gcc] [--step 7919] [--seed 1]
+        1. 校验 calendar.c 中 CAL_DIVxx_M/CAL_DIVxx_S 在注释给出的取值范围内等于真实除法;
+        2. 2000-01-01 ~ 2099-12-31 每一天取 00:00:00、23:59:59 和一个按 --step 变化的时刻,
+           以及第一天的每一秒, 检查 Cal_FromEpoch 的日期、时间、星期和 Cal_ToEpoch 往返;
+        3. 全部 256 个 BCD 码, 和各类越界日期(2 月 29/30 日、13 月、0 日、24 时、非法 BCD 码等)
+           必须返回 CAL_EPOCH_INVD.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 calendar.c 后运行一次.
+"""
+
+import argparse
+import datetime
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'calendar.c')
+BASE = datetime.datetime(2000, 1, 1)
+EPOCH_MAX = 3155759999
+EPOCH_INVD = 0xFFFFFFFF
+FMT_DEC, FMT_BCD = 0, 1
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include "calendar.h"
+
+int main(void) {
+    char op;
+    unsigned long a[7];
+    Cal_DateTime dt;
+
+    while (scanf(" %c", &op) == 1) {
+        if (op == 'F') {
+            if (scanf("%lu", &a[0]) != 1) return 2;
+            Cal_FromEpoch((uint32_t)a[0], &dt);
+            printf("%u %u %u %u %u %u %u %lu\n", dt.Year, dt.Month, dt.Day, dt.Weekday,
+                   dt.Hour, dt.Minute, dt.Second, (unsigned long)Cal_ToEpoch(CAL_FMT_DEC, &dt));
+        } else if (op == 'T') {
+            if (scanf("%lu %lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5], &a[6]) != 7) return 2;
+            dt.Year = (uint8_t)a[1]; dt.Month = (uint8_t)a[2]; dt.Day = (uint8_t)a[3];
+            dt.Hour = (uint8_t)a[4]; dt.Minute = (uint8_t)a[5]; dt.Second = (uint8_t)a[6];
+            dt.Weekday = 0U;
+            printf("%lu\n", (unsigned long)Cal_ToEpoch((uint8_t)a[0], &dt));
+        } else if (op == 'B') {
+            if (scanf("%lu", &a[0]) != 1) return 2;
+            printf("%u\n", Cal_Bcd2Dec((uint8_t)a[0]));
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def to_bcd(v):
+    return ((v // 10) << 4) | (v % 10)
+
+
+def check_magic(text):
+    """CAL_DIVd_M/_S 注释为 "x < 上限", 要求 x * M >> S == x // d 对所有 x 成立"""
+    errors = []
+    pattern = re.compile(r'#define\s+CAL_DIV(\d+)_M\s+(\d+)U?L*\s*//\s*x\s*<\s*([0-9^]+)')
+    found = pattern.findall(text)
+    if not found:
+        return ['calendar.c 中没有找到 CAL_DIVxx_M 定义']
+    for d, m, limit in found:
+        d, m = int(d), int(m)
+        xmax = (2 ** int(limit[2:])) - 1 if limit.startswith('2^') else int(limit) - 1
+        s = re.search(r'#define\s+CAL_DIV%d_S\s+(\d+)\b' % d, text)
+        if s is None:
+            errors.append('CAL_DIV%d_S 未定义' % d)
+            continue
+        s = int(s.group(1))
+        e = m * d - (1 << s)
+        # x * M / 2^S = x / d + x * e / (d * 2^S), 误差项小于 1/d 时取整不变
+        if e < 0 or e * xmax >= (1 << s):
+            errors.append('CAL_DIV%d: M=%d S=%d 在 x <= %d 时不精确' % (d, m, s, xmax))
+        elif d != 86400 and m * xmax >= (1 << 32):
+            errors.append('CAL_DIV%d: x * M 超出 32 位' % d)
+    return errors
+
+
+def expect_from(epoch):
+    t = BASE + datetime.timedelta(seconds=epoch)
+    return (t.year - 2000, t.month, t.day, (t.weekday() + 1) % 7, t.hour, t.minute, t.second, epoch)
+
+
+def valid_date(y, mo, d, h, mi, s):
+    try:
+        t = datetime.datetime(2000 + y, mo, d, h, mi, s)
+    except ValueError:
+        return None
+    return int((t - BASE).total_seconds())
+
+
+def build_queries(args):
+    rnd = random.Random(args.seed)
+    queries, expects = [], []
+
+    # 每一天的首末秒和一个变化的时刻
+    days = (datetime.datetime(2100, 1, 1) - BASE).days
+    for day in range(days):
+        for sod in (0, 86399, (day * args.step) % 86400):
+            e = day * 86400 + sod
+            queries.append('F %d' % e)
+            expects.append(('F', e, expect_from(e)))
+
+    # 第一天每一秒, 覆盖时分秒换算
+    for e in range(86400):
+        queries.append('F %d' % e)
+        expects.append(('F', e, expect_from(e)))
+
+    # 超出范围按最大值
+    for e in (EPOCH_MAX + 1, 0xFFFFFFFF):
+        queries.append('F %d' % e)
+        expects.append(('F', e, expect_from(EPOCH_MAX)))
+
+    for b in range(256):
+        hi, lo = b >> 4, b & 0xF
+        queries.append('B %d' % b)
+        expects.append(('B', b, (hi * 10 + lo if hi < 10 and lo < 10 else 0xFF,)))
+
+    # 正向: 随机合法值和各类越界值, 十进制和 BCD 各一遍
+    cases = []
+    for _ in range(20000):
+        cases.append((rnd.randrange(100), rnd.randrange(1, 13), rnd.randrange(1, 32),
+                      rnd.randrange(24), rnd.randrange(60), rnd.randrange(60)))
+    for y in range(100):
+        cases += [(y, 2, 28, 0, 0, 0), (y, 2, 29, 0, 0, 0), (y, 2, 30, 0, 0, 0),
+                  (y, 4, 31, 0, 0, 0), (y, 12, 31, 23, 59, 59)]
+    cases += [(0, 0, 1, 0, 0, 0), (0, 13, 1, 0, 0, 0), (0, 1, 0, 0, 0, 0), (0, 1, 32, 0, 0, 0),
+              (0, 1, 1, 24, 0, 0), (0, 1, 1, 0, 60, 0), (0, 1, 1, 0, 0, 60), (100, 1, 1, 0, 0, 0)]
+    for c in cases:
+        e = valid_date(*c)
+        exp = EPOCH_INVD if (e is None or c[0] > 99) else e
+        queries.append('T %d %d %d %d %d %d %d' % ((FMT_DEC,) + c))
+        expects.append(('T', c, (exp,)))
+        if max(c) < 100:
+            queries.append('T %d %d %d %d %d %d %d' % ((FMT_BCD,) + tuple(to_bcd(v) for v in c)))
+            expects.append(('T', c, (exp,)))
+
+    # 非法 BCD 码
+    for bad in (0x0A, 0x1F, 0xA0, 0xFF):
+        queries.append('T %d %d 1 1 0 0 0' % (FMT_BCD, bad))
+        expects.append(('T', ('bcd year', hex(bad)), (EPOCH_INVD,)))
+        queries.append('T %d 0 1 1 0 0 %d' % (FMT_BCD, bad))
+        expects.append(('T', ('bcd second', hex(bad)), (EPOCH_INVD,)))
+
+    return queries, expects
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--step', type=int, default=7919, help='每天额外检查的时刻步进, 秒')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+
+    with open(SOURCE, encoding='utf-8') as f:
+        errors = check_magic(f.read())
+    for e in errors:
+        print(e)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'calendar_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-Werror',
+               '-I', os.path.dirname(SOURCE), SOURCE, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        queries, expects = build_queries(args)
+        r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                           universal_newlines=True)
+        lines = r.stdout.splitlines()
+        if r.returncode != 0 or len(lines) != len(expects):
+            print('驱动异常退出: 返回 %d, 输出 %d 行, 应为 %d 行' % (r.returncode, len(lines), len(expects)))
+            return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    bad = 0
+    for line, (op, arg, exp) in zip(lines, expects):
+        got = tuple(int(v) for v in line.split())
+        if got != exp:
+            if bad < MAX_REPORT:
+                print('%s %s: 得到 %s, 应为 %s' % (op, arg, got, exp))
+            bad += 1
+
+    print('%d 项, 差异 %d 项, 常数错误 %d 项' % (len(expects), bad, len(errors)))
+    return 1 if (bad or errors) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,421 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/can_filter.c 的主机测试: 用主机编译器编译 can_filter.c 和一个读标准输入的驱动,
+把编译出的过滤器组交给 Python 写的过滤器硬件模型, 逐帧检查接收结果.
+
+    can_filter_test.py [--cc gcc] [--cases 300] [--seed 1]
+        1. 随机生成规则表(标准帧单 ID/区间、扩展帧单 ID/区间、整段大区间、不同类别重叠),
+           标准帧 2048 个 ID 全部检查, 扩展帧检查规则所在的 8192 个 ID 窗口、每条规则
+           的边界和对齐块边界, 以及随机 ID; 数据帧和远程帧各一遍;
+        2. 硬件模型按 bxCAN 过滤器组格式(STM32/GD32/AT32 相同)实现 16/32 位列表和掩码,
+           FMI 在每个 FIFO 内按组顺序编号, 多个过滤器同时命中时按 32 位优先、列表优先、
+           组号小优先选一个;
+        3. 数据帧被接收当且仅当某条规则包含它, 查 FMIClass 得到的类别必须是包含它的
+           规则之一, FIFO 必须与类别对应(类别 0 为 FIFO0); 远程帧一律不接收;
+        4. NumFMI 与各组占用的编号数一致; MaxBanks 取编译结果组数时结果不变,
+           少一组时返回 CANFILTER_ERR_BANKS;
+        5. 非法规则返回 CANFILTER_ERR_RULE, 区间展开超过 CANFILTER_MAX_ENTRIES 时返回
+           CANFILTER_ERR_ENTRIES, 先出错的规则决定返回值;
+        6. CANFilter_AcceptAll 接收全部数据帧到 FIFO0 类别 0.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 can_filter.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'can_filter.c')
+STD_FULL = 0x7FF
+EXT_FULL = 0x1FFFFFFF
+MAX_BANKS = 28
+MAX_ENTRIES = 128
+MAX_CLASS = 4
+MODE_MASK, MODE_LIST = 0, 1
+SCALE_16BIT, SCALE_32BIT = 0, 1
+OK, ERR_RULE, ERR_ENTRIES, ERR_BANKS = 0, -1, -2, -3
+EXT_WINDOW = 8192
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include "can_filter.h"
+
+static CANFilter_Rule rules[256];
+static CANFilter_Table table;
+
+static void dump(long ret, const CANFilter_Table *t) {
+    unsigned i, f;
+
+    printf("%ld %u %u %u\n", ret, t->NumBanks, t->NumFMI[0], t->NumFMI[1]);
+    for (i = 0; i < t->NumBanks && i < CANFILTER_MAX_BANKS; i++) {
+        printf("%lu %lu %u %u %u\n", (unsigned long)t->Bank[i].FR1, (unsigned long)t->Bank[i].FR2,
+               t->Bank[i].Mode, t->Bank[i].Scale, t->Bank[i].FIFO);
+    }
+    for (f = 0; f < 2; f++) {
+        printf("-");
+        for (i = 0; i < t->NumFMI[f] && i < CANFILTER_MAX_FMI; i++) printf(" %u", t->FMIClass[f][i]);
+        printf("\n");
+    }
+}
+
+int main(void) {
+    char op;
+    unsigned long maxBanks, n, i, a[4];
+
+    while (scanf(" %c", &op) == 1) {
+        if (op == 'C') {
+            if (scanf("%lu %lu", &maxBanks, &n) != 2 || n > 256) return 2;
+            for (i = 0; i < n; i++) {
+                if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 2;
+                rules[i].IdLow = (uint32_t)a[0];
+                rules[i].IdHigh = (uint32_t)a[1];
+                rules[i].Ext = (uint8_t)a[2];
+                rules[i].Class = (uint8_t)a[3];
+            }
+            dump((long)CANFilter_Compile(rules, (uint32_t)n, (uint8_t)maxBanks, &table), &table);
+        } else if (op == 'A') {
+            dump(0, &CANFilter_AcceptAll);
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def blocks(low, high, full):
+    """与 CANFilter_AddRange 相同的对齐 2^k 拆分, 只数条目数"""
+    n = 0
+    while True:
+        size = (low & -low) if low else full + 1
+        while low + size - 1 > high:
+            size >>= 1
+        n += 1
+        if low + size - 1 == high:
+            return n
+        low += size
+
+
+def expect_ret(rules):
+    count = 0
+    for low, high, ext, cls in rules:
+        full = EXT_FULL if ext else STD_FULL
+        if low > high or high > full or cls >= MAX_CLASS:
+            return ERR_RULE
+        count += blocks(low, high, full)
+        if count > MAX_ENTRIES:
+            return ERR_ENTRIES
+    return OK
+
+
+class Hardware:
+    """过滤器组硬件模型, 输入 (NumBanks, Bank[]) , 输出每帧命中的 (FIFO, FMI)"""
+
+    def __init__(self, banks):
+        self.exact16 = {}
+        self.exact32 = {}
+        self.mask16 = []
+        self.mask32 = []
+        self.slots = [0, 0]
+        for no, (fr1, fr2, mode, scale, fifo) in enumerate(banks):
+            if scale == SCALE_32BIT and mode == MODE_LIST:
+                for k, w in enumerate((fr1, fr2)):
+                    self.exact32.setdefault(w, (no, k, fifo, self.slots[fifo] + k))
+                n = 2
+            elif scale == SCALE_32BIT:
+                self.mask32.append((fr1 & fr2, fr2, fifo, self.slots[fifo]))
+                n = 1
+            elif mode == MODE_LIST:
+                for k, w in enumerate((fr1 & 0xFFFF, fr1 >> 16, fr2 & 0xFFFF, fr2 >> 16)):
+                    self.exact16.setdefault(w, (no, k, fifo, self.slots[fifo] + k))
+                n = 4
+            else:
+                for k, w in enumerate((fr1, fr2)):
+                    m = w >> 16
+                    self.mask16.append((w & m & 0xFFFF, m, fifo, self.slots[fifo] + k))
+                n = 2
+            self.slots[fifo] += n
+
+    def match(self, ident, ext, rtr):
+        if ext:
+            w32 = (ident << 3) | 0x4 | (rtr << 1)
+            w16 = ((ident >> 18) << 5) | (rtr << 4) | 0x8 | ((ident >> 15) & 0x7)
+        else:
+            w32 = (ident << 21) | (rtr << 1)
+            w16 = (ident << 5) | (rtr << 4)
+        # 优先级: 32 位 > 16 位, 列表 > 掩码, 组号小的优先
+        if w32 in self.exact32:
+            return self.exact32[w32][2:]
+        for value, mask, fifo, fmi in self.mask32:
+            if w32 & mask == value:
+                return fifo, fmi
+        if w16 in self.exact16:
+            return self.exact16[w16][2:]
+        for value, mask, fifo, fmi in self.mask16:
+            if w16 & mask == value:
+                return fifo, fmi
+        return None
+
+
+def gen_rules(rnd):
+    rules = []
+    base = rnd.randrange(EXT_FULL + 1 - EXT_WINDOW)
+    for _ in range(rnd.randrange(1, 10)):
+        kind = rnd.randrange(8)
+        cls = rnd.randrange(MAX_CLASS)
+        if kind == 0:
+            a = rnd.randrange(STD_FULL + 1)
+            rules.append((a, a, 0, cls))
+        elif kind == 1:
+            a = rnd.randrange(STD_FULL + 1)
+            rules.append((a, min(STD_FULL, a + rnd.randrange(1, 300)), 0, cls))
+        elif kind == 2:
+            a = rnd.randrange(STD_FULL + 1)
+            b = rnd.randrange(STD_FULL + 1)
+            rules.append((min(a, b), max(a, b), 0, cls))
+        elif kind == 3:
+            a = base + rnd.randrange(EXT_WINDOW)
+            rules.append((a, a, 1, cls))
+        elif kind == 4:
+            a = base + rnd.randrange(EXT_WINDOW)
+            rules.append((a, min(base + EXT_WINDOW - 1, a + rnd.randrange(1, 600)), 1, cls))
+        elif kind == 5:
+            # 对齐块和跨块的整段
+            k = rnd.randrange(4, 12)
+            a = base + (rnd.randrange(EXT_WINDOW >> k) << k)
+            rules.append((a, a + (1 << k) - 1 + rnd.choice((0, 0, 1, -1)), 1, cls))
+        elif kind == 6:
+            # 大的对齐块, 偶尔到末尾的整段
+            k = rnd.randrange(14, 29)
+            a = rnd.randrange((EXT_FULL + 1) >> k) << k
+            rules.append((a, EXT_FULL if rnd.random() < 0.2 else a + (1 << k) - 1, 1, cls))
+        else:
+            # 与已有规则重叠, 类别可能不同
+            if rules:
+                low, high, ext, _ = rnd.choice(rules)
+                rules.append((low, rnd.randrange(low, high + 1), ext, cls))
+    return rules, base
+
+
+def ext_probes(rnd, rules, base):
+    ids = set(range(max(0, base - 16), min(EXT_FULL, base + EXT_WINDOW + 16) + 1))
+    for low, high, ext, _ in rules:
+        if not ext:
+            continue
+        for v in (low - 1, low, low + 1, high - 1, high, high + 1):
+            if 0 <= v <= EXT_FULL:
+                ids.add(v)
+        # 区间内每个对齐块的首尾
+        a = low
+        while a <= high:
+            size = (a & -a) if a else EXT_FULL + 1
+            while a + size - 1 > high:
+                size >>= 1
+            ids.update((a, a + size - 1))
+            a += size
+    for _ in range(2000):
+        ids.add(rnd.randrange(EXT_FULL + 1))
+    # 与标准帧同值的扩展 ID, 检查 IDE 区分
+    ids.update(range(STD_FULL + 1))
+    return sorted(ids)
+
+
+def classes_of(rules, ident, ext):
+    return {cls for low, high, e, cls in rules if e == ext and low <= ident <= high}
+
+
+def check_table(tag, rules, table, ext_ids, accept_all, report):
+    ret, banks, nfmi, fmiclass = table
+    bad = 0
+
+    def fail(msg):
+        nonlocal bad
+        if report[0] < MAX_REPORT:
+            print('%s: %s' % (tag, msg))
+        report[0] += 1
+        bad += 1
+
+    hw = Hardware(banks)
+    if hw.slots != nfmi:
+        fail('NumFMI %s, 各组实际占用 %s' % (nfmi, hw.slots))
+        return bad
+    for f in (0, 1):
+        if len(fmiclass[f]) != nfmi[f] or any(c >= MAX_CLASS for c in fmiclass[f]):
+            fail('FIFO%d 的 FMIClass 非法: %s' % (f, fmiclass[f]))
+            return bad
+
+    frames = [(i, 0) for i in range(STD_FULL + 1)] + [(i, 1) for i in ext_ids]
+    for ident, ext in frames:
+        want = {0} if accept_all else classes_of(rules, ident, ext)
+        got = hw.match(ident, ext, 0)
+        if got is None:
+            if want:
+                fail('%s ID 0x%X 应接收(类别 %s), 未命中' % ('扩展' if ext else '标准', ident, sorted(want)))
+            continue
+        fifo, fmi = got
+        cls = fmiclass[fifo][fmi]
+        if not want:
+            fail('%s ID 0x%X 不在规则内, 却命中 FIFO%d FMI %d' % ('扩展' if ext else '标准', ident, fifo, fmi))
+        elif cls not in want or fifo != (1 if cls else 0):
+            fail('%s ID 0x%X 得到 FIFO%d 类别 %d, 应为类别 %s' %
+                 ('扩展' if ext else '标准', ident, fifo, cls, sorted(want)))
+        if bad > MAX_REPORT:
+            break
+        if not accept_all and hw.match(ident, ext, 1) is not None:
+            fail('%s ID 0x%X 的远程帧被接收' % ('扩展' if ext else '标准', ident))
+    return bad
+
+
+def read_tables(lines):
+    tables = []
+    pos = 0
+    while pos < len(lines):
+        ret, n, f0, f1 = (int(v) for v in lines[pos].split())
+        # NumBanks 超过 28 时驱动只打印 28 组, 由调用者按组数越界报错
+        n = min(n, MAX_BANKS + 1)
+        banks = [tuple(int(v) for v in lines[pos + 1 + i].split()) for i in range(min(n, MAX_BANKS))]
+        pos += 1 + len(banks)
+        fmiclass = [[int(v) for v in lines[pos + f].split()[1:]] for f in (0, 1)]
+        tables.append((ret, banks if n <= MAX_BANKS else banks + [None], [f0, f1], fmiclass))
+        pos += 2
+    return tables
+
+
+def compile_query(rules, max_banks):
+    return ['C %d %d' % (max_banks, len(rules))] + ['%d %d %d %d' % r for r in rules]
+
+
+def run(exe, queries):
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d' % r.returncode)
+    return read_tables(r.stdout.splitlines())
+
+
+def error_cases():
+    cases = [
+        ([(5, 4, 0, 0)], ERR_RULE),
+        ([(0, STD_FULL + 1, 0, 0)], ERR_RULE),
+        ([(0, EXT_FULL + 1, 1, 0)], ERR_RULE),
+        ([(1, 1, 0, MAX_CLASS)], ERR_RULE),
+        # 每条展开 20 个条目, 第 7 条超出 128
+        ([(1, STD_FULL - 1, 0, 0)] * 7, ERR_ENTRIES),
+        ([(1, STD_FULL - 1, 0, 0)] * 6 + [(1, 0, 0, 0)], ERR_RULE),
+        ([(1, EXT_FULL - 1, 1, 1)] * 2 + [(1, STD_FULL - 1, 0, 0)] * 4, ERR_ENTRIES),
+        ([], OK),
+    ]
+    # 恰好 128 个条目可以编译, 129 个返回 CANFILTER_ERR_ENTRIES
+    used = 6 * blocks(1, STD_FULL - 1, STD_FULL)
+    for extra, ret in ((MAX_ENTRIES - used, OK), (MAX_ENTRIES + 1 - used, ERR_ENTRIES)):
+        high = next(h for h in range(1, STD_FULL + 1) if blocks(1, h, STD_FULL) == extra)
+        cases.append(([(1, STD_FULL - 1, 0, 0)] * 6 + [(1, high, 0, 1)], ret))
+    for rules, ret in cases:
+        assert expect_ret(rules) == ret, (rules, ret)
+    return cases
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=300, help='随机规则表个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'can_filter_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-Werror',
+               '-I', ROOT, SOURCE, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        report = [0]
+        bad = 0
+        frames = 0
+        full = 0
+
+        # 随机规则表, 先用 28 组编译
+        cases = [gen_rules(rnd) for _ in range(args.cases)]
+        queries = []
+        for rules, _ in cases:
+            queries += compile_query(rules, MAX_BANKS)
+        first = run(exe, queries)
+
+        # 再用恰好够用和少一组各编译一次
+        queries = []
+        for (rules, _), t in zip(cases, first):
+            if t[0] == OK:
+                queries += compile_query(rules, len(t[1]))
+                queries += compile_query(rules, len(t[1]) - 1)
+        second = iter(run(exe, queries))
+
+        for no, ((rules, base), t) in enumerate(zip(cases, first)):
+            tag = '用例 %d' % no
+            exp = expect_ret(rules)
+            if t[0] == OK:
+                same, less = next(second), next(second)
+            if t[0] == ERR_BANKS and exp == OK:
+                full += 1
+                continue
+            if t[0] != exp:
+                print('%s: 返回 %d, 应为 %d, 规则 %s' % (tag, t[0], exp, rules))
+                bad += 1
+                continue
+            if exp != OK:
+                continue
+            if len(t[1]) > MAX_BANKS:
+                print('%s: NumBanks 超过 %d' % (tag, MAX_BANKS))
+                bad += 1
+                continue
+            ext_ids = ext_probes(rnd, rules, base)
+            frames += 2 * (STD_FULL + 1 + len(ext_ids))
+            bad += check_table(tag, rules, t, ext_ids, False, report)
+            if same != t:
+                print('%s: MaxBanks=%d 时结果不同' % (tag, len(t[1])))
+                bad += 1
+            if len(t[1]) and less[0] != ERR_BANKS:
+                print('%s: MaxBanks=%d 时返回 %d, 应为 %d' % (tag, len(t[1]) - 1, less[0], ERR_BANKS))
+                bad += 1
+
+        # 错误码
+        errs = error_cases()
+        queries = []
+        for rules, _ in errs:
+            queries += compile_query(rules, MAX_BANKS)
+        for (rules, exp), t in zip(errs, run(exe, queries)):
+            if t[0] != exp:
+                print('错误码: 规则 %s 返回 %d, 应为 %d' % (rules[:2], t[0], exp))
+                bad += 1
+
+        # 接收全部
+        t = run(exe, ['A'])[0]
+        bad += check_table('CANFilter_AcceptAll', [], t, ext_probes(rnd, [], 0), True, report)
+    except RuntimeError as e:
+        print(e)
+        return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    print('%d 个规则表(%d 个超出 28 组), %d 帧, %d 个错误码用例, 差异 %d 项' %
+          (len(cases), full, frames, len(errs), bad))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,449 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/can_queue.c 的主机测试: 用主机编译器(开 AddressSanitizer)编译 can_queue.c 和一个读标准输入的
+驱动, 驱动代替各模板的 can_bus.c 提供 CANQueue_Port(记录写邮箱和中止请求), 发送完成和接收的帧由
+测试给出, 结果与 Python 写的参考模型逐项比较.
+
+    can_queue_test.py [--cc gcc] [--cases 300] [--seed 1]
+        1. 发送顺序: 按线上仲裁字段(基本 ID, RTR/SRR, IDE, 扩展 ID, RTR)排序, 同键按入队顺序;
+           有空邮箱时装入编号最小的空邮箱, 同一键同时只占一个邮箱;
+        2. 抢占: 3 个邮箱都忙且队首优先于最差的邮箱时只中止这一个, 已在中止中的不重复请求;
+        3. 发送完成: 只处理软件记录为忙的邮箱, 成功计 TxFrames, 中止的帧先装入队首再重新入队
+           (计 TxRequeued, 队列满计 TxDropped), 其余计 TxErrors; 队列满时 CANQueue_Send 返回 0
+           并计 TxDropped, TxQueueMax 记录最大深度;
+        4. 接收: FMI 减去偏移后查类别(FMIOffset 为 NULL 时按 0), 不在表中的按 FIFO 号归类,
+           Class 由 CANQueue_RxSlot 填好; 环形缓冲区满时返回 NULL 并计 RxOverflow;
+           CANQueue_Receive 类别 0 优先, 同类别先进先出, 计数器可回绕;
+        5. 回调的 Q 就是初始化的队列.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 can_queue.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+RX_DEPTH = 32
+TX_DEPTH = 32
+MAILBOXES = 3
+MAX_CLASS = 4
+MAX_FMI = 28 * 4
+MASK32 = 0xFFFFFFFF
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include <string.h>
+#include "can_queue.c"
+
+static CANQueue queue;
+static CANFilter_Table table;
+static char events[256];
+static int bad_q;
+
+static void host_write(CANQueue *Q, uint8_t Mailbox, const CANBus_Frame *Frame) {
+    size_t n = strlen(events);
+    unsigned i;
+
+    if(Q != &queue || Mailbox >= CANQUEUE_MAILBOXES) bad_q++;
+    n += (size_t)snprintf(events + n, sizeof(events) - n, " W%u:%lx:%u%u:%u:", (unsigned)Mailbox,
+                          (unsigned long)Frame->Id, (unsigned)Frame->Ext, (unsigned)Frame->Rtr,
+                          (unsigned)Frame->Dlc);
+    for(i = 0; i < 8 && n < sizeof(events); i++) {
+        n += (size_t)snprintf(events + n, sizeof(events) - n, "%02x", (unsigned)Frame->Data[i]);
+    }
+}
+
+static void host_abort(CANQueue *Q, uint8_t Mailbox) {
+    size_t n = strlen(events);
+
+    if(Q != &queue || Mailbox >= CANQUEUE_MAILBOXES) bad_q++;
+    snprintf(events + n, sizeof(events) - n, " A%u", (unsigned)Mailbox);
+}
+
+static const CANQueue_Port port = {host_write, host_abort};
+
+static int read_frame(CANBus_Frame *f) {
+    unsigned id, ext, rtr, dlc, i, b;
+
+    if(scanf("%x %u %u %u", &id, &ext, &rtr, &dlc) != 4) return 0;
+    memset(f, 0xA5, sizeof(*f));
+    f->Id = id;
+    f->Ext = (uint8_t)ext;
+    f->Rtr = (uint8_t)rtr;
+    f->Dlc = (uint8_t)dlc;
+    for(i = 0; i < 8; i++) {
+        if(scanf("%x", &b) != 1) return 0;
+        f->Data[i] = (uint8_t)b;
+    }
+    return 1;
+}
+
+int main(void) {
+    char cmd;
+    unsigned a, b, c, i, j;
+    uint8_t offset[2];
+    CANBus_Frame fr, *slot;
+    CANBus_Stats st;
+
+    while(scanf(" %c", &cmd) == 1) {
+        events[0] = 0;
+        if(cmd == 'I') {
+            /* I 偏移有效 偏移0 偏移1 编号数0 编号数1 类别... */
+            if(scanf("%u %u %u", &a, &b, &c) != 3) return 2;
+            offset[0] = (uint8_t)b;
+            offset[1] = (uint8_t)c;
+            memset(&table, 0x5A, sizeof(table));
+            for(i = 0; i < 2; i++) {
+                if(scanf("%u", &b) != 1) return 2;
+                table.NumFMI[i] = (uint8_t)b;
+            }
+            for(i = 0; i < 2; i++) {
+                for(j = 0; j < table.NumFMI[i]; j++) {
+                    if(scanf("%u", &b) != 1) return 2;
+                    table.FMIClass[i][j] = (uint8_t)b;
+                }
+            }
+            memset(&queue, 0xA5, sizeof(queue));
+            CANQueue_Init(&queue, &port, &table, a ? offset : NULL);
+            printf("ok\n");
+        } else if(cmd == 'S') {
+            if(!read_frame(&fr)) return 2;
+            a = CANQueue_Send(&queue, &fr);
+            printf("%u%s\n", a, events);
+        } else if(cmd == 'T') {
+            if(scanf("%u %u", &a, &b) != 2) return 2;
+            CANQueue_TxDone(&queue, (uint8_t)a, (uint8_t)b);
+            printf("-%s\n", events);
+        } else if(cmd == 'R') {
+            /* R FIFO FMI 时间戳 帧 */
+            if(scanf("%u %u %u", &a, &b, &c) != 3 || !read_frame(&fr)) return 2;
+            slot = CANQueue_RxSlot(&queue, (uint8_t)a, (uint8_t)b);
+            if(slot == NULL) {
+                printf("-\n");
+                continue;
+            }
+            j = slot->Class;
+            fr.Class = slot->Class;
+            fr.Time = (uint16_t)c;
+            *slot = fr;
+            CANQueue_RxCommit(&queue, slot);
+            printf("%u\n", j);
+        } else if(cmd == 'O') {
+            if(scanf("%u", &a) != 1) return 2;
+            CANQueue_FifoOverrun(&queue, (uint8_t)a);
+            printf("ok\n");
+        } else if(cmd == 'G') {
+            memset(&fr, 0, sizeof(fr));
+            a = CANQueue_Receive(&queue, &fr);
+            printf("%u", a);
+            if(a) {
+                printf(" %u %lx %u%u %u %u ", (unsigned)fr.Class, (unsigned long)fr.Id, (unsigned)fr.Ext,
+                       (unsigned)fr.Rtr, (unsigned)fr.Dlc, (unsigned)fr.Time);
+                for(i = 0; i < 8; i++) printf("%02x", (unsigned)fr.Data[i]);
+            }
+            printf("\n");
+        } else if(cmd == 'H') {
+            /* 把接收计数器移到回绕附近, 只在接收缓冲区为空时使用 */
+            if(scanf("%x", &a) != 1) return 2;
+            for(i = 0; i < CANFILTER_MAX_CLASS; i++) queue.Rx[i].Head = queue.Rx[i].Tail = a;
+            printf("ok\n");
+        } else if(cmd == 'X') {
+            st = queue.Stats;
+            printf("%u", (unsigned)st.RxFrames);
+            for(i = 0; i < CANFILTER_MAX_CLASS; i++) printf(" %u", (unsigned)st.RxOverflow[i]);
+            printf(" %u %u %u %u %u %u %u %u %d\n", (unsigned)st.FifoOverrun[0], (unsigned)st.FifoOverrun[1],
+                   (unsigned)st.TxFrames, (unsigned)st.TxRequeued, (unsigned)st.TxErrors,
+                   (unsigned)st.TxDropped, (unsigned)st.TxQueueMax, (unsigned)queue.HeapSize, bad_q);
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def key(f):
+    ident, ext, rtr = f[0], f[1], f[2]
+    if ext:
+        return (((ident >> 18) << 21) | (3 << 19) | ((ident & 0x3FFFF) << 1) | rtr) & MASK32
+    return ((ident << 21) | (rtr << 20)) & MASK32
+
+
+def frame_text(f):
+    return '%x:%d%d:%d:%s' % (f[0], f[1], f[2], f[3], ''.join('%02x' % b for b in f[4]))
+
+
+class Model:
+    """can_queue.c 的参考模型, 发送队列用 (键, 序号) 排序的列表代替二叉堆"""
+
+    def __init__(self):
+        self.init(None, [0, 0], [[], []])
+
+    def init(self, offset, num, cls):
+        self.offset = offset or [0, 0]
+        self.cls = cls
+        self.num = num
+        self.rx = [[] for _ in range(MAX_CLASS)]
+        self.heap = []
+        self.seq = 0
+        self.mb = [None] * MAILBOXES
+        self.abort = [False] * MAILBOXES
+        self.rx_frames = 0
+        self.overflow = [0] * MAX_CLASS
+        self.overrun = [0, 0]
+        self.tx_frames = self.requeued = self.errors = self.dropped = self.qmax = 0
+        return 'ok'
+
+    def push(self, item):
+        if len(self.heap) >= TX_DEPTH:
+            return False
+        self.heap.append(item)
+        self.heap.sort(key=lambda it: (it[0], it[1]))
+        self.qmax = max(self.qmax, len(self.heap))
+        return True
+
+    def load(self, ev):
+        while self.heap:
+            head = self.heap[0]
+            if any(m is not None and m[0] == head[0] for m in self.mb):
+                return
+            free = [i for i in range(MAILBOXES) if self.mb[i] is None]
+            if not free:
+                worst = max(range(MAILBOXES), key=lambda i: (self.mb[i][0], self.mb[i][1]))
+                if not self.abort[worst] and (head[0], head[1]) < (self.mb[worst][0], self.mb[worst][1]):
+                    self.abort[worst] = True
+                    ev.append('A%d' % worst)
+                return
+            self.mb[free[0]] = self.heap.pop(0)
+            ev.append('W%d:%s' % (free[0], frame_text(head[2])))
+
+    def send(self, f):
+        item = (key(f), self.seq, f)
+        self.seq += 1
+        ev = []
+        if not self.push(item):
+            self.dropped += 1
+            return '0'
+        self.load(ev)
+        return ' '.join(['1'] + ev)
+
+    def tx_done(self, done, ok):
+        ev, requeue = [], []
+        for i in range(MAILBOXES):
+            if not (done >> i) & 1 or self.mb[i] is None:
+                continue
+            if (ok >> i) & 1:
+                self.tx_frames += 1
+            elif self.abort[i]:
+                requeue.append(self.mb[i])
+            else:
+                self.errors += 1
+            self.mb[i] = None
+            self.abort[i] = False
+        self.load(ev)
+        for it in requeue:
+            if self.push(it):
+                self.requeued += 1
+            else:
+                self.dropped += 1
+        if requeue:
+            self.load(ev)
+        return ' '.join(['-'] + ev)
+
+    def rx_slot(self, fifo, fmi, time, f):
+        k = (fmi - self.offset[fifo]) & 0xFF
+        c = self.cls[fifo][k] if k < self.num[fifo] else fifo
+        if len(self.rx[c]) >= RX_DEPTH:
+            self.overflow[c] += 1
+            return '-'
+        self.rx[c].append((c, f, time))
+        self.rx_frames += 1
+        return str(c)
+
+    def receive(self):
+        for c in range(MAX_CLASS):
+            if self.rx[c]:
+                c, f, time = self.rx[c].pop(0)
+                return '1 %d %x %d%d %d %d %s' % (c, f[0], f[1], f[2], f[3], time,
+                                                  ''.join('%02x' % b for b in f[4]))
+        return '0'
+
+    def stat_line(self):
+        return ' '.join(str(v) for v in [self.rx_frames] + self.overflow + self.overrun +
+                        [self.tx_frames, self.requeued, self.errors, self.dropped, self.qmax,
+                         len(self.heap), 0])
+
+
+def gen_frame(rnd, pool, size):
+    if pool and (len(pool) >= size or rnd.random() < 0.6):
+        ident, ext = rnd.choice(pool)
+    else:
+        ext = int(rnd.random() < 0.4)
+        if ext:
+            # 基本 ID 部分取小范围, 让标准帧和扩展帧的基本 ID 相同
+            ident = (rnd.randint(0, 15) << 18) | rnd.choice((0, rnd.randint(0, 0x3FFFF)))
+        else:
+            ident = rnd.choice((rnd.randint(0, 15), rnd.randint(0, 0x7FF)))
+        pool.append((ident, ext))
+    data = [rnd.randint(0, 255) for _ in range(8)]
+    return (ident, ext, int(rnd.random() < 0.2), rnd.randint(0, 8), data)
+
+
+def frame_args(f):
+    return '%x %d %d %d %s' % (f[0], f[1], f[2], f[3], ' '.join('%x' % b for b in f[4]))
+
+
+def scenario(rnd, ops):
+    """一个场景的命令和期望输出"""
+    m = Model()
+    cmds, exp = [], []
+    pool = []
+    # 部分场景只用几个 ID, 队首常与邮箱中的帧同键
+    size = rnd.choice((4, 1000))
+
+    def init():
+        use = int(rnd.random() < 0.7)
+        off = [rnd.randint(0, 60), rnd.randint(0, 60)]
+        num = [rnd.randint(0, 12), rnd.randint(0, 12)]
+        if rnd.random() < 0.05:
+            num[rnd.randint(0, 1)] = MAX_FMI
+        cls = [[rnd.randint(0, MAX_CLASS - 1) for _ in range(num[k])] for k in range(2)]
+        cmds.append('I %d %d %d %d %d %s' % (use, off[0], off[1], num[0], num[1],
+                                             ' '.join(str(c) for c in cls[0] + cls[1])))
+        exp.append(m.init(off if use else None, num, cls))
+
+    # 每个场景的操作比例不同, 部分场景少取少完成, 让发送队列和接收环形缓冲区填满
+    w_send, w_done, w_rx, w_get = (rnd.choice((1, 3, 6)), rnd.choice((0.3, 1, 3)), rnd.choice((2, 8)),
+                                   rnd.choice((0.05, 0.5, 3)))
+    total = w_send + w_done + w_rx + w_get + 1
+    init()
+    for _ in range(ops):
+        r = rnd.random() * total
+        busy = [i for i in range(MAILBOXES) if m.mb[i] is not None]
+        if r < w_send:
+            # 偶尔连发一串, 把发送队列填满
+            for _ in range(rnd.randint(10, 40) if rnd.random() < 0.1 else 1):
+                f = gen_frame(rnd, pool, size)
+                cmds.append('S ' + frame_args(f))
+                exp.append(m.send(f))
+        elif r < w_send + w_done:
+            aborting = sum(1 << i for i in range(MAILBOXES) if m.abort[i])
+            if aborting and rnd.random() < 0.5:
+                # 只完成被中止的邮箱, 队列满且队首与邮箱同键时重新入队会失败
+                done, ok = aborting, 0
+            else:
+                done = sum(1 << i for i in busy if rnd.random() < 0.6)
+                if rnd.random() < 0.1:
+                    done |= rnd.randint(0, 7)
+                ok = done & rnd.randint(0, 7)
+            cmds.append('T %d %d' % (done, ok))
+            exp.append(m.tx_done(done, ok))
+        elif r < w_send + w_done + w_rx:
+            fifo = rnd.randint(0, 1)
+            off = m.offset[fifo]
+            fmi = rnd.choice((off + rnd.randint(0, m.num[fifo] + 2), rnd.randint(0, 255)))
+            fmi &= 0xFF
+            time = rnd.randint(0, 0xFFFF)
+            f = gen_frame(rnd, pool, size)
+            cmds.append('R %d %d %d %s' % (fifo, fmi, time, frame_args(f)))
+            exp.append(m.rx_slot(fifo, fmi, time, f))
+        elif r < w_send + w_done + w_rx + w_get:
+            cmds.append('G')
+            exp.append(m.receive())
+        else:
+            r = rnd.random()
+            if r < 0.3:
+                fifo = rnd.randint(0, 1)
+                cmds.append('O %d' % fifo)
+                exp.append('ok')
+                m.overrun[fifo] += 1
+            elif r < 0.5 and not any(m.rx):
+                cmds.append('H %x' % rnd.choice((0xFFFFFFF0, 0x7FFFFFF8, 0)))
+                exp.append('ok')
+            elif r < 0.6:
+                init()
+            else:
+                cmds.append('X')
+                exp.append(m.stat_line())
+    cmds.append('X')
+    exp.append(m.stat_line())
+    return cmds, exp, m
+
+
+def run(exe, queries):
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d\n%s' % (r.returncode, r.stdout[-2000:]))
+    return r.stdout.splitlines()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=300, help='随机场景个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'can_queue_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O1', '-g', '-Wall', '-Wextra', '-Werror', '-fsanitize=address',
+               '-fno-omit-frame-pointer', '-no-pie', '-fno-pie', '-I', ROOT, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        bad = 0
+
+        def fail(msg):
+            nonlocal bad
+            if bad < MAX_REPORT:
+                print(msg)
+            bad += 1
+
+        ops = sent = aborted = dropped = overflow = 0
+        for no in range(args.cases):
+            cmds, exp, m = scenario(rnd, rnd.randint(40, 400))
+            ops += len(cmds)
+            sent += m.tx_frames
+            aborted += m.requeued
+            dropped += m.dropped
+            overflow += sum(m.overflow)
+            got = run(exe, cmds)
+            if len(got) != len(exp):
+                fail('场景 %d: 输出 %d 行, 应为 %d 行' % (no, len(got), len(exp)))
+                continue
+            for c, g, e in zip(cmds, got, exp):
+                if g != e:
+                    fail('场景 %d: %s 得到 %s, 应为 %s' % (no, c[:60], g, e))
+                    break
+            if got[-1].split()[-1] != '0':
+                fail('场景 %d: 回调收到错误的队列或邮箱 %s 次' % (no, got[-1].split()[-1]))
+    except RuntimeError as e:
+        print(e)
+        return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    print('%d 个场景, %d 次操作, 发送 %d 帧, 抢占重排 %d 次, 发送队列满 %d 帧, 接收溢出 %d 帧, 差异 %d 项' %
+          (args.cases, ops, sent, aborted, dropped, overflow, bad))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
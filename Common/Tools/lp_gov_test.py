@@ -0,0 +1,546 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/lp_gov.c 的主机测试: 用主机编译器(开 AddressSanitizer)编译 lp_gov.c 和一个读标准输入的
+驱动, 驱动代替各模板的 lp_gov_hw.c 提供 Lp_Port: 周期计数、唤醒定时器和 Enter 都是模拟的,
+每次 Lp_Idle 的唤醒结果(是否定时到、恢复周期、时钟是否失败)由测试给出, 结果与 Python 写的参考模型
+逐项比较.
+
+    lp_gov_test.py [--cc gcc] [--cases 300] [--seed 1]
+        1. 模式选择: 进入 + 唤醒 + 最短驻留 <= 距到期时间的最深模式(和按 64 位计, LP_FOREVER 附近
+           不溢出), 被 Lp_Block(可嵌套)、Lp_SetMaxLatency(等于唤醒时延时仍可用) 或 Port->Deepest
+           禁止时降到更浅的模式, 并记一次降级; 都不满足时返回 LP_MODE_RUN, 不调用 Arm/Enter;
+        2. 时延学习: 进入耗时按 Cycles 差(含 32 位回绕)向上取整到 us, 恢复耗时按 Lp_Wake 的周期数和
+           频率向上取整, 都取最大值替换时延表; Lp_SetLatency 清除该模式的实测值, Lp_ResetStats
+           清除所有实测值和统计; Lp_GetLatency 返回当前使用的值; 最大唤醒时延在 Lp_GovInit 后保留;
+        3. 定时模式: 先 Suspend 再 Arm(到期时间 - 唤醒时延), Enter 时传入 Wake, 唤醒后 Resume 的
+           驻留时间在定时到且 Arm 返回非 0 时取 Arm 的返回值, 否则取 NowUs 差(没有 NowUs 时为 0);
+           提前唤醒记 Early, 时钟失败记 ClockFail; 非定时模式不调用 Suspend/Arm/Resume;
+        4. 参数检查: Lp_GovInit 参数错误返回 LP_ERR_PARAM, 之后(以及初始化之前) Lp_Idle 不休眠、
+           Lp_Block / Lp_SetLatency / Lp_GetLatency 等不起作用; 模式越界被拒绝;
+        5. Lock/Unlock 成对, NextDeadline 和 Enter 在 Lock 内调用.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 lp_gov.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+MODE_RUN = 0
+MODE_MAX = 4
+FOREVER = 0xFFFFFFFF
+OK, ERR_PARAM = 0, -1
+MASK32 = 0xFFFFFFFF
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include <string.h>
+#include "lp_gov.c"
+
+static Lp_Port port;
+static Lp_Config cfg;
+static Lp_Latency defaults[LP_MODE_MAX];
+static int depth, bad_lock, bad_call;
+static uint32_t cyc, cyc_step, now, now_step, mhz, deadline, arm_cap;
+static uint8_t deepest;
+static int arm_mode, arm_us, enter_mode, suspend_mode, wake_mode, resume_mode;
+static uint32_t resume_slept;
+static Lp_Wake wake_info;
+
+static uint32_t host_lock(void) {
+    depth++;
+    return 0x5A000000u | (uint32_t)depth;
+}
+
+static void host_unlock(uint32_t State) {
+    if(State != (0x5A000000u | (uint32_t)depth)) bad_lock++;
+    depth--;
+}
+
+static uint32_t host_cycles(void) {
+    uint32_t c = cyc;
+
+    cyc += cyc_step;
+    return c;
+}
+
+static uint32_t host_mhz(void) {
+    return mhz;
+}
+
+static uint8_t host_deepest(void) {
+    return deepest;
+}
+
+static uint32_t host_arm(uint8_t Mode, uint32_t Us) {
+    if(depth != 1) bad_call++;
+    arm_mode = Mode;
+    arm_us = (int)Us;
+    if(arm_cap == 0) return 0;
+    return Us < arm_cap ? Us : arm_cap;
+}
+
+static void host_enter(uint8_t Mode, void (*Wake)(uint8_t Mode), Lp_Wake *Info) {
+    if(depth != 1 || Wake != cfg.Wake) bad_call++;
+    enter_mode = Mode;
+    if(Mode >= port.TimedMode) {
+        if(Wake) Wake(Mode);
+        *Info = wake_info;
+    }
+}
+
+static uint32_t host_deadline(void) {
+    if(depth != 1) bad_call++;
+    return deadline;
+}
+
+static uint32_t host_now(void) {
+    uint32_t n = now;
+
+    now += now_step;
+    return n;
+}
+
+static void host_suspend(uint8_t Mode) {
+    suspend_mode = Mode;
+}
+
+static void host_wake(uint8_t Mode) {
+    wake_mode = Mode;
+}
+
+static void host_resume(uint8_t Mode, uint32_t SleptUs) {
+    resume_mode = Mode;
+    resume_slept = SleptUs;
+}
+
+int main(void) {
+    char cmd;
+    unsigned a, b, c, d, e, i, flags;
+    int dp;
+    Lp_Latency lat;
+    Lp_Stats st;
+
+    while(scanf(" %c", &cmd) == 1) {
+        if(cmd == 'I') {
+            /* I 模式数 定时模式 Deepest(-1 为 NULL) 标志 时延表... */
+            if(scanf("%u %u %d %u", &a, &b, &dp, &flags) != 4) return 2;
+            memset(defaults, 0, sizeof(defaults));
+            for(i = 0; i < a && i < LP_MODE_MAX; i++) {
+                if(scanf("%u %u %u %u", &defaults[i].EntryUs, &defaults[i].HwWakeUs,
+                         &defaults[i].RestoreUs, &defaults[i].MinUs) != 4) return 2;
+            }
+            port.NumModes = (uint8_t)a;
+            port.TimedMode = (uint8_t)b;
+            port.Defaults = defaults;
+            port.Lock = host_lock;
+            port.Unlock = host_unlock;
+            port.Cycles = host_cycles;
+            port.CpuMhz = host_mhz;
+            port.Deepest = dp < 0 ? NULL : host_deepest;
+            port.Arm = host_arm;
+            port.Enter = host_enter;
+            deepest = dp < 0 ? 0 : (uint8_t)dp;
+            memset(&cfg, 0, sizeof(cfg));
+            cfg.NextDeadline = (flags & 4) ? NULL : host_deadline;
+            if(flags & 1) cfg.NowUs = host_now;
+            if(flags & 2) {
+                cfg.Suspend = host_suspend;
+                cfg.Wake = host_wake;
+                cfg.Resume = host_resume;
+            }
+            printf("%d\n", (int)Lp_GovInit(&port, (flags & 8) ? NULL : &cfg));
+        } else if(cmd == 'D') {
+            /* D 到期 进入周期 MHz NowUs步长 Arm上限 定时到 时钟失败 恢复周期 恢复MHz */
+            unsigned fired, fail, rc, rm;
+            if(scanf("%u %u %u %u %u %u %u %u %u", &deadline, &cyc_step, &mhz, &now_step, &arm_cap,
+                     &fired, &fail, &rc, &rm) != 9) return 2;
+            wake_info.Fired = (uint8_t)fired;
+            wake_info.ClockFail = (uint8_t)fail;
+            wake_info.RestoreCycles = rc;
+            wake_info.RestoreMhz = rm;
+            arm_mode = arm_us = enter_mode = suspend_mode = wake_mode = resume_mode = -1;
+            resume_slept = 0;
+            a = Lp_Idle();
+            printf("%u %d %d %d %d %d %d %u\n", a, arm_mode, arm_us, enter_mode, suspend_mode,
+                   wake_mode, resume_mode, (unsigned)resume_slept);
+        } else if(cmd == 'C') {
+            /* 周期计数和 NowUs 的起点, 用来覆盖 32 位回绕 */
+            if(scanf("%u %u", &cyc, &now) != 2) return 2;
+            printf("ok\n");
+        } else if(cmd == 'P') {
+            if(scanf("%u", &a) != 1) return 2;
+            deepest = (uint8_t)a;
+            printf("ok\n");
+        } else if(cmd == 'B' || cmd == 'U') {
+            if(scanf("%u", &a) != 1) return 2;
+            if(cmd == 'B') Lp_Block((uint8_t)a);
+            else Lp_Unblock((uint8_t)a);
+            printf("ok\n");
+        } else if(cmd == 'M') {
+            if(scanf("%u", &a) != 1) return 2;
+            Lp_SetMaxLatency(a);
+            printf("ok\n");
+        } else if(cmd == 'L') {
+            if(scanf("%u %u %u %u %u", &a, &b, &c, &d, &e) != 5) return 2;
+            lat.EntryUs = b;
+            lat.HwWakeUs = c;
+            lat.RestoreUs = d;
+            lat.MinUs = e;
+            printf("%d\n", (int)Lp_SetLatency((uint8_t)a, &lat));
+        } else if(cmd == 'G') {
+            if(scanf("%u", &a) != 1) return 2;
+            memset(&lat, 0xA5, sizeof(lat));
+            dp = (int)Lp_GetLatency((uint8_t)a, &lat);
+            printf("%d %u %u %u %u\n", dp, (unsigned)lat.EntryUs, (unsigned)lat.HwWakeUs,
+                   (unsigned)lat.RestoreUs, (unsigned)lat.MinUs);
+        } else if(cmd == 'R') {
+            Lp_ResetStats();
+            printf("ok\n");
+        } else if(cmd == 'S') {
+            memset(&st, 0xA5, sizeof(st));
+            Lp_GetStats(&st);
+            for(i = 0; i < LP_MODE_MAX; i++) {
+                printf("%u %u %llu %u ", (unsigned)st.Mode[i].Count, (unsigned)st.Mode[i].Early,
+                       (unsigned long long)st.Mode[i].TimeUs, (unsigned)st.Mode[i].MaxRestoreCycles);
+            }
+            printf("%u %u %d %d %d\n", (unsigned)st.Demoted, (unsigned)st.ClockFail, depth, bad_lock, bad_call);
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def ceil_div(a, b):
+    return (a + b - 1) // b
+
+
+class Model:
+    """lp_gov.c 的参考模型"""
+
+    def __init__(self):
+        self.ready = False
+        self.max_latency = FOREVER
+        self.cyc = 0
+        self.now = 0
+        self.deepest = 0
+        self.clear_all()
+
+    def clear_all(self):
+        self.lat = [[0, 0, 0, 0] for _ in range(MODE_MAX)]
+        self.entry_max = [0] * MODE_MAX
+        self.restore_max = [0] * MODE_MAX
+        self.block = [0] * MODE_MAX
+        self.clear_stats()
+
+    def clear_stats(self):
+        self.count = [0] * MODE_MAX
+        self.early = [0] * MODE_MAX
+        self.time = [0] * MODE_MAX
+        self.maxrc = [0] * MODE_MAX
+        self.demoted = 0
+        self.clockfail = 0
+
+    def init(self, num, timed, deepest, flags, lat):
+        self.ready = False
+        self.deepest = max(deepest, 0)
+        if flags & 12 or num > MODE_MAX:
+            return str(ERR_PARAM)
+        self.num, self.timed, self.has_deepest, self.flags = num, timed, deepest >= 0, flags
+        self.clear_all()
+        for m in range(num):
+            self.lat[m] = list(lat[m])
+        self.ready = True
+        return str(OK)
+
+    def valid(self, m):
+        return self.ready and m != MODE_RUN and m < self.num
+
+    def entry_us(self, m):
+        return self.entry_max[m] or self.lat[m][0]
+
+    def exit_us(self, m):
+        return (self.lat[m][1] + (self.restore_max[m] or self.lat[m][2])) & MASK32
+
+    def select(self, idle):
+        allowed, demoted = self.num - 1, False
+        for m in range(1, self.num):
+            if self.block[m]:
+                allowed = m - 1
+                break
+        if self.has_deepest:
+            allowed = min(allowed, self.deepest)
+        mode = MODE_RUN
+        for m in range(self.num - 1, MODE_RUN, -1):
+            ex = self.exit_us(m)
+            if self.entry_us(m) + ex + self.lat[m][3] > idle:
+                continue
+            if m > allowed or ex > self.max_latency:
+                demoted = True
+                continue
+            mode = m
+            break
+        if demoted:
+            self.demoted += 1
+        return mode
+
+    def idle(self, deadline, cyc_step, mhz, now_step, arm_cap, fired, fail, rc, rm):
+        res = dict(arm=-1, arm_us=-1, enter=-1, suspend=-1, wake=-1, resume=-1, slept=0)
+
+        def line(mode):
+            return '%d %d %d %d %d %d %d %d' % (mode, res['arm'], res['arm_us'], res['enter'], res['suspend'],
+                                                res['wake'], res['resume'], res['slept'])
+
+        if not self.ready:
+            return line(MODE_RUN)
+        self.cyc = (self.cyc + cyc_step) & MASK32
+        mode = self.select(deadline)
+        if mode == MODE_RUN:
+            return line(mode)
+        has_now, has_cb = self.flags & 1, self.flags & 2
+        timed = mode >= self.timed
+        if has_now:
+            self.now = (self.now + now_step) & MASK32
+        planned = 0
+        if timed:
+            if has_cb:
+                res['suspend'] = mode
+            arm = (deadline - self.exit_us(mode)) & MASK32
+            res['arm'], res['arm_us'] = mode, arm - (1 << 32) if arm >= 1 << 31 else arm
+            planned = 0 if arm_cap == 0 else min(arm, arm_cap)
+        self.cyc = (self.cyc + cyc_step) & MASK32
+        self.entry_max[mode] = max(self.entry_max[mode], ceil_div(cyc_step, mhz))
+        res['enter'] = mode
+        if timed:
+            if has_cb:
+                res['wake'] = mode
+            if fail:
+                self.clockfail += 1
+            self.maxrc[mode] = max(self.maxrc[mode], rc)
+            self.restore_max[mode] = max(self.restore_max[mode], ceil_div(rc, rm))
+            if not fired:
+                self.early[mode] += 1
+        slept = 0
+        if timed and fired and planned:
+            slept = planned
+        elif has_now:
+            slept = now_step
+            self.now = (self.now + now_step) & MASK32
+        if timed and has_cb:
+            res['resume'], res['slept'] = mode, slept
+        self.count[mode] += 1
+        self.time[mode] += slept
+        return line(mode)
+
+    def set_block(self, m, inc):
+        if not self.valid(m):
+            return 'ok'
+        if inc:
+            self.block[m] += 1
+        elif self.block[m]:
+            self.block[m] -= 1
+        return 'ok'
+
+    def set_latency(self, m, lat):
+        if not self.valid(m):
+            return str(ERR_PARAM)
+        self.lat[m] = list(lat)
+        self.entry_max[m] = self.restore_max[m] = 0
+        return str(OK)
+
+    def get_latency(self, m):
+        if not self.ready or m >= self.num:
+            return '%d %d %d %d %d' % ((ERR_PARAM,) + (0xA5A5A5A5,) * 4)
+        hw = self.lat[m][1]
+        return '%d %d %d %d %d' % (OK, self.entry_us(m), hw, (self.exit_us(m) - hw) & MASK32, self.lat[m][3])
+
+    def reset(self):
+        if self.ready:
+            self.clear_stats()
+            self.entry_max = [0] * MODE_MAX
+            self.restore_max = [0] * MODE_MAX
+        return 'ok'
+
+    def stat_line(self):
+        if not self.ready:
+            return ' '.join(['0'] * (MODE_MAX * 4 + 2)) + ' 0 0 0'
+        out = []
+        for m in range(MODE_MAX):
+            out += [self.count[m], self.early[m], self.time[m], self.maxrc[m]]
+        return ' '.join(str(v) for v in out + [self.demoted, self.clockfail]) + ' 0 0 0'
+
+
+def gen_latency(rnd, num):
+    """随机时延表, 偶尔给出接近 32 位上限的值检查 64 位求和"""
+    lat = [[0, 0, 0, 0]]
+    for m in range(1, num):
+        if rnd.random() < 0.05:
+            lat.append([rnd.randint(0, 0x7FFFFFFF) for _ in range(4)])
+        else:
+            lat.append([rnd.randint(0, 20), rnd.randint(0, 200 * m), rnd.randint(0, 3000 * m),
+                        rnd.choice((0, rnd.randint(0, 20000 * m)))])
+    return lat
+
+
+def scenario(rnd, ops):
+    """一个场景的命令和期望输出"""
+    m = Model()
+    cmds, exp = [], []
+    num = 4
+
+    def init():
+        nonlocal num
+        num = rnd.choice((2, 3, 3, 4, 4, 5 if rnd.random() < 0.1 else 4))
+        timed = rnd.randint(1, min(num, MODE_MAX))
+        deepest = rnd.choice((-1, -1, rnd.randint(0, max(num - 1, 0))))
+        flags = rnd.randint(0, 3)
+        if rnd.random() < 0.05:
+            flags |= rnd.choice((4, 8))
+        lat = gen_latency(rnd, min(num, MODE_MAX))
+        cmds.append('I %d %d %d %d %s' % (num, timed, deepest, flags,
+                                          ' '.join('%d %d %d %d' % tuple(l) for l in lat)))
+        exp.append(m.init(num, timed, deepest, flags, lat))
+
+    def mode():
+        return rnd.choice((0, rnd.randint(1, max(num - 1, 1)), rnd.randint(1, max(num - 1, 1)), num, 7))
+
+    if rnd.random() < 0.8:
+        init()
+    if rnd.random() < 0.3:
+        c, n = rnd.choice((0, 0xFFFFFF00)), rnd.choice((0, 0xFFFFF000))
+        cmds.append('C %d %d' % (c, n))
+        exp.append('ok')
+        m.cyc, m.now = c, n
+    for _ in range(ops):
+        r = rnd.random()
+        if r < 0.45:
+            deadline = rnd.choice((rnd.randint(0, 100), rnd.randint(0, 30000), rnd.randint(0, 2000000),
+                                   FOREVER, FOREVER - rnd.randint(0, 5)))
+            mhz = rnd.choice((1, 8, 16, 168, 240))
+            args = (deadline, rnd.randint(0, 2000), mhz, rnd.randint(0, 3000000),
+                    rnd.choice((0, 0, rnd.randint(1, 200000), FOREVER)), rnd.randint(0, 1),
+                    int(rnd.random() < 0.1), rnd.randint(0, 400000), rnd.choice((1, 16, 20, 40, 100)))
+            cmds.append('D %d %d %d %d %d %d %d %d %d' % args)
+            exp.append(m.idle(*args))
+        elif r < 0.55:
+            k = mode()
+            cmds.append('B %d' % k)
+            exp.append(m.set_block(k, True))
+        elif r < 0.65:
+            k = mode()
+            cmds.append('U %d' % k)
+            exp.append(m.set_block(k, False))
+        elif r < 0.7:
+            us = rnd.choice((FOREVER, rnd.randint(0, 500), rnd.randint(0, 5000)))
+            if m.ready and rnd.random() < 0.5:
+                # 恰好等于某个模式当前的唤醒时延, 该模式仍可用
+                us = m.exit_us(rnd.randint(1, m.num - 1))
+            cmds.append('M %d' % us)
+            exp.append('ok')
+            m.max_latency = us
+        elif r < 0.75:
+            k = mode()
+            lat = gen_latency(rnd, 2)[1]
+            cmds.append('L %d %d %d %d %d' % ((k,) + tuple(lat)))
+            exp.append(m.set_latency(k, lat))
+        elif r < 0.83:
+            k = mode()
+            cmds.append('G %d' % k)
+            exp.append(m.get_latency(k))
+        elif r < 0.86:
+            d = rnd.randint(0, 3)
+            cmds.append('P %d' % d)
+            exp.append('ok')
+            m.deepest = d
+        elif r < 0.88:
+            cmds.append('R')
+            exp.append(m.reset())
+        elif r < 0.9:
+            init()
+        else:
+            cmds.append('S')
+            exp.append(m.stat_line())
+    cmds.append('S')
+    exp.append(m.stat_line())
+    return cmds, exp, m
+
+
+def run(exe, queries):
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d\n%s' % (r.returncode, r.stdout[-2000:]))
+    return r.stdout.splitlines()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=300, help='随机场景个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'lp_gov_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O1', '-g', '-Wall', '-Wextra', '-Werror', '-fsanitize=address',
+               '-fno-omit-frame-pointer', '-no-pie', '-fno-pie', '-I', ROOT, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        bad = 0
+
+        def fail(msg):
+            nonlocal bad
+            if bad < MAX_REPORT:
+                print(msg)
+            bad += 1
+
+        ops = 0
+        sleeps = [0] * MODE_MAX
+        for no in range(args.cases):
+            cmds, exp, m = scenario(rnd, rnd.randint(20, 120))
+            ops += len(cmds)
+            for k in range(MODE_MAX):
+                sleeps[k] += m.count[k]
+            got = run(exe, cmds)
+            if len(got) != len(exp):
+                fail('场景 %d: 输出 %d 行, 应为 %d 行' % (no, len(got), len(exp)))
+                continue
+            for c, g, e in zip(cmds, got, exp):
+                if g != e:
+                    fail('场景 %d: %s 得到 %s, 应为 %s' % (no, c[:60], g, e))
+                    break
+            stat = got[-1].split()
+            if stat[-3:] != ['0', '0', '0']:
+                fail('场景 %d: Lock 深度 %s, 不成对 %s, Lock 外调用 %s 次' % ((no,) + tuple(stat[-3:])))
+    except RuntimeError as e:
+        print(e)
+        return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    print('%d 个场景, %d 次操作, 各模式休眠 %s 次, 差异 %d 项' %
+          (args.cases, ops, '/'.join(str(v) for v in sleeps[1:]), bad))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,562 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/rng_pool.c 的主机测试: 用主机编译器(开 AddressSanitizer)编译 rng_pool.c 和一个读标准输入的
+驱动, 驱动代替各模板的 rng_hw.c 把原始字交给 Rng_Feed, 结果与 Python 写的参考模型逐项比较.
+
+    rng_pool_test.py [--cc gcc] [--cases 200] [--seed 1]
+        1. ChaCha20 块函数对照 RFC 8439 的测试向量: 2.3.2 块函数、2.4.2 加密(两块密钥流)、
+           附录 A.1 全零密钥的第 0/1 块(即 Rng_Fill 首次播种前的密钥); 块计数器 32 位溢出进位到
+           State[13];
+        2. 随机场景: 随机原始字中插入卡死的字节(RCT 恰好超限和差一次)、偏斜的字节分布(APT)、
+           硬件种子/时钟错误, 穿插 Rng_PoolStart / Rng_Fill / Rng_TlsCallback / Rng_Raw /
+           Rng_Available; 驱动按 Rng_Feed 的返回值停止喂数, 和关 RNG 中断一样;
+           每一步的返回值、输出字节、统计、ChaCha20 状态与参考模型相同, 其中
+           - 启动检测丢弃前 256 字, 检测失败丢弃池中失败前的数据并重新做启动检测;
+           - 连续失败超过 3 次判定故障, Halt 只调用一次, 之后 Rng_Fill / Rng_Raw 不再输出;
+           - Rng_Fill 先用当前密钥第 0 块换密钥, 输出从第 1 块开始(快速密钥擦除),
+             每 4096 字节重播种, 池不足一个种子时推迟; 出错时输出缓冲不变;
+           - Rng_Raw 按入池顺序取字, 不足 4 字节的尾部只取前几个字节;
+        3. Lock/Unlock 成对且嵌套正确, Resume 只在 Lock 内调用, 每次取数都调用.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 rng_pool.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+POOL_WORDS = 64
+SEED_WORDS = 8
+STARTUP_WORDS = 256
+FAIL_MAX = 3
+RESEED_BYTES = 4096
+RCT_CUTOFF = 11
+APT_WINDOW = 512
+APT_CUTOFF = 177
+OK, ERR_FAILED, ERR_UNSEEDED = 0, -1, -2
+FAULT_SEED, FAULT_CLOCK = 0, 1
+SIGMA = [0x61707865, 0x3320646E, 0x79622D32, 0x6B206574]
+MASK32 = 0xFFFFFFFF
+MAX_REPORT = 20
+
+# rng_pool.c 直接包含进驱动, 块函数 rng_block 是 static 的
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rng_pool.c"
+
+static Rng_Pool pool;
+static int depth, bad_lock, bad_resume;
+static unsigned resumes, halts;
+
+static uint32_t host_lock(void) {
+    depth++;
+    return 0x5A000000u | (uint32_t)depth;
+}
+
+static void host_unlock(uint32_t State) {
+    if(State != (0x5A000000u | (uint32_t)depth)) bad_lock++;
+    depth--;
+}
+
+static void host_resume(void) {
+    resumes++;
+    if(depth == 0) bad_resume++;
+}
+
+static void host_halt(void) {
+    halts++;
+}
+
+static const Rng_Port port = {host_lock, host_unlock, host_resume, host_halt};
+
+static void hex(const uint8_t *p, uint32_t n) {
+    while(n--) printf("%02x", *p++);
+}
+
+static uint8_t *buffer(uint32_t n) {
+    uint8_t *p = malloc(n ? n : 1);
+
+    memset(p, 0xA5, n);
+    return p;
+}
+
+int main(void) {
+    char cmd;
+    unsigned n, i, w[16];
+    int kind;
+    Rng_Stats st;
+
+    while(scanf(" %c", &cmd) == 1) {
+        if(cmd == 'I') {
+            Rng_PoolInit(&pool, &port);
+            printf("ok\n");
+        } else if(cmd == 'F') {
+            uint8_t ret = 0;
+            unsigned fed = 0;
+            if(scanf("%u", &n) != 1) return 2;
+            for(i = 0; i < n; i++) {
+                unsigned word;
+                if(scanf("%x", &word) != 1) return 2;
+                if(ret) continue;
+                ret = Rng_Feed(word);
+                fed++;
+            }
+            printf("%u %u\n", fed, ret);
+        } else if(cmd == 'E') {
+            if(scanf("%d", &kind) != 1) return 2;
+            Rng_Fault((uint8_t)kind);
+            printf("ok\n");
+        } else if(cmd == 'P') {
+            if(scanf("%u", &n) != 1) return 2;
+            printf("%d\n", (int)Rng_PoolStart(n));
+        } else if(cmd == 'G' || cmd == 'T' || cmd == 'R') {
+            uint8_t *p;
+            long ret;
+            if(scanf("%u", &n) != 1) return 2;
+            p = buffer(n);
+            if(cmd == 'G') ret = Rng_Fill(p, n);
+            else if(cmd == 'T') ret = Rng_TlsCallback(NULL, p, n);
+            else ret = (long)Rng_Raw(p, n);
+            printf("%ld ", ret);
+            hex(p, n);
+            printf("\n");
+            free(p);
+        } else if(cmd == 'A') {
+            printf("%u\n", (unsigned)Rng_Available());
+        } else if(cmd == 'S') {
+            Rng_GetStats(&st);
+            printf("%u %u %u %u %u %u %u %u %u %u %d %d %d\n", (unsigned)st.Words,
+                   (unsigned)st.RctFailures, (unsigned)st.AptFailures, (unsigned)st.SeedErrors,
+                   (unsigned)st.ClockErrors, (unsigned)st.Reseeds, (unsigned)st.ReseedDeferred,
+                   st.Failed, resumes, halts, depth, bad_lock, bad_resume);
+        } else if(cmd == 'K') {
+            for(i = 0; i < 16; i++) printf("%08x%c", (unsigned)pool.ChaCha[i], i == 15 ? '\n' : ' ');
+        } else if(cmd == 'B') {
+            uint32_t state[16], out[16];
+            for(i = 0; i < 16; i++) {
+                if(scanf("%x", &w[i]) != 1) return 2;
+                state[i] = w[i];
+            }
+            rng_block(state, out);
+            for(i = 0; i < 16; i++) printf("%08x ", (unsigned)out[i]);
+            printf("%08x %08x\n", (unsigned)state[12], (unsigned)state[13]);
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+# RFC 8439 测试向量: (密钥, 计数器, nonce, 期望输出)
+KEY_SEQ = bytes(range(32))
+RFC_BLOCKS = [
+    ('2.3.2', KEY_SEQ, 1, bytes.fromhex('000000090000004a00000000'),
+     '10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e'
+     'd2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e'),
+    ('A.1 #1', bytes(32), 0, bytes(12),
+     '76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7'
+     'da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586'),
+    ('A.1 #2', bytes(32), 1, bytes(12),
+     '9f07e7be5551387a98ba977c732d080dcb0f29a048e3656912c6533e32ee7aed'
+     '29b721769ce64e43d57133b074d839d531ed1f28510afb45ace10a1f4b794d6f'),
+]
+RFC_ENCRYPT = ('2.4.2', KEY_SEQ, 1, bytes.fromhex('000000000000004a00000000'),
+               b"Ladies and Gentlemen of the class of '99: If I could offer you only one tip for "
+               b"the future, sunscreen would be it.",
+               '6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b'
+               'f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8'
+               '07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736'
+               '5af90bbf74a35be6b40b8eedf2785e42874d')
+
+
+def rfc_state(key, counter, nonce):
+    return SIGMA + list(struct.unpack('<8I', key)) + [counter] + list(struct.unpack('<3I', nonce))
+
+
+def rotl(v, n):
+    return ((v << n) | (v >> (32 - n))) & MASK32
+
+
+def quarter(x, a, b, c, d):
+    x[a] = (x[a] + x[b]) & MASK32
+    x[d] = rotl(x[d] ^ x[a], 16)
+    x[c] = (x[c] + x[d]) & MASK32
+    x[b] = rotl(x[b] ^ x[c], 12)
+    x[a] = (x[a] + x[b]) & MASK32
+    x[d] = rotl(x[d] ^ x[a], 8)
+    x[c] = (x[c] + x[d]) & MASK32
+    x[b] = rotl(x[b] ^ x[c], 7)
+
+
+def chacha_block(state):
+    """返回一块输出(16 个字), state 的计数器加 1, 与 rng_block 相同"""
+    x = list(state)
+    for _ in range(10):
+        quarter(x, 0, 4, 8, 12)
+        quarter(x, 1, 5, 9, 13)
+        quarter(x, 2, 6, 10, 14)
+        quarter(x, 3, 7, 11, 15)
+        quarter(x, 0, 5, 10, 15)
+        quarter(x, 1, 6, 11, 12)
+        quarter(x, 2, 7, 8, 13)
+        quarter(x, 3, 4, 9, 14)
+    out = [(a + b) & MASK32 for a, b in zip(x, state)]
+    state[12] = (state[12] + 1) & MASK32
+    if state[12] == 0:
+        state[13] = (state[13] + 1) & MASK32
+    return out
+
+
+def words_bytes(words):
+    return struct.pack('<%dI' % len(words), *words)
+
+
+class Model(object):
+    """rng_pool.c 的参考模型, 计数器不回绕"""
+
+    def __init__(self):
+        self.pool = [0] * POOL_WORDS
+        self.head = self.tail = self.fail_head = self.epoch = self.seen = 0
+        self.failed = False
+        self.startup = STARTUP_WORDS
+        self.fail_run = 0
+        self.rct_last = self.rct_count = 0
+        self.apt_first = self.apt_count = self.apt_index = 0
+        self.chacha = SIGMA + [0] * 12
+        self.since = 0
+        self.seeded = False
+        self.stats = [0] * 7         # Words Rct Apt Seed Clock Reseeds Deferred
+        self.resumes = self.halts = 0
+
+    def restart(self):
+        self.fail_head = self.head
+        self.epoch += 1
+        self.startup = STARTUP_WORDS
+        self.rct_count = 0
+        self.apt_index = 0
+        self.fail_run += 1
+        if self.fail_run > FAIL_MAX and not self.failed:
+            self.failed = True
+            self.halts += 1
+
+    def health(self, word):
+        for i in range(4):
+            b = (word >> (8 * i)) & 0xFF
+            if self.rct_count and b == self.rct_last:
+                self.rct_count += 1
+                if self.rct_count >= RCT_CUTOFF:
+                    self.stats[1] += 1
+                    return True
+            else:
+                self.rct_last = b
+                self.rct_count = 1
+            if self.apt_index == 0:
+                self.apt_first = b
+                self.apt_count = 1
+            elif b == self.apt_first:
+                self.apt_count += 1
+                if self.apt_count >= APT_CUTOFF:
+                    self.stats[2] += 1
+                    return True
+            self.apt_index = (self.apt_index + 1) % APT_WINDOW
+        return False
+
+    def feed(self, word):
+        if self.failed:
+            return 1
+        if self.health(word):
+            self.restart()
+            return int(self.failed)
+        if self.startup:
+            self.startup -= 1
+            if self.startup == 0:
+                self.fail_run = 0
+            return 0
+        self.pool[self.head % POOL_WORDS] = word
+        self.head += 1
+        self.stats[0] += 1
+        return int(self.head - self.tail >= POOL_WORDS)
+
+    def feed_many(self, words):
+        fed, ret = 0, 0
+        for w in words:
+            ret = self.feed(w)
+            fed += 1
+            if ret:
+                break
+        return '%d %d' % (fed, ret)
+
+    def fault(self, kind):
+        self.stats[3 if kind == FAULT_SEED else 4] += 1
+        self.restart()
+        return 'ok'
+
+    def sync(self):
+        if self.seen != self.epoch:
+            self.seen = self.epoch
+            self.tail = self.fail_head
+
+    def take(self):
+        if self.head == self.tail:
+            return None
+        w = self.pool[self.tail % POOL_WORDS]
+        self.pool[self.tail % POOL_WORDS] = 0
+        self.tail += 1
+        if not self.failed:
+            self.resumes += 1
+        return w
+
+    def reseed(self):
+        if self.head - self.tail < SEED_WORDS:
+            return False
+        for i in range(SEED_WORDS):
+            self.chacha[4 + i] ^= self.take()
+        self.chacha[12] = self.chacha[13] = 0
+        self.since = 0
+        self.seeded = True
+        self.stats[5] += 1
+        return True
+
+    def available(self):
+        self.sync()
+        return (self.head - self.tail) * 4
+
+    def start(self, spins):
+        for _ in range(spins):
+            if self.failed:
+                return str(ERR_FAILED)
+            if self.available() >= SEED_WORDS * 4:
+                break
+        self.sync()
+        ok = False if self.failed else self.reseed()
+        if self.failed:
+            return str(ERR_FAILED)
+        return str(OK if ok else ERR_UNSEEDED)
+
+    def fill(self, n):
+        self.sync()
+        if self.failed:
+            return ERR_FAILED, b'\xa5' * n
+        if not self.seeded or self.since >= RESEED_BYTES:
+            if not self.reseed():
+                if not self.seeded:
+                    return ERR_UNSEEDED, b'\xa5' * n
+                self.stats[6] += 1
+        self.since += n
+        block = chacha_block(self.chacha)
+        state = list(self.chacha)
+        self.chacha[4:12] = block[:8]
+        self.chacha[12] = self.chacha[13] = 0
+        out = b''
+        while len(out) < n:
+            out += words_bytes(chacha_block(state))
+        return OK, out[:n]
+
+    def raw(self, n):
+        self.sync()
+        out = b''
+        if not self.failed:
+            while len(out) < n:
+                w = self.take()
+                if w is None:
+                    break
+                out += words_bytes([w])[:n - len(out)]
+        return '%d %s' % (len(out), (out + b'\xa5' * (n - len(out))).hex())
+
+    def stat_line(self):
+        return ' '.join(map(str, self.stats + [int(self.failed), self.resumes, self.halts, 0, 0, 0]))
+
+    def key_line(self):
+        return ' '.join('%08x' % w for w in self.chacha)
+
+
+def gen_words(rnd, n):
+    """原始字, 偶尔插入卡死的字节或偏斜分布"""
+    out = []
+    while len(out) < n:
+        r = rnd.random()
+        if r < 0.01:
+            b = rnd.randint(0, 255) * 0x01010101
+            # 11 个相同字节超限; 10 个相同字节(差一次)应通过
+            if rnd.random() < 0.5:
+                out += [b, b, (b & 0xFFFFFF) | ((b ^ 0x01) & 0xFF) << 24]
+            else:
+                out += [b, b, (b & 0xFFFF) | (((b ^ 0x01) & 0xFF) << 16) | (((b ^ 0x02) & 0xFF) << 24)]
+        elif r < 0.015:
+            b = rnd.randint(0, 255)
+            for _ in range(rnd.randint(100, 200)):
+                w = 0
+                for i in range(4):
+                    w |= (b if rnd.random() < 0.45 else rnd.randint(0, 255)) << (8 * i)
+                out.append(w)
+        else:
+            out.append(rnd.getrandbits(32))
+    return out[:n]
+
+
+def scenario(rnd, ops):
+    """一个场景的命令和期望输出"""
+    m = Model()
+    cmds, exp = ['I'], ['ok']
+
+    def feed(n):
+        words = gen_words(rnd, n)
+        cmds.append('F %d %s' % (len(words), ' '.join('%x' % w for w in words)))
+        exp.append(m.feed_many(words))
+
+    feed(STARTUP_WORDS + rnd.randint(-8, 40))
+    cmds.append('P %d' % rnd.randint(0, 3))
+    exp.append(m.start(int(cmds[-1].split()[1])))
+    for _ in range(ops):
+        r = rnd.random()
+        if r < 0.3:
+            feed(rnd.choice((rnd.randint(1, 16), rnd.randint(16, 80), STARTUP_WORDS + rnd.randint(0, 64))))
+        elif r < 0.5:
+            n = rnd.choice((0, 1, 31, 32, 64, 65, rnd.randint(0, 300), rnd.randint(300, 2500)))
+            ret, out = m.fill(n)
+            if rnd.random() < 0.2:
+                cmds.append('T %d' % n)
+                exp.append('%d %s' % (0 if ret == OK else -1, out.hex()))
+            else:
+                cmds.append('G %d' % n)
+                exp.append('%d %s' % (ret, out.hex()))
+        elif r < 0.65:
+            n = rnd.choice((0, 1, 3, 4, 5, 32, rnd.randint(0, 300)))
+            cmds.append('R %d' % n)
+            exp.append(m.raw(n))
+        elif r < 0.72:
+            cmds.append('A')
+            exp.append(str(m.available()))
+        elif r < 0.76:
+            kind = rnd.choice((FAULT_SEED, FAULT_CLOCK))
+            cmds.append('E %d' % kind)
+            exp.append(m.fault(kind))
+        elif r < 0.78:
+            cmds.append('P %d' % rnd.randint(0, 2))
+            exp.append(m.start(int(cmds[-1].split()[1])))
+        elif r < 0.9:
+            cmds.append('K')
+            exp.append(m.key_line())
+        else:
+            cmds.append('S')
+            exp.append(m.stat_line())
+    cmds += ['S', 'K']
+    exp += [m.stat_line(), m.key_line()]
+    return cmds, exp, m
+
+
+def run(exe, queries):
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d\n%s' % (r.returncode, r.stdout[-2000:]))
+    return r.stdout.splitlines()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=200, help='随机场景个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'rng_pool_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O1', '-g', '-Wall', '-Wextra', '-Werror', '-fsanitize=address',
+               '-fno-omit-frame-pointer', '-no-pie', '-fno-pie', '-I', ROOT, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        bad = 0
+
+        def fail(msg):
+            nonlocal bad
+            if bad < MAX_REPORT:
+                print(msg)
+            bad += 1
+
+        # 1. RFC 8439 向量, 先查参考模型再查 rng_block
+        vectors = 0
+        queries, expect = [], []
+        for name, key, counter, nonce, want in RFC_BLOCKS:
+            state = rfc_state(key, counter, nonce)
+            if words_bytes(chacha_block(list(state))).hex() != want:
+                fail('参考模型与 RFC 8439 %s 不符' % name)
+            queries.append('B ' + ' '.join('%x' % w for w in state))
+            expect.append((name, want, counter + 1, state[13]))
+        name, key, counter, nonce, plain, cipher_want = RFC_ENCRYPT
+        state = rfc_state(key, counter, nonce)
+        for i in range((len(plain) + 63) // 64):
+            s = list(state)
+            s[12] += i
+            queries.append('B ' + ' '.join('%x' % w for w in s))
+            expect.append((name, None, s[12] + 1, s[13]))
+        carry = SIGMA + [rnd.getrandbits(32) for _ in range(8)] + [MASK32, 7, 0, 0]
+        queries.append('B ' + ' '.join('%x' % w for w in carry))
+        expect.append(('计数器进位', words_bytes(chacha_block(list(carry))).hex(), 0, 8))
+        stream = b''
+        for line, (name, want, c12, c13) in zip(run(exe, queries), expect):
+            w = [int(v, 16) for v in line.split()]
+            got = words_bytes(w[:16]).hex()
+            vectors += 1
+            if want is None:
+                stream += bytes.fromhex(got)
+            elif got != want:
+                fail('rng_block %s: 得到 %s, 应为 %s' % (name, got, want))
+            if (w[16], w[17]) != (c12, c13):
+                fail('rng_block %s: 计数器 %08x %08x, 应为 %08x %08x' % (name, w[16], w[17], c12, c13))
+        cipher = bytes(a ^ b for a, b in zip(plain, stream)).hex()
+        if cipher != cipher_want:
+            fail('RFC 8439 2.4.2 加密: 得到 %s, 应为 %s' % (cipher, cipher_want))
+
+        # 2/3. 随机场景
+        ops = 0
+        failed = 0
+        for no in range(args.cases):
+            cmds, exp, m = scenario(rnd, rnd.randint(20, 80))
+            ops += len(cmds)
+            failed += m.failed
+            got = run(exe, cmds)
+            if len(got) != len(exp):
+                fail('场景 %d: 输出 %d 行, 应为 %d 行' % (no, len(got), len(exp)))
+                continue
+            for c, g, e in zip(cmds, got, exp):
+                if g != e:
+                    fail('场景 %d: %s 得到 %s, 应为 %s' % (no, c[:40], g[:120], e[:120]))
+                    break
+            stat = got[-2].split()
+            if stat[-3:] != ['0', '0', '0']:
+                fail('场景 %d: Lock 深度 %s, 不成对 %s, Lock 外调用 Resume %s 次' % ((no,) + tuple(stat[-3:])))
+            if int(stat[9]) > 1:
+                fail('场景 %d: Halt 调用 %s 次' % (no, stat[9]))
+    except RuntimeError as e:
+        print(e)
+        return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    print('RFC 8439 向量 %d 块, %d 个场景(%d 个判定故障), %d 次操作, 差异 %d 项' %
+          (vectors, args.cases, failed, ops, bad))
+    return 1 if bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
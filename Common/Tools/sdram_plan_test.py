@@ -0,0 +1,457 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/sdram_plan.c 的主机测试: 用主机编译器(开 AddressSanitizer)编译 sdram_plan.c 和一个读标准输入的
+驱动, 结果与 Python 写的参考模型逐项比较.
+
+    sdram_plan_test.py [--cc gcc] [--cases 400] [--seed 1]
+        1. SDRAM_PlanTiming: 随机时序和时钟, 周期数为向上取整且至少 1, tWR 满足
+           tWR >= tRAS - tRCD 和 tWR >= tRC - tRCD - tRP, 刷新间隔与参考一致;
+           InBanks 不是 2/4、RefreshRows 为 0 或时钟为 0 时返回 SDRAM_ERR_PARAM;
+        2. SDRAM_PickDiv: 返回不超过 MaxHz 的最小分频, 都超过时返回 0;
+        3. SDRAM_Attach: 容量、bank、行大小不一致或映射非法时返回 SDRAM_ERR_PARAM,
+           之后 SDRAM_Alloc 返回 NULL; 传 NULL 后同样不能分配;
+        4. 分配器: 随机几何(列 8~11 位、行 11~13 位、8/16/32 位宽、2/4 个 bank, 两种映射)和
+           随机分配序列(指定 bank、SDRAM_BANK_ANY、非法 bank、超大请求), 地址与参考一致, 对齐到
+           SDRAM_ALIGN, 互不重叠, 不越界; 按地址线模型算出的 bank 与请求一致:
+           BANK_ROW_COL 整个缓冲在请求的 bank 内, ROW_BANK_COL 起点在请求的 bank 的行段开头,
+           两个起点在不同 bank 的缓冲按相同偏移访问时 bank 始终不同; SDRAM_BankOf 与地址线
+           模型一致, SDRAM 之外返回 SDRAM_BANK_ANY; SDRAM_FreeAll 后从头分配;
+        5. SDRAM_BenchRun: 在静态数组上跑两种映射, 读写不出 SDRAM 范围(ASan 检查),
+           测试缓冲之外的内容不变, 整片测试时下标绕回也不越界; 未登记 SDRAM 时结果全为 0 且不访问内存.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 sdram_plan.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'sdram_plan.c')
+ALIGN = 32
+BANK_ANY = 0xFF
+MAP_BRC, MAP_RBC = 0, 1
+OK, ERR_PARAM = 0, -1
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdram_plan.h"
+
+/* 测试缓冲的几何: 列 8 位、行 11 位、16 位宽、4 bank, 共 4MB; 测试缓冲放在最后一个 bank, 越界读会碰到 ASan 的保护区 */
+#define BENCH_SIZE      (4UL << 20)
+#define BENCH_BUF       (64UL << 10)
+
+static uint8_t region[BENCH_SIZE];
+static uint8_t shadow[BENCH_SIZE];
+
+static int bench(void) {
+    static volatile uint32_t cycles;
+    SDRAM_BenchResult r;
+    SDRAM_Info info;
+    uint8_t *buf;
+    uint32_t i, map;
+
+    for (map = 0; map < 2; map++) {
+        info.Base = (uint32_t)(uintptr_t)region;
+        info.Size = BENCH_SIZE;
+        info.RowSize = 512;
+        info.BankSize = BENCH_SIZE / 4;
+        info.InBanks = 4;
+        info.Map = (uint8_t)map;
+        if (SDRAM_Attach(&info) != SDRAM_OK) return 1;
+        (void)SDRAM_Alloc(100, 0);
+        buf = SDRAM_Alloc(BENCH_BUF, 3);
+        if (buf == NULL) return 2;
+        for (i = 0; i < BENCH_SIZE; i++) region[i] = (uint8_t)(i * 7 + map);
+        memcpy(shadow, region, BENCH_SIZE);
+        SDRAM_BenchRun(buf, BENCH_BUF, &cycles, 240000000, &r);
+        for (i = 0; i < BENCH_SIZE; i++) {
+            if (&region[i] >= buf && &region[i] < buf + BENCH_BUF) continue;
+            if (region[i] != shadow[i]) {
+                printf("bench map %lu: offset %lu changed\n", (unsigned long)map, (unsigned long)i);
+                return 3;
+            }
+        }
+        if (r.SeqWrite || r.SeqRead || r.StrideRead || r.SameBankRead || r.CrossBankRead || r.RandRead) return 4;
+        /* 整片测试: 各项读的下标绕回, 检查掩码 */
+        SDRAM_BenchRun(region, BENCH_SIZE, &cycles, 240000000, &r);
+    }
+
+    (void)SDRAM_Attach(NULL);
+    memcpy(shadow, region, BENCH_SIZE);
+    memset(&r, 0x55, sizeof(r));
+    SDRAM_BenchRun(region, BENCH_BUF, &cycles, 240000000, &r);
+    if (r.SeqWrite || r.SeqRead || r.StrideRead || r.SameBankRead || r.CrossBankRead || r.RandRead) return 5;
+    if (memcmp(region, shadow, BENCH_SIZE) != 0) return 6;
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    char op[4];
+    unsigned long a[12];
+    SDRAM_Config cfg;
+    SDRAM_Timing t;
+    SDRAM_Info info;
+    long ret;
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) return bench();
+
+    memset(&cfg, 0, sizeof(cfg));
+    while (scanf("%3s", op) == 1) {
+        if (op[0] == 'P') {
+            if (scanf("%lu %lu %lu %lu %lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5],
+                      &a[6], &a[7], &a[8], &a[9]) != 10) return 1;
+            cfg.InBanks = (uint8_t)a[0];
+            cfg.RefreshRows = (uint16_t)a[1];
+            cfg.RefreshMs = (uint16_t)a[2];
+            cfg.tRCD = (uint16_t)a[4];
+            cfg.tRP = (uint16_t)a[5];
+            cfg.tRC = (uint16_t)a[6];
+            cfg.tRAS = (uint16_t)a[7];
+            cfg.tXSR = (uint16_t)a[8];
+            cfg.tWR = (uint16_t)a[9];
+            memset(&t, 0, sizeof(t));
+            ret = SDRAM_PlanTiming(&cfg, (uint32_t)a[3], &t);
+            printf("%ld %lu %lu %lu %lu %lu %lu %lu\n", ret, (unsigned long)t.tRCD, (unsigned long)t.tRP,
+                   (unsigned long)t.tRC, (unsigned long)t.tRAS, (unsigned long)t.tXSR, (unsigned long)t.tWR,
+                   (unsigned long)t.Refresh);
+        } else if (op[0] == 'D') {
+            if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 1;
+            printf("%u\n", SDRAM_PickDiv((uint32_t)a[0], (uint32_t)a[1], (uint8_t)a[2], (uint8_t)a[3]));
+        } else if (op[0] == 'T') {
+            if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != 6) return 1;
+            info.Base = (uint32_t)a[0];
+            info.Size = (uint32_t)a[1];
+            info.BankSize = (uint32_t)a[2];
+            info.RowSize = (uint32_t)a[3];
+            info.InBanks = (uint8_t)a[4];
+            info.Map = (uint8_t)a[5];
+            printf("%ld\n", (long)SDRAM_Attach(&info));
+        } else if (op[0] == 'N') {
+            printf("%ld\n", (long)SDRAM_Attach(NULL));
+        } else if (op[0] == 'A') {
+            if (scanf("%lu %lu", &a[0], &a[1]) != 2) return 1;
+            printf("%lu\n", (unsigned long)(uintptr_t)SDRAM_Alloc((uint32_t)a[0], (uint8_t)a[1]));
+        } else if (op[0] == 'F') {
+            SDRAM_FreeAll();
+        } else if (op[0] == 'B') {
+            if (scanf("%lu", &a[0]) != 1) return 1;
+            printf("%u\n", SDRAM_BankOf((const void *)(uintptr_t)a[0]));
+        } else {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def cycles(ns, hz):
+    return max((ns * hz + 999999999) // 1000000000, 1)
+
+
+def plan(inbanks, rows, ms, hz, ns):
+    if hz == 0 or inbanks not in (2, 4) or rows == 0:
+        return None
+    rcd, rp, rc, ras, xsr, wr = [cycles(v, hz) for v in ns]
+    if ras > rcd:
+        wr = max(wr, ras - rcd)
+    if rc > rcd + rp:
+        wr = max(wr, rc - rcd - rp)
+    return [rcd, rp, rc, ras, xsr, wr, ms * hz // 1000 // rows]
+
+
+def pick_div(inhz, maxhz, lo, hi):
+    for div in range(max(lo, 1), hi + 1):
+        if inhz // div <= maxhz:
+            return div
+    return 0
+
+
+class Geometry:
+    def __init__(self, base, col, row, width, inbanks, mp):
+        self.base = base
+        self.col_shift = col + {8: 0, 16: 1, 32: 2}[width]
+        self.row_bits = row
+        self.inbanks = inbanks
+        self.map = mp
+        self.row_size = 1 << self.col_shift
+        self.bank_size = self.row_size << row
+        self.size = self.bank_size * inbanks
+
+    def info(self):
+        return (self.base, self.size, self.bank_size, self.row_size, self.inbanks, self.map)
+
+    def bank_of(self, addr):
+        """按地址线模型: BRC 的 bank 位在行地址之上, RBC 的 bank 位紧接列地址"""
+        off = addr - self.base
+        if off < 0 or off >= self.size:
+            return BANK_ANY
+        if self.map == MAP_BRC:
+            return off >> (self.col_shift + self.row_bits)
+        return (off >> self.col_shift) & (self.inbanks - 1)
+
+
+class RefAlloc:
+    def __init__(self, g):
+        self.g = g
+        self.free_all()
+
+    def free_all(self):
+        self.used = [0] * 4
+        self.next = 0
+        self.count = [0] * 4
+
+    def alloc(self, nbytes, bank):
+        g = self.g
+        if nbytes == 0 or nbytes > g.size:
+            return 0
+        nbytes = (nbytes + ALIGN - 1) & ~(ALIGN - 1)
+        start = []
+        for i in range(g.inbanks):
+            if g.map == MAP_BRC:
+                s = i * g.bank_size + self.used[i]
+                if self.used[i] + nbytes > g.bank_size:
+                    s = None
+            else:
+                s = (self.next + g.row_size - 1) & ~(g.row_size - 1)
+                s += ((i - s // g.row_size) % g.inbanks) * g.row_size
+                if s > g.size - nbytes:
+                    s = None
+            start.append(s)
+        if bank == BANK_ANY:
+            fits = [i for i in range(g.inbanks) if start[i] is not None]
+            if not fits:
+                return 0
+            if g.map == MAP_BRC:
+                bank = min(fits, key=lambda i: (self.count[i], self.used[i], i))
+            else:
+                bank = min(fits, key=lambda i: (self.count[i], start[i], i))
+        if bank >= g.inbanks or start[bank] is None:
+            return 0
+        if g.map == MAP_BRC:
+            self.used[bank] += nbytes
+        else:
+            self.next = start[bank] + nbytes
+        self.count[bank] += 1
+        return g.base + start[bank]
+
+
+def gen_geometry(rnd):
+    col = rnd.randint(8, 11)
+    row = rnd.randint(11, 13)
+    width = rnd.choice((8, 16, 32))
+    inbanks = rnd.choice((2, 4))
+    # 256MB 以内, 基址按 16MB 对齐放在 0x80000000~0xD0000000
+    while (1 << col) * (width // 8) * (1 << row) * inbanks > (256 << 20):
+        row -= 1
+    base = rnd.choice((0x80000000, 0xC0000000, 0xD0000000))
+    return Geometry(base, col, row, width, inbanks, rnd.choice((MAP_BRC, MAP_RBC)))
+
+
+def gen_ops(rnd, g):
+    ops = []
+    for _ in range(rnd.randint(4, 60)):
+        k = rnd.random()
+        if k < 0.05:
+            ops.append(('F',))
+            continue
+        if k < 0.4:
+            nbytes = rnd.randint(1, 5000)
+        elif k < 0.8:
+            nbytes = rnd.choice((480 * 272 * 2, 800 * 480 * 2, 800 * 480 * 4, 1024 * 600 * 2))
+        elif k < 0.95:
+            nbytes = rnd.randint(1, g.bank_size)
+        else:
+            nbytes = rnd.choice((0, g.size, g.size + 1, 0xFFFFFFFF))
+        k = rnd.random()
+        if k < 0.5:
+            bank = BANK_ANY
+        elif k < 0.95:
+            bank = rnd.randrange(g.inbanks)
+        else:
+            bank = rnd.choice((g.inbanks, 4, 0xFE))
+        ops.append(('A', nbytes, bank))
+    return ops
+
+
+def run(exe, queries, args=()):
+    r = subprocess.run([exe] + list(args), input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d\n%s' % (r.returncode, r.stdout[-2000:]))
+    return r.stdout.splitlines()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=400, help='随机几何个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'sdram_plan_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        # 静态数组的地址要能放进 32 位的 SDRAM_Info.Base
+        cmd = [args.cc, '-std=c99', '-O1', '-g', '-Wall', '-Wextra', '-Werror', '-fsanitize=address',
+               '-fno-omit-frame-pointer', '-no-pie', '-fno-pie', '-I', ROOT, SOURCE, driver, '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        bad = 0
+
+        def fail(msg):
+            nonlocal bad
+            if bad < MAX_REPORT:
+                print(msg)
+            bad += 1
+
+        # 1. 时序换算
+        queries, expect = [], []
+        for _ in range(args.cases * 5):
+            inbanks = rnd.choice((2, 4, 4, 4, 3, 0))
+            rows = rnd.choice((4096, 8192, 8192, 0, 1))
+            ms = rnd.choice((32, 64, 64))
+            hz = rnd.choice((0, rnd.randint(1, 300000000), 100000000, 166000000, 84000000))
+            ns = [rnd.randint(0, 250) for _ in range(6)]
+            queries.append('P %d %d %d %d %s' % (inbanks, rows, ms, hz, ' '.join(map(str, ns))))
+            expect.append(plan(inbanks, rows, ms, hz, ns))
+        timing_cases = len(queries)
+        for q, e, line in zip(queries, expect, run(exe, queries)):
+            got = list(map(int, line.split()))
+            if e is None:
+                if got[0] != ERR_PARAM:
+                    fail('PlanTiming %s: 返回 %d, 应为 SDRAM_ERR_PARAM' % (q, got[0]))
+            elif got[0] != OK or got[1:] != e:
+                fail('PlanTiming %s: 得到 %s, 应为 %s' % (q, got, [OK] + e))
+
+        # 2. 分频
+        queries, expect = [], []
+        for _ in range(args.cases):
+            inhz = rnd.randint(1, 300000000)
+            maxhz = rnd.choice((rnd.randint(1, 300000000), 166000000, 100000000, inhz // 2, inhz // 3))
+            lo = rnd.choice((1, 2, 2))
+            hi = rnd.choice((lo, 2, 3, 4, 16))
+            queries.append('D %d %d %d %d' % (inhz, maxhz, lo, hi))
+            expect.append(pick_div(inhz, maxhz, lo, hi))
+        for q, e, line in zip(queries, expect, run(exe, queries)):
+            if int(line) != e:
+                fail('PickDiv %s: 得到 %s, 应为 %d' % (q, line, e))
+
+        # 3. 登记参数检查
+        good = Geometry(0xC0000000, 9, 13, 16, 4, MAP_BRC).info()
+        wrong = [
+            good[:4] + (3,) + good[5:],
+            good[:3] + (1000,) + good[4:],
+            good[:3] + (16,) + good[4:],
+            (good[0], 2048, 512, 1024, 2, MAP_BRC),
+            (good[0], good[1] * 2) + good[2:],
+            good[:2] + (good[2] + 512,) + good[3:],
+            good[:5] + (2,),
+        ]
+        queries = []
+        for w in wrong:
+            queries += ['T %d %d %d %d %d %d' % w, 'A 64 255']
+        queries += ['T %d %d %d %d %d %d' % good, 'A 64 255', 'N', 'A 64 255', 'B %d' % good[0]]
+        out = run(exe, queries)
+        for i, w in enumerate(wrong):
+            if out[2 * i] != str(ERR_PARAM) or out[2 * i + 1] != '0':
+                fail('Attach %s: 返回 %s, 之后分配得到 %s, 应为 %d 和 NULL' % (w, out[2 * i], out[2 * i + 1], ERR_PARAM))
+        tail = out[2 * len(wrong):]
+        if tail != [str(OK), str(good[0]), str(OK), '0', str(BANK_ANY)]:
+            fail('Attach 正确参数和 NULL: 得到 %s' % tail)
+
+        # 4. 分配器
+        allocs = 0
+        for no in range(args.cases):
+            g = gen_geometry(rnd)
+            ops = gen_ops(rnd, g)
+            queries = ['T %d %d %d %d %d %d' % g.info()]
+            for op in ops:
+                queries.append(' '.join(map(str, op)))
+            probes = [g.base - 1, g.base + g.size, g.base + g.size - 1] + \
+                     [g.base + rnd.randrange(g.size) for _ in range(20)]
+            queries += ['B %d' % p for p in probes]
+            out = iter(run(exe, queries))
+            tag = '几何 %d(%s, %s)' % (no, 'BRC' if g.map == MAP_BRC else 'RBC',
+                                       'col %d row %d bank %d' % (g.col_shift, g.row_bits, g.inbanks))
+            if next(out) != str(OK):
+                fail('%s: Attach 失败' % tag)
+                continue
+            ref = RefAlloc(g)
+            live = []
+            for op in ops:
+                if op[0] == 'F':
+                    ref.free_all()
+                    live = []
+                    continue
+                _, nbytes, bank = op
+                got = int(next(out))
+                exp = ref.alloc(nbytes, bank)
+                allocs += 1
+                if got != exp:
+                    fail('%s: Alloc(%d, %d) 得到 0x%X, 应为 0x%X' % (tag, nbytes, bank, got, exp))
+                    break
+                if got == 0:
+                    continue
+                size = (nbytes + ALIGN - 1) & ~(ALIGN - 1)
+                if got % ALIGN or got < g.base or got + size > g.base + g.size:
+                    fail('%s: 0x%X+%d 未对齐或越界' % (tag, got, size))
+                for a, s, b in live:
+                    if got < a + s and a < got + size:
+                        fail('%s: 0x%X+%d 与 0x%X+%d 重叠' % (tag, got, size, a, s))
+                want = g.bank_of(got)
+                if bank != BANK_ANY and want != bank:
+                    fail('%s: Alloc 到 bank %d, 地址 0x%X 在 bank %d' % (tag, bank, got, want))
+                if g.map == MAP_BRC and g.bank_of(got + size - 1) != want:
+                    fail('%s: 0x%X+%d 跨 bank' % (tag, got, size))
+                if g.map == MAP_RBC:
+                    if (got - g.base) % g.row_size:
+                        fail('%s: 0x%X 不在行段开头' % (tag, got))
+                    for a, s, b in live:
+                        if b == want:
+                            continue
+                        for k in (0, g.row_size - 1, g.row_size, rnd.randrange(min(s, size))):
+                            if k < min(s, size) and g.bank_of(a + k) == g.bank_of(got + k):
+                                fail('%s: 0x%X 与 0x%X 偏移 %d 处同 bank' % (tag, got, a, k))
+                live.append((got, size, want))
+            else:
+                for p in probes:
+                    got = int(next(out))
+                    if got != g.bank_of(p):
+                        fail('%s: BankOf(0x%X) = %d, 应为 %d' % (tag, p, got, g.bank_of(p)))
+
+        # 5. 带宽测试
+        try:
+            run(exe, [], ('bench',))
+            bench_ok = True
+        except RuntimeError as e:
+            fail('BenchRun: %s' % e)
+            bench_ok = False
+
+        print('时序 %d 组, 分频 %d 组, 几何 %d 个, 分配 %d 次, 带宽测试%s, 差异 %d 项' %
+              (timing_cases, args.cases, args.cases, allocs, '通过' if bench_ok else '失败', bad))
+        return 1 if bad else 0
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Common/wave_gen.c 的主机测试: 用主机编译器(开 AddressSanitizer)编译 wave_gen.c 和一个读标准输入的
+驱动, 结果与 Python 写的参考模型逐项比较.
+
+    wave_gen_test.py [--cc gcc] [--cases 400] [--seed 1]
+        1. Wave_PlanRate: 随机时钟、采样率和分频上限, 任意分频和 2 的幂分频两种定时器, 以及计数正好在
+           65536 * 分频附近的边界;
+           分频不超过上限且(2 的幂时)是 2 的幂, 周期 2~65536, 能放下时分频最小、周期四舍五入,
+           返回值 = 时钟 / (分频 * 周期);
+        2. Wave_GenSine: 与双精度参考相差不超过 1, 超出 0~4095 的部分削顶;
+        3. Wave_GenSaw / Wave_GenArbitrary / Wave_Pack: 与整数参考逐样本相同, 包括下降锯齿、
+           第一个断点之前和末点到首点的插值、相位相同的断点;
+        4. Wave_StreamStart / Wave_StreamDone: 随机的块完成序列, 回调收到的块地址和样本数、
+           欠载计数、块数和回调耗时与参考一致, 启动时清零(DacUnderruns 除外);
+           回调写满整块不越界(ASan 检查); 没有回调(表播放)时不调用 Playing, 统计不变.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 wave_gen.c 后运行一次.
+"""
+
+import argparse
+import math
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'wave_gen.c')
+FULL_SCALE = 4095
+MAX_PERIOD = 65536
+MAX_REPORT = 20
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wave_gen.h"
+
+static volatile uint32_t cycles;
+static uint32_t delta;
+static uint8_t playing;
+static uint32_t playing_calls;
+static uint8_t *base;
+static long last_off;
+static unsigned long last_samples;
+static uint32_t last_bytes;
+
+static uint8_t Playing(void) {
+    playing_calls++;
+    return playing;
+}
+
+static void Refill(void *Buf, uint32_t Samples) {
+    last_off = (long)((uint8_t *)Buf - base);
+    last_samples = Samples;
+    memset(Buf, 0xA5, (size_t)Samples * last_bytes);
+    cycles += delta;
+}
+
+static int stream(void) {
+    Wave_Stream s;
+    unsigned long samples, bytes, cb, n, done, play, d, i;
+
+    if (scanf("%lu %lu %lu %lu", &samples, &bytes, &cb, &n) != 4) return 1;
+    base = malloc(2 * samples * bytes);
+    last_bytes = (uint32_t)bytes;
+    last_off = -1;
+    memset(&s, 0x5A, sizeof(s));
+    s.Stats.DacUnderruns = 7;
+    delta = 3;
+    Wave_StreamStart(&s, base, (uint32_t)samples, (uint32_t)bytes, cb ? Refill : 0);
+    printf("%ld %lu %lu\n", last_off, last_samples, (unsigned long)s.Stats.DacUnderruns);
+    playing_calls = 0;
+    for (i = 0; i < n; i++) {
+        if (scanf("%lu %lu %lu", &done, &play, &d) != 3) return 1;
+        delta = (uint32_t)d;
+        playing = (uint8_t)play;
+        last_off = -1;
+        last_samples = 0;
+        Wave_StreamDone(&s, (uint8_t)done, Playing, &cycles);
+        printf("%ld %lu %lu %lu %lu %lu %lu\n", last_off, last_samples, (unsigned long)s.Stats.Underruns,
+               (unsigned long)s.Stats.Blocks, (unsigned long)s.Stats.LastCycles,
+               (unsigned long)s.Stats.MaxCycles, (unsigned long)playing_calls);
+    }
+    free(base);
+    return 0;
+}
+
+static void print_table(const uint16_t *t, unsigned long n) {
+    unsigned long i;
+
+    for (i = 0; i < n; i++) printf("%u%c", t[i], i + 1 < n ? ' ' : '\n');
+    if (n == 0) printf("\n");
+}
+
+int main(void) {
+    char op[4];
+    unsigned long a[6], i;
+    uint32_t div, period, ret;
+    uint16_t *t, *t2;
+    uint32_t *dual;
+    Wave_Point *pts;
+
+    while (scanf("%3s", op) == 1) {
+        if (op[0] == 'R') {
+            if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 1;
+            ret = Wave_PlanRate((uint32_t)a[0], (uint32_t)a[1], (uint32_t)a[2], (uint8_t)a[3], &div, &period);
+            printf("%lu %lu %lu\n", (unsigned long)ret, (unsigned long)div, (unsigned long)period);
+        } else if (op[0] == 'S') {
+            if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 1;
+            t = malloc(a[0] * sizeof(uint16_t));
+            Wave_GenSine(t, (uint32_t)a[0], (uint16_t)a[1], (uint16_t)a[2], (uint16_t)a[3]);
+            print_table(t, a[0]);
+            free(t);
+        } else if (op[0] == 'W') {
+            if (scanf("%lu %lu %lu", &a[0], &a[1], &a[2]) != 3) return 1;
+            t = malloc(a[0] * sizeof(uint16_t));
+            Wave_GenSaw(t, (uint32_t)a[0], (uint16_t)a[1], (uint16_t)a[2]);
+            print_table(t, a[0]);
+            free(t);
+        } else if (op[0] == 'A') {
+            if (scanf("%lu %lu", &a[0], &a[1]) != 2) return 1;
+            pts = malloc((a[1] + 1) * sizeof(Wave_Point));
+            for (i = 0; i < a[1]; i++) {
+                if (scanf("%lu %lu", &a[2], &a[3]) != 2) return 1;
+                pts[i].Phase = (uint16_t)a[2];
+                pts[i].Value = (uint16_t)a[3];
+            }
+            t = malloc(a[0] * sizeof(uint16_t));
+            Wave_GenArbitrary(t, (uint32_t)a[0], pts, (uint32_t)a[1]);
+            print_table(t, a[0]);
+            free(t);
+            free(pts);
+        } else if (op[0] == 'K') {
+            if (scanf("%lu", &a[0]) != 1) return 1;
+            t = malloc(a[0] * sizeof(uint16_t));
+            t2 = malloc(a[0] * sizeof(uint16_t));
+            dual = malloc(a[0] * sizeof(uint32_t));
+            for (i = 0; i < 2 * a[0]; i++) {
+                if (scanf("%lu", &a[1]) != 1) return 1;
+                (i < a[0] ? t : t2)[i % a[0]] = (uint16_t)a[1];
+            }
+            Wave_Pack(dual, t, t2, (uint32_t)a[0]);
+            for (i = 0; i < a[0]; i++) printf("%lu%c", (unsigned long)dual[i], i + 1 < a[0] ? ' ' : '\n');
+            free(t);
+            free(t2);
+            free(dual);
+        } else if (op[0] == 'T') {
+            if (stream() != 0) return 1;
+        } else {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def plan_rate(clock, rate, divmax, pow2):
+    rate = rate or 1
+    divmax = divmax or 1
+    ticks = max((clock + rate // 2) // rate, 2)
+    if pow2:
+        div = 1
+        while div < divmax and (ticks - 1) // div >= MAX_PERIOD:
+            div <<= 1
+    else:
+        div = min((ticks - 1) // MAX_PERIOD + 1, divmax)
+    period = min(max((ticks + div // 2) // div, 2), MAX_PERIOD)
+    return clock // (div * period), div, period
+
+
+def cdiv(a, b):
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def sine(n, amp, off, phase):
+    out = []
+    for i in range(n):
+        v = off + amp * math.sin(2 * math.pi * (i / n + phase / 65536))
+        out.append(int(min(max(v, 0.0), FULL_SCALE) + 0.5))
+    return out
+
+
+def saw(n, low, high):
+    return [low + cdiv((high - low) * i, n) for i in range(n)]
+
+
+def arbitrary(n, pts):
+    out = []
+    for i in range(n):
+        ph = (i << 16) // n
+        k = 0
+        while k + 1 < len(pts) and pts[k + 1][0] <= ph:
+            k += 1
+        if ph < pts[0][0]:
+            x0, y0 = pts[-1]
+            x1, y1 = pts[0][0] + 65536, pts[0][1]
+            ph += 65536
+        elif k + 1 < len(pts):
+            (x0, y0), (x1, y1) = pts[k], pts[k + 1]
+        else:
+            x0, y0 = pts[k]
+            x1, y1 = pts[0][0] + 65536, pts[0][1]
+        out.append(y0 if x1 == x0 else y0 + cdiv((y1 - y0) * (ph - x0), x1 - x0))
+    return out
+
+
+def run(exe, queries):
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE,
+                       stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        raise RuntimeError('驱动异常退出: 返回 %d\n%s' % (r.returncode, r.stdout[-2000:]))
+    return r.stdout.splitlines()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--cases', type=int, default=400, help='每项随机用例个数')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    rnd = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        driver = os.path.join(tmp, 'driver.c')
+        exe = os.path.join(tmp, 'wave_gen_test')
+        with open(driver, 'w') as f:
+            f.write(DRIVER)
+        cmd = [args.cc, '-std=c99', '-O1', '-g', '-Wall', '-Wextra', '-Werror', '-fsanitize=address',
+               '-fno-omit-frame-pointer', '-no-pie', '-fno-pie', '-I', ROOT, SOURCE, driver, '-o', exe, '-lm']
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return 1
+
+        bad = 0
+
+        def fail(msg):
+            nonlocal bad
+            if bad < MAX_REPORT:
+                print(msg)
+            bad += 1
+
+        # 1. 采样率
+        queries = []
+        for _ in range(args.cases * 5):
+            clock = rnd.choice((rnd.randint(1, 300000000), 84000000, 120000000, 200000000, 0, 1))
+            rate = rnd.choice((rnd.randint(1, 2000000), rnd.randint(1, 100), 8000, 44100, 48000,
+                               clock // 2, clock + 1, 0))
+            pow2 = rnd.randint(0, 1)
+            divmax = rnd.choice((1024, 1, 2, 64)) if pow2 else rnd.choice((65536, 1, 7, 300))
+            queries.append((clock, rate, divmax, pow2))
+        # 计数正好在 65536 * 分频附近, 检查分频的边界
+        for _ in range(args.cases):
+            rate = rnd.randint(1, 2000)
+            ticks = MAX_PERIOD * rnd.choice((1, 2, 3, 4, 8, 16)) + rnd.choice((-1, 0, 1, 2))
+            pow2 = rnd.randint(0, 1)
+            queries.append((rate * ticks, rate, 1024 if pow2 else 65536, pow2))
+        for q, line in zip(queries, run(exe, ['R %d %d %d %d' % q for q in queries])):
+            got = tuple(map(int, line.split()))
+            exp = plan_rate(*q)
+            clock, rate, divmax, pow2 = q
+            _, div, period = got
+            if got != exp:
+                fail('PlanRate%s: 得到 %s, 应为 %s' % (q, got, exp))
+            elif div < 1 or div > divmax or (pow2 and div & (div - 1)) or not 2 <= period <= MAX_PERIOD:
+                fail('PlanRate%s: 分频 %d 周期 %d 超出范围' % (q, div, period))
+            elif got[0] != clock // (div * period):
+                fail('PlanRate%s: 返回 %d 与分频周期不符' % (q, got[0]))
+        rate_cases = len(queries)
+
+        # 2/3. 波形表
+        queries, expect = [], []
+        for _ in range(args.cases):
+            n = rnd.choice((1, 2, 3, rnd.randint(4, 64), rnd.randint(64, 1024), 4096))
+            queries.append('S %d %d %d %d' % (n, rnd.choice((0, 2047, 2048, rnd.randint(0, 4095), 65535)),
+                                              rnd.choice((0, 2048, 4095, rnd.randint(0, 4095))),
+                                              rnd.randint(0, 65535)))
+            expect.append(('S', n))
+            low, high = rnd.randint(0, 4095), rnd.randint(0, 4095)
+            queries.append('W %d %d %d' % (n, low, high))
+            expect.append(saw(n, low, high))
+            k = rnd.choice((1, 2, rnd.randint(3, 12)))
+            phases = sorted(rnd.choice((0, 0, 65535, rnd.randint(0, 65535))) if rnd.random() < 0.2
+                            else rnd.randint(0, 65535) for _ in range(k))
+            pts = [(p, rnd.randint(0, 4095)) for p in phases]
+            queries.append('A %d %d %s' % (n, k, ' '.join('%d %d' % p for p in pts)))
+            expect.append(arbitrary(n, pts))
+            ch0 = [rnd.randint(0, 65535) for _ in range(n)]
+            ch1 = [rnd.randint(0, 65535) for _ in range(n)]
+            queries.append('K %d %s %s' % (n, ' '.join(map(str, ch0)), ' '.join(map(str, ch1))))
+            expect.append([a | (b << 16) for a, b in zip(ch0, ch1)])
+        for q, e, line in zip(queries, expect, run(exe, queries)):
+            got = list(map(int, line.split()))
+            tag = q if len(q) < 60 else q[:60] + '...'
+            if isinstance(e, tuple):
+                n, amp, off, phase = map(int, q.split()[1:])
+                e = sine(n, amp, off, phase)
+                diff = [i for i in range(n) if abs(got[i] - e[i]) > 1 or not 0 <= got[i] <= FULL_SCALE]
+                if len(got) != n or diff:
+                    fail('%s: 样本 %s 得到 %s, 应为 %s' % (tag, diff[:3], [got[i] for i in diff[:3]],
+                                                       [e[i] for i in diff[:3]]))
+            elif got != e:
+                i = next((i for i in range(min(len(got), len(e))) if got[i] != e[i]), min(len(got), len(e)))
+                fail('%s: 样本 %d 得到 %s, 应为 %s' % (tag, i, got[i:i + 3], e[i:i + 3]))
+        table_cases = len(queries)
+
+        # 4. 流播放
+        blocks = 0
+        for _ in range(args.cases):
+            samples = rnd.choice((1, 2, rnd.randint(3, 512)))
+            nbytes = rnd.choice((2, 4))
+            cb = 0 if rnd.random() < 0.1 else 1
+            events = [(rnd.randint(0, 1), rnd.randint(0, 1), rnd.choice((0, 1, rnd.randint(0, 100000))))
+                      for _ in range(rnd.randint(0, 40))]
+            q = 'T %d %d %d %d %s' % (samples, nbytes, cb, len(events), ' '.join('%d %d %d' % e for e in events))
+            tag = 'Stream(%d, %d, cb %d)' % (samples, nbytes, cb)
+            try:
+                out = run(exe, [q])
+            except RuntimeError as e:
+                fail('%s: %s' % (tag, e))
+                continue
+            block = samples * nbytes
+            start = '%d %d 7' % (block, samples) if cb else '-1 0 7'
+            if out[0] != start:
+                fail('%s: 启动后 %s, 应为 %s(最后填第 1 块, DacUnderruns 不清零)' % (tag, out[0], start))
+            under = count = last = peak = calls = 0
+            for i, (done, play, d) in enumerate(events):
+                if cb:
+                    calls += 1
+                    under += play == done
+                    count += 1
+                    last = d
+                    peak = max(peak, d)
+                    exp = [done * block, samples, under, count, last, peak, calls]
+                else:
+                    exp = [-1, 0, 0, 0, 0, 0, 0]
+                got = list(map(int, out[i + 1].split()))
+                if got != exp:
+                    fail('%s: 第 %d 块 done %d playing %d: 得到 %s, 应为 %s' % (tag, i, done, play, got, exp))
+                    break
+                blocks += 1
+
+        print('采样率 %d 组, 波形表 %d 张, 流播放 %d 组 %d 块, 差异 %d 项' %
+              (rate_cases, table_cases, args.cases, blocks, bad))
+        return 1 if bad else 0
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
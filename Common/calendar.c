@@ -0,0 +1,173 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : calendar.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 日历与秒计数互换
+                   1. 2000~2099 每 4 年一闰(2000 年为闰年), 年首天数 = 365 * 年 + (年 + 3) / 4, 除 4 用移位;
+                   2. 月首天数、BCD 码都查表; 非法 BCD 码查表得 0xFF, 随后的范围检查一并剔除;
+                   3. 反向换算中的除法(86400/3600/60/1461/7)都换成乘以倒数再移位, 倒数取上舍入,
+                      常数由 Common/Tools/calendar_test.py 校验在整个取值范围内与真实除法相同;
+                   4. 年内天数换月: 月首天数不超过 31 * 月序号, 月序号至少为 天数 / 32,
+                      至多再进一位, 一次比较即可.
+  * Function List:
+
+  **********************************************************
+ */
+#include "calendar.h"
+
+#define CAL_SEC_PER_DAY         86400UL
+#define CAL_DAY_PER_4YEAR       1461UL
+
+/* x / d = (x * M) >> S, 取值范围内精确 */
+#define CAL_DIV86400_M          3257812231ULL   //x < 2^32
+#define CAL_DIV86400_S          48
+#define CAL_DIV3600_M           37283UL         //x < 86400
+#define CAL_DIV3600_S           27
+#define CAL_DIV60_M             2185UL          //x < 3600
+#define CAL_DIV60_S             17
+#define CAL_DIV1461_M           22967UL         //x < 36525
+#define CAL_DIV1461_S           25
+#define CAL_DIV7_M              18725UL         //x < 36532
+#define CAL_DIV7_S              17
+
+#define CAL_WEEKDAY_BASE        6               //2000-01-01 为星期六
+
+static const uint8_t cal_bcd2dec[256] = {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     10,  11,  12,  13,  14,  15,  16,  17,  18,  19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     20,  21,  22,  23,  24,  25,  26,  27,  28,  29, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     30,  31,  32,  33,  34,  35,  36,  37,  38,  39, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     40,  41,  42,  43,  44,  45,  46,  47,  48,  49, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     50,  51,  52,  53,  54,  55,  56,  57,  58,  59, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     60,  61,  62,  63,  64,  65,  66,  67,  68,  69, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     70,  71,  72,  73,  74,  75,  76,  77,  78,  79, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     80,  81,  82,  83,  84,  85,  86,  87,  88,  89, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+     90,  91,  92,  93,  94,  95,  96,  97,  98,  99, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+/* 月首在年内的天数, 第 13 项为全年天数; [0] 平年, [1] 闰年 */
+static const uint16_t cal_month_start[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366},
+};
+
+/* 4 年周期内各年年首的天数, 周期首年为闰年 */
+static const uint16_t cal_cycle_start[4] = {0, 366, 731, 1096};
+
+/**
+  * @Name    Cal_Bcd2Dec
+  * @brief   BCD 码转十进制
+  * @param   Bcd: BCD 码
+  * @retval  0~99; 非法 BCD 码返回 CAL_BCD_INVD
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t Cal_Bcd2Dec(uint8_t Bcd) {
+    return cal_bcd2dec[Bcd];
+}
+
+/**
+  * @Name    Cal_ToEpoch
+  * @brief   日历转秒计数
+  * @param   Format: CAL_FMT_DEC / CAL_FMT_BCD
+  * @param   Dt: 日期时间, 不使用 Weekday
+  * @retval  2000-01-01 00:00:00 起的秒数; 字段超出范围返回 CAL_EPOCH_INVD
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Cal_ToEpoch(uint8_t Format, const Cal_DateTime *Dt) {
+    uint32_t year, month, day, hour, minute, second, days;
+    const uint16_t *start;
+
+    if(Dt == 0) return CAL_EPOCH_INVD;
+
+    if(Format == CAL_FMT_BCD) {
+        year = cal_bcd2dec[Dt->Year];
+        month = cal_bcd2dec[Dt->Month];
+        day = cal_bcd2dec[Dt->Day];
+        hour = cal_bcd2dec[Dt->Hour];
+        minute = cal_bcd2dec[Dt->Minute];
+        second = cal_bcd2dec[Dt->Second];
+    } else {
+        year = Dt->Year;
+        month = Dt->Month;
+        day = Dt->Day;
+        hour = Dt->Hour;
+        minute = Dt->Minute;
+        second = Dt->Second;
+    }
+
+    if(year > 99 || month - 1 >= 12 || hour > 23 || minute > 59 || second > 59) return CAL_EPOCH_INVD;
+
+    start = cal_month_start[(year & 3) == 0];
+
+    if(day == 0 || day > (uint32_t)start[month] - start[month - 1]) return CAL_EPOCH_INVD;
+
+    days = 365 * year + ((year + 3) >> 2) + start[month - 1] + day - 1;
+
+    return days * CAL_SEC_PER_DAY + hour * 3600 + minute * 60 + second;
+}
+
+/**
+  * @Name    Cal_FromEpoch
+  * @brief   秒计数转日历
+  * @param   Epoch: 2000-01-01 00:00:00 起的秒数, 大于 CAL_EPOCH_MAX 时按 CAL_EPOCH_MAX
+  * @param   Dt: 输出十进制日期时间, 含星期
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Cal_FromEpoch(uint32_t Epoch, Cal_DateTime *Dt) {
+    uint32_t days, rem, cycle, year, hour, minute, month;
+    const uint16_t *start;
+
+    if(Dt == 0) return;
+
+    if(Epoch > CAL_EPOCH_MAX) Epoch = CAL_EPOCH_MAX;
+
+    days = (uint32_t)(((uint64_t)Epoch * CAL_DIV86400_M) >> CAL_DIV86400_S);
+    rem = Epoch - days * CAL_SEC_PER_DAY;
+
+    hour = (rem * CAL_DIV3600_M) >> CAL_DIV3600_S;
+    rem -= hour * 3600;
+    minute = (rem * CAL_DIV60_M) >> CAL_DIV60_S;
+    Dt->Hour = hour;
+    Dt->Minute = minute;
+    Dt->Second = rem - minute * 60;
+
+    rem = days + CAL_WEEKDAY_BASE;
+    Dt->Weekday = rem - ((rem * CAL_DIV7_M) >> CAL_DIV7_S) * 7;
+
+    cycle = (days * CAL_DIV1461_M) >> CAL_DIV1461_S;
+    rem = days - cycle * CAL_DAY_PER_4YEAR;
+
+    for(year = 3; rem < cal_cycle_start[year]; year--);
+
+    rem -= cal_cycle_start[year];
+    start = cal_month_start[year == 0];
+
+    month = rem >> 5;
+    if(month < 11 && rem >= start[month + 1]) month++;
+
+    Dt->Year = (cycle << 2) + year;
+    Dt->Month = month + 1;
+    Dt->Day = rem - start[month] + 1;
+}
@@ -0,0 +1,53 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : calendar.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 日历与秒计数互换
+                   秒计数从 2000-01-01 00:00:00 起, 范围与 RTC 年字段一致(2000~2099), 32 位不溢出.
+                   只用查表、移位和乘法, 不做除法; 只依赖 stdint.h, 不访问寄存器, STM32/HC32 模板的
+                   rtc_epoch.c 共用, 由 Common/Tools/calendar_test.py 对照 Python datetime 逐日检查.
+  * Function List:
+                   Cal_Bcd2Dec
+                   Cal_ToEpoch
+                   Cal_FromEpoch
+  ******************************************************
+**/
+
+#ifndef __CALENDAR_H_
+#define __CALENDAR_H_
+
+#include <stdint.h>
+
+#define CAL_YEAR_BASE           2000
+#define CAL_UNIX_OFFSET         946684800UL     //2000-01-01 00:00:00 的 Unix 时间
+#define CAL_EPOCH_MAX           3155759999UL    //2099-12-31 23:59:59
+#define CAL_EPOCH_INVD          0xFFFFFFFFUL    //字段超出范围
+#define CAL_BCD_INVD            0xFF
+
+/* 字段格式 */
+#define CAL_FMT_DEC             0
+#define CAL_FMT_BCD             1               //与 RTC 寄存器相同的 BCD 码
+
+typedef struct {
+    uint8_t Year;               //0~99, 即 2000~2099
+    uint8_t Month;              //1~12
+    uint8_t Day;                //1~31
+    uint8_t Weekday;            //0~6, 0 为星期日(同 HC32 的 RTC_WEEKDAY_SUNDAY, STM32 的 RTC_Weekday_Sunday 为 7); Cal_ToEpoch 不检查
+    uint8_t Hour;               //0~23
+    uint8_t Minute;
+    uint8_t Second;
+} Cal_DateTime;
+
+uint8_t Cal_Bcd2Dec(uint8_t Bcd);
+uint32_t Cal_ToEpoch(uint8_t Format, const Cal_DateTime *Dt);
+void Cal_FromEpoch(uint32_t Epoch, Cal_DateTime *Dt);
+
+#endif
@@ -0,0 +1,277 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 过滤器组编译器
+                   1. 每个区间按对齐的 2^k 块拆成 (值, 掩码) 条目;
+                   2. 同类别条目反复合并: 被包含的删除, 掩码相同且只差一位的合并成一条;
+                   3. 按 FIFO 装箱: 标准帧单 ID 用 16 位列表(4 个/组), 标准帧掩码用
+                      16 位掩码(2 个/组), 扩展帧单 ID 用 32 位列表(2 个/组),
+                      扩展帧掩码用 32 位掩码(1 个/组), 空位重复最后一个条目.
+                   编译结果只接收数据帧, 与规则表完全等价, 不会多收.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_filter.h"
+
+#define CANFILTER_STD_FULL      0x7FFU
+#define CANFILTER_EXT_FULL      0x1FFFFFFFU
+
+typedef struct {
+    uint32_t Value;
+    uint32_t Mask;
+    uint8_t  Ext;
+    uint8_t  Class;
+} CANFilter_Entry;
+
+const CANFilter_Table CANFilter_AcceptAll = {
+    1,
+    {{0, 0, CANFILTER_MODE_MASK, CANFILTER_SCALE_32BIT, 0}},
+    {1, 0},
+    {{0}}
+};
+
+static CANFilter_Entry cf_entry[CANFILTER_MAX_ENTRIES];
+static uint32_t cf_count;
+
+/**
+  * @Name    CANFilter_AddRange
+  * @brief   把一个闭区间拆成对齐的 2^k 块
+  * @param   Low/High: 区间
+  * @param   Ext: 0 标准帧, 1 扩展帧
+  * @param   Class: 类别
+  * @retval  CANFILTER_OK / CANFILTER_ERR_ENTRIES
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static int32_t CANFilter_AddRange(uint32_t Low, uint32_t High, uint8_t Ext, uint8_t Class) {
+    uint32_t full = Ext ? CANFILTER_EXT_FULL : CANFILTER_STD_FULL;
+    uint32_t size;
+
+    while(1) {
+        size = Low ? (Low & (~Low + 1)) : (full + 1);
+
+        while(Low + size - 1 > High) size >>= 1;
+
+        if(cf_count >= CANFILTER_MAX_ENTRIES) return CANFILTER_ERR_ENTRIES;
+
+        cf_entry[cf_count].Value = Low;
+        cf_entry[cf_count].Mask = full & ~(size - 1);
+        cf_entry[cf_count].Ext = Ext;
+        cf_entry[cf_count].Class = Class;
+        cf_count++;
+
+        if(Low + size - 1 == High) break;
+
+        Low += size;
+    }
+
+    return CANFILTER_OK;
+}
+
+/**
+  * @Name    CANFilter_Covers
+  * @brief   条目 A 是否包含条目 B
+  * @param   A/B: 条目
+  * @retval  1: 包含; 0: 不包含
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint8_t CANFilter_Covers(const CANFilter_Entry *A, const CANFilter_Entry *B) {
+    return (uint8_t)((B->Mask & A->Mask) == A->Mask && (B->Value & A->Mask) == A->Value);
+}
+
+/**
+  * @Name    CANFilter_Merge
+  * @brief   同类别条目去包含、按单个位合并, 直到不再变化
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只在掩码相同且值只差一个关心位时合并, 合并结果恰好等于两者之并,
+          因此不会接收规则之外的 ID.
+ **/
+static void CANFilter_Merge(void) {
+    uint8_t changed = 1;
+    uint32_t i, j, diff;
+
+    while(changed) {
+        changed = 0;
+
+        for(i = 0; i < cf_count; i++) {
+            for(j = i + 1; j < cf_count; j++) {
+                CANFilter_Entry *a = &cf_entry[i];
+                CANFilter_Entry *b = &cf_entry[j];
+
+                if(a->Ext != b->Ext || a->Class != b->Class) continue;
+
+                if(CANFilter_Covers(b, a)) *a = *b;
+                else if(!CANFilter_Covers(a, b)) {
+                    if(a->Mask != b->Mask) continue;
+
+                    diff = a->Value ^ b->Value;
+
+                    if(diff & (diff - 1)) continue;
+
+                    a->Mask &= ~diff;
+                    a->Value &= a->Mask;
+                }
+
+                cf_entry[j] = cf_entry[--cf_count];
+                j = i;
+                changed = 1;
+            }
+        }
+    }
+}
+
+/**
+  * @Name    CANFilter_Pack
+  * @brief   把某个 FIFO 的某一类条目装入过滤器组
+  * @param   Table: 输出表
+  * @param   FIFO: 0 或 1
+  * @param   Ext: 0 标准帧, 1 扩展帧
+  * @param   Exact: 1 单 ID(列表模式), 0 掩码模式
+  * @param   MaxBanks: 组数上限
+  * @retval  CANFILTER_OK / CANFILTER_ERR_BANKS
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static int32_t CANFilter_Pack(CANFilter_Table *Table, uint8_t FIFO, uint8_t Ext, uint8_t Exact, uint8_t MaxBanks) {
+    uint32_t full = Ext ? CANFILTER_EXT_FULL : CANFILTER_STD_FULL;
+    uint32_t slot[4];
+    uint32_t extMask = 0;
+    uint8_t cls[4];
+    uint8_t perBank = (uint8_t)(Ext ? (Exact ? 2 : 1) : (Exact ? 4 : 2));
+    uint8_t n = 0;
+    uint8_t k;
+    uint32_t i;
+    CANFilter_Bank *bank;
+
+    for(i = 0; i <= cf_count; i++) {
+        if(i < cf_count) {
+            const CANFilter_Entry *e = &cf_entry[i];
+
+            if(e->Ext != Ext || (e->Class != 0) != FIFO || (e->Mask == full) != Exact) continue;
+
+            /* 16 位: STID[10:0] RTR IDE EXID[17:15]; 32 位: EXID[28:0] IDE RTR 0.
+               掩码里 RTR 和 IDE 都要求匹配, 只接收数据帧 */
+            if(Ext) {
+                slot[n] = (e->Value << 3) | 0x4;
+                extMask = (e->Mask << 3) | 0x6;
+            } else if(Exact) {
+                slot[n] = e->Value << 5;
+            } else {
+                slot[n] = (((e->Mask << 5) | 0x18) << 16) | (e->Value << 5);
+            }
+
+            cls[n] = e->Class;
+            n++;
+
+            if(n < perBank) continue;
+        }
+
+        if(n == 0) break;
+
+        /* 空位重复最后一个条目 */
+        for(k = n; k < perBank; k++) {
+            slot[k] = slot[n - 1];
+            cls[k] = cls[n - 1];
+        }
+
+        if(Table->NumBanks >= MaxBanks) return CANFILTER_ERR_BANKS;
+
+        bank = &Table->Bank[Table->NumBanks++];
+        bank->FIFO = FIFO;
+        bank->Mode = Exact ? CANFILTER_MODE_LIST : CANFILTER_MODE_MASK;
+        bank->Scale = Ext ? CANFILTER_SCALE_32BIT : CANFILTER_SCALE_16BIT;
+
+        if(perBank == 4) {
+            bank->FR1 = (slot[1] << 16) | slot[0];
+            bank->FR2 = (slot[3] << 16) | slot[2];
+        } else if(perBank == 2) {
+            bank->FR1 = slot[0];
+            bank->FR2 = slot[1];
+        } else {
+            bank->FR1 = slot[0];
+            bank->FR2 = extMask;
+        }
+
+        for(k = 0; k < perBank; k++) {
+            Table->FMIClass[FIFO][Table->NumFMI[FIFO]++] = cls[k];
+        }
+
+        n = 0;
+    }
+
+    return CANFILTER_OK;
+}
+
+/**
+  * @Name    CANFilter_Compile
+  * @brief   编译接收规则
+  * @param   Rules: 规则表
+  * @param   NumRules: 规则数
+  * @param   MaxBanks: 可用的过滤器组数, 例如两个 CAN 按复位值平分 28 组时为 14
+  * @param   Table: 输出
+  * @retval  CANFILTER_OK 或错误码
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器编号 FMI 在每个 FIFO 内按组顺序连续编号, 类别 0 的条目放 FIFO0,
+          其它类别放 FIFO1, 接收中断中用 FMIClass 把 FMI 映射回类别.
+ **/
+int32_t CANFilter_Compile(const CANFilter_Rule *Rules, uint32_t NumRules, uint8_t MaxBanks,
+                          CANFilter_Table *Table) {
+    uint32_t i;
+    int32_t ret;
+    uint8_t fifo;
+
+    cf_count = 0;
+    Table->NumBanks = 0;
+    Table->NumFMI[0] = 0;
+    Table->NumFMI[1] = 0;
+
+    if(MaxBanks > CANFILTER_MAX_BANKS) MaxBanks = CANFILTER_MAX_BANKS;
+
+    for(i = 0; i < NumRules; i++) {
+        const CANFilter_Rule *r = &Rules[i];
+        uint32_t full = r->Ext ? CANFILTER_EXT_FULL : CANFILTER_STD_FULL;
+
+        if(r->IdLow > r->IdHigh || r->IdHigh > full || r->Class >= CANFILTER_MAX_CLASS) {
+            return CANFILTER_ERR_RULE;
+        }
+
+        ret = CANFilter_AddRange(r->IdLow, r->IdHigh, r->Ext, r->Class);
+
+        if(ret != CANFILTER_OK) return ret;
+    }
+
+    CANFilter_Merge();
+
+    for(fifo = 0; fifo < 2; fifo++) {
+        if((ret = CANFilter_Pack(Table, fifo, 0, 1, MaxBanks)) != CANFILTER_OK) return ret;
+
+        if((ret = CANFilter_Pack(Table, fifo, 0, 0, MaxBanks)) != CANFILTER_OK) return ret;
+
+        if((ret = CANFilter_Pack(Table, fifo, 1, 1, MaxBanks)) != CANFILTER_OK) return ret;
+
+        if((ret = CANFilter_Pack(Table, fifo, 1, 0, MaxBanks)) != CANFILTER_OK) return ret;
+    }
+
+    return CANFILTER_OK;
+}
@@ -0,0 +1,78 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 过滤器组编译器
+                   把"接收哪些 ID/ID 区间"的规则表编译成最少的 bxCAN 过滤器组,
+                   只依赖 stdint.h, 不访问寄存器, STM32/GD32/AT32 模板共用.
+                   bxCAN 与 GD32 CAN、AT32 CAN 的过滤器组格式相同, 各模板的
+                   can_filter_hw.c 只负责把编译结果写入本系列的寄存器.
+                   由 Common/Tools/can_filter_test.py 在主机上按过滤器硬件模型逐 ID 检查.
+  * Function List:
+                   CANFilter_Compile
+  ******************************************************
+**/
+
+#ifndef __CAN_FILTER_H_
+#define __CAN_FILTER_H_
+
+#include <stdint.h>
+
+#define CANFILTER_MAX_BANKS     28      //过滤器组总数(STM32/GD32 两个 CAN 共用, AT32 每个 CAN 各有)
+#define CANFILTER_MAX_ENTRIES   128     //区间展开后的中间条目上限
+#define CANFILTER_MAX_FMI       (CANFILTER_MAX_BANKS * 4)
+#define CANFILTER_MAX_CLASS     4       //优先级类别数
+
+/* 与模式寄存器、位宽寄存器中对应位的取值一致 */
+#define CANFILTER_MODE_MASK     0
+#define CANFILTER_MODE_LIST     1
+#define CANFILTER_SCALE_16BIT   0
+#define CANFILTER_SCALE_32BIT   1
+
+/* 错误码 */
+#define CANFILTER_OK            0
+#define CANFILTER_ERR_RULE      (-1)    //规则非法(ID 超范围、区间颠倒、类别越界)
+#define CANFILTER_ERR_ENTRIES   (-2)    //区间展开后条目过多
+#define CANFILTER_ERR_BANKS     (-3)    //需要的过滤器组超过 MaxBanks
+
+/* 一条接收规则: [IdLow, IdHigh] 闭区间, 单个 ID 时两者相等 */
+typedef struct {
+    uint32_t IdLow;
+    uint32_t IdHigh;
+    uint8_t  Ext;               //0: 标准帧 11 位, 1: 扩展帧 29 位
+    uint8_t  Class;             //优先级类别 0~CANFILTER_MAX_CLASS-1, 0 最高, 使用 FIFO0
+} CANFilter_Rule;
+
+/* 一个编译好的过滤器组, FR1/FR2 可直接写入 sFilterRegister[].FR1/FR2(STM32)、
+   CAN_FDATA0/1(GD32) 或 ffb[].ffdb1/ffdb2(AT32) */
+typedef struct {
+    uint32_t FR1;
+    uint32_t FR2;
+    uint8_t  Mode;              //CANFILTER_MODE_xxx
+    uint8_t  Scale;             //CANFILTER_SCALE_xxx
+    uint8_t  FIFO;              //0 或 1
+} CANFilter_Bank;
+
+/* 编译结果 */
+typedef struct {
+    uint8_t NumBanks;
+    CANFilter_Bank Bank[CANFILTER_MAX_BANKS];
+    uint8_t NumFMI[2];                          //每个 FIFO 占用的过滤器编号数
+    uint8_t FMIClass[2][CANFILTER_MAX_FMI];     //FIFO 内过滤器编号(从本表第一组算起) -> 类别
+} CANFilter_Table;
+
+/* 一组 32 位掩码全 0, 接收全部帧到 FIFO0 类别 0, CANBus_Init 的 Table 为 NULL 时使用 */
+extern const CANFilter_Table CANFilter_AcceptAll;
+
+int32_t CANFilter_Compile(const CANFilter_Rule *Rules, uint32_t NumRules, uint8_t MaxBanks,
+                          CANFilter_Table *Table);
+
+#endif
@@ -0,0 +1,351 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_queue.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 收发队列
+                   1. 接收中断一次把硬件 FIFO(3 级)读空, 按 FMI 查类别后直接读进该类别的
+                      单生产者单消费者环形缓冲区, 环形缓冲区满时照样释放硬件邮箱;
+                   2. 发送队列是按仲裁字段排序的二叉堆, 同优先级按入队顺序;
+                   3. 3 个邮箱都忙而队首优先级更高时, 中止最低优先级的邮箱,
+                      中止成功的帧重新入队, 同一 ID 同时只占一个邮箱以保证顺序.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_queue.h"
+#include "string.h"
+
+/**
+  * @Name    CANQueue_Key
+  * @brief   按总线仲裁顺序生成排序键
+  * @param   Frame: 帧
+  * @retval  排序键
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          位序与线上仲裁字段一致: 基本 ID[10:0], RTR/SRR, IDE, 扩展 ID[17:0], RTR,
+          因此同基本 ID 时标准数据帧优先于扩展帧.
+ **/
+static uint32_t CANQueue_Key(const CANBus_Frame *Frame) {
+    if(Frame->Ext) {
+        return ((Frame->Id >> 18) << 21) | (3U << 19) | ((Frame->Id & 0x3FFFF) << 1) | (Frame->Rtr ? 1U : 0U);
+    }
+
+    return (Frame->Id << 21) | (Frame->Rtr ? (1U << 20) : 0U);
+}
+
+static uint8_t CANQueue_Before(const CANQueue_TxItem *A, const CANQueue_TxItem *B) {
+    if(A->Key != B->Key) return (uint8_t)(A->Key < B->Key);
+
+    return (uint8_t)((int32_t)(A->Seq - B->Seq) < 0);
+}
+
+/**
+  * @Name    CANQueue_Push
+  * @brief   发送堆入队
+  * @param   Q: 队列
+  * @param   Item: 待入队条目
+  * @retval  1: 成功; 0: 队列满
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint8_t CANQueue_Push(CANQueue *Q, const CANQueue_TxItem *Item) {
+    uint32_t i, parent;
+
+    if(Q->HeapSize >= CANBUS_TX_DEPTH) return 0;
+
+    i = Q->HeapSize++;
+
+    while(i > 0) {
+        parent = (i - 1) >> 1;
+
+        if(!CANQueue_Before(Item, &Q->Heap[parent])) break;
+
+        Q->Heap[i] = Q->Heap[parent];
+        i = parent;
+    }
+
+    Q->Heap[i] = *Item;
+
+    if(Q->HeapSize > Q->Stats.TxQueueMax) Q->Stats.TxQueueMax = Q->HeapSize;
+
+    return 1;
+}
+
+/**
+  * @Name    CANQueue_Pop
+  * @brief   删除堆顶
+  * @param   Q: 队列
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void CANQueue_Pop(CANQueue *Q) {
+    const CANQueue_TxItem *last;
+    uint32_t i = 0, child;
+
+    if(Q->HeapSize == 0) return;
+
+    last = &Q->Heap[--Q->HeapSize];
+
+    while((child = 2 * i + 1) < Q->HeapSize) {
+        if(child + 1 < Q->HeapSize && CANQueue_Before(&Q->Heap[child + 1], &Q->Heap[child])) child++;
+
+        if(!CANQueue_Before(&Q->Heap[child], last)) break;
+
+        Q->Heap[i] = Q->Heap[child];
+        i = child;
+    }
+
+    Q->Heap[i] = *last;
+}
+
+/**
+  * @Name    CANQueue_Load
+  * @brief   把队首装入空邮箱, 必要时中止最低优先级的邮箱
+  * @param   Q: 队列
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          调用者须保证发送中断不会同时进入(在发送中断内, 或已屏蔽发送中断).
+          邮箱占用以软件记录为准, 完成中断处理之前不会复用该邮箱.
+ **/
+static void CANQueue_Load(CANQueue *Q) {
+    uint8_t mb, worst;
+
+    while(Q->HeapSize) {
+        for(mb = 0; mb < CANQUEUE_MAILBOXES; mb++) {
+            if((Q->MailboxBusy & (1U << mb)) && Q->Mailbox[mb].Key == Q->Heap[0].Key) return;
+        }
+
+        for(mb = 0; mb < CANQUEUE_MAILBOXES; mb++) {
+            if(!(Q->MailboxBusy & (1U << mb))) break;
+        }
+
+        if(mb == CANQUEUE_MAILBOXES) {
+            worst = 0;
+
+            for(mb = 1; mb < CANQUEUE_MAILBOXES; mb++) {
+                if(CANQueue_Before(&Q->Mailbox[worst], &Q->Mailbox[mb])) worst = mb;
+            }
+
+            if(!(Q->MailboxAbort & (1U << worst)) && CANQueue_Before(&Q->Heap[0], &Q->Mailbox[worst])) {
+                Q->MailboxAbort |= (uint8_t)(1U << worst);
+                Q->Port->Abort(Q, worst);
+            }
+
+            return;
+        }
+
+        Q->Mailbox[mb] = Q->Heap[0];
+        Q->MailboxBusy |= (uint8_t)(1U << mb);
+        CANQueue_Pop(Q);
+
+        Q->Port->Write(Q, mb, &Q->Mailbox[mb].Frame);
+    }
+}
+
+/**
+  * @Name    CANQueue_Init
+  * @brief   清空队列, 装入过滤器编号到类别的对照表
+  * @param   Q: 队列
+  * @param   Port: 硬件接口
+  * @param   Table: CANFilter_Compile 的结果, 不能为 NULL
+  * @param   FMIOffset: 本表第一组在每个 FIFO 内的过滤器编号, 由 CANFilter_Load 给出; NULL 为 0
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANQueue_Init(CANQueue *Q, const CANQueue_Port *Port, const CANFilter_Table *Table,
+                   const uint8_t FMIOffset[2]) {
+    memset(Q, 0, sizeof(CANQueue));
+    Q->Port = Port;
+
+    if(FMIOffset) {
+        Q->FMIOffset[0] = FMIOffset[0];
+        Q->FMIOffset[1] = FMIOffset[1];
+    }
+
+    Q->NumFMI[0] = Table->NumFMI[0];
+    Q->NumFMI[1] = Table->NumFMI[1];
+    memcpy(Q->FMIClass, Table->FMIClass, sizeof(Q->FMIClass));
+}
+
+/**
+  * @Name    CANQueue_Send
+  * @brief   帧入发送队列, 有空邮箱时立即装入
+  * @param   Q: 队列
+  * @param   Frame: 帧, Class 和 Time 不使用
+  * @retval  1: 成功; 0: 队列满, 计入 TxDropped
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          调用者先屏蔽本 CAN 的发送中断; 不可重入, 只能在一个上下文中调用.
+ **/
+uint8_t CANQueue_Send(CANQueue *Q, const CANBus_Frame *Frame) {
+    CANQueue_TxItem item;
+
+    item.Frame = *Frame;
+    item.Key = CANQueue_Key(Frame);
+    item.Seq = Q->Seq++;
+
+    if(!CANQueue_Push(Q, &item)) {
+        Q->Stats.TxDropped++;
+        return 0;
+    }
+
+    CANQueue_Load(Q);
+
+    return 1;
+}
+
+/**
+  * @Name    CANQueue_Receive
+  * @brief   取一帧, 类别 0 优先
+  * @param   Q: 队列
+  * @param   Frame: 输出
+  * @retval  1: 取到; 0: 无数据
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          不屏蔽中断, 只能在一个上下文中调用.
+ **/
+uint8_t CANQueue_Receive(CANQueue *Q, CANBus_Frame *Frame) {
+    CANQueue_Ring *ring;
+    uint32_t tail;
+    uint8_t cls;
+
+    for(cls = 0; cls < CANFILTER_MAX_CLASS; cls++) {
+        ring = &Q->Rx[cls];
+        tail = ring->Tail;
+
+        if(ring->Head == tail) continue;
+
+        *Frame = ring->Buf[tail & (CANBUS_RX_DEPTH - 1)];
+        CANQUEUE_DMB();
+        ring->Tail = tail + 1;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+  * @Name    CANQueue_RxSlot
+  * @brief   接收中断取一个空位, 由调用者把 FIFO 邮箱直接读进去
+  * @param   Q: 队列
+  * @param   FIFO: 0 或 1
+  * @param   FMI: 硬件给出的过滤器编号
+  * @retval  空位(Class 已填好); 该类别的环形缓冲区满时返回 NULL, 计入 RxOverflow
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          不在本表中的编号按 FIFO 号归类. 返回 NULL 时也要释放硬件邮箱, 避免硬件 FIFO 溢出
+          连带丢失其它类别的帧.
+ **/
+CANBus_Frame *CANQueue_RxSlot(CANQueue *Q, uint8_t FIFO, uint8_t FMI) {
+    CANQueue_Ring *ring;
+    CANBus_Frame *f;
+    uint32_t head;
+    uint8_t fmi = (uint8_t)(FMI - Q->FMIOffset[FIFO]);
+    uint8_t cls = (fmi < Q->NumFMI[FIFO]) ? Q->FMIClass[FIFO][fmi] : FIFO;
+
+    ring = &Q->Rx[cls];
+    head = ring->Head;
+
+    if(head - ring->Tail >= CANBUS_RX_DEPTH) {
+        Q->Stats.RxOverflow[cls]++;
+        return NULL;
+    }
+
+    f = &ring->Buf[head & (CANBUS_RX_DEPTH - 1)];
+    f->Class = cls;
+
+    return f;
+}
+
+/**
+  * @Name    CANQueue_RxCommit
+  * @brief   发布 CANQueue_RxSlot 取得的帧
+  * @param   Q: 队列
+  * @param   Slot: CANQueue_RxSlot 的返回值, 已填好
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANQueue_RxCommit(CANQueue *Q, const CANBus_Frame *Slot) {
+    CANQueue_Ring *ring = &Q->Rx[Slot->Class];
+
+    CANQUEUE_DMB();
+    ring->Head = ring->Head + 1;
+    Q->Stats.RxFrames++;
+}
+
+/**
+  * @Name    CANQueue_FifoOverrun
+  * @brief   记录一次硬件 FIFO 溢出
+  * @param   Q: 队列
+  * @param   FIFO: 0 或 1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANQueue_FifoOverrun(CANQueue *Q, uint8_t FIFO) {
+    Q->Stats.FifoOverrun[FIFO]++;
+}
+
+/**
+  * @Name    CANQueue_TxDone
+  * @brief   发送完成中断: 释放完成的邮箱, 被中止的帧重新入队, 再装入新的帧
+  * @param   Q: 队列
+  * @param   Done: 完成的邮箱, 第 n 位对应邮箱 n, 调用前已清除硬件完成标志
+  * @param   Ok: 其中发送成功的邮箱
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          失败且发过中止请求的帧重新入队, 否则计入 TxErrors. 先把队首装入刚空出的邮箱,
+          再把被中止的帧放回队列, 保证队列满时也有位置.
+ **/
+void CANQueue_TxDone(CANQueue *Q, uint8_t Done, uint8_t Ok) {
+    CANQueue_TxItem requeue[CANQUEUE_MAILBOXES];
+    uint8_t mb, n = 0;
+
+    Done &= Q->MailboxBusy;
+
+    for(mb = 0; mb < CANQUEUE_MAILBOXES; mb++) {
+        if(!(Done & (1U << mb))) continue;
+
+        if(Ok & (1U << mb)) Q->Stats.TxFrames++;
+        else if(Q->MailboxAbort & (1U << mb)) requeue[n++] = Q->Mailbox[mb];
+        else Q->Stats.TxErrors++;
+
+        Q->MailboxBusy &= (uint8_t)~(1U << mb);
+        Q->MailboxAbort &= (uint8_t)~(1U << mb);
+    }
+
+    CANQueue_Load(Q);
+
+    for(mb = 0; mb < n; mb++) {
+        if(CANQueue_Push(Q, &requeue[mb])) Q->Stats.TxRequeued++;
+        else Q->Stats.TxDropped++;
+    }
+
+    if(n) CANQueue_Load(Q);
+}
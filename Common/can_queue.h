@@ -0,0 +1,120 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_queue.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 收发队列
+                   只依赖 stdint.h, 不访问寄存器, STM32/GD32/AT32 模板共用.
+                   接收: 每个优先级类别一个的单生产者单消费者环形缓冲区, 按过滤器编号(FMI)分类;
+                   发送: 按仲裁优先级排序的发送队列, 同时使用 3 个发送邮箱,
+                         更高优先级的帧到来时中止优先级最低的邮箱并重新排队.
+                   各模板的 can_bus.c 只负责寄存器: 接收中断里用 CANQueue_RxSlot / CANQueue_RxCommit
+                   把 FIFO 邮箱直接读进环形缓冲区, 发送完成中断把完成的邮箱交给 CANQueue_TxDone,
+                   写邮箱和中止请求经 CANQueue_Port 回调完成.
+                   由 Common/Tools/can_queue_test.py 在主机上检查.
+  * Function List:
+                   CANQueue_Init
+                   CANQueue_Send
+                   CANQueue_Receive
+                   CANQueue_RxSlot
+                   CANQueue_RxCommit
+                   CANQueue_FifoOverrun
+                   CANQueue_TxDone
+  ******************************************************
+**/
+
+#ifndef __CAN_QUEUE_H_
+#define __CAN_QUEUE_H_
+
+#include <stdint.h>
+#include "can_filter.h"
+
+#define CANBUS_RX_DEPTH         32      //每个类别的接收环形缓冲区深度, 必须是 2 的幂
+#define CANBUS_TX_DEPTH         32      //发送队列深度
+#define CANQUEUE_MAILBOXES      3
+
+/* 环形缓冲区的发布顺序: 帧内容写完再移动 Head/Tail */
+#ifndef CANQUEUE_DMB
+#if defined(__CC_ARM)
+#define CANQUEUE_DMB()          __dmb(0xF)
+#else
+#define CANQUEUE_DMB()          __sync_synchronize()
+#endif
+#endif
+
+/* 一帧数据 */
+typedef struct {
+    uint32_t Id;                //11 位或 29 位 ID
+    uint8_t  Ext;               //0: 标准帧, 1: 扩展帧
+    uint8_t  Rtr;               //0: 数据帧, 1: 远程帧
+    uint8_t  Dlc;
+    uint8_t  Class;             //接收: 规则表中的类别
+    uint16_t Time;              //接收: 硬件时间戳(需开启 TTCM)
+    uint8_t  Data[8];
+} CANBus_Frame;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t RxFrames;
+    uint32_t RxOverflow[CANFILTER_MAX_CLASS];   //环形缓冲区满丢弃的帧
+    uint32_t FifoOverrun[2];                    //硬件 FIFO 溢出次数(中断来不及读)
+    uint32_t TxFrames;                          //发送成功的帧
+    uint32_t TxRequeued;                        //被更高优先级抢占后重新排队的帧
+    uint32_t TxErrors;                          //发送失败(关闭自动重传时)
+    uint32_t TxDropped;                         //发送队列满被拒绝的帧
+    uint32_t TxQueueMax;                        //发送队列最大深度
+} CANBus_Stats;
+
+typedef struct {
+    CANBus_Frame Buf[CANBUS_RX_DEPTH];
+    volatile uint32_t Head;     //只由接收中断写
+    volatile uint32_t Tail;     //只由 CANQueue_Receive 写
+} CANQueue_Ring;
+
+typedef struct {
+    uint32_t Key;               //仲裁字段, 越小优先级越高
+    uint32_t Seq;               //入队序号
+    CANBus_Frame Frame;
+} CANQueue_TxItem;
+
+typedef struct CANQueue CANQueue;
+
+/* 各模板的硬件接口, 在发送中断内或已屏蔽发送中断时调用 */
+typedef struct {
+    void (*Write)(CANQueue *Q, uint8_t Mailbox, const CANBus_Frame *Frame);    //写邮箱并请求发送
+    void (*Abort)(CANQueue *Q, uint8_t Mailbox);                               //请求中止邮箱
+} CANQueue_Port;
+
+/* 一个 CAN 的队列状态, 由各模板定义(STM32 放 CCM), 回调按 Q 在数组中的位置找到 CAN */
+struct CANQueue {
+    const CANQueue_Port *Port;
+    CANQueue_Ring Rx[CANFILTER_MAX_CLASS];
+    uint8_t FMIOffset[2];
+    uint8_t NumFMI[2];
+    uint8_t FMIClass[2][CANFILTER_MAX_FMI];
+    CANQueue_TxItem Heap[CANBUS_TX_DEPTH];
+    uint32_t HeapSize;
+    uint32_t Seq;
+    CANQueue_TxItem Mailbox[CANQUEUE_MAILBOXES];
+    uint8_t MailboxBusy;
+    uint8_t MailboxAbort;
+    CANBus_Stats Stats;
+};
+
+void CANQueue_Init(CANQueue *Q, const CANQueue_Port *Port, const CANFilter_Table *Table,
+                   const uint8_t FMIOffset[2]);
+uint8_t CANQueue_Send(CANQueue *Q, const CANBus_Frame *Frame);
+uint8_t CANQueue_Receive(CANQueue *Q, CANBus_Frame *Frame);
+CANBus_Frame *CANQueue_RxSlot(CANQueue *Q, uint8_t FIFO, uint8_t FMI);
+void CANQueue_RxCommit(CANQueue *Q, const CANBus_Frame *Slot);
+void CANQueue_FifoOverrun(CANQueue *Q, uint8_t FIFO);
+void CANQueue_TxDone(CANQueue *Q, uint8_t Done, uint8_t Ok);
+
+#endif
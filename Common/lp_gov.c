@@ -0,0 +1,326 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的公共部分
+                   1. 选择: 从最深的模式往浅找, 要求 进入 + 唤醒 + 最短驻留 <= 距到期时间, 唤醒时延
+                      不超过 Lp_SetMaxLatency, 没有被 Lp_Block 禁止, 且不深于 Port->Deepest;
+                      都不满足时不休眠;
+                   2. 决定和进入都在 Port->Lock 内进行, 期间到来的中断仍能唤醒 WFI, 不会漏掉;
+                      唤醒后先恢复时钟再开中断, 中断服务在全速下执行, 唤醒时延由 1 的限制保证;
+                   3. 定时模式的唤醒时间取 到期时间 - 唤醒时延, 到期时已回到全速; 唤醒定时器一次
+                      定不了那么长时提前醒来, 由主循环再次调用, 更长的空闲分多次休眠;
+                   4. 进入耗时用 Port->Cycles 实测, 恢复耗时由 Port->Enter 按唤醒后的内部时钟实测,
+                      都取最大值替换时延表的估计值.
+  * Function List:
+
+  **********************************************************
+ */
+#include "lp_gov.h"
+#include "string.h"
+
+static const Lp_Port *lp_port;
+static Lp_Config lp_cfg;
+static Lp_Latency lp_lat[LP_MODE_MAX];
+static uint32_t lp_entry_max[LP_MODE_MAX];      //实测, 0 为未测
+static uint32_t lp_restore_max[LP_MODE_MAX];
+static Lp_Stats lp_stats;
+static uint8_t lp_block[LP_MODE_MAX];
+static uint32_t lp_max_latency = LP_FOREVER;
+
+static uint32_t lp_cycles_to_us(uint32_t Cycles, uint32_t Mhz) {
+    return (Cycles + Mhz - 1) / Mhz;
+}
+
+static uint32_t lp_entry_us(uint8_t Mode) {
+    return lp_entry_max[Mode] ? lp_entry_max[Mode] : lp_lat[Mode].EntryUs;
+}
+
+static uint32_t lp_exit_us(uint8_t Mode) {
+    return lp_lat[Mode].HwWakeUs + (lp_restore_max[Mode] ? lp_restore_max[Mode] : lp_lat[Mode].RestoreUs);
+}
+
+static uint8_t lp_valid(uint8_t Mode) {
+    return lp_port != NULL && Mode != LP_MODE_RUN && Mode < lp_port->NumModes;
+}
+
+/**
+  * @Name    Lp_GovInit
+  * @brief   装入默认时延表, 清除实测值、统计和 Lp_Block 计数
+  * @param   Port: 硬件接口, 由各模板的 Lp_Init 传入
+  * @param   Cfg: 回调, NextDeadline 不能为 NULL
+  * @retval  LP_OK; 参数错误时 LP_ERR_PARAM, 之后 Lp_Idle 不休眠, Lp_Block 等不起作用
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          最大唤醒时延不清除, 可在初始化之前设置.
+ **/
+int32_t Lp_GovInit(const Lp_Port *Port, const Lp_Config *Cfg) {
+    lp_port = NULL;
+
+    if(Port == NULL || Cfg == NULL || Cfg->NextDeadline == NULL || Port->NumModes > LP_MODE_MAX)
+        return LP_ERR_PARAM;
+
+    lp_cfg = *Cfg;
+    memset(lp_lat, 0, sizeof(lp_lat));
+    memcpy(lp_lat, Port->Defaults, Port->NumModes * sizeof(Lp_Latency));
+    memset(lp_entry_max, 0, sizeof(lp_entry_max));
+    memset(lp_restore_max, 0, sizeof(lp_restore_max));
+    memset(&lp_stats, 0, sizeof(lp_stats));
+    memset(lp_block, 0, sizeof(lp_block));
+    lp_port = Port;
+
+    return LP_OK;
+}
+
+/* 满足时间的最深模式; 更深的模式本可满足但被禁止时记一次降级 */
+static uint8_t lp_select(uint32_t Idle) {
+    uint8_t mode, deepest, allowed = lp_port->NumModes - 1, demoted = 0;
+    uint32_t exit;
+
+    for(mode = LP_MODE_RUN + 1; mode < lp_port->NumModes; mode++) {
+        if(lp_block[mode]) {
+            allowed = mode - 1;
+            break;
+        }
+    }
+
+    if(lp_port->Deepest) {
+        deepest = lp_port->Deepest();
+        if(allowed > deepest) allowed = deepest;
+    }
+
+    for(mode = lp_port->NumModes - 1; mode > LP_MODE_RUN; mode--) {
+        exit = lp_exit_us(mode);
+
+        if((uint64_t)lp_entry_us(mode) + exit + lp_lat[mode].MinUs > Idle) continue;
+
+        if(mode > allowed || exit > lp_max_latency) {
+            demoted = 1;
+            continue;
+        }
+
+        break;
+    }
+
+    if(demoted) lp_stats.Demoted++;
+
+    return mode;
+}
+
+/**
+  * @Name    Lp_Idle
+  * @brief   空闲时调用一次, 按到期时间休眠
+  * @param   None
+  * @retval  实际使用的模式 LP_MODE_xxx
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          被任何中断唤醒即返回, 中断服务在返回前(开中断时)执行; 主循环处理完事件后再次调用.
+ **/
+uint8_t Lp_Idle(void) {
+    uint32_t start, state, idle, planned = 0, slept = 0, t0 = 0, us;
+    uint8_t mode, timed;
+    Lp_Wake info;
+    Lp_ModeStats *st;
+
+    if(lp_port == NULL) return LP_MODE_RUN;
+
+    start = lp_port->Cycles();
+    state = lp_port->Lock();
+
+    idle = lp_cfg.NextDeadline();
+    mode = lp_select(idle);
+
+    if(mode == LP_MODE_RUN) {
+        lp_port->Unlock(state);
+        return mode;
+    }
+
+    st = &lp_stats.Mode[mode];
+    timed = mode >= lp_port->TimedMode;
+    if(lp_cfg.NowUs) t0 = lp_cfg.NowUs();
+
+    if(timed) {
+        if(lp_cfg.Suspend) lp_cfg.Suspend(mode);
+
+        planned = lp_port->Arm(mode, idle - lp_exit_us(mode));
+    }
+
+    us = lp_cycles_to_us(lp_port->Cycles() - start, lp_port->CpuMhz());
+    if(us > lp_entry_max[mode]) lp_entry_max[mode] = us;
+
+    memset(&info, 0, sizeof(info));
+    lp_port->Enter(mode, lp_cfg.Wake, &info);
+
+    if(timed) {
+        if(info.ClockFail) lp_stats.ClockFail++;
+
+        if(info.RestoreCycles > st->MaxRestoreCycles) st->MaxRestoreCycles = info.RestoreCycles;
+        us = lp_cycles_to_us(info.RestoreCycles, info.RestoreMhz);
+        if(us > lp_restore_max[mode]) lp_restore_max[mode] = us;
+
+        if(!info.Fired) st->Early++;
+    }
+
+    if(timed && info.Fired && planned != 0) slept = planned;
+    else if(lp_cfg.NowUs) slept = lp_cfg.NowUs() - t0;
+
+    if(timed && lp_cfg.Resume) lp_cfg.Resume(mode, slept);
+
+    st->Count++;
+    st->TimeUs += slept;
+
+    lp_port->Unlock(state);
+
+    return mode;
+}
+
+/**
+  * @Name    Lp_Block
+  * @brief   禁止进入 Mode 及更深的模式, 可嵌套, 与 Lp_Unblock 成对使用
+  * @param   Mode: LP_MODE_RUN 以外的模式
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          例如 DMA 传输期间 Lp_Block(LP_MODE_STOP), 结束时 Lp_Unblock(LP_MODE_STOP).
+ **/
+void Lp_Block(uint8_t Mode) {
+    uint32_t state;
+
+    if(!lp_valid(Mode)) return;
+
+    state = lp_port->Lock();
+    lp_block[Mode]++;
+    lp_port->Unlock(state);
+}
+
+/**
+  * @Name    Lp_Unblock
+  * @brief   撤销一次 Lp_Block
+  * @param   Mode: 与 Lp_Block 相同
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Lp_Unblock(uint8_t Mode) {
+    uint32_t state;
+
+    if(!lp_valid(Mode)) return;
+
+    state = lp_port->Lock();
+    if(lp_block[Mode]) lp_block[Mode]--;
+    lp_port->Unlock(state);
+}
+
+/**
+  * @Name    Lp_SetMaxLatency
+  * @brief   设置允许的最大唤醒时延, 唤醒时延更长的模式不再使用
+  * @param   Us: 微秒, LP_FOREVER 为不限制
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          唤醒时延 = 硬件唤醒 + 时钟恢复, 即中断到来到中断服务在全速下开始执行的最长时间.
+ **/
+void Lp_SetMaxLatency(uint32_t Us) {
+    lp_max_latency = Us;
+}
+
+/**
+  * @Name    Lp_SetLatency
+  * @brief   设置某个模式的时延表, 同时清除该模式的实测值
+  * @param   Mode: LP_MODE_RUN 以外的模式
+  * @param   Lat: 时延
+  * @retval  LP_OK; 模式不存在或 Lat 为 NULL 时 LP_ERR_PARAM
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int32_t Lp_SetLatency(uint8_t Mode, const Lp_Latency *Lat) {
+    uint32_t state;
+
+    if(Lat == NULL || !lp_valid(Mode)) return LP_ERR_PARAM;
+
+    state = lp_port->Lock();
+    lp_lat[Mode] = *Lat;
+    lp_entry_max[Mode] = 0;
+    lp_restore_max[Mode] = 0;
+    lp_port->Unlock(state);
+
+    return LP_OK;
+}
+
+/**
+  * @Name    Lp_GetLatency
+  * @brief   读取某个模式当前使用的时延, 已实测的项为实测最大值
+  * @param   Mode: LP_MODE_xxx
+  * @param   Lat: 输出
+  * @retval  LP_OK; 模式不存在或 Lat 为 NULL 时 LP_ERR_PARAM
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int32_t Lp_GetLatency(uint8_t Mode, Lp_Latency *Lat) {
+    if(Lat == NULL || lp_port == NULL || Mode >= lp_port->NumModes) return LP_ERR_PARAM;
+
+    *Lat = lp_lat[Mode];
+    Lat->EntryUs = lp_entry_us(Mode);
+    Lat->RestoreUs = lp_exit_us(Mode) - Lat->HwWakeUs;
+
+    return LP_OK;
+}
+
+/**
+  * @Name    Lp_GetStats
+  * @brief   读取驻留统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Lp_GetStats(Lp_Stats *Stats) {
+    uint32_t state;
+
+    if(lp_port == NULL) {
+        memset(Stats, 0, sizeof(*Stats));
+        return;
+    }
+
+    state = lp_port->Lock();
+    *Stats = lp_stats;
+    lp_port->Unlock(state);
+}
+
+/**
+  * @Name    Lp_ResetStats
+  * @brief   清除驻留统计和实测时延
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Lp_ResetStats(void) {
+    uint32_t state;
+
+    if(lp_port == NULL) return;
+
+    state = lp_port->Lock();
+    memset(&lp_stats, 0, sizeof(lp_stats));
+    memset(lp_entry_max, 0, sizeof(lp_entry_max));
+    memset(lp_restore_max, 0, sizeof(lp_restore_max));
+    lp_port->Unlock(state);
+}
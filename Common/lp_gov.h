@@ -0,0 +1,114 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的公共部分
+                   只依赖 stdint.h, 不访问寄存器, STM32/HC32/SWM32 模板共用.
+                   主循环空闲时调用 Lp_Idle: 按下一个定时器到期时间和各模式的进出时延表, 选能在
+                   到期前恢复全速的最深模式; 进入耗时和恢复耗时每次实测, 更新时延表;
+                   记录各模式次数和驻留时间.
+                   各模板的 lp_gov_hw.c 提供 Lp_Init 和模式定义(LP_MODE_xxx), 只负责进入模式、
+                   唤醒定时器和唤醒后的时钟恢复, 经 Lp_Port 交给 Lp_GovInit.
+                   由 Common/Tools/lp_gov_test.py 在主机上检查.
+  * Function List:
+                   Lp_GovInit
+                   Lp_Idle
+                   Lp_Block
+                   Lp_Unblock
+                   Lp_SetMaxLatency
+                   Lp_SetLatency
+                   Lp_GetLatency
+                   Lp_GetStats
+                   Lp_ResetStats
+  ******************************************************
+**/
+
+#ifndef __LP_GOV_H_
+#define __LP_GOV_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LP_FOREVER              0xFFFFFFFF
+
+/* 模式, 数值越大越深; LP_MODE_RUN 以外的模式见各模板 lp_gov_hw.h */
+#define LP_MODE_RUN             0       //不休眠, 立即返回
+#define LP_MODE_MAX             4       //模式数上限(含 LP_MODE_RUN)
+
+/* 错误码 */
+#define LP_OK                   0
+#define LP_ERR_PARAM            (-1)    //参数错误
+
+/* 时延表, 单位 us */
+typedef struct {
+    uint32_t EntryUs;           //决定进入到执行 WFI(实测)
+    uint32_t HwWakeUs;          //唤醒事件到执行第一条指令, 手册值, 片上无法测量
+    uint32_t RestoreUs;         //恢复时钟到全速(实测最大值, 未测时为估计值)
+    uint32_t MinUs;             //最短驻留, 更短时省下的电抵不过进出开销
+} Lp_Latency;
+
+typedef struct {
+    uint32_t Count;
+    uint32_t Early;             //定时未到即被其他中断唤醒
+    uint64_t TimeUs;            //驻留时间; 提前唤醒且没有 NowUs 时不计
+    uint32_t MaxRestoreCycles;  //恢复时钟的最大周期数(按唤醒后运行的内部时钟计)
+} Lp_ModeStats;
+
+typedef struct {
+    Lp_ModeStats Mode[LP_MODE_MAX];
+    uint32_t Demoted;           //被 Lp_Block、时延上限或硬件条件降为更浅的模式
+    uint32_t ClockFail;         //唤醒后外部振荡器或 PLL 未稳定, 留在内部时钟
+} Lp_Stats;
+
+/* 应用回调 */
+typedef struct {
+    uint32_t (*NextDeadline)(void);                 //距下一个定时器到期的 us, 没有时返回 LP_FOREVER
+    uint32_t (*NowUs)(void);                        //可为 NULL; 休眠中不停的时间源, 用于提前唤醒时计时
+    void (*Suspend)(uint8_t Mode);                  //可为 NULL; 进入定时模式前调用, 如停 SysTick
+    void (*Wake)(uint8_t Mode);                     //可为 NULL; 唤醒后在内部时钟上等待振荡器时调用, 恢复外设状态
+    void (*Resume)(uint8_t Mode, uint32_t SleptUs); //可为 NULL; 定时模式恢复时钟后调用, 补偿节拍
+} Lp_Config;
+
+/* 定时模式唤醒后由 Lp_Port.Enter 填写 */
+typedef struct {
+    uint32_t RestoreCycles;     //恢复时钟用的周期数
+    uint32_t RestoreMhz;        //RestoreCycles 的计数频率(MHz), 即唤醒后运行的内部时钟
+    uint8_t  Fired;             //1: 唤醒定时器已到; 0: 被其他唤醒源提前唤醒
+    uint8_t  ClockFail;         //1: 振荡器未稳定, 留在内部时钟
+} Lp_Wake;
+
+/* 各模板的硬件接口 */
+typedef struct {
+    uint8_t NumModes;                               //含 LP_MODE_RUN, 不超过 LP_MODE_MAX
+    uint8_t TimedMode;                              //从这个模式起由唤醒定时器按时唤醒并需恢复时钟
+    const Lp_Latency *Defaults;                     //默认时延表, NumModes 项
+    uint32_t (*Lock)(void);                         //关中断, 返回之前的中断状态
+    void (*Unlock)(uint32_t State);                 //恢复 Lock 返回的状态
+    uint32_t (*Cycles)(void);                       //CPU 周期计数(DWT->CYCCNT)
+    uint32_t (*CpuMhz)(void);                       //当前 CPU 时钟(MHz)
+    uint8_t (*Deepest)(void);                       //可为 NULL; 当前可用的最深模式, 如 RTC 未开时不能定时唤醒
+    uint32_t (*Arm)(uint8_t Mode, uint32_t Us);     //定时模式: 约 Us 后唤醒, 返回实际定时 us, 相位未知时返回 0
+    void (*Enter)(uint8_t Mode, void (*Wake)(uint8_t Mode), Lp_Wake *Info);
+                                                    //进入 Mode 直到唤醒; 定时模式还要在等待振荡器时调用
+                                                    //Wake(可为 NULL)、恢复时钟、停唤醒定时器并填写 Info
+} Lp_Port;
+
+int32_t Lp_GovInit(const Lp_Port *Port, const Lp_Config *Cfg);
+uint8_t Lp_Idle(void);
+void Lp_Block(uint8_t Mode);
+void Lp_Unblock(uint8_t Mode);
+void Lp_SetMaxLatency(uint32_t Us);
+int32_t Lp_SetLatency(uint8_t Mode, const Lp_Latency *Lat);
+int32_t Lp_GetLatency(uint8_t Mode, Lp_Latency *Lat);
+void Lp_GetStats(Lp_Stats *Stats);
+void Lp_ResetStats(void);
+
+#endif
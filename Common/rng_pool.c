@@ -0,0 +1,490 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_pool.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 硬件随机数池 + ChaCha20 伪随机数发生器的公共部分
+                   1. 中断只做生产者(写 Head), 取数一侧只做消费者(写 Tail), 池不加锁;
+                   2. 健康检测失败时中断记下当时的 Head, 消费侧发现后丢弃之前的池内容,
+                      硬件重新经过启动检测才继续入池;
+                   3. ChaCha20 每次 Rng_Fill 先用当前密钥的一块输出替换密钥(快速密钥擦除), 本次输出
+                      由旧密钥的局部副本生成, 返回前擦除, 之后即使状态泄露也推不出已经给出的数据;
+                   4. 消费侧改 Tail 和密钥的部分在 Port->Lock 内完成(最多一块 ChaCha20 加一个种子),
+                      长输出在局部副本上生成不关中断, Rng_Fill/Rng_Raw 可同时在任务和中断中调用.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rng_pool.h"
+#include "string.h"
+
+#define RNG_POOL_MASK           (RNG_POOL_WORDS - 1)
+
+#define ROTL32(v, n)            (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER(a, b, c, d) \
+    a += b; d ^= a; d = ROTL32(d, 16); \
+    c += d; b ^= c; b = ROTL32(b, 12); \
+    a += b; d ^= a; d = ROTL32(d, 8);  \
+    c += d; b ^= c; b = ROTL32(b, 7)
+
+static Rng_Pool *rng;
+
+static uint8_t rng_reseed(void);
+
+/**
+  * @Name    rng_wipe
+  * @brief   清零, 用于擦除密钥和输出的局部副本
+  * @param   Buf: 缓冲
+  * @param   Len: 字节数
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          经 volatile 指针逐字节写, 函数返回前对局部变量的清零不会被编译器当作无用写入删掉.
+ **/
+static void rng_wipe(void *Buf, uint32_t Len) {
+    volatile uint8_t *p = (volatile uint8_t *)Buf;
+
+    while(Len--) *p++ = 0;
+}
+
+/**
+  * @Name    Rng_PoolInit
+  * @brief   清空池和生成器状态, 在打开 RNG 中断之前调用
+  * @param   Pool: 状态, 之后所有函数都作用于它
+  * @param   Port: 硬件接口
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Rng_PoolInit(Rng_Pool *Pool, const Rng_Port *Port) {
+    memset(Pool, 0, sizeof(*Pool));
+    Pool->Port = Port;
+    Pool->Startup = RNG_STARTUP_WORDS;
+
+    /* ChaCha20 常量 "expand 32-byte k", 密钥在第一次播种时填入, 计数器和 nonce 为 0 */
+    Pool->ChaCha[0] = 0x61707865;
+    Pool->ChaCha[1] = 0x3320646E;
+    Pool->ChaCha[2] = 0x79622D32;
+    Pool->ChaCha[3] = 0x6B206574;
+
+    rng = Pool;
+}
+
+/**
+  * @Name    rng_restart
+  * @brief   检测失败后重新开始启动检测, 在中断中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_restart(void) {
+    rng->FailHead = rng->Head;
+    rng->Epoch++;
+    rng->Startup = RNG_STARTUP_WORDS;
+    rng->RctCount = 0;
+    rng->AptIndex = 0;
+
+    if(++rng->FailRun > RNG_FAIL_MAX && !rng->Failed) {
+        rng->Failed = 1;
+        rng->Stats.Failed = 1;
+        rng->Port->Halt();
+    }
+}
+
+/**
+  * @Name    rng_health
+  * @brief   对一个字的 4 个字节做 RCT 和 APT
+  * @param   Word: 原始随机数
+  * @retval  0: 通过; 1: 失败
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          RCT: 同一字节连续出现 RNG_RCT_CUTOFF 次即失败, 针对输出卡死;
+          APT: 每 RNG_APT_WINDOW 字节以首字节为样本计数, 达到 RNG_APT_CUTOFF 即失败,
+          针对熵下降导致的分布偏斜.
+ **/
+static uint8_t rng_health(uint32_t Word) {
+    uint8_t b;
+    uint32_t i;
+
+    for(i = 0; i < 4; i++) {
+        b = (uint8_t)(Word >> (i * 8));
+
+        if(rng->RctCount != 0 && b == rng->RctLast) {
+            if(++rng->RctCount >= RNG_RCT_CUTOFF) {
+                rng->Stats.RctFailures++;
+                return 1;
+            }
+        } else {
+            rng->RctLast = b;
+            rng->RctCount = 1;
+        }
+
+        if(rng->AptIndex == 0) {
+            rng->AptFirst = b;
+            rng->AptCount = 1;
+        } else if(b == rng->AptFirst) {
+            if(++rng->AptCount >= RNG_APT_CUTOFF) {
+                rng->Stats.AptFailures++;
+                return 1;
+            }
+        }
+
+        if(++rng->AptIndex >= RNG_APT_WINDOW) rng->AptIndex = 0;
+    }
+
+    return 0;
+}
+
+/**
+  * @Name    Rng_Feed
+  * @brief   交给池一个原始随机字, 在 RNG 中断中调用
+  * @param   Word: 原始随机数
+  * @retval  1: 池已满或已判定故障, 停止产生, 直到 Port->Resume; 0: 继续
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          检测通过且启动检测已完成才入池; 检测失败丢弃池中失败前的数据, 重新做启动检测.
+ **/
+uint8_t Rng_Feed(uint32_t Word) {
+    if(rng->Failed) return 1;
+
+    if(rng_health(Word)) {
+        rng_restart();
+        return rng->Failed;
+    }
+
+    if(rng->Startup != 0) {
+        if(--rng->Startup == 0) rng->FailRun = 0;
+
+        return 0;
+    }
+
+    rng->Pool[rng->Head & RNG_POOL_MASK] = Word;
+    rng->Head++;
+    rng->Stats.Words++;
+
+    return rng->Head - rng->Tail >= RNG_POOL_WORDS;
+}
+
+/**
+  * @Name    Rng_Fault
+  * @brief   硬件报告的错误, 在 RNG 中断中调用
+  * @param   Kind: RNG_FAULT_SEED / RNG_FAULT_CLOCK
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          清标志和重启硬件由调用方完成, 这里只计数并当作一次检测失败处理.
+ **/
+void Rng_Fault(uint8_t Kind) {
+    if(Kind == RNG_FAULT_SEED) rng->Stats.SeedErrors++;
+    else rng->Stats.ClockErrors++;
+
+    rng_restart();
+}
+
+/**
+  * @Name    rng_sync
+  * @brief   发现检测失败后丢弃失败前入池的数据
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_sync(void) {
+    if(rng->SeenEpoch != rng->Epoch) {
+        rng->SeenEpoch = rng->Epoch;
+        rng->Tail = rng->FailHead;
+    }
+}
+
+/**
+  * @Name    rng_take
+  * @brief   从池中取一个字, 关中断时调用
+  * @param   Word: 输出
+  * @retval  1: 取到; 0: 池空
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint8_t rng_take(uint32_t *Word) {
+    uint32_t tail = rng->Tail;
+
+    if(rng->Head == tail) return 0;
+
+    *Word = rng->Pool[tail & RNG_POOL_MASK];
+    rng->Pool[tail & RNG_POOL_MASK] = 0;
+    rng->Tail = tail + 1;
+
+    if(!rng->Failed) rng->Port->Resume();
+
+    return 1;
+}
+
+/**
+  * @Name    Rng_PoolStart
+  * @brief   等待启动检测完成并取得第一个种子, 在打开 RNG 之后调用
+  * @param   Spins: 最多查询次数
+  * @retval  RNG_OK; RNG_ERR_FAILED: 硬件反复检测失败; RNG_ERR_UNSEEDED: 超时
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          启动检测 1024 字节在 48MHz 的 RNG 时钟下不到 1ms, 之后调用方不再等硬件.
+ **/
+int32_t Rng_PoolStart(uint32_t Spins) {
+    uint32_t i, state;
+    uint8_t ok;
+
+    for(i = 0; i < Spins; i++) {
+        if(rng->Failed) return RNG_ERR_FAILED;
+
+        if(Rng_Available() >= RNG_SEED_WORDS * 4) break;
+    }
+
+    state = rng->Port->Lock();
+    rng_sync();
+    ok = rng->Failed ? 0 : rng_reseed();
+    rng->Port->Unlock(state);
+
+    if(rng->Failed) return RNG_ERR_FAILED;
+
+    return ok ? RNG_OK : RNG_ERR_UNSEEDED;
+}
+
+/**
+  * @Name    Rng_Available
+  * @brief   池中原始随机数字节数
+  * @param   None
+  * @retval  字节数
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Rng_Available(void) {
+    uint32_t state, words;
+
+    state = rng->Port->Lock();
+    rng_sync();
+    words = rng->Head - rng->Tail;
+    rng->Port->Unlock(state);
+
+    return words * 4;
+}
+
+/**
+  * @Name    rng_block
+  * @brief   ChaCha20 生成一块(64 字节), 计数器加 1
+  * @param   State: 生成器状态
+  * @param   Out: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          State[12] 为块计数器, 进位到 State[13]; 输出 RNG 的 nonce 为 0, 不会用到进位.
+ **/
+static void rng_block(uint32_t State[16], uint32_t Out[16]) {
+    uint32_t x[16];
+    uint32_t i;
+
+    for(i = 0; i < 16; i++) x[i] = State[i];
+
+    for(i = 0; i < 10; i++) {
+        QUARTER(x[0], x[4], x[8],  x[12]);
+        QUARTER(x[1], x[5], x[9],  x[13]);
+        QUARTER(x[2], x[6], x[10], x[14]);
+        QUARTER(x[3], x[7], x[11], x[15]);
+        QUARTER(x[0], x[5], x[10], x[15]);
+        QUARTER(x[1], x[6], x[11], x[12]);
+        QUARTER(x[2], x[7], x[8],  x[13]);
+        QUARTER(x[3], x[4], x[9],  x[14]);
+    }
+
+    for(i = 0; i < 16; i++) Out[i] = x[i] + State[i];
+
+    rng_wipe(x, sizeof(x));
+
+    if(++State[12] == 0) State[13]++;
+}
+
+/**
+  * @Name    rng_reseed
+  * @brief   从池中取 8 个字异或进密钥, 关中断时调用
+  * @param   None
+  * @retval  1: 成功; 0: 池中不足一个种子, 密钥不变
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint8_t rng_reseed(void) {
+    uint32_t word, i;
+
+    if(rng->Head - rng->Tail < RNG_SEED_WORDS) return 0;
+
+    for(i = 0; i < RNG_SEED_WORDS; i++) {
+        rng_take(&word);
+        rng->ChaCha[4 + i] ^= word;
+    }
+
+    rng->ChaCha[12] = 0;
+    rng->ChaCha[13] = 0;
+    rng->SinceReseed = 0;
+    rng->Seeded = 1;
+    rng->Stats.Reseeds++;
+
+    return 1;
+}
+
+/**
+  * @Name    rng_rekey
+  * @brief   按需重播种, 取出本次输出用的状态并换密钥, 关中断时调用
+  * @param   State: 本次输出用的状态(旧密钥, 计数器接在换密钥用的块之后)
+  * @param   Len: 本次输出字节数
+  * @retval  RNG_OK; RNG_ERR_FAILED / RNG_ERR_UNSEEDED
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          到重播种间隔时池中不足一个种子就先用当前密钥继续输出, 下次再补,
+          绝不因硬件慢而阻塞.
+ **/
+static int32_t rng_rekey(uint32_t State[16], uint32_t Len) {
+    uint32_t block[16];
+
+    rng_sync();
+
+    if(rng->Failed) return RNG_ERR_FAILED;
+
+    if(!rng->Seeded || rng->SinceReseed >= RNG_RESEED_BYTES) {
+        if(!rng_reseed()) {
+            if(!rng->Seeded) return RNG_ERR_UNSEEDED;
+
+            rng->Stats.ReseedDeferred++;
+        }
+    }
+
+    rng->SinceReseed += Len;
+
+    /* 快速密钥擦除: 新密钥取自当前密钥的第一块, 本次输出从第二块开始 */
+    rng_block(rng->ChaCha, block);
+    memcpy(State, rng->ChaCha, sizeof(rng->ChaCha));
+    memcpy(&rng->ChaCha[4], block, 32);
+    rng->ChaCha[12] = 0;
+    rng->ChaCha[13] = 0;
+    rng_wipe(block, sizeof(block));
+
+    return RNG_OK;
+}
+
+/**
+  * @Name    Rng_Fill
+  * @brief   填充密码学安全的随机数, 不等待硬件
+  * @param   Buf: 输出
+  * @param   Len: 字节数
+  * @retval  RNG_OK; 尚未播种或硬件故障时 RNG_ERR_UNSEEDED / RNG_ERR_FAILED, Buf 不变
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只在 rng_rekey 期间关中断, 输出在局部状态上生成, 可重入;
+          旧密钥和本次输出用的块在返回前擦除.
+ **/
+int32_t Rng_Fill(void *Buf, uint32_t Len) {
+    uint8_t *p = (uint8_t *)Buf;
+    uint32_t state[16];
+    uint32_t block[16];
+    uint32_t n, lock;
+    int32_t ret;
+
+    lock = rng->Port->Lock();
+    ret = rng_rekey(state, Len);
+    rng->Port->Unlock(lock);
+
+    if(ret != RNG_OK) return ret;
+
+    while(Len != 0) {
+        rng_block(state, block);
+        n = Len < sizeof(block) ? Len : sizeof(block);
+        memcpy(p, block, n);
+        p += n;
+        Len -= n;
+    }
+
+    rng_wipe(state, sizeof(state));
+    rng_wipe(block, sizeof(block));
+
+    return RNG_OK;
+}
+
+/**
+  * @Name    Rng_Raw
+  * @brief   直接取池中经过检测的原始随机数
+  * @param   Buf: 输出
+  * @param   Len: 最多字节数
+  * @retval  实际字节数, 池中不够或硬件故障时小于 Len
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          按字取, Len 不是 4 的倍数时最后一个字只用前几个字节, 其余丢弃不再使用.
+          关中断取数, 最多取空一个池(RNG_POOL_WORDS 字), 可重入.
+ **/
+uint32_t Rng_Raw(void *Buf, uint32_t Len) {
+    uint8_t *p = (uint8_t *)Buf;
+    uint32_t word, n, lock, done = 0;
+
+    lock = rng->Port->Lock();
+    rng_sync();
+
+    if(!rng->Failed) {
+        while(done < Len && rng_take(&word)) {
+            n = Len - done < 4 ? Len - done : 4;
+            memcpy(p + done, &word, n);
+            done += n;
+        }
+    }
+
+    rng->Port->Unlock(lock);
+
+    return done;
+}
+
+/**
+  * @Name    Rng_TlsCallback
+  * @brief   TLS 库随机数回调(f_rng 形式)
+  * @param   Ctx: 未使用
+  * @param   Output: 输出
+  * @param   Len: 字节数
+  * @retval  0: 成功; -1: 失败
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int Rng_TlsCallback(void *Ctx, unsigned char *Output, size_t Len) {
+    (void)Ctx;
+
+    return Rng_Fill(Output, (uint32_t)Len) == RNG_OK ? 0 : -1;
+}
+
+/**
+  * @Name    Rng_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Rng_GetStats(Rng_Stats *Stats) {
+    *Stats = rng->Stats;
+}
@@ -0,0 +1,117 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_pool.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 硬件随机数池 + ChaCha20 伪随机数发生器的公共部分
+                   只依赖 stdint.h, 不访问寄存器, STM32/GD32/HC32 模板共用.
+                   各模板的 rng_hw.c 提供 Rng_Init / Rng_IRQHandler, 只负责 RNG/TRNG 的时钟、中断和
+                   取数: 中断里每取到一个原始字交给 Rng_Feed, 硬件报告的种子/时钟错误交给 Rng_Fault;
+                   关中断、池有空位后继续产生、判定故障后停止硬件经 Rng_Port 回调完成.
+                   每个原始字节都做连续健康检测(重复计数 RCT、自适应比例 APT, 参照 SP 800-90B 4.4).
+                   Rng_Fill 由 ChaCha20 输出, 只在池里够一个种子时重播种, 从不等待硬件;
+                   Rng_Raw 直接取池中原始随机数, 给需要真随机的场合(长期密钥).
+                   TLS 库的随机数回调可直接用 Rng_TlsCallback.
+                   由 Common/Tools/rng_pool_test.py 在主机上检查(含 RFC 8439 测试向量).
+  * Function List:
+                   Rng_PoolInit
+                   Rng_PoolStart
+                   Rng_Feed
+                   Rng_Fault
+                   Rng_Fill
+                   Rng_Raw
+                   Rng_Available
+                   Rng_TlsCallback
+                   Rng_GetStats
+  ******************************************************
+**/
+
+#ifndef __RNG_POOL_H_
+#define __RNG_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define RNG_POOL_WORDS          64      //原始随机数池(字), 须为 2 的幂
+#define RNG_SEED_WORDS          8       //一个种子(ChaCha20 密钥)
+#define RNG_STARTUP_WORDS       256     //启动检测: 前 1024 字节只做检测不入池
+#define RNG_FAIL_MAX            3       //连续检测失败次数超过后判定硬件故障, 停止输出
+#define RNG_RESEED_BYTES        4096    //ChaCha20 每输出这么多字节后从池取新种子
+
+/* 健康检测: 按每字节最小熵 2 bit 估计, 误报率 2^-20 */
+#define RNG_RCT_CUTOFF          11      //同一字节连续出现次数上限 1 + 20 / 2
+#define RNG_APT_WINDOW          512     //APT 窗口(字节)
+#define RNG_APT_CUTOFF          177     //窗口内首字节出现次数上限
+
+/* 错误码 */
+#define RNG_OK                  0
+#define RNG_ERR_FAILED          (-1)    //判定硬件故障, 不再输出
+#define RNG_ERR_UNSEEDED        (-2)    //尚未取得第一个种子
+
+/* Rng_Fault 的错误类型 */
+#define RNG_FAULT_SEED          0       //种子错误(STM32 SECS / GD32 SECS)
+#define RNG_FAULT_CLOCK         1       //时钟错误(CECS)
+
+/* 运行统计 */
+typedef struct {
+    uint32_t Words;             //通过检测进入池的字
+    uint32_t RctFailures;
+    uint32_t AptFailures;
+    uint32_t SeedErrors;        //硬件种子错误; HC32 的 TRNG 不报告, 始终为 0
+    uint32_t ClockErrors;       //硬件时钟错误; HC32 始终为 0
+    uint32_t Reseeds;
+    uint32_t ReseedDeferred;    //该重播种时池不足一个种子, 推迟到下次
+    uint8_t  Failed;            //1: 判定硬件故障, Rng_Fill/Rng_Raw 不再输出
+} Rng_Stats;
+
+/* 各模板的硬件接口 */
+typedef struct {
+    uint32_t (*Lock)(void);             //关中断, 返回之前的中断状态
+    void (*Unlock)(uint32_t State);     //恢复 Lock 返回的状态
+    void (*Resume)(void);               //池有了空位, 继续产生随机数; 关中断时调用
+    void (*Halt)(void);                 //判定硬件故障, 停止 RNG; 在 Rng_Feed / Rng_Fault 中调用
+} Rng_Port;
+
+/* 池和生成器状态, 由各模板定义, 可放在 DMA 访问不到的内存(STM32 放 CCM) */
+typedef struct {
+    const Rng_Port *Port;
+    /* 中断侧 */
+    uint32_t Pool[RNG_POOL_WORDS];
+    volatile uint32_t Head;
+    volatile uint32_t FailHead;         //最近一次检测失败时的 Head
+    volatile uint32_t Epoch;            //检测失败次数, 消费侧据此丢弃旧数据
+    volatile uint8_t  Failed;
+    uint32_t Startup;                   //启动检测还需丢弃的字数
+    uint32_t FailRun;                   //连续失败次数
+    uint8_t  RctLast;
+    uint32_t RctCount;
+    uint8_t  AptFirst;
+    uint32_t AptCount;
+    uint32_t AptIndex;
+    /* 消费侧 */
+    volatile uint32_t Tail;
+    uint32_t SeenEpoch;
+    uint32_t ChaCha[16];
+    uint32_t SinceReseed;
+    uint8_t  Seeded;
+    Rng_Stats Stats;
+} Rng_Pool;
+
+void Rng_PoolInit(Rng_Pool *Pool, const Rng_Port *Port);
+int32_t Rng_PoolStart(uint32_t Spins);
+uint8_t Rng_Feed(uint32_t Word);
+void Rng_Fault(uint8_t Kind);
+int32_t Rng_Fill(void *Buf, uint32_t Len);
+uint32_t Rng_Raw(void *Buf, uint32_t Len);
+uint32_t Rng_Available(void);
+int Rng_TlsCallback(void *Ctx, unsigned char *Output, size_t Len);
+void Rng_GetStats(Rng_Stats *Stats);
+
+#endif
@@ -0,0 +1,312 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram_plan.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SDRAM 时序换算、按内部 bank 分配和带宽测试
+                   1. 周期数 = ceil(ns * 时钟 / 1e9), 至少 1 个周期;
+                      tWR 同时满足 tWR >= tRAS - tRCD 和 tWR >= tRC - tRCD - tRP;
+                   2. 刷新间隔 = 刷新周期 / 行数 * 时钟, 控制器要求的余量由各模板扣除;
+                   3. BANK_ROW_COL 映射下每个内部 bank 一个线性指针; ROW_BANK_COL 映射下全片一个
+                      指针, 分配到 bank b 时起点移到下一个属于 b 的行段开头, 两个起点在不同 bank
+                      的缓冲按相同偏移顺序访问时始终落在不同 bank; 只整体释放, 适合启动时一次
+                      分配的帧缓冲和工作区;
+                   4. 带宽测试只在测试缓冲内写, 其余都是只读访问, 不会破坏已分配的数据.
+  * Function List:
+
+  **********************************************************
+ */
+#include "sdram_plan.h"
+#include "stddef.h"
+
+static SDRAM_Info sd_info;
+static uint32_t sd_used[SDRAM_INBK_MAX];        //BANK_ROW_COL: 各 bank 已用字节数
+static uint32_t sd_next;                        //ROW_BANK_COL: 全片已用到的偏移
+static uint8_t sd_count[SDRAM_INBK_MAX];
+
+static uint32_t SDRAM_Cycles(uint32_t Ns, uint32_t Hz) {
+    uint32_t cyc = (uint32_t)(((uint64_t)Ns * Hz + 999999999) / 1000000000);
+
+    return cyc ? cyc : 1;
+}
+
+static uint8_t SDRAM_IsPow2(uint32_t X) {
+    return X != 0 && (X & (X - 1)) == 0;
+}
+
+/**
+  * @Name    SDRAM_PickDiv
+  * @brief   选 SDRAM 时钟分频
+  * @param   InHz: 控制器输入时钟
+  * @param   MaxHz: 器件最高时钟
+  * @param   DivMin/DivMax: 控制器支持的分频范围(连续)
+  * @retval  不超过 MaxHz 的最小分频, 都超过时返回 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t SDRAM_PickDiv(uint32_t InHz, uint32_t MaxHz, uint8_t DivMin, uint8_t DivMax) {
+    uint8_t div;
+
+    for(div = DivMin; div != 0 && div <= DivMax; div++) {
+        if(InHz / div <= MaxHz) return div;
+    }
+
+    return 0;
+}
+
+/**
+  * @Name    SDRAM_PlanTiming
+  * @brief   把器件时序换算成 SDRAM 时钟周期
+  * @param   Config: 器件参数
+  * @param   Hz: SDRAM 时钟
+  * @param   Timing: 输出
+  * @retval  SDRAM_OK / SDRAM_ERR_PARAM(Hz 为 0、InBanks 不是 2 或 4、RefreshRows 为 0)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只做换算, 是否超出寄存器范围由调用者按本控制器检查.
+ **/
+int32_t SDRAM_PlanTiming(const SDRAM_Config *Config, uint32_t Hz, SDRAM_Timing *Timing) {
+    if(Hz == 0 || (Config->InBanks != 2 && Config->InBanks != 4) || Config->RefreshRows == 0) return SDRAM_ERR_PARAM;
+
+    Timing->tRCD = SDRAM_Cycles(Config->tRCD, Hz);
+    Timing->tRP = SDRAM_Cycles(Config->tRP, Hz);
+    Timing->tRC = SDRAM_Cycles(Config->tRC, Hz);
+    Timing->tRAS = SDRAM_Cycles(Config->tRAS, Hz);
+    Timing->tXSR = SDRAM_Cycles(Config->tXSR, Hz);
+    Timing->tWR = SDRAM_Cycles(Config->tWR, Hz);
+
+    if(Timing->tRAS > Timing->tRCD && Timing->tWR < Timing->tRAS - Timing->tRCD)
+        Timing->tWR = Timing->tRAS - Timing->tRCD;
+
+    if(Timing->tRC > Timing->tRCD + Timing->tRP && Timing->tWR < Timing->tRC - Timing->tRCD - Timing->tRP)
+        Timing->tWR = Timing->tRC - Timing->tRCD - Timing->tRP;
+
+    Timing->Refresh = (uint32_t)((uint64_t)Config->RefreshMs * Hz / 1000 / Config->RefreshRows);
+
+    return SDRAM_OK;
+}
+
+/**
+  * @Name    SDRAM_Attach
+  * @brief   登记初始化好的 SDRAM, 清空分配器
+  * @param   Info: 容量和地址映射, NULL 表示没有可用的 SDRAM
+  * @retval  SDRAM_OK / SDRAM_ERR_PARAM(容量不是 2 的幂或与 bank、行大小不符)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          由各模板的 SDRAM_Setup 调用: 开始时传 NULL, 上电序列完成后传初始化结果.
+ **/
+int32_t SDRAM_Attach(const SDRAM_Info *Info) {
+    sd_info.Size = 0;
+    SDRAM_FreeAll();
+
+    if(Info == NULL) return SDRAM_OK;
+
+    if((Info->InBanks != 2 && Info->InBanks != 4) || !SDRAM_IsPow2(Info->RowSize) || Info->RowSize < SDRAM_ALIGN ||
+            !SDRAM_IsPow2(Info->BankSize) || Info->BankSize < Info->RowSize || Info->Size != Info->BankSize * Info->InBanks ||
+            (Info->Map != SDRAM_MAP_BANK_ROW_COL && Info->Map != SDRAM_MAP_ROW_BANK_COL)) return SDRAM_ERR_PARAM;
+
+    sd_info = *Info;
+
+    return SDRAM_OK;
+}
+
+/**
+  * @Name    SDRAM_Alloc
+  * @brief   在指定内部 bank 中分配
+  * @param   Bytes: 字节数, 向上对齐到 SDRAM_ALIGN
+  * @param   Bank: 内部 bank 0 ~ InBanks-1, 或 SDRAM_BANK_ANY
+  * @retval  地址, 空间不足或未初始化返回 NULL
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          同时访问的缓冲(前/后帧缓冲、DMA 源和目的)放在不同 bank. SDRAM_BANK_ANY 选已分配
+          次数最少的 bank, 次数相同时 BANK_ROW_COL 选剩余空间最多的, ROW_BANK_COL 选起点
+          填充最少的, 依次分配的缓冲会自动分散到各个 bank.
+          ROW_BANK_COL 映射下缓冲跨越所有 bank, "在 bank b" 指起点在 b 的行段开头.
+ **/
+void *SDRAM_Alloc(uint32_t Bytes, uint8_t Bank) {
+    uint32_t start[SDRAM_INBK_MAX], addr;
+    uint8_t i;
+
+    if(sd_info.Size == 0 || Bytes == 0 || Bytes > sd_info.Size) return NULL;
+
+    Bytes = (Bytes + SDRAM_ALIGN - 1) & ~(uint32_t)(SDRAM_ALIGN - 1);
+
+    for(i = 0; i < sd_info.InBanks; i++) {
+        if(sd_info.Map == SDRAM_MAP_BANK_ROW_COL) {
+            start[i] = i * sd_info.BankSize + sd_used[i];
+
+            if(sd_used[i] + Bytes > sd_info.BankSize) start[i] = sd_info.Size;
+        } else {
+            /* 下一个行段开头, 再往后找到第一个属于 bank i 的行段 */
+            start[i] = (sd_next + sd_info.RowSize - 1) & ~(sd_info.RowSize - 1);
+            start[i] += ((i + sd_info.InBanks - (start[i] / sd_info.RowSize) % sd_info.InBanks) % sd_info.InBanks) *
+                        sd_info.RowSize;
+
+            if(start[i] > sd_info.Size - Bytes) start[i] = sd_info.Size;
+        }
+    }
+
+    if(Bank == SDRAM_BANK_ANY) {
+        for(i = 0; i < sd_info.InBanks; i++) {
+            if(start[i] == sd_info.Size) continue;
+
+            if(Bank == SDRAM_BANK_ANY || sd_count[i] < sd_count[Bank] ||
+                    (sd_count[i] == sd_count[Bank] && sd_info.Map == SDRAM_MAP_BANK_ROW_COL && sd_used[i] < sd_used[Bank]) ||
+                    (sd_count[i] == sd_count[Bank] && sd_info.Map == SDRAM_MAP_ROW_BANK_COL && start[i] < start[Bank])) Bank = i;
+        }
+    }
+
+    if(Bank >= sd_info.InBanks || start[Bank] == sd_info.Size) return NULL;
+
+    if(sd_info.Map == SDRAM_MAP_BANK_ROW_COL) sd_used[Bank] += Bytes;
+    else sd_next = start[Bank] + Bytes;
+
+    sd_count[Bank]++;
+    addr = sd_info.Base + start[Bank];
+
+    return (void *)(uintptr_t)addr;
+}
+
+/**
+  * @Name    SDRAM_FreeAll
+  * @brief   释放全部分配
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void SDRAM_FreeAll(void) {
+    uint8_t i;
+
+    for(i = 0; i < SDRAM_INBK_MAX; i++) {
+        sd_used[i] = 0;
+        sd_count[i] = 0;
+    }
+
+    sd_next = 0;
+}
+
+/**
+  * @Name    SDRAM_BankOf
+  * @brief   地址所在的内部 bank
+  * @param   Addr: SDRAM 中的地址
+  * @retval  内部 bank 号, 不在 SDRAM 中返回 SDRAM_BANK_ANY
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t SDRAM_BankOf(const void *Addr) {
+    uint32_t off = (uint32_t)(uintptr_t)Addr - sd_info.Base;
+
+    if(sd_info.Size == 0 || off >= sd_info.Size) return SDRAM_BANK_ANY;
+
+    if(sd_info.Map == SDRAM_MAP_BANK_ROW_COL) return (uint8_t)(off / sd_info.BankSize);
+
+    return (uint8_t)((off / sd_info.RowSize) % sd_info.InBanks);
+}
+
+static uint32_t SDRAM_Rate(uint32_t Bytes, uint32_t Cycles, uint32_t CpuHz) {
+    return Cycles ? (uint32_t)((uint64_t)Bytes * CpuHz / Cycles / 1024) : 0;
+}
+
+/**
+  * @Name    SDRAM_BenchRun
+  * @brief   测量当前配置的带宽
+  * @param   Buf: 测试缓冲, 顺序写会改写其内容
+  * @param   Bytes: 测试缓冲大小, 每项测试访问 Bytes 字节
+  * @param   Cycles: CPU 周期计数器(DWT->CYCCNT)
+  * @param   CpuHz: 周期计数器的频率
+  * @param   Result: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          按字访问. 由各模板的 SDRAM_Bench 在关中断、打开周期计数后调用.
+          未登记 SDRAM 时结果全为 0.
+ **/
+void SDRAM_BenchRun(void *Buf, uint32_t Bytes, volatile uint32_t *Cycles, uint32_t CpuHz,
+                    SDRAM_BenchResult *Result) {
+    volatile uint32_t *p = (volatile uint32_t *)Buf;
+    volatile uint32_t *b0, *b1;
+    uint32_t n = Bytes / 4, step, area, other, mask, i, t, x, sum = 0;
+
+    Result->SeqWrite = Result->SeqRead = Result->StrideRead = 0;
+    Result->SameBankRead = Result->CrossBankRead = Result->RandRead = 0;
+
+    if(sd_info.Size == 0 || n == 0) return;
+
+    /* step: 同一 bank 的下一行; area: bank 0 各行所在的范围; other: 另一个 bank 的同一行 */
+    if(sd_info.Map == SDRAM_MAP_BANK_ROW_COL) {
+        step = sd_info.RowSize;
+        area = sd_info.BankSize;
+        other = sd_info.BankSize;
+    } else {
+        step = sd_info.RowSize * sd_info.InBanks;
+        area = sd_info.Size;
+        other = sd_info.RowSize;
+    }
+
+    t = *Cycles;
+
+    for(i = 0; i < n; i++) p[i] = i;
+
+    Result->SeqWrite = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    t = *Cycles;
+
+    for(i = 0; i < n; i++) sum += p[i];
+
+    Result->SeqRead = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    /* 每次访问前进一行, 在 bank 0 内循环 */
+    b0 = (volatile uint32_t *)(uintptr_t)sd_info.Base;
+    mask = area / 4 - 1;
+    t = *Cycles;
+
+    for(i = 0; i < n; i++) sum += b0[(i * (step / 4)) & mask];
+
+    Result->StrideRead = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    /* 两个数据流: 相距半个 area, 相同偏移处在同一 bank 的不同行 */
+    b1 = b0 + area / 8;
+    mask = area / 8 - 1;
+    t = *Cycles;
+
+    for(i = 0; i < n; i += 2) sum += b0[(i / 2) & mask] + b1[(i / 2) & mask];
+
+    Result->SameBankRead = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    /* 两个数据流: 相距 other, 相同偏移处在不同 bank */
+    b1 = b0 + other / 4;
+    t = *Cycles;
+
+    for(i = 0; i < n; i += 2) sum += b0[(i / 2) & mask] + b1[(i / 2) & mask];
+
+    Result->CrossBankRead = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    mask = sd_info.Size / 4 - 1;
+    x = 1;
+    t = *Cycles;
+
+    for(i = 0; i < n; i++) {
+        x = x * 1664525 + 1013904223;
+        sum += b0[(x >> 8) & mask];
+    }
+
+    Result->RandRead = SDRAM_Rate(Bytes, *Cycles - t, CpuHz);
+
+    (void)sum;
+}
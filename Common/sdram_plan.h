@@ -0,0 +1,125 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram_plan.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SDRAM 时序换算、按内部 bank 分配和带宽测试
+                   只依赖 stdint.h, 不访问寄存器, AT32/GD32/HC32/SWM32 模板共用.
+                   各模板的 sdram.c(SDRAM_Setup) 选分频、按本控制器的寄存器范围检查换算结果、
+                   写寄存器并执行上电序列, 成功后用 SDRAM_Attach 登记容量和地址映射;
+                   之后的分配、查 bank 和带宽测试都在这里, 与控制器无关.
+                   两种地址映射:
+                     SDRAM_MAP_BANK_ROW_COL: [内部 bank][行][列], 每个内部 bank 是连续的一段
+                                             (AT32 XMC、GD32 EXMC、HC32 DMC 按 BRC 译码);
+                     SDRAM_MAP_ROW_BANK_COL: [行][内部 bank][列], 每行大小的一段轮流落在各个 bank
+                                             (SWM341 SDRAMC, 映射固定).
+                   由 Common/Tools/sdram_plan_test.py 在主机上检查.
+  * Function List:
+                   SDRAM_PickDiv
+                   SDRAM_PlanTiming
+                   SDRAM_Attach
+                   SDRAM_Alloc
+                   SDRAM_FreeAll
+                   SDRAM_BankOf
+                   SDRAM_BenchRun
+  ******************************************************
+**/
+
+#ifndef __SDRAM_PLAN_H_
+#define __SDRAM_PLAN_H_
+
+#include <stdint.h>
+
+#define SDRAM_INBK_MAX          4
+#define SDRAM_BANK_ANY          0xFF            //SDRAM_Alloc 自动选择分配次数最少的 bank
+#define SDRAM_ALIGN             32              //分配对齐, 与 DMA 突发和缓存行一致
+
+/* 地址映射 */
+#define SDRAM_MAP_BANK_ROW_COL  0
+#define SDRAM_MAP_ROW_BANK_COL  1
+
+/* 错误码 */
+#define SDRAM_OK                0
+#define SDRAM_ERR_PARAM         (-1)    //器件参数超出控制器支持的范围
+#define SDRAM_ERR_CLOCK         (-2)    //任何分频下 SDRAM 时钟都超过 MaxHz
+#define SDRAM_ERR_TIMING        (-3)    //时序换算成周期后超出寄存器范围
+#define SDRAM_ERR_REFRESH       (-4)    //刷新间隔太短
+#define SDRAM_ERR_TIMEOUT       (-5)    //控制器命令或上电序列超时
+
+/* 器件参数 */
+typedef struct {
+    uint8_t  Device;            //控制器片选: AT32/GD32 0~1(SDNE0/SDNE1), HC32 0~3, SWM341 只有 0
+    uint8_t  ColBits;           //列地址位数
+    uint8_t  RowBits;           //行地址位数
+    uint8_t  Width;             //数据宽度 8 / 16 / 32
+    uint8_t  InBanks;           //内部 bank 数 2 / 4
+    uint8_t  Cas;               //CAS 延迟 1 / 2 / 3
+    uint8_t  ReadBurst;         //1: 读请求合并为突发, 顺序读更快
+    uint8_t  ReadDelay;         //读数据采样延迟(HCLK 周期), 只有 AT32/GD32 使用
+    uint32_t MaxHz;             //器件在该 CAS 下的最高时钟
+    uint16_t tRCD;              //以下单位均为 ns
+    uint16_t tRP;
+    uint16_t tRC;               //同时用作自动刷新周期 tRFC
+    uint16_t tRAS;
+    uint16_t tXSR;
+    uint16_t tWR;
+    uint8_t  tMRD;              //单位: 时钟周期
+    uint16_t RefreshMs;         //刷新周期, 一般 64ms
+    uint16_t RefreshRows;       //刷新周期内的刷新次数(行数), 一般 4096 / 8192
+} SDRAM_Config;
+
+/* 换算成 SDRAM 时钟周期的时序 */
+typedef struct {
+    uint32_t tRCD;
+    uint32_t tRP;
+    uint32_t tRC;
+    uint32_t tRAS;
+    uint32_t tXSR;
+    uint32_t tWR;               //已满足 tWR >= tRAS - tRCD 和 tWR >= tRC - tRCD - tRP
+    uint32_t Refresh;           //两次自动刷新之间的周期数, 未扣控制器要求的余量
+} SDRAM_Timing;
+
+/* 初始化结果 */
+typedef struct {
+    uint32_t Base;
+    uint32_t Size;
+    uint32_t ClockHz;
+    uint32_t BankSize;          //每个内部 bank 的字节数
+    uint32_t RowSize;           //每行字节数
+    uint16_t Refresh;           //写入刷新寄存器的值
+    uint8_t  Div;               //SDRAM 时钟 = 控制器输入时钟 / Div
+    uint8_t  InBanks;
+    uint8_t  Map;               //SDRAM_MAP_xxx
+} SDRAM_Info;
+
+/* 带宽测试结果, 单位: KB/s */
+typedef struct {
+    uint32_t SeqWrite;          //测试缓冲内顺序写
+    uint32_t SeqRead;           //测试缓冲内顺序读
+    uint32_t StrideRead;        //每次访问都换到同一 bank 的下一行
+    uint32_t SameBankRead;      //同一 bank 内两个不同行的数据流交替读, 模拟两个缓冲放在同一 bank
+    uint32_t CrossBankRead;     //两个 bank 内的数据流交替读, 各自保持打开的行
+    uint32_t RandRead;          //全片随机读
+} SDRAM_BenchResult;
+
+/* 常用器件: W9825G6KH-6(32MB, 16 位, 4 bank), 接在片选 0 */
+#define SDRAM_W9825G6KH_CONFIG  {0, 9, 13, 16, 4, 3, 1, 1, 166000000, \
+                                 18, 18, 60, 42, 72, 12, 2, 64, 8192}
+
+uint8_t SDRAM_PickDiv(uint32_t InHz, uint32_t MaxHz, uint8_t DivMin, uint8_t DivMax);
+int32_t SDRAM_PlanTiming(const SDRAM_Config *Config, uint32_t Hz, SDRAM_Timing *Timing);
+int32_t SDRAM_Attach(const SDRAM_Info *Info);
+void *SDRAM_Alloc(uint32_t Bytes, uint8_t Bank);
+void SDRAM_FreeAll(void);
+uint8_t SDRAM_BankOf(const void *Addr);
+void SDRAM_BenchRun(void *Buf, uint32_t Bytes, volatile uint32_t *Cycles, uint32_t CpuHz,
+                    SDRAM_BenchResult *Result);
+
+#endif
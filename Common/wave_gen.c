@@ -0,0 +1,247 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_gen.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 波形播放的公共部分
+                   1. 采样率: 先取能放下的最小分频, 再四舍五入周期, 误差不超过半个计数周期;
+                      只支持 2 的幂分频的定时器(HC32 TMR0)按 2 的幂取分频;
+                   2. 流播放: 两块连续存放, DMA 播完一块就在中断里把这一块交给回调; 回调返回后
+                      DMA 若已回到这一块, 说明这一块播放时还没填好, 计一次欠载;
+                   3. 波形表由 Wave_GenXxx 一次算好, 之后只由 DMA 读取.
+  * Function List:
+
+  **********************************************************
+ */
+#include "wave_gen.h"
+#include "math.h"
+
+/**
+  * @Name    Wave_PlanRate
+  * @brief   采样率换算成定时器分频和周期
+  * @param   Clock: 定时器计数时钟(Hz)
+  * @param   Rate: 采样率(Hz), 0 按 1 处理
+  * @param   DivMax: 定时器支持的最大分频
+  * @param   Pow2: 1: 分频只能是 2 的幂(DivMax 也须是 2 的幂); 0: 1~DivMax 任意
+  * @param   Div: 输出分频, 写入预分频寄存器时按各定时器的格式换算
+  * @param   Period: 输出周期计数 2~WAVE_MAX_PERIOD
+  * @retval  实际采样率(Hz, 向下取整)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          超出范围时取最接近的一端.
+ **/
+uint32_t Wave_PlanRate(uint32_t Clock, uint32_t Rate, uint32_t DivMax, uint8_t Pow2,
+                       uint32_t *Div, uint32_t *Period) {
+    uint32_t ticks, div, period;
+
+    if(Rate == 0) Rate = 1;
+
+    if(DivMax == 0) DivMax = 1;
+
+    ticks = (uint32_t)(((uint64_t)Clock + Rate / 2) / Rate);
+
+    if(ticks < 2) ticks = 2;
+
+    if(Pow2) {
+        for(div = 1; div < DivMax && (ticks - 1) / div >= WAVE_MAX_PERIOD; div <<= 1);
+    } else {
+        div = (ticks - 1) / WAVE_MAX_PERIOD + 1;
+
+        if(div > DivMax) div = DivMax;
+    }
+
+    period = (ticks + div / 2) / div;
+
+    if(period < 2) period = 2;
+
+    if(period > WAVE_MAX_PERIOD) period = WAVE_MAX_PERIOD;
+
+    *Div = div;
+    *Period = period;
+
+    return (uint32_t)((uint64_t)Clock / ((uint64_t)div * period));
+}
+
+/**
+  * @Name    Wave_StreamStart
+  * @brief   开始流播放前填满两块并清零统计
+  * @param   Stream: 流播放状态
+  * @param   Buf: 两块连续的缓冲, 共 2 * Samples 个样本
+  * @param   Samples: 每块样本数
+  * @param   SampleBytes: 每个样本的字节数, WAVE_SAMPLE_BYTES(通道)
+  * @param   Callback: 填块回调, 先填第 0 块再填第 1 块
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DacUnderruns 从 Wave_Init 起累计, 这里不清零.
+ **/
+void Wave_StreamStart(Wave_Stream *Stream, void *Buf, uint32_t Samples, uint32_t SampleBytes,
+                      Wave_RefillCallback Callback) {
+    Stream->Buf = (uint8_t *)Buf;
+    Stream->Samples = Samples;
+    Stream->BlockBytes = Samples * SampleBytes;
+    Stream->Callback = Callback;
+    Stream->Stats.Blocks = 0;
+    Stream->Stats.Underruns = 0;
+    Stream->Stats.LastCycles = 0;
+    Stream->Stats.MaxCycles = 0;
+
+    if(Callback == 0) return;
+
+    Callback(Stream->Buf, Samples);
+    Callback(Stream->Buf + Stream->BlockBytes, Samples);
+}
+
+/**
+  * @Name    Wave_StreamDone
+  * @brief   一块播完后刷新这一块
+  * @param   Stream: 流播放状态
+  * @param   Done: 刚播完的块 0 / 1
+  * @param   Playing: 返回 DMA 当前所在的块 0 / 1, 回调返回后调用
+  * @param   Cycles: CPU 周期计数器(DWT->CYCCNT)
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          由各模板的 Wave_DMA_IRQHandler 在清除块完成标志后调用; 表播放(Callback 为 0)时直接返回.
+ **/
+void Wave_StreamDone(Wave_Stream *Stream, uint8_t Done, uint8_t (*Playing)(void), volatile uint32_t *Cycles) {
+    uint32_t start, cycles;
+
+    if(Stream->Callback == 0) return;
+
+    start = *Cycles;
+    Stream->Callback(Stream->Buf + (Done ? Stream->BlockBytes : 0), Stream->Samples);
+
+    if(Playing() == Done) Stream->Stats.Underruns++;
+
+    cycles = *Cycles - start;
+    Stream->Stats.LastCycles = cycles;
+
+    if(cycles > Stream->Stats.MaxCycles) Stream->Stats.MaxCycles = cycles;
+
+    Stream->Stats.Blocks++;
+}
+
+/**
+  * @Name    Wave_GenSine
+  * @brief   生成一个周期的正弦表
+  * @param   Table: 输出
+  * @param   Samples: 样本数
+  * @param   Amplitude: 峰值
+  * @param   Offset: 中心值, Offset ± Amplitude 超出 0~WAVE_FULL_SCALE 的部分削顶
+  * @param   Phase: 起始相位, 65536 为一周
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Wave_GenSine(uint16_t *Table, uint32_t Samples, uint16_t Amplitude, uint16_t Offset, uint16_t Phase) {
+    const float two_pi = 6.28318530718f;
+    float v;
+    uint32_t i;
+
+    for(i = 0; i < Samples; i++) {
+        v = (float)Offset + (float)Amplitude * sinf(two_pi * ((float)i / (float)Samples + (float)Phase / 65536.0f));
+
+        if(v < 0.0f) v = 0.0f;
+
+        if(v > (float)WAVE_FULL_SCALE) v = (float)WAVE_FULL_SCALE;
+
+        Table[i] = (uint16_t)(v + 0.5f);
+    }
+}
+
+/**
+  * @Name    Wave_GenSaw
+  * @brief   生成一个周期的锯齿表
+  * @param   Table: 输出
+  * @param   Samples: 样本数
+  * @param   Low: 起点
+  * @param   High: 终点, 小于 Low 时为下降锯齿
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          最后一个样本比 High 少一阶, 循环播放时回到 Low 不会重复端点.
+ **/
+void Wave_GenSaw(uint16_t *Table, uint32_t Samples, uint16_t Low, uint16_t High) {
+    int32_t span = (int32_t)High - (int32_t)Low;
+    uint32_t i;
+
+    for(i = 0; i < Samples; i++) {
+        Table[i] = (uint16_t)((int32_t)Low + (int32_t)((int64_t)span * i / Samples));
+    }
+}
+
+/**
+  * @Name    Wave_GenArbitrary
+  * @brief   按断点线性插值生成一个周期
+  * @param   Table: 输出
+  * @param   Samples: 样本数
+  * @param   Points: 断点, 相位递增
+  * @param   NumPoints: 断点数, 至少 1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          最后一个断点到下一周期第一个断点之间也插值, 波形首尾连续.
+ **/
+void Wave_GenArbitrary(uint16_t *Table, uint32_t Samples, const Wave_Point *Points, uint32_t NumPoints) {
+    uint32_t i, k = 0, phase, x0, x1;
+    int32_t y0, y1;
+
+    if(NumPoints == 0) return;
+
+    for(i = 0; i < Samples; i++) {
+        phase = (uint32_t)(((uint64_t)i << 16) / Samples);
+
+        while(k + 1 < NumPoints && Points[k + 1].Phase <= phase) k++;
+
+        if(phase < Points[0].Phase) {
+            /* 第一个断点之前: 上一周期末点到首点 */
+            x0 = Points[NumPoints - 1].Phase;
+            x1 = Points[0].Phase + 65536;
+            y0 = Points[NumPoints - 1].Value;
+            y1 = Points[0].Value;
+            phase += 65536;
+        } else {
+            x0 = Points[k].Phase;
+            x1 = k + 1 < NumPoints ? Points[k + 1].Phase : Points[0].Phase + 65536;
+            y0 = Points[k].Value;
+            y1 = k + 1 < NumPoints ? Points[k + 1].Value : Points[0].Value;
+        }
+
+        Table[i] = (uint16_t)(x1 == x0 ? y0 : y0 + (int32_t)((int64_t)(y1 - y0) * (int32_t)(phase - x0) / (int32_t)(x1 - x0)));
+    }
+}
+
+/**
+  * @Name    Wave_Pack
+  * @brief   两路单通道表合成双通道表
+  * @param   Dual: 输出, 低 16 位第一路, 高 16 位第二路
+  * @param   Ch0: 第一路
+  * @param   Ch1: 第二路, 与 Ch0 相同长度
+  * @param   Samples: 样本数
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Wave_Pack(uint32_t *Dual, const uint16_t *Ch0, const uint16_t *Ch1, uint32_t Samples) {
+    uint32_t i;
+
+    for(i = 0; i < Samples; i++) {
+        Dual[i] = (uint32_t)Ch0[i] | ((uint32_t)Ch1[i] << 16);
+    }
+}
@@ -0,0 +1,92 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_gen.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 波形播放的公共部分: 波形表生成、采样率换算和流播放的块管理
+                   只依赖 stdint.h, 不访问寄存器, STM32/GD32/AT32/HC32 模板共用.
+                   各模板的 wave_player.c 提供同样的 Wave_Init / Wave_PlayTable / Wave_PlayStream /
+                   Wave_SetRate / Wave_Stop / Wave_DMA_IRQHandler / Wave_GetStats, 只负责定时器、
+                   DMA 和 DAC 寄存器; 采样率用 Wave_PlanRate 换算, 块完成中断交给 Wave_StreamDone.
+                   样本格式各系列相同: 12 位右对齐; 单通道 uint16_t; 双通道 uint32_t,
+                   低 16 位第一路、高 16 位第二路(见 Wave_Pack).
+                   由 Common/Tools/wave_gen_test.py 在主机上检查.
+  * Function List:
+                   Wave_PlanRate
+                   Wave_StreamStart
+                   Wave_StreamDone
+                   Wave_GenSine
+                   Wave_GenSaw
+                   Wave_GenArbitrary
+                   Wave_Pack
+  ******************************************************
+**/
+
+#ifndef __WAVE_GEN_H_
+#define __WAVE_GEN_H_
+
+#include <stdint.h>
+
+#define WAVE_FULL_SCALE         4095    //12 位右对齐
+#define WAVE_MAX_SAMPLES        65535   //表长和流播放每块样本数的上限(DMA 计数寄存器 16 位)
+#define WAVE_MAX_PERIOD         65536   //定时器周期计数上限
+
+/* 通道, 可按位组合; 引脚见各模板 wave_player.h */
+#define WAVE_CH0                0x01    //第一路 DAC 输出
+#define WAVE_CH1                0x02    //第二路 DAC 输出
+#define WAVE_CH_BOTH            (WAVE_CH0 | WAVE_CH1)
+
+/* 每个样本的字节数 */
+#define WAVE_SAMPLE_BYTES(ch)   ((ch) == WAVE_CH_BOTH ? 4 : 2)
+
+/* 错误码 */
+#define WAVE_OK                 0
+#define WAVE_ERR_PARAM          (-1)    //通道参数错误
+#define WAVE_ERR_BUSY           (-2)    //触发连线或中断号已被其他代码占用(HC32)
+
+/* 流回调: 填满 Buf 中的 Samples 个样本, 在 DMA 中断中调用 */
+typedef void (*Wave_RefillCallback)(void *Buf, uint32_t Samples);
+
+/* 任意波形断点: 一个周期内按相位线性插值, 末点与首点相连 */
+typedef struct {
+    uint16_t Phase;             //0~65535 对应一个周期, 须递增
+    uint16_t Value;             //0~WAVE_FULL_SCALE
+} Wave_Point;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t Blocks;            //流播放已填的块数
+    uint32_t Underruns;         //回调没赶上, 播放了未刷新的块
+    uint32_t DacUnderruns;      //DAC 触发时 DMA 未送到数据; HC32 的 DAC 不发 DMA 请求, 始终为 0
+    uint32_t LastCycles;        //最近一次回调耗时(CPU 周期)
+    uint32_t MaxCycles;
+} Wave_Stats;
+
+/* 流播放状态: Buf 是连续的两块, 第 0 块在前 */
+typedef struct {
+    uint8_t *Buf;
+    uint32_t Samples;           //每块样本数
+    uint32_t BlockBytes;
+    Wave_RefillCallback Callback;
+    Wave_Stats Stats;
+} Wave_Stream;
+
+uint32_t Wave_PlanRate(uint32_t Clock, uint32_t Rate, uint32_t DivMax, uint8_t Pow2,
+                       uint32_t *Div, uint32_t *Period);
+void Wave_StreamStart(Wave_Stream *Stream, void *Buf, uint32_t Samples, uint32_t SampleBytes,
+                      Wave_RefillCallback Callback);
+void Wave_StreamDone(Wave_Stream *Stream, uint8_t Done, uint8_t (*Playing)(void), volatile uint32_t *Cycles);
+
+void Wave_GenSine(uint16_t *Table, uint32_t Samples, uint16_t Amplitude, uint16_t Offset, uint16_t Phase);
+void Wave_GenSaw(uint16_t *Table, uint32_t Samples, uint16_t Low, uint16_t High);
+void Wave_GenArbitrary(uint16_t *Table, uint32_t Samples, const Wave_Point *Points, uint32_t NumPoints);
+void Wave_Pack(uint32_t *Dual, const uint16_t *Ch0, const uint16_t *Ch1, uint32_t Samples);
+
+#endif
@@ -0,0 +1,263 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_bus.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 中断驱动的 CAN 收发, GD32 CAN 寄存器部分
+                   1. 接收中断直接读邮箱寄存器, 一次把硬件 FIFO(3 级)读空, 每帧读进
+                      CANQueue_RxSlot 给出的环形缓冲区空位;
+                   2. 发送完成中断清标志后把完成的邮箱交给 CANQueue_TxDone, 写邮箱和中止请求
+                      由 Common/can_queue.c 经回调发起.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_bus.h"
+#include "string.h"
+
+static CANQueue cb_bus[2];
+static const uint32_t cb_can[2] = {CAN0, CAN1};
+
+static CANQueue *CANBus_Get(uint32_t CANx) {
+    return &cb_bus[CANx == CAN1 ? 1 : 0];
+}
+
+/**
+  * @Name    CANBus_Write
+  * @brief   写发送邮箱并请求发送
+  * @param   Q: 队列
+  * @param   Mailbox: 0~2
+  * @param   Frame: 帧
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void CANBus_Write(CANQueue *Q, uint8_t Mailbox, const CANBus_Frame *Frame) {
+    uint32_t CANx = cb_can[Q - cb_bus];
+    uint32_t word[2];
+
+    memcpy(word, Frame->Data, 8);
+
+    CAN_TMP(CANx, Mailbox) = Frame->Dlc & 0x0F;
+    CAN_TMDATA0(CANx, Mailbox) = word[0];
+    CAN_TMDATA1(CANx, Mailbox) = word[1];
+    CAN_TMI(CANx, Mailbox) = (Frame->Ext ? ((Frame->Id << 3) | CAN_TMI_FF) : (Frame->Id << 21)) |
+                             (Frame->Rtr ? CAN_TMI_FT : 0) | CAN_TMI_TEN;
+}
+
+static void CANBus_Abort(CANQueue *Q, uint8_t Mailbox) {
+    CAN_TSTAT(cb_can[Q - cb_bus]) = CAN_TSTAT_MST0 << (8 * Mailbox);
+}
+
+static const CANQueue_Port cb_port = {CANBus_Write, CANBus_Abort};
+
+/**
+  * @Name    CANBus_Init
+  * @brief   初始化 CAN、过滤器组和中断
+  * @param   CANx: CAN0 或 CAN1
+  * @param   InitStruct: 位时序等参数, 直接传给 CAN_Init
+  * @param   Table: CANFilter_Compile 的结果, NULL 时接收全部帧到类别 0
+  * @param   StartBank: 第一个过滤器组编号
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器组由 CANFilter_Load 写入, CAN0 可用 StartBank ~ HBC1F-1 组(复位值 14);
+          CAN1 会把 StartBank 写入 HBC1F, 独占 StartBank ~ 27 组, 应先初始化 CAN0.
+ **/
+ErrStatus CANBus_Init(uint32_t CANx, CAN_Parameter_Struct *InitStruct,
+                        const CANFilter_Table *Table, uint8_t StartBank) {
+    uint8_t offset[2];
+    uint8_t irq[3];
+    uint8_t i;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    if(StartBank + Table->NumBanks > CANFILTER_MAX_BANKS) return ERROR;
+
+    /* 过滤器在 CAN0 中, 只用 CAN1 时也要打开 CAN0 时钟 */
+    RCU_Periph_Clock_Enable(RCU_CAN0);
+
+    if(CANx == CAN1) RCU_Periph_Clock_Enable(RCU_CAN1);
+
+    if(CAN_Init(CANx, InitStruct) != SUCCESS) return ERROR;
+
+    if(CANFilter_Load(CANx, Table, StartBank, offset) != SUCCESS) return ERROR;
+
+    CANQueue_Init(CANBus_Get(CANx), &cb_port, Table, offset);
+
+    if(CANx == CAN1) {
+        irq[0] = CAN1_RX0_IRQn;
+        irq[1] = CAN1_RX1_IRQn;
+        irq[2] = CAN1_TX_IRQn;
+    } else {
+        irq[0] = CAN0_RX0_IRQn;
+        irq[1] = CAN0_RX1_IRQn;
+        irq[2] = CAN0_TX_IRQn;
+    }
+
+    /* 三个中断同一优先级, 互不抢占 */
+    for(i = 0; i < 3; i++) {
+        NVIC_irq_Enable(irq[i], CANBUS_IRQ_PRIORITY, 0);
+    }
+
+    /* TMEIE 常开: 只有 MTFx 置位时才进中断 */
+    CAN_INTEN(CANx) |= CAN_INTEN_RFNEIE0 | CAN_INTEN_RFOIE0 | CAN_INTEN_RFNEIE1 | CAN_INTEN_RFOIE1 | CAN_INTEN_TMEIE;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    CANBus_Send
+  * @brief   帧入发送队列
+  * @param   CANx: CAN0 或 CAN1
+  * @param   Frame: 帧, Class 和 Time 不使用
+  * @retval  SUCCESS / ERROR(队列满)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只屏蔽本 CAN 的 TMEIE, 不关全局中断; 不可重入, 只能在一个上下文中调用.
+ **/
+ErrStatus CANBus_Send(uint32_t CANx, const CANBus_Frame *Frame) {
+    ErrStatus status;
+
+    CAN_INTEN(CANx) &= ~CAN_INTEN_TMEIE;
+    status = CANQueue_Send(CANBus_Get(CANx), Frame) ? SUCCESS : ERROR;
+    CAN_INTEN(CANx) |= CAN_INTEN_TMEIE;
+
+    return status;
+}
+
+/**
+  * @Name    CANBus_Receive
+  * @brief   取一帧, 类别 0 优先
+  * @param   CANx: CAN0 或 CAN1
+  * @param   Frame: 输出
+  * @retval  1: 取到; 0: 无数据
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t CANBus_Receive(uint32_t CANx, CANBus_Frame *Frame) {
+    return CANQueue_Receive(CANBus_Get(CANx), Frame);
+}
+
+/**
+  * @Name    CANBus_Drain
+  * @brief   读空一个接收 FIFO
+  * @param   CANx: CAN0 或 CAN1
+  * @param   FIFO: 0 或 1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          环形缓冲区满时照样释放邮箱, 丢弃的帧由 CANQueue_RxSlot 计入 RxOverflow.
+ **/
+static void CANBus_Drain(uint32_t CANx, uint8_t FIFO) {
+    CANQueue *Q = CANBus_Get(CANx);
+    volatile uint32_t *rfr = FIFO ? &CAN_RFIFO1(CANx) : &CAN_RFIFO0(CANx);
+    CANBus_Frame *f;
+    uint32_t rir, rdtr, word[2];
+
+    while(*rfr & CAN_RFIFO0_RFL0) {
+        rir = CAN_RFIFOMI(CANx, FIFO);
+        rdtr = CAN_RFIFOMP(CANx, FIFO);
+        f = CANQueue_RxSlot(Q, FIFO, (uint8_t)((rdtr & CAN_RFIFOMP_FI) >> 8));
+
+        if(f) {
+            f->Ext = (rir & CAN_RFIFOMI_FF) ? 1 : 0;
+            f->Id = f->Ext ? (rir >> 3) : (rir >> 21);
+            f->Rtr = (rir & CAN_RFIFOMI_FT) ? 1 : 0;
+            f->Dlc = (uint8_t)(rdtr & CAN_RFIFOMP_DLENC);
+            f->Time = (uint16_t)(rdtr >> 16);
+            word[0] = CAN_RFIFOMDATA0(CANx, FIFO);
+            word[1] = CAN_RFIFOMDATA1(CANx, FIFO);
+            memcpy(f->Data, word, 8);
+
+            CANQueue_RxCommit(Q, f);
+        }
+
+        *rfr = CAN_RFIFO0_RFD0;
+    }
+
+    if(*rfr & CAN_RFIFO0_RFO0) {
+        CANQueue_FifoOverrun(Q, FIFO);
+        *rfr = CAN_RFIFO0_RFO0;
+    }
+}
+
+/**
+  * @Name    CANBus_RX0_IRQHandler
+  * @brief   在 CANx_RX0_IRQHandler 中调用
+  * @param   CANx: CAN0 或 CAN1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_RX0_IRQHandler(uint32_t CANx) {
+    CANBus_Drain(CANx, 0);
+}
+
+/**
+  * @Name    CANBus_RX1_IRQHandler
+  * @brief   在 CANx_RX1_IRQHandler 中调用
+  * @param   CANx: CAN0 或 CAN1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_RX1_IRQHandler(uint32_t CANx) {
+    CANBus_Drain(CANx, 1);
+}
+
+/**
+  * @Name    CANBus_TX_IRQHandler
+  * @brief   在 CANx_TX_IRQHandler 中调用
+  * @param   CANx: CAN0 或 CAN1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          清除完成标志后交给 CANQueue_TxDone, 被中止的帧在那里重新入队.
+ **/
+void CANBus_TX_IRQHandler(uint32_t CANx) {
+    uint32_t tsr = CAN_TSTAT(CANx);
+    uint8_t mb, done = 0, ok = 0;
+
+    for(mb = 0; mb < 3; mb++) {
+        if(!(tsr & (CAN_TSTAT_MTF0 << (8 * mb)))) continue;
+
+        /* 清 MTF 同时清 MTFNERR/MAL/MTE */
+        CAN_TSTAT(CANx) = CAN_TSTAT_MTF0 << (8 * mb);
+        done |= (uint8_t)(1U << mb);
+
+        if(tsr & (CAN_TSTAT_MTFNERR0 << (8 * mb))) ok |= (uint8_t)(1U << mb);
+    }
+
+    CANQueue_TxDone(CANBus_Get(CANx), done, ok);
+}
+
+/**
+  * @Name    CANBus_GetStats
+  * @brief   读取运行统计
+  * @param   CANx: CAN0 或 CAN1
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_GetStats(uint32_t CANx, CANBus_Stats *Stats) {
+    *Stats = CANBus_Get(CANx)->Stats;
+}
@@ -0,0 +1,99 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN 过滤器组写入
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_filter_hw.h"
+#include "stddef.h"
+
+/**
+  * @Name    CANFilter_Load
+  * @brief   装入过滤器组
+  * @param   CANx: CAN0 或 CAN1
+  * @param   Table: CANFilter_Compile 的结果, NULL 时用 CANFilter_AcceptAll
+  * @param   StartBank: 第一个过滤器组编号
+  * @param   FMIOffset: 输出, 每个 FIFO 中 StartBank 之前各组占用的过滤器编号数
+  * @retval  SUCCESS / ERROR(组数超出本 CAN 的范围)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器寄存器只在 CAN0 中. CAN0 可用 StartBank ~ HBC1F-1 组(复位值 14);
+          CAN1 会把 StartBank 写入 HBC1F, 独占 StartBank ~ 27 组, 应先装入 CAN0.
+          本 CAN 范围内未使用的组关闭.
+ **/
+ErrStatus CANFilter_Load(uint32_t CANx, const CANFilter_Table *Table, uint8_t StartBank,
+                         uint8_t FMIOffset[2]) {
+    const CANFilter_Bank *b;
+    uint8_t bank, end, fifo;
+    uint32_t bit;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    if(StartBank + Table->NumBanks > CANFILTER_MAX_BANKS) return ERROR;
+
+    CAN_FCTL(CAN0) |= CAN_FCTL_FLD;
+
+    if(CANx == CAN1) {
+        CAN_FCTL(CAN0) = (CAN_FCTL(CAN0) & ~CAN_FCTL_HBC1F) | ((uint32_t)StartBank << 8);
+        end = CANFILTER_MAX_BANKS;
+    } else {
+        end = (uint8_t)((CAN_FCTL(CAN0) & CAN_FCTL_HBC1F) >> 8);
+    }
+
+    if(StartBank + Table->NumBanks > end) {
+        CAN_FCTL(CAN0) &= ~CAN_FCTL_FLD;
+        return ERROR;
+    }
+
+    for(bank = StartBank; bank < end; bank++) {
+        bit = 1U << bank;
+        CAN_FW(CAN0) &= ~bit;
+
+        if(bank >= StartBank + Table->NumBanks) continue;
+
+        b = &Table->Bank[bank - StartBank];
+
+        if(b->Mode == CANFILTER_MODE_LIST) CAN_FMCFG(CAN0) |= bit;
+        else CAN_FMCFG(CAN0) &= ~bit;
+
+        if(b->Scale == CANFILTER_SCALE_32BIT) CAN_FSCFG(CAN0) |= bit;
+        else CAN_FSCFG(CAN0) &= ~bit;
+
+        if(b->FIFO) CAN_FAFIFO(CAN0) |= bit;
+        else CAN_FAFIFO(CAN0) &= ~bit;
+
+        CAN_FDATA0(CAN0, bank) = b->FR1;
+        CAN_FDATA1(CAN0, bank) = b->FR2;
+        CAN_FW(CAN0) |= bit;
+    }
+
+    /* FMI 在同一 FIFO 内跨所有组连续编号, 前面各组占用的编号:
+       32 位掩码 1 个, 32 位列表和 16 位掩码 2 个, 16 位列表 4 个 */
+    FMIOffset[0] = 0;
+    FMIOffset[1] = 0;
+
+    for(bank = 0; bank < StartBank; bank++) {
+        bit = 1U << bank;
+        fifo = (CAN_FAFIFO(CAN0) & bit) ? 1 : 0;
+
+        if(CAN_FSCFG(CAN0) & bit) FMIOffset[fifo] += (CAN_FMCFG(CAN0) & bit) ? 2 : 1;
+        else FMIOffset[fifo] += (CAN_FMCFG(CAN0) & bit) ? 4 : 2;
+    }
+
+    CAN_FCTL(CAN0) &= ~CAN_FCTL_FLD;
+
+    return SUCCESS;
+}
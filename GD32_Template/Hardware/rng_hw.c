@@ -0,0 +1,139 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TRNG 外设接到 Common/rng_pool 的随机数池
+                   1. TRNGIE 同时打开数据就绪和种子/时钟错误中断, 中断每次取一个字交给 Rng_Feed;
+                   2. 池满关 TRNG 中断, 消费侧取数后经 Resume 再打开.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rng_hw.h"
+
+static Rng_Pool rng_state;
+
+/**
+  * @Name    rng_lock
+  * @brief   关中断
+  * @param   None
+  * @retval  之前的 PRIMASK
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint32_t rng_lock(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+}
+
+/**
+  * @Name    rng_unlock
+  * @brief   恢复中断状态
+  * @param   State: rng_lock 的返回值
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_unlock(uint32_t State) {
+    __set_PRIMASK(State);
+}
+
+/**
+  * @Name    rng_resume
+  * @brief   池有空位, 重新打开 TRNG 中断
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_resume(void) {
+    TRNG_Interrupt_Enable();
+}
+
+/**
+  * @Name    rng_halt
+  * @brief   判定硬件故障, 关闭 TRNG
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_halt(void) {
+    TRNG_Interrupt_Disable();
+    TRNG_Disable();
+}
+
+static const Rng_Port rng_port = {rng_lock, rng_unlock, rng_resume, rng_halt};
+
+/**
+  * @Name    Rng_IRQHandler
+  * @brief   TRNG 中断, 在 TRNG_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          种子错误按手册清标志并重新使能 TRNG, 时钟错误由硬件自行恢复; 两者都交给 Rng_Fault.
+ **/
+void Rng_IRQHandler(void) {
+    uint32_t stat = TRNG_STAT;
+
+    if(stat & (TRNG_STAT_SEIF | TRNG_STAT_CEIF)) {
+        if(stat & TRNG_STAT_SEIF) {
+            TRNG_Interrupt_Flag_Clear(TRNG_INT_Flag_SEIF);
+            TRNG_Disable();
+            TRNG_Enable();
+            Rng_Fault(RNG_FAULT_SEED);
+        }
+
+        if(stat & TRNG_STAT_CEIF) {
+            TRNG_Interrupt_Flag_Clear(TRNG_INT_Flag_CEIF);
+            Rng_Fault(RNG_FAULT_CLOCK);
+        }
+
+        return;
+    }
+
+    if((stat & TRNG_STAT_DRDY) == 0) return;
+
+    if(Rng_Feed(TRNG_Get_true_random_data())) TRNG_Interrupt_Disable();
+}
+
+/**
+  * @Name    Rng_Init
+  * @brief   启动 TRNG, 等待启动检测完成并取得第一个种子
+  * @param   None
+  * @retval  SUCCESS; 硬件反复检测失败或超时时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+ErrStatus Rng_Init(void) {
+    Rng_PoolInit(&rng_state, &rng_port);
+
+    RCU_Periph_Clock_Enable(RCU_TRNG);
+    TRNG_DeInit();
+
+    NVIC_irq_Enable(TRNG_IRQn, RNG_IRQ_PRIORITY, 0);
+
+    TRNG_Enable();
+    TRNG_Interrupt_Enable();
+
+    return Rng_PoolStart(SystemCoreClock / 100) == RNG_OK ? SUCCESS : ERROR;
+}
@@ -0,0 +1,33 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TRNG 外设接到 Common/rng_pool 的随机数池
+                   池、健康检测和 ChaCha20 在 Common/rng_pool.c, 这里只管 TRNG 时钟、中断和取数;
+                   Rng_Fill / Rng_Raw / Rng_Available / Rng_TlsCallback / Rng_GetStats 见 rng_pool.h.
+  * Function List:
+                   Rng_Init
+                   Rng_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __RNG_HW_H_
+#define __RNG_HW_H_
+
+#include "gd32f4xx.h"
+#include "rng_pool.h"
+
+#define RNG_IRQ_PRIORITY        6       //后台补充, 优先级放低
+
+ErrStatus Rng_Init(void);
+void Rng_IRQHandler(void);
+
+#endif
@@ -0,0 +1,181 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : EXMC 外部 SDRAM
+                   1. SDRAM 时钟 = HCLK / 分频(2/3), 取不超过 MaxHz 的最小分频;
+                   2. 时序由 SDRAM_PlanTiming 换算, 超过 16 个周期时返回 SDRAM_ERR_TIMING;
+                      EXMC_sdram_Init 自己减 1, 这里填周期数;
+                   3. 刷新计数 = 刷新间隔 - 20, 20 个周期留给正在进行的访问.
+  * Function List:
+
+  **********************************************************
+ */
+#include "sdram.h"
+#include "stddef.h"
+
+#define SDRAM_REFRESH_MIN       41      //刷新计数下限
+#define SDRAM_REFRESH_MAX       0x1FFF
+#define SDRAM_REFRESH_MARGIN    20
+
+static int32_t SDRAM_Command(uint32_t Cmd, uint32_t Device, uint32_t Refresh, uint32_t Data) {
+    EXMC_sdram_command_Parameter_Struct cmd;
+    uint32_t timeout = SDRAM_TIMEOUT;
+
+    cmd.command = Cmd;
+    cmd.bank_select = Device == EXMC_SDRAM_DEVICE0 ? EXMC_SDRAM_DEVICE0_SELECT : EXMC_SDRAM_DEVICE1_SELECT;
+    cmd.auto_refresh_number = Refresh;
+    cmd.mode_Register_content = Data;
+    EXMC_sdram_command_Config(&cmd);
+
+    while(EXMC_Flag_Get(Device, EXMC_SDRAM_Flag_NREADY) != RESET) {
+        if(--timeout == 0) return SDRAM_ERR_TIMEOUT;
+    }
+
+    return SDRAM_OK;
+}
+
+/**
+  * @Name    SDRAM_Setup
+  * @brief   按器件参数初始化 SDRAM
+  * @param   Config: 器件参数, Device 0 / 1 对应 EXMC_SDRAM_DEVICE0 / EXMC_SDRAM_DEVICE1
+  * @param   Info: 输出实际时钟、容量和刷新计数, 可以为 NULL
+  * @retval  SDRAM_OK / SDRAM_ERR_xxx
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在系统时钟配置完成后调用, 改变 HCLK 后须重新调用. 初始化会清空分配器.
+          支持列 8~11 位、行 11~13 位、8/16/32 位宽、CAS 1~3、ReadDelay 0~2.
+          两个片选共用 SDCLK 分频和 tRC/tRP/tWR(写在 DEVICE0 的寄存器里), 两片都接时用相同的器件参数.
+          模式寄存器: 突发长度 1、顺序突发、写为单次访问, 连续访问由控制器合并.
+ **/
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info) {
+    EXMC_sdram_Parameter_Struct init;
+    EXMC_sdram_timing_Parameter_Struct timing;
+    SDRAM_Timing t;
+    SDRAM_Info info;
+    uint32_t hclk, hz, device, refresh, i;
+    int32_t ret;
+    uint8_t div;
+
+    (void)SDRAM_Attach(NULL);
+
+    if(Config->Device > 1 || Config->ColBits < 8 || Config->ColBits > 11 || Config->RowBits < 11 ||
+            Config->RowBits > 13 || (Config->Width != 8 && Config->Width != 16 && Config->Width != 32) ||
+            Config->Cas < 1 || Config->Cas > 3 || Config->ReadDelay > 2 || Config->tMRD < 1 ||
+            Config->tMRD > 16) return SDRAM_ERR_PARAM;
+
+    hclk = RCU_Clock_Freq_Get(CK_AHB);
+    div = SDRAM_PickDiv(hclk, Config->MaxHz, 2, 3);
+
+    if(div == 0) return SDRAM_ERR_CLOCK;
+
+    hz = hclk / div;
+    ret = SDRAM_PlanTiming(Config, hz, &t);
+
+    if(ret != SDRAM_OK) return ret;
+
+    if(t.tRCD > 16 || t.tRP > 16 || t.tRC > 16 || t.tRAS > 16 || t.tXSR > 16 || t.tWR > 16) return SDRAM_ERR_TIMING;
+
+    if(t.Refresh < SDRAM_REFRESH_MIN + SDRAM_REFRESH_MARGIN) return SDRAM_ERR_REFRESH;
+
+    refresh = t.Refresh - SDRAM_REFRESH_MARGIN;
+
+    if(refresh > SDRAM_REFRESH_MAX) refresh = SDRAM_REFRESH_MAX;
+
+    device = Config->Device == 0 ? EXMC_SDRAM_DEVICE0 : EXMC_SDRAM_DEVICE1;
+
+    RCU_Periph_Clock_Enable(RCU_EXMC);
+
+    init.timing = &timing;
+    EXMC_sdram_Struct_Para_Init(&init);
+    init.sdram_device = device;
+    init.internal_bank_number = Config->InBanks == 4 ? EXMC_SDRAM_4_INTER_BANK : EXMC_SDRAM_2_INTER_BANK;
+    init.sdclock_Config = div == 2 ? EXMC_SDCLK_PERIODS_2_HCLK : EXMC_SDCLK_PERIODS_3_HCLK;
+    init.write_Protection = DISABLE;
+    init.burst_read_switch = Config->ReadBurst ? ENABLE : DISABLE;
+    init.pipeline_read_delay = SDCTL_PIPED(Config->ReadDelay);
+    init.column_Address_width = SDCTL_CAW(Config->ColBits - 8);
+    init.row_Address_width = SDCTL_RAW(Config->RowBits - 11);
+    init.cas_latency = SDCTL_CL(Config->Cas);
+    init.data_width = Config->Width == 32 ? EXMC_SDRAM_DATABUS_Width_32B :
+                      (Config->Width == 16 ? EXMC_SDRAM_DATABUS_Width_16B : EXMC_SDRAM_DATABUS_Width_8B);
+
+    timing.load_Mode_Register_delay = Config->tMRD;
+    timing.exit_selfrefresh_delay = t.tXSR;
+    timing.row_Address_Select_delay = t.tRAS;
+    timing.auto_refresh_delay = t.tRC;
+    timing.write_recovery_delay = t.tWR;
+    timing.row_precharge_delay = t.tRP;
+    timing.row_to_column_delay = t.tRCD;
+    EXMC_sdram_Init(&init);
+
+    /* JEDEC 上电序列: 时钟稳定至少 100us 后预充电, 至少 2 次自动刷新(这里 8 次), 再装载模式寄存器 */
+    ret = SDRAM_Command(EXMC_SDRAM_Clock_ENABLE, device, EXMC_SDRAM_Auto_REFLESH_1_SDCLK, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    for(i = SystemCoreClock / 10000; i > 0; i--) __NOP();
+
+    ret = SDRAM_Command(EXMC_SDRAM_PRECHARGE_ALL, device, EXMC_SDRAM_Auto_REFLESH_1_SDCLK, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    ret = SDRAM_Command(EXMC_SDRAM_Auto_REFRESH, device, EXMC_SDRAM_Auto_REFLESH_8_SDCLK, 0);
+
+    if(ret != SDRAM_OK) return ret;
+
+    ret = SDRAM_Command(EXMC_SDRAM_LOAD_Mode_REGISTER, device, EXMC_SDRAM_Auto_REFLESH_1_SDCLK,
+                        0x0200 | ((uint32_t)Config->Cas << 4));
+
+    if(ret != SDRAM_OK) return ret;
+
+    EXMC_sdram_refresh_count_Set(refresh);
+
+    info.Base = Config->Device == 0 ? SDRAM_DEVICE0_BASE : SDRAM_DEVICE1_BASE;
+    info.RowSize = (1UL << Config->ColBits) * (Config->Width / 8);
+    info.BankSize = info.RowSize << Config->RowBits;
+    info.Size = info.BankSize * Config->InBanks;
+    info.ClockHz = hz;
+    info.Refresh = (uint16_t)refresh;
+    info.Div = div;
+    info.InBanks = Config->InBanks;
+    info.Map = SDRAM_MAP_BANK_ROW_COL;
+
+    if(Info) *Info = info;
+
+    return SDRAM_Attach(&info);
+}
+
+/**
+  * @Name    SDRAM_Bench
+  * @brief   测量当前配置的带宽
+  * @param   Buf: 测试缓冲, 顺序写会改写其内容
+  * @param   Bytes: 测试缓冲大小, 每项测试访问 Bytes 字节
+  * @param   Result: 输出, 单位 KB/s
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          关中断后用 DWT 计数执行 SDRAM_BenchRun. 不同 ReadBurst/ReadDelay/CAS 或 HCLK 下分别初始化后
+          调用, 比较结果选择配置.
+ **/
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __disable_irq();
+
+    SDRAM_BenchRun(Buf, Bytes, &DWT->CYCCNT, SystemCoreClock, Result);
+
+    __enable_irq();
+}
@@ -0,0 +1,38 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : EXMC 外部 SDRAM 初始化和带宽测试
+                   时序换算、分配和测试过程在 Common/sdram_plan.c, 这里只写 EXMC 寄存器并执行上电序列.
+                   EXMC 地址映射为 [内部 bank][行][列], 用 SDRAM_Alloc 把同时访问的缓冲放在不同 bank.
+                   Device 0 / 1 对应 EXMC_SDRAM_DEVICE0(SDNE0) / EXMC_SDRAM_DEVICE1(SDNE1).
+                   EXMC 引脚复用由用户在调用 SDRAM_Setup 之前配置.
+  * Function List:
+                   SDRAM_Setup
+                   SDRAM_Bench
+  ******************************************************
+**/
+
+#ifndef __SDRAM_H_
+#define __SDRAM_H_
+
+#include "gd32f4xx.h"
+#include "sdram_plan.h"
+
+#define SDRAM_DEVICE0_BASE      0xC0000000      //EXMC_SDRAM_DEVICE0(SDNE0)
+#define SDRAM_DEVICE1_BASE      0xD0000000      //EXMC_SDRAM_DEVICE1(SDNE1)
+
+#define SDRAM_TIMEOUT           0xFFFF
+
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info);
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result);
+
+#endif
@@ -0,0 +1,325 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 任意波形播放
+                   1. TIMER5 更新事件作 TRGO, 同时触发 DAC0/DAC1, 每次触发 DAC 发一次 DMA 请求;
+                   2. 双通道只用 DAC0 的 DMA 请求(通道5), 32 位写 DACC_R12DH 同时装入两路数据;
+                   3. 改采样率只改预分频和自动重装载值, 两者都带影子寄存器, 在下一个更新事件生效,
+                      输出不中断;
+                   4. 流播放用 DMA 双缓冲模式, 两块是 Buf 的前后两半, 块完成后交给 Wave_StreamDone.
+  * Function List:
+
+  **********************************************************
+ */
+#include "wave_player.h"
+
+#define WAVE_DMA                DMA0
+#define WAVE_TIMER              TIMER5
+
+static uint8_t wave_channels;
+static DMA_Channel_enum wave_dma_ch;
+static uint32_t wave_dac;                       //发 DMA 请求的 DAC
+static Wave_Stream wave_stream;
+
+/**
+  * @Name    Wave_TimerClock
+  * @brief   TIMER5 计数时钟
+  * @param   None
+  * @retval  Hz
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          APB1 不分频时等于 APB1; 分频时为 APB1 的 2 倍, TIMERSEL 置位且分频不小于 4 时为 4 倍.
+ **/
+static uint32_t Wave_TimerClock(void) {
+    uint32_t apb1 = RCU_Clock_Freq_Get(CK_APB1);
+    uint32_t psc = RCU_CFG0 & RCU_CFG0_APB1PSC;
+
+    if(psc == RCU_APB1_CKAHB_DIV1) return apb1;
+
+    if((RCU_CFG1 & RCU_CFG1_TIMERSEL) && psc != RCU_APB1_CKAHB_DIV2) return apb1 * 4;
+
+    return apb1 * 2;
+}
+
+/**
+  * @Name    Wave_CheckUnderrun
+  * @brief   检查并恢复 DAC DMA 欠载
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          欠载后 DAC 不再发 DMA 请求, 清标志并重新使能 DMA 请求后继续.
+ **/
+static void Wave_CheckUnderrun(void) {
+    if(wave_channels == 0 || DAC_Flag_Get(wave_dac) == RESET) return;
+
+    DAC_Flag_Clear(wave_dac);
+    DAC_DMA_Disable(wave_dac);
+    DAC_DMA_Enable(wave_dac);
+    wave_stream.Stats.DacUnderruns++;
+}
+
+/**
+  * @Name    Wave_Init
+  * @brief   初始化引脚、DAC、TIMER5 和 DMA 通道
+  * @param   Channels: WAVE_CH0 / WAVE_CH1 / WAVE_CH_BOTH
+  * @retval  WAVE_OK; 通道参数错误时 WAVE_ERR_PARAM
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int32_t Wave_Init(uint8_t Channels) {
+    TIMER_Parameter_Struct timer;
+    uint32_t pins = 0;
+
+    if(Channels == 0 || (Channels & ~WAVE_CH_BOTH) != 0) return WAVE_ERR_PARAM;
+
+    wave_channels = Channels;
+    wave_stream.Callback = 0;
+    wave_stream.Stats.DacUnderruns = 0;
+
+    if(Channels == WAVE_CH1) {
+        wave_dac = DAC1;
+        wave_dma_ch = DMA_CH6;
+    } else {
+        wave_dac = DAC0;
+        wave_dma_ch = DMA_CH5;
+    }
+
+    RCU_Periph_Clock_Enable(RCU_GPIOA);
+    RCU_Periph_Clock_Enable(RCU_DAC);
+    RCU_Periph_Clock_Enable(RCU_TIMER5);
+    RCU_Periph_Clock_Enable(RCU_DMA0);
+
+    if(Channels & WAVE_CH0) pins |= GPIO_Pin_4;
+
+    if(Channels & WAVE_CH1) pins |= GPIO_Pin_5;
+
+    GPIO_mode_Set(GPIOA, GPIO_Mode_ANALOG, GPIO_PUPD_NONE, pins);
+
+    DAC_DeInit();
+
+    if(Channels & WAVE_CH0) {
+        DAC_Trigger_Source_Config(DAC0, DAC_Trigger_T5_TRGO);
+        DAC_Trigger_Enable(DAC0);
+        DAC_Wave_Mode_Config(DAC0, DAC_Wave_DISABLE);
+        DAC_OutPut_Buffer_Enable(DAC0);
+        DAC_Enable(DAC0);
+    }
+
+    if(Channels & WAVE_CH1) {
+        DAC_Trigger_Source_Config(DAC1, DAC_Trigger_T5_TRGO);
+        DAC_Trigger_Enable(DAC1);
+        DAC_Wave_Mode_Config(DAC1, DAC_Wave_DISABLE);
+        DAC_OutPut_Buffer_Enable(DAC1);
+        DAC_Enable(DAC1);
+    }
+
+    TIMER_DeInit(WAVE_TIMER);
+    TIMER_Struct_Para_Init(&timer);
+    timer.clockdivision = TIMER_CKDIV_DIV1;
+    timer.period = 0xFFFF;
+    TIMER_Init(WAVE_TIMER, &timer);
+    TIMER_Auto_Reload_Shadow_Enable(WAVE_TIMER);
+    TIMER_Master_OutPut_Trigger_Source_Select(WAVE_TIMER, TIMER_TRI_OUT_SRC_UPDATE);
+
+    NVIC_irq_Enable(Channels == WAVE_CH1 ? DMA0_Channel6_IRQn : DMA0_Channel5_IRQn, WAVE_IRQ_PRIORITY, 0);
+
+    return WAVE_OK;
+}
+
+/**
+  * @Name    Wave_SetRate
+  * @brief   设置采样率, 播放中也可调用
+  * @param   Rate: 采样率(Hz)
+  * @retval  实际采样率(Hz, 向下取整)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          预分频 1~65536 任意, 由 Wave_PlanRate 换算.
+ **/
+uint32_t Wave_SetRate(uint32_t Rate) {
+    uint32_t div, period, actual;
+
+    actual = Wave_PlanRate(Wave_TimerClock(), Rate, 65536, 0, &div, &period);
+    TIMER_Prescaler_Config(WAVE_TIMER, (uint16_t)(div - 1), TIMER_PSC_Reload_UPDATE);
+    TIMER_AutoReload_Value_Config(WAVE_TIMER, period - 1);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_DMAStart
+  * @brief   配置并启动 DMA 和 TIMER5
+  * @param   Buf0: 第一块
+  * @param   Buf1: 第二块, 为 0 时只在 Buf0 上循环
+  * @param   Samples: 每块样本数
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void Wave_DMAStart(const void *Buf0, const void *Buf1, uint32_t Samples) {
+    DMA_Single_Data_Parameter_Struct dma;
+
+    DMA_DeInit(WAVE_DMA, wave_dma_ch);
+    DMA_Single_Data_Para_Struct_Init(&dma);
+
+    if(wave_channels == WAVE_CH_BOTH) {
+        dma.periph_addr = (uint32_t)&DACC_R12DH;
+        dma.periph_Memory_width = DMA_Periph_Width_32BIT;
+    } else {
+        dma.periph_addr = wave_channels == WAVE_CH0 ? (uint32_t)&DAC0_R12DH : (uint32_t)&DAC1_R12DH;
+        dma.periph_Memory_width = DMA_Periph_Width_16BIT;
+    }
+
+    dma.periph_inc = DMA_Periph_INCREASE_DISABLE;
+    dma.memory0_addr = (uint32_t)Buf0;
+    dma.memory_inc = DMA_Memory_INCREASE_ENABLE;
+    dma.circular_mode = DMA_CIRCULAR_Mode_ENABLE;
+    dma.direction = DMA_Memory_TO_PERIPH;
+    dma.number = Samples;
+    dma.priority = DMA_Priority_ULTRA_HIGH;
+    DMA_Single_Data_Mode_Init(WAVE_DMA, wave_dma_ch, &dma);
+    DMA_Channel_Subperipheral_Select(WAVE_DMA, wave_dma_ch, DMA_SUBPERI7);
+
+    if(Buf1) {
+        DMA_Switch_Buffer_Mode_Config(WAVE_DMA, wave_dma_ch, (uint32_t)Buf1, DMA_Memory_0);
+        DMA_Switch_Buffer_Mode_Enable(WAVE_DMA, wave_dma_ch, ENABLE);
+        DMA_Interrupt_Flag_Clear(WAVE_DMA, wave_dma_ch, DMA_INT_Flag_FTF);
+        DMA_Interrupt_Enable(WAVE_DMA, wave_dma_ch, DMA_CHXCTL_FTFIE);
+    }
+
+    DAC_Flag_Clear(wave_dac);
+    DMA_Channel_Enable(WAVE_DMA, wave_dma_ch);
+    DAC_DMA_Enable(wave_dac);
+
+    TIMER_Counter_Value_Config(WAVE_TIMER, 0);
+    TIMER_Enable(WAVE_TIMER);
+}
+
+/**
+  * @Name    Wave_PlayTable
+  * @brief   循环播放一张波形表
+  * @param   Table: 单通道 uint16_t[], 双通道 uint32_t[](Wave_Pack 生成), 播放期间不得修改
+  * @param   Samples: 样本数, 1~WAVE_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz), 输出频率 = Rate / Samples
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Table == 0 || Samples == 0 || Samples > WAVE_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    wave_stream.Callback = 0;
+    actual = Wave_SetRate(Rate);
+    TIMER_Event_Software_Generate(WAVE_TIMER, TIMER_Event_SRC_UPG);
+    Wave_DMAStart(Table, 0, Samples);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_PlayStream
+  * @brief   双缓冲流播放
+  * @param   Buf: 连续的两块, 共 2 * Samples 个样本
+  * @param   Samples: 每块样本数, 1~WAVE_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz)
+  * @param   Callback: 填块回调, 启动前先调用两次填满两块
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          回调必须在一块的播放时间(Samples / Rate)内返回.
+ **/
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Buf == 0 || Callback == 0 || Samples == 0 || Samples > WAVE_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    Wave_StreamStart(&wave_stream, Buf, Samples, WAVE_SAMPLE_BYTES(wave_channels), Callback);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    actual = Wave_SetRate(Rate);
+    TIMER_Event_Software_Generate(WAVE_TIMER, TIMER_Event_SRC_UPG);
+    Wave_DMAStart(wave_stream.Buf, wave_stream.Buf + wave_stream.BlockBytes, Samples);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_Stop
+  * @brief   停止播放, 输出保持最后一个样本
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Wave_Stop(void) {
+    if(wave_channels == 0) return;
+
+    TIMER_Disable(WAVE_TIMER);
+    DAC_DMA_Disable(wave_dac);
+    DMA_Interrupt_Disable(WAVE_DMA, wave_dma_ch, DMA_CHXCTL_FTFIE);
+    DMA_Channel_Disable(WAVE_DMA, wave_dma_ch);
+
+    while(DMA_CHCTL(WAVE_DMA, wave_dma_ch) & DMA_CHXCTL_CHEN);
+}
+
+static uint8_t Wave_Playing(void) {
+    return (uint8_t)DMA_Using_Memory_Get(WAVE_DMA, wave_dma_ch);
+}
+
+/**
+  * @Name    Wave_DMA_IRQHandler
+  * @brief   流播放的块完成中断, 在 DMA0_Channel5_IRQHandler(只用 CH1 时为 Channel6)中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DMA 已切到另一块, 刚播完的一块交给 Wave_StreamDone 刷新.
+ **/
+void Wave_DMA_IRQHandler(void) {
+    if(DMA_Interrupt_Flag_Get(WAVE_DMA, wave_dma_ch, DMA_INT_Flag_FTF) == RESET) return;
+
+    DMA_Interrupt_Flag_Clear(WAVE_DMA, wave_dma_ch, DMA_INT_Flag_FTF);
+    Wave_CheckUnderrun();
+    Wave_StreamDone(&wave_stream, Wave_Playing() ^ 1, Wave_Playing, &DWT->CYCCNT);
+}
+
+/**
+  * @Name    Wave_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          表播放不进中断, DAC 欠载在这里检查并恢复.
+ **/
+void Wave_GetStats(Wave_Stats *Stats) {
+    if(wave_stream.Callback == 0) Wave_CheckUnderrun();
+
+    *Stats = wave_stream.Stats;
+}
@@ -33,7 +33,8 @@ extern "C"
  ******************************************************************************/
 #include "hc32_ll_def.h"
 
-#include "hc32f4xx.h"
+//#include "hc32f4xx.h"
+#include "hc32f4a0sitb.h"
 #include "hc32f4xx_conf.h"
 /**
  * @addtogroup LL_Driver
@@ -1707,6 +1707,193 @@ void CLK_SetTpiuClockDiv(uint8_t u8Div) {
     MODIFY_REG8(CM_CMU->TPIUCKCFGR, CMU_TPIUCKCFGR_TPIUCKS, u8Div);
 }
 
+/**
+ * @brief  Save the running clock configuration for CLK_SnapshotRestore().
+ * @param  [out] pstcSnapshot Pointer to a @ref stc_clock_snapshot_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   No error
+ *           - LL_ERR_INVD_PARAM:       pstcSnapshot == NULL
+ * @note   Call again after any change of the system clock configuration.
+ */
+int32_t CLK_SnapshotSave(stc_clock_snapshot_t *pstcSnapshot) {
+    int32_t i32Ret = LL_OK;
+
+    if (NULL == pstcSnapshot) {
+        i32Ret = LL_ERR_INVD_PARAM;
+    } else {
+        pstcSnapshot->u32Scfgr = READ_REG32(CM_CMU->SCFGR);
+        pstcSnapshot->u32PllhCfgr = READ_REG32(CM_CMU->PLLHCFGR);
+        pstcSnapshot->u32PllaCfgr = READ_REG32(CM_CMU->PLLACFGR);
+        pstcSnapshot->u8Ckswr = READ_REG8_BIT(CM_CMU->CKSWR, CMU_CKSWR_CKSW);
+        pstcSnapshot->u8HrcCr = READ_REG8_BIT(CM_CMU->HRCCR, CMU_HRCCR_HRCSTP);
+        pstcSnapshot->u8XtalCr = READ_REG8_BIT(CM_CMU->XTALCR, CMU_XTALCR_XTALSTP);
+        pstcSnapshot->u8PllhCr = READ_REG8_BIT(CM_CMU->PLLHCR, CMU_PLLHCR_PLLHOFF);
+        pstcSnapshot->u8PllaCr = READ_REG8_BIT(CM_CMU->PLLACR, CMU_PLLACR_PLLAOFF);
+        pstcSnapshot->u8State = CLK_SNAPSHOT_IDLE;
+        pstcSnapshot->u32WakeCycles = 0UL;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Start restoring a saved clock configuration, e.g. after stop mode wake-up.
+ * @param  [in] pstcSnapshot Pointer to a @ref stc_clock_snapshot_t structure saved by CLK_SnapshotSave().
+ * @retval None
+ * @note   Only requests the oscillators and returns without waiting. The caller may restore
+ *         peripheral state while they stabilise, then call CLK_SnapshotRestorePoll() until LL_OK.
+ * @note   Starts the DWT cycle counter if it is not running.
+ * @note   Updates SystemCoreClock to the wake-up clock, so the CLK_SYSCLK_SW_STB delays in
+ *         CLK_SnapshotRestorePoll() are counted for the clock actually running.
+ */
+void CLK_SnapshotRestoreStart(stc_clock_snapshot_t *pstcSnapshot) {
+    DDL_ASSERT(NULL != pstcSnapshot);
+    DDL_ASSERT(IS_CLK_UNLOCKED());
+
+    SystemCoreClockUpdate();
+    if (0UL == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    pstcSnapshot->u32StartCycle = DWT->CYCCNT;
+
+    /* Oscillators only, PLLs need a stable source */
+    if (0U == pstcSnapshot->u8HrcCr) {
+        WRITE_REG8(CM_CMU->HRCCR, 0U);
+    }
+    if (0U == pstcSnapshot->u8XtalCr) {
+        WRITE_REG8(CM_CMU->XTALCR, 0U);
+    }
+    pstcSnapshot->u8State = CLK_SNAPSHOT_OSC;
+}
+
+/**
+ * @brief  Advance a restore started by CLK_SnapshotRestoreStart(), never waits.
+ * @param  [in] pstcSnapshot Pointer to a @ref stc_clock_snapshot_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   Running on the saved system clock
+ *           - LL_ERR_BUSY:             Oscillator or PLL not stable yet, call again
+ * @note   Register values that survive stop mode are compared and only rewritten when changed.
+ *         The FCG backup around a PLL switch is the same as CLK_SetSysClockSrc(), but the
+ *         settle delay before the switch is counted for the wake-up clock and the delays
+ *         after it for the saved clock: SystemCoreClock follows every switch.
+ */
+int32_t CLK_SnapshotRestorePoll(stc_clock_snapshot_t *pstcSnapshot) {
+    int32_t i32Ret = LL_OK;
+    uint8_t u8Stb;
+    uint32_t fcg0;
+    uint32_t fcg1;
+    uint32_t fcg2;
+    uint32_t fcg3;
+
+    DDL_ASSERT(NULL != pstcSnapshot);
+    DDL_ASSERT(IS_CLK_UNLOCKED());
+
+    u8Stb = READ_REG8(CM_CMU->OSCSTBSR);
+
+    if (CLK_SNAPSHOT_OSC == pstcSnapshot->u8State) {
+        if (((0U == pstcSnapshot->u8HrcCr) && (0U == (u8Stb & CLK_STB_FLAG_HRC))) ||
+                ((0U == pstcSnapshot->u8XtalCr) && (0U == (u8Stb & CLK_STB_FLAG_XTAL)))) {
+            i32Ret = LL_ERR_BUSY;
+        } else {
+            /* PLL config can only be written while the PLL is off */
+            if ((0U == pstcSnapshot->u8PllhCr) && (READ_REG32(CM_CMU->PLLHCFGR) != pstcSnapshot->u32PllhCfgr) &&
+                    (0U != READ_REG8_BIT(CM_CMU->PLLHCR, CMU_PLLHCR_PLLHOFF))) {
+                WRITE_REG32(CM_CMU->PLLHCFGR, pstcSnapshot->u32PllhCfgr);
+            }
+            if ((0U == pstcSnapshot->u8PllaCr) && (READ_REG32(CM_CMU->PLLACFGR) != pstcSnapshot->u32PllaCfgr) &&
+                    (0U != READ_REG8_BIT(CM_CMU->PLLACR, CMU_PLLACR_PLLAOFF))) {
+                WRITE_REG32(CM_CMU->PLLACFGR, pstcSnapshot->u32PllaCfgr);
+            }
+            if (0U == pstcSnapshot->u8PllhCr) {
+                WRITE_REG8(CM_CMU->PLLHCR, 0U);
+            }
+            if (0U == pstcSnapshot->u8PllaCr) {
+                WRITE_REG8(CM_CMU->PLLACR, 0U);
+            }
+            pstcSnapshot->u8State = CLK_SNAPSHOT_PLL;
+            u8Stb = READ_REG8(CM_CMU->OSCSTBSR);
+        }
+    }
+
+    if (CLK_SNAPSHOT_PLL == pstcSnapshot->u8State) {
+        if (((0U == pstcSnapshot->u8PllhCr) && (0U == (u8Stb & CLK_STB_FLAG_PLL))) ||
+                ((0U == pstcSnapshot->u8PllaCr) && (0U == (u8Stb & CLK_STB_FLAG_PLLX)))) {
+            i32Ret = LL_ERR_BUSY;
+        } else {
+            if (READ_REG32(CM_CMU->SCFGR) != pstcSnapshot->u32Scfgr) {
+                SetSysClockDiv(CLK_BUS_CLK_ALL, pstcSnapshot->u32Scfgr);
+            }
+
+            if (READ_REG8_BIT(CM_CMU->CKSWR, CMU_CKSWR_CKSW) != pstcSnapshot->u8Ckswr) {
+                if (CLK_SYSCLK_SRC_PLL == pstcSnapshot->u8Ckswr) {
+                    DDL_ASSERT((CM_PWC->FCG0PC & PWC_FCG0PC_PRT0) == PWC_FCG0PC_PRT0);
+                    fcg0 = READ_REG32(CM_PWC->FCG0);
+                    fcg1 = READ_REG32(CM_PWC->FCG1);
+                    fcg2 = READ_REG32(CM_PWC->FCG2);
+                    fcg3 = READ_REG32(CM_PWC->FCG3);
+                    WRITE_REG32(CM_PWC->FCG0, CLK_FCG0_DEFAULT);
+                    WRITE_REG32(CM_PWC->FCG1, CLK_FCG1_DEFAULT);
+                    WRITE_REG32(CM_PWC->FCG2, CLK_FCG2_DEFAULT);
+                    WRITE_REG32(CM_PWC->FCG3, CLK_FCG3_DEFAULT);
+                    CLK_Delay(CLK_SYSCLK_SW_STB);
+
+                    WRITE_REG8(CM_CMU->CKSWR, pstcSnapshot->u8Ckswr);
+                    pstcSnapshot->u32WakeCycles = DWT->CYCCNT - pstcSnapshot->u32StartCycle;
+                    SystemCoreClockUpdate();
+                    CLK_Delay(CLK_SYSCLK_SW_STB);
+
+                    WRITE_REG32(CM_PWC->FCG0, fcg0);
+                    WRITE_REG32(CM_PWC->FCG1, fcg1);
+                    WRITE_REG32(CM_PWC->FCG2, fcg2);
+                    WRITE_REG32(CM_PWC->FCG3, fcg3);
+                    CLK_Delay(CLK_SYSCLK_SW_STB);
+                } else {
+                    WRITE_REG8(CM_CMU->CKSWR, pstcSnapshot->u8Ckswr);
+                    pstcSnapshot->u32WakeCycles = DWT->CYCCNT - pstcSnapshot->u32StartCycle;
+                    SystemCoreClockUpdate();
+                    CLK_Delay(CLK_SYSCLK_SW_STB);
+                }
+            } else {
+                pstcSnapshot->u32WakeCycles = DWT->CYCCNT - pstcSnapshot->u32StartCycle;
+            }
+
+            pstcSnapshot->u8State = CLK_SNAPSHOT_DONE;
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Restore a saved clock configuration and wait until done.
+ * @param  [in] pstcSnapshot Pointer to a @ref stc_clock_snapshot_t structure saved by CLK_SnapshotSave().
+ * @retval int32_t:
+ *           - LL_OK:                   Running on the saved system clock
+ *           - LL_ERR_INVD_PARAM:       pstcSnapshot == NULL
+ *           - LL_ERR_TIMEOUT:          Oscillator or PLL not stable, system clock unchanged
+ */
+int32_t CLK_SnapshotRestore(stc_clock_snapshot_t *pstcSnapshot) {
+    __IO uint32_t u32Timeout = 0UL;
+    int32_t i32Ret;
+
+    if (NULL == pstcSnapshot) {
+        i32Ret = LL_ERR_INVD_PARAM;
+    } else {
+        CLK_SnapshotRestoreStart(pstcSnapshot);
+
+        do {
+            i32Ret = CLK_SnapshotRestorePoll(pstcSnapshot);
+            u32Timeout++;
+        } while ((LL_ERR_BUSY == i32Ret) && (u32Timeout < (CLK_TIMEOUT * 2UL)));
+
+        if (LL_OK != i32Ret) {
+            i32Ret = LL_ERR_TIMEOUT;
+        }
+    }
+
+    return i32Ret;
+}
 
 #endif /* LL_CLK_ENABLE */
 
@@ -189,6 +189,26 @@ typedef struct {
     uint32_t u32PllxR;                 /*!< pllxr clock frequency.         */
 } stc_pll_clock_freq_t;
 
+/**
+ * @brief  CLK snapshot structure definition
+ * @note   Filled in by CLK_SnapshotSave(). The restore progress is kept here as well,
+ *         do not modify it while a restore is in progress.
+ */
+typedef struct {
+    uint32_t u32Scfgr;                 /*!< Bus clock divider.                          */
+    uint32_t u32PllhCfgr;              /*!< PLLH config.                                */
+    uint32_t u32PllaCfgr;              /*!< PLLA(PLLx) config.                          */
+    uint8_t u8Ckswr;                   /*!< System clock source.                        */
+    uint8_t u8HrcCr;                   /*!< HRCCR.HRCSTP, 0: on.                       */
+    uint8_t u8XtalCr;                  /*!< XTALCR.XTALSTP, 0: on.                     */
+    uint8_t u8PllhCr;                  /*!< PLLHCR.PLLHOFF, 0: on.                     */
+    uint8_t u8PllaCr;                  /*!< PLLACR.PLLAOFF, 0: on.                     */
+    uint8_t u8State;                   /*!< Restore progress, @ref CLK_Snapshot_State   */
+    uint32_t u32StartCycle;            /*!< DWT cycle counter at CLK_SnapshotRestoreStart(). */
+    uint32_t u32WakeCycles;            /*!< Cycles from CLK_SnapshotRestoreStart() to the switch back
+                                            to the saved system clock, counted at the wake-up clock. */
+} stc_clock_snapshot_t;
+
 
 
 /*******************************************************************************
@@ -533,6 +553,14 @@ typedef struct {
 #define CLK_TPIUCLK_DIV4                (0x02U)
 
 
+/**
+ * @defgroup CLK_Snapshot_State CLK Snapshot Restore State
+ */
+#define CLK_SNAPSHOT_IDLE               (0x00U)     /*!< Saved, restore not started   */
+#define CLK_SNAPSHOT_OSC                (0x01U)     /*!< Waiting HRC/XTAL stable      */
+#define CLK_SNAPSHOT_PLL                (0x02U)     /*!< Waiting PLLH/PLLA stable     */
+#define CLK_SNAPSHOT_DONE               (0x03U)     /*!< Running on the saved clock   */
+
 /**
  * @defgroup CLK_MCO_Channel_Sel CLK MCO Channel Select
  */
@@ -630,6 +658,11 @@ void CLK_SetCANClockSrc(uint8_t u8Unit, uint8_t u8Src);
 void CLK_TpiuClockCmd(en_functional_state_t enNewState);
 void CLK_SetTpiuClockDiv(uint8_t u8Div);
 
+int32_t CLK_SnapshotSave(stc_clock_snapshot_t *pstcSnapshot);
+void CLK_SnapshotRestoreStart(stc_clock_snapshot_t *pstcSnapshot);
+int32_t CLK_SnapshotRestorePoll(stc_clock_snapshot_t *pstcSnapshot);
+int32_t CLK_SnapshotRestore(stc_clock_snapshot_t *pstcSnapshot);
+
 
 #endif /* LL_CLK_ENABLE */
 
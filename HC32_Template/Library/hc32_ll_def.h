@@ -285,6 +285,45 @@ area of a module to a memory space in physical RAM. */
 #define RW_MEM16(addr)                  (*(volatile uint16_t *)(addr))
 #define RW_MEM32(addr)                  (*(volatile uint32_t *)(addr))
 
+#ifdef LL_REG_TRACE
+/* Register access trace build: every register macro goes through REGTRACE_Read/REGTRACE_Write,
+   which perform the access and record it together with the calling function, see User/BSP/reg_trace.h */
+uint32_t REGTRACE_Read(const volatile void *pvAddr, uint32_t u32Size, const char *pcFunc);
+uint32_t REGTRACE_Write(volatile void *pvAddr, uint32_t u32Size, uint32_t u32Val, const char *pcFunc);
+
+#define REGTRACE_RD(REG)                (REGTRACE_Read((const volatile void *)&(REG), (uint32_t)sizeof(REG), __func__))
+#define REGTRACE_WR(REG, VAL)           (REGTRACE_Write((volatile void *)&(REG), (uint32_t)sizeof(REG), (uint32_t)(VAL), __func__))
+
+#define SET_REG_BIT(REG, BIT)           REGTRACE_WR((REG), REGTRACE_RD(REG) | ((uint32_t)(BIT)))
+#define SET_REG8_BIT(REG, BIT)          REGTRACE_WR((REG), REGTRACE_RD(REG) | ((uint8_t)(BIT)))
+#define SET_REG16_BIT(REG, BIT)         REGTRACE_WR((REG), REGTRACE_RD(REG) | ((uint16_t)(BIT)))
+#define SET_REG32_BIT(REG, BIT)         REGTRACE_WR((REG), REGTRACE_RD(REG) | ((uint32_t)(BIT)))
+
+#define CLR_REG_BIT(REG, BIT)           REGTRACE_WR((REG), REGTRACE_RD(REG) & (~((uint32_t)(BIT))))
+#define CLR_REG8_BIT(REG, BIT)          REGTRACE_WR((REG), REGTRACE_RD(REG) & ((uint8_t)(~((uint8_t)(BIT)))))
+#define CLR_REG16_BIT(REG, BIT)         REGTRACE_WR((REG), REGTRACE_RD(REG) & ((uint16_t)(~((uint16_t)(BIT)))))
+#define CLR_REG32_BIT(REG, BIT)         REGTRACE_WR((REG), REGTRACE_RD(REG) & ((uint32_t)(~((uint32_t)(BIT)))))
+
+#define READ_REG_BIT(REG, BIT)          (REGTRACE_RD(REG) & ((uint32_t)(BIT)))
+#define READ_REG8_BIT(REG, BIT)         (REGTRACE_RD(REG) & ((uint8_t)(BIT)))
+#define READ_REG16_BIT(REG, BIT)        (REGTRACE_RD(REG) & ((uint16_t)(BIT)))
+#define READ_REG32_BIT(REG, BIT)        (REGTRACE_RD(REG) & ((uint32_t)(BIT)))
+
+#define CLR_REG(REG)                    REGTRACE_WR((REG), 0UL)
+#define CLR_REG8(REG)                   REGTRACE_WR((REG), 0UL)
+#define CLR_REG16(REG)                  REGTRACE_WR((REG), 0UL)
+#define CLR_REG32(REG)                  REGTRACE_WR((REG), 0UL)
+
+#define WRITE_REG(REG, VAL)             REGTRACE_WR((REG), (VAL))
+#define WRITE_REG8(REG, VAL)            REGTRACE_WR((REG), ((uint8_t)(VAL)))
+#define WRITE_REG16(REG, VAL)           REGTRACE_WR((REG), ((uint16_t)(VAL)))
+#define WRITE_REG32(REG, VAL)           REGTRACE_WR((REG), ((uint32_t)(VAL)))
+
+#define READ_REG(REG)                   REGTRACE_RD(REG)
+#define READ_REG8(REG)                  ((uint8_t)REGTRACE_RD(REG))
+#define READ_REG16(REG)                 ((uint16_t)REGTRACE_RD(REG))
+#define READ_REG32(REG)                 REGTRACE_RD(REG)
+#else
 #define SET_REG_BIT(REG, BIT)           ((REG) |= (BIT))
 #define SET_REG8_BIT(REG, BIT)          ((REG) |= ((uint8_t)(BIT)))
 #define SET_REG16_BIT(REG, BIT)         ((REG) |= ((uint16_t)(BIT)))
@@ -314,6 +353,7 @@ area of a module to a memory space in physical RAM. */
 #define READ_REG8(REG)                  (REG)
 #define READ_REG16(REG)                 (REG)
 #define READ_REG32(REG)                 (REG)
+#endif /* LL_REG_TRACE */
 
 #define MODIFY_REG(REGS, CLRMASK, SETMASK)    (WRITE_REG((REGS), (((READ_REG(REGS)) & (~(CLRMASK))) | ((SETMASK) & (CLRMASK)))))
 #define MODIFY_REG8(REGS, CLRMASK, SETMASK)   (WRITE_REG8((REGS), (((READ_REG8((REGS))) & ((uint8_t)(~((uint8_t)(CLRMASK))))) | ((uint8_t)(SETMASK) & (uint8_t)(CLRMASK)))))
@@ -231,6 +231,7 @@ void DMA_ErrIntCmd(CM_DMA_TypeDef *DMAx, uint32_t u32ErrInt, en_functional_state
     }
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Get DMA error flag.
  * @param  [in] DMAx        DMA unit instance.
@@ -245,7 +246,9 @@ en_flag_status_t DMA_GetErrStatus(const CM_DMA_TypeDef *DMAx, uint32_t u32Flag)
 
     return (0U != READ_REG32_BIT(DMAx->INTSTAT0, u32Flag) ? SET : RESET);
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Clear DMA error flag.
  * @param  [in] DMAx        DMA unit instance.
@@ -260,6 +263,7 @@ void DMA_ClearErrStatus(CM_DMA_TypeDef *DMAx, uint32_t u32Flag) {
 
     SET_REG32_BIT(DMAx->INTCLR0, u32Flag);
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  DMA transfer IRQ function config.
@@ -281,6 +285,7 @@ void DMA_TransCompleteIntCmd(CM_DMA_TypeDef *DMAx, uint32_t u32TransCompleteInt,
     }
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Get DMA transfer flag.
  * @param  [in] DMAx DMA unit instance.
@@ -293,7 +298,9 @@ en_flag_status_t DMA_GetTransCompleteStatus(const CM_DMA_TypeDef *DMAx, uint32_t
     DDL_ASSERT(IS_DMA_TRANS_FLAG(u32Flag));
     return ((0U != READ_REG32_BIT(DMAx->INTSTAT1, u32Flag)) ? SET : RESET);
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Clear DMA transfer flag.
  * @param  [in] DMAx DMA unit instance.
@@ -308,6 +315,7 @@ void DMA_ClearTransCompleteStatus(CM_DMA_TypeDef *DMAx, uint32_t u32Flag) {
 
     SET_REG32_BIT(DMAx->INTCLR1, u32Flag);
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  DMA multiplex channel function config.
@@ -329,6 +337,7 @@ void DMA_MxChCmd(CM_DMA_TypeDef *DMAx, uint8_t u8MxCh, en_functional_state_t enN
     }
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  DMA channel function config.
  * @param  [in] DMAx DMA unit instance.
@@ -350,7 +359,9 @@ int32_t DMA_ChCmd(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, en_functional_state_t enNe
 
     return LL_OK;
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Get DMA transfer status.
  * @param  [in] DMAx DMA unit instance.
@@ -364,6 +375,7 @@ en_flag_status_t DMA_GetTransStatus(const CM_DMA_TypeDef *DMAx, uint32_t u32Stat
 
     return ((0U != READ_REG32_BIT(DMAx->CHSTAT, u32Status)) ? SET : RESET);
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  Get DMA request status.
@@ -379,6 +391,7 @@ en_flag_status_t DMA_GetRequestStatus(const CM_DMA_TypeDef *DMAx, uint32_t u32St
     return ((0U != READ_REG32_BIT(DMAx->REQSTAT, u32Status)) ? SET : RESET);
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Config DMA source address.
  * @param  [in] DMAx DMA unit instance.
@@ -395,7 +408,9 @@ int32_t DMA_SetSrcAddr(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, uint32_t u32Addr) {
 
     return LL_OK;
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Config DMA destination address.
  * @param  [in] DMAx DMA unit instance.
@@ -412,7 +427,9 @@ int32_t DMA_SetDestAddr(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, uint32_t u32Addr) {
 
     return LL_OK;
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Config DMA transfer count.
  * @param  [in] DMAx DMA unit instance.
@@ -430,7 +447,9 @@ int32_t DMA_SetTransCount(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, uint16_t u16Count)
     MODIFY_REG32(*DTCTLx, DMA_DTCTL_CNT, ((uint32_t)(u16Count) << DMA_DTCTL_CNT_POS));
     return LL_OK;
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Config DMA block size per transfer.
  * @param  [in] DMAx DMA unit instance.
@@ -450,6 +469,7 @@ int32_t DMA_SetBlockSize(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, uint16_t u16Size) {
 
     return LL_OK;
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  Config DMA source repeat size.
@@ -996,6 +1016,7 @@ int32_t DMA_ReconfigInit(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, const stc_dma_recon
     return i32Ret;
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  DMA get current source address
  * @param  [in] DMAx DMA unit instance.
@@ -1009,7 +1030,9 @@ uint32_t DMA_GetSrcAddr(const CM_DMA_TypeDef *DMAx, uint8_t u8Ch) {
 
     return READ_REG32(DMA_CH_REG(DMAx->MONSAR0, u8Ch));
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  DMA get current destination address
  * @param  [in] DMAx DMA unit instance.
@@ -1023,7 +1046,9 @@ uint32_t DMA_GetDestAddr(const CM_DMA_TypeDef *DMAx, uint8_t u8Ch) {
 
     return READ_REG32(DMA_CH_REG(DMAx->MONDAR0, u8Ch));
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  DMA get current transfer count
  * @param  [in] DMAx DMA unit instance.
@@ -1037,6 +1062,7 @@ uint32_t DMA_GetTransCount(const CM_DMA_TypeDef *DMAx, uint8_t u8Ch) {
 
     return ((READ_REG32(DMA_CH_REG(DMAx->MONDTCTL0, u8Ch)) >> DMA_DTCTL_CNT_POS) & 0xFFFFUL);
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  DMA get current block size
@@ -3695,10 +3695,10 @@ int32_t ETH_PTP_UpdateBasicAddend(void) {
     int32_t i32Ret = LL_ERR;
 
     if (0UL == READ_REG32(bCM_ETH->PTP_TSPCTLR_b.TSPADUP)) {
-        WRITE_REG32(bCM_ETH->MMC_MMCCTLR_b.CRST, 1U);
+        WRITE_REG32(bCM_ETH->PTP_TSPCTLR_b.TSPADUP, 1U);
         u32Count = ETH_WR_REG_TIMEOUT * (HCLK_VALUE / 20000UL);
 
-        while (0UL != READ_REG32(bCM_ETH->MMC_MMCCTLR_b.CRST)) {
+        while (0UL != READ_REG32(bCM_ETH->PTP_TSPCTLR_b.TSPADUP)) {
             if (0UL == u32Count) {
                 i32Ret = LL_ERR_TIMEOUT;
                 break;
@@ -479,6 +479,7 @@ void GPIO_InputMOSCmd(uint8_t u8Port, en_functional_state_t enNewState) {
     }
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Read specified GPIO input data port pins
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -492,7 +493,9 @@ en_pin_state_t GPIO_ReadInputPins(uint8_t u8Port, uint16_t u16Pin) {
 
     return ((READ_REG(PIDR_REG(u8Port)) & (u16Pin)) != 0U) ? PIN_SET : PIN_RESET;
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Read specified GPIO input data port
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -504,6 +507,7 @@ uint16_t GPIO_ReadInputPort(uint8_t u8Port) {
 
     return READ_REG(PIDR_REG(u8Port));
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  Read specified GPIO output data port pins
@@ -531,6 +535,7 @@ uint16_t GPIO_ReadOutputPort(uint8_t u8Port) {
     return READ_REG(PODR_REG(u8Port));
 }
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Set specified GPIO output data port pins
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -547,7 +552,9 @@ void GPIO_SetPins(uint8_t u8Port, uint16_t u16Pin) {
     POSRx = &POSR_REG(u8Port);
     SET_REG_BIT(*POSRx, (GPIO_REG_TYPE)u16Pin);
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Reset specified GPIO output data port pins
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -564,7 +571,9 @@ void GPIO_ResetPins(uint8_t u8Port, uint16_t u16Pin) {
     PORRx = &PORR_REG(u8Port);
     SET_REG_BIT(*PORRx, (GPIO_REG_TYPE)u16Pin);
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Write specified GPIO data port
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -580,7 +589,9 @@ void GPIO_WritePort(uint8_t u8Port, uint16_t u16PortVal) {
     PODRx = &PODR_REG(u8Port);
     WRITE_REG(*PODRx, (GPIO_REG_TYPE)u16PortVal);
 }
+#endif /* LL_INLINE_ENABLE */
 
+#if (LL_INLINE_ENABLE == DDL_OFF)
 /**
  * @brief  Toggle specified GPIO output data port pin
  * @param  [in] u8Port: GPIO_PORT_x, x can be the suffix in @ref GPIO_Port_Source for each product
@@ -597,6 +608,7 @@ void GPIO_TogglePins(uint8_t u8Port, uint16_t u16Pin) {
     POTRx = &POTR_REG(u8Port);
     SET_REG_BIT(*POTRx, (GPIO_REG_TYPE)u16Pin);
 }
+#endif /* LL_INLINE_ENABLE */
 
 /**
  * @brief  GPIO Analog command.
@@ -338,6 +338,42 @@ __STATIC_INLINE void GPIO_REG_Unlock(void) {
     WRITE_REG16(CM_GPIO->PWPR, GPIO_REG_UNLOCK_KEY);
 }
 
+#if (LL_INLINE_ENABLE == DDL_ON)
+/* Release profile: port data accessors without parameter checks, see LL_INLINE_ENABLE */
+#define GPIO_DATA_REG_INLINE(reg, port) (*(__IO uint16_t *)((uint32_t)(&CM_GPIO->reg) + 0x10UL * (uint32_t)(port)))
+
+__STATIC_INLINE en_pin_state_t GPIO_ReadInputPins(uint8_t u8Port, uint16_t u16Pin) {
+    return ((READ_REG(GPIO_DATA_REG_INLINE(PIDRA, u8Port)) & (u16Pin)) != 0U) ? PIN_SET : PIN_RESET;
+}
+
+__STATIC_INLINE uint16_t GPIO_ReadInputPort(uint8_t u8Port) {
+    return READ_REG(GPIO_DATA_REG_INLINE(PIDRA, u8Port));
+}
+
+__STATIC_INLINE void GPIO_SetPins(uint8_t u8Port, uint16_t u16Pin) {
+    WRITE_REG16(GPIO_DATA_REG_INLINE(POSRA, u8Port), u16Pin);
+}
+
+__STATIC_INLINE void GPIO_ResetPins(uint8_t u8Port, uint16_t u16Pin) {
+    WRITE_REG16(GPIO_DATA_REG_INLINE(PORRA, u8Port), u16Pin);
+}
+
+__STATIC_INLINE void GPIO_WritePort(uint8_t u8Port, uint16_t u16PortVal) {
+    WRITE_REG16(GPIO_DATA_REG_INLINE(PODRA, u8Port), u16PortVal);
+}
+
+__STATIC_INLINE void GPIO_TogglePins(uint8_t u8Port, uint16_t u16Pin) {
+    WRITE_REG16(GPIO_DATA_REG_INLINE(POTRA, u8Port), u16Pin);
+}
+#else
+en_pin_state_t GPIO_ReadInputPins(uint8_t u8Port, uint16_t u16Pin);
+uint16_t GPIO_ReadInputPort(uint8_t u8Port);
+void GPIO_SetPins(uint8_t u8Port, uint16_t u16Pin);
+void GPIO_ResetPins(uint8_t u8Port, uint16_t u16Pin);
+void GPIO_WritePort(uint8_t u8Port, uint16_t u16PortVal);
+void GPIO_TogglePins(uint8_t u8Port, uint16_t u16Pin);
+#endif /* LL_INLINE_ENABLE */
+
 int32_t GPIO_Init(uint8_t u8Port, uint16_t u16Pin, const stc_gpio_init_t *pstcGpioInit);
 void GPIO_DeInit(void);
 int32_t GPIO_StructInit(stc_gpio_init_t *pstcGpioInit);
@@ -348,14 +384,8 @@ void GPIO_SetSubFunc(uint8_t u8Func);
 void GPIO_SetReadWaitCycle(uint16_t u16ReadWait);
 void GPIO_InputMOSCmd(uint8_t u8Port, en_functional_state_t enNewState);
 void GPIO_OutputCmd(uint8_t u8Port, uint16_t u16Pin, en_functional_state_t enNewState);
-en_pin_state_t GPIO_ReadInputPins(uint8_t u8Port, uint16_t u16Pin);
-uint16_t GPIO_ReadInputPort(uint8_t u8Port);
 en_pin_state_t GPIO_ReadOutputPins(uint8_t u8Port, uint16_t u16Pin);
 uint16_t GPIO_ReadOutputPort(uint8_t u8Port);
-void GPIO_SetPins(uint8_t u8Port, uint16_t u16Pin);
-void GPIO_ResetPins(uint8_t u8Port, uint16_t u16Pin);
-void GPIO_WritePort(uint8_t u8Port, uint16_t u16PortVal);
-void GPIO_TogglePins(uint8_t u8Port, uint16_t u16Pin);
 void GPIO_ExIntCmd(uint8_t u8Port, uint16_t u16Pin, en_functional_state_t enNewState);
 void GPIO_AnalogCmd(uint8_t u8Port, uint16_t u16Pin, en_functional_state_t enNewState);
 
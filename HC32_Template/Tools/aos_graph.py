@@ -0,0 +1,687 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/aos_graph.c 事件链路图的离线检查、代码生成和时延仿真.
+
+图文件每行一条连线 "源事件 -> 目标", 源事件为 en_event_src_t 去掉 EVT_SRC_ 前缀,
+目标为 AOS_xxx 去掉 AOS_ 前缀, # 之后为注释:
+
+    TMR6_1_GCMP_A -> ADC1_0     # 比较 A 启动 ADC1 序列 A
+    ADC1_EOCA     -> DMA1_0     # 转换完成搬运结果
+    DMA1_TC0      -> DCU1       # 搬完比较阈值
+
+    aos_graph.py check graph.txt [--cc gcc]
+        用主机编译器编译 aos_graph.c, 图交给其中的 AOSG_Check/AOSG_Describe, 打印输入位置分配和
+        每条硬件数据流; 结果与本文件的 Python 模型不一致或有错返回 1
+    aos_graph.py gen graph.txt [--name m_astcGraph]
+        输出可直接交给 AOSG_Apply 的 stc_aosg_link_t 数组
+    aos_graph.py sim graph.txt [--pclk 120 --lat ADC1=1.2 --isr-us 0.6 --busy 0.2 ...]
+        对每条路径比较硬件链与"每一级在中断里软件触发下一级"的端到端时延和抖动
+    aos_graph.py selftest
+        对照设备头文件检查 aos_graph.c 的目标表和事件区间表
+    aos_graph.py ctest [graph.txt ...] [--cc gcc] [--cases 2000] [--seed 1]
+        编译 aos_graph.c, 把给出的图、内置的图(链、公共触发合并, 以及回环、重复连线、同一目标两次
+        用同一公共触发、需要第三个公共触发等应被拒绝的图)和随机图交给 AOSG_Check/AOSG_Describe/
+        AOSG_Apply, 与 Python 模型逐项比较: 返回值、出错原因和连线序号、输入位置、公共触发、
+        级数、根数、每条路径的文本, 以及 Apply 后各 AOS 寄存器的值; 有差异返回 1
+
+模块划分与 aos_graph.c 的 m_astcTarget/m_astcSrcRange 一致, 修改时两边一起改.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+DEVICE_HEADER = os.path.join(ROOT, 'User', 'hc32f4a0sitb.h')
+AOS_HEADER = os.path.join(ROOT, 'Library', 'hc32_ll_aos.h')
+GRAPH_SOURCE = os.path.join(ROOT, 'User', 'BSP', 'aos_graph.c')
+
+COMM_NUM = 2
+LINK_MAX = 16
+TRGSEL_NONE = 0x1FF
+MAX_REPORT = 20
+
+# 与 aos_graph.h 的 AOSG_ERR_xxx 相同
+ERR_NONE, ERR_DUPLICATE, ERR_COMM_FULL, ERR_LOOP = 0, 3, 4, 5
+
+# 目标模块收到触发到产生下一个事件的典型时间(us), 可用 --lat 覆盖
+DEFAULT_LAT = {
+    'DMA1': 0.10, 'DMA2': 0.10, 'DMA_RC': 0.10,
+    'DCU1': 0.02, 'DCU2': 0.02, 'DCU3': 0.02, 'DCU4': 0.02,
+    'TMR0': 0.0, 'TMR2': 0.0, 'TMR6': 0.0, 'TMRA': 0.0,
+    'PORT12': 0.01, 'PORT34': 0.01, 'HASH': 2.0, 'OTS': 10.0,
+    'ADC1': 1.0, 'ADC2': 1.0, 'ADC3': 1.0,
+}
+
+
+def load_events(path):
+    text = open(path, encoding='utf-8', errors='replace').read()
+    body = text[:text.index('} en_event_src_t;')]
+    return {m.group(1): int(m.group(2)) for m in re.finditer(r'EVT_SRC_(\w+)\s*=\s*(\d+)U?', body)}
+
+
+def load_targets(path):
+    text = open(path, encoding='utf-8', errors='replace').read()
+    return {m.group(1): m.group(2) for m in re.finditer(r'#define\s+AOS_(\w+)\s+\(uint32_t\)\(&CM_AOS->(\w+)\)', text)}
+
+
+def target_module(name):
+    """目标名 -> 模块"""
+    if name.startswith('DCU'):
+        return name
+    if name.startswith('EVTPORT'):
+        return 'PORT' + name[7:]
+    if name.startswith('HASH'):
+        return 'HASH'
+    if name == 'DMA_RC':
+        return name
+    return name.split('_')[0]
+
+
+def source_module(name):
+    """事件名 -> 产生它的可作目标的模块, 不是时为 None"""
+    m = re.match(r'(DMA[12]|TMR0|TMR2|TMR6|TMRA|ADC[123])_', name)
+    if m:
+        return m.group(1)
+    if name in ('DCU1', 'DCU2', 'DCU3', 'DCU4', 'HASH', 'OTS'):
+        return name
+    m = re.match(r'EVENT_PORT([1-4])$', name)
+    if m:
+        return 'PORT12' if m.group(1) in '12' else 'PORT34'
+    return None
+
+
+class Graph:
+    def __init__(self, lines, events, targets):
+        self.links = []
+        self.errors = []
+        self.err = (ERR_NONE, 0)            # (AOSG_ERR_xxx, 出错连线序号), 与 stc_aosg_plan_t 相同
+        self.events = events
+        for no, line in enumerate(lines, 1):
+            line = line.split('#')[0].strip()
+            if not line:
+                continue
+            m = re.match(r'(\w+)\s*->\s*(\w+)$', line)
+            if not m:
+                self.errors.append('line %d: expected "SOURCE -> TARGET"' % no)
+                continue
+            src, tgt = m.group(1), m.group(2)
+            if src.startswith('EVT_SRC_'):
+                src = src[8:]
+            if tgt.startswith('AOS_'):
+                tgt = tgt[4:]
+            if src not in events or src == 'MAX':
+                self.errors.append('line %d: unknown event %s' % (no, src))
+            elif tgt not in targets:
+                self.errors.append('line %d: unknown target %s' % (no, tgt))
+            else:
+                self.links.append((src, tgt, no))
+        if len(self.links) > LINK_MAX:
+            self.errors.append('%d links, AOSG_LINK_MAX is %d' % (len(self.links), LINK_MAX))
+
+    def plan(self):
+        """AOSG_Check: 分配输入位置, 检查公共触发和回环"""
+        slots = []
+        comm = [None] * COMM_NUM
+        for i, (src, tgt, no) in enumerate(self.links):
+            before = [j for j in range(i) if self.links[j][1] == tgt]
+            if any(self.links[j][0] == src for j in before):
+                self.errors.append('line %d: duplicate link %s -> %s' % (no, src, tgt))
+                self.err = (ERR_DUPLICATE, i)
+                return None
+            if not before:
+                slots.append(0)
+                continue
+            for k in range(COMM_NUM):
+                if comm[k] in (None, src):
+                    break
+            else:
+                self.errors.append('line %d: %s needs a third common trigger' % (no, tgt))
+                self.err = (ERR_COMM_FULL, i)
+                return None
+            if any(slots[j] == k + 1 for j in before):
+                self.errors.append('line %d: %s already uses COMTRG%d' % (no, tgt, k + 1))
+                self.err = (ERR_DUPLICATE, i)
+                return None
+            comm[k] = src
+            slots.append(k + 1)
+        edges = {}
+        for src, tgt, _ in self.links:
+            sm = source_module(src)
+            if sm:
+                edges.setdefault(sm, set()).add(target_module(tgt))
+        loop = self.find_loop(edges)
+        if loop:
+            self.errors.append('loop: ' + ' -> '.join(loop))
+            left = self.loop_modules(edges)
+            self.err = (ERR_LOOP, next(i for i, (_, t, _) in enumerate(self.links) if target_module(t) in left))
+            return None
+        return slots, comm
+
+    @staticmethod
+    def loop_modules(edges):
+        """逐个摘掉没有输入的模块后剩下的模块(在回环上或在回环下游)"""
+        nodes = set(edges) | {m for v in edges.values() for m in v}
+        indeg = {n: 0 for n in nodes}
+        for v in edges.values():
+            for m in v:
+                indeg[m] += 1
+        todo = [n for n in nodes if indeg[n] == 0]
+        while todo:
+            n = todo.pop()
+            nodes.discard(n)
+            for m in edges.get(n, ()):
+                indeg[m] -= 1
+                if indeg[m] == 0:
+                    todo.append(m)
+        return nodes
+
+    @staticmethod
+    def find_loop(edges):
+        state = {}
+        stack = []
+
+        def visit(n):
+            state[n] = 1
+            stack.append(n)
+            for m in sorted(edges.get(n, ())):
+                if state.get(m) == 1:
+                    return stack[stack.index(m):] + [m]
+                if m not in state:
+                    r = visit(m)
+                    if r:
+                        return r
+            stack.pop()
+            state[n] = 2
+            return None
+
+        for n in sorted(edges):
+            if n not in state:
+                r = visit(n)
+                if r:
+                    return r
+        return None
+
+    def paths(self):
+        """与 AOSG_Describe 相同的根到末端路径, 每条为连线序号列表"""
+        tmods = {target_module(t) for _, t, _ in self.links}
+        out = []
+
+        def walk(path):
+            mod = target_module(self.links[path[-1]][1])
+            nxt = [i for i, (s, _, _) in enumerate(self.links) if source_module(s) == mod]
+            if not nxt:
+                out.append(path)
+            for i in nxt:
+                walk(path + [i])
+
+        for i, (src, _, _) in enumerate(self.links):
+            if source_module(src) not in tmods:
+                walk([i])
+        return out
+
+    def describe(self, path):
+        return ' => '.join('%s -> %s' % (self.links[i][0], self.links[i][1]) for i in path)
+
+    def describe_c(self, path):
+        """AOSG_Describe 的写法: 源事件写成 模块(事件号)"""
+        return ' => '.join('%s(%d) -> %s' % (source_module(self.links[i][0]) or 'EVT', self.events[self.links[i][0]],
+                                             self.links[i][1]) for i in path)
+
+
+def load_graph(args):
+    g = Graph(open(args.graph, encoding='utf-8'), load_events(DEVICE_HEADER), load_targets(AOS_HEADER))
+    if g.errors:
+        for e in g.errors:
+            print('ERROR ' + e)
+        return None, None
+    p = g.plan()
+    if p is None:
+        for e in g.errors:
+            print('ERROR ' + e)
+        return None, None
+    return g, p
+
+
+# 在 hc32_ll.h 之后强制包含: CM_AOS 改为内存中的结构
+REGS = r'''
+#ifndef __HOST_REGS_H__
+#define __HOST_REGS_H__
+extern CM_AOS_TypeDef m_stcAos;
+#undef CM_AOS
+#define CM_AOS              (&m_stcAos)
+#endif
+'''
+
+# 每行一张图 "n 事件号 目标序号 ...", 输出 R/D/A/C 行, 以 E 结束
+DRIVER = r'''
+#include <stdio.h>
+#include <string.h>
+
+CM_AOS_TypeDef m_stcAos;
+
+void FCG_Fcg0PeriphClockCmd(uint32_t u32Fcg0Periph, en_functional_state_t enNewState) {
+    (void)u32Fcg0Periph;
+    (void)enNewState;
+}
+
+/* AOS_xxx 是 m_stcAos 成员的地址, 不是常量, 运行时填表; -no-pie 保证地址在 32 位以内 */
+static uint32_t m_au32Target[%(count)d];
+
+#define TARGET_NUM          (sizeof(m_au32Target) / sizeof(m_au32Target[0]))
+
+static void HOST_TargetInit(void) {
+    uint32_t i = 0UL;
+%(targets)s
+}
+
+static char m_acText[65536];
+
+int main(void) {
+    stc_aosg_link_t astcLink[AOSG_LINK_MAX];
+    stc_aosg_plan_t stcPlan;
+    unsigned int n, v, t, i;
+    int32_t i32Ret;
+    char *pcLine;
+
+    HOST_TargetInit();
+    while (1 == scanf("%%u", &n)) {
+        for (i = 0U; i < n; i++) {
+            if ((2 != scanf("%%u %%u", &v, &t)) || (t >= TARGET_NUM) || (i >= AOSG_LINK_MAX)) {
+                return 2;
+            }
+            astcLink[i].enSrc = (en_event_src_t)v;
+            astcLink[i].u32Target = m_au32Target[t];
+        }
+        memset(&stcPlan, 0xA5, sizeof(stcPlan));
+        i32Ret = AOSG_Check(astcLink, (uint8_t)n, &stcPlan);
+        printf("R %%ld %%u %%u %%u %%u %%u %%u", (long)i32Ret, stcPlan.u8Err, stcPlan.u8ErrLink, stcPlan.u8Depth,
+               stcPlan.u8Roots, (unsigned)stcPlan.aenComm[0], (unsigned)stcPlan.aenComm[1]);
+        for (i = 0U; (LL_OK == i32Ret) && (i < n); i++) {
+            printf(" %%u", stcPlan.au8Slot[i]);
+        }
+        printf("\n");
+        if (LL_OK != i32Ret) {
+            printf("E\n");
+            continue;
+        }
+
+        if (0UL != AOSG_Describe(astcLink, (uint8_t)n, m_acText, sizeof(m_acText))) {
+            for (pcLine = strtok(m_acText, "\n"); NULL != pcLine; pcLine = strtok(NULL, "\n")) {
+                printf("D %%s\n", pcLine);
+            }
+        }
+
+        /* 复位值下 Apply, 输出被改动的寄存器 */
+        for (i = 0U; i < TARGET_NUM; i++) {
+            *(uint32_t *)m_au32Target[i] = AOSG_TRGSEL_NONE;
+        }
+        m_stcAos.COMTRG1 = AOSG_TRGSEL_NONE;
+        m_stcAos.COMTRG2 = AOSG_TRGSEL_NONE;
+        i32Ret = AOSG_Apply(astcLink, (uint8_t)n, &stcPlan);
+        printf("P %%ld\n", (long)i32Ret);
+        for (i = 0U; i < TARGET_NUM; i++) {
+            if (AOSG_TRGSEL_NONE != *(uint32_t *)m_au32Target[i]) {
+                printf("A %%u %%lu\n", i, (unsigned long)*(uint32_t *)m_au32Target[i]);
+            }
+        }
+        printf("C %%lu %%lu\n", (unsigned long)m_stcAos.COMTRG1, (unsigned long)m_stcAos.COMTRG2);
+        AOSG_Release(astcLink, (uint8_t)n, &stcPlan);
+        for (i = 0U; i < TARGET_NUM; i++) {
+            if (AOSG_TRGSEL_NONE != *(uint32_t *)m_au32Target[i]) {
+                printf("L %%u\n", i);
+            }
+        }
+        printf("E\n");
+    }
+    return 0;
+}
+'''
+
+
+class CBuild:
+    """编译 aos_graph.c, 按目标名序号传连线"""
+
+    def __init__(self, cc, targets):
+        self.names = sorted(targets)
+        self.index = {n: i for i, n in enumerate(self.names)}
+        self.tmp = tempfile.mkdtemp()
+        self.exe = None
+        table = '\n'.join('    m_au32Target[i++] = AOS_%s;' % n for n in self.names)
+        files = {'host_regs.h': REGS, 'driver.c': '#include "aos_graph.h"\n' + DRIVER % {'targets': table, 'count': len(self.names)}}
+        for name, text in files.items():
+            with open(os.path.join(self.tmp, name), 'w', encoding='utf-8') as f:
+                f.write(text)
+        exe = os.path.join(self.tmp, 'aos_graph_host')
+        inc = []
+        for d in ('User', 'User/BSP', 'Boot', 'Library'):
+            inc += ['-I', os.path.join(ROOT, d)]
+        cmd = [cc, '-std=gnu99', '-O1', '-w', '-no-pie', '-fno-pie', '-DHC32F4A0', '-DUSE_DDL_DRIVER'] + inc + \
+              ['-include', 'hc32_ll.h', '-include', os.path.join(self.tmp, 'host_regs.h'),
+               GRAPH_SOURCE, os.path.join(self.tmp, 'driver.c'), '-o', exe]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+        else:
+            self.exe = exe
+
+    def close(self):
+        shutil.rmtree(self.tmp, ignore_errors=True)
+
+    def run(self, graphs):
+        """每张图返回 dict: ret/err/link/depth/roots/comm/slots/paths/apply/regs/left"""
+        text = ''
+        for g in graphs:
+            text += '%d %s\n' % (len(g.links), ' '.join('%d %d' % (g.events[s], self.index[t]) for s, t, _ in g.links))
+        r = subprocess.run([self.exe], input=text, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                           universal_newlines=True)
+        out, cur = [], None
+        for line in r.stdout.splitlines():
+            tag, _, rest = line.partition(' ')
+            if tag == 'R':
+                v = [int(x) for x in rest.split()]
+                cur = dict(ret=v[0], err=v[1], link=v[2], depth=v[3], roots=v[4], comm=v[5:7], slots=v[7:],
+                           paths=[], apply=None, regs={}, comtrg=None, left=[])
+            elif tag == 'D':
+                cur['paths'].append(rest)
+            elif tag == 'P':
+                cur['apply'] = int(rest)
+            elif tag == 'A':
+                i, v = rest.split()
+                if not self.names[int(i)].startswith('COMM_'):   # COMTRG 由 C 行单独比对
+                    cur['regs'][self.names[int(i)]] = int(v)
+            elif tag == 'C':
+                cur['comtrg'] = [int(x) for x in rest.split()]
+            elif tag == 'L' and not self.names[int(rest)].startswith('COMM_'):
+                cur['left'].append(self.names[int(rest)])
+            elif tag == 'E':
+                out.append(cur)
+        if r.returncode != 0 or len(out) != len(graphs):
+            raise RuntimeError('驱动异常: 返回 %d, %d/%d 张图 %s' % (r.returncode, len(out), len(graphs),
+                                                                r.stdout.strip()[-200:]))
+        return out
+
+
+def compare(g, c):
+    """Python 模型与 aos_graph.c 的结果比较, 返回差异列表"""
+    diffs = []
+    p = g.plan()
+    if (c['err'], c['link'] if c['err'] else 0) != g.err:
+        diffs.append('AOSG_Check 出错原因/连线 %d/%d, 模型 %d/%d' % (c['err'], c['link'], g.err[0], g.err[1]))
+    if (c['ret'] == 0) != (p is not None):
+        diffs.append('AOSG_Check 返回 %d, 模型%s' % (c['ret'], '通过' if p else '拒绝'))
+    if p is None or c['ret'] != 0:
+        return diffs
+    slots, comm = p
+    paths = g.paths()
+    tmods = {target_module(t) for _, t, _ in g.links}
+    roots = sum(1 for s, _, _ in g.links if source_module(s) not in tmods)
+    ccomm = [g.events[x] if x else TRGSEL_NONE for x in comm]
+    if c['slots'] != slots:
+        diffs.append('输入位置 %s, 模型 %s' % (c['slots'], slots))
+    if c['comm'] != ccomm:
+        diffs.append('公共触发 %s, 模型 %s' % (c['comm'], ccomm))
+    if c['depth'] != max(len(x) for x in paths) or c['roots'] != roots:
+        diffs.append('级数/根数 %d/%d, 模型 %d/%d' % (c['depth'], c['roots'], max(len(x) for x in paths), roots))
+    want = [g.describe_c(x) for x in paths]
+    if c['paths'] != want:
+        diffs.append('AOSG_Describe %s, 模型 %s' % (c['paths'][:3], want[:3]))
+    regs = {}
+    for (src, tgt, _), slot in zip(g.links, slots):
+        regs[tgt] = regs.get(tgt, 0) | (g.events[src] if slot == 0 else 1 << (29 + slot))
+    if c['apply'] != 0 or c['regs'] != regs or c['comtrg'] != ccomm:
+        diffs.append('AOSG_Apply 返回 %d, 寄存器 %s COMTRG %s, 模型 %s COMTRG %s' % (
+            c['apply'], c['regs'], c['comtrg'], regs, ccomm))
+    if c['left']:
+        diffs.append('AOSG_Release 后仍有寄存器未复位: %s' % c['left'])
+    return diffs
+
+
+ERR_NAME = {1: 'unknown target', 2: 'event out of range', 3: 'duplicate', 4: 'third common trigger', 5: 'loop',
+            6: 'occupied'}
+
+
+def check(args):
+    events, targets = load_events(DEVICE_HEADER), load_targets(AOS_HEADER)
+    g = Graph(open(args.graph, encoding='utf-8'), events, targets)
+    if g.errors:
+        for e in g.errors:
+            print('ERROR ' + e)
+        return 1
+    cb = CBuild(args.cc, targets)
+    try:
+        if cb.exe is None:
+            return 1
+        c = cb.run([g])[0]
+    finally:
+        cb.close()
+    diffs = compare(g, c)
+    names = {v: k for k, v in events.items()}
+    if c['ret'] != 0:
+        print('ERROR AOSG_Check %d: %s at line %d' % (c['ret'], ERR_NAME.get(c['err'], c['err']),
+                                                      g.links[c['link']][2]))
+        for e in g.errors:
+            print('  ' + e)
+    else:
+        for (src, tgt, no), slot in zip(g.links, c['slots']):
+            print('line %-3d %-22s -> %-10s %s' % (no, src, tgt, 'TRGSEL' if slot == 0 else 'COMTRG%d' % slot))
+        for k, v in enumerate(c['comm']):
+            if v != TRGSEL_NONE:
+                print('COMTRG%d = %s' % (k + 1, names[v]))
+        print('%d path(s), longest %d hop(s):' % (len(c['paths']), c['depth']))
+        for x in c['paths']:
+            print('  ' + x)
+    for d in diffs:
+        print('MISMATCH ' + d)
+    return 1 if (c['ret'] != 0 or diffs) else 0
+
+
+# 内置图: (名称, 期望的 AOSG_ERR_xxx, 连线)
+BUILTIN = [
+    ('chain', ERR_NONE, ['TMR6_1_GCMP_A -> ADC1_0', 'ADC1_EOCA -> DMA1_0', 'DMA1_TC0 -> DCU1']),
+    ('merge', ERR_NONE, ['TMR6_1_GCMP_A -> DMA1_1', 'TMR0_1_CMP_A -> DMA1_1', 'TMR2_1_CMP_A -> DMA1_1',
+                         'PORT_EIRQ0 -> DMA2_0', 'TMR0_1_CMP_A -> DMA2_0']),
+    ('fanout', ERR_NONE, ['TMR6_1_GCMP_A -> ADC1_0', 'ADC1_EOCA -> DMA1_0', 'ADC1_EOCA -> DMA2_0',
+                          'DMA1_TC0 -> DCU1', 'DMA2_TC0 -> DCU2']),
+    ('loop', ERR_LOOP, ['DMA1_TC0 -> DCU1', 'DCU1 -> DMA1_1']),
+    ('self loop', ERR_LOOP, ['PORT_EIRQ0 -> DCU1', 'DMA1_TC0 -> DMA1_1']),
+    ('loop downstream', ERR_LOOP, ['TMR6_1_GCMP_A -> ADC1_0', 'ADC1_EOCA -> DMA1_0', 'DMA1_TC0 -> ADC1_1',
+                                   'DMA1_BTC0 -> DCU3']),
+    ('duplicate', ERR_DUPLICATE, ['TMR6_1_GCMP_A -> ADC1_0', 'TMR0_1_CMP_A -> ADC1_0', 'TMR6_1_GCMP_A -> ADC1_0']),
+    ('third common trigger', ERR_COMM_FULL, ['PORT_EIRQ0 -> DMA1_0', 'TMR0_1_CMP_A -> DMA1_0',
+                                             'PORT_EIRQ0 -> DMA1_1', 'TMR0_1_CMP_B -> DMA1_1',
+                                             'PORT_EIRQ0 -> DMA1_2', 'TMR2_1_CMP_A -> DMA1_2']),
+]
+
+
+def random_graph(rnd, events, targets):
+    """随机图: 模块随机排序, 多数连线从排在前面的模块接到后面的模块, 少数反向以产生回环"""
+    by_mod, roots = {}, []
+    for name in events:
+        if name == 'MAX':
+            continue
+        m = source_module(name)
+        if m:
+            by_mod.setdefault(m, []).append(name)
+        else:
+            roots.append(name)
+    tgts = {}
+    for name in targets:
+        if not name.startswith('COMM_'):
+            tgts.setdefault(target_module(name), []).append(name)
+    mods = sorted(tgts)
+    rnd.shuffle(mods)
+    # 少量事件和目标, 让同一目标多路输入和公共触发争用经常出现
+    pool = {m: rnd.sample(by_mod.get(m, roots), min(3, len(by_mod.get(m, roots)))) for m in mods}
+    tpool = {m: rnd.sample(tgts[m], min(2, len(tgts[m]))) for m in mods}
+    use = mods[:rnd.randint(2, 6)]
+    back = rnd.random() < 0.3
+    lines = []
+    for _ in range(rnd.randint(1, LINK_MAX)):
+        ti = rnd.randrange(len(use))
+        tgt = rnd.choice(tpool[use[ti]])
+        if ti == 0 or rnd.random() < 0.25:
+            src = rnd.choice(roots[:8])
+        elif back and rnd.random() < 0.2:
+            src = rnd.choice(pool[use[rnd.randrange(ti, len(use))]])
+        else:
+            src = rnd.choice(pool[use[rnd.randrange(ti)]])
+        line = '%s -> %s' % (src, tgt)
+        if line not in lines or rnd.random() < 0.03:
+            lines.append(line)
+    return lines
+
+
+def ctest(args):
+    events, targets = load_events(DEVICE_HEADER), load_targets(AOS_HEADER)
+    rnd = random.Random(args.seed)
+    cases = []
+    for path in args.graph:
+        cases.append((path, None, list(open(path, encoding='utf-8'))))
+    cases += BUILTIN
+    for i in range(args.cases):
+        cases.append(('random %d' % i, None, random_graph(rnd, events, targets)))
+    graphs = []
+    fails = []
+    for name, want, lines in cases:
+        g = Graph(lines, events, targets)
+        if g.errors:
+            fails.append('%s: %s' % (name, '; '.join(g.errors)))
+        graphs.append(g)
+    cb = CBuild(args.cc, targets)
+    try:
+        if cb.exe is None:
+            return 1
+        res = cb.run(graphs)
+    finally:
+        cb.close()
+    count = {}
+    for (name, want, lines), g, c in zip(cases, graphs, res):
+        count[c['err']] = count.get(c['err'], 0) + 1
+        for d in compare(g, c):
+            fails.append('%s: %s' % (name, d))
+        if want is not None and c['err'] != want:
+            fails.append('%s: AOSG_Check 得到 %s, 应为 %s' % (name, ERR_NAME.get(c['err'], 'ok'),
+                                                         ERR_NAME.get(want, 'ok')))
+    for msg in fails[:MAX_REPORT]:
+        print(msg)
+    print('%d 张图: 通过 %d, 回环 %d, 重复 %d, 公共触发不够 %d; 差异 %d 项' % (
+        len(cases), count.get(ERR_NONE, 0), count.get(ERR_LOOP, 0), count.get(ERR_DUPLICATE, 0),
+        count.get(ERR_COMM_FULL, 0), len(fails)))
+    return 1 if fails else 0
+
+
+def gen(args):
+    g, _ = load_graph(args)
+    if g is None:
+        return 1
+    print('static const stc_aosg_link_t %s[] = {' % args.name)
+    for src, tgt, _ in g.links:
+        print('    {EVT_SRC_%s, AOS_%s},' % (src, tgt))
+    print('};')
+    return 0
+
+
+def percentile(v, q):
+    v = sorted(v)
+    return v[min(len(v) - 1, int(q * len(v)))]
+
+
+def sim(args):
+    g, _ = load_graph(args)
+    if g is None:
+        return 1
+    lat = dict(DEFAULT_LAT)
+    for item in args.lat or []:
+        k, v = item.split('=')
+        lat[k.upper()] = float(v)
+    rnd = random.Random(args.seed)
+    cycle = 1.0 / args.pclk
+    print('%-60s %8s %8s %8s %8s' % ('path (us)', 'min', 'mean', 'p99', 'max'))
+    for path in g.paths():
+        hw, sw = [], []
+        for _ in range(args.n):
+            t_hw = t_sw = 0.0
+            for i in path:
+                work = lat[target_module(g.links[i][1])]
+                # 硬件: AOS 同步 args.aos_cycles 个 PCLK, 相位不确定 1 个周期
+                t_hw += (args.aos_cycles + rnd.random()) * cycle + work
+                # 软件: 上一级完成中断 -> 进入中断 -> 写寄存器触发下一级, 可能被更高优先级中断推迟
+                t_sw += args.isr_us + work
+                if rnd.random() < args.busy:
+                    t_sw += rnd.uniform(0.0, args.preempt_us)
+            hw.append(t_hw)
+            sw.append(t_sw)
+        print(g.describe(path))
+        for name, v in (('  hardware', hw), ('  isr chain', sw)):
+            print('%-60s %8.3f %8.3f %8.3f %8.3f' % (name, min(v), sum(v) / len(v), percentile(v, 0.99), max(v)))
+    return 0
+
+
+def selftest(args):
+    events = load_events(DEVICE_HEADER)
+    targets = load_targets(AOS_HEADER)
+    text = open(GRAPH_SOURCE, encoding='utf-8').read()
+    errors = 0
+    rows = re.findall(r'\{&CM_AOS->(\w+),\s*AOSG_MOD_(\w+),\s*"(\w+)"\}', text)
+    for reg, mod, name in rows:
+        if targets.get(name) != reg:
+            print('target %s: AOS_%s is %s in hc32_ll_aos.h, table says %s' % (name, name, targets.get(name), reg))
+            errors += 1
+        if target_module(name) != mod:
+            print('target %s: module %s, tool says %s' % (name, mod, target_module(name)))
+            errors += 1
+    for name in targets:
+        if not name.startswith('COMM_') and name not in [r[2] for r in rows]:
+            print('target %s missing from m_astcTarget' % name)
+            errors += 1
+    ranges = [(int(a), int(b), m) for a, b, m in re.findall(r'\{(\d+)U,\s*(\d+)U,\s*AOSG_MOD_(\w+)\}', text)]
+    for name, val in events.items():
+        c = next((m for a, b, m in ranges if a <= val <= b), None)
+        py = source_module(name)
+        if c != py:
+            print('event %s (%d): aos_graph.c says %s, tool says %s' % (name, val, c, py))
+            errors += 1
+    print('%d targets, %d ranges, %d events checked, %d error(s)' % (len(rows), len(ranges), len(events), errors))
+    return 1 if errors else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description='AOS event graph check / codegen / latency simulation')
+    sub = ap.add_subparsers(dest='cmd')
+    for name in ('check', 'gen', 'sim'):
+        p = sub.add_parser(name)
+        p.add_argument('graph')
+    sub.choices['gen'].add_argument('--name', default='m_astcGraph', help='array name')
+    sub.choices['check'].add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    p = sub.choices['sim']
+    p.add_argument('--pclk', type=float, default=120.0, help='AOS clock, MHz')
+    p.add_argument('--aos-cycles', type=float, default=2.0, help='AOS propagation, clocks')
+    p.add_argument('--lat', action='append', help='MODULE=us, time from trigger to the module\'s next event')
+    p.add_argument('--isr-us', type=float, default=0.6, help='interrupt entry + handler to retrigger, us')
+    p.add_argument('--busy', type=float, default=0.2, help='probability a higher-priority ISR is running')
+    p.add_argument('--preempt-us', type=float, default=5.0, help='longest higher-priority ISR, us')
+    p.add_argument('--n', type=int, default=20000)
+    p.add_argument('--seed', type=int, default=1)
+    sub.add_parser('selftest')
+    p = sub.add_parser('ctest')
+    p.add_argument('graph', nargs='*')
+    p.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    p.add_argument('--cases', type=int, default=2000)
+    p.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    if args.cmd is None:
+        ap.print_help()
+        return 2
+    return {'check': check, 'gen': gen, 'sim': sim, 'selftest': selftest, 'ctest': ctest}[args.cmd](args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
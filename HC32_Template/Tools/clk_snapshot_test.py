@@ -0,0 +1,402 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Library/hc32_ll_clk.c 中 CLK_Snapshot* 的主机检查: 用主机编译器编译 hc32_ll_clk.c 和
+Boot/system_hc32f4a0sitb.c, CMU/PWC/DWT 寄存器接到内存中的时钟模型上.
+
+模型: STOP 唤醒后系统时钟为 MRC 或 HRC, XTAL 和 PLL 已停, SystemCoreClock 仍是进入 STOP 前的值;
+振荡器和 PLL 在使能后按随机的起振时间置稳定标志; DWT 周期计数按当前系统时钟推进, 每次
+CLK_SnapshotRestorePoll 之间耗 --poll 个周期, CLK_Delay 每次循环耗 --loop 个周期
+(CLK_Delay 是纯空转, 只有这一个函数换成按次数推进计数的版本, 其余为库中原样代码).
+
+    clk_snapshot_test.py [--cc gcc] [--seed 1] [--cases 2000] [--loop 6] [--poll 40] [--slack 50]
+        随机组合唤醒时钟、保存的系统时钟(PLLH 各档、XTAL、HRC)、HCLK 分频、唤醒后 SCFGR 是否保留
+        和起振时间. 检查项:
+          1. RestorePoll 最终返回 LL_OK, CKSWR/SCFGR/PLLHCFGR/PLLACFGR 和振荡器开关与保存时一致,
+             FCG0~3 恢复为调用前的值, SystemCoreClock 为保存的系统时钟频率;
+          2. 切换前的每次 CLK_Delay 次数按唤醒时钟的 HCLK 计(HCLK / 50000), 切换后按保存的时钟计;
+          3. u32WakeCycles 等于模型中从 RestoreStart 到写 CKSWR 的唤醒时钟周期数;
+             从 RestoreStart 到写 CKSWR 的时间不超过需要等待的振荡器/PLL 起振时间、切换前
+             CLK_Delay 耗时与 --slack 微秒之和;
+          4. 库中 DDL_ASSERT 不触发(按 __DEBUG 编译).
+        并报告唤醒恢复耗时(us)和切换前 CLK_Delay 总耗时(us)的平均值和最大值.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 CLK_Snapshot* 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+CLK_C = os.path.join(ROOT, 'Library', 'hc32_ll_clk.c')
+SYSTEM_C = os.path.join(ROOT, 'Boot', 'system_hc32f4a0sitb.c')
+MAX_REPORT = 20
+MRC_HZ, HRC_HZ, XTAL_HZ = 8000000, 16000000, 8000000
+
+# 在 hc32_ll.h 之后强制包含: 寄存器指针改为内存中的结构
+REGS = r'''
+#ifndef __HOST_REGS_H__
+#define __HOST_REGS_H__
+extern CM_CMU_TypeDef m_stcCmu;
+extern CM_PWC_TypeDef m_stcPwc;
+extern bCM_CMU_TypeDef m_stcCmuBit;
+extern DWT_Type m_stcDwt;
+extern CoreDebug_Type m_stcCoreDebug;
+extern uint32_t m_u32HrcFreqMon;
+void HOST_Delay(uint32_t u32Delay);
+#undef CM_CMU
+#undef CM_PWC
+#undef bCM_CMU
+#undef DWT
+#undef CoreDebug
+#define CM_CMU              (&m_stcCmu)
+#define CM_PWC              (&m_stcPwc)
+#define bCM_CMU             (&m_stcCmuBit)
+#define DWT                 (&m_stcDwt)
+#define CoreDebug           (&m_stcCoreDebug)
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+CM_CMU_TypeDef m_stcCmu;
+CM_PWC_TypeDef m_stcPwc;
+bCM_CMU_TypeDef m_stcCmuBit;
+DWT_Type m_stcDwt;
+CoreDebug_Type m_stcCoreDebug;
+uint32_t m_u32HrcFreqMon;
+
+#define MRC_HZ      (8000000.0)
+#define HRC_HZ      (16000000.0)
+#define XTAL_HZ     (8000000.0)
+
+static uint32_t m_u32Loop, m_u32Poll, m_u32Slack;
+static double m_dNowUs;                 /* 模型时间 */
+static double m_adReadyUs[4];           /* HRC/XTAL/PLLH/PLLA 稳定时刻, <0: 未使能 */
+static double m_adStartUs[4];           /* 起振时间 */
+static uint8_t m_u8Wake;
+static uint8_t m_u8Switched;
+static uint32_t m_u32SwitchCycle;       /* 写 CKSWR 时的周期计数和模型时间 */
+static double m_dSwitchUs;
+static uint32_t m_u32Asserts;
+static int m_iFails;
+
+static double m_dSettleUs;              /* 切换前 CLK_Delay 的总耗时 */
+
+void DDL_AssertHandler(const char *file, int line) {
+    if (m_u32Asserts++ < 4U) {
+        printf("fail: DDL_ASSERT %s:%d\n", file, line);
+    }
+    m_iFails++;
+}
+
+static double ClockHz(void) {
+    uint32_t plln, pllp, pllm;
+
+    switch (m_stcCmu.CKSWR & CMU_CKSWR_CKSW) {
+        case 0U: return HRC_HZ;
+        case 1U: return MRC_HZ;
+        case 3U: return XTAL_HZ;
+        case 5U:
+            plln = (m_stcCmu.PLLHCFGR & CMU_PLLHCFGR_PLLHN) >> CMU_PLLHCFGR_PLLHN_POS;
+            pllp = (m_stcCmu.PLLHCFGR & CMU_PLLHCFGR_PLLHP) >> CMU_PLLHCFGR_PLLHP_POS;
+            pllm = (m_stcCmu.PLLHCFGR & CMU_PLLHCFGR_PLLHM) >> CMU_PLLHCFGR_PLLHM_POS;
+            return XTAL_HZ / (pllm + 1U) * (plln + 1U) / (pllp + 1U);
+        default: return MRC_HZ;
+    }
+}
+
+/* 按当前时钟推进 n 个周期, 并更新振荡器稳定标志 */
+static void Advance(uint32_t n) {
+    static const uint8_t au8Flag[4] = {CMU_OSCSTBSR_HRCSTBF, CMU_OSCSTBSR_XTALSTBF,
+                                       CMU_OSCSTBSR_PLLHSTBF, CMU_OSCSTBSR_PLLASTBF};
+    uint8_t on[4];
+    uint32_t i;
+
+    m_stcDwt.CYCCNT += n;
+    m_dNowUs += n / ClockHz() * 1e6;
+
+    on[0] = (0U == (m_stcCmu.HRCCR & CMU_HRCCR_HRCSTP));
+    on[1] = (0U == (m_stcCmu.XTALCR & CMU_XTALCR_XTALSTP));
+    on[2] = (0U == (m_stcCmu.PLLHCR & CMU_PLLHCR_PLLHOFF));
+    on[3] = (0U == (m_stcCmu.PLLACR & CMU_PLLACR_PLLAOFF));
+    for (i = 0U; i < 4U; i++) {
+        if (!on[i]) {
+            m_adReadyUs[i] = -1.0;
+            m_stcCmu.OSCSTBSR &= (uint8_t)~au8Flag[i];
+        } else if (m_adReadyUs[i] < 0.0) {
+            m_adReadyUs[i] = m_dNowUs + m_adStartUs[i];
+        } else if (m_dNowUs >= m_adReadyUs[i]) {
+            m_stcCmu.OSCSTBSR |= au8Flag[i];
+        }
+    }
+}
+
+/* CLK_SYSCLK_SW_STB 应按此刻运行的时钟计: HCLK / 50000 */
+void HOST_Delay(uint32_t u32Delay) {
+    uint32_t u32Hclk = (uint32_t)ClockHz() >> ((m_stcCmu.SCFGR & CMU_SCFGR_HCLKS) >> CMU_SCFGR_HCLKS_POS);
+
+    if (u32Delay != u32Hclk / 50000UL) {
+        printf("fail: %s CLK_Delay(%lu), 此时 HCLK %lu Hz 应为 %lu\n",
+               (m_stcCmu.CKSWR == m_u8Wake) ? "切换前" : "切换后", (unsigned long)u32Delay,
+               (unsigned long)u32Hclk, (unsigned long)(u32Hclk / 50000UL));
+        m_iFails++;
+    }
+    if (m_stcCmu.CKSWR == m_u8Wake) {
+        m_dSettleUs += u32Delay * (double)m_u32Loop / ClockHz() * 1e6;
+    } else if (!m_u8Switched) {
+        /* 写 CKSWR 后的第一次延时, 其间计数未推进 */
+        m_u8Switched = 1U;
+        m_u32SwitchCycle = m_stcDwt.CYCCNT;
+        m_dSwitchUs = m_dNowUs;
+    }
+    Advance(u32Delay * m_u32Loop);
+}
+
+static uint32_t Arg(int argc, char **argv, const char *key, uint32_t def) {
+    size_t n = strlen(key);
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((0 == strncmp(argv[i], key, n)) && ('=' == argv[i][n])) {
+            return (uint32_t)strtoul(argv[i] + n + 1, NULL, 0);
+        }
+    }
+    return def;
+}
+
+int main(int argc, char **argv) {
+    stc_clock_snapshot_t stcSnap;
+    uint32_t u32Wake = Arg(argc, argv, "wake", 1U);        /* CKSWR: 1 MRC, 0 HRC */
+    uint32_t u32Src = Arg(argc, argv, "src", 5U);          /* 保存的 CKSWR */
+    uint32_t u32Hclks = Arg(argc, argv, "hclks", 0U);
+    uint32_t u32Pllh = Arg(argc, argv, "pllh", 0U);
+    uint32_t u32Keep = Arg(argc, argv, "keep", 1U);        /* 唤醒后 SCFGR 保留 */
+    uint32_t u32Scfgr = (u32Hclks << CMU_SCFGR_HCLKS_POS) | (u32Hclks << CMU_SCFGR_PCLK1S_POS);
+    uint32_t au32Fcg[4] = {0x0123A5A0UL, 0xFEDC0001UL, 0x00FF00FFUL, 0x5A5AA5A5UL};
+    uint32_t u32SavedHz, u32Polls = 0U, i;
+    double dStartUs, dLimitUs = 0.0;
+    int32_t i32Ret;
+
+    m_u32Loop = Arg(argc, argv, "loop", 6U);
+    m_u32Poll = Arg(argc, argv, "poll", 40U);
+    m_u32Slack = Arg(argc, argv, "slack", 50U);
+    for (i = 0U; i < 4U; i++) {
+        m_adStartUs[i] = Arg(argc, argv, (0U == i) ? "thrc" : (1U == i) ? "txtal" : (2U == i) ? "tpll" : "tplla",
+                             100U);
+        m_adReadyUs[i] = -1.0;
+    }
+
+    /* 运行时的时钟树 */
+    m_u32HrcFreqMon = 1UL;                                  /* HRC 16MHz */
+    m_stcPwc.FPRC = PWC_FPRC_FPRCB0 | PWC_FPRC_FPRCB1;
+    m_stcPwc.FCG0PC = PWC_FCG0PC_PRT0;
+    m_stcCmu.HRCCR = (0U == u32Wake || 0U == u32Src || (5U == u32Src && 0U != (u32Pllh >> 31))) ? 0U : CMU_HRCCR_HRCSTP;
+    m_stcCmu.XTALCR = (3U == u32Src || 5U == u32Src) ? 0U : CMU_XTALCR_XTALSTP;
+    m_stcCmu.PLLHCR = (5U == u32Src) ? 0U : CMU_PLLHCR_PLLHOFF;
+    m_stcCmu.PLLACR = CMU_PLLACR_PLLAOFF;
+    m_stcCmu.PLLHCFGR = u32Pllh & 0x7FFFFFFFUL;
+    m_stcCmu.PLLACFGR = 0x11101300UL;
+    m_stcCmu.SCFGR = u32Scfgr;
+    m_stcCmu.CKSWR = (uint8_t)u32Src;
+    m_stcCmu.OSCSTBSR = 0x7FU;
+    SystemCoreClockUpdate();
+    u32SavedHz = SystemCoreClock;
+    (void)CLK_SnapshotSave(&stcSnap);
+
+    /* STOP 唤醒: 切到唤醒时钟, XTAL/PLL 停止, SystemCoreClock 不变 */
+    m_stcCmu.CKSWR = (uint8_t)u32Wake;
+    m_stcCmu.XTALCR = CMU_XTALCR_XTALSTP;
+    m_stcCmu.PLLHCR = CMU_PLLHCR_PLLHOFF;
+    m_stcCmu.PLLACR = CMU_PLLACR_PLLAOFF;
+    if (1U == u32Wake) {
+        m_stcCmu.HRCCR = CMU_HRCCR_HRCSTP;
+    }
+    if (!u32Keep) {
+        m_stcCmu.SCFGR = 0UL;
+    }
+    m_stcCmu.OSCSTBSR = (0U == u32Wake) ? CMU_OSCSTBSR_HRCSTBF : 0U;
+    m_stcPwc.FCG0 = au32Fcg[0];
+    m_stcPwc.FCG1 = au32Fcg[1];
+    m_stcPwc.FCG2 = au32Fcg[2];
+    m_stcPwc.FCG3 = au32Fcg[3];
+    m_stcDwt.CYCCNT = 0x12345678UL;
+    m_u8Wake = (uint8_t)u32Wake;
+
+    /* 需要起振的振荡器决定恢复时间下限 */
+    if (0U == stcSnap.u8HrcCr && 1U == u32Wake) {
+        dLimitUs = m_adStartUs[0];
+    }
+    if (0U == stcSnap.u8XtalCr && m_adStartUs[1] > dLimitUs) {
+        dLimitUs = m_adStartUs[1];
+    }
+    if (0U == stcSnap.u8PllhCr) {
+        dLimitUs += m_adStartUs[2];
+    }
+
+    dStartUs = m_dNowUs;
+    CLK_SnapshotRestoreStart(&stcSnap);
+    for (;;) {
+        i32Ret = CLK_SnapshotRestorePoll(&stcSnap);
+        if ((LL_ERR_BUSY != i32Ret) || (++u32Polls >= 1000000U)) {
+            if (!m_u8Switched) {
+                /* 无需切换: 在最后一次 Poll 里记录 */
+                m_u8Switched = 1U;
+                m_u32SwitchCycle = m_stcDwt.CYCCNT;
+                m_dSwitchUs = m_dNowUs;
+            }
+            break;
+        }
+        Advance(m_u32Poll);
+    }
+
+    if (LL_OK != i32Ret) {
+        printf("fail: RestorePoll 返回 %ld\n", (long)i32Ret);
+        m_iFails++;
+    }
+    if ((m_stcCmu.CKSWR != stcSnap.u8Ckswr) || (m_stcCmu.SCFGR != u32Scfgr) ||
+            (m_stcCmu.PLLHCFGR != stcSnap.u32PllhCfgr) || (m_stcCmu.PLLACFGR != stcSnap.u32PllaCfgr) ||
+            ((m_stcCmu.HRCCR & CMU_HRCCR_HRCSTP) != stcSnap.u8HrcCr && 0U == stcSnap.u8HrcCr) ||
+            ((m_stcCmu.XTALCR & CMU_XTALCR_XTALSTP) != stcSnap.u8XtalCr) ||
+            ((m_stcCmu.PLLHCR & CMU_PLLHCR_PLLHOFF) != stcSnap.u8PllhCr)) {
+        printf("fail: 寄存器未恢复 CKSWR %u SCFGR %08lx PLLHCFGR %08lx\n", (unsigned)m_stcCmu.CKSWR,
+               (unsigned long)m_stcCmu.SCFGR, (unsigned long)m_stcCmu.PLLHCFGR);
+        m_iFails++;
+    }
+    if ((m_stcPwc.FCG0 != au32Fcg[0]) || (m_stcPwc.FCG1 != au32Fcg[1]) ||
+            (m_stcPwc.FCG2 != au32Fcg[2]) || (m_stcPwc.FCG3 != au32Fcg[3])) {
+        printf("fail: FCG 未恢复\n");
+        m_iFails++;
+    }
+    if (SystemCoreClock != u32SavedHz) {
+        printf("fail: SystemCoreClock %lu, 应为 %lu\n", (unsigned long)SystemCoreClock, (unsigned long)u32SavedHz);
+        m_iFails++;
+    }
+    if (stcSnap.u32WakeCycles != m_u32SwitchCycle - 0x12345678UL) {
+        printf("fail: u32WakeCycles %lu, 模型 %lu\n", (unsigned long)stcSnap.u32WakeCycles,
+               (unsigned long)(m_u32SwitchCycle - 0x12345678UL));
+        m_iFails++;
+    }
+    if ((m_dSwitchUs - dStartUs) > dLimitUs + m_dSettleUs + m_u32Slack) {
+        printf("fail: 恢复耗时 %.1fus, 起振 %.1fus + 稳定延时 %.1fus + 余量 %luus\n", (m_dSwitchUs - dStartUs),
+               dLimitUs, m_dSettleUs, (unsigned long)m_u32Slack);
+        m_iFails++;
+    }
+
+    printf("restore_us=%.3f\n", (m_dSwitchUs - dStartUs));
+    printf("settle_us=%.3f\n", m_dSettleUs);
+    printf("wake_cycles=%lu\n", (unsigned long)stcSnap.u32WakeCycles);
+
+    return m_iFails ? 1 : 0;
+}
+'''
+
+
+def build(args, tmp):
+    with open(CLK_C, encoding='utf-8') as f:
+        clk = f.read()
+    # CLK_Delay 是空转, 换成按次数推进模型时间
+    clk, n = re.subn(r'static void CLK_Delay\(uint32_t u32Delay\) \{.*?\n\}',
+                     'static void CLK_Delay(uint32_t u32Delay) {\n    HOST_Delay(u32Delay);\n}', clk, flags=re.S)
+    if n != 1:
+        print('hc32_ll_clk.c 中找不到 CLK_Delay')
+        return None
+    with open(SYSTEM_C, encoding='utf-8') as f:
+        system = f.read()
+    system, n = re.subn(r'(#define HRC_FREQ_MON\(\)\s+)\(.*\)', r'\1(m_u32HrcFreqMon)', system)
+    if n != 1:
+        print('system_hc32f4a0sitb.c 中找不到 HRC_FREQ_MON')
+        return None
+    files = {'clk.c': clk, 'system.c': system, 'host_regs.h': REGS, 'driver.c': DRIVER}
+    for name, text in files.items():
+        with open(os.path.join(tmp, name), 'w', encoding='utf-8') as f:
+            f.write(text)
+    exe = os.path.join(tmp, 'clk_snapshot_test')
+    inc = []
+    for d in ('User', 'Boot', 'Library'):
+        inc += ['-I', os.path.join(ROOT, d)]
+    cmd = [args.cc, '-std=gnu99', '-O1', '-w', '-DHC32F4A0', '-DUSE_DDL_DRIVER', '-D__DEBUG'] + inc + \
+          ['-include', 'hc32_ll.h', '-include', os.path.join(tmp, 'host_regs.h')] + \
+          [os.path.join(tmp, n) for n in ('clk.c', 'system.c', 'driver.c')] + ['-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def pllh_cfg(rng):
+    """XTAL 8MHz 为源, 输出 120~240MHz 的 PLLHCFGR(M=1, N, P)"""
+    while True:
+        n = rng.randrange(74, 150)
+        p = rng.choice((1, 2, 3))
+        hz = XTAL_HZ * (n + 1) // (p + 1)
+        if 120000000 <= hz <= 240000000 and hz % 50000 == 0:
+            return (n << 8) | (p << 28) | (1 << 20) | (1 << 24), hz
+
+
+def run(exe, params):
+    cmd = [exe] + ['%s=%s' % kv for kv in sorted(params.items())]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    res, fails = {}, []
+    for line in r.stdout.splitlines():
+        if line.startswith('fail: '):
+            fails.append(line[6:])
+        elif '=' in line:
+            k, v = line.split('=', 1)
+            res[k] = float(v)
+    if r.returncode not in (0, 1):
+        fails.append('驱动异常退出: 返回 %d %s' % (r.returncode, r.stdout.strip()[-200:]))
+    return res, fails
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--cases', type=int, default=2000)
+    ap.add_argument('--loop', type=int, default=6, help='CLK_Delay 每次循环的周期数')
+    ap.add_argument('--poll', type=int, default=40, help='两次 RestorePoll 之间的周期数')
+    ap.add_argument('--slack', type=int, default=50, help='恢复耗时超出起振时间与稳定延时之和的上限, us')
+    args = ap.parse_args()
+    rng = random.Random(args.seed)
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args, tmp)
+        if exe is None:
+            return 1
+        fails, restore, settle = [], [], []
+        for case in range(args.cases):
+            src = rng.choice((5, 5, 5, 3, 0))
+            cfg, _ = pllh_cfg(rng)
+            params = dict(wake=rng.choice((1, 1, 0)), src=src, hclks=rng.choice((0, 0, 1)),
+                          pllh=cfg | (rng.choice((0, 1)) << 31), keep=rng.choice((1, 1, 0)),
+                          thrc=rng.randrange(2, 20), txtal=rng.randrange(200, 3000), tpll=rng.randrange(20, 200),
+                          tplla=100, loop=args.loop, poll=args.poll, slack=args.slack)
+            res, f = run(exe, params)
+            restore.append(res.get('restore_us', 0.0))
+            settle.append(res.get('settle_us', 0.0))
+            fails += ['第 %d 组 %s: %s' % (case, ' '.join('%s=%s' % kv for kv in sorted(params.items())), m)
+                      for m in f]
+        for msg in fails[:MAX_REPORT]:
+            print(msg)
+        print('唤醒恢复 %d 组: 恢复耗时 平均 %.1fus 最大 %.1fus, 切换前 CLK_Delay 平均 %.1fus 最大 %.1fus, 差异 %d 项' % (
+            args.cases, sum(restore) / len(restore), max(restore), sum(settle) / len(settle), max(settle),
+            len(fails)))
+        return 1 if fails else 0
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,1145 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/dcu_kernel.c 的逐位一致主机模型.
+
+按板上的执行方式建模: 样本按 DMA 块处理, DCU 寄存器按设定宽度截断, 累加按块统计进位,
+波形按 DCUK_WaveNext 的边界规则步进. 数据可来自文件(每行一个数, 支持 0x 前缀)或与
+DCUK_SelfTest 相同的 LCG.
+
+    dcu_model.py limit  [--input f | --num N] --width 16 --low 0x40 --high 0xFC0 [--first]
+        越限检查: 越限样本数、首个序号、块数、需要 CPU 定位的块数
+    dcu_model.py accum  [--input f | --num N] --max 0xFFF
+        32 位 DCU 累加: 64 位和、块长、块数、进位次数
+    dcu_model.py wave   --mode triangle --lower 0x100 --upper 0xE00 --step 0xB3 --n 64 [--c NAME]
+        波形序列, --c 输出 C 数组, 用来对照 DAC 输出或做查表备份
+    dcu_model.py gen    --num N --kind accum|limit [--name NAME]
+        输出自检数据的 C 数组
+    dcu_model.py selftest [--num N]
+        与 dcu_kernel.c 的常量对照, 模型与直接计算对照, 并打印 DCUK_SelfTest(N) 的期望值
+    dcu_model.py ctest [--cc gcc] [--cases 1000] [--seed 1] [--num 4096]
+        主机编译 dcu_kernel.c、aos_graph.c 和库中原样的 hc32_ll_dcu.c/hc32_ll_dma.c, DCU/DMA/AOS
+        寄存器接到内存中的硬件模型: DMA 按块逐个搬运并更新 MONSAR, 块结束置 BTC/TC 并挂起中断;
+        DCU 按数据宽度比较/相加, 置标志并按 INTEVTSEL 挂起中断; 中断按随机的 DMA 数据个数延迟
+        响应(DCU 与 DMA 中断先后随机), 比较标志随机为保持或逐次更新; CPU 在开中断处让硬件前进.
+        随机用例对照本模型, 检查项:
+          1. 越限检查(三种宽度, 全部/首个): 越限个数、首个序号、回调序列、块数、CPU 定位的块数、
+             u32Done 和 DMA 实际块长;
+          2. 累加: 64 位和、块数、DMA 实际块长等于按最大样本值限制后的块长, 每块进位不超过一次;
+          3. 波形: 每个事件后 DATA0 等于 wave 序列, DAC 为当前值或上一步(DMA 先响应时),
+             DCUK_WaveStop 后 AOS 寄存器复位;
+          4. DCUK_SelfTest 返回 LL_OK; 库中 DDL_ASSERT 不触发(按 __DEBUG 编译).
+        全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 dcu_kernel.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+KERNEL_SOURCE = os.path.join(ROOT, 'User', 'BSP', 'dcu_kernel.c')
+
+BLOCK_MAX = 1024
+WAVE_MAX = 0xFFF
+M32 = 0xFFFFFFFF
+
+# 与 dcu_kernel.c 相同
+TEST_SEED = 0x20261019
+TEST_LOW = 0x040
+TEST_HIGH = 0xFC0
+TEST_WAVE = ('triangle', 0x100, 0xE00, 0x0B3)
+TEST_WAVE_STEPS = 64
+
+
+def lcg(state):
+    """DCUK_Lcg, 返回 (新状态, 输出)"""
+    state = (state * 1664525 + 1013904223) & M32
+    return state, state
+
+
+def test_data(num, kind):
+    """DCUK_SelfTest 的数据: accum 为 24 位字, limit 为 12 位半字"""
+    state, out = TEST_SEED, []
+    for _ in range(num):
+        state, v = lcg(state)
+        out.append(v >> 8 if kind == 'accum' else v >> 20)
+    return out
+
+
+def limit(data, width, low, high, first=False):
+    """按块执行的越限检查, 与 DCUK_LimitStart 的中断流程相同"""
+    mask = (1 << (8 * width)) - 1
+    res = {'matches': 0, 'first': None, 'blocks': 0, 'scan_blocks': 0, 'hits': []}
+    lo, hi = low & mask, high & mask
+    for start in range(0, len(data), BLOCK_MAX):
+        block = [v & mask for v in data[start:start + BLOCK_MAX]]
+        res['blocks'] += 1
+        # DCU 中断只标记块, CPU 扫描被标记的块
+        if not any(v < lo or v > hi for v in block):
+            continue
+        res['scan_blocks'] += 1
+        for i, v in enumerate(block):
+            if v < lo or v > hi:
+                if res['first'] is None:
+                    res['first'] = start + i
+                res['matches'] += 1
+                res['hits'].append((start + i, v))
+                if first:
+                    return res
+    return res
+
+
+def block_len(max_sample):
+    """DCUK_AccumStart 的块长: 一块之和不超过 0xFFFFFFFF"""
+    return BLOCK_MAX if max_sample == 0 else min(BLOCK_MAX, M32 // max_sample)
+
+
+def accum(data, max_sample):
+    """DCU 32 位加法 + 块末进位计数, 返回与 DCUK_GetResult 相同的 u64Sum"""
+    blen = block_len(max_sample)
+    data0, carry, blocks, sums = 0, 0, 0, []
+    for start in range(0, len(data), blen):
+        flag = False
+        for v in data[start:start + blen]:
+            if v > max_sample:
+                raise ValueError('sample 0x%X at %d exceeds --max 0x%X' % (v, start, max_sample))
+            data0 += v & M32
+            if data0 > M32:
+                if flag:
+                    raise AssertionError('two carries in one block')
+                flag = True
+                data0 &= M32
+        carry += int(flag)
+        blocks += 1
+        sums.append((carry << 32) | data0)
+    return {'sum': (carry << 32) | data0, 'block_len': blen, 'blocks': blocks,
+            'carries': carry, 'running': sums}
+
+
+def wave_next(mode, val, down, lower, upper, step):
+    """DCUK_WaveNext, 返回 (新值, 是否下降)"""
+    if mode == 'saw_up':
+        return (lower if val + step > upper else val + step), down
+    if mode == 'saw_down':
+        return (upper if val < lower + step else val - step), down
+    if not down:
+        if val + step >= upper:
+            return upper, True
+        return val + step, False
+    if val <= lower + step:
+        return lower, False
+    return val - step, True
+
+
+def wave(mode, lower, upper, step, n):
+    """从起点(锯齿下降为上限, 其余为下限)开始, 返回 n 步之后的 DATA0"""
+    if not (0 <= lower < upper <= WAVE_MAX and 0 < step <= WAVE_MAX):
+        raise ValueError('need 0 <= lower < upper <= 0xFFF, 0 < step <= 0xFFF')
+    val = upper if mode == 'saw_down' else lower
+    down, out = False, []
+    for _ in range(n):
+        val, down = wave_next(mode, val, down, lower, upper, step)
+        out.append(val)
+    return out
+
+
+def c_array(name, ctype, values, per_line=8):
+    digits = {'uint16_t': 4, 'uint32_t': 8}[ctype]
+    lines = ['static const %s %s[%d] = {' % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join('0x%0*XU' % (digits, v) for v in values[i:i + per_line]) + ',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def load(args, kind):
+    if args.input:
+        with open(args.input) as f:
+            return [int(t, 0) for line in f for t in line.split('#')[0].replace(',', ' ').split()]
+    return test_data(args.num, kind)
+
+
+def cmd_limit(args):
+    data = load(args, 'limit')
+    r = limit(data, args.width, args.low, args.high, args.first)
+    print('samples %d  blocks %d  cpu-scanned blocks %d' % (len(data), r['blocks'], r['scan_blocks']))
+    print('matches %d  first %s' % (r['matches'], '-' if r['first'] is None else r['first']))
+    for i, v in r['hits'][:args.show]:
+        print('  [%d] 0x%X' % (i, v))
+    return 0
+
+
+def cmd_accum(args):
+    data = load(args, 'accum')
+    r = accum(data, args.max)
+    print('samples %d  block %d  blocks %d  carries %d' % (len(data), r['block_len'], r['blocks'], r['carries']))
+    print('sum %d (0x%016X)' % (r['sum'], r['sum']))
+    return 0
+
+
+def cmd_wave(args):
+    seq = wave(args.mode, args.lower, args.upper, args.step, args.n)
+    if args.c:
+        print(c_array(args.c, 'uint16_t', seq))
+    else:
+        print(' '.join('0x%03X' % v for v in seq))
+    return 0
+
+
+def cmd_gen(args):
+    data = test_data(args.num, args.kind)
+    ctype = 'uint32_t' if args.kind == 'accum' else 'uint16_t'
+    print(c_array(args.name or ('m_a%sDcuTest' % ('u32' if args.kind == 'accum' else 'u16')), ctype, data))
+    return 0
+
+
+def source_constants():
+    with open(KERNEL_SOURCE, encoding='utf-8') as f:
+        src = f.read()
+    got = {}
+    for name in ('TEST_SEED', 'TEST_LOW', 'TEST_HIGH', 'TEST_WAVE_STEPS', 'BLOCK_MAX'):
+        m = re.search(r'#define\s+DCUK_%s\s+\((0x[0-9A-Fa-f]+|\d+)U?L?\)' % name, src)
+        got[name] = int(m.group(1), 0) if m else None
+    m = re.search(r'(\d+)UL\s*\+\s*(\d+)UL', src[src.find('DCUK_Lcg(uint32_t'):])
+    got['LCG'] = (int(m.group(1)), int(m.group(2))) if m else None
+    wv = [re.search(r'stcWave\.%s\s*=\s*(0x[0-9A-Fa-f]+)UL' % k, src) for k in ('u32Lower', 'u32Upper', 'u32Step')]
+    got['WAVE'] = tuple(int(x.group(1), 0) for x in wv) if all(wv) else None
+    return got
+
+
+def cmd_selftest(args):
+    errs = []
+    header = os.path.join(ROOT, 'User', 'BSP', 'dcu_kernel.h')
+    with open(header, encoding='utf-8') as f:
+        hsrc = f.read()
+    m = re.search(r'#define\s+DCUK_BLOCK_MAX\s+\((\d+)U\)', hsrc)
+    if not m or int(m.group(1)) != BLOCK_MAX:
+        errs.append('DCUK_BLOCK_MAX differs from model')
+    got = source_constants()
+    want = {'TEST_SEED': TEST_SEED, 'TEST_LOW': TEST_LOW, 'TEST_HIGH': TEST_HIGH,
+            'TEST_WAVE_STEPS': TEST_WAVE_STEPS, 'LCG': (1664525, 1013904223), 'WAVE': TEST_WAVE[1:]}
+    for k, v in want.items():
+        if got.get(k) != v:
+            errs.append('dcu_kernel.c %s = %r, model %r' % (k, got.get(k), v))
+
+    # 模型与直接计算对照
+    rnd = random.Random(1)
+    for _ in range(200):
+        n = rnd.randint(1, 3000)
+        width = rnd.choice((1, 2, 4))
+        mask = (1 << (8 * width)) - 1
+        data = [rnd.getrandbits(8 * width) for _ in range(n)]
+        lo = rnd.randint(0, mask)
+        hi = rnd.randint(lo, mask)
+        direct = [i for i, v in enumerate(data) if v < lo or v > hi]
+        r = limit(data, width, lo, hi)
+        if [i for i, _ in r['hits']] != direct:
+            errs.append('limit model mismatch n=%d width=%d' % (n, width))
+            break
+        rf = limit(data, width, lo, hi, first=True)
+        if rf['first'] != (direct[0] if direct else None) or rf['matches'] != min(1, len(direct)):
+            errs.append('limit first mismatch')
+            break
+        mx = rnd.choice((0xFFF, 0xFFFF, 0xFFFFFF, M32, rnd.randint(1, M32)))
+        data = [rnd.randint(0, mx) for _ in range(n)]
+        if accum(data, mx)['sum'] != sum(data):
+            errs.append('accum model mismatch max=0x%X' % mx)
+            break
+    for mode in ('triangle', 'saw_up', 'saw_down'):
+        seq = wave(mode, 0x100, 0xE00, 0xB3, 200)
+        if min(seq) < 0x100 or max(seq) > 0xE00:
+            errs.append('wave %s out of limits' % mode)
+    tri = wave('triangle', 0x100, 0xE00, 0xB3, 200)
+    if 0x100 not in tri or 0xE00 not in tri:
+        errs.append('triangle does not reach both limits')
+
+    n = args.num
+    a = accum(test_data(n, 'accum'), 0x00FFFFFF)
+    lm = limit(test_data(n, 'limit'), 2, TEST_LOW, TEST_HIGH)
+    print('DCUK_SelfTest(%d) expects:' % n)
+    print('  accum  sum 0x%016X  blocks %d  carries %d' % (a['sum'], a['blocks'], a['carries']))
+    print('  limit  matches %d  first %s  cpu-scanned blocks %d/%d'
+          % (lm['matches'], lm['first'], lm['scan_blocks'], lm['blocks']))
+    print('  wave   %s' % ' '.join('0x%03X' % v for v in wave(*TEST_WAVE, n=8)) + ' ...')
+    for e in errs:
+        print('ERROR: ' + e)
+    print('selftest %s' % ('FAILED' if errs else 'ok'))
+    return 1 if errs else 0
+
+
+# ---------------------------------------------------------------------------
+# ctest: 主机编译 dcu_kernel.c + 库中 hc32_ll_dcu.c/hc32_ll_dma.c + aos_graph.c,
+# DCU/DMA/AOS 寄存器接到内存中的模型上
+
+GRAPH_SOURCE = os.path.join(ROOT, 'User', 'BSP', 'aos_graph.c')
+DCU_SOURCE = os.path.join(ROOT, 'Library', 'hc32_ll_dcu.c')
+DMA_SOURCE = os.path.join(ROOT, 'Library', 'hc32_ll_dma.c')
+MAX_REPORT = 20
+
+# 在 hc32_ll.h 之后强制包含: 外设指针改为内存中的结构, -no-pie 保证地址在 32 位以内
+REGS = r'''
+#ifndef __HOST_REGS_H__
+#define __HOST_REGS_H__
+extern CM_AOS_TypeDef m_stcAos;
+extern CM_DMA_TypeDef m_astcDma[2];
+extern uint32_t m_au32Dcu[8][256];
+void HOST_AosSwTrigger(void);
+#undef CM_AOS
+#undef CM_DMA1
+#undef CM_DMA2
+#undef CM_DCU1_BASE
+#undef CM_DCU2_BASE
+#undef CM_DCU3_BASE
+#undef CM_DCU4_BASE
+#undef CM_DCU5_BASE
+#undef CM_DCU6_BASE
+#undef CM_DCU7_BASE
+#undef CM_DCU8_BASE
+#define CM_AOS              (&m_stcAos)
+#define CM_DMA1             (&m_astcDma[0])
+#define CM_DMA2             (&m_astcDma[1])
+#define CM_DCU1_BASE        ((uint32_t)&m_au32Dcu[0][0])
+#define CM_DCU2_BASE        ((uint32_t)&m_au32Dcu[1][0])
+#define CM_DCU3_BASE        ((uint32_t)&m_au32Dcu[2][0])
+#define CM_DCU4_BASE        ((uint32_t)&m_au32Dcu[3][0])
+#define CM_DCU5_BASE        ((uint32_t)&m_au32Dcu[4][0])
+#define CM_DCU6_BASE        ((uint32_t)&m_au32Dcu[5][0])
+#define CM_DCU7_BASE        ((uint32_t)&m_au32Dcu[6][0])
+#define CM_DCU8_BASE        ((uint32_t)&m_au32Dcu[7][0])
+/* AOS_SW_Trigger 是写位带别名的内联函数 */
+#define AOS_SW_Trigger      HOST_AosSwTrigger
+#endif
+'''
+
+# core_cm4.h 在定义 CMSIS_NVIC_VIRTUAL 时包含此文件, NVIC 操作接到模型
+NVIC = r'''
+#ifndef __HOST_NVIC_H__
+#define __HOST_NVIC_H__
+void HOST_NvicEnable(IRQn_Type IRQn);
+void HOST_NvicDisable(IRQn_Type IRQn);
+uint32_t HOST_NvicGetPending(IRQn_Type IRQn);
+void HOST_NvicClearPending(IRQn_Type IRQn);
+void HOST_NvicSetPriority(IRQn_Type IRQn, uint32_t u32Prio);
+#define NVIC_EnableIRQ              HOST_NvicEnable
+#define NVIC_DisableIRQ             HOST_NvicDisable
+#define NVIC_GetPendingIRQ          HOST_NvicGetPending
+#define NVIC_ClearPendingIRQ        HOST_NvicClearPending
+#define NVIC_SetPriority            HOST_NvicSetPriority
+#define NVIC_SetPriorityGrouping    __NVIC_SetPriorityGrouping
+#define NVIC_GetPriorityGrouping    __NVIC_GetPriorityGrouping
+#define NVIC_GetEnableIRQ           __NVIC_GetEnableIRQ
+#define NVIC_SetPendingIRQ          __NVIC_SetPendingIRQ
+#define NVIC_GetActive              __NVIC_GetActive
+#define NVIC_GetPriority            __NVIC_GetPriority
+#define NVIC_SystemReset            __NVIC_SystemReset
+#endif
+'''
+
+# 写 1 生效的寄存器(CHEN/CHENCLR/INTCLR1/FLAGCLR)在库函数写完后由模型立即处理,
+# 这三个库函数编译时改名, 由驱动包一层
+RENAME = {DCU_SOURCE: ['DCU_ClearStatus'],
+          DMA_SOURCE: ['DMA_ChCmd', 'DMA_ClearTransCompleteStatus']}
+
+# 每行一个用例, 见 cmd_ctest; 输出 R/H/V 行, 以 E 结束
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "dcu_kernel.h"
+
+int32_t HOST_DCU_ClearStatus_(CM_DCU_TypeDef *DCUx, uint32_t u32Flag);
+int32_t HOST_DMA_ChCmd_(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, en_functional_state_t enNewState);
+void HOST_DMA_ClearTransCompleteStatus_(CM_DMA_TypeDef *DMAx, uint32_t u32Flag);
+
+CM_AOS_TypeDef m_stcAos;
+CM_DMA_TypeDef m_astcDma[2];
+uint32_t m_au32Dcu[8][256] __attribute__((aligned(1024)));
+
+#define IRQ_NUM             (144U)
+#define WAVE_EVT            (EVT_SRC_TMR0_1_CMP_A)      /* 波形步进事件 */
+#define DCU_REG(u)          ((CM_DCU_TypeDef *)(void *)&m_au32Dcu[u][0])
+#define CH_REG(u, reg, ch)  (*(volatile uint32_t *)((uintptr_t)&m_astcDma[u].reg + (uintptr_t)(ch) * 0x40U))
+#define DCU_FLAG(u)         (*(volatile uint32_t *)&DCU_REG(u)->FLAG)
+
+typedef struct {
+    uint8_t u8On;
+    uint32_t u32Req;                    /* 未处理的块请求 */
+    uint32_t u32Left;                   /* 当前块剩余数据个数 */
+} stc_host_ch_t;
+
+static stc_host_ch_t m_astcCh[2][8];
+static func_ptr_t m_apfnIrq[IRQ_NUM];
+static int32_t m_ai32IrqSrc[IRQ_NUM];
+static uint8_t m_au8IrqOn[IRQ_NUM];
+static uint8_t m_au8IrqPend[IRQ_NUM];
+static uint32_t m_au32IrqLat[IRQ_NUM];
+static uint8_t m_u8InIsr;
+static uint8_t m_au8Down[4];
+static uint32_t m_au32WaveCtl[4];
+static uint32_t m_u32Rand;
+static uint32_t m_u32LatMax;            /* 中断响应延迟, DMA 数据个数 */
+static uint8_t m_u8Sticky;              /* DCU 比较标志保持到清除 */
+static uint32_t m_u32Asserts;
+
+/* 硬件统计 */
+static uint32_t m_u32HwBlocks;
+static uint32_t m_u32HwMaxBlk;
+static uint32_t m_u32BlkCarry;
+static uint32_t m_u32MaxCarry;
+
+static uint32_t m_au32Buf[8192];
+static volatile uint16_t m_u16Dac;
+
+void DDL_AssertHandler(const char *file, int line) {
+    if (m_u32Asserts++ < 4U) {
+        printf("F DDL_ASSERT %s:%d\n", file, line);
+    }
+}
+
+void FCG_Fcg0PeriphClockCmd(uint32_t u32Fcg0Periph, en_functional_state_t enNewState) {
+    (void)u32Fcg0Periph;
+    (void)enNewState;
+}
+
+int32_t INTC_IrqSignIn(const stc_irq_signin_config_t *pstcIrqSignConfig) {
+    uint32_t n = (uint32_t)pstcIrqSignConfig->enIRQn;
+
+    if ((n >= IRQ_NUM) || (NULL != m_apfnIrq[n])) {
+        return LL_ERR_BUSY;
+    }
+    m_apfnIrq[n] = pstcIrqSignConfig->pfnCallback;
+    m_ai32IrqSrc[n] = (int32_t)pstcIrqSignConfig->enIntSrc;
+    return LL_OK;
+}
+
+static uint32_t Rand(void) {
+    m_u32Rand ^= m_u32Rand << 13;
+    m_u32Rand ^= m_u32Rand >> 17;
+    m_u32Rand ^= m_u32Rand << 5;
+    return m_u32Rand;
+}
+
+static void Pend(int32_t i32Src) {
+    uint32_t n;
+
+    for (n = 0U; n < IRQ_NUM; n++) {
+        if ((NULL != m_apfnIrq[n]) && (m_ai32IrqSrc[n] == i32Src) && (0U == m_au8IrqPend[n])) {
+            m_au8IrqPend[n] = 1U;
+            m_au32IrqLat[n] = Rand() % (m_u32LatMax + 1U);
+        }
+    }
+}
+
+/* 写 1 生效的寄存器 */
+static void Sync(void) {
+    uint32_t u, ch;
+
+    for (u = 0U; u < 2U; u++) {
+        for (ch = 0U; ch < 8U; ch++) {
+            if (0UL != (m_astcDma[u].CHENCLR & (1UL << ch))) {
+                m_astcCh[u][ch].u8On = 0U;
+                m_astcCh[u][ch].u32Req = 0U;
+                m_astcCh[u][ch].u32Left = 0U;
+            } else if ((0UL != (m_astcDma[u].CHEN & (1UL << ch))) && (0U == m_astcCh[u][ch].u8On)) {
+                /* 使能时装入监视寄存器 */
+                m_astcCh[u][ch].u8On = 1U;
+                m_astcCh[u][ch].u32Req = 0U;
+                m_astcCh[u][ch].u32Left = 0U;
+                *(volatile uint32_t *)&CH_REG(u, MONSAR0, ch) = CH_REG(u, SAR0, ch);
+                *(volatile uint32_t *)&CH_REG(u, MONDAR0, ch) = CH_REG(u, DAR0, ch);
+                *(volatile uint32_t *)&CH_REG(u, MONDTCTL0, ch) = CH_REG(u, DTCTL0, ch);
+            }
+        }
+        m_astcDma[u].CHENCLR = 0UL;
+        m_astcDma[u].CHEN = 0UL;
+        for (ch = 0U; ch < 8U; ch++) {
+            m_astcDma[u].CHEN |= (uint32_t)m_astcCh[u][ch].u8On << ch;
+        }
+        *(volatile uint32_t *)&m_astcDma[u].INTSTAT1 &= ~m_astcDma[u].INTCLR1;
+        m_astcDma[u].INTCLR1 = 0UL;
+    }
+    for (u = 0U; u < 8U; u++) {
+        DCU_FLAG(u) &= ~DCU_REG(u)->FLAGCLR;
+        DCU_REG(u)->FLAGCLR = 0UL;
+    }
+}
+
+int32_t DMA_ChCmd(CM_DMA_TypeDef *DMAx, uint8_t u8Ch, en_functional_state_t enNewState) {
+    int32_t i32Ret = HOST_DMA_ChCmd_(DMAx, u8Ch, enNewState);
+    Sync();
+    return i32Ret;
+}
+
+void DMA_ClearTransCompleteStatus(CM_DMA_TypeDef *DMAx, uint32_t u32Flag) {
+    HOST_DMA_ClearTransCompleteStatus_(DMAx, u32Flag);
+    Sync();
+}
+
+void DCU_ClearStatus(CM_DCU_TypeDef *DCUx, uint32_t u32Flag) {
+    (void)HOST_DCU_ClearStatus_(DCUx, u32Flag);
+    Sync();
+}
+
+static uint32_t WidthMask(uint32_t u) {
+    uint32_t u32Size = DCU_REG(u)->CTL & DCU_CTL_DATASIZE;
+    return (0UL == u32Size) ? 0xFFUL : ((DCU_DATA_WIDTH_16BIT == u32Size) ? 0xFFFFUL : 0xFFFFFFFFUL);
+}
+
+static void DcuIrq(uint32_t u, uint32_t u32Flag) {
+    if ((0UL != (DCU_REG(u)->CTL & DCU_CTL_INTEN)) && (0UL != (u32Flag & DCU_REG(u)->INTEVTSEL))) {
+        Pend((int32_t)INT_SRC_DCU1 + (int32_t)u);
+    }
+}
+
+/* DMA 或 CPU 写 DATA0/DATA1: 比较与加法 */
+static void DcuWrite(uint32_t u, uint32_t u32Idx, uint32_t u32Val) {
+    CM_DCU_TypeDef *DCUx = DCU_REG(u);
+    uint32_t m = WidthMask(u);
+    uint32_t d0, d1, d2, f;
+    uint64_t s;
+
+    if (0U == u32Idx) {
+        DCUx->DATA0 = u32Val;
+        if (DCU_MD_CMP == (DCUx->CTL & DCU_CTL_MODE)) {
+            d0 = u32Val & m;
+            d1 = DCUx->DATA1 & m;
+            d2 = DCUx->DATA2 & m;
+            f = ((d0 < d2) ? DCU_FLAG_DATA0_LT_DATA2 : 0UL) | ((d0 == d2) ? DCU_FLAG_DATA0_EQ_DATA2 : 0UL) |
+                ((d0 > d2) ? DCU_FLAG_DATA0_GT_DATA2 : 0UL) | ((d0 < d1) ? DCU_FLAG_DATA0_LT_DATA1 : 0UL) |
+                ((d0 == d1) ? DCU_FLAG_DATA0_EQ_DATA1 : 0UL) | ((d0 > d1) ? DCU_FLAG_DATA0_GT_DATA1 : 0UL);
+            DCU_FLAG(u) = m_u8Sticky ? (DCU_FLAG(u) | f) : ((DCU_FLAG(u) & ~0x7EUL) | f);
+            DcuIrq(u, f);
+        }
+    } else {
+        DCUx->DATA1 = u32Val;
+        if (DCU_MD_ADD == (DCUx->CTL & DCU_CTL_MODE)) {
+            s = (uint64_t)(DCUx->DATA0 & m) + (u32Val & m);
+            DCUx->DATA0 = (uint32_t)s & m;
+            if (s > m) {
+                DCU_FLAG(u) |= DCU_FLAG_CARRY;
+                m_u32BlkCarry++;
+                DcuIrq(u, DCU_FLAG_CARRY);
+            }
+        }
+    }
+}
+
+/* 波形模式下一个触发事件, 与 dcu_model.py 的 wave_next 相同 */
+static void DcuWave(uint32_t u) {
+    CM_DCU_TypeDef *DCUx = DCU_REG(u);
+    uint32_t md = DCUx->CTL & DCU_CTL_MODE;
+    uint32_t v = DCUx->DATA0 & 0xFFFUL;
+    uint32_t lo = DCUx->DATA1 & 0xFFFUL;
+    uint32_t hi = (DCUx->DATA1 >> 16U) & 0xFFFUL;
+    uint32_t st = DCUx->DATA2 & 0xFFFUL;
+
+    if (m_au32WaveCtl[u] != DCUx->CTL) {
+        m_au32WaveCtl[u] = DCUx->CTL;
+        m_au8Down[u] = 0U;
+    }
+    if (DCU_MD_SAWTOOTH_WAVE_INC == md) {
+        v = ((v + st) > hi) ? lo : (v + st);
+    } else if (DCU_MD_SAWTOOTH_WAVE_DEC == md) {
+        v = (v < (lo + st)) ? hi : (v - st);
+    } else if (DCU_MD_TRIANGLE_WAVE == md) {
+        if (0U == m_au8Down[u]) {
+            if ((v + st) >= hi) {
+                v = hi;
+                m_au8Down[u] = 1U;
+            } else {
+                v += st;
+            }
+        } else if (v <= (lo + st)) {
+            v = lo;
+            m_au8Down[u] = 0U;
+        } else {
+            v -= st;
+        }
+    } else {
+        return;
+    }
+    DCUx->DATA0 = v;
+}
+
+static void BusWrite(uint32_t u32Addr, uint32_t u32Val, uint32_t u32Bytes) {
+    uint32_t u32Off = u32Addr - (uint32_t)&m_au32Dcu[0][0];
+
+    if ((u32Off < sizeof(m_au32Dcu)) && (((u32Off & 0x3FFU) == 8U) || ((u32Off & 0x3FFU) == 12U))) {
+        DcuWrite(u32Off >> 10U, ((u32Off & 0x3FFU) - 8U) / 4U, u32Val);
+    } else {
+        memcpy((void *)(uintptr_t)u32Addr, &u32Val, u32Bytes);
+    }
+}
+
+static uint32_t BusRead(uint32_t u32Addr, uint32_t u32Bytes) {
+    uint32_t u32Val = 0UL;
+    memcpy(&u32Val, (const void *)(uintptr_t)u32Addr, u32Bytes);
+    return u32Val;
+}
+
+static uint32_t AddrStep(uint32_t u32Mode, uint32_t u32Bytes) {
+    return (1U == u32Mode) ? u32Bytes : ((2U == u32Mode) ? (uint32_t)(0UL - u32Bytes) : 0UL);
+}
+
+/* 传输一个数据, 没有可传的返回 0 */
+static int Step(void) {
+    uint32_t u, ch, ctl, by, v, cnt, blk;
+    stc_host_ch_t *p;
+
+    for (u = 0U; u < 2U; u++) {
+        if (0UL == (m_astcDma[u].EN & 1UL)) {
+            continue;
+        }
+        for (ch = 0U; ch < 8U; ch++) {
+            p = &m_astcCh[u][ch];
+            if ((0U == p->u8On) || ((0U == p->u32Left) && (0U == p->u32Req))) {
+                continue;
+            }
+            if (0U == p->u32Left) {
+                p->u32Req--;
+                blk = CH_REG(u, MONDTCTL0, ch) & DMA_DTCTL_BLKSIZE;
+                p->u32Left = (0UL == blk) ? 1024UL : blk;
+                m_u32HwBlocks++;
+                m_u32BlkCarry = 0U;
+                if (p->u32Left > m_u32HwMaxBlk) {
+                    m_u32HwMaxBlk = p->u32Left;
+                }
+            }
+            ctl = CH_REG(u, CHCTL0, ch);
+            by = 1UL << ((ctl & DMA_CHCTL_HSIZE) >> 8U);
+            v = BusRead(CH_REG(u, MONSAR0, ch), by);
+            BusWrite(CH_REG(u, MONDAR0, ch), v, by);
+            *(volatile uint32_t *)&CH_REG(u, MONSAR0, ch) += AddrStep(ctl & 3UL, by);
+            *(volatile uint32_t *)&CH_REG(u, MONDAR0, ch) += AddrStep((ctl >> 2U) & 3UL, by);
+            if (0U == --p->u32Left) {
+                if (m_u32BlkCarry > m_u32MaxCarry) {
+                    m_u32MaxCarry = m_u32BlkCarry;
+                }
+                *(volatile uint32_t *)&m_astcDma[u].INTSTAT1 |= DMA_FLAG_BTC_CH0 << ch;
+                cnt = CH_REG(u, MONDTCTL0, ch) >> 16U;
+                if (0UL != cnt) {
+                    cnt--;
+                    *(volatile uint32_t *)&CH_REG(u, MONDTCTL0, ch) =
+                        (CH_REG(u, MONDTCTL0, ch) & 0xFFFFUL) | (cnt << 16U);
+                    if (0UL == cnt) {
+                        p->u8On = 0U;
+                        p->u32Req = 0U;
+                        m_astcDma[u].CHEN &= ~(1UL << ch);
+                        *(volatile uint32_t *)&m_astcDma[u].INTSTAT1 |= DMA_FLAG_TC_CH0 << ch;
+                        if ((0UL != (ctl & DMA_CHCTL_IE)) &&
+                                (0UL == (m_astcDma[u].INTMASK1 & (DMA_INT_TC_CH0 << ch)))) {
+                            Pend((int32_t)((0U == u) ? INT_SRC_DMA1_TC0 : INT_SRC_DMA2_TC0) + (int32_t)ch);
+                        }
+                    }
+                }
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 响应中断: bForce 为 0 时只响应延迟已到的 */
+static void Deliver(int bForce) {
+    uint32_t n;
+    int again = 1;
+
+    while ((0U == m_u8InIsr) && again) {
+        again = 0;
+        for (n = 0U; n < IRQ_NUM; n++) {
+            if ((0U != m_au8IrqPend[n]) && (0U != m_au8IrqOn[n]) && (bForce || (0U == m_au32IrqLat[n]))) {
+                m_au8IrqPend[n] = 0U;
+                m_u8InIsr = 1U;
+                m_apfnIrq[n]();
+                m_u8InIsr = 0U;
+                Sync();
+                again = 1;
+                break;
+            }
+        }
+    }
+}
+
+/* 硬件运行至多 u32Steps 个数据 */
+static void Run(uint32_t u32Steps) {
+    uint32_t i, n;
+
+    for (i = 0U; i < u32Steps; i++) {
+        Sync();
+        if (0 == Step()) {
+            Deliver(1);
+            return;
+        }
+        for (n = 0U; n < IRQ_NUM; n++) {
+            if ((0U != m_au8IrqPend[n]) && (0U != m_au32IrqLat[n])) {
+                m_au32IrqLat[n]--;
+            }
+        }
+        Deliver(0);
+    }
+}
+
+void HOST_NvicEnable(IRQn_Type IRQn) {
+    m_au8IrqOn[IRQn] = 1U;
+    /* CPU 开中断的位置即轮询点, 硬件在此前进一段 */
+    if (0U == m_u8InIsr) {
+        Run(1U + Rand() % 200U);
+    }
+}
+
+void HOST_NvicDisable(IRQn_Type IRQn) { m_au8IrqOn[IRQn] = 0U; }
+uint32_t HOST_NvicGetPending(IRQn_Type IRQn) { return m_au8IrqPend[IRQn]; }
+void HOST_NvicClearPending(IRQn_Type IRQn) { m_au8IrqPend[IRQn] = 0U; }
+void HOST_NvicSetPriority(IRQn_Type IRQn, uint32_t u32Prio) { (void)IRQn; (void)u32Prio; }
+
+static int Selected(uint32_t u32Reg, uint32_t u32Evt) {
+    return ((u32Reg & 0x1FFUL) == u32Evt) ||
+           ((0UL != (u32Reg & (1UL << 30U))) && ((m_stcAos.COMTRG1 & 0x1FFUL) == u32Evt)) ||
+           ((0UL != (u32Reg & (1UL << 31U))) && ((m_stcAos.COMTRG2 & 0x1FFUL) == u32Evt));
+}
+
+/* 一个 AOS 事件: DCU 立即步进, DMA 记一次块请求; bDmaFirst 时 DMA 先于 DCU 响应 */
+static void Event(uint32_t u32Evt, int bDmaFirst) {
+    uint32_t u, ch;
+
+    for (u = 0U; u < 2U; u++) {
+        for (ch = 0U; ch < 8U; ch++) {
+            if (Selected(*(volatile uint32_t *)(uintptr_t)(((0U == u) ? AOS_DMA1_0 : AOS_DMA2_0) + 4UL * ch), u32Evt) &&
+                    (0U != m_astcCh[u][ch].u8On)) {
+                m_astcCh[u][ch].u32Req++;
+            }
+        }
+    }
+    if (bDmaFirst) {
+        Run(0xFFFFFFFFUL);
+    }
+    for (u = 0U; u < 4U; u++) {
+        if (Selected(*(volatile uint32_t *)(uintptr_t)(AOS_DCU1 + 4UL * u), u32Evt)) {
+            DcuWave(u);
+        }
+    }
+}
+
+void HOST_AosSwTrigger(void) {
+    Event(EVT_SRC_AOS_STRG, 0);
+}
+
+static void Reset(uint32_t u32Seed, uint32_t u32Lat, uint32_t u32Sticky) {
+    uint32_t i;
+
+    for (i = 0U; i < sizeof(m_stcAos) / 4U; i++) {
+        ((volatile uint32_t *)(void *)&m_stcAos)[i] = 0x1FFUL;
+    }
+    memset(m_astcDma, 0, sizeof(m_astcDma));
+    memset(m_au32Dcu, 0, sizeof(m_au32Dcu));
+    memset(m_astcCh, 0, sizeof(m_astcCh));
+    memset(m_apfnIrq, 0, sizeof(m_apfnIrq));
+    memset(m_au8IrqOn, 0, sizeof(m_au8IrqOn));
+    memset(m_au8IrqPend, 0, sizeof(m_au8IrqPend));
+    memset(m_au32WaveCtl, 0, sizeof(m_au32WaveCtl));
+    m_u32Rand = u32Seed | 1UL;
+    m_u32LatMax = u32Lat;
+    m_u8Sticky = (uint8_t)u32Sticky;
+    m_u32HwBlocks = 0UL;
+    m_u32HwMaxBlk = 0UL;
+    m_u32MaxCarry = 0UL;
+}
+
+static int32_t Init(void) {
+    stc_dcuk_config_t stcCfg;
+    unsigned int dcu, dma, ch;
+
+    if (3 != scanf("%u %u %u", &dcu, &dma, &ch)) {
+        exit(2);
+    }
+    stcCfg.DCUx = DCU_REG(dcu);
+    stcCfg.DMAx = &m_astcDma[dma];
+    stcCfg.u8DmaCh = (uint8_t)ch;
+    stcCfg.enDmaIRQn = INT010_IRQn;
+    stcCfg.enDcuIRQn = INT011_IRQn;
+    stcCfg.u32IrqPrio = DDL_IRQ_PRIO_03;
+    return DCUK_Init(&stcCfg);
+}
+
+static int32_t Wait(stc_dcuk_result_t *pstcRes) {
+    uint32_t u32Polls = 0UL;
+    int32_t i32Ret;
+
+    while (LL_ERR_BUSY == (i32Ret = DCUK_GetResult(pstcRes))) {
+        if (++u32Polls > 100000UL) {
+            DCUK_Abort();
+            return LL_ERR_TIMEOUT;
+        }
+    }
+    return i32Ret;
+}
+
+static void TestMatch(uint32_t u32Index, uint32_t u32Value) {
+    printf("H %lu %lu\n", (unsigned long)u32Index, (unsigned long)u32Value);
+}
+
+static void ReadData(unsigned int n, unsigned int w) {
+    unsigned int i, v;
+
+    for (i = 0U; i < n; i++) {
+        if (1 != scanf("%x", &v)) {
+            exit(2);
+        }
+        if (1U == w) {
+            ((uint8_t *)m_au32Buf)[i] = (uint8_t)v;
+        } else if (2U == w) {
+            ((uint16_t *)(void *)m_au32Buf)[i] = (uint16_t)v;
+        } else {
+            m_au32Buf[i] = v;
+        }
+    }
+}
+
+int main(void) {
+    stc_dcuk_result_t stcRes;
+    stc_dcuk_wave_t stcWave;
+    unsigned int seed, lat, sticky, w, md, n, lo, hi, i, a[4];
+    int32_t i32Ret, i32Get;
+    char acCmd[4];
+
+    while (1 == scanf("%3s", acCmd)) {
+        memset(&stcRes, 0, sizeof(stcRes));
+        if ('L' == acCmd[0]) {
+            /* L seed lat sticky dcu dma ch width mode lo hi n v... */
+            if (3 != scanf("%u %u %u", &seed, &lat, &sticky)) {
+                return 2;
+            }
+            Reset(seed, lat, sticky);
+            i32Ret = Init();
+            if ((5 != scanf("%u %u %x %x %u", &w, &md, &lo, &hi, &n)) || (n > sizeof(m_au32Buf) / w)) {
+                return 2;
+            }
+            ReadData(n, w);
+            if (LL_OK == i32Ret) {
+                i32Ret = DCUK_LimitStart(m_au32Buf, n, (uint8_t)w, lo, hi, (uint8_t)md, &TestMatch);
+            }
+            i32Get = (LL_OK == i32Ret) ? Wait(&stcRes) : i32Ret;
+            printf("R %ld %ld %lu %lu %lu %lu %lu %lu %lu\n", (long)i32Ret, (long)i32Get,
+                   (unsigned long)stcRes.u32Done, (unsigned long)stcRes.u32Matches,
+                   (unsigned long)stcRes.u32FirstIndex, (unsigned long)stcRes.u32Blocks,
+                   (unsigned long)stcRes.u32ScanBlocks, (unsigned long)m_u32HwBlocks, (unsigned long)m_u32HwMaxBlk);
+        } else if ('A' == acCmd[0]) {
+            /* A seed lat dcu dma ch max n v... */
+            if (2 != scanf("%u %u", &seed, &lat)) {
+                return 2;
+            }
+            Reset(seed, lat, 0U);
+            i32Ret = Init();
+            if ((2 != scanf("%x %u", &hi, &n)) || (n > sizeof(m_au32Buf) / 4U)) {
+                return 2;
+            }
+            ReadData(n, 4U);
+            if (LL_OK == i32Ret) {
+                i32Ret = DCUK_AccumStart(m_au32Buf, n, hi);
+            }
+            i32Get = (LL_OK == i32Ret) ? Wait(&stcRes) : i32Ret;
+            printf("R %ld %ld %lu %lu %llu %lu %lu %lu\n", (long)i32Ret, (long)i32Get,
+                   (unsigned long)stcRes.u32Done, (unsigned long)stcRes.u32Blocks,
+                   (unsigned long long)stcRes.u64Sum, (unsigned long)m_u32HwBlocks,
+                   (unsigned long)m_u32HwMaxBlk, (unsigned long)m_u32MaxCarry);
+        } else if ('W' == acCmd[0]) {
+            /* W seed dcu dma ch mode lower upper step steps */
+            if (9 != scanf("%u %u %u %u %u %x %x %x %u", &seed, &a[0], &a[1], &a[2], &md, &lo, &hi, &a[3], &n)) {
+                return 2;
+            }
+            Reset(seed, 0U, 0U);
+            memset(&stcWave, 0, sizeof(stcWave));
+            stcWave.DCUx = DCU_REG(a[0]);
+            stcWave.DMAx = &m_astcDma[a[1]];
+            stcWave.u8DmaCh = (uint8_t)a[2];
+            stcWave.enTrigSrc = (en_event_src_t)WAVE_EVT;
+            stcWave.u32Mode = md;
+            stcWave.u32Lower = lo;
+            stcWave.u32Upper = hi;
+            stcWave.u32Step = a[3];
+            stcWave.u32DestAddr = (uint32_t)&m_u16Dac;
+            i32Ret = DCUK_WaveStart(&stcWave);
+            printf("R %ld\n", (long)i32Ret);
+            for (i = 0U; (LL_OK == i32Ret) && (i < n); i++) {
+                Event(WAVE_EVT, (int)(Rand() & 1U));
+                Run(0xFFFFFFFFUL);
+                printf("V %lu %u\n", (unsigned long)(DCU_REG(a[0])->DATA0 & 0xFFFFUL), m_u16Dac);
+            }
+            if (LL_OK == i32Ret) {
+                DCUK_WaveStop(&stcWave);
+                /* 停止后 AOS 目标恢复复位值 */
+                for (i = 0U; i < sizeof(m_stcAos) / 4U; i++) {
+                    if ((0x1FFUL != ((volatile uint32_t *)(void *)&m_stcAos)[i]) &&
+                            (&((volatile uint32_t *)(void *)&m_stcAos)[i] != &m_stcAos.INTSFTTRG)) {
+                        printf("X %u\n", i);
+                    }
+                }
+            }
+        } else if ('S' == acCmd[0]) {
+            /* S seed lat sticky dcu dma ch num */
+            if (3 != scanf("%u %u %u", &seed, &lat, &sticky)) {
+                return 2;
+            }
+            Reset(seed, lat, sticky);
+            i32Ret = Init();
+            if ((1 != scanf("%u", &n)) || (n > sizeof(m_au32Buf) / 4U)) {
+                return 2;
+            }
+            i32Get = (LL_OK == i32Ret) ? DCUK_SelfTest(m_au32Buf, n) : i32Ret;
+            printf("R %ld %ld\n", (long)i32Ret, (long)i32Get);
+        } else {
+            return 2;
+        }
+        printf("E\n");
+        fflush(stdout);
+    }
+    return 0;
+}
+'''
+
+
+def build(cc, tmp):
+    """编译主机程序, 失败返回 None"""
+    files = {'host_regs.h': REGS, 'host_nvic.h': NVIC, 'driver.c': DRIVER}
+    for name, text in files.items():
+        with open(os.path.join(tmp, name), 'w', encoding='utf-8') as f:
+            f.write(text)
+    inc = []
+    for d in ('User', 'User/BSP', 'Boot', 'Library'):
+        inc += ['-I', os.path.join(ROOT, d)]
+    base = [cc, '-std=gnu99', '-O1', '-g', '-w', '-no-pie', '-fno-pie', '-fsanitize=address,undefined',
+            '-DHC32F4A0', '-DUSE_DDL_DRIVER', '-D__DEBUG', '-DCMSIS_NVIC_VIRTUAL',
+            '-DCMSIS_NVIC_VIRTUAL_HEADER_FILE="%s"' % os.path.join(tmp, 'host_nvic.h')] + inc + \
+           ['-include', 'hc32_ll.h', '-include', os.path.join(tmp, 'host_regs.h')]
+    objs = []
+    for src in (KERNEL_SOURCE, GRAPH_SOURCE, DCU_SOURCE, DMA_SOURCE, os.path.join(tmp, 'driver.c')):
+        obj = os.path.join(tmp, os.path.basename(src) + '.o')
+        ren = ['-D%s=HOST_%s_' % (n, n) for n in RENAME.get(src, [])]
+        cmd = base + ren + ['-c', src, '-o', obj]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return None
+        objs.append(obj)
+    exe = os.path.join(tmp, 'dcu_kernel_host')
+    r = subprocess.run([cc, '-no-pie', '-fsanitize=address,undefined'] + objs + ['-o', exe],
+                       stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(r.stdout)
+        return None
+    return exe
+
+
+def limit_data(rnd, n, width, lo, hi):
+    """越限密度随机: 没有、稀疏、成片、全部"""
+    mask = (1 << (8 * width)) - 1
+    p = rnd.choice((0.0, 0.0005, 0.01, 0.3, 1.0))
+    out = []
+    for _ in range(n):
+        if rnd.random() < p and (lo > 0 or hi < mask):
+            if lo > 0 and (hi == mask or rnd.random() < 0.5):
+                out.append(rnd.randint(0, lo - 1))
+            else:
+                out.append(rnd.randint(hi + 1, mask))
+        else:
+            out.append(rnd.randint(lo, hi))
+    return out
+
+
+def pick_num(rnd, top):
+    return rnd.choice((1, BLOCK_MAX - 1, BLOCK_MAX, BLOCK_MAX + 1, 2 * BLOCK_MAX, rnd.randint(1, top)))
+
+
+def cmd_ctest(args):
+    rnd = random.Random(args.seed)
+    cases = []
+    for i in range(args.cases):
+        hw = '%d %d %d' % (rnd.randrange(8), rnd.randrange(2), rnd.randrange(8))
+        kind = rnd.choice('LLLLAAAWS') if i >= 4 else 'LAWS'[i]
+        seed, lat = rnd.getrandbits(31), rnd.choice((0, 0, 2, 8, 40))
+        if kind == 'L':
+            width = rnd.choice((1, 2, 4))
+            mask = (1 << (8 * width)) - 1
+            lo = rnd.choice((0, rnd.randint(0, mask)))
+            hi = rnd.choice((mask, rnd.randint(lo, mask)))
+            first = rnd.random() < 0.3
+            data = limit_data(rnd, pick_num(rnd, args.num), width, lo, hi)
+            text = 'L %d %d %d %s %d %d %x %x %d %s' % (seed, lat, rnd.randrange(2), hw, width, int(first), lo, hi,
+                                                         len(data), ' '.join('%x' % v for v in data))
+            cases.append(('L', (width, lo, hi, first, data), text))
+        elif kind == 'A':
+            mx = rnd.choice((1, 0xFFF, 0xFFFF, 0x00FFFFFF, M32, rnd.randint(1, M32)))
+            n = pick_num(rnd, args.num)
+            if mx == M32:
+                n = min(n, 1500)
+            near = rnd.random() < 0.5
+            data = [rnd.randint(mx * 3 // 4, mx) if near else rnd.randint(0, mx) for _ in range(n)]
+            text = 'A %d %d %s %x %d %s' % (seed, lat, hw, mx, n, ' '.join('%x' % v for v in data))
+            cases.append(('A', (mx, data), text))
+        elif kind == 'W':
+            mode = rnd.choice(('triangle', 'saw_up', 'saw_down'))
+            lower = rnd.randint(0, WAVE_MAX - 1)
+            upper = rnd.randint(lower + 1, WAVE_MAX)
+            step = rnd.choice((1, rnd.randint(1, upper - lower), rnd.randint(1, WAVE_MAX)))
+            steps = rnd.randint(1, 300)
+            text = 'W %d %d %d %d %d %x %x %x %d' % (seed, rnd.randrange(4), rnd.randrange(2), rnd.randrange(8),
+                                                     WAVE_MODE[mode], lower, upper, step, steps)
+            cases.append(('W', (mode, lower, upper, step, steps), text))
+        else:
+            hw = '%d %d %d' % (rnd.randrange(4), rnd.randrange(2), rnd.randrange(8))
+            text = 'S %d %d %d %s %d' % (seed, lat, rnd.randrange(2), hw, args.num)
+            cases.append(('S', (), text))
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args.cc, tmp)
+        if exe is None:
+            return 1
+        try:
+            r = subprocess.run([exe], input='\n'.join(c[2] for c in cases) + '\n', stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT, universal_newlines=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired as e:
+            out = e.output or b''
+            r = subprocess.CompletedProcess(e.cmd, -1, out.decode('utf-8', 'replace') if isinstance(out, bytes) else out)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    outs, cur = [], []
+    for line in r.stdout.splitlines():
+        if line == 'E':
+            outs.append(cur)
+            cur = []
+        else:
+            cur.append(line)
+    fails = []
+    if r.returncode != 0 or len(outs) != len(cases):
+        fails.append('主机程序返回 %d, 完成 %d/%d 个用例: %s' % (r.returncode, len(outs), len(cases),
+                                                         (r.stdout.strip() + '\n'.join(cur))[-400:]))
+    stat = {'L': 0, 'A': 0, 'W': 0, 'S': 0, 'scan': 0, 'blocks': 0, 'carries': 0, 'capped': 0}
+    for i, ((kind, p, _), out) in enumerate(zip(cases, outs)):
+        stat[kind] += 1
+        for m in check_case(kind, p, out, stat):
+            fails.append('用例 %d (%s): %s' % (i, kind, m))
+    for msg in fails[:MAX_REPORT]:
+        print(msg)
+    print('越限 %d 组(CPU 定位 %d/%d 块), 累加 %d 组(进位 %d 次, 块长受限 %d 组), 波形 %d 组, 自检 %d 组; 差异 %d 项' % (
+        stat['L'], stat['scan'], stat['blocks'], stat['A'], stat['carries'], stat['capped'], stat['W'], stat['S'],
+        len(fails)))
+    return 1 if fails else 0
+
+
+WAVE_MODE = {'triangle': 8, 'saw_up': 9, 'saw_down': 10}
+
+
+def check_case(kind, p, out, stat):
+    errs = [x[2:] for x in out if x.startswith('F ')]
+    rline = [x for x in out if x.startswith('R ')]
+    if not rline:
+        return errs + ['没有结果行']
+    res = [int(x) for x in rline[0].split()[1:]]
+    if kind == 'L':
+        width, lo, hi, first, data = p
+        m = limit(data, width, lo, hi, first)
+        hits = [tuple(int(v) for v in x.split()[1:]) for x in out if x.startswith('H ')]
+        n = len(data)
+        done = n if not (first and m['matches']) else min(n, (m['first'] // BLOCK_MAX + 1) * BLOCK_MAX)
+        want = [0, 0, done, m['matches'], 0xFFFFFFFF if m['first'] is None else m['first'], m['blocks'],
+                m['scan_blocks'], m['blocks'], min(n, BLOCK_MAX)]
+        stat['scan'] += m['scan_blocks']
+        stat['blocks'] += m['blocks']
+        names = ('ret', 'GetResult', 'u32Done', 'u32Matches', 'u32FirstIndex', 'u32Blocks', 'u32ScanBlocks',
+                 'DMA 块数', '最大块长')
+        for k, (a, b) in enumerate(zip(res, want)):
+            if a != b:
+                errs.append('%s = %d, 模型 %d' % (names[k], a, b))
+        if hits != m['hits']:
+            errs.append('回调 %d 次, 模型 %d 次, 首个不同处 %s' % (
+                len(hits), len(m['hits']),
+                next(((a, b) for a, b in zip(hits, m['hits']) if a != b), '长度不同')))
+    elif kind == 'A':
+        mx, data = p
+        m = accum(data, mx)
+        stat['carries'] += m['carries']
+        stat['capped'] += int(m['block_len'] < BLOCK_MAX)
+        want = [0, 0, len(data), m['blocks'], m['sum'], m['blocks'], min(len(data), m['block_len'])]
+        names = ('ret', 'GetResult', 'u32Done', 'u32Blocks', 'u64Sum', 'DMA 块数', '最大块长')
+        for k, (a, b) in enumerate(zip(res, want)):
+            if a != b:
+                errs.append('%s = %d, 模型 %d (max 0x%X, 块长 %d)' % (names[k], a, b, mx, m['block_len']))
+        if res[7] > 1:
+            errs.append('一块内进位 %d 次 (max 0x%X, 块长 %d)' % (res[7], mx, m['block_len']))
+    elif kind == 'W':
+        mode, lower, upper, step, steps = p
+        seq = wave(mode, lower, upper, step, steps)
+        start = upper if mode == 'saw_down' else lower
+        vals = [tuple(int(v) for v in x.split()[1:]) for x in out if x.startswith('V ')]
+        if res[0] != 0:
+            errs.append('DCUK_WaveStart 返回 %d' % res[0])
+        elif len(vals) != steps:
+            errs.append('输出 %d 步, 应为 %d' % (len(vals), steps))
+        for k, (d0, dac) in enumerate(vals):
+            prev = seq[k - 1] if k else start
+            if d0 != seq[k]:
+                errs.append('%s 第 %d 步 DATA0 0x%X, 模型 0x%X' % (mode, k, d0, seq[k]))
+                break
+            if dac not in (seq[k], prev):
+                errs.append('%s 第 %d 步 DAC 0x%X, 应为 0x%X 或上一步 0x%X' % (mode, k, dac, seq[k], prev))
+                break
+        left = [x for x in out if x.startswith('X ')]
+        if left:
+            errs.append('DCUK_WaveStop 后 AOS 寄存器未复位: %s' % ' '.join(x[2:] for x in left))
+    else:
+        if res != [0, 0]:
+            errs.append('DCUK_Init/DCUK_SelfTest 返回 %d/%d' % tuple(res))
+    return errs
+
+
+def main():
+    ap = argparse.ArgumentParser(description='bit-exact host model of dcu_kernel.c')
+    sub = ap.add_subparsers(dest='cmd')
+    for name in ('limit', 'accum'):
+        p = sub.add_parser(name)
+        p.add_argument('--input', help='one value per line, 0x prefix allowed')
+        p.add_argument('--num', type=int, default=4096, help='LCG samples when no --input')
+    p = sub.choices['limit']
+    p.add_argument('--width', type=int, choices=(1, 2, 4), default=2, help='bytes')
+    p.add_argument('--low', type=lambda s: int(s, 0), default=TEST_LOW)
+    p.add_argument('--high', type=lambda s: int(s, 0), default=TEST_HIGH)
+    p.add_argument('--first', action='store_true')
+    p.add_argument('--show', type=int, default=10, help='print the first N hits')
+    sub.choices['accum'].add_argument('--max', type=lambda s: int(s, 0), default=0x00FFFFFF)
+    p = sub.add_parser('wave')
+    p.add_argument('--mode', choices=('triangle', 'saw_up', 'saw_down'), default='triangle')
+    p.add_argument('--lower', type=lambda s: int(s, 0), default=TEST_WAVE[1])
+    p.add_argument('--upper', type=lambda s: int(s, 0), default=TEST_WAVE[2])
+    p.add_argument('--step', type=lambda s: int(s, 0), default=TEST_WAVE[3])
+    p.add_argument('--n', type=int, default=TEST_WAVE_STEPS)
+    p.add_argument('--c', metavar='NAME', help='emit a C array')
+    p = sub.add_parser('gen')
+    p.add_argument('--num', type=int, default=256)
+    p.add_argument('--kind', choices=('accum', 'limit'), default='limit')
+    p.add_argument('--name')
+    sub.add_parser('selftest').add_argument('--num', type=int, default=4096)
+    p = sub.add_parser('ctest')
+    p.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    p.add_argument('--cases', type=int, default=1000)
+    p.add_argument('--seed', type=int, default=1)
+    p.add_argument('--num', type=int, default=4096, help='每组最多样本数')
+    p.add_argument('--timeout', type=int, default=600, help='主机程序运行时间上限, 秒')
+    args = ap.parse_args()
+    if args.cmd is None:
+        ap.print_help()
+        return 2
+    return {'limit': cmd_limit, 'accum': cmd_accum, 'wave': cmd_wave,
+            'gen': cmd_gen, 'selftest': cmd_selftest, 'ctest': cmd_ctest}[args.cmd](args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
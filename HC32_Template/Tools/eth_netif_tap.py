@@ -0,0 +1,1323 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/eth_netif.c 的主机构建: 驱动接到寄存器级的 ETH DMA 模型上, 上面跑一个最小协议栈
+(ARP 应答、ICMP 回显、UDP 7 号端口回显), 帧来自随机生成器或 Linux TAP 设备.
+
+DMA 模型按描述符语义工作:
+  - 接收: 链式描述符(须置 RSAC), 帧写入当前 OWN 描述符的缓冲区, 超过缓冲区的帧跨描述符;
+    MAC 按 IPC 计算 IPv4 头和 TCP/UDP/ICMP 校验和并写 RDES4, 配置了丢弃时校验和错误的帧不进描述符;
+    不置 DIC 的帧立即置 RIS, 置 DIC 的帧启动 RX 看门狗(ETH_DMA_SetRxWatchdogCounter x 256 个 HCLK),
+    到期置 RIS; 没有可用描述符时丢帧、置 RUS 并挂起, 只有写 RXPOLLR 才恢复;
+  - 发送: 从首描述符起收集 TFS~TLS, 按 CIC 填 IPv4 头和 TCP/UDP/ICMP 校验和(须开启
+    store-and-forward), 不足 60 字节补齐, TTSE 帧在最后一个描述符写时间戳; 发送随机延后, 驱动
+    会看到仍为 OWN 的描述符;
+  - 模型只在寄存器访问和时间推进时读描述符, 两次普通存储之间的先后(如首描述符最后交出)查不出来;
+  - 中断: DMASTSR 写 1 清零, NIS/AIS 汇总, 按 INTENAR 和 NVIC 使能在模型事件点进入 ETHIF_IrqHandler,
+    接收回调和 RXPOLLR 写入时随机插入新帧, 模拟 ETHIF_Poll 执行中到达的帧和中断抢占.
+
+    eth_netif_tap.py [load] [--cc gcc] [--seed 1] [--frames 20000]
+        随机流量(突发和空闲交替, ARP/ICMP/UDP/TCP/IPv6/校验和错误/超长帧/带时间戳的帧), 配置取
+        每帧中断、按个数合并、只靠看门狗、无通知(主循环查询)和缓冲区紧张几种. 检查项:
+          1. 进入描述符的每一帧都按顺序、按原内容交给协议栈一次, 缓冲区就是 DMA 写入的那块(零拷贝),
+             ETHIF_BUF_FLAG_xx 与模型的校验结果和时间戳一致; 超长帧和 DMA 判错的帧不交出;
+          2. 流量停止后只靠中断和通知即可收完, 不会停在屏蔽的 RIE 或挂起的接收 DMA 上;
+          3. 发出的每一帧与协议栈按软件校验和构造的期望一致(含两段拼接的 UDP 回显), 发送时间戳回调
+             的值和顺序正确; 描述符用完时 ETHIF_Output 返回 LL_ERR_BUSY 且缓冲区仍归调用者;
+          4. 描述符的 DIC 与合并配置一致, 每次 RXPOLLR 写入前补满一批(缓冲区池用空时除外), 中断不会连续重入;
+          5. 结束后缓冲区池不丢不重, 统计计数与模型一致.
+    eth_netif_tap.py tap [--cc gcc] [--ifname ethif0] [--seconds 10]
+        需要 root: 建立 TAP 设备, 主机端地址 192.168.77.1/24, 模拟的板子为 192.168.77.2.
+        主机用 UDP 回显和原始套接字 ICMP 回显对板子做突发压测, 核对回显内容和 ICMP 校验和,
+        报告丢包率、中断合并比和每次查询的最大帧数; 模型和协议栈的检查项同 load.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 eth_netif.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+BSP = os.path.join(ROOT, 'User', 'BSP')
+NETIF = os.path.join(BSP, 'eth_netif.c')
+LL_DEF = os.path.join(ROOT, 'Library', 'hc32_ll_def.h')
+LL_ETH = os.path.join(ROOT, 'Library', 'hc32_ll_eth.h')
+DEVICE = os.path.join(ROOT, 'Boot', 'hc32f4a0sitb.h')
+MAX_REPORT = 20
+HOST_IP, BOARD_IP = '192.168.77.1', '192.168.77.2'
+
+# 代替 hc32_ll.h: 返回值、ETH 位定义和结构从库头文件中摘出, 寄存器写入和内核函数接到模型上
+STUB = r'''
+#ifndef __HC32_LL_H__
+#define __HC32_LL_H__
+#include <stddef.h>
+#include <stdint.h>
+#define __IO    volatile
+#define __I     volatile const
+#define __ALIGN_BEGIN
+typedef enum {
+    DISABLE = 0U,
+    ENABLE  = 1U,
+} en_functional_state_t;
+typedef void (*func_ptr_t)(void);
+typedef int IRQn_Type;
+typedef int en_int_src_t;
+typedef struct {
+    en_int_src_t enIntSrc;
+    IRQn_Type enIRQn;
+    func_ptr_t pfnCallback;
+} stc_irq_signin_config_t;
+#define INT_SRC_ETH_GLB_INT         (322)
+#define FCG1_PERIPH_ETHMAC          (0x10000000UL)
+#define DDL_IRQ_PRIO_DEFAULT        (15U)
+%s
+typedef struct {
+    __IO uint32_t DMA_DMASTSR;
+    __IO uint32_t DMA_INTENAR;
+    __IO uint32_t DMA_RXPOLLR;
+    __IO uint32_t DMA_TXPOLLR;
+    __IO uint32_t DMA_RXDLADR;
+    __IO uint32_t DMA_TXDLADR;
+} CM_ETH_TypeDef;
+extern CM_ETH_TypeDef g_stcSimEth;
+#define CM_ETH                      (&g_stcSimEth)
+void Sim_Write32(__IO uint32_t *reg, uint32_t val);
+#define WRITE_REG32(REG, VAL)       Sim_Write32(&(REG), (uint32_t)(VAL))
+#define READ_REG32(REG)             (REG)
+#define __DMB()                     __sync_synchronize()
+uint32_t __get_PRIMASK(void);
+void __disable_irq(void);
+void __set_PRIMASK(uint32_t priMask);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void FCG_Fcg1PeriphClockCmd(uint32_t u32Fcg1Periph, en_functional_state_t enNewState);
+int32_t INTC_IrqSignIn(const stc_irq_signin_config_t *pstcIrqSignConfig);
+int32_t ETH_DeInit(void);
+int32_t ETH_Init(stc_eth_handle_t *pstcEthHandle, stc_eth_init_t *pstcEthInit);
+int32_t ETH_CommStructInit(stc_eth_comm_init_t *pstcCommInit);
+int32_t ETH_StructInit(stc_eth_init_t *pstcEthInit);
+int32_t ETH_Start(void);
+int32_t ETH_Stop(void);
+void ETH_DMA_SetRxWatchdogCounter(uint8_t u8Value);
+void ETH_DMA_IntCmd(uint32_t u32IntType, en_functional_state_t enNewState);
+void ETH_DMA_ClearStatus(uint32_t u32Flag);
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+#include "eth_netif.h"
+
+#define SIM_Q_MAX           256U
+#define SIM_FRAME_MAX       3000U
+#define SIM_HCLK_BYTE       19U             /* 240MHz HCLK, 100Mbps 下每字节的周期数 */
+#define SIM_HOLD_MAX        ETHIF_BUF_NUM
+
+typedef struct {
+    uint16_t len;
+    uint16_t flags;
+    uint32_t tsHi, tsLo;
+    const uint8_t *buf;
+    uint8_t data[ETHIF_BUF_SIZE];
+} sim_rx_t;
+
+typedef struct {
+    uint16_t len;
+    uint8_t ts;
+    uint8_t data[ETHIF_BUF_SIZE];
+} sim_tx_t;
+
+CM_ETH_TypeDef g_stcSimEth;
+static stc_eth_init_t simInit;
+static stc_eth_comm_init_t simComm;
+static func_ptr_t simIsr;
+static int nvicOn, inIsr, started, rxSuspended;
+static uint32_t primask, wdt, rxCur, txCur, txPending;
+static uint64_t now, wdtAt;
+
+static sim_rx_t rxQ[SIM_Q_MAX];
+static unsigned rxQHead, rxQNum;
+static sim_tx_t txQ[SIM_Q_MAX];
+static unsigned txQHead, txQNum;
+static uint32_t tsQ[SIM_Q_MAX][2];
+static unsigned tsQHead, tsQNum;
+
+static stc_ethif_buf_t *held[SIM_HOLD_MAX];
+static unsigned heldNum;
+
+static unsigned long errors, seed = 1, nFrames = 20000, generated;
+static unsigned long dropCsum, dropNoDesc, dropJumbo, errDescs, rxIrqs, rusIrqs, ovsIrqs;
+static unsigned long rejects, txOk, txBusy, txNoBuf, notifies, polls, pollFrames, refills, armed;
+static unsigned long txFrames, txTs, rxNoBuf;
+static unsigned pInject = 40, holdMax = 6, pollMode, budgetMax = 32, txDelay = 1, coalesce = 1, draining;
+static volatile int notified;
+static uint64_t rs;
+static int tapFd = -1;
+
+static const uint8_t myMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+static const uint8_t peerMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t myIp[4] = {192, 168, 77, 2};
+static const uint8_t peerIp[4] = {192, 168, 77, 1};
+
+static uint32_t Rnd(void) {
+    rs ^= rs << 13;
+    rs ^= rs >> 7;
+    rs ^= rs << 17;
+    return (uint32_t)(rs >> 16);
+}
+
+static void Fail(const char *msg, unsigned long a, unsigned long b) {
+    if (errors < 20) printf("fail: %s (%lu, %lu)\n", msg, a, b);
+    errors++;
+}
+
+static stc_eth_dma_desc_t *Desc(uint32_t addr) {
+    return (stc_eth_dma_desc_t *)(uintptr_t)addr;
+}
+
+/* ---------------- 校验和 ---------------- */
+
+static uint32_t Sum(const uint8_t *p, uint32_t n, uint32_t s) {
+    uint32_t i;
+    for (i = 0; i + 1 < n; i += 2) s += ((uint32_t)p[i] << 8) | p[i + 1];
+    if (n & 1U) s += (uint32_t)p[n - 1] << 8;
+    return s;
+}
+
+static uint16_t Fold(uint32_t s) {
+    while (s >> 16) s = (s & 0xFFFFU) + (s >> 16);
+    return (uint16_t)~s;
+}
+
+static void Put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint16_t Get16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* L4 校验和, 含伪首部; v6 为 IPv6 */
+static uint16_t L4Sum(const uint8_t *ip, int v6, uint8_t proto, const uint8_t *l4, uint32_t n) {
+    uint32_t s = 0;
+    if (proto == 1U) return Fold(Sum(l4, n, 0));
+    if (v6) s = Sum(ip + 8, 32, 0);
+    else s = Sum(ip + 12, 8, 0);
+    s += proto + n;
+    return Fold(Sum(l4, n, s));
+}
+
+static uint32_t CsumOffset(uint8_t proto) {
+    return proto == 6U ? 16U : proto == 17U ? 6U : 2U;
+}
+
+/* 解析 IP 帧, 返回 0(非 IP)、4 或 6, 同时给出 L4 起点、长度和协议号 */
+static int ParseIp(const uint8_t *f, uint32_t len, const uint8_t **l4, uint32_t *l4n, uint8_t *proto) {
+    uint16_t type = Get16(f + 12);
+    const uint8_t *ip = f + 14;
+
+    if (type == 0x0800U && len >= 34U && (ip[0] >> 4) == 4U) {
+        uint32_t ihl = (ip[0] & 15U) * 4U, tot = Get16(ip + 2);
+        if (ihl < 20U || tot < ihl || 14U + tot > len) return 0;
+        *proto = ip[9];
+        *l4 = ip + ihl;
+        *l4n = tot - ihl;
+        return 4;
+    }
+    if (type == 0x86DDU && len >= 54U && (ip[0] >> 4) == 6U) {
+        uint32_t pl = Get16(ip + 4);
+        if (54U + pl > len) return 0;
+        *proto = ip[6];
+        *l4 = ip + 40;
+        *l4n = pl;
+        return 6;
+    }
+    return 0;
+}
+
+/* 按 MAC IPC 给出 RDES4; *bad 为头或负载校验和错误 */
+static uint32_t RxCheck(const uint8_t *f, uint32_t len, int *bad) {
+    const uint8_t *l4;
+    uint32_t n, ext = 0;
+    uint8_t proto;
+    int v = ParseIp(f, len, &l4, &n, &proto);
+
+    *bad = 0;
+    if (v == 0) return 0;
+    if (v == 4) {
+        ext |= ETH_DMA_RXDESC_IPV4DR;
+        if (Fold(Sum(f + 14, (f[14] & 15U) * 4U, 0)) != 0) {
+            *bad = 1;
+            return ext | ETH_DMA_RXDESC_IPHE;
+        }
+    } else {
+        ext |= ETH_DMA_RXDESC_IPV6DR;
+    }
+    if (proto == 17U) ext |= ETH_DMA_RXDESC_IPPT_UDP;
+    else if (proto == 6U) ext |= ETH_DMA_RXDESC_IPPT_TCP;
+    else if (proto == 1U && v == 4) ext |= ETH_DMA_RXDESC_IPPT_ICMP;
+    else return ext;
+    if (n < CsumOffset(proto) + 2U) {
+        *bad = 1;
+        return ext | ETH_DMA_RXDESC_IPPE;
+    }
+    /* UDP 校验和为 0 表示未计算 */
+    if (!(proto == 17U && v == 4 && Get16(l4 + 6) == 0) && L4Sum(f + 14, v == 6, proto, l4, n) != 0) {
+        *bad = 1;
+        ext |= ETH_DMA_RXDESC_IPPE;
+    }
+    return ext;
+}
+
+static uint16_t ExpectFlags(uint32_t ext) {
+    uint16_t fl = 0;
+    if (ext & ETH_DMA_RXDESC_IPV4DR) fl |= ETHIF_BUF_FLAG_IP_CSUM_OK;
+    if (ext & ETH_DMA_RXDESC_IPV6DR) fl |= ETHIF_BUF_FLAG_IPV6;
+    if (fl && (ext & ETH_DMA_RXDESC_IPPT) != ETH_DMA_RXDESC_IPPT_UNKNOWN) fl |= ETHIF_BUF_FLAG_L4_CSUM_OK;
+    return fl;
+}
+
+/* 按 TCPUDPICMP_FULL 填发送帧的校验和 */
+static void TxInsert(uint8_t *f, uint32_t len) {
+    const uint8_t *l4c;
+    uint8_t *l4, proto;
+    uint32_t n;
+    int v = ParseIp(f, len, &l4c, &n, &proto);
+    uint16_t c;
+
+    if (v == 0) return;
+    l4 = (uint8_t *)(uintptr_t)l4c;
+    if (v == 4) {
+        Put16(f + 24, 0);
+        Put16(f + 24, Fold(Sum(f + 14, (f[14] & 15U) * 4U, 0)));
+    }
+    if ((proto != 17U && proto != 6U && !(proto == 1U && v == 4)) || n < CsumOffset(proto) + 2U) return;
+    Put16(l4 + CsumOffset(proto), 0);
+    c = L4Sum(f + 14, v == 6, proto, l4, n);
+    if (proto == 17U && c == 0) c = 0xFFFFU;
+    Put16(l4 + CsumOffset(proto), c);
+}
+
+/* ---------------- 内核和库函数 ---------------- */
+
+static void IrqCheck(void);
+
+uint32_t __get_PRIMASK(void) { return primask; }
+void __disable_irq(void) { primask = 1; }
+void __set_PRIMASK(uint32_t v) {
+    primask = v;
+    IrqCheck();
+}
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn) { (void)IRQn; }
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) { (void)IRQn; (void)priority; }
+void NVIC_EnableIRQ(IRQn_Type IRQn) {
+    (void)IRQn;
+    nvicOn = 1;
+    IrqCheck();
+}
+void NVIC_DisableIRQ(IRQn_Type IRQn) { (void)IRQn; nvicOn = 0; }
+void FCG_Fcg1PeriphClockCmd(uint32_t u32Fcg1Periph, en_functional_state_t enNewState) {
+    (void)u32Fcg1Periph;
+    (void)enNewState;
+}
+
+int32_t INTC_IrqSignIn(const stc_irq_signin_config_t *c) {
+    if (c->enIntSrc != INT_SRC_ETH_GLB_INT || c->pfnCallback == NULL) Fail("中断登记参数不对", 0, 0);
+    simIsr = c->pfnCallback;
+    return LL_OK;
+}
+
+int32_t ETH_DeInit(void) {
+    memset(&g_stcSimEth, 0, sizeof(g_stcSimEth));
+    started = 0;
+    return LL_OK;
+}
+
+int32_t ETH_CommStructInit(stc_eth_comm_init_t *p) {
+    memset(p, 0, sizeof(*p));
+    return LL_OK;
+}
+
+int32_t ETH_StructInit(stc_eth_init_t *p) {
+    memset(p, 0, sizeof(*p));
+    return LL_OK;
+}
+
+int32_t ETH_Init(stc_eth_handle_t *h, stc_eth_init_t *p) {
+    simComm = h->stcCommInit;
+    simInit = *p;
+    if (memcmp(simComm.au8MacAddr, myMac, 6) != 0) Fail("MAC 地址没有传给 ETH_Init", 0, 0);
+    return LL_OK;
+}
+
+int32_t ETH_Start(void) {
+    started = 1;
+    return LL_OK;
+}
+
+int32_t ETH_Stop(void) {
+    started = 0;
+    return LL_OK;
+}
+
+void ETH_DMA_SetRxWatchdogCounter(uint8_t u8Value) { wdt = u8Value; }
+
+void ETH_DMA_IntCmd(uint32_t u32IntType, en_functional_state_t enNewState) {
+    if (enNewState == ENABLE) g_stcSimEth.DMA_INTENAR |= u32IntType;
+    else g_stcSimEth.DMA_INTENAR &= ~u32IntType;
+    IrqCheck();
+}
+
+void ETH_DMA_ClearStatus(uint32_t u32Flag) { g_stcSimEth.DMA_DMASTSR &= ~u32Flag; }
+
+/* ---------------- DMA 模型 ---------------- */
+
+static void SetStatus(uint32_t f) {
+    if (f & (ETH_DMA_FLAG_RIS | ETH_DMA_FLAG_TIS)) f |= ETH_DMA_FLAG_NIS;
+    if (f & (ETH_DMA_FLAG_RUS | ETH_DMA_FLAG_OVS)) f |= ETH_DMA_FLAG_AIS;
+    g_stcSimEth.DMA_DMASTSR |= f;
+    IrqCheck();
+}
+
+static int IrqPending(void) {
+    uint32_t st = g_stcSimEth.DMA_DMASTSR, en = g_stcSimEth.DMA_INTENAR;
+    int nor = (en & ETH_DMA_INT_NIE) && (st & en & ETH_DMA_INT_RIE & ETH_DMA_FLAG_RIS);
+    int abn = (en & ETH_DMA_INT_AIE) && (st & en & (ETH_DMA_FLAG_RUS | ETH_DMA_FLAG_OVS) &
+                                        (ETH_DMA_INT_RUE | ETH_DMA_INT_OVE));
+    return nvicOn && (nor || abn);
+}
+
+static void IrqCheck(void) {
+    unsigned n = 0;
+
+    if (inIsr || primask || simIsr == NULL) return;
+
+    while (IrqPending()) {
+        uint32_t st = g_stcSimEth.DMA_DMASTSR;
+
+        if (++n > 4U) {
+            printf("fail: 中断标志未清除, 中断连续重入 (DMASTSR 0x%08lx)\n", (unsigned long)st);
+            exit(1);
+        }
+        if (st & ETH_DMA_FLAG_RIS) rxIrqs++;
+        if (st & ETH_DMA_FLAG_RUS) rusIrqs++;
+        if (st & ETH_DMA_FLAG_OVS) ovsIrqs++;
+        inIsr = 1;
+        simIsr();
+        inIsr = 0;
+    }
+}
+
+static void Emit(const uint8_t *f, uint32_t len, int ts, uint32_t tsHi, uint32_t tsLo) {
+    sim_tx_t *e;
+
+    txFrames++;
+    if (tapFd >= 0 && write(tapFd, f, len) != (ssize_t)len) Fail("写 TAP 失败", (unsigned long)errno, len);
+
+    if (txQNum == 0) {
+        Fail("发出了不在期望中的帧", len, 0);
+        return;
+    }
+    e = &txQ[txQHead];
+    if (e->len != len || memcmp(e->data, f, len) != 0) {
+        uint32_t i;
+        for (i = 0; i < len && i < e->len && e->data[i] == f[i]; i++);
+        Fail("发出的帧与期望不同(长度, 首个不同字节)", len, i);
+    }
+    if (e->ts != ts) Fail("发送时间戳请求不对", ts, e->ts);
+    if (ts) {
+        tsQ[(tsQHead + tsQNum) % SIM_Q_MAX][0] = tsHi;
+        tsQ[(tsQHead + tsQNum) % SIM_Q_MAX][1] = tsLo;
+        tsQNum++;
+    }
+    txQHead = (txQHead + 1) % SIM_Q_MAX;
+    txQNum--;
+}
+
+/* 处理已交给 DMA 的发送帧 */
+static void TxRun(void) {
+    static uint8_t f[SIM_FRAME_MAX + 64];
+
+    while (started && (Desc(txCur)->u32ControlStatus & ETH_DMA_TXDESC_OWN)) {
+        stc_eth_dma_desc_t *d = Desc(txCur), *first = d, *last;
+        uint32_t len = 0, n = 0, st0 = d->u32ControlStatus;
+
+        if (!(st0 & ETH_DMA_TXDESC_TFS)) {
+            Fail("发送帧的首描述符没有 TFS", 0, 0);
+        }
+        if ((st0 & ETH_DMA_TXDESC_CIC) != ETH_DMA_TXDESC_CIC_TCPUDPICMP_FULL) Fail("发送没有打开完整校验和插入", 0, 0);
+
+        for (;;) {
+            uint32_t st = d->u32ControlStatus, bs = d->u32ControlBufSize & ETH_DMA_TXDESC_TBS1;
+
+            if (!(st & ETH_DMA_TXDESC_OWN)) {
+                Fail("帧的后续描述符还没交给 DMA", n, 0);
+                return;
+            }
+            if (!(st & ETH_DMA_TXDESC_TSAC)) Fail("发送描述符不是链式", 0, 0);
+            if (bs == 0 || len + bs > SIM_FRAME_MAX) Fail("发送段长度不对", bs, len);
+            else memcpy(f + len, (const void *)(uintptr_t)d->u32Buf1Addr, bs);
+            len += bs;
+            n++;
+            if (st & ETH_DMA_TXDESC_TLS) break;
+            d = Desc(d->u32Buf2NextDescAddr);
+            if (d == first || n > 64U) {
+                Fail("发送帧没有 TLS", n, 0);
+                return;
+            }
+        }
+        last = d;
+
+        if (simInit.stcDmaInit.u32TransStoreForward == ETH_DMA_TRANS_STORE_FORWARD_ENABLE) TxInsert(f, len);
+        while (len < 60U) f[len++] = 0;
+
+        d = first;
+        for (;;) {
+            uint32_t st = d->u32ControlStatus & ~ETH_DMA_TXDESC_OWN;
+            if (d == last && (st0 & ETH_DMA_TXDESC_TTSE)) {
+                d->u32TimestampHigh = (uint32_t)(now / 240000000U);
+                d->u32TimestampLow = (uint32_t)(now % 240000000U) | 1U;
+                st |= ETH_DMA_TXDESC_TTSS;
+            }
+            d->u32ControlStatus = st;
+            if (d == last) break;
+            d = Desc(d->u32Buf2NextDescAddr);
+        }
+        txCur = last->u32Buf2NextDescAddr;
+        Emit(f, len, (st0 & ETH_DMA_TXDESC_TTSE) != 0, last->u32TimestampHigh, last->u32TimestampLow);
+    }
+    txPending = 0;
+}
+
+static void Advance(uint64_t t) {
+    now = t;
+    if (wdtAt != 0 && now >= wdtAt) {
+        wdtAt = 0;
+        SetStatus(ETH_DMA_FLAG_RIS);
+    }
+    if (txPending) TxRun();
+}
+
+/* 一帧到达 MAC; data 不超过 SIM_FRAME_MAX, ts 为带时间戳的帧 */
+static void RxFrame(const uint8_t *data, uint32_t len, int ts) {
+    stc_eth_dma_desc_t *d;
+    uint32_t ext = 0, need, left, off, n, i, fl;
+    uint32_t csumHw = simComm.u32ChecksumMode == ETH_MAC_CHECKSUM_MD_HW;
+    int bad = 0;
+    sim_rx_t *e = NULL;
+
+    if (!started) return;
+    if (csumHw) ext = RxCheck(data, len, &bad);
+    else ext = ETH_DMA_RXDESC_IPCB;
+    if (bad && simInit.stcDmaInit.u32DropChecksumErrorFrame == ETH_DMA_DROP_CHECKSUM_ERR_FRAME_ENABLE) {
+        dropCsum++;
+        return;
+    }
+
+    /* 帧长: 没有去 FCS 时含 4 字节 FCS */
+    fl = len;
+    if (simInit.stcMacInit.u32TypeFrameStripFCS != ETH_MAC_TYPE_FRAME_STRIP_FCS_ENABLE) fl += 4U;
+
+    d = Desc(rxCur);
+    need = 0;
+    left = fl;
+    for (i = 0; i < 8U && left > 0; i++) {
+        uint32_t bs = d->u32ControlBufSize & ETH_DMA_RXDESC_RBS1;
+        if (rxSuspended || !(d->u32ControlStatus & ETH_DMA_RXDESC_OWN) || bs == 0) break;
+        left = left > bs ? left - bs : 0;
+        need++;
+        d = Desc(d->u32Buf2NextDescAddr);
+    }
+    if (left > 0) {
+        dropNoDesc++;
+        if (!rxSuspended) {
+            rxSuspended = 1;
+            SetStatus(ETH_DMA_FLAG_RUS);
+        }
+        return;
+    }
+
+    if (need == 1 && !bad) {
+        if (rxQNum >= SIM_Q_MAX) {
+            Fail("期望队列溢出", rxQNum, 0);
+            return;
+        }
+        e = &rxQ[(rxQHead + rxQNum) % SIM_Q_MAX];
+        rxQNum++;
+        e->len = (uint16_t)fl;
+        memcpy(e->data, data, len);
+        memset(e->data + len, 0, fl - len);
+        e->flags = ExpectFlags(ext);
+        e->tsHi = e->tsLo = 0;
+    } else {
+        /* 驱动按描述符计 u32RxErrors */
+        dropJumbo += need > 1;
+        errDescs += need;
+    }
+    armed -= need;
+
+    d = Desc(rxCur);
+    off = 0;
+    for (n = 0; n < need; n++) {
+        uint32_t ctrl = d->u32ControlBufSize, bs = ctrl & ETH_DMA_RXDESC_RBS1, cp, st = 0;
+        uint32_t idx = (uint32_t)((uintptr_t)d - g_stcSimEth.DMA_RXDLADR) / sizeof(*d);
+        int dic = (ctrl & ETH_DMA_RXDESC_DIC) != 0;
+        int wantDic = wdt != 0 && ((idx + 1U) % coalesce) != 0;
+
+        if (!(ctrl & ETH_DMA_RXDESC_RSAC)) Fail("接收描述符不是链式", idx, 0);
+        if (dic != wantDic) Fail("描述符的 DIC 与合并配置不符(序号, DIC)", idx, dic);
+
+        cp = fl - off > bs ? bs : fl - off;
+        if (off < len) memcpy((void *)(uintptr_t)d->u32Buf1Addr, data + off, off + cp > len ? len - off : cp);
+        if (n == 0) {
+            st |= ETH_DMA_RXDESC_RFS;
+            if (e) e->buf = (const uint8_t *)(uintptr_t)d->u32Buf1Addr;
+        }
+        off += cp;
+        if (n + 1 == need) {
+            st |= ETH_DMA_RXDESC_RLS | (fl << 16);
+            if (bad) st |= ETH_DMA_RXDESC_ERSUM;
+            if (simInit.stcDmaInit.u32EnhanceDesc == ETH_DMA_ENHANCE_DESC_ENABLE) {
+                d->u32ExtendStatus = ext;
+                if (ts) {
+                    d->u32TimestampHigh = (uint32_t)(now / 240000000U) + 1U;
+                    d->u32TimestampLow = (uint32_t)(now % 240000000U) | 1U;
+                    if (e) {
+                        e->tsHi = d->u32TimestampHigh;
+                        e->tsLo = d->u32TimestampLow;
+                        e->flags |= ETHIF_BUF_FLAG_TIMESTAMP;
+                    }
+                }
+            }
+        }
+        d->u32ControlStatus = st;
+        rxCur = d->u32Buf2NextDescAddr;
+
+        if (n + 1 == need) {
+            if (!dic) {
+                wdtAt = 0;
+                SetStatus(ETH_DMA_FLAG_RIS);
+            } else if (wdt != 0 && wdtAt == 0) {
+                wdtAt = now + (uint64_t)wdt * 256U;
+            }
+        }
+        d = Desc(d->u32Buf2NextDescAddr);
+    }
+}
+
+/* ---------------- 帧生成 ---------------- */
+
+static uint32_t BuildIp(uint8_t *f, int v6, uint8_t proto, uint32_t pay, int badCsum) {
+    uint8_t *ip = f + 14, *l4;
+    uint32_t hl = v6 ? 40U : 20U, l4h = proto == 6U ? 20U : 8U, i, len;
+
+    memcpy(f, myMac, 6);
+    memcpy(f + 6, peerMac, 6);
+    Put16(f + 12, v6 ? 0x86DDU : 0x0800U);
+    memset(ip, 0, hl);
+    if (v6) {
+        ip[0] = 0x60;
+        Put16(ip + 4, (uint16_t)(l4h + pay));
+        ip[6] = proto;
+        ip[7] = 64;
+        for (i = 0; i < 32; i++) ip[8 + i] = (uint8_t)Rnd();
+    } else {
+        ip[0] = 0x45;
+        Put16(ip + 2, (uint16_t)(hl + l4h + pay));
+        Put16(ip + 4, (uint16_t)Rnd());
+        ip[8] = 64;
+        ip[9] = proto;
+        memcpy(ip + 12, peerIp, 4);
+        memcpy(ip + 16, myIp, 4);
+    }
+    l4 = ip + hl;
+    memset(l4, 0, l4h);
+    if (proto == 1U) {
+        l4[0] = 8;
+        Put16(l4 + 4, (uint16_t)Rnd());
+        Put16(l4 + 6, (uint16_t)Rnd());
+    } else if (proto == 17U) {
+        Put16(l4, (uint16_t)(1024U + Rnd() % 1000U));
+        Put16(l4 + 2, (Rnd() & 3U) ? 7U : (uint16_t)(2000U + Rnd() % 100U));
+        Put16(l4 + 4, (uint16_t)(l4h + pay));
+    } else {
+        Put16(l4, (uint16_t)Rnd());
+        Put16(l4 + 2, 80);
+        l4[12] = 0x50;
+    }
+    for (i = 0; i < pay; i++) l4[l4h + i] = (uint8_t)Rnd();
+    len = 14U + hl + l4h + pay;
+    TxInsert(f, len);
+    if (badCsum == 1 && !v6) f[25] ^= 0x5A;
+    if (badCsum == 2) {
+        if (pay) l4[l4h + Rnd() % pay] ^= 0x21;
+        else l4[CsumOffset(proto)] ^= 0x01;
+    }
+    while (len < 60U) f[len++] = 0;
+    return len;
+}
+
+static uint32_t Generate(uint8_t *f, int *ts) {
+    uint32_t r = Rnd() % 100U, pay = Rnd() % 4U == 0 ? Rnd() % 1400U : Rnd() % 200U, len, i;
+
+    *ts = Rnd() % 16U == 0;
+    if (r < 8) {
+        memset(f, 0xFF, 6);
+        memcpy(f + 6, peerMac, 6);
+        Put16(f + 12, 0x0806);
+        memset(f + 14, 0, 46);
+        Put16(f + 14, 1);
+        Put16(f + 16, 0x0800);
+        f[18] = 6;
+        f[19] = 4;
+        Put16(f + 20, 1);
+        memcpy(f + 22, peerMac, 6);
+        memcpy(f + 28, peerIp, 4);
+        memcpy(f + 38, Rnd() & 7U ? myIp : peerIp, 4);
+        return 60;
+    }
+    if (r < 30) return BuildIp(f, 0, 1, pay, 0);
+    if (r < 55) return BuildIp(f, 0, 17, pay + 1, 0);
+    if (r < 70) return BuildIp(f, 0, 6, pay, 0);
+    if (r < 78) return BuildIp(f, 1, Rnd() & 1U ? 17 : 6, pay, 0);
+    if (r < 86) return BuildIp(f, 0, (uint8_t)(Rnd() % 3U == 0 ? 1 : Rnd() & 1U ? 17 : 6), pay, 1 + (int)(Rnd() & 1U));
+    if (r < 90) {
+        len = ETHIF_BUF_SIZE + 1U + Rnd() % (SIM_FRAME_MAX - ETHIF_BUF_SIZE);
+        memcpy(f, myMac, 6);
+        memcpy(f + 6, peerMac, 6);
+        Put16(f + 12, 0x88B5);
+        for (i = 14; i < len; i++) f[i] = (uint8_t)Rnd();
+        return len;
+    }
+    len = 60U + Rnd() % 1455U;
+    memcpy(f, myMac, 6);
+    memcpy(f + 6, peerMac, 6);
+    Put16(f + 12, 0x88B6);
+    for (i = 14; i < len; i++) f[i] = (uint8_t)Rnd();
+    return len;
+}
+
+static void Inject(void) {
+    static uint8_t f[SIM_FRAME_MAX];
+    int ts;
+    uint32_t len;
+
+    if (tapFd >= 0 || generated >= nFrames) return;
+    len = Generate(f, &ts);
+    generated++;
+    now += (uint64_t)(len + 20U) * SIM_HCLK_BYTE;
+    RxFrame(f, len, ts);
+}
+
+/* ---------------- 协议栈 ---------------- */
+
+static void ExpectTx(const stc_ethif_buf_t *chain) {
+    sim_tx_t *e;
+    uint32_t len = 0;
+
+    if (txQNum >= SIM_Q_MAX) {
+        Fail("发送期望队列溢出", 0, 0);
+        return;
+    }
+    e = &txQ[(txQHead + txQNum) % SIM_Q_MAX];
+    e->ts = (chain->u16Flags & ETHIF_BUF_FLAG_TIMESTAMP) != 0;
+    for (; chain; chain = chain->pstcNext) {
+        memcpy(e->data + len, chain->pu8Payload, chain->u16Len);
+        len += chain->u16Len;
+    }
+    TxInsert(e->data, len);
+    while (len < 60U) e->data[len++] = 0;
+    e->len = (uint16_t)len;
+    txQNum++;
+}
+
+static void Send(stc_ethif_buf_t *chain) {
+    stc_ethif_buf_t *b, *next;
+    uint8_t *ip;
+    int32_t ret;
+
+    if (Rnd() % 8U == 0) chain->u16Flags |= ETHIF_BUF_FLAG_TIMESTAMP;
+    ExpectTx(chain);
+    /* 校验和字段清零, 由硬件填写 */
+    ip = chain->pu8Payload + 14;
+    if (Get16(chain->pu8Payload + 12) == 0x0800U) {
+        Put16(ip + 10, 0);
+        if (ip[9] == 1U) Put16(ip + 22, 0);
+        else if (ip[9] == 17U && chain->u16Len >= 42U) Put16(ip + 26, 0);
+    }
+
+    ret = ETHIF_Output(chain);
+    if (ret == LL_OK) {
+        txOk++;
+        return;
+    }
+    if (ret != LL_ERR_BUSY) Fail("ETHIF_Output 返回值不对", (unsigned long)-ret, 0);
+    txBusy++;
+    txQNum--;
+    for (b = chain; b; b = next) {
+        next = b->pstcNext;
+        ETHIF_BufFree(b);
+    }
+}
+
+static void SwapEthIp(uint8_t *f) {
+    uint8_t t[6];
+    memcpy(f, f + 6, 6);
+    memcpy(f + 6, myMac, 6);
+    memcpy(t, f + 14 + 12, 4);
+    memcpy(f + 14 + 12, f + 14 + 16, 4);
+    memcpy(f + 14 + 16, t, 4);
+}
+
+static int32_t Input(stc_ethif_buf_t *b) {
+    sim_rx_t *e;
+    uint8_t *f = b->pu8Payload;
+    uint16_t type;
+
+    pollFrames++;
+    if (rxQNum == 0) {
+        Fail("交出了不在期望中的帧", b->u16Len, 0);
+        return LL_ERR;
+    }
+    e = &rxQ[rxQHead];
+    rxQHead = (rxQHead + 1) % SIM_Q_MAX;
+    rxQNum--;
+    if (b->pu8Payload != b->au8Data || b->au8Data != e->buf) Fail("接收帧不在 DMA 写入的缓冲区中", 0, 0);
+    if (b->u16Len != e->len || memcmp(b->pu8Payload, e->data, e->len) != 0) Fail("接收帧内容不对", b->u16Len, e->len);
+    if (b->u16Flags != e->flags) Fail("接收标志不对(实际, 期望)", b->u16Flags, e->flags);
+    if ((e->flags & ETHIF_BUF_FLAG_TIMESTAMP) && (b->u32TsSec != e->tsHi || b->u32TsSubsec != e->tsLo)) {
+        Fail("接收时间戳不对", b->u32TsSec, e->tsHi);
+    }
+    if (b->pstcNext != NULL) Fail("接收缓冲区 pstcNext 不为 NULL", 0, 0);
+
+    if (Rnd() % 100U < pInject) Inject();
+
+    type = Get16(f + 12);
+    if (type == 0x0806U && Get16(f + 20) == 1U && memcmp(f + 38, myIp, 4) == 0) {
+        memcpy(f, f + 6, 6);
+        memcpy(f + 6, myMac, 6);
+        Put16(f + 20, 2);
+        memcpy(f + 32, f + 22, 10);
+        memcpy(f + 22, myMac, 6);
+        memcpy(f + 28, myIp, 4);
+        b->u16Len = 42;
+        Send(b);
+        return LL_OK;
+    }
+    if (type == 0x0800U && memcmp(f + 30, myIp, 4) == 0 && (f[14] & 15U) == 5U) {
+        uint32_t tot = Get16(f + 16);
+        if (f[23] == 1U && f[34] == 8U) {
+            SwapEthIp(f);
+            f[34] = 0;
+            b->u16Len = (uint16_t)(14U + tot);
+            Send(b);
+            return LL_OK;
+        }
+        if (f[23] == 17U && Get16(f + 36) == 7U && tot > 28U) {
+            stc_ethif_buf_t *h = ETHIF_BufAlloc();
+            if (h == NULL) {
+                txNoBuf++;
+                return LL_ERR;
+            }
+            SwapEthIp(f);
+            Put16(f + 36, Get16(f + 34));
+            Put16(f + 34, 7);
+            memcpy(h->pu8Payload, f, 42);
+            h->u16Len = 42;
+            /* 负载留在接收缓冲区里, 不拷贝 */
+            b->pu8Payload = f + 42;
+            b->u16Len = (uint16_t)(tot - 28U);
+            h->pstcNext = b;
+            Send(h);
+            return LL_OK;
+        }
+        if (f[23] == 6U && heldNum < holdMax) {
+            held[heldNum++] = b;
+            return LL_OK;
+        }
+    }
+    if (Rnd() % 8U == 0) {
+        rejects++;
+        return LL_ERR;
+    }
+    ETHIF_BufFree(b);
+    return LL_OK;
+}
+
+static void Notify(void) {
+    notifies++;
+    notified = 1;
+}
+
+static void TxTs(uint32_t s, uint32_t ss) {
+    txTs++;
+    if (tsQNum == 0 || tsQ[tsQHead][0] != s || tsQ[tsQHead][1] != ss) {
+        Fail("发送时间戳回调的值或顺序不对", s, ss);
+    }
+    if (tsQNum) {
+        tsQHead = (tsQHead + 1) % SIM_Q_MAX;
+        tsQNum--;
+    }
+}
+
+void Sim_Write32(__IO uint32_t *reg, uint32_t val) {
+    stc_ethif_stats_t st;
+    stc_eth_dma_desc_t *d;
+    uint32_t i, own = 0;
+
+    if (reg == &g_stcSimEth.DMA_DMASTSR) {
+        g_stcSimEth.DMA_DMASTSR &= ~val;
+    } else if (reg == &g_stcSimEth.DMA_RXDLADR) {
+        *reg = val;
+        rxCur = val;
+    } else if (reg == &g_stcSimEth.DMA_TXDLADR) {
+        *reg = val;
+        txCur = val;
+    } else if (reg == &g_stcSimEth.DMA_RXPOLLR) {
+        refills++;
+        d = Desc(g_stcSimEth.DMA_RXDLADR);
+        for (i = 0; i < ETHIF_RX_DESC_NUM; i++) own += (d[i].u32ControlStatus & ETH_DMA_RXDESC_OWN) != 0;
+        ETHIF_GetStats(&st);
+        if (own <= armed) Fail("RXPOLLR 写入前没有补上描述符", own, armed);
+        /* 不足一批只允许出现在初始化和缓冲区池用空时 */
+        else if (own - armed < ETHIF_RX_REFILL_BATCH && armed != 0 && st.u32RxNoBuf == rxNoBuf)
+            Fail("RXPOLLR 写入前补的描述符不足一批(补上, 之前已挂)", own - armed, armed);
+        rxNoBuf = st.u32RxNoBuf;
+        armed = own;
+        rxSuspended = 0;
+        if (Rnd() % 100U < pInject) Inject();
+    } else if (reg == &g_stcSimEth.DMA_TXPOLLR) {
+        txPending = 1;
+        if (Rnd() % 4U >= txDelay) TxRun();
+    } else {
+        *reg = val;
+    }
+}
+
+static void Thread(int force) {
+    uint32_t n, budget;
+
+    if (pollMode == 1 ? (force || Rnd() % 4U == 0) : (notified || force || (!draining && Rnd() % 64U == 0))) {
+        notified = 0;
+        budget = 1U + Rnd() % budgetMax;
+        n = ETHIF_Poll(budget);
+        polls++;
+        if (n == budget) notified = 1;
+    }
+    while (heldNum && (Rnd() % 8U == 0 || heldNum >= holdMax)) {
+        unsigned k = Rnd() % heldNum;
+        ETHIF_BufFree(held[k]);
+        held[k] = held[--heldNum];
+        if (heldNum < holdMax) break;
+    }
+}
+
+static uint64_t Ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+static int TapOpen(const char *name) {
+    struct ifreq ifr;
+    int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+
+    if (fd < 0) return -1;
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char **argv) {
+    stc_ethif_config_t cfg;
+    stc_ethif_stats_t st;
+    stc_ethif_buf_t *b, *list = NULL;
+    unsigned long i, pool = 0, seconds = 0;
+    const char *ifname = NULL;
+    int32_t ret;
+    uint8_t f[SIM_FRAME_MAX];
+
+    /* seed frames wdt coalesce pollMode holdMax budgetMax pInject [tap ifname seconds] */
+    if (argc < 9) return 2;
+    seed = strtoul(argv[1], NULL, 0);
+    nFrames = strtoul(argv[2], NULL, 0);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.u8RxWatchdog = (uint8_t)strtoul(argv[3], NULL, 0);
+    coalesce = (unsigned)strtoul(argv[4], NULL, 0);
+    pollMode = (unsigned)strtoul(argv[5], NULL, 0);
+    holdMax = (unsigned)strtoul(argv[6], NULL, 0);
+    budgetMax = (unsigned)strtoul(argv[7], NULL, 0);
+    pInject = (unsigned)strtoul(argv[8], NULL, 0);
+    if (argc > 10) {
+        ifname = argv[9];
+        seconds = strtoul(argv[10], NULL, 0);
+    }
+    rs = 0x9E3779B97F4A7C15ULL ^ (seed * 0x2545F4914F6CDD1DULL);
+
+    memcpy(cfg.au8MacAddr, myMac, 6);
+    cfg.u32Interface = ETH_MAC_IF_RMII;
+    cfg.enIRQn = 5;
+    cfg.u32IrqPrio = DDL_IRQ_PRIO_DEFAULT;
+    cfg.pfnInput = Input;
+    cfg.pfnNotify = pollMode == 1 ? NULL : Notify;
+    cfg.pfnTxTimestamp = TxTs;
+
+    if (ifname) {
+        tapFd = TapOpen(ifname);
+        if (tapFd < 0) {
+            printf("fail: 打开 TAP %s 失败: %s\n", ifname, strerror(errno));
+            return 1;
+        }
+    }
+
+    cfg.u8RxCoalesce = 0;
+    if (ETHIF_Init(&cfg) != LL_ERR_INVD_PARAM) Fail("u8RxCoalesce 为 0 未返回 LL_ERR_INVD_PARAM", 0, 0);
+    cfg.u8RxCoalesce = (uint8_t)coalesce;
+    ret = ETHIF_Init(&cfg);
+    if (ret != LL_OK) {
+        printf("fail: ETHIF_Init 返回 %ld\n", (long)ret);
+        return 1;
+    }
+    if (simComm.u32ChecksumMode != ETH_MAC_CHECKSUM_MD_HW) Fail("MAC 没有打开硬件校验", 0, 0);
+    if (simInit.stcDmaInit.u32EnhanceDesc != ETH_DMA_ENHANCE_DESC_ENABLE) Fail("没有使用增强描述符", 0, 0);
+    if (wdt != cfg.u8RxWatchdog) Fail("看门狗没有按配置设置", wdt, cfg.u8RxWatchdog);
+    if (ETHIF_Start() != LL_OK) Fail("ETHIF_Start 失败", 0, 0);
+
+    /* 发送描述符用完时返回 BUSY, 缓冲区仍归调用者 */
+    txDelay = 4;
+    for (i = 0; i <= ETHIF_TX_DESC_NUM; i++) {
+        b = ETHIF_BufAlloc();
+        memset(b->au8Data, 0, 60);
+        memcpy(b->au8Data, peerMac, 6);
+        memcpy(b->au8Data + 6, myMac, 6);
+        Put16(b->au8Data + 12, 0x88B6);
+        b->au8Data[14] = (uint8_t)i;
+        b->u16Len = 60;
+        Send(b);
+    }
+    if (txBusy != 1 || txOk != ETHIF_TX_DESC_NUM) Fail("描述符用完时 ETHIF_Output 没有返回 BUSY", txOk, txBusy);
+    b = ETHIF_BufAlloc();
+    b->u16Len = 0;
+    if (ETHIF_Output(b) != LL_ERR_INVD_PARAM || ETHIF_Output(NULL) != LL_ERR_INVD_PARAM) Fail("空帧没有返回 LL_ERR_INVD_PARAM", 0, 0);
+    ETHIF_BufFree(b);
+    TxRun();
+    txDelay = 1 + Rnd() % 3U;
+
+    if (tapFd >= 0) {
+        uint64_t t0 = Ns(), t;
+        struct pollfd p;
+
+        p.fd = tapFd;
+        p.events = POLLIN;
+        while ((t = Ns() - t0) < (uint64_t)seconds * 1000000000ULL) {
+            (void)poll(&p, 1, 1);
+            Advance(t * 24U / 100U);
+            for (i = 0; i < 64U; i++) {
+                ssize_t n = read(tapFd, f, sizeof(f));
+                if (n <= 0) break;
+                if (n > 0) {
+                    now = (Ns() - t0) * 24U / 100U;
+                    RxFrame(f, (uint32_t)n, 0);
+                }
+                Thread(0);
+            }
+            Advance((Ns() - t0) * 24U / 100U);
+            Thread(0);
+        }
+    } else {
+        while (generated < nFrames) {
+            uint32_t r = Rnd() % 16U;
+            /* 突发: 帧间隔最小; 空闲: 超过看门狗时间 */
+            if (r == 0) now += (uint64_t)(cfg.u8RxWatchdog + 1U) * 512U + Rnd() % 20000U;
+            else if (r < 4) now += Rnd() % 3000U;
+            Advance(now);
+            Inject();
+            Advance(now);
+            Thread(0);
+        }
+    }
+
+    /* 流量停止: 只靠中断/通知收完 */
+    draining = 1;
+    for (i = 0; i < 2000U && (rxQNum || txPending || notified || heldNum); i++) {
+        now += 70000U;
+        Advance(now);
+        Thread(0);
+        if (heldNum && i > 100U) {
+            ETHIF_BufFree(held[--heldNum]);
+        }
+    }
+    if (rxQNum) Fail("流量停止后仍有帧没有交给协议栈(只靠中断)", rxQNum, 0);
+    if (rxSuspended) Fail("接收 DMA 停在挂起状态", 0, 0);
+    if (!(g_stcSimEth.DMA_INTENAR & ETH_DMA_INT_RIE) && pollMode != 1) Fail("收空后 RIE 没有重新打开", 0, 0);
+
+    Thread(1);
+    TxRun();
+    (void)ETHIF_Poll(0);
+    if (txQNum) Fail("仍有期望的帧没有发出", txQNum, 0);
+    if (tsQNum) Fail("仍有发送时间戳没有回调", tsQNum, 0);
+
+    while ((b = ETHIF_BufAlloc()) != NULL) {
+        b->pstcNext = list;
+        list = b;
+        pool++;
+    }
+    if (pool + armed != ETHIF_BUF_NUM) Fail("缓冲区池丢失或重复(空闲 + 接收描述符)", pool, armed);
+    while (list) {
+        b = list;
+        list = list->pstcNext;
+        ETHIF_BufFree(b);
+    }
+
+    ETHIF_GetStats(&st);
+    if (st.u32RxIrqs != rxIrqs) Fail("u32RxIrqs 与模型不符", st.u32RxIrqs, rxIrqs);
+    if (st.u32RxUnavail != rusIrqs) Fail("u32RxUnavail 与模型不符", st.u32RxUnavail, rusIrqs);
+    if (st.u32RxErrors != errDescs) Fail("u32RxErrors 与出错帧占用的描述符数不符", st.u32RxErrors, errDescs);
+    if (st.u32RxRejected != rejects + txNoBuf) Fail("u32RxRejected 与协议栈拒收数不符", st.u32RxRejected, rejects + txNoBuf);
+    if (st.u32RxFrames + st.u32RxRejected != pollFrames) Fail("u32RxFrames 不对", st.u32RxFrames, pollFrames);
+    if (st.u32TxFrames != txOk || st.u32TxBusy != txBusy) Fail("发送统计不对", st.u32TxFrames, txOk);
+    if (cfg.u8RxWatchdog != 0 && cfg.u8RxCoalesce > 1 && pollFrames > 1000 && rxIrqs * 2 > pollFrames) {
+        Fail("合并后中断次数仍超过帧数的一半", rxIrqs, pollFrames);
+    }
+    if (ETHIF_Stop() != LL_OK || nvicOn) Fail("ETHIF_Stop 没有关闭中断", 0, 0);
+
+    printf("generated=%lu\nrx=%lu\nrxirq=%lu\nmaxbatch=%lu\ndropcsum=%lu\ndropnodesc=%lu\njumbo=%lu\n"
+           "rus=%lu\ntx=%lu\ntxbusy=%lu\ntxts=%lu\nrefills=%lu\npolls=%lu\nnobuf=%lu\nerrors=%lu\n",
+           generated, pollFrames, rxIrqs, (unsigned long)st.u32RxMaxBatch, dropCsum, dropNoDesc, dropJumbo,
+           rusIrqs, txFrames, txBusy, txTs, refills, polls, (unsigned long)st.u32RxNoBuf, errors);
+    if (tapFd >= 0) close(tapFd);
+    return errors ? 1 : 0;
+}
+'''
+
+# (名称, 看门狗, 合并个数, 查询方式 0 通知/1 主循环查询, 协议栈最多持有, 单次查询预算, 查询中到达帧的概率%)
+SCENARIOS = (
+    ('每帧中断', 0, 1, 0, 6, 32, 30),
+    ('按 4 帧合并', 16, 4, 0, 6, 32, 40),
+    ('只靠看门狗', 64, 16, 0, 6, 64, 40),
+    ('主循环查询', 8, 8, 1, 6, 8, 20),
+    ('缓冲区紧张', 16, 4, 0, 30, 4, 60),
+    ('预算为 1', 255, 2, 0, 2, 1, 50),
+)
+
+
+def write_stub(tmp):
+    with open(LL_DEF, encoding='utf-8') as f:
+        defs = [l.rstrip() for l in f if re.match(r'#define\s+(LL_OK|LL_ERR\w*)\b', l)]
+    with open(DEVICE, encoding='utf-8') as f:
+        dev = f.read()
+    regs = re.findall(r'#define\s+ETH_\w+\s+\((?:0x[0-9A-Fa-f]+UL|\d+U)\)', dev)
+    with open(LL_ETH, encoding='utf-8') as f:
+        eth = f.read()
+    types = re.search(r'typedef struct \{(?:(?!#define).)*?\} stc_eth_handle_t;', eth, re.S).group(0)
+    macros = re.findall(r'#define\s+ETH_(?:DMA|MAC|RX_MD)_\w+(?:[^\n]*\\\n)*[^\n]*', eth)
+    seen, out = set(), []
+    for m in regs + macros:
+        name = m.split()[1]
+        if name not in seen and '(' not in name:
+            seen.add(name)
+            out.append(m)
+    with open(os.path.join(tmp, 'hc32_ll.h'), 'w', encoding='utf-8') as f:
+        f.write(STUB % '\n'.join(defs + out + [types]))
+
+
+def build(args, tmp):
+    write_stub(tmp)
+    path = os.path.join(tmp, 'netif_host.c')
+    exe = os.path.join(tmp, 'netif_host')
+    with open(path, 'w', encoding='utf-8') as f:
+        f.write(DRIVER)
+    # 描述符里的地址是 32 位, 用 -no-pie 让静态缓冲区落在低 4GB
+    cmd = [args.cc, '-std=gnu99', '-O2', '-Wall', '-Wextra', '-Werror', '-Wno-pointer-to-int-cast',
+           '-Wno-int-to-pointer-cast', '-no-pie', '-fno-pie', '-I', tmp, '-I', BSP, NETIF, path, '-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def parse_out(text):
+    vals, fails = {}, []
+    for line in text.splitlines():
+        if line.startswith('fail: '):
+            fails.append(line[6:])
+        elif '=' in line:
+            k, v = line.split('=', 1)
+            if v.isdigit():
+                vals[k] = int(v)
+    return vals, fails
+
+
+def run_load(args, exe):
+    bad = 0
+    for k, (name, wdt, coal, mode, hold, budget, inject) in enumerate(SCENARIOS):
+        cmd = [exe, str(args.seed * 100 + k), str(args.frames), str(wdt), str(coal), str(mode),
+               str(hold), str(budget), str(inject)]
+        try:
+            r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True,
+                               timeout=300)
+        except subprocess.TimeoutExpired:
+            print('%s: 超时' % name)
+            bad += 1
+            continue
+        v, fails = parse_out(r.stdout)
+        for msg in fails[:MAX_REPORT]:
+            print('%s: %s' % (name, msg))
+        if r.returncode != 0 and not fails:
+            print('%s: 返回 %d' % (name, r.returncode))
+            print(r.stdout[-2000:])
+        bad += r.returncode != 0
+        print('%-8s 生成 %d 帧, 交出 %d, 接收中断 %d(每次 %.1f 帧), 单次最多 %d, 校验和丢弃 %d, 无描述符丢弃 %d, '
+              '超长 %d, 发出 %d(BUSY %d), 每次 RXPOLLR 补 %.1f 个, 差异 %d 项' % (
+                  name, v.get('generated', 0), v.get('rx', 0), v.get('rxirq', 0),
+                  v.get('rx', 0) / max(1, v.get('rxirq', 0)), v.get('maxbatch', 0), v.get('dropcsum', 0),
+                  v.get('dropnodesc', 0), v.get('jumbo', 0), v.get('tx', 0), v.get('txbusy', 0),
+                  (v.get('rx', 0) + v.get('jumbo', 0)) / max(1, v.get('refills', 0)), len(fails)))
+    return 1 if bad else 0
+
+
+def icmp_sum(data):
+    if len(data) & 1:
+        data += b'\0'
+    s = sum(struct.unpack('!%dH' % (len(data) // 2), data))
+    while s >> 16:
+        s = (s & 0xFFFF) + (s >> 16)
+    return ~s & 0xFFFF
+
+
+def run_tap(args, exe):
+    if os.geteuid() != 0:
+        print('tap 需要 root 权限')
+        return 1
+    name = args.ifname
+    ip = lambda *a: subprocess.run(['ip'] + list(a), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                   universal_newlines=True)
+    r = ip('tuntap', 'add', 'dev', name, 'mode', 'tap')
+    if r.returncode != 0:
+        print('建立 TAP 失败: %s' % r.stdout.strip())
+        return 1
+    proc = None
+    try:
+        ip('addr', 'add', HOST_IP + '/24', 'dev', name)
+        ip('link', 'set', name, 'up')
+        proc = subprocess.Popen([exe, str(args.seed), '0', '16', '4', '0', '6', '32', '0', name,
+                                 str(args.seconds)], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                universal_newlines=True)
+        time.sleep(0.3)
+        rnd = random.Random(args.seed)
+        udp = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        udp.bind((HOST_IP, 0))
+        udp.settimeout(0.2)
+        icmp = socket.socket(socket.AF_INET, socket.SOCK_RAW, socket.IPPROTO_ICMP)
+        icmp.settimeout(0.2)
+        sent = got = corrupt = isent = igot = ibad = 0
+        deadline = time.time() + args.seconds - 1.0
+        seq = 0
+        while time.time() < deadline:
+            burst = rnd.choice((1, 4, 16, 48))
+            want = {}
+            for _ in range(burst):
+                seq += 1
+                data = struct.pack('!I', seq) + bytes(rnd.getrandbits(8) for _ in range(rnd.randrange(1, 1400)))
+                want[seq] = data
+                udp.sendto(data, (BOARD_IP, 7))
+                sent += 1
+            ident = seq & 0xFFFF
+            payload = bytes(rnd.getrandbits(8) for _ in range(rnd.randrange(0, 1000)))
+            hdr = struct.pack('!BBHHH', 8, 0, 0, ident, seq & 0xFFFF)
+            icmp.sendto(hdr[:2] + struct.pack('!H', icmp_sum(hdr + payload)) + hdr[4:] + payload, (BOARD_IP, 0))
+            isent += 1
+            end = time.time() + 0.2
+            while want and time.time() < end:
+                try:
+                    data, _ = udp.recvfrom(2048)
+                except socket.timeout:
+                    break
+                s = struct.unpack('!I', data[:4])[0] if len(data) >= 4 else 0
+                if want.pop(s, None) == data:
+                    got += 1
+                else:
+                    corrupt += 1
+            end = time.time() + 0.05
+            while time.time() < end:
+                try:
+                    pkt, addr = icmp.recvfrom(2048)
+                except socket.timeout:
+                    break
+                hl = (pkt[0] & 15) * 4
+                msg = pkt[hl:]
+                if addr[0] != BOARD_IP or len(msg) < 8 or msg[0] != 0:
+                    continue
+                if icmp_sum(msg) != 0 or msg[8:] != payload or struct.unpack('!H', msg[4:6])[0] != ident:
+                    ibad += 1
+                else:
+                    igot += 1
+        out, _ = proc.communicate(timeout=args.seconds + 30)
+    finally:
+        if proc is not None and proc.poll() is None:
+            proc.kill()
+        ip('tuntap', 'del', 'dev', name, 'mode', 'tap')
+
+    v, fails = parse_out(out)
+    for msg in fails[:MAX_REPORT]:
+        print(msg)
+    print('UDP 回显: 发出 %d, 收到 %d(丢失 %.1f%%), 内容错误 %d; ICMP 回显: 发出 %d, 收到 %d, 校验和或内容错误 %d' % (
+        sent, got, 100.0 * (sent - got) / max(1, sent), corrupt, isent, igot, ibad))
+    print('驱动: 交出 %d 帧, 接收中断 %d(每次 %.1f 帧), 单次最多 %d, 无描述符丢弃 %d, 发出 %d, 差异 %d 项' % (
+        v.get('rx', 0), v.get('rxirq', 0), v.get('rx', 0) / max(1, v.get('rxirq', 0)), v.get('maxbatch', 0),
+        v.get('dropnodesc', 0), v.get('tx', 0), len(fails)))
+    return 1 if fails or proc.returncode != 0 or corrupt or ibad or got == 0 or igot == 0 else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('cmd', nargs='?', choices=('load', 'tap'), default='load')
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--frames', type=int, default=20000, help='load: 每个场景的帧数')
+    ap.add_argument('--ifname', default='ethif0', help='tap: TAP 设备名')
+    ap.add_argument('--seconds', type=int, default=10, help='tap: 运行时间')
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args, tmp)
+        if exe is None:
+            return 1
+        if args.cmd == 'tap':
+            return run_tap(args, exe)
+        return run_load(args, exe)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,1022 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/nand_ftl.c 的主机仿真: 用主机编译器编译 nand_ftl.c, 闪存操作接到 RAM 中的 NAND 模型上.
+模型按 NAND 的规则工作(编程只能把 1 写成 0, 带 ECC 的页不能重复编程, 按块擦除), 并注入故障.
+
+    nand_ftl_sim.py torture [--cc gcc] [--seed 1] [--ops 100000]
+        依次跑下列场景, 每个场景随机混合读、写(1~16 扇区, 热点偏斜, 部分整页对齐)、Sync 和后台回收:
+          clean     无故障
+          bad       出厂坏块 + 编程失败 + 擦除失败
+          powercut  在随机的第 N 次编程/擦除/坏块标记时掉电: 正在编程的页只写了一部分(ECC 不可纠正),
+                    正在擦除的块部分页擦掉、部分页 ECC 失效; 之后重新挂载
+          all       以上全部
+          disturb   读干扰: 读时页随机变为不可纠正, 受影响的逻辑页允许丢失, 其它数据不能受牵连
+          wear      小容量, 冷数据写满后反复写少量热数据, 检查静态磨损均衡
+        检查项:
+          1. 读出的每个扇区与影子数据逐字节相同(扇区内容由扇区号和版本号生成, 可反推版本);
+          2. 掉电重新挂载后, 每个扇区为最后一次 Sync 时的版本或之后写入的某个版本, 不能回到更旧的版本;
+          3. 映射表指向的页已正常编程, 页内标签的逻辑页号一致, 各块有效页数与映射表一致,
+             已标记的坏块状态为 NAND_FTL_BLK_BAD;
+          4. 不对出厂或已标记的坏块编程/擦除, 不重复编程同一页;
+          5. 除读干扰丢失的逻辑页外, 读写、Sync 和回收不返回错误;
+          6. 每个场景注入的故障确实发生过(否则该场景不算通过).
+    nand_ftl_sim.py bench [--cc gcc] [--seed 1] [--ops 20000]
+        先顺序写满, 再跑随机 512B、随机 4KB、顺序 32KB 写, 按 --trd/--tprog/--ters/--mbps 的时序
+        统计每次 NAND_FTL_Write 的延迟(平均/99%/最大)、写放大和每 MB 擦除次数, 分别给出不做和做后台回收
+        (每次写后调用 NAND_FTL_BackgroundGc) 的结果, 并与不用 FTL 原地改写(读整块-擦除-写整块)对比.
+    全部通过返回 0, 否则打印前若干处错误并返回 1. 修改 nand_ftl.c 后运行一次 torture.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'User', 'BSP', 'nand_ftl.c')
+LL_DEF = os.path.join(ROOT, 'Library', 'hc32_ll_def.h')
+MAX_REPORT = 20
+WL_THRESHOLD = 256
+SECTOR = 512
+SPARE = 64
+
+# 代替 hc32_ll.h: 返回值和 LL_MAX/LL_MIN 从 hc32_ll_def.h 中摘出, 关掉 NFC 实现
+STUB = r'''
+#ifndef __HC32_LL_H__
+#define __HC32_LL_H__
+#include <stddef.h>
+#include <stdint.h>
+%s
+#define LL_NFC_ENABLE       (DDL_OFF)
+#define EXMC_NFC_BANK0      (0UL)
+#endif
+'''
+
+DRIVER = r'''
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nand_ftl.h"
+
+#define SPARE           64U
+#define SEC             NAND_FTL_SECTOR_SIZE
+#define PG_ERASED       0U
+#define PG_PROG         1U
+#define PG_BROKEN       2U          /* ECC 不可纠正 */
+#define MAX_FAIL_LOG    20UL
+
+static struct {
+    unsigned long blocks, ppb, page, lpn, ops, seed, bad, maxfail, maxsec, hot, cut, check, idle;
+    double pfail, efail, rfail, trd, tprog, ters, tbyte;
+    char mode[16];
+    char work[16];
+} P = {64, 32, 2048, 0, 100000, 1, 0, 0, 16, 70, 0, 256, 0,
+       0.0, 0.0, 0.0, 25.0, 250.0, 2000.0, 0.025, "torture", "r512"};
+
+static uint32_t nblk, ppb, psz, npage, psec, nsec;
+static uint8_t *cell;
+static uint8_t *pst;
+static uint8_t *worn;               /* 擦除必然失败 */
+static uint8_t *marked;             /* 首页坏块标记已写入 */
+static uint8_t *retire;             /* 本次挂载以来编程失败过, 应回收后标记为坏块 */
+static uint8_t *lost;               /* 读干扰破坏过的逻辑页 */
+static uint32_t *cur;               /* 每个扇区最后写入的版本, 0 为未写过 */
+static uint32_t *dur;               /* 最后一次 Sync 成功时的版本 */
+static uint32_t ver, mark;          /* mark: 最后一次 Sync 成功时的 ver */
+static uint8_t *hbuf;
+static double *lat;
+static uint64_t rng;
+static double now;
+static unsigned long done, flash_ops, cut_at, cuts, pfails, efails, disturbs, violations, errors;
+static jmp_buf cut_env;
+static stc_nand_ftl_stats_t acc;
+
+static uint32_t *map;
+static stc_nand_ftl_block_t *blk;
+static stc_nand_ftl_cfg_t cfg;
+
+static void Fail(const char *fmt, ...) {
+    va_list ap;
+
+    if (errors++ < MAX_FAIL_LOG) {
+        printf("fail: ");
+        va_start(ap, fmt);
+        vprintf(fmt, ap);
+        va_end(ap);
+        printf("\n");
+    }
+}
+
+static uint32_t Rnd(void) {
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return (uint32_t)((rng * 2685821657736338717ULL) >> 32);
+}
+
+static uint32_t RndN(uint32_t n) {
+    return (uint32_t)(((uint64_t)Rnd() * n) >> 32);
+}
+
+static int Chance(double p) {
+    return (p > 0.0) && ((double)Rnd() < p * 4294967296.0);
+}
+
+static uint8_t *Cell(uint32_t page) {
+    return cell + (size_t)page * (psz + SPARE);
+}
+
+/* ---------------- NAND 模型 ---------------- */
+
+static void Violation(const char *what, uint32_t page) {
+    violations++;
+    Fail("%s: block %lu page %lu", what, (unsigned long)(page / ppb), (unsigned long)(page % ppb));
+}
+
+/* 每次改写闪存的操作计数, 到达 cut_at 时这次操作只完成一部分, 然后掉电 */
+static int Cut(void) {
+    flash_ops++;
+
+    if ((cut_at != 0UL) && (flash_ops >= cut_at)) {
+        cut_at = 0UL;
+        cuts++;
+        return 1;
+    }
+
+    return 0;
+}
+
+static void ArmCut(void) {
+    cut_at = (P.cut != 0UL) ? (flash_ops + 1UL + RndN((uint32_t)(2UL * P.cut))) : 0UL;
+}
+
+/* 编程中断或失败: 只有部分位从 1 变为 0 */
+static void PartialProgram(uint32_t page, const uint8_t *buf, uint32_t len) {
+    uint8_t *c = Cell(page);
+    uint32_t i;
+
+    for (i = 0U; i < len; i++) {
+        c[i] &= (uint8_t)(buf[i] | (uint8_t)Rnd());
+    }
+
+    pst[page] = PG_BROKEN;
+}
+
+/* 擦除中断或失败: 每页随机为已擦除、不变或 ECC 失效(原来已擦除的页仍为已擦除) */
+static void PartialErase(uint32_t block) {
+    uint32_t page;
+    uint32_t i;
+
+    for (i = 0U; i < ppb; i++) {
+        page = block * ppb + i;
+
+        switch (RndN(3U)) {
+        case 0U:
+            memset(Cell(page), 0xFF, psz + SPARE);
+            pst[page] = PG_ERASED;
+            break;
+        case 1U:
+            break;
+        default:
+            if (pst[page] == PG_PROG) {
+                pst[page] = PG_BROKEN;
+            }
+            break;
+        }
+    }
+}
+
+static int CheckAddr(uint32_t page, uint32_t len) {
+    if ((page >= npage) || (len > psz + SPARE)) {
+        Violation("address out of range", page % npage);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int32_t SimReadPage(uint32_t page, uint8_t *buf, uint32_t len) {
+    uint32_t lpn;
+
+    if (!CheckAddr(page, len)) {
+        return LL_ERR;
+    }
+
+    now += P.trd + P.tbyte * len;
+
+    if ((pst[page] == PG_PROG) && Chance(P.rfail)) {
+        pst[page] = PG_BROKEN;
+        disturbs++;
+        memcpy(&lpn, Cell(page) + psz + 4U, 4U);
+
+        if (lpn < P.lpn) {
+            lost[lpn] = 1U;
+        }
+    }
+
+    if (pst[page] == PG_BROKEN) {
+        memset(buf, 0xA5, len);
+        return LL_ERR;
+    }
+
+    memcpy(buf, Cell(page), len);
+    return LL_OK;
+}
+
+static int32_t SimReadRaw(uint32_t page, uint8_t *buf, uint32_t len) {
+    if (!CheckAddr(page, len)) {
+        return LL_ERR;
+    }
+
+    now += P.trd + P.tbyte * len;
+    memcpy(buf, Cell(page), len);
+    return LL_OK;
+}
+
+static int32_t SimWritePage(uint32_t page, const uint8_t *buf, uint32_t len) {
+    uint8_t *c = Cell(page);
+    uint32_t i;
+
+    if (!CheckAddr(page, len)) {
+        return LL_ERR;
+    }
+
+    if (marked[page / ppb]) {
+        Violation("program on bad block", page);
+    }
+
+    if (pst[page] != PG_ERASED) {
+        Violation("page programmed twice", page);
+    }
+
+    now += P.tprog + P.tbyte * len;
+
+    if (Cut()) {
+        PartialProgram(page, buf, len);
+        longjmp(cut_env, 1);
+    }
+
+    if ((pfails < P.maxfail) && Chance(P.pfail)) {
+        pfails++;
+        retire[page / ppb] = 1U;
+        PartialProgram(page, buf, len);
+        return LL_ERR;
+    }
+
+    for (i = 0U; i < len; i++) {
+        c[i] &= buf[i];
+    }
+
+    pst[page] = PG_PROG;
+    return LL_OK;
+}
+
+static int32_t SimWriteRaw(uint32_t page, const uint8_t *buf, uint32_t len) {
+    uint8_t *c = Cell(page);
+    uint32_t i;
+
+    if (!CheckAddr(page, len)) {
+        return LL_ERR;
+    }
+
+    now += P.tprog + P.tbyte * len;
+
+    if (Cut()) {
+        PartialProgram(page, buf, len);
+        longjmp(cut_env, 1);
+    }
+
+    for (i = 0U; i < len; i++) {
+        c[i] &= buf[i];
+    }
+
+    pst[page] = PG_BROKEN;
+
+    if (((page % ppb) == 0U) && (len > psz) && (c[psz] != 0xFFU)) {
+        marked[page / ppb] = 1U;
+    }
+
+    return LL_OK;
+}
+
+static int32_t SimEraseBlock(uint32_t page) {
+    uint32_t block = page / ppb;
+
+    if (!CheckAddr(page, 0U)) {
+        return LL_ERR;
+    }
+
+    if ((page % ppb) != 0U) {
+        Violation("erase address not block aligned", page);
+    }
+
+    if (marked[block]) {
+        Violation("erase of bad block", page);
+    }
+
+    if (retire[block]) {
+        Violation("erase of block that failed programming", page);
+    }
+
+    now += P.ters;
+
+    if (Cut()) {
+        PartialErase(block);
+        longjmp(cut_env, 1);
+    }
+
+    if (!worn[block] && (efails < P.maxfail) && Chance(P.efail)) {
+        efails++;
+        worn[block] = 1U;
+    }
+
+    if (worn[block]) {
+        PartialErase(block);
+        return LL_ERR;
+    }
+
+    memset(Cell(page), 0xFF, (size_t)ppb * (psz + SPARE));
+    memset(&pst[page], PG_ERASED, ppb);
+    return LL_OK;
+}
+
+static const stc_nand_ftl_ops_t ops = {
+    SimReadPage, SimWritePage, SimReadRaw, SimWriteRaw, SimEraseBlock
+};
+
+/* ---------------- 扇区内容 ---------------- */
+
+/* 版本 0 为未写过(全 0xFF), 否则前 8 字节为扇区号和版本号, 其余由两者生成 */
+static void Fill(uint8_t *p, uint32_t s, uint32_t v) {
+    uint32_t x = (s * 2654435761U) ^ (v * 40503U) ^ 0x9E3779B9U;
+    uint32_t i;
+
+    if (v == 0U) {
+        memset(p, 0xFF, SEC);
+        return;
+    }
+
+    memcpy(p, &s, 4U);
+    memcpy(p + 4U, &v, 4U);
+
+    for (i = 8U; i < SEC; i += 4U) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        memcpy(p + i, &x, 4U);
+    }
+}
+
+static int Decode(const uint8_t *p, uint32_t s, uint32_t *v) {
+    uint8_t ref[SEC];
+    uint32_t s2;
+
+    memcpy(&s2, p, 4U);
+    memcpy(v, p + 4U, 4U);
+
+    if ((s2 == 0xFFFFFFFFU) && (*v == 0xFFFFFFFFU)) {
+        *v = 0U;
+    } else if ((s2 != s) || (*v == 0U) || (*v > ver)) {
+        return 0;
+    }
+
+    Fill(ref, s, *v);
+    return memcmp(ref, p, SEC) == 0;
+}
+
+/* ---------------- 检查 ---------------- */
+
+static void AccStats(void) {
+    stc_nand_ftl_stats_t s;
+
+    NAND_FTL_GetStats(&s);
+    acc.u32HostSectors += s.u32HostSectors;
+    acc.u32PageWrites += s.u32PageWrites;
+    acc.u32PageReads += s.u32PageReads;
+    acc.u32Merges += s.u32Merges;
+    acc.u32GcPages += s.u32GcPages;
+    acc.u32Erases += s.u32Erases;
+    acc.u32WlMoves += s.u32WlMoves;
+    acc.u32EccFails += s.u32EccFails;
+}
+
+static void CheckTables(const char *where) {
+    uint32_t *cnt = calloc(nblk, sizeof(uint32_t));
+    uint8_t *used = calloc(npage, 1U);
+    uint32_t lpn;
+    uint32_t ppn;
+    uint32_t tag;
+    uint32_t b;
+
+    for (lpn = 0U; lpn < P.lpn; lpn++) {
+        ppn = map[lpn];
+
+        if (ppn == 0xFFFFFFFFU) {
+            continue;
+        }
+
+        if (ppn >= npage) {
+            Fail("%s: lpn %lu maps to page %lu out of range", where, (unsigned long)lpn, (unsigned long)ppn);
+            continue;
+        }
+
+        b = ppn / ppb;
+        cnt[b]++;
+
+        if (used[ppn]++ != 0U) {
+            Fail("%s: page %lu mapped twice (lpn %lu)", where, (unsigned long)ppn, (unsigned long)lpn);
+        }
+
+        if ((blk[b].u8State != NAND_FTL_BLK_DATA) && (blk[b].u8State != NAND_FTL_BLK_RETIRE)) {
+            Fail("%s: lpn %lu maps into block %lu in state %u", where, (unsigned long)lpn, (unsigned long)b,
+                 blk[b].u8State);
+        }
+
+        if (pst[ppn] == PG_PROG) {
+            memcpy(&tag, Cell(ppn) + psz + 4U, 4U);
+
+            if (tag != lpn) {
+                Fail("%s: lpn %lu maps to page %lu tagged %lu", where, (unsigned long)lpn, (unsigned long)ppn,
+                     (unsigned long)tag);
+            }
+        } else if (!lost[lpn]) {
+            Fail("%s: lpn %lu maps to page %lu in state %u", where, (unsigned long)lpn, (unsigned long)ppn, pst[ppn]);
+        }
+    }
+
+    for (b = 0U; b < nblk; b++) {
+        if (marked[b] && (blk[b].u8State != NAND_FTL_BLK_BAD)) {
+            Fail("%s: marked bad block %lu in state %u", where, (unsigned long)b, blk[b].u8State);
+        }
+
+        if (cnt[b] != blk[b].u16Valid) {
+            Fail("%s: block %lu valid %u, map has %lu", where, (unsigned long)b, blk[b].u16Valid, (unsigned long)cnt[b]);
+        }
+    }
+
+    free(cnt);
+    free(used);
+}
+
+static int AnyLost(uint32_t s, uint32_t n) {
+    uint32_t i;
+
+    for (i = s / psec; i <= (s + n - 1U) / psec; i++) {
+        if (lost[i]) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * 逐扇区读出全部数据
+ * exact: 1 时须等于最后写入的版本; 0 时(掉电后)为最后一次 Sync 的版本或之后写入的版本
+ * 之后以读出的内容为新的基准
+ */
+static void VerifyAll(int exact, const char *where) {
+    uint32_t s;
+    uint32_t v;
+    int32_t ret;
+
+    for (s = 0U; s < nsec; s++) {
+        ret = NAND_FTL_Read(s, hbuf, 1U);
+
+        if (ret != LL_OK) {
+            if (!lost[s / psec]) {
+                Fail("%s: sector %lu read returns %ld", where, (unsigned long)s, (long)ret);
+            }
+            cur[s] = 0U;
+        } else if (!Decode(hbuf, s, &v)) {
+            Fail("%s: sector %lu holds data that was never written to it", where, (unsigned long)s);
+            cur[s] = 0U;
+        } else {
+            if (lost[s / psec]) {
+                /* 读干扰丢失的逻辑页可以是任何写过的版本或 0xFF */
+            } else if (exact && (v != cur[s])) {
+                Fail("%s: sector %lu version %lu, expect %lu", where, (unsigned long)s, (unsigned long)v,
+                     (unsigned long)cur[s]);
+            } else if (!exact && (v != dur[s]) && (v <= mark)) {
+                Fail("%s: sector %lu version %lu, synced %lu, newest %lu", where, (unsigned long)s,
+                     (unsigned long)v, (unsigned long)dur[s], (unsigned long)cur[s]);
+            }
+            cur[s] = v;
+        }
+
+        dur[s] = cur[s];
+    }
+
+    mark = ver;
+}
+
+static void Remount(const char *where, int exact) {
+    int32_t ret;
+
+    AccStats();
+    /* 待退役状态只在 RAM 中, 重新挂载后编程失败的块按普通数据块回收 */
+    memset(retire, 0, nblk);
+    ret = NAND_FTL_Mount(&cfg);
+
+    if (ret != LL_OK) {
+        Fail("%s: mount returns %ld", where, (long)ret);
+        return;
+    }
+
+    CheckTables(where);
+    VerifyAll(exact, where);
+}
+
+/* ---------------- 主机操作 ---------------- */
+
+static void PickRange(uint32_t *ps, uint32_t *pn, uint32_t maxsec) {
+    uint32_t area = (RndN(100U) < P.hot) ? (nsec / 8U) : nsec;
+    uint32_t n;
+    uint32_t s;
+
+    if ((RndN(5U) == 0U) && (maxsec >= psec)) {
+        n = psec * (1U + RndN(maxsec / psec));
+        s = RndN(area / psec) * psec;
+    } else {
+        n = 1U + RndN(maxsec);
+        s = RndN(area);
+    }
+
+    if (s + n > nsec) {
+        s = nsec - n;
+    }
+
+    *ps = s;
+    *pn = n;
+}
+
+static int32_t HostWrite(uint32_t s, uint32_t n) {
+    int32_t ret;
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        cur[s + i] = ++ver;
+        Fill(hbuf + i * SEC, s + i, ver);
+    }
+
+    ret = NAND_FTL_Write(s, hbuf, n);
+
+    if (ret != LL_OK) {
+        Fail("write %lu+%lu returns %ld", (unsigned long)s, (unsigned long)n, (long)ret);
+    }
+
+    return ret;
+}
+
+static void HostRead(uint32_t s, uint32_t n) {
+    int32_t ret;
+    uint32_t v;
+    uint32_t i;
+
+    ret = NAND_FTL_Read(s, hbuf, n);
+
+    if (ret != LL_OK) {
+        if ((ret != LL_ERR) || !AnyLost(s, n)) {
+            Fail("read %lu+%lu returns %ld", (unsigned long)s, (unsigned long)n, (long)ret);
+        }
+        return;
+    }
+
+    for (i = 0U; i < n; i++) {
+        if (!Decode(hbuf + i * SEC, s + i, &v)) {
+            Fail("sector %lu holds data that was never written to it", (unsigned long)(s + i));
+        } else if (!lost[(s + i) / psec] && (v != cur[s + i])) {
+            Fail("sector %lu version %lu, expect %lu", (unsigned long)(s + i), (unsigned long)v,
+                 (unsigned long)cur[s + i]);
+        }
+    }
+}
+
+static void HostSync(void) {
+    int32_t ret = NAND_FTL_Sync();
+
+    if (ret != LL_OK) {
+        Fail("sync returns %ld", (long)ret);
+        return;
+    }
+
+    memcpy(dur, cur, nsec * sizeof(uint32_t));
+    mark = ver;
+}
+
+static void HostGc(uint32_t pages) {
+    int32_t ret = NAND_FTL_BackgroundGc(pages);
+
+    if ((ret != LL_OK) && (ret != LL_ERR_NOT_RDY)) {
+        Fail("background gc returns %ld", (long)ret);
+    }
+}
+
+static void Torture(void) {
+    uint32_t s;
+    uint32_t n;
+    uint32_t r;
+
+    ArmCut();
+
+    while ((done < P.ops) && (errors < MAX_FAIL_LOG)) {
+        if (setjmp(cut_env) != 0) {
+            Remount("remount after power cut", 0);
+            ArmCut();
+            continue;
+        }
+
+        r = RndN(100U);
+        PickRange(&s, &n, (uint32_t)P.maxsec);
+
+        if (r < 55U) {
+            (void)HostWrite(s, n);
+        } else if (r < 80U) {
+            HostRead(s, n);
+        } else if (r < 88U) {
+            HostSync();
+        } else {
+            HostGc(1U + RndN(ppb));
+        }
+
+        done++;
+
+        if ((done % P.check) == 0UL) {
+            CheckTables("run");
+        }
+    }
+
+    cut_at = 0UL;
+    HostSync();
+    VerifyAll(1, "after sync");
+    Remount("clean remount", 1);
+}
+
+/* 冷数据写满后只写前 4 页, 每次写后做后台回收 */
+static void Wear(void) {
+    uint32_t s;
+
+    for (s = 0U; s < nsec; s += psec) {
+        (void)HostWrite(s, psec);
+    }
+
+    HostSync();
+
+    for (done = 0UL; (done < P.ops) && (errors < MAX_FAIL_LOG); done++) {
+        (void)HostWrite(RndN(4U) * psec, psec);
+        HostGc(ppb);
+    }
+
+    HostSync();
+    VerifyAll(1, "after sync");
+    Remount("clean remount", 1);
+}
+
+static int CmpDouble(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void Bench(void) {
+    uint32_t s = 0U;
+    uint32_t n;
+    uint32_t i;
+    double t0;
+
+    for (s = 0U; s < nsec; s += psec) {
+        (void)HostWrite(s, psec);
+    }
+
+    HostSync();
+    AccStats();
+    memset(&acc, 0, sizeof(acc));
+    (void)NAND_FTL_Mount(&cfg);
+    s = 0U;
+
+    for (done = 0UL; (done < P.ops) && (errors < MAX_FAIL_LOG); done++) {
+        if (strcmp(P.work, "r4k") == 0) {
+            n = 8U;
+            s = RndN(nsec / 8U) * 8U;
+        } else if (strcmp(P.work, "seq") == 0) {
+            n = 64U;
+            s = (s + 64U <= nsec) ? s : 0U;
+        } else {
+            n = 1U;
+            s = RndN(nsec);
+        }
+
+        t0 = now;
+        (void)HostWrite(s, n);
+        lat[done] = now - t0;
+        s += n;
+
+        for (i = 0U; i < P.idle; i++) {
+            if (NAND_FTL_BackgroundGc(ppb) != LL_OK) {
+                break;
+            }
+        }
+    }
+
+    HostSync();
+    VerifyAll(1, "after sync");
+}
+
+/* ---------------- 主程序 ---------------- */
+
+static int SetParam(const char *arg) {
+    static const struct {
+        const char *name;
+        unsigned long *pul;
+        double *pd;
+    } tab[] = {
+        {"blocks", &P.blocks, NULL}, {"ppb", &P.ppb, NULL}, {"page", &P.page, NULL}, {"lpn", &P.lpn, NULL},
+        {"ops", &P.ops, NULL}, {"seed", &P.seed, NULL}, {"bad", &P.bad, NULL}, {"maxfail", &P.maxfail, NULL},
+        {"maxsec", &P.maxsec, NULL}, {"hot", &P.hot, NULL}, {"cut", &P.cut, NULL}, {"check", &P.check, NULL},
+        {"idle", &P.idle, NULL}, {"pfail", NULL, &P.pfail}, {"efail", NULL, &P.efail}, {"rfail", NULL, &P.rfail},
+        {"trd", NULL, &P.trd}, {"tprog", NULL, &P.tprog}, {"ters", NULL, &P.ters}, {"tbyte", NULL, &P.tbyte},
+    };
+    const char *eq = strchr(arg, '=');
+    size_t k;
+
+    if (eq == NULL) {
+        return 0;
+    }
+
+    if (strncmp(arg, "mode=", 5U) == 0) {
+        snprintf(P.mode, sizeof(P.mode), "%s", eq + 1);
+        return 1;
+    }
+
+    if (strncmp(arg, "work=", 5U) == 0) {
+        snprintf(P.work, sizeof(P.work), "%s", eq + 1);
+        return 1;
+    }
+
+    for (k = 0U; k < sizeof(tab) / sizeof(tab[0]); k++) {
+        if ((strlen(tab[k].name) == (size_t)(eq - arg)) && (strncmp(arg, tab[k].name, (size_t)(eq - arg)) == 0)) {
+            if (tab[k].pul != NULL) {
+                *tab[k].pul = strtoul(eq + 1, NULL, 0);
+            } else {
+                *tab[k].pd = strtod(eq + 1, NULL);
+            }
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint32_t nlost = 0U;
+    uint32_t ecmin = 0xFFFFFFFFU;
+    uint32_t ecmax = 0U;
+    uint32_t nbad = 0U;
+    uint32_t b;
+    double sum = 0.0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!SetParam(argv[i])) {
+            fprintf(stderr, "bad argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    nblk = (uint32_t)P.blocks;
+    ppb = (uint32_t)P.ppb;
+    psz = (uint32_t)P.page;
+    npage = nblk * ppb;
+    psec = psz / SEC;
+    nsec = (uint32_t)P.lpn * psec;
+    rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)P.seed << 17);
+
+    cell = malloc((size_t)npage * (psz + SPARE));
+    pst = calloc(npage, 1U);
+    worn = calloc(nblk, 1U);
+    marked = calloc(nblk, 1U);
+    retire = calloc(nblk, 1U);
+    lost = calloc(P.lpn, 1U);
+    cur = calloc(nsec, sizeof(uint32_t));
+    dur = calloc(nsec, sizeof(uint32_t));
+    hbuf = malloc((size_t)(P.maxsec > 64UL ? P.maxsec : 64UL) * SEC);
+    lat = calloc(P.ops + 1UL, sizeof(double));
+    map = malloc(P.lpn * sizeof(uint32_t));
+    blk = calloc(nblk, sizeof(stc_nand_ftl_block_t));
+
+    memset(cell, 0xFF, (size_t)npage * (psz + SPARE));
+
+    /* 出厂坏块: 首页备用区第 0 字节为 0 */
+    while (nbad < P.bad) {
+        b = RndN(nblk);
+        if (!marked[b]) {
+            marked[b] = 1U;
+            worn[b] = 1U;
+            Cell(b * ppb)[psz] = 0x00U;
+            nbad++;
+        }
+    }
+
+    cfg.pstcOps = &ops;
+    cfg.u32BlockNum = nblk;
+    cfg.u16PagesPerBlock = (uint16_t)ppb;
+    cfg.u16PageSize = (uint16_t)psz;
+    cfg.u32LpnNum = (uint32_t)P.lpn;
+    cfg.pu32Map = map;
+    cfg.pstcBlock = blk;
+
+    if (NAND_FTL_Format(&cfg) != LL_OK) {
+        Fail("format failed");
+    } else if (strcmp(P.mode, "wear") == 0) {
+        Wear();
+    } else if (strcmp(P.mode, "bench") == 0) {
+        Bench();
+    } else {
+        Torture();
+    }
+
+    AccStats();
+
+    for (b = 0U; b < P.lpn; b++) {
+        nlost += lost[b];
+    }
+
+    for (b = 0U; b < nblk; b++) {
+        if (blk[b].u8State == NAND_FTL_BLK_BAD) {
+            continue;
+        }
+        ecmin = (blk[b].u32EraseCnt < ecmin) ? blk[b].u32EraseCnt : ecmin;
+        ecmax = (blk[b].u32EraseCnt > ecmax) ? blk[b].u32EraseCnt : ecmax;
+    }
+
+    nbad = 0U;
+    for (b = 0U; b < nblk; b++) {
+        nbad += (blk[b].u8State == NAND_FTL_BLK_BAD) ? 1U : 0U;
+    }
+
+    if (strcmp(P.mode, "bench") == 0) {
+        for (i = 0; i < (int)done; i++) {
+            sum += lat[i];
+        }
+        qsort(lat, done, sizeof(double), CmpDouble);
+        printf("lat_mean=%.1f\nlat_p99=%.1f\nlat_max=%.1f\n", (done != 0UL) ? sum / (double)done : 0.0,
+               (done != 0UL) ? lat[(done * 99UL) / 100UL] : 0.0, (done != 0UL) ? lat[done - 1UL] : 0.0);
+    }
+
+    printf("ops=%lu\ncuts=%lu\npfails=%lu\nefails=%lu\ndisturbs=%lu\nviolations=%lu\nerrors=%lu\n",
+           done, cuts, pfails, efails, disturbs, violations, errors);
+    printf("host_sectors=%lu\npage_writes=%lu\npage_reads=%lu\nmerges=%lu\ngc_pages=%lu\nerases=%lu\n",
+           (unsigned long)acc.u32HostSectors, (unsigned long)acc.u32PageWrites, (unsigned long)acc.u32PageReads,
+           (unsigned long)acc.u32Merges, (unsigned long)acc.u32GcPages, (unsigned long)acc.u32Erases);
+    printf("wl_moves=%lu\necc_fails=%lu\nbad_blocks=%lu\nlost=%lu\nec_min=%lu\nec_max=%lu\n",
+           (unsigned long)acc.u32WlMoves, (unsigned long)acc.u32EccFails, (unsigned long)nbad,
+           (unsigned long)nlost, (unsigned long)ecmin, (unsigned long)ecmax);
+
+    return 0;
+}
+'''
+
+
+def lpn_for(blocks, ppb, bad=0, grown=0, fill=0.9):
+    """逻辑页数: NAND_FTL_CheckCfg 要求的余量之外再扣掉坏块, 按 fill 填充"""
+    return int((blocks - 3 - bad - grown) * ppb * fill)
+
+
+def scenarios(args):
+    base = dict(blocks=64, ppb=32, page=2048, ops=args.ops, seed=args.seed)
+    faults = dict(bad=3, pfail=3e-4, efail=3e-3, maxfail=4)
+    out = [
+        ('clean', dict(base), ()),
+        ('bad', dict(base, **faults), ('pfails', 'efails')),
+        ('powercut', dict(base, cut=400), ('cuts',)),
+        ('all', dict(base, cut=400, **faults), ('cuts', 'pfails', 'efails')),
+        ('disturb', dict(base, rfail=2e-5), ('disturbs',)),
+        ('wear', dict(blocks=24, ppb=16, page=2048, ops=args.ops, seed=args.seed, mode='wear'), ('wl_moves',)),
+    ]
+    for _, p, _ in out:
+        p['lpn'] = lpn_for(p['blocks'], p['ppb'], p.get('bad', 0), 2 * p.get('maxfail', 0))
+    return out
+
+
+def build(args, tmp):
+    with open(LL_DEF, encoding='utf-8') as f:
+        defs = [l.rstrip() for l in f
+                if re.match(r'#define\s+(LL_OK|LL_ERR\w*|LL_MAX|LL_MIN|DDL_ON|DDL_OFF)\b', l)]
+    with open(os.path.join(tmp, 'hc32_ll.h'), 'w', encoding='utf-8') as f:
+        f.write(STUB % '\n'.join(defs))
+    driver = os.path.join(tmp, 'driver.c')
+    exe = os.path.join(tmp, 'nand_ftl_sim')
+    with open(driver, 'w', encoding='utf-8') as f:
+        f.write(DRIVER)
+    cmd = [args.cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-Werror',
+           '-I', tmp, '-I', os.path.dirname(SOURCE), SOURCE, driver, '-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def run(exe, params):
+    cmd = [exe] + ['%s=%s' % kv for kv in sorted(params.items())]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    res, fails = {}, []
+    for line in r.stdout.splitlines():
+        if line.startswith('fail: '):
+            fails.append(line[6:])
+        elif '=' in line:
+            k, v = line.split('=', 1)
+            res[k] = float(v) if '.' in v else int(v)
+    if r.returncode != 0:
+        fails.append('驱动异常退出: 返回 %d %s' % (r.returncode, r.stdout.strip()[-200:]))
+    return res, fails
+
+
+def torture(args, exe):
+    bad = 0
+    print('%-9s %7s %5s %6s %6s %6s %5s %6s %6s %9s' % (
+        '场景', '操作', '掉电', '编程失败', '擦除失败', '读干扰', '坏块', '写放大', 'GC 页', '擦除次数'))
+    for name, params, need in scenarios(args):
+        res, fails = run(exe, params)
+        for key in need:
+            if res.get(key, 0) == 0:
+                fails.append('没有触发 %s, 加大 --ops' % key)
+        if name == 'wear' and res.get('ec_max', 0) - res.get('ec_min', 0) > 2 * WL_THRESHOLD:
+            fails.append('擦除次数差 %d 超过 2 * NAND_FTL_WL_THRESHOLD' % (res['ec_max'] - res['ec_min']))
+        if res.get('errors', 0) and not fails:
+            fails.append('驱动报告 %d 处错误' % res['errors'])
+        host = res.get('host_sectors', 0) * SECTOR
+        waf = res.get('page_writes', 0) * params['page'] / host if host else 0.0
+        print('%-9s %9d %7d %9d %9d %9d %7d %9.2f %8d %6d~%d' % (
+            name, res.get('ops', 0), res.get('cuts', 0), res.get('pfails', 0), res.get('efails', 0),
+            res.get('disturbs', 0), res.get('bad_blocks', 0), waf, res.get('gc_pages', 0),
+            res.get('ec_min', 0), res.get('ec_max', 0)))
+        for msg in fails[:MAX_REPORT]:
+            print('    ' + msg)
+        bad += 1 if fails else 0
+    print('%d 个场景, 失败 %d 个' % (len(scenarios(args)), bad))
+    return 1 if bad else 0
+
+
+def bench(args, exe):
+    blocks, ppb, page = 64, 32, 2048
+    tbyte = 1.0 / args.mbps
+    timing = dict(trd=args.trd, tprog=args.tprog, ters=args.ters, tbyte=tbyte)
+    # 原地改写: 读出整块, 擦除, 改好后写回整块
+    rmw = ppb * (args.trd + args.tprog + 2 * tbyte * (page + SPARE)) + args.ters
+    print('时序: tR %.0fus, tPROG %.0fus, tBERS %.0fus, 总线 %.0f MB/s; %d 块 x %d 页 x %d 字节' % (
+        args.trd, args.tprog, args.ters, args.mbps, blocks, ppb, page))
+    print('%-6s %-8s %10s %10s %10s %8s %10s' % ('负载', '后台回收', '平均(us)', '99%(us)', '最大(us)', '写放大', '擦除/MB'))
+    bad = 0
+    for work, sectors in (('r512', 1), ('r4k', 8), ('seq', 64)):
+        for idle in (0, 1):
+            params = dict(blocks=blocks, ppb=ppb, page=page, lpn=lpn_for(blocks, ppb), ops=args.ops,
+                          seed=args.seed, mode='bench', work=work, idle=idle, **timing)
+            res, fails = run(exe, params)
+            host = res.get('host_sectors', 0) * SECTOR
+            print('%-6s %-10s %10.1f %10.1f %10.1f %9.2f %10.2f' % (
+                work, '是' if idle else '否', res.get('lat_mean', 0), res.get('lat_p99', 0), res.get('lat_max', 0),
+                res.get('page_writes', 0) * page / host if host else 0.0,
+                res.get('erases', 0) * 1048576.0 / host if host else 0.0))
+            for msg in fails[:MAX_REPORT]:
+                print('    ' + msg)
+            bad += 1 if fails else 0
+        print('%-6s %-10s %10.1f %10.1f %10.1f %9.2f %10.2f' % (
+            work, '原地改写', rmw, rmw, rmw, ppb * page / (sectors * SECTOR), 1048576.0 / (sectors * SECTOR)))
+    return 1 if bad else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('cmd', nargs='?', choices=('torture', 'bench'), default='torture')
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--ops', type=int, help='每个场景的主机操作数, 默认 torture 100000, bench 20000')
+    ap.add_argument('--trd', type=float, default=25.0, help='页读取时间, us')
+    ap.add_argument('--tprog', type=float, default=250.0, help='页编程时间, us')
+    ap.add_argument('--ters', type=float, default=2000.0, help='块擦除时间, us')
+    ap.add_argument('--mbps', type=float, default=40.0, help='EXMC 总线传输速率, MB/s')
+    args = ap.parse_args()
+    if args.ops is None:
+        args.ops = 100000 if args.cmd == 'torture' else 20000
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args, tmp)
+        if exe is None:
+            return 1
+        return torture(args, exe) if args.cmd == 'torture' else bench(args, exe)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
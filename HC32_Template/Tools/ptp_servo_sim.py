@@ -0,0 +1,993 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+User/BSP/ptp_slave.c 的主机构建和离线仿真, 用来在上板之前调 fKp/fKi/u32StepNs/u32MaxPpb.
+
+ptp_slave.c 原样在主机上编译, ETH_PTP_xx/ETH_MACADDR_xx/ETH_PPS_xx 和 ETHIF_xx 接到一个从时钟模型上:
+从时钟 = 主时钟 + 自由运行偏差 + 伺服修正; 伺服修正按 ETH_PTP_SetBasicAddend/UpdateBasicAddend 写入的
+加数换算频率(加数 x 亚秒增量 x HCLK / 2^32 ns/s)积分, ETH_PTP_SetUpdateTime/UpdateSysTime 的阶跃直接加减.
+主时钟一侧按时间戳流构造 Sync/Follow_Up/Delay_Resp 报文(L2 或 UDP/IPv4, 一步或两步, 带 correctionField),
+接收时间戳和 Delay_Req 的发送时间戳由模型按 --tick 量化后给出. 时间戳流每个同步周期一行:
+Sync 的 t1、正向延迟、此刻的自由运行偏差, Delay_Req 发出的主时钟时刻(Sync 处理完后立即发出)、
+反向延迟、此刻的自由运行偏差,
+以及丢包/干扰标志, 由 synth 合成或由 replay 从板上记录还原.
+
+    ptp_servo_sim.py synth [--ppm 30] [--wander 2] [--delay 5000] [--jitter 200] [--bound 1000] ...
+        合成一段主从时钟: 从时钟有固定频偏加随机游走, 路径延迟带高斯抖动;
+        输出锁定时间和锁定后的 RMS/最大偏差(测得的和模型中真实的), --csv 时逐样本写出
+    ptp_servo_sim.py replay samples.txt [--kp 0.5 --ki 0.1 ...]
+        回放板上 pfnSample 打印的记录, 每行 "t1 t2 delay offset freq_ppb step"(ns, 十进制, 空格分隔),
+        先去掉原伺服施加的修正, 还原出自由运行时的偏差, 再用候选参数经主机构建重跑一遍
+    ptp_servo_sim.py ctest [--cases 40] [--seed 1]
+        随机场景: 两种传输方式、一步/两步、Delay_Req 频率、频偏、抖动、时间戳分辨率、初始偏差
+        (含从 0 起步的大阶跃)、透明时钟修正, 叠加丢包、无时间戳的 Sync、丢失的发送时间戳、缓冲区耗尽、
+        其他主时钟的 Sync、序号不符的 Follow_Up、发给其他端口的 Delay_Resp、非 PTP 帧. 检查项:
+          1. 样本的 t1/t2 与注入的一致(correctionField 计入), offset = t2 - t1 - delay,
+             delay 在已完成的各次测量之间; 每个同步周期至多一个样本;
+          2. Delay_Req 的帧头、IPv4/UDP 头、端口 ID 和序号正确并请求发送时间戳; 发送失败时缓冲区归还;
+          3. 加数换算出的频率与 i32FreqPpb 一致; 其他主时钟不会抢走父时钟;
+          4. 统计计数与注入的报文一致, 结束后缓冲区不丢不重;
+          5. --lock-by 个样本内锁定(连续 8 个 |offset| < 1000ns), 锁定后模型中真实的偏差小于 --bound.
+    synth 锁定后真实偏差超出 --bound(replay 为测得的偏差)或未锁定时返回 1; ctest 全部通过返回 0, 否则打印前若干处差异并返回 1.
+    修改 ptp_slave.c 后运行一次 ctest.
+"""
+
+import argparse
+import csv
+import math
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'User', 'BSP', 'ptp_slave.c')
+MAX_REPORT = 20
+NS_PER_SEC = 1000000000
+LOCK_NS = 1000
+LOCK_COUNT = 8
+EPOCH = 1700000000 * NS_PER_SEC
+
+# 每行的标志, 与 DRIVER 中 HOST_F_xx 相同
+F_DROP_SYNC = 0x001
+F_DROP_FU = 0x002
+F_DROP_RESP = 0x004
+F_NO_TS = 0x008
+F_TX_LOST = 0x010
+F_ALLOC_FAIL = 0x020
+F_OUTPUT_FAIL = 0x040
+F_FOREIGN = 0x080
+F_STALE_FU = 0x100
+F_RESP_FIRST = 0x200
+F_WRONG_PORT = 0x400
+F_NON_PTP = 0x800
+F_IP_OPT = 0x1000
+F_TWO_STEP = 0x10000
+LOSS_FLAGS = (F_DROP_SYNC, F_DROP_FU, F_DROP_RESP, F_NO_TS, F_TX_LOST, F_ALLOC_FAIL, F_OUTPUT_FAIL)
+NOISE_FLAGS = (F_FOREIGN, F_STALE_FU, F_RESP_FIRST, F_WRONG_PORT, F_NON_PTP, F_IP_OPT)
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ptp_slave.h"
+
+#define HOST_BUF_NUM        (8)
+#define HOST_F_DROP_SYNC    (0x001U)
+#define HOST_F_DROP_FU      (0x002U)
+#define HOST_F_DROP_RESP    (0x004U)
+#define HOST_F_NO_TS        (0x008U)
+#define HOST_F_TX_LOST      (0x010U)
+#define HOST_F_ALLOC_FAIL   (0x020U)
+#define HOST_F_OUTPUT_FAIL  (0x040U)
+#define HOST_F_FOREIGN      (0x080U)
+#define HOST_F_STALE_FU     (0x100U)
+#define HOST_F_RESP_FIRST   (0x200U)
+#define HOST_F_WRONG_PORT   (0x400U)
+#define HOST_F_NON_PTP      (0x800U)
+#define HOST_F_IP_OPT       (0x1000U)
+#define HOST_F_TWO_STEP     (0x10000U)
+
+#define ERR(...)    do { if (m_u32Errors++ < 20U) { printf("E "); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const uint8_t m_au8Mac[6] = {0x02U, 0x00U, 0x00U, 0x12U, 0x34U, 0x56U};
+static const uint8_t m_au8PortId[10] = {0x02U, 0x00U, 0x00U, 0xFFU, 0xFEU, 0x12U, 0x34U, 0x56U, 0x00U, 0x01U};
+static const uint8_t m_au8MasterMac[6] = {0x00U, 0x1BU, 0x19U, 0x00U, 0x00U, 0x01U};
+static const uint8_t m_au8Master[10] = {0x00U, 0x1BU, 0x19U, 0xFFU, 0xFEU, 0x00U, 0x00U, 0x01U, 0x00U, 0x01U};
+static const uint8_t m_au8Foreign[10] = {0x00U, 0x1BU, 0x19U, 0xFFU, 0xFEU, 0x00U, 0x00U, 0x02U, 0x00U, 0x01U};
+static const uint8_t m_au8Other[10] = {0x02U, 0x00U, 0x00U, 0xFFU, 0xFEU, 0x12U, 0x34U, 0x57U, 0x00U, 0x01U};
+static const uint8_t m_au8L2Dst[6] = {0x01U, 0x1BU, 0x19U, 0x00U, 0x00U, 0x00U};
+static const uint8_t m_au8Ip4Dst[6] = {0x01U, 0x00U, 0x5EU, 0x00U, 0x01U, 0x81U};
+static const uint32_t m_u32Ip = 0xC0A8010AUL;
+
+static stc_ptp_config_t m_stcCfg;
+static uint32_t m_u32Tick;
+static uint32_t m_u32Errors;
+
+/* 缓冲区池 */
+static stc_ethif_buf_t m_astcBuf[HOST_BUF_NUM];
+static uint8_t m_au8Used[HOST_BUF_NUM];
+static uint8_t m_u8FailAlloc;
+static uint8_t m_u8FailOutput;
+static stc_ethif_buf_t *m_pstcTx;
+
+/* 从时钟模型: 本地 = 主 + 自由运行偏差 + m_ldCorr */
+static long double m_ldCorr;
+static int64_t m_i64Now;
+static uint32_t m_u32Addend;
+static uint32_t m_u32AddendNew;
+static uint8_t m_u8Inc;
+static uint8_t m_u8IncNew;
+static uint8_t m_u8PtpInit;
+static uint32_t m_u32UpdSign;
+static uint64_t m_u64Upd;
+
+/* 期望 */
+static int64_t m_i64ExpT1;
+static int64_t m_i64ExpT2;
+static int64_t m_i64True;
+static uint32_t m_u32RowSamples;
+static uint8_t m_u8HaveRaw;
+static int64_t m_i64RawMin;
+static int64_t m_i64RawMax;
+static uint16_t m_u16ReqSeq;
+static stc_ptp_stats_t m_stcExp;
+
+static long double HOST_Rate(void) {
+    return (long double)m_u32Addend * (long double)m_u8Inc * (long double)HCLK_VALUE / 4294967296.0L / 1.0e9L;
+}
+
+/* 推进到主时钟时刻, 修正量按当前加数积分 */
+static void HOST_Advance(int64_t i64Master) {
+    if (i64Master < m_i64Now) {
+        ERR("time goes back %lld -> %lld", (long long)m_i64Now, (long long)i64Master);
+        return;
+    }
+
+    m_ldCorr += (HOST_Rate() - 1.0L) * (long double)(i64Master - m_i64Now);
+    m_i64Now = i64Master;
+}
+
+/* 硬件时间戳: 本地时间按分辨率向下取整 */
+static int64_t HOST_Stamp(int64_t i64Master, int64_t i64Phase) {
+    int64_t i64Local = i64Master + i64Phase + (int64_t)floorl(m_ldCorr);
+
+    if (i64Local < 0) {
+        ERR("local time negative %lld", (long long)i64Local);
+        return 0;
+    }
+
+    return i64Local - (i64Local % (int64_t)m_u32Tick);
+}
+
+static stc_ethif_buf_t *HOST_Alloc(void) {
+    uint32_t i;
+
+    for (i = 0U; i < HOST_BUF_NUM; i++) {
+        if (0U == m_au8Used[i]) {
+            m_au8Used[i] = 1U;
+            (void)memset(&m_astcBuf[i], 0, sizeof(m_astcBuf[i]));
+            m_astcBuf[i].pu8Payload = m_astcBuf[i].au8Data;
+            return &m_astcBuf[i];
+        }
+    }
+
+    ERR("buffer pool empty");
+    exit(1);
+}
+
+static void HOST_Free(stc_ethif_buf_t *pstcBuf) {
+    uint32_t i = (uint32_t)(pstcBuf - m_astcBuf);
+
+    if ((pstcBuf < m_astcBuf) || (i >= HOST_BUF_NUM) || (pstcBuf != &m_astcBuf[i])) {
+        ERR("free of foreign buffer");
+    } else if (0U == m_au8Used[i]) {
+        ERR("double free of buffer %u", i);
+    } else {
+        m_au8Used[i] = 0U;
+    }
+}
+
+/* ---- ETH 库 ---- */
+int32_t ETH_PTP_StructInit(stc_eth_ptp_init_t *pstcPtpInit) {
+    (void)memset(pstcPtpInit, 0, sizeof(*pstcPtpInit));
+    return LL_OK;
+}
+
+int32_t ETH_PTP_Init(const stc_eth_ptp_init_t *pstcPtpInit) {
+    uint32_t u32Frame = (PTP_TRANSPORT_L2 == m_stcCfg.u8Transport) ?
+                        ETH_PTP_FRAME_TYPE_ETH_FRAME : ETH_PTP_FRAME_TYPE_IPV4_FRAME;
+
+    if ((ETH_PTP_SUBSEC_SCALE_DEC != pstcPtpInit->u32SubsecScale) ||
+        (ETH_PTP_CALIB_MD_FINE != pstcPtpInit->u32CalibMode) ||
+        (ETH_PTP_DATAGRAM_VER_IEEE1588V2 != pstcPtpInit->u32DatagramVersion) ||
+        (ETH_PTP_DATAGRAM_TYPE_SYNC_FOLLOW_DELAY != pstcPtpInit->u32SnapDatagramType) ||
+        (u32Frame != pstcPtpInit->u32SnapFrameType)) {
+        ERR("ETH_PTP_Init mode");
+    }
+
+    m_u32Addend = pstcPtpInit->u32BasicAddend;
+    m_u8Inc = pstcPtpInit->u8SubsecAddend;
+
+    /* 累加器每个 HCLK 至多溢出一次, 标称频率误差不超过 1ppb */
+    if (((uint64_t)m_u8Inc * HCLK_VALUE < 1000000000ULL) || (fabsl(HOST_Rate() - 1.0L) > 1.0e-9L)) {
+        ERR("ETH_PTP_Init addend %lu inc %u", (unsigned long)m_u32Addend, m_u8Inc);
+    }
+
+    m_u8PtpInit = 1U;
+    return LL_OK;
+}
+
+void ETH_PTP_SetBasicAddend(uint32_t u32BasicAddend, uint8_t u8SubsecAddend) {
+    m_u32AddendNew = u32BasicAddend;
+    m_u8IncNew = u8SubsecAddend;
+}
+
+int32_t ETH_PTP_UpdateBasicAddend(void) {
+    m_u32Addend = m_u32AddendNew;
+    m_u8Inc = m_u8IncNew;
+    return LL_OK;
+}
+
+void ETH_PTP_SetUpdateTime(uint32_t u32Sign, uint32_t u32Sec, uint32_t u32Subsec) {
+    if (u32Subsec >= 1000000000UL) {
+        ERR("update subsec %lu", (unsigned long)u32Subsec);
+    }
+
+    m_u32UpdSign = u32Sign;
+    m_u64Upd = (uint64_t)u32Sec * 1000000000ULL + u32Subsec;
+}
+
+int32_t ETH_PTP_UpdateSysTime(void) {
+    if (ETH_PTP_TIME_UPDATE_SIGN_MINUS == m_u32UpdSign) {
+        m_ldCorr -= (long double)m_u64Upd;
+    } else {
+        m_ldCorr += (long double)m_u64Upd;
+    }
+
+    return LL_OK;
+}
+
+int32_t ETH_MACADDR_StructInit(stc_eth_mac_addr_config_t *pstcMacAddrInit) {
+    (void)memset(pstcMacAddrInit, 0, sizeof(*pstcMacAddrInit));
+    return LL_OK;
+}
+
+int32_t ETH_MACADDR_Init(uint32_t u32Index, const stc_eth_mac_addr_config_t *pstcMacAddrInit) {
+    const uint8_t *pu8Dst = (PTP_TRANSPORT_L2 == m_stcCfg.u8Transport) ? m_au8L2Dst : m_au8Ip4Dst;
+
+    if ((ETH_MAC_ADDR_IDX1 != u32Index) || (0 != memcmp(pstcMacAddrInit->au8MacAddr, pu8Dst, 6U)) ||
+        (ETH_MAC_ADDR_FILTER_PERFECT_DEST_ADDR != pstcMacAddrInit->u32MacAddrFilter)) {
+        ERR("multicast filter");
+    }
+
+    return LL_OK;
+}
+
+int32_t ETH_PPS_StructInit(stc_eth_pps_config_t *pstcPpsInit) {
+    (void)memset(pstcPpsInit, 0, sizeof(*pstcPpsInit));
+    return LL_OK;
+}
+
+int32_t ETH_PPS_Init(uint8_t u8Ch, const stc_eth_pps_config_t *pstcPpsInit) {
+    if ((ETH_PPS_CH0 != u8Ch) || (ETH_PPS_OUTPUT_FREQ_1HZ != pstcPpsInit->u32OutputFreq)) {
+        ERR("PPS");
+    }
+
+    return LL_OK;
+}
+
+/* ---- ETHIF ---- */
+stc_ethif_buf_t *ETHIF_BufAlloc(void) {
+    if (0U != m_u8FailAlloc) {
+        m_u8FailAlloc = 0U;
+        m_stcExp.u32TxFail++;
+        return NULL;
+    }
+
+    return HOST_Alloc();
+}
+
+void ETHIF_BufFree(stc_ethif_buf_t *pstcBuf) {
+    HOST_Free(pstcBuf);
+}
+
+int32_t ETHIF_Output(stc_ethif_buf_t *pstcChain) {
+    if (0U != m_u8FailOutput) {
+        m_u8FailOutput = 0U;
+        m_stcExp.u32TxFail++;
+        return LL_ERR_BUSY;
+    }
+
+    if (NULL != m_pstcTx) {
+        ERR("two Delay_Req in one sync interval");
+        HOST_Free(m_pstcTx);
+    }
+
+    m_pstcTx = pstcChain;
+    m_stcExp.u32DelayReqTx++;
+    return LL_OK;
+}
+
+/* ---- 报文 ---- */
+static void HOST_Put16(uint8_t *pu8Buf, uint32_t u32Val) {
+    pu8Buf[0] = (uint8_t)(u32Val >> 8U);
+    pu8Buf[1] = (uint8_t)u32Val;
+}
+
+static void HOST_Put32(uint8_t *pu8Buf, uint32_t u32Val) {
+    HOST_Put16(pu8Buf, u32Val >> 16U);
+    HOST_Put16(&pu8Buf[2], u32Val & 0xFFFFU);
+}
+
+static uint32_t HOST_Get16(const uint8_t *pu8Buf) {
+    return ((uint32_t)pu8Buf[0] << 8U) | pu8Buf[1];
+}
+
+static uint32_t HOST_Get32(const uint8_t *pu8Buf) {
+    return (HOST_Get16(pu8Buf) << 16U) | HOST_Get16(&pu8Buf[2]);
+}
+
+/* 主时钟发出的报文; u8Transport 为 0xFF 时造一个 ARP 帧 */
+static stc_ethif_buf_t *HOST_Frame(uint8_t u8Type, const uint8_t *pu8Port, uint16_t u16Seq, uint8_t u8TwoStep,
+                                   int64_t i64Ts, int64_t i64Corr, const uint8_t *pu8Req, uint32_t u32Flags) {
+    stc_ethif_buf_t *pstcBuf = HOST_Alloc();
+    uint8_t *pu8Frame = pstcBuf->pu8Payload;
+    uint8_t *pu8Msg;
+    uint32_t u32Len = (0x9U == u8Type) ? 54U : 44U;
+    uint32_t u32Ihl = (0U != (u32Flags & HOST_F_IP_OPT)) ? 24U : 20U;
+    uint64_t u64Sec = (uint64_t)i64Ts / 1000000000ULL;
+    uint32_t i;
+
+    (void)memcpy(&pu8Frame[6], m_au8MasterMac, 6U);
+
+    if (0U != (u32Flags & HOST_F_NON_PTP)) {
+        (void)memset(pu8Frame, 0xFF, 6U);
+        HOST_Put16(&pu8Frame[12], 0x0806U);
+        pstcBuf->u16Len = 42U;
+        return pstcBuf;
+    }
+
+    if (PTP_TRANSPORT_L2 == m_stcCfg.u8Transport) {
+        (void)memcpy(pu8Frame, m_au8L2Dst, 6U);
+        HOST_Put16(&pu8Frame[12], 0x88F7U);
+        pu8Msg = &pu8Frame[14];
+        pstcBuf->u16Len = (uint16_t)(14U + u32Len);
+    } else {
+        (void)memcpy(pu8Frame, m_au8Ip4Dst, 6U);
+        HOST_Put16(&pu8Frame[12], 0x0800U);
+        pu8Msg = &pu8Frame[14];
+        pu8Msg[0] = (uint8_t)(0x40U | (u32Ihl / 4U));
+        HOST_Put16(&pu8Msg[2], u32Ihl + 8U + u32Len);
+        HOST_Put16(&pu8Msg[6], 0x4000U);                /* DF */
+        pu8Msg[8] = 1U;
+        pu8Msg[9] = 17U;
+        HOST_Put32(&pu8Msg[12], 0xC0A80101UL);
+        HOST_Put32(&pu8Msg[16], 0xE0000181UL);
+        pu8Msg += u32Ihl;
+        HOST_Put16(&pu8Msg[0], (0x0U == u8Type) ? 319U : 320U);
+        HOST_Put16(&pu8Msg[2], (0x0U == u8Type) ? 319U : 320U);
+        HOST_Put16(&pu8Msg[4], 8U + u32Len);
+        pu8Msg += 8U;
+        pstcBuf->u16Len = (uint16_t)(14U + u32Ihl + 8U + u32Len);
+    }
+
+    pu8Msg[0] = u8Type;
+    pu8Msg[1] = 2U;
+    HOST_Put16(&pu8Msg[2], u32Len);
+    pu8Msg[4] = m_stcCfg.u8Domain;
+    pu8Msg[6] = (0U != u8TwoStep) ? 0x02U : 0x00U;
+
+    for (i = 0U; i < 8U; i++) {
+        pu8Msg[8U + i] = (uint8_t)(((uint64_t)(i64Corr * 65536LL)) >> (56U - 8U * i));
+    }
+
+    (void)memcpy(&pu8Msg[20], pu8Port, 10U);
+    HOST_Put16(&pu8Msg[30], u16Seq);
+    pu8Msg[32] = (0x0U == u8Type) ? 0U : ((0x8U == u8Type) ? 2U : 3U);
+
+    for (i = 0U; i < 6U; i++) {
+        pu8Msg[34U + i] = (uint8_t)(u64Sec >> (40U - 8U * i));
+    }
+
+    HOST_Put32(&pu8Msg[40], (uint32_t)((uint64_t)i64Ts % 1000000000ULL));
+
+    if (NULL != pu8Req) {
+        (void)memcpy(&pu8Msg[44], pu8Req, 10U);
+    }
+
+    return pstcBuf;
+}
+
+static void HOST_Deliver(stc_ethif_buf_t *pstcBuf, uint8_t u8Ptp) {
+    int32_t i32Ret = PTP_Input(pstcBuf);
+
+    if ((0U != u8Ptp) && (LL_OK != i32Ret)) {
+        ERR("PTP frame not taken");
+    } else if ((0U == u8Ptp) && (LL_ERR != i32Ret)) {
+        ERR("non-PTP frame taken");
+    }
+
+    if (LL_OK != i32Ret) {
+        HOST_Free(pstcBuf);
+    }
+}
+
+static void HOST_Timestamp(stc_ethif_buf_t *pstcBuf, int64_t i64Ts) {
+    pstcBuf->u16Flags |= ETHIF_BUF_FLAG_TIMESTAMP;
+    pstcBuf->u32TsSec = (uint32_t)(i64Ts / 1000000000LL);
+    pstcBuf->u32TsSubsec = (uint32_t)(i64Ts % 1000000000LL);
+}
+
+static void HOST_CheckDelayReq(const stc_ethif_buf_t *pstcBuf) {
+    const uint8_t *pu8Frame = pstcBuf->pu8Payload;
+    const uint8_t *pu8Msg = &pu8Frame[14];
+
+    if ((0U == (pstcBuf->u16Flags & ETHIF_BUF_FLAG_TIMESTAMP)) || (0 != memcmp(&pu8Frame[6], m_au8Mac, 6U))) {
+        ERR("Delay_Req flags/source");
+    }
+
+    if (PTP_TRANSPORT_L2 == m_stcCfg.u8Transport) {
+        if ((0 != memcmp(pu8Frame, m_au8L2Dst, 6U)) || (0x88F7U != HOST_Get16(&pu8Frame[12])) ||
+            ((14U + 44U) != pstcBuf->u16Len)) {
+            ERR("Delay_Req L2 header");
+        }
+    } else {
+        if ((0 != memcmp(pu8Frame, m_au8Ip4Dst, 6U)) || (0x0800U != HOST_Get16(&pu8Frame[12])) ||
+            ((14U + 20U + 8U + 44U) != pstcBuf->u16Len) || (0x45U != pu8Msg[0]) ||
+            ((20U + 8U + 44U) != HOST_Get16(&pu8Msg[2])) || (0U != (HOST_Get16(&pu8Msg[6]) & 0x3FFFU)) ||
+            (0U == pu8Msg[8]) || (17U != pu8Msg[9]) || (m_u32Ip != HOST_Get32(&pu8Msg[12])) ||
+            (0xE0000181UL != HOST_Get32(&pu8Msg[16])) || (319U != HOST_Get16(&pu8Msg[20])) ||
+            (319U != HOST_Get16(&pu8Msg[22])) || ((8U + 44U) != HOST_Get16(&pu8Msg[24]))) {
+            ERR("Delay_Req IPv4/UDP header");
+        }
+
+        pu8Msg += 28U;
+    }
+
+    m_u16ReqSeq++;
+
+    if ((0x1U != (pu8Msg[0] & 0x0FU)) || (2U != (pu8Msg[1] & 0x0FU)) || (44U != HOST_Get16(&pu8Msg[2])) ||
+        (m_stcCfg.u8Domain != pu8Msg[4]) || (0 != memcmp(&pu8Msg[20], m_au8PortId, 10U)) ||
+        (m_u16ReqSeq != HOST_Get16(&pu8Msg[30])) || (1U != pu8Msg[32])) {
+        ERR("Delay_Req message seq %u/%u", (unsigned)HOST_Get16(&pu8Msg[30]), (unsigned)m_u16ReqSeq);
+        m_u16ReqSeq = (uint16_t)HOST_Get16(&pu8Msg[30]);
+    }
+}
+
+static void HOST_Sample(const stc_ptp_sample_t *pstcSample) {
+    if (0U != m_u32RowSamples++) {
+        ERR("two samples in one sync interval");
+    }
+
+    if ((pstcSample->i64T1 != m_i64ExpT1) || (pstcSample->i64T2 != m_i64ExpT2)) {
+        ERR("sample t1/t2 %lld/%lld, sent %lld/%lld", (long long)pstcSample->i64T1, (long long)pstcSample->i64T2,
+            (long long)m_i64ExpT1, (long long)m_i64ExpT2);
+    }
+
+    if ((pstcSample->i64Offset != (pstcSample->i64T2 - pstcSample->i64T1 - pstcSample->i32Delay)) ||
+        (pstcSample->u8State > PTP_SERVO_TRACKING)) {
+        ERR("sample offset/state");
+    }
+
+    if ((0U == m_u8HaveRaw) || (pstcSample->i32Delay < m_i64RawMin) || (pstcSample->i32Delay > m_i64RawMax)) {
+        ERR("delay %ld outside measured [%lld, %lld]", (long)pstcSample->i32Delay, (long long)m_i64RawMin,
+            (long long)m_i64RawMax);
+    }
+
+    if (0LL != pstcSample->i64Step) {
+        m_stcExp.u32Steps++;
+    }
+
+    printf("T %lld %lld %ld %lld %ld %lld %u %lld\n", (long long)pstcSample->i64T1, (long long)pstcSample->i64T2,
+           (long)pstcSample->i32Delay, (long long)pstcSample->i64Offset, (long)pstcSample->i32FreqPpb,
+           (long long)pstcSample->i64Step, pstcSample->u8State, (long long)m_i64True);
+}
+
+/* 一个同步周期 */
+static void HOST_Row(int64_t i64T1, int64_t i64Fwd, int64_t i64PhRx, int64_t i64T3m, int64_t i64Back,
+                     int64_t i64PhTx, uint32_t u32Flags, int64_t i64Cs, int64_t i64Cf, int64_t i64Cr) {
+    static uint16_t u16Seq;
+    uint8_t u8TwoStep = (0U != (u32Flags & HOST_F_TWO_STEP)) ? 1U : 0U;
+    uint32_t u32Ip = u32Flags & HOST_F_IP_OPT;
+    uint32_t u32Steps;
+    stc_ethif_buf_t *pstcBuf;
+    stc_ptp_stats_t stcStats;
+    uint8_t u8SyncOk = 0U;
+    int64_t i64T2;
+    int64_t i64T3;
+    int64_t i64T4;
+    long double ldPpb;
+
+    u16Seq++;
+    m_u32RowSamples = 0U;
+    u32Steps = m_stcExp.u32Steps;
+
+    HOST_Advance(i64T1 + i64Fwd);
+    i64T2 = HOST_Stamp(i64T1 + i64Fwd, i64PhRx);
+    m_i64ExpT1 = i64T1;
+    m_i64ExpT2 = i64T2;
+    m_i64True = llroundl((long double)i64PhRx + m_ldCorr);
+    m_u8FailAlloc = (0U != (u32Flags & HOST_F_ALLOC_FAIL)) ? 1U : 0U;
+    m_u8FailOutput = (0U != (u32Flags & HOST_F_OUTPUT_FAIL)) ? 1U : 0U;
+
+    if (0U == (u32Flags & HOST_F_DROP_SYNC)) {
+        pstcBuf = HOST_Frame(0x0U, m_au8Master, u16Seq, u8TwoStep,
+                             (0U != u8TwoStep) ? (i64T1 - i64Cs + 777LL) : (i64T1 - i64Cs), i64Cs, NULL, u32Ip);
+
+        if (0U == (u32Flags & HOST_F_NO_TS)) {
+            HOST_Timestamp(pstcBuf, i64T2);
+            m_stcExp.u32SyncRx++;
+            u8SyncOk = 1U;
+        } else {
+            m_stcExp.u32NoTimestamp++;
+        }
+
+        HOST_Deliver(pstcBuf, 1U);
+    }
+
+    if (0U != (u32Flags & HOST_F_NON_PTP)) {
+        HOST_Deliver(HOST_Frame(0x0U, m_au8Master, u16Seq, 0U, i64T1, 0LL, NULL, HOST_F_NON_PTP), 0U);
+    }
+
+    /* 另一个主时钟的一步 Sync, 时间差得很远, 不应换主; 阶跃之后总发一个, 父时钟的静默计时须跟着换时间轴 */
+    if ((0U != u8SyncOk) && ((0U != (u32Flags & HOST_F_FOREIGN)) || (u32Steps != m_stcExp.u32Steps))) {
+        HOST_Advance(i64T1 + i64Fwd + 1000LL);
+        pstcBuf = HOST_Frame(0x0U, m_au8Foreign, (uint16_t)(u16Seq * 7U), 0U, i64T1 + 7000000000LL, 0LL, NULL,
+                             u32Ip);
+        HOST_Timestamp(pstcBuf, HOST_Stamp(i64T1 + i64Fwd + 1000LL, i64PhRx));
+        HOST_Deliver(pstcBuf, 1U);
+    }
+
+    if (0U != u8TwoStep) {
+        if (0U != (u32Flags & HOST_F_STALE_FU)) {
+            HOST_Deliver(HOST_Frame(0x8U, m_au8Master, (uint16_t)(u16Seq + 100U), 0U, i64T1 + 123456789LL, 0LL,
+                                    NULL, u32Ip), 1U);
+        }
+
+        if (0U == (u32Flags & HOST_F_DROP_FU)) {
+            HOST_Deliver(HOST_Frame(0x8U, m_au8Master, u16Seq, 0U, i64T1 - i64Cs - i64Cf, i64Cf, NULL, u32Ip), 1U);
+
+            if (0U != u8SyncOk) {
+                m_stcExp.u32FollowUpRx++;
+            }
+        }
+    }
+
+    if (NULL != m_pstcTx) {
+        HOST_CheckDelayReq(m_pstcTx);
+        HOST_Free(m_pstcTx);
+        m_pstcTx = NULL;
+
+        HOST_Advance(i64T3m);
+        i64T3 = HOST_Stamp(i64T3m, i64PhTx);
+        i64T4 = i64T3m + i64Back;
+
+        if (0U == (u32Flags & (HOST_F_RESP_FIRST | HOST_F_TX_LOST))) {
+            PTP_TxTimestamp((uint32_t)(i64T3 / 1000000000LL), (uint32_t)(i64T3 % 1000000000LL));
+        }
+
+        if (0U != (u32Flags & HOST_F_WRONG_PORT)) {
+            HOST_Deliver(HOST_Frame(0x9U, m_au8Master, m_u16ReqSeq, 0U, i64T4 + 5555LL, 0LL, m_au8Other, u32Ip),
+                         1U);
+        }
+
+        if (0U == (u32Flags & HOST_F_DROP_RESP)) {
+            HOST_Deliver(HOST_Frame(0x9U, m_au8Master, m_u16ReqSeq, 0U, i64T4 + i64Cr, i64Cr, m_au8PortId, u32Ip),
+                         1U);
+            m_stcExp.u32DelayRespRx++;
+        }
+
+        if ((0U != (u32Flags & HOST_F_RESP_FIRST)) && (0U == (u32Flags & HOST_F_TX_LOST))) {
+            PTP_TxTimestamp((uint32_t)(i64T3 / 1000000000LL), (uint32_t)(i64T3 % 1000000000LL));
+        }
+
+        if (0U == (u32Flags & (HOST_F_DROP_RESP | HOST_F_TX_LOST))) {
+            int64_t i64Raw = ((i64T2 - i64T1) + (i64T4 - i64T3)) / 2LL;
+
+            if (i64Raw >= 0LL) {
+                if ((0U == m_u8HaveRaw) || (i64Raw < m_i64RawMin)) {
+                    m_i64RawMin = i64Raw;
+                }
+
+                if ((0U == m_u8HaveRaw) || (i64Raw > m_i64RawMax)) {
+                    m_i64RawMax = i64Raw;
+                }
+
+                m_u8HaveRaw = 1U;
+            }
+        }
+    }
+
+    /* 加数换算的频率与伺服输出一致 */
+    PTP_GetStats(&stcStats);
+    ldPpb = (HOST_Rate() - 1.0L) * 1.0e9L;
+
+    if (fabsl(ldPpb - (long double)stcStats.i32FreqPpb) > 2.0L) {
+        ERR("addend gives %.1Lf ppb, servo %ld", ldPpb, (long)stcStats.i32FreqPpb);
+    }
+
+    if (((0U != m_stcExp.u32SyncRx) ? 1U : 0U) != stcStats.u32ParentChanges) {
+        ERR("parent changes %lu", (unsigned long)stcStats.u32ParentChanges);
+    }
+}
+
+int main(void) {
+    char acLine[512];
+    stc_ptp_config_t stcCfg;
+    stc_ptp_stats_t stcStats;
+    unsigned uTransport;
+    unsigned uDomain;
+    unsigned uRate;
+    unsigned long ulStep;
+    unsigned long ulMaxPpb;
+    double dKp;
+    double dKi;
+    long long allRow[10];
+    uint8_t u8First = 1U;
+    uint32_t i;
+
+    if ((NULL == fgets(acLine, sizeof(acLine), stdin)) ||
+        (8 != sscanf(acLine, "C %u %u %u %lf %lf %lu %lu %u", &uTransport, &uDomain, &uRate, &dKp, &dKi, &ulStep,
+                     &ulMaxPpb, &m_u32Tick))) {
+        printf("E bad config line\n");
+        return 1;
+    }
+
+    (void)memset(&m_stcCfg, 0, sizeof(m_stcCfg));
+    (void)memcpy(m_stcCfg.au8MacAddr, m_au8Mac, 6U);
+    m_stcCfg.u8Transport = (uint8_t)uTransport;
+    m_stcCfg.u8Domain = (uint8_t)uDomain;
+    m_stcCfg.u32IpAddr = m_u32Ip;
+    m_stcCfg.u8DelayReqRate = (uint8_t)uRate;
+    m_stcCfg.u8PpsEnable = 1U;
+    m_stcCfg.u32StepNs = (uint32_t)ulStep;
+    m_stcCfg.u32MaxPpb = (uint32_t)ulMaxPpb;
+    m_stcCfg.fKp = (float)dKp;
+    m_stcCfg.fKi = (float)dKi;
+    m_stcCfg.pfnSample = HOST_Sample;
+
+    stcCfg = m_stcCfg;
+    stcCfg.u8DelayReqRate = 0U;
+
+    if ((LL_ERR_INVD_PARAM != PTP_Init(NULL)) || (LL_ERR_INVD_PARAM != PTP_Init(&stcCfg))) {
+        ERR("PTP_Init accepts bad config");
+    }
+
+    if ((LL_OK != PTP_Init(&m_stcCfg)) || (0U == m_u8PtpInit)) {
+        ERR("PTP_Init");
+    }
+
+    while (NULL != fgets(acLine, sizeof(acLine), stdin)) {
+        if (10 != sscanf(acLine, "R %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld", &allRow[0], &allRow[1],
+                         &allRow[2], &allRow[3], &allRow[4], &allRow[5], &allRow[6], &allRow[7], &allRow[8],
+                         &allRow[9])) {
+            continue;
+        }
+
+        if (0U != u8First) {
+            u8First = 0U;
+            m_i64Now = allRow[0];
+        }
+
+        HOST_Row(allRow[0], allRow[1], allRow[2], allRow[3], allRow[4], allRow[5], (uint32_t)allRow[6], allRow[7],
+                 allRow[8], allRow[9]);
+    }
+
+    PTP_GetStats(&stcStats);
+
+    if ((stcStats.u32SyncRx != m_stcExp.u32SyncRx) || (stcStats.u32FollowUpRx != m_stcExp.u32FollowUpRx) ||
+        (stcStats.u32DelayReqTx != m_stcExp.u32DelayReqTx) || (stcStats.u32DelayRespRx != m_stcExp.u32DelayRespRx) ||
+        (stcStats.u32NoTimestamp != m_stcExp.u32NoTimestamp) || (stcStats.u32TxFail != m_stcExp.u32TxFail) ||
+        (stcStats.u32Steps != m_stcExp.u32Steps)) {
+        ERR("stats sync %lu/%lu fu %lu/%lu req %lu/%lu resp %lu/%lu nots %lu/%lu txfail %lu/%lu steps %lu/%lu",
+            (unsigned long)stcStats.u32SyncRx, (unsigned long)m_stcExp.u32SyncRx,
+            (unsigned long)stcStats.u32FollowUpRx, (unsigned long)m_stcExp.u32FollowUpRx,
+            (unsigned long)stcStats.u32DelayReqTx, (unsigned long)m_stcExp.u32DelayReqTx,
+            (unsigned long)stcStats.u32DelayRespRx, (unsigned long)m_stcExp.u32DelayRespRx,
+            (unsigned long)stcStats.u32NoTimestamp, (unsigned long)m_stcExp.u32NoTimestamp,
+            (unsigned long)stcStats.u32TxFail, (unsigned long)m_stcExp.u32TxFail,
+            (unsigned long)stcStats.u32Steps, (unsigned long)m_stcExp.u32Steps);
+    }
+
+    for (i = 0U; i < HOST_BUF_NUM; i++) {
+        if (0U != m_au8Used[i]) {
+            ERR("buffer %lu leaked", (unsigned long)i);
+        }
+    }
+
+    printf("G %lu %lu %lu %lu %lu %u\n", (unsigned long)stcStats.u32SyncRx, (unsigned long)stcStats.u32DelayReqTx,
+           (unsigned long)stcStats.u32DelayRespRx, (unsigned long)stcStats.u32Steps,
+           (unsigned long)stcStats.u32TxFail, stcStats.u8Locked);
+    return (0U == m_u32Errors) ? 0 : 1;
+}
+'''
+
+
+def build(cc, tmp):
+    """编译主机程序, 失败返回 None"""
+    driver = os.path.join(tmp, 'driver.c')
+    with open(driver, 'w', encoding='utf-8') as f:
+        f.write(DRIVER)
+    inc = []
+    for d in ('User', 'User/BSP', 'Boot', 'Library'):
+        inc += ['-I', os.path.join(ROOT, d)]
+    exe = os.path.join(tmp, 'ptp_slave_host')
+    cmd = [cc, '-std=gnu99', '-O1', '-g', '-w', '-fsanitize=address,undefined', '-DHC32F4A0', '-DUSE_DDL_DRIVER',
+           '-DHCLK_VALUE=240000000UL'] + inc + [SOURCE, driver, '-lm', '-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def run(exe, cfg, rows, timeout):
+    """cfg: (transport, domain, rate, kp, ki, step, maxppb, tick); 返回 (样本, 统计, 错误)"""
+    text = ['C %d %d %d %r %r %d %d %d' % cfg]
+    text += ['R ' + ' '.join(str(v) for v in row) for row in rows]
+    try:
+        r = subprocess.run([exe], input='\n'.join(text) + '\n', stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                           universal_newlines=True, timeout=timeout)
+        out, code = r.stdout, r.returncode
+    except subprocess.TimeoutExpired:
+        return [], None, ['timeout after %d s' % timeout]
+    samples, stats, errors = [], None, []
+    for line in out.splitlines():
+        parts = line.split()
+        try:
+            if parts and parts[0] == 'T' and len(parts) == 9:
+                samples.append([int(p) for p in parts[1:]])
+            elif parts and parts[0] == 'G' and len(parts) == 7:
+                stats = [int(p) for p in parts[1:]]
+            elif parts and parts[0] == 'E':
+                errors.append(line[2:])
+        except ValueError:
+            errors.append(line)
+    if code != 0 and not errors:
+        errors.append('exit %d: %s' % (code, out.strip()[-2000:]))
+    if stats is None and not errors:
+        errors.append('no stats line')
+    return samples, stats, errors
+
+
+def report(samples, bound, true=True):
+    """samples: T 行 [t1 t2 delay offset freq step state true]; 返回 (通过, 锁定序号, 说明)"""
+    run_ = 0
+    lock_at = None
+    for i, s in enumerate(samples):
+        run_ = run_ + 1 if abs(s[3]) < LOCK_NS else 0
+        if run_ >= LOCK_COUNT:
+            lock_at = i
+            break
+    if lock_at is None:
+        return False, None, 'never locked (%d samples)' % len(samples)
+    tail = samples[lock_at:]
+    rms = math.sqrt(sum(s[3] * s[3] for s in tail) / len(tail))
+    peak = max(abs(s[3]) for s in tail)
+    text = 'locked after %.1f s (%d samples); after lock: rms %.1f ns, max %d ns' % (
+        (samples[lock_at][0] - samples[0][0]) / NS_PER_SEC, lock_at + 1, rms, peak)
+    ok = peak < bound
+    if true:
+        # 测得的偏差含单次 Sync 的路径抖动, 界限只用于模型中真实的偏差
+        true_peak = max(abs(s[7]) for s in tail)
+        text += ', true max %d ns' % true_peak
+        ok = true_peak < bound
+    text += ' over %d samples' % len(tail)
+    if not ok:
+        text += ' -- exceeds bound %d ns' % bound
+    return ok, lock_at, text
+
+
+def synth_rows(rnd, p):
+    """合成时间戳流, 每行 (t1, fwd, ph_rx, t3m, back, ph_tx, flags, cs, cf, cr)"""
+    interval = int(p['interval'] * NS_PER_SEC)
+    drift = p['ppm'] * 1000.0
+    phase = 0.0
+    rows = []
+    for n in range(p['count']):
+        t1 = p['epoch'] + n * interval
+        drift += rnd.gauss(0.0, p['wander'])
+        fwd = max(0, int(round(p['delay'] + rnd.gauss(0.0, p['jitter']))))
+        back = max(0, int(round(p['delay'] + rnd.gauss(0.0, p['jitter']))))
+        # Delay_Req 在处理完 Sync 后立即发出, 软件延迟 20us~2ms
+        t3m = t1 + fwd + rnd.randint(20000, 2000000)
+        ph_rx = p['initial'] + int(round(phase + drift * fwd / 1e9))
+        ph_tx = p['initial'] + int(round(phase + drift * (t3m - t1) / 1e9))
+        phase += drift * interval / 1e9
+        flags = F_TWO_STEP if p['two_step'] else 0
+        for bit in LOSS_FLAGS:
+            if rnd.random() < p['loss']:
+                flags |= bit
+        for bit in NOISE_FLAGS:
+            if rnd.random() < p['noise']:
+                flags |= bit
+        tc = p['tc']
+        rows.append((t1, fwd, ph_rx, t3m, back, ph_tx, flags,
+                     rnd.randint(0, tc), rnd.randint(0, tc), rnd.randint(0, tc)))
+    return rows
+
+
+def cfg_from(args, transport, rate, tick):
+    return (transport, 0, rate, args.kp, args.ki, args.step, args.maxppb, tick)
+
+
+def write_csv(path, samples):
+    with open(path, 'w', newline='') as f:
+        w = csv.writer(f)
+        w.writerow(['t1', 't2', 'delay', 'offset', 'freq_ppb', 'step', 'state', 'true_offset'])
+        w.writerows(samples)
+
+
+def with_exe(args, body):
+    tmp = tempfile.mkdtemp(prefix='ptp_host_')
+    try:
+        exe = build(args.cc, tmp)
+        if exe is None:
+            return 1
+        return body(exe)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+def cmd_synth(args):
+    p = {'interval': args.interval, 'ppm': args.ppm, 'wander': args.wander, 'delay': args.delay,
+         'jitter': args.jitter, 'initial': args.initial, 'count': args.count, 'epoch': EPOCH,
+         'two_step': args.two_step, 'loss': args.loss, 'noise': 0.0, 'tc': 0}
+    rows = synth_rows(random.Random(args.seed), p)
+    cfg = cfg_from(args, 1 if args.transport == 'udp' else 0, args.rate, args.tick)
+
+    def body(exe):
+        samples, _, errors = run(exe, cfg, rows, args.timeout)
+        for e in errors[:MAX_REPORT]:
+            print('error:', e)
+        if args.csv:
+            write_csv(args.csv, samples)
+        ok, _, text = report(samples, args.bound)
+        print(text)
+        return 0 if ok and not errors else 1
+    return with_exe(args, body)
+
+
+def cmd_replay(args):
+    recs = []
+    with open(args.samples, encoding='utf-8', errors='replace') as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) < 6 or line.lstrip().startswith('#'):
+                continue
+            try:
+                recs.append([int(p) for p in parts[:6]])
+            except ValueError:
+                continue
+    if len(recs) < 3:
+        print('not enough samples')
+        return 2
+    # 还原自由运行的偏差: 减去原伺服在此之前施加的频率修正积分, 加回阶跃
+    free = []
+    applied = 0.0
+    prev_t2, prev_freq = recs[0][1], 0
+    for t1, t2, delay, offset, freq, step in recs:
+        applied += prev_freq * (t2 - prev_t2) / 1e9
+        free.append(int(round(offset - applied)))
+        applied -= step
+        prev_t2, prev_freq = t2, freq
+    # 主时钟时间轴用 t1, Delay_Req 在 Sync 到达后 100us 发出, 其自由运行偏差在相邻两个样本间插值
+    rows = []
+    for k, (t1, t2, delay, offset, freq, step) in enumerate(recs):
+        nxt = recs[k + 1][0] if k + 1 < len(recs) else t1 + (t1 - recs[k - 1][0])
+        slope = (free[k + 1] - free[k]) / max(1, nxt - t1) if k + 1 < len(recs) else 0.0
+        fwd = max(0, delay)
+        t3m = t1 + fwd + 100000
+        rows.append((t1, fwd, free[k], t3m, fwd, free[k] + int(round(slope * (t3m - t1))),
+                     F_TWO_STEP if args.two_step else 0, 0, 0, 0))
+    cfg = cfg_from(args, 0, 1, 1)
+
+    def body(exe):
+        samples, _, errors = run(exe, cfg, rows, args.timeout)
+        for e in errors[:MAX_REPORT]:
+            print('error:', e)
+        print('original: ', report([(r[0], r[1], r[2], r[3]) for r in recs], args.bound, False)[2])
+        ok, _, text = report(samples, args.bound, False)
+        print('candidate:', text)
+        return 0 if ok and not errors else 1
+    return with_exe(args, body)
+
+
+def random_case(rnd, count):
+    """ctest 的一个场景, 在伺服设计范围内: 抖动 sigma 不超过 100ns, 频偏不超过 100ppm"""
+    initial = rnd.choice((3 * NS_PER_SEC, -3 * NS_PER_SEC, 15000, -800, -EPOCH + 2 * NS_PER_SEC))
+    return {'interval': rnd.choice((0.125, 0.25, 0.5, 1.0)), 'ppm': rnd.uniform(-100.0, 100.0),
+            'wander': rnd.uniform(0.0, 2.0), 'delay': rnd.uniform(300.0, 50000.0),
+            'jitter': rnd.uniform(0.0, 100.0), 'initial': initial, 'count': count, 'epoch': EPOCH,
+            'two_step': rnd.random() < 0.5, 'loss': rnd.choice((0.0, 0.01, 0.05)),
+            'noise': rnd.choice((0.0, 0.05, 0.2)), 'tc': rnd.choice((0, 0, 3000))}
+
+
+def cmd_ctest(args):
+    rnd = random.Random(args.seed)
+
+    def body(exe):
+        fails = 0
+        worst = (0, 0)
+        for case in range(args.cases):
+            p = random_case(rnd, args.count)
+            transport = rnd.randint(0, 1)
+            rate = rnd.choice((1, 1, 2, 4))
+            tick = rnd.choice((1, 9, 20))
+            rows = synth_rows(rnd, p)
+            samples, stats, errors = run(exe, cfg_from(args, transport, rate, tick), rows, args.timeout)
+            ok, lock_at, text = report(samples, args.bound)
+            if ok and lock_at >= args.lock_by:
+                errors.append('locked only after %d samples' % (lock_at + 1))
+            elif not ok:
+                errors.append(text)
+            if stats is not None and stats[5] != 1:
+                errors.append('stats not locked at end')
+            if lock_at is not None:
+                peak = max(abs(s[7]) for s in samples[lock_at:])
+                if peak > worst[0]:
+                    worst = (peak, case)
+            if errors:
+                fails += 1
+                if fails <= MAX_REPORT:
+                    desc = '%s %s rate %d tick %d ppm %.1f jitter %.0f interval %.3f initial %d loss %.2f noise %.2f' % (
+                        ('L2', 'UDP4')[transport], ('one-step', 'two-step')[p['two_step']], rate, tick, p['ppm'],
+                        p['jitter'], p['interval'], p['initial'], p['loss'], p['noise'])
+                    print('case %d (%s):' % (case, desc))
+                    for e in errors[:5]:
+                        print('  ' + e)
+        print('%d cases, %d failed, worst offset after lock %d ns (case %d), bound %d ns' % (
+            args.cases, fails, worst[0], worst[1], args.bound))
+        return 0 if fails == 0 else 1
+    return with_exe(args, body)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='PTP slave host build and servo simulation')
+    sub = ap.add_subparsers(dest='cmd')
+    for name in ('synth', 'replay', 'ctest'):
+        p = sub.add_parser(name)
+        if name == 'replay':
+            p.add_argument('samples')
+        p.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+        p.add_argument('--kp', type=float, default=0.5, help='ppb/ns at 1 s interval')
+        p.add_argument('--ki', type=float, default=0.1, help='ppb/ns per sample at 1 s interval')
+        p.add_argument('--step', type=int, default=20000, help='step threshold, ns')
+        p.add_argument('--maxppb', type=int, default=500000)
+        p.add_argument('--bound', type=int, default=1000, help='max |offset| after lock, ns')
+        p.add_argument('--timeout', type=int, default=120, help='host program time limit, s')
+        if name != 'ctest':
+            p.add_argument('--two-step', action='store_true')
+    p = sub.choices['synth']
+    p.add_argument('--transport', choices=('l2', 'udp'), default='l2')
+    p.add_argument('--rate', type=int, default=1, help='Sync per Delay_Req')
+    p.add_argument('--ppm', type=float, default=30.0, help='slave frequency error')
+    p.add_argument('--wander', type=float, default=2.0, help='frequency random walk per sample, ppb')
+    p.add_argument('--delay', type=float, default=5000.0, help='mean path delay, ns')
+    p.add_argument('--jitter', type=float, default=200.0, help='path delay jitter sigma, ns')
+    p.add_argument('--tick', type=int, default=10, help='timestamp resolution, ns')
+    p.add_argument('--interval', type=float, default=1.0, help='sync interval, s')
+    p.add_argument('--initial', type=int, default=3 * NS_PER_SEC, help='initial offset, ns')
+    p.add_argument('--loss', type=float, default=0.0, help='probability of each loss event per sync')
+    p.add_argument('--count', type=int, default=300)
+    p.add_argument('--seed', type=int, default=1)
+    p.add_argument('--csv', help='write per-sample rows')
+    p = sub.choices['ctest']
+    p.add_argument('--cases', type=int, default=40)
+    p.add_argument('--count', type=int, default=200, help='sync intervals per case')
+    p.add_argument('--lock-by', type=int, default=64, help='samples allowed before lock')
+    p.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    if args.cmd is None:
+        ap.print_help()
+        return 2
+    return {'synth': cmd_synth, 'replay': cmd_replay, 'ctest': cmd_ctest}[args.cmd](args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
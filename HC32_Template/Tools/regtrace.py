@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+寄存器访问记录的统计与对比, 记录由 User/BSP/reg_trace.c 的 REGTRACE_Dump 输出.
+
+    regtrace.py summary trace.txt
+        按外设、按驱动函数、按标记段统计读写次数
+    regtrace.py diff old.txt new.txt [--values]
+        按标记名配对, 逐段对比访问序列(操作、宽度、外设+偏移), --values 时连值一起比较;
+        有差异时输出差异并返回 1, 可直接放进回归脚本
+
+外设名取自器件头文件中的 CM_xxx_BASE 定义, 默认 ../User/hc32f4a0sitb.h, 可用 --header 指定.
+经 bCM_xxx 位带别名的访问(如 WRITE_REG32(bCM_DVP->CTR_b.CROPEN, ...))折算回外设寄存器, 记为 外设+偏移.位号.
+不在任何外设地址范围内的访问(如对局部变量使用 CLR_REG32_BIT)不参与统计和对比.
+本工具和跟踪构建的检查见 regtrace_test.py.
+"""
+
+import argparse
+import bisect
+import collections
+import difflib
+import os
+import re
+import sys
+
+PERIPH_SPAN = 0x400
+PERIPH_BASE = 0x40000000
+BITBAND_BASE = 0x42000000       # 位带别名: 每个字对应 PERIPH_BASE 起的一位
+BITBAND_SPAN = 0x02000000
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'User', 'hc32f4a0sitb.h')
+
+
+class PeriphMap:
+    def __init__(self, header):
+        bases = {}
+        with open(header, encoding='utf-8', errors='replace') as f:
+            for m in re.finditer(r'#define\s+CM_(\w+)_BASE\s+\(0x([0-9A-Fa-f]+)UL\)', f.read()):
+                bases.setdefault(int(m.group(2), 16), m.group(1))
+        self.addrs = sorted(bases)
+        self.names = [bases[a] for a in self.addrs]
+
+    def lookup(self, addr):
+        """返回 (外设名, 偏移, 位号), 位号只对位带别名访问有效, 否则为 None"""
+        bit = None
+        if BITBAND_BASE <= addr < BITBAND_BASE + BITBAND_SPAN:
+            bit = (addr >> 2) & 31
+            addr = PERIPH_BASE + (((addr - BITBAND_BASE) >> 5) & ~3)
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        base = self.addrs[i]
+        limit = self.addrs[i + 1] if i + 1 < len(self.addrs) else base + PERIPH_SPAN
+        if addr - base >= max(PERIPH_SPAN, min(limit - base, 0x10000)):
+            return None
+        return self.names[i], addr - base, bit
+
+
+Access = collections.namedtuple('Access', 'op size addr value func periph offset bit')
+
+
+def load(path, pmap):
+    """返回 [(标记, [Access...]), ...] 和丢弃数, 第一个标记之前的访问归入 '<start>'"""
+    segs = [('<start>', [])]
+    lost = 0
+    with open(path, encoding='utf-8', errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line.startswith('# regtrace'):
+                parts = line.split()
+                if len(parts) >= 4:
+                    lost = int(parts[3], 16)
+                continue
+            if line.startswith('#'):
+                continue
+            if line.startswith('@ '):
+                segs.append((line[2:], []))
+                continue
+            m = re.match(r'([RW])([124])\s+([0-9A-Fa-f]{8})\s+([0-9A-Fa-f]{8})\s*(.*)$', line)
+            if not m:
+                continue
+            addr = int(m.group(3), 16)
+            hit = pmap.lookup(addr)
+            if hit is None:
+                continue
+            segs[-1][1].append(Access(m.group(1), int(m.group(2)), addr, int(m.group(4), 16),
+                                      m.group(5) or '?', hit[0], hit[1], hit[2]))
+    if not segs[0][1]:
+        segs.pop(0)
+    return segs, lost
+
+
+def fmt(a, values):
+    s = '%s%d %s+0x%03X' % (a.op, a.size, a.periph, a.offset)
+    if a.bit is not None:
+        s += '.%d' % a.bit
+    if values:
+        s += ' =0x%08X' % a.value
+    return s + '  (' + a.func + ')'
+
+
+def count_table(title, counter):
+    print(title)
+    print('  %-32s %8s %8s %8s' % ('', 'read', 'write', 'total'))
+    for key, (r, w) in sorted(counter.items(), key=lambda kv: -(kv[1][0] + kv[1][1])):
+        print('  %-32s %8d %8d %8d' % (key, r, w, r + w))
+    print()
+
+
+def summary(args, pmap):
+    segs, lost = load(args.trace, pmap)
+    by_periph = collections.defaultdict(lambda: [0, 0])
+    by_func = collections.defaultdict(lambda: [0, 0])
+    by_seg = collections.defaultdict(lambda: [0, 0])
+    for tag, accs in segs:
+        for a in accs:
+            k = 0 if a.op == 'R' else 1
+            by_periph[a.periph][k] += 1
+            by_func[a.func][k] += 1
+            by_seg[tag][k] += 1
+    if lost:
+        print('warning: %d accesses were dropped on target, counts are incomplete\n' % lost)
+    count_table('per peripheral', by_periph)
+    count_table('per function', by_func)
+    count_table('per mark', by_seg)
+    return 0
+
+
+def group(segs):
+    """同名标记可能出现多次, 按出现顺序编号后配对"""
+    seen = collections.Counter()
+    out = collections.OrderedDict()
+    for tag, accs in segs:
+        seen[tag] += 1
+        out[tag if seen[tag] == 1 else '%s#%d' % (tag, seen[tag])] = accs
+    return out
+
+
+def diff(args, pmap):
+    old_segs, old_lost = load(args.old, pmap)
+    new_segs, new_lost = load(args.new, pmap)
+    if old_lost or new_lost:
+        print('warning: dropped accesses old=%d new=%d, diff may be incomplete' % (old_lost, new_lost))
+    old = group(old_segs)
+    new = group(new_segs)
+    changed = 0
+    for tag in list(old) + [t for t in new if t not in old]:
+        a = [fmt(x, args.values) for x in old.get(tag, [])]
+        b = [fmt(x, args.values) for x in new.get(tag, [])]
+        if tag not in new or tag not in old:
+            print('@ %s: only in %s (%d accesses)' % (tag, 'old' if tag in old else 'new', len(a) or len(b)))
+            changed += 1
+            continue
+        if a == b:
+            continue
+        changed += 1
+        ra = sum(1 for x in old[tag] if x.op == 'R')
+        rb = sum(1 for x in new[tag] if x.op == 'R')
+        print('@ %s: reads %d -> %d, writes %d -> %d' % (tag, ra, rb, len(a) - ra, len(b) - rb))
+        for line in difflib.unified_diff(a, b, 'old', 'new', lineterm='', n=2):
+            if not line.startswith(('---', '+++')):
+                print('    ' + line)
+        print()
+    if changed:
+        print('%d mark(s) differ' % changed)
+        return 1
+    print('register traffic identical (%d marks)' % len(old))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description='register access trace summary / diff')
+    ap.add_argument('--header', default=DEFAULT_HEADER, help='device header with CM_xxx_BASE defines')
+    sub = ap.add_subparsers(dest='cmd')
+    p = sub.add_parser('summary')
+    p.add_argument('trace')
+    p = sub.add_parser('diff')
+    p.add_argument('old')
+    p.add_argument('new')
+    p.add_argument('--values', action='store_true', help='compare written/read values too')
+    args = ap.parse_args()
+    if args.cmd is None:
+        ap.print_help()
+        return 2
+    pmap = PeriphMap(args.header)
+    return summary(args, pmap) if args.cmd == 'summary' else diff(args, pmap)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
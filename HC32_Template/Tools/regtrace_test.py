@@ -0,0 +1,548 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+寄存器跟踪构建和 regtrace.py 的主机检查: 用主机编译器按 LL_REG_TRACE 编译 User/BSP/reg_trace.c 和
+Library 中的 hc32_ll_fcg.c、hc32_ll_gpio.c、hc32_ll_dma.c、hc32_ll_tmr0.c、hc32_ll_dvp.c,
+REGTRACE_Read/REGTRACE_Write 中的寄存器访问换成主机上的寄存器表(其余为原样代码):
+外设地址 0x40000000~0x40FFFFFF 按字存放, 位带别名 0x42000000~0x43FFFFFF 读写对应字中的一位,
+其他地址(局部变量)照常访问内存. 驱动按固定顺序调用一组 DDL 函数并在每组前 REGTRACE_Mark.
+
+    regtrace_test.py [--cc gcc] [--update]
+        检查项:
+          1. REGTRACE_Dump 输出的每一行与寄存器表实际收到的访问(操作、宽度、地址、值、__func__)
+             逐条一致, 首行条数正确; 记录中调用 REGTRACE_Dump 时输出函数本身的寄存器访问不进记录,
+             之后继续记录; REGTRACE_Stop 之后的访问和标记不进记录;
+          2. 超过 REGTRACE_DEPTH 条时保留前 REGTRACE_DEPTH 条, 首行丢弃数等于多出的访问数;
+          3. 经位带别名的写(DVP_CropCmd)落到寄存器表中 DVP CTR 的 CROPEN 位;
+          4. 输出与 Tools/regtrace_ref.txt 用 regtrace.py diff --values 比较无差异;
+             改了 DDL 函数的寄存器访问时对比会失败, 确认改动符合预期后用 --update 更新参考记录;
+          5. regtrace.py: summary 的按标记计数与记录一致; diff 不带 --values 忽略值、带 --values 时报告
+             改过的值; 少一条访问或改名的标记返回 1 并指出标记; 同名标记按出现顺序配对;
+             外设地址范围外的访问不参与对比; 有丢弃数时给出警告.
+    全部通过返回 0, 否则打印差异并返回 1. 修改 reg_trace.c、regtrace.py 或 hc32_ll_def.h 的跟踪宏后运行一次.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+TRACE_C = os.path.join(ROOT, 'User', 'BSP', 'reg_trace.c')
+LIBS = ['hc32_ll_fcg.c', 'hc32_ll_gpio.c', 'hc32_ll_dma.c', 'hc32_ll_tmr0.c', 'hc32_ll_dvp.c']
+TOOL = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regtrace.py')
+REFERENCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regtrace_ref.txt')
+MAX_REPORT = 20
+
+# 在 hc32_ll.h 之后强制包含: 关中断换成空操作, 寄存器访问接到寄存器表
+REGS = r'''
+#ifndef __HOST_REGS_H__
+#define __HOST_REGS_H__
+uint32_t HOST_RegRead(const volatile void *pvAddr, uint32_t u32Size, const char *pcFunc);
+void HOST_RegWrite(volatile void *pvAddr, uint32_t u32Size, uint32_t u32Val, const char *pcFunc);
+#define __get_PRIMASK()         (0UL)
+#define __set_PRIMASK(x)        ((void)(x))
+#define __disable_irq()         ((void)0)
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "reg_trace.h"
+
+#define PERIPH_LO       (0x40000000UL)
+#define PERIPH_HI       (0x41000000UL)
+#define BITBAND_LO      (0x42000000UL)
+#define BITBAND_HI      (0x44000000UL)
+#define REG_SLOTS       (4096U)
+#define SHADOW_MAX      (4096U)
+
+typedef struct {
+    uint32_t u32Addr;
+    uint32_t u32Val;
+} stc_host_reg_t;
+
+/* 寄存器表: 按字地址的开放寻址表, 未写过的寄存器读为 0 */
+static stc_host_reg_t m_astcReg[REG_SLOTS];
+static uint32_t m_u32Regs;
+
+/* 期望的记录: 驱动自己登记的标记和寄存器表收到的访问 */
+static char m_aacShadow[SHADOW_MAX][96];
+static uint32_t m_u32Shadow;
+static uint32_t m_u32ShadowLost;
+static int m_iRecord;
+static int m_iInDump;
+static uint32_t m_u32Line;
+static uint32_t m_u32DumpFails;
+static int m_iFails;
+static FILE *m_pOut;
+
+static void Fail(const char *pcMsg, unsigned long a, unsigned long b) {
+    if (m_iFails++ < 20) {
+        printf("fail: %s (%lu, %lu)\n", pcMsg, a, b);
+    }
+}
+
+static uint32_t *Slot(uint32_t u32Addr) {
+    uint32_t i = (u32Addr >> 2) % REG_SLOTS;
+
+    while (m_astcReg[i].u32Addr != 0UL && m_astcReg[i].u32Addr != u32Addr) {
+        i = (i + 1U) % REG_SLOTS;
+    }
+    if (m_astcReg[i].u32Addr == 0UL) {
+        if (++m_u32Regs >= REG_SLOTS) {
+            printf("fail: 寄存器表满\n");
+            exit(2);
+        }
+        m_astcReg[i].u32Addr = u32Addr;
+    }
+    return &m_astcReg[i].u32Val;
+}
+
+static uint32_t RegGet(uint32_t u32Addr) {
+    return *Slot(u32Addr);
+}
+
+static void RegSet(uint32_t u32Addr, uint32_t u32Val) {
+    *Slot(u32Addr) = u32Val;
+}
+
+static void Shadow(const char *pcLine) {
+    if (!m_iRecord || m_iInDump) {
+        return;
+    }
+    if (m_u32Shadow < REGTRACE_DEPTH) {
+        strcpy(m_aacShadow[m_u32Shadow++], pcLine);
+    } else {
+        m_u32ShadowLost++;
+    }
+}
+
+static void ShadowAccess(char cOp, uint32_t u32Size, uint32_t u32Addr, uint32_t u32Val, const char *pcFunc) {
+    char acLine[96];
+
+    snprintf(acLine, sizeof(acLine), "%c%u %08X %08X %s", cOp, (unsigned)u32Size, (unsigned)u32Addr,
+             (unsigned)u32Val, pcFunc);
+    Shadow(acLine);
+}
+
+static uint32_t Access(uintptr_t uAddr, uint32_t u32Size, int iWrite, uint32_t u32Val) {
+    uint32_t u32Mask = (4UL == u32Size) ? 0xFFFFFFFFUL : ((1UL << (8U * u32Size)) - 1UL);
+    uint32_t u32Word, u32Shift, u32Bit;
+
+    if (uAddr >= BITBAND_LO && uAddr < BITBAND_HI) {
+        /* 位带别名: 每个字对应外设区一位 */
+        u32Word = PERIPH_LO + ((((uint32_t)uAddr - BITBAND_LO) >> 5) & ~3UL);
+        u32Bit = (((uint32_t)uAddr - BITBAND_LO) >> 2) & 31U;
+        if (iWrite) {
+            RegSet(u32Word, (RegGet(u32Word) & ~(1UL << u32Bit)) | ((u32Val & 1UL) << u32Bit));
+            return u32Val & 1UL;
+        }
+        return (RegGet(u32Word) >> u32Bit) & 1UL;
+    }
+    if (uAddr >= PERIPH_LO && uAddr < PERIPH_HI) {
+        if ((uAddr & (u32Size - 1U)) != 0U) {
+            Fail("寄存器访问未对齐", (unsigned long)uAddr, u32Size);
+        }
+        u32Word = (uint32_t)uAddr & ~3UL;
+        u32Shift = 8U * ((uint32_t)uAddr & 3U);
+        if (iWrite) {
+            RegSet(u32Word, (RegGet(u32Word) & ~(u32Mask << u32Shift)) | ((u32Val & u32Mask) << u32Shift));
+            return u32Val & u32Mask;
+        }
+        return (RegGet(u32Word) >> u32Shift) & u32Mask;
+    }
+    /* 局部变量等普通内存 */
+    if (iWrite) {
+        if (1U == u32Size) *(volatile uint8_t *)uAddr = (uint8_t)u32Val;
+        else if (2U == u32Size) *(volatile uint16_t *)uAddr = (uint16_t)u32Val;
+        else *(volatile uint32_t *)uAddr = u32Val;
+        return u32Val & u32Mask;
+    }
+    if (1U == u32Size) return *(volatile uint8_t *)uAddr;
+    if (2U == u32Size) return *(volatile uint16_t *)uAddr;
+    return *(volatile uint32_t *)uAddr;
+}
+
+uint32_t HOST_RegRead(const volatile void *pvAddr, uint32_t u32Size, const char *pcFunc) {
+    uint32_t u32Val = Access((uintptr_t)pvAddr, u32Size, 0, 0UL);
+
+    ShadowAccess('R', u32Size, (uint32_t)(uintptr_t)pvAddr, u32Val, pcFunc);
+    return u32Val;
+}
+
+void HOST_RegWrite(volatile void *pvAddr, uint32_t u32Size, uint32_t u32Val, const char *pcFunc) {
+    u32Val = Access((uintptr_t)pvAddr, u32Size, 1, u32Val);
+    ShadowAccess('W', u32Size, (uint32_t)(uintptr_t)pvAddr, u32Val, pcFunc);
+}
+
+static void Start(void) {
+    REGTRACE_Start();
+    m_u32Shadow = 0U;
+    m_u32ShadowLost = 0U;
+    m_iRecord = 1;
+}
+
+static void Stop(void) {
+    REGTRACE_Stop();
+    m_iRecord = 0;
+}
+
+static void Mark(const char *pcTag) {
+    char acLine[96];
+
+    REGTRACE_Mark(pcTag);
+    snprintf(acLine, sizeof(acLine), "@ %s", pcTag);
+    Shadow(acLine);
+}
+
+/* 逐行与期望比对; 输出函数自己也访问寄存器, 这些访问不应进入记录 */
+static void Out(const char *pcLine) {
+    char acHead[64];
+
+    m_iInDump = 1;
+    WRITE_REG32(CM_USART1->DR, (uint32_t)(uint8_t)pcLine[0]);
+    m_iInDump = 0;
+
+    if (m_pOut != NULL) {
+        fprintf(m_pOut, "%s\n", pcLine);
+    }
+    if (0U == m_u32Line) {
+        snprintf(acHead, sizeof(acHead), "# regtrace %08X %08X", (unsigned)m_u32Shadow, (unsigned)m_u32ShadowLost);
+        if (strcmp(pcLine, acHead) != 0 && m_u32DumpFails++ < 4U) {
+            printf("fail: 首行 '%s', 应为 '%s'\n", pcLine, acHead);
+            m_iFails++;
+        }
+    } else if (m_u32Line > m_u32Shadow) {
+        if (m_u32DumpFails++ < 4U) {
+            printf("fail: 多出的记录 '%s'\n", pcLine);
+            m_iFails++;
+        }
+    } else if (strcmp(pcLine, m_aacShadow[m_u32Line - 1U]) != 0 && m_u32DumpFails++ < 4U) {
+        printf("fail: 第 %u 条记录 '%s', 应为 '%s'\n", (unsigned)m_u32Line, pcLine, m_aacShadow[m_u32Line - 1U]);
+        m_iFails++;
+    }
+    m_u32Line++;
+}
+
+static void Dump(FILE *pOut) {
+    m_pOut = pOut;
+    m_u32Line = 0U;
+    m_u32DumpFails = 0U;
+    REGTRACE_Dump(&Out);
+    if (m_u32Line != m_u32Shadow + 1U) {
+        Fail("输出行数与记录数不符", m_u32Line, m_u32Shadow + 1U);
+    }
+    m_pOut = NULL;
+}
+
+static void Sequence(void) {
+    stc_gpio_init_t stcGpio;
+    stc_dma_init_t stcDma;
+    stc_dma_llp_init_t stcLlp;
+    stc_tmr0_init_t stcTmr0;
+    stc_dvp_crop_window_config_t stcCrop;
+
+    Mark("fcg");
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DMA2, ENABLE);
+    FCG_Fcg2PeriphClockCmd(FCG2_PERIPH_TMR0_1, ENABLE);
+    FCG_Fcg3PeriphClockCmd(FCG3_PERIPH_DVP, ENABLE);
+
+    Mark("gpio_init");
+    GPIO_REG_Unlock();
+    (void)GPIO_StructInit(&stcGpio);
+    stcGpio.u16PinAttr = PIN_ATTR_ANALOG;
+    (void)GPIO_Init(GPIO_PORT_A, GPIO_PIN_04 | GPIO_PIN_05, &stcGpio);
+    GPIO_SetFunc(GPIO_PORT_H, GPIO_PIN_08, GPIO_FUNC_13);
+    GPIO_REG_Lock();
+
+    Mark("gpio_io");
+    GPIO_SetPins(GPIO_PORT_B, GPIO_PIN_00);
+    (void)GPIO_ReadInputPins(GPIO_PORT_B, GPIO_PIN_01);
+    GPIO_TogglePins(GPIO_PORT_B, GPIO_PIN_00);
+
+    Mark("dma_init");
+    DMA_Cmd(CM_DMA2, ENABLE);
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = DMA_INT_ENABLE;
+    stcDma.u32SrcAddr = (uint32_t)&CM_DVP->DMR;
+    stcDma.u32DestAddr = 0x20000000UL;
+    stcDma.u32DataWidth = DMA_DATAWIDTH_32BIT;
+    stcDma.u32BlockSize = 1UL;
+    stcDma.u32TransCount = 320UL;
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_INC;
+    (void)DMA_Init(CM_DMA2, DMA_CH1, &stcDma);
+    (void)DMA_LlpStructInit(&stcLlp);
+    stcLlp.u32State = DMA_LLP_ENABLE;
+    stcLlp.u32Mode = DMA_LLP_WAIT;
+    stcLlp.u32Addr = 0x20000100UL;
+    (void)DMA_LlpInit(CM_DMA2, DMA_CH1, &stcLlp);
+
+    Mark("dma_start");
+    DMA_TransCompleteIntCmd(CM_DMA2, DMA_INT_TC_CH0 << DMA_CH1, ENABLE);
+    (void)DMA_ChCmd(CM_DMA2, DMA_CH1, ENABLE);
+    (void)DMA_GetTransCount(CM_DMA2, DMA_CH1);
+
+    Mark("tmr0");
+    (void)TMR0_StructInit(&stcTmr0);
+    stcTmr0.u32ClockSrc = TMR0_CLK_SRC_INTERN_CLK;
+    stcTmr0.u32ClockDiv = TMR0_CLK_DIV8;
+    stcTmr0.u32Func = TMR0_FUNC_CMP;
+    stcTmr0.u16CompareValue = 999U;
+    (void)TMR0_Init(CM_TMR0_1, TMR0_CH_A, &stcTmr0);
+    TMR0_SetCompareValue(CM_TMR0_1, TMR0_CH_A, 499U);
+    TMR0_Start(CM_TMR0_1, TMR0_CH_A);
+    TMR0_Stop(CM_TMR0_1, TMR0_CH_A);
+
+    Mark("dvp_crop");
+    stcCrop.u16RowStartLine = 8U;
+    stcCrop.u16ColoumStartLine = 16U;
+    stcCrop.u16RowLineSize = 240U;
+    stcCrop.u16ColoumLineSize = 640U;
+    (void)DVP_CropWindowConfig(&stcCrop);
+    DVP_CropCmd(ENABLE);
+
+    Mark("gpio_io");
+    GPIO_SetPins(GPIO_PORT_B, GPIO_PIN_00);
+    (void)GPIO_ReadInputPins(GPIO_PORT_B, GPIO_PIN_01);
+    GPIO_TogglePins(GPIO_PORT_B, GPIO_PIN_00);
+}
+
+int main(int argc, char **argv) {
+    FILE *pOut;
+    uint32_t i, u32Before;
+
+    if (argc < 2 || (pOut = fopen(argv[1], "w")) == NULL) {
+        printf("usage: driver dump.txt\n");
+        return 2;
+    }
+
+    /* 复位值(外设时钟全关)和输入、监视寄存器的初值, 让读到的值不全为 0 */
+    (void)Access((uintptr_t)&CM_PWC->FCG0, 4U, 1, 0xFFFFFFFFUL);
+    (void)Access((uintptr_t)&CM_PWC->FCG2, 4U, 1, 0xFFFFFFFFUL);
+    (void)Access((uintptr_t)&CM_PWC->FCG3, 4U, 1, 0xFFFFFFFFUL);
+    (void)Access((uintptr_t)&CM_GPIO->PIDRB, 2U, 1, 0x0002UL);
+    (void)Access((uintptr_t)&CM_DMA2->MONDTCTL1, 4U, 1, (320UL << DMA_DTCTL_CNT_POS) | 1UL);
+
+    /* 1. 开始记录前的访问不进记录, 记录中途 Dump 之后继续记录 */
+    GPIO_SetPins(GPIO_PORT_C, GPIO_PIN_03);
+    Start();
+    Sequence();
+    Dump(NULL);
+    Mark("after_dump");
+    GPIO_ResetPins(GPIO_PORT_C, GPIO_PIN_03);
+    Stop();
+    GPIO_SetPins(GPIO_PORT_C, GPIO_PIN_03);
+    REGTRACE_Mark("stopped");
+    Dump(pOut);
+    fclose(pOut);
+    printf("records=%u\n", (unsigned)m_u32Shadow);
+
+    if (0UL == (RegGet((uint32_t)(uintptr_t)&CM_DVP->CTR) & DVP_CTR_CROPEN)) {
+        Fail("位带写 CROPEN 没有落到 DVP CTR", RegGet((uint32_t)(uintptr_t)&CM_DVP->CTR), DVP_CTR_CROPEN);
+    }
+
+    /* 2. 写满后丢弃新记录并计数 */
+    Start();
+    for (i = 0U; m_u32Shadow + m_u32ShadowLost < REGTRACE_DEPTH + 37U; i++) {
+        u32Before = m_u32Shadow + m_u32ShadowLost;
+        GPIO_SetPins(GPIO_PORT_D, (uint16_t)(1U << (i & 15U)));
+        if (m_u32Shadow + m_u32ShadowLost == u32Before) {
+            Fail("GPIO_SetPins 没有经过跟踪宏", i, 0);
+            break;
+        }
+    }
+    Stop();
+    Dump(NULL);
+    printf("overflow_lost=%u\n", (unsigned)m_u32ShadowLost);
+    if (m_u32Shadow != REGTRACE_DEPTH || 0U == m_u32ShadowLost) {
+        Fail("溢出测试没有写满记录表", m_u32Shadow, m_u32ShadowLost);
+    }
+
+    return m_iFails ? 1 : 0;
+}
+'''
+
+
+def build(args, tmp):
+    with open(TRACE_C, encoding='utf-8') as f:
+        trace = f.read()
+    trace, n1 = re.subn(r'\*\(const volatile uint(8|16|32)_t \*\)pvAddr',
+                        r'HOST_RegRead(pvAddr, \1U / 8U, pcFunc)', trace)
+    trace, n2 = re.subn(r'\*\(volatile uint(8|16|32)_t \*\)pvAddr = ([^;]+);',
+                        r'HOST_RegWrite(pvAddr, \1U / 8U, \2, pcFunc);', trace)
+    if n1 != 3 or n2 != 3:
+        print('reg_trace.c 中找不到 REGTRACE_Read/REGTRACE_Write 的寄存器访问 (%d, %d)' % (n1, n2))
+        return None
+    files = {'reg_trace.c': trace, 'host_regs.h': REGS, 'driver.c': DRIVER}
+    for name, text in files.items():
+        with open(os.path.join(tmp, name), 'w', encoding='utf-8') as f:
+            f.write(text)
+    exe = os.path.join(tmp, 'regtrace_test')
+    inc = []
+    for d in ('User', 'User/BSP', 'Boot', 'Library'):
+        inc += ['-I', os.path.join(ROOT, d)]
+    cmd = [args.cc, '-std=gnu99', '-O1', '-w', '-DHC32F4A0', '-DUSE_DDL_DRIVER', '-DLL_REG_TRACE',
+           '-fsanitize=address,undefined', '-fno-sanitize-recover=undefined', '-no-pie', '-fno-pie'] + inc + \
+          ['-include', 'hc32_ll.h', '-include', os.path.join(tmp, 'host_regs.h')] + \
+          [os.path.join(tmp, 'reg_trace.c'), os.path.join(tmp, 'driver.c')] + \
+          [os.path.join(ROOT, 'Library', n) for n in LIBS] + ['-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def tool(*argv):
+    r = subprocess.run([sys.executable, TOOL] + list(argv), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                       universal_newlines=True)
+    return r.returncode, r.stdout
+
+
+def write(path, lines):
+    with open(path, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+def check_tool(dump, tmp):
+    """对真实记录做改动, 检查 regtrace.py 的统计和对比"""
+    fails = []
+    with open(dump, encoding='utf-8') as f:
+        lines = f.read().splitlines()
+    accesses = [i for i, s in enumerate(lines) if s[:1] in 'RW']
+    marks = [s[2:] for s in lines if s.startswith('@ ')]
+
+    # summary: 按标记计数
+    rc, out = tool('summary', dump)
+    per_mark = {}
+    section = None
+    for s in out.splitlines():
+        if not s.startswith(' '):
+            section = s.strip()
+            continue
+        parts = s.split()
+        if section == 'per mark' and len(parts) == 4 and parts[1].isdigit():
+            per_mark[parts[0]] = int(parts[3])
+    expect = {}
+    seg = None
+    for s in lines:
+        if s.startswith('@ '):
+            seg = s[2:]
+        elif s[:1] in 'RW':
+            expect[seg] = expect.get(seg, 0) + 1
+    if rc != 0 or per_mark != expect:
+        fails.append('summary 按标记计数 %s, 应为 %s' % (per_mark, expect))
+
+    # diff: 与自身一致
+    rc, out = tool('diff', dump, dump, '--values')
+    if rc != 0:
+        fails.append('同一份记录 diff 返回 %d' % rc)
+
+    # 改一个写入值: 不带 --values 不报, 带 --values 报
+    mod = list(lines)
+    w = next(i for i in accesses if lines[i].startswith('W4'))
+    f = mod[w].split(' ', 3)
+    f[2] = '%08X' % (int(f[2], 16) ^ 0x100)
+    mod[w] = ' '.join(f)
+    path = os.path.join(tmp, 'value.txt')
+    write(path, mod)
+    rc, _ = tool('diff', dump, path)
+    if rc != 0:
+        fails.append('只改值时不带 --values 的 diff 返回 %d' % rc)
+    rc, out = tool('diff', dump, path, '--values')
+    if rc != 1 or '=0x%s' % f[2] not in out:
+        fails.append('带 --values 时没有报告改过的值: %s' % out.strip()[-200:])
+
+    # 少一条访问: 指出所在标记和读写计数
+    drop = accesses[len(accesses) // 2]
+    seg = [s[2:] for s in lines[:drop] if s.startswith('@ ')][-1]
+    path = os.path.join(tmp, 'drop.txt')
+    write(path, lines[:drop] + lines[drop + 1:])
+    rc, out = tool('diff', dump, path)
+    if rc != 1 or ('@ %s:' % seg) not in out or '1 mark(s) differ' not in out:
+        fails.append('少一条访问时 diff 没有指出标记 %s: %s' % (seg, out.strip()[-200:]))
+
+    # 同名标记按出现顺序配对: 只改第二个 gpio_io 段
+    dup = [i for i, s in enumerate(lines) if s == '@ gpio_io']
+    if len(dup) != 2:
+        fails.append('参考序列中应有两个 gpio_io 标记, 实际 %d 个' % len(dup))
+    else:
+        path = os.path.join(tmp, 'dup.txt')
+        write(path, lines[:dup[1] + 1] + lines[dup[1] + 2:])
+        rc, out = tool('diff', dump, path)
+        if rc != 1 or '@ gpio_io#2:' not in out or '@ gpio_io:' in out:
+            fails.append('同名标记没有按顺序配对: %s' % out.strip()[-200:])
+
+    # 改名的标记: 两边各报一次
+    path = os.path.join(tmp, 'rename.txt')
+    write(path, [('@ tmr0_renamed' if s == '@ tmr0' else s) for s in lines])
+    rc, out = tool('diff', dump, path)
+    if rc != 1 or '@ tmr0: only in old' not in out or '@ tmr0_renamed: only in new' not in out:
+        fails.append('改名的标记没有报告: %s' % out.strip()[-200:])
+
+    # 外设范围外的访问不参与对比; 丢弃数给出警告
+    path = os.path.join(tmp, 'stack.txt')
+    head = lines[0].split()
+    write(path, ['# regtrace %s 00000003' % head[2]] + lines[1:dup[0] + 1] +
+          ['W4 2001FFF0 00000001 DMA_Init'] + lines[dup[0] + 1:])
+    rc, out = tool('diff', dump, path)
+    if rc != 0 or 'warning: dropped accesses old=0 new=3' not in out:
+        fails.append('外设范围外的访问或丢弃数处理不对: %s' % out.strip()[-200:])
+    rc, out = tool('summary', path)
+    if 'warning: 3 accesses were dropped' not in out:
+        fails.append('summary 没有给出丢弃警告')
+
+    if not marks:
+        fails.append('记录中没有标记')
+    return fails
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--update', action='store_true', help='用本次输出更新 Tools/regtrace_ref.txt')
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args, tmp)
+        if exe is None:
+            return 1
+        dump = os.path.join(tmp, 'trace.txt')
+        env = dict(os.environ, ASAN_OPTIONS='detect_leaks=0')
+        r = subprocess.run([exe, dump], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True,
+                           env=env)
+        fails = [s[6:] for s in r.stdout.splitlines() if s.startswith('fail: ')]
+        res = dict(s.split('=', 1) for s in r.stdout.splitlines() if '=' in s and not s.startswith('fail: '))
+        if r.returncode not in (0, 1):
+            fails.append('驱动异常退出: 返回 %d %s' % (r.returncode, r.stdout.strip()[-400:]))
+        if r.returncode == 0 and not fails:
+            fails += check_tool(dump, tmp)
+            if args.update:
+                shutil.copyfile(dump, REFERENCE)
+                print('已更新 %s' % os.path.relpath(REFERENCE, ROOT))
+            else:
+                rc, out = tool('diff', REFERENCE, dump, '--values')
+                if rc != 0:
+                    print(out.rstrip())
+                    fails.append('与 Tools/regtrace_ref.txt 不一致, 确认 DDL 改动符合预期后用 --update 更新')
+        for msg in fails[:MAX_REPORT]:
+            print(msg)
+        print('寄存器跟踪: %s 条记录, 溢出丢弃 %s 条, 差异 %d 项' % (res.get('records', '?'),
+                                                         res.get('overflow_lost', '?'), len(fails)))
+        return 1 if fails else 0
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
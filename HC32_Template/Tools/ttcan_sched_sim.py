@@ -0,0 +1,1078 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+TTCAN 调度的主机仿真: User/BSP/can_ttc_sched.c 不带任何桩直接编译, can_ttc.c 接到寄存器级的
+TTC 模型上编译.
+
+    ttcan_sched_sim.py frame [--cc gcc] [--seed 1] [--frames 300]
+        逐位展开帧(SOF~帧间隔, 经典帧含 CRC15 和动态填充, FD 帧含动态填充、填充计数和固定填充位,
+        BRS 时数据段按波特率之比折算), 对标准/扩展、经典/FD/FD+BRS、全部 DLC、NTU 为 1/2/4/8 位、
+        波特率之比 1~8, 用随机数据和逐位贪心构造的最坏填充数据求出实际最长占用时间,
+        TTCAN_FrameNtu 不得小于它, 同时报告上界比实际最坏多出的位数.
+    ttcan_sched_sim.py check [--cc gcc] [--seed 1] [--matrices 3000]
+        随机矩阵(含各类参数错误)交给 TTCAN_SchedCheck:
+          1. 参数错误的返回值和出错时隙与 Python 按头文件注释实现的规则一致;
+          2. 检查通过的矩阵在总线回放中不出问题: 每个周期按实际帧长(最坏填充)排队发送,
+             独占窗口在发送使能窗口内任意时刻(含窗口末端)开始, 合并窗口内的帧按 ID 仲裁、
+             结束触发前开始的帧发完, 任何触发时刻总线上不能还有前一个窗口的帧, 周期末总线须空闲;
+          3. 检查判为重叠的矩阵, 统计最坏情况回放其实放得下的个数(上界的保守程度), 不算错误.
+    ttcan_sched_sim.py engine [--cc gcc] [--seed 1] [--cycles 4000]
+        can_ttc.c 接到 TTC 模型: 模型实现 TBSLOT 选缓冲区/置满、TRG_CFG/TT_TRIG 装载触发器、
+        触发时刻发送缓冲区内的帧并置 TTIF、看门触发置 WTIF, 在中断上下文调用 TTCAN_IrqHandler,
+        参考报文处调用 TTCAN_CycleStart, 触发之间在线程上下文随机调用 TTCAN_UpdateMsg.
+        场景: 正常、参考报文丢失和周期计数跳变、单周期矩阵、含空周期的矩阵、只有接收时隙的矩阵.
+        检查项:
+          1. 每个收到参考报文的周期, 触发序列(时间、类型、发送使能窗口)与矩阵中该周期的时隙完全一致,
+             参考报文丢失的周期没有触发, 周期结束时没有已装载的触发;
+          2. 发送触发使用的缓冲区已填满, 发出的帧 ID 是该时隙的报文, 写入缓冲区时数据是该报文的
+             最新版本, 写入与发出之间不超过 TTCAN_FILL_AHEAD 个发送时隙;
+          3. 合并窗口结束触发指向最近一个发送触发的缓冲区; 不装载过去的触发, 不覆盖未到达的触发;
+          4. 统计计数与模型一致, 无故障场景只在首个周期对齐一次.
+    ttcan_sched_sim.py [all] 依次运行以上三项.
+    全部通过返回 0, 否则打印前若干处错误并返回 1. 修改 can_ttc_sched.c 或 can_ttc.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+BSP = os.path.join(ROOT, 'User', 'BSP')
+SCHED = os.path.join(BSP, 'can_ttc_sched.c')
+ENGINE = os.path.join(BSP, 'can_ttc.c')
+LL_DEF = os.path.join(ROOT, 'Library', 'hc32_ll_def.h')
+LL_CAN = os.path.join(ROOT, 'Library', 'hc32_ll_can.h')
+DEVICE = os.path.join(ROOT, 'Boot', 'hc32f4a0sitb.h')
+MAX_REPORT = 20
+MSG_MAX = 16
+FILL_AHEAD = 2
+EXCLUSIVE, ARBIT_START, ARBIT_STOP, RX = 0, 1, 2, 3
+SCHED_OK, SCHED_ERR_PARAM, SCHED_ERR_OVERLAP = 0, -1, -2
+POS_INVD = 0xFFFF
+DLC_SIZE = (0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64)
+
+# 只链接 can_ttc_sched.c, 不给任何头文件目录以外的桩
+SCHED_DRIVER = r'''
+#include <stdio.h>
+#include "can_ttc_sched.h"
+
+static stc_ttcan_slot_t slots[256];
+static stc_ttcan_frame_fmt_t fmts[256];
+
+int main(void) {
+    char op;
+    unsigned long a[8];
+    unsigned long i;
+    stc_ttcan_sched_t s;
+    uint16_t err;
+    int32_t ret;
+
+    while (scanf(" %c", &op) == 1) {
+        if (op == 'N') {
+            if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != 6) return 2;
+            fmts[0].u8Dlc = (uint8_t)a[0];
+            fmts[0].u8Ide = (uint8_t)a[1];
+            fmts[0].u8Fdf = (uint8_t)a[2];
+            fmts[0].u8Brs = (uint8_t)a[3];
+            printf("%u\n", TTCAN_FrameNtu(&fmts[0], (uint8_t)a[4], (uint8_t)a[5]));
+        } else if (op == 'M') {
+            if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != 6) return 2;
+            if (a[4] > 256 || a[5] > 256) return 2;
+            s.u16CycleTime = (uint16_t)a[0];
+            s.u8CycleNum = (uint8_t)a[1];
+            s.u8NtuBits = (uint8_t)a[2];
+            s.u8FdDataRatio = (uint8_t)a[3];
+            s.u8SlotNum = (uint8_t)a[4];
+            s.u8MsgNum = (uint8_t)a[5];
+            s.pstcSlot = slots;
+            s.pstcFmt = fmts;
+            for (i = 0; i < a[4]; i++) {
+                if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[6], &a[7]) != 6) return 2;
+                slots[i].u16Time = (uint16_t)a[0];
+                slots[i].u8Type = (uint8_t)a[1];
+                slots[i].u8TxEnableWindow = (uint8_t)a[2];
+                slots[i].u8CycleBase = (uint8_t)a[3];
+                slots[i].u8CycleRepeat = (uint8_t)a[6];
+                slots[i].u8MsgIndex = (uint8_t)a[7];
+            }
+            for (i = 0; i < s.u8MsgNum; i++) {
+                if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 2;
+                fmts[i].u8Dlc = (uint8_t)a[0];
+                fmts[i].u8Ide = (uint8_t)a[1];
+                fmts[i].u8Fdf = (uint8_t)a[2];
+                fmts[i].u8Brs = (uint8_t)a[3];
+            }
+            err = 0;
+            ret = TTCAN_SchedCheck(&s, &err);
+            printf("%ld %u\n", (long)ret, err);
+        } else {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+# 代替 hc32_ll.h: 返回值、CAN 寄存器结构和位定义、帧结构和 TTC 常量从库头文件中摘出,
+# 寄存器写入接到模型上
+STUB = r'''
+#ifndef __HC32_LL_H__
+#define __HC32_LL_H__
+#include <stddef.h>
+#include <stdint.h>
+#define __IO    volatile
+#define __I     volatile const
+typedef enum {
+    DISABLE = 0U,
+    ENABLE  = 1U,
+} en_functional_state_t;
+%s
+extern CM_CAN_TypeDef g_stcSimCan[2];
+#define CM_CAN1                     (&g_stcSimCan[0])
+#define CM_CAN2                     (&g_stcSimCan[1])
+void Sim_Write8(__IO uint8_t *reg, uint8_t val);
+void Sim_Write16(__IO uint16_t *reg, uint16_t val);
+#define WRITE_REG8(REG, VAL)        Sim_Write8(&(REG), (uint8_t)(VAL))
+#define WRITE_REG16(REG, VAL)       Sim_Write16(&(REG), (uint16_t)(VAL))
+#define READ_REG8_BIT(REG, BIT)     ((REG) & (BIT))
+#define __DMB()                     __sync_synchronize()
+void CAN_TTC_IntCmd(CM_CAN_TypeDef *CANx, uint8_t u8IntType, en_functional_state_t enNewState);
+void CAN_TTC_Cmd(CM_CAN_TypeDef *CANx, en_functional_state_t enNewState);
+uint8_t CAN_TTC_GetStatusValue(const CM_CAN_TypeDef *CANx);
+void CAN_TTC_ClearStatus(CM_CAN_TypeDef *CANx, uint8_t u8Flag);
+#endif
+'''
+
+ENGINE_DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "can_ttc.h"
+
+#define SIM_BUF             4U
+#define SIM_ID_BASE         0x100U
+#define SIM_EV_MAX          256U
+
+typedef struct {
+    uint8_t full;
+    uint32_t id;
+    uint32_t ctrl;
+    uint8_t data[64];
+    unsigned long txAt;             /* 写入时已发出的发送时隙数 */
+} sim_buf_t;
+
+typedef struct {
+    uint16_t time;
+    uint16_t type;
+    uint8_t tew;
+    uint8_t ptr;
+    uint32_t id;
+} sim_ev_t;
+
+CM_CAN_TypeDef g_stcSimCan[2];
+static CM_CAN_TypeDef *can = &g_stcSimCan[0];
+static stc_ttcan_slot_t slots[64];
+static stc_can_tx_frame_t msgs[TTCAN_MSG_MAX];
+static stc_ttcan_matrix_t mx;
+static uint32_t ver[TTCAN_MSG_MAX];
+static sim_buf_t buf[SIM_BUF];
+static uint8_t curPtr = 0xFFU;
+static uint8_t trigValid;
+static uint16_t trigTime;
+static uint16_t trigCfg;
+static uint16_t now;
+static uint8_t inCycle;
+static sim_ev_t ev[SIM_EV_MAX];
+static unsigned evNum;
+static unsigned long errors, txCount, trigCount, cycles, misses, jumps, updates, latches;
+static unsigned long seed = 1, nCycles = 1000, pMiss = 0, pJump = 0, pUpd = 300;
+static uint64_t rs;
+static uint8_t lastTxPtr = 0xFFU;
+
+static uint32_t Rnd(void) {
+    rs ^= rs << 13;
+    rs ^= rs >> 7;
+    rs ^= rs << 17;
+    return (uint32_t)(rs >> 16);
+}
+
+static void Fail(const char *msg, unsigned long a, unsigned long b) {
+    if (errors < 20) {
+        printf("fail: 周期 %lu 时刻 %u: %s (%lu, %lu)\n", cycles, now, msg, a, b);
+    }
+    errors++;
+}
+
+static void MakeData(uint8_t idx, uint32_t v, uint8_t *out) {
+    unsigned i;
+
+    for (i = 0; i < 64; i++) {
+        out[i] = (uint8_t)(v * 29U + i * 7U + idx * 13U + (v >> 8));
+    }
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = idx;
+}
+
+static uint8_t MsgSize(const stc_can_tx_frame_t *f) {
+    static const uint8_t size[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+    return size[f->DLC];
+}
+
+void Sim_Write8(__IO uint8_t *reg, uint8_t val) {
+    const uint32_t *w = (const uint32_t *)(const void *)&can->TBUF;
+    uint8_t ptr = (uint8_t)(val & CAN_TBSLOT_TBPTR);
+    uint8_t expect[64];
+    uint32_t idx;
+
+    *reg = val;
+
+    if (reg != &can->TBSLOT) {
+        return;
+    }
+
+    if (ptr >= SIM_BUF) {
+        Fail("TBPTR 超出 4 个 TTC 缓冲区", ptr, 0);
+        return;
+    }
+
+    if ((val & CAN_TBSLOT_TBE) != 0U) {
+        buf[ptr].full = 0;
+        curPtr = ptr;
+    }
+
+    if ((val & CAN_TBSLOT_TBF) != 0U) {
+        if (ptr != curPtr) {
+            Fail("置满的缓冲区不是刚写入的缓冲区", ptr, curPtr);
+        }
+
+        idx = w[0] - SIM_ID_BASE;
+
+        if (idx >= mx.u8MsgNum) {
+            Fail("写入缓冲区的 ID 不在报文表中", w[0], 0);
+            return;
+        }
+
+        if (w[1] != msgs[idx].u32Ctrl) {
+            Fail("写入缓冲区的控制字与报文不同", w[1], msgs[idx].u32Ctrl);
+        }
+
+        MakeData((uint8_t)idx, ver[idx], expect);
+
+        if (memcmp(&w[2], expect, MsgSize(&msgs[idx])) != 0) {
+            Fail("写入缓冲区的数据不是报文的最新版本", idx, ver[idx]);
+        }
+
+        buf[ptr].full = 1;
+        buf[ptr].id = w[0];
+        buf[ptr].ctrl = w[1];
+        memcpy(buf[ptr].data, &w[2], 64);
+        buf[ptr].txAt = txCount;
+        latches++;
+    }
+}
+
+void Sim_Write16(__IO uint16_t *reg, uint16_t val) {
+    *reg = val;
+
+    if (reg != &can->TT_TRIG) {
+        return;
+    }
+
+    if (trigValid != 0U) {
+        Fail("覆盖了尚未到达的触发", trigTime, val);
+    }
+
+    if (inCycle == 0U) {
+        Fail("没有参考报文时装载触发", val, 0);
+    } else if ((evNum != 0U) && (val <= now)) {
+        Fail("装载了已经过去的触发", val, now);
+    }
+
+    trigValid = 1;
+    trigTime = val;
+    trigCfg = can->TRG_CFG;
+}
+
+void CAN_TTC_IntCmd(CM_CAN_TypeDef *CANx, uint8_t u8IntType, en_functional_state_t enNewState) {
+    if (enNewState == ENABLE) {
+        CANx->TTCFG |= u8IntType;
+    } else {
+        CANx->TTCFG &= (uint8_t)~u8IntType;
+    }
+}
+
+void CAN_TTC_Cmd(CM_CAN_TypeDef *CANx, en_functional_state_t enNewState) {
+    if (enNewState == ENABLE) {
+        CANx->TTCFG |= CAN_TTCFG_TTEN;
+    } else {
+        CANx->TTCFG &= (uint8_t)~CAN_TTCFG_TTEN;
+    }
+}
+
+uint8_t CAN_TTC_GetStatusValue(const CM_CAN_TypeDef *CANx) {
+    return (uint8_t)(CANx->TTCFG & CAN_TTC_FLAG_ALL);
+}
+
+void CAN_TTC_ClearStatus(CM_CAN_TypeDef *CANx, uint8_t u8Flag) {
+    CANx->TTCFG &= (uint8_t)~u8Flag;
+}
+
+static void Fire(void) {
+    uint16_t type = (uint16_t)(trigCfg & CAN_TRG_CFG_TTYPE);
+    uint8_t ptr = (uint8_t)(trigCfg & CAN_TRG_CFG_TTPTR);
+    sim_ev_t *e;
+
+    now = trigTime;
+    trigValid = 0;
+    trigCount++;
+
+    if (evNum >= SIM_EV_MAX) {
+        Fail("一个周期内触发过多", evNum, 0);
+        return;
+    }
+
+    e = &ev[evNum++];
+    e->time = trigTime;
+    e->type = type;
+    e->tew = (uint8_t)(((trigCfg & CAN_TRG_CFG_TEW) >> CAN_TRG_CFG_TEW_POS) + 1U);
+    e->ptr = ptr;
+    e->id = 0;
+
+    if ((type == CAN_TTC_TRIG_SINGLESHOT_TX_TRIG) || (type == CAN_TTC_TRIG_TX_START_TRIG)) {
+        if (ptr >= SIM_BUF || buf[ptr].full == 0U) {
+            Fail("发送触发指向空缓冲区", ptr, 0);
+        } else {
+            e->id = buf[ptr].id;
+
+            /* 算上本时隙 */
+            if (txCount + 1U - buf[ptr].txAt > TTCAN_FILL_AHEAD) {
+                Fail("帧写入后隔了太多发送时隙才发出", txCount + 1U - buf[ptr].txAt, TTCAN_FILL_AHEAD);
+            }
+        }
+
+        if (ptr < SIM_BUF) {
+            buf[ptr].full = 0;
+        }
+
+        lastTxPtr = ptr;
+        txCount++;
+    } else if (type == CAN_TTC_TRIG_TX_STOP_TRIG) {
+        if (ptr != lastTxPtr) {
+            Fail("合并窗口结束触发没有指向最近的发送缓冲区", ptr, lastTxPtr);
+        }
+    }
+
+    can->TTCFG |= CAN_TTCFG_TTIF;
+    TTCAN_IrqHandler();
+
+    if ((can->TTCFG & CAN_TTCFG_TTIF) != 0U) {
+        Fail("TTIF 未清除", 0, 0);
+    }
+}
+
+static void Update(void) {
+    uint8_t idx;
+    uint8_t data[64];
+
+    if (mx.u8MsgNum == 0U || (Rnd() % 1000U) >= pUpd) {
+        return;
+    }
+
+    idx = (uint8_t)(Rnd() % mx.u8MsgNum);
+    MakeData(idx, ver[idx] + 1U, data);
+
+    if (TTCAN_UpdateMsg(idx, data) != LL_OK) {
+        Fail("TTCAN_UpdateMsg 失败", idx, 0);
+    }
+
+    ver[idx]++;
+    updates++;
+}
+
+static const uint16_t trigType[4] = {
+    CAN_TTC_TRIG_SINGLESHOT_TX_TRIG, CAN_TTC_TRIG_TX_START_TRIG, CAN_TTC_TRIG_TX_STOP_TRIG, CAN_TTC_TRIG_TIME_TRIG
+};
+
+static void Compare(uint8_t cyc) {
+    unsigned n = 0, i;
+    const stc_ttcan_slot_t *s;
+
+    for (i = 0; i < mx.u8SlotNum; i++) {
+        s = &slots[i];
+
+        if ((cyc & (s->u8CycleRepeat - 1U)) != s->u8CycleBase) {
+            continue;
+        }
+
+        if (n >= evNum) {
+            Fail("时隙没有触发", i, s->u16Time);
+            return;
+        }
+
+        if (ev[n].time != s->u16Time || ev[n].type != trigType[s->u8Type] || ev[n].tew != s->u8TxEnableWindow) {
+            Fail("触发与时隙不符(时隙, 触发时间)", i, ev[n].time);
+            return;
+        }
+
+        if (s->u8Type <= TTCAN_SLOT_ARBIT_START && ev[n].id != SIM_ID_BASE + s->u8MsgIndex) {
+            Fail("发送时隙发出的报文不对(ID, 应为)", ev[n].id, SIM_ID_BASE + s->u8MsgIndex);
+        }
+
+        n++;
+    }
+
+    if (n != evNum) {
+        Fail("周期内多出触发(实际, 应为)", evNum, n);
+    }
+}
+
+int main(int argc, char **argv) {
+    stc_ttcan_stats_t st;
+    unsigned long a[6];
+    unsigned long i, k;
+    unsigned long refs = 0;
+    uint8_t c = 0;
+    uint8_t r;
+
+    for (i = 1; i < (unsigned long)argc; i++) {
+        char *eq = strchr(argv[i], '=');
+
+        if (eq == NULL) {
+            return 2;
+        }
+
+        *eq = '\0';
+        k = strtoul(eq + 1, NULL, 0);
+
+        if (strcmp(argv[i], "seed") == 0) seed = k;
+        else if (strcmp(argv[i], "cycles") == 0) nCycles = k;
+        else if (strcmp(argv[i], "miss") == 0) pMiss = k;
+        else if (strcmp(argv[i], "jump") == 0) pJump = k;
+        else if (strcmp(argv[i], "upd") == 0) pUpd = k;
+        else return 2;
+    }
+
+    rs = 0x9E3779B97F4A7C15ULL ^ seed;
+
+    if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != 6 || a[4] > 64 || a[5] > TTCAN_MSG_MAX) {
+        return 2;
+    }
+
+    mx.u16CycleTime = (uint16_t)a[0];
+    mx.u8CycleNum = (uint8_t)a[1];
+    mx.u8NtuBits = (uint8_t)a[2];
+    mx.u8FdDataRatio = (uint8_t)a[3];
+    mx.u8SlotNum = (uint8_t)a[4];
+    mx.u8MsgNum = (uint8_t)a[5];
+    mx.pstcSlot = slots;
+    mx.pstcMsg = msgs;
+
+    for (i = 0; i < mx.u8SlotNum; i++) {
+        if (scanf("%lu %lu %lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != 6) return 2;
+        slots[i].u16Time = (uint16_t)a[0];
+        slots[i].u8Type = (uint8_t)a[1];
+        slots[i].u8TxEnableWindow = (uint8_t)a[2];
+        slots[i].u8CycleBase = (uint8_t)a[3];
+        slots[i].u8CycleRepeat = (uint8_t)a[4];
+        slots[i].u8MsgIndex = (uint8_t)a[5];
+    }
+
+    for (i = 0; i < mx.u8MsgNum; i++) {
+        if (scanf("%lu %lu %lu %lu", &a[0], &a[1], &a[2], &a[3]) != 4) return 2;
+        msgs[i].u32ID = SIM_ID_BASE + (uint32_t)i;
+        msgs[i].DLC = (uint32_t)a[0] & 0xFU;
+        msgs[i].IDE = (uint32_t)a[1] & 1U;
+        msgs[i].FDF = (uint32_t)a[2] & 1U;
+        msgs[i].BRS = (uint32_t)a[3] & 1U;
+        MakeData((uint8_t)i, 0, msgs[i].au8Data);
+    }
+
+    if (TTCAN_Init(CM_CAN1, &mx) != LL_ERR_INVD_MD) {
+        Fail("TTCAN 发送缓冲区模式未检查", 0, 0);
+    }
+
+    can->TCTRL |= CAN_TCTRL_TTTBM;
+
+    if (TTCAN_Init(CM_CAN1, &mx) != LL_OK) {
+        printf("fail: TTCAN_Init 失败\n");
+        return 1;
+    }
+
+    if ((can->TTCFG & (CAN_TTCFG_TTEN | CAN_TTC_INT_TIME_TRIG | CAN_TTC_INT_WATCH_TRIG)) !=
+            (CAN_TTCFG_TTEN | CAN_TTC_INT_TIME_TRIG | CAN_TTC_INT_WATCH_TRIG)) {
+        Fail("TTCAN 或其中断未打开", can->TTCFG, 0);
+    }
+
+    for (cycles = 0; cycles < nCycles; cycles++) {
+        r = (uint8_t)(Rnd() % 1000U);
+        evNum = 0;
+        now = 0;
+        Update();
+
+        if (cycles > 0 && r < pMiss) {
+            /* 参考报文丢失: 看门触发, 本周期没有触发 */
+            misses++;
+            can->TTCFG |= CAN_TTCFG_WTIF;
+            TTCAN_IrqHandler();
+
+            if ((can->TTCFG & CAN_TTCFG_WTIF) != 0U) {
+                Fail("WTIF 未清除", 0, 0);
+            }
+
+            if (trigValid != 0U) {
+                Fail("参考报文丢失时仍有已装载的触发", trigTime, 0);
+            }
+
+            c++;
+            continue;
+        }
+
+        if (cycles > 0 && r < pMiss + pJump) {
+            jumps++;
+            c = (uint8_t)(c + 1U + Rnd() % 7U);
+        }
+
+        inCycle = 1;
+        refs++;
+        TTCAN_CycleStart(c);
+
+        while (trigValid != 0U) {
+            if (trigTime > mx.u16CycleTime) {
+                Fail("触发时间超出基本周期", trigTime, mx.u16CycleTime);
+                trigValid = 0;
+                break;
+            }
+
+            Update();
+            Fire();
+        }
+
+        inCycle = 0;
+        Compare((uint8_t)(c & (mx.u8CycleNum - 1U)));
+        c++;
+    }
+
+    TTCAN_GetStats(&st);
+
+    if (st.u32Cycles != refs) Fail("统计: 周期数", st.u32Cycles, refs);
+    if (st.u32Triggers != trigCount) Fail("统计: 触发数", st.u32Triggers, trigCount);
+    if (st.u32TxSlots != txCount) Fail("统计: 发送时隙数", st.u32TxSlots, txCount);
+    if (st.u32WatchTrigs != misses) Fail("统计: 看门触发数", st.u32WatchTrigs, misses);
+    if (st.u32TrigErrors != 0U) Fail("统计: 触发错误", st.u32TrigErrors, 0);
+    if (pMiss == 0U && pJump == 0U && st.u32Resync != 1U) Fail("统计: 无故障时重新对齐", st.u32Resync, 1);
+
+    printf("cycles=%lu\ntriggers=%lu\ntx=%lu\nlatches=%lu\nupdates=%lu\nmisses=%lu\njumps=%lu\nresync=%lu\nerrors=%lu\n",
+           refs, trigCount, txCount, latches, updates, misses, jumps, (unsigned long)st.u32Resync, errors);
+    return errors ? 1 : 0;
+}
+'''
+
+
+# ---------------------------------------------------------------- 帧长
+
+def crc15(bits):
+    crc = 0
+    for b in bits:
+        nxt = b ^ ((crc >> 14) & 1)
+        crc = (crc << 1) & 0x7FFF
+        if nxt:
+            crc ^= 0x4599
+    return [(crc >> (14 - i)) & 1 for i in range(15)]
+
+
+def to_bits(value, width):
+    return [(value >> (width - 1 - i)) & 1 for i in range(width)]
+
+
+def stuff_count(bits, start_run=0, start_last=None):
+    """动态填充: 返回 (填充位数, 每个原始位之后插入的填充位数列表)"""
+    run, last = start_run, start_last
+    total = 0
+    after = []
+    for b in bits:
+        if b == last:
+            run += 1
+        else:
+            run, last = 1, b
+        n = 0
+        if run == 5:
+            n = 1
+            last = 1 - b
+            run = 1
+        total += n
+        after.append(n)
+    return total, after
+
+
+def frame_fields(ident, ide, fdf, brs, dlc, data):
+    """返回 (仲裁段原始位, 数据段原始位, 数据字节数); 经典帧全部算仲裁段, 含 CRC15"""
+    size = DLC_SIZE[dlc] if fdf else min(dlc, 8)
+    payload = []
+    for v in data[:size]:
+        payload += to_bits(v, 8)
+    if ide:
+        head = [0] + to_bits(ident >> 18, 11) + [1, 1] + to_bits(ident & 0x3FFFF, 18)   # SRR, IDE
+    else:
+        head = [0] + to_bits(ident, 11)
+    if not fdf:
+        body = head + [0, 0, 0] + to_bits(dlc, 4) + payload     # RTR, r1/IDE, r0
+        return body + crc15(body), [], size
+    if ide:
+        arb = head + [0, 1, 0, brs]                             # RRS, FDF, res, BRS
+    else:
+        arb = head + [0, 0, 1, 0, brs]                          # RRS, IDE, FDF, res, BRS
+    return arb, [0] + to_bits(dlc, 4) + payload, size           # ESI, DLC, 数据
+
+
+def frame_time(ident, ide, fdf, brs, dlc, data, ratio):
+    """帧占用时间, 以仲裁段位时间计"""
+    arb, dat, size = frame_fields(ident, ide, fdf, brs, dlc, data)
+    if not fdf:
+        n, _ = stuff_count(arb)
+        return len(arb) + n + 13                                # CRC 界定符、ACK、EOF、帧间隔
+    n, after = stuff_count(arb + dat)
+    n_arb = sum(after[:len(arb) - 1])                           # BRS 之后插入的填充位已是数据段速率
+    crc_len = 21 if size > 16 else 17
+    fixed = 1 + (4 + crc_len - 1) // 4                          # 填充计数前及其后每 4 位一个固定填充位
+    fast = len(dat) + n - n_arb + 4 + crc_len + fixed
+    return len(arb) + n_arb + 13 + (fast / ratio if brs else fast)
+
+
+def free_bits(ide, fdf, brs, dlc):
+    """ID 和数据位在动态填充区中的位置"""
+    size = DLC_SIZE[dlc] if fdf else min(dlc, 8)
+    lo = frame_fields(0, ide, fdf, brs, dlc, [0] * size)
+    hi = frame_fields((1 << (29 if ide else 11)) - 1, ide, fdf, brs, dlc, [0xFF] * size)
+    seq_lo, seq_hi = lo[0] + lo[1], hi[0] + hi[1]
+    n = len(seq_lo) - (0 if fdf else 15)
+    return [k for k in range(n) if seq_lo[k] != seq_hi[k]], size
+
+
+def greedy_frame(ide, fdf, brs, dlc):
+    """ID 和数据位逐位取与上一个发出位(含填充位)相同的值, 使填充位尽量多"""
+    pos, size = free_bits(ide, fdf, brs, dlc)
+    seq = list(frame_fields(0, ide, fdf, brs, dlc, [0] * size))
+    seq = seq[0] + seq[1]
+    free = set(pos)
+    run, last = 0, None
+    for k in range(len(seq)):
+        if k in free:
+            seq[k] = last
+        if seq[k] == last:
+            run += 1
+        else:
+            run, last = 1, seq[k]
+        if run == 5:
+            last, run = 1 - seq[k], 1
+    vals = [seq[k] for k in pos]
+    width = 29 if ide else 11
+    ident = 0
+    for v in vals[:width]:
+        ident = (ident << 1) | v
+    data = []
+    for k in range(size):
+        byte = 0
+        for v in vals[width + 8 * k:width + 8 * k + 8]:
+            byte = (byte << 1) | v
+        data.append(byte)
+    return [(ident, data)]
+
+
+def run_frame(args, exe):
+    rnd = random.Random(args.seed)
+    queries, cases = [], []
+    for ide in (0, 1):
+        for fdf in (0, 1):
+            for brs in ((0, 1) if fdf else (0,)):
+                for dlc in range(16):
+                    if not fdf and dlc > 8:
+                        continue
+                    frames = greedy_frame(ide, fdf, brs, dlc)
+                    size = DLC_SIZE[dlc] if fdf else dlc
+                    for fill in (0x00, 0xFF, 0x0F, 0xF0, 0x55):
+                        frames.append((0, [fill] * size))
+                    for _ in range(args.frames):
+                        ident = rnd.randrange(1 << (29 if ide else 11))
+                        frames.append((ident, [rnd.randrange(256) for _ in range(size)]))
+                    for ntu in (1, 2, 4, 8):
+                        for ratio in ((1, 2, 4, 5, 8) if brs else (1,)):
+                            queries.append('N %d %d %d %d %d %d' % (dlc, ide, fdf, brs, ntu, ratio))
+                            cases.append((ide, fdf, brs, dlc, ntu, ratio, frames))
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE, universal_newlines=True)
+    lines = r.stdout.split()
+    if r.returncode != 0 or len(lines) != len(cases):
+        print('驱动异常退出: 返回 %d' % r.returncode)
+        return 1
+    bad = 0
+    slack = {}
+    memo = {}
+    for line, (ide, fdf, brs, dlc, ntu, ratio, frames) in zip(lines, cases):
+        bound = int(line) * ntu
+        key = (ide, fdf, brs, dlc, ratio)
+        if key not in memo:
+            memo[key] = max(frame_time(i, ide, fdf, brs, dlc, d, ratio) for i, d in frames)
+        worst = memo[key]
+        if worst > bound:
+            if bad < MAX_REPORT:
+                print('IDE=%d FDF=%d BRS=%d DLC=%d NTU=%d 位 比 %d: 上界 %d 位, 实际 %.2f 位' % (
+                    ide, fdf, brs, dlc, ntu, ratio, bound, worst))
+            bad += 1
+        if ntu == 1:
+            kind = ('FD+BRS' if brs else 'FD') if fdf else '经典'
+            kind += '/扩展' if ide else '/标准'
+            slack.setdefault(kind, []).append(bound - worst)
+    for kind in sorted(slack):
+        print('  %-12s 上界比实际最坏多 %.1f ~ %.1f 位' % (kind, min(slack[kind]), max(slack[kind])))
+    print('frame: %d 种格式, 差异 %d 项' % (len(cases), bad))
+    return 1 if bad else 0
+
+
+# ---------------------------------------------------------------- 矩阵检查
+
+def fmt_time(fmt, ntu, ratio, memo={}):
+    """该格式的实际最坏占用时间(NTU, 向上取整)"""
+    dlc, ide, fdf, brs = fmt
+    key = (dlc, ide, fdf, brs, ratio)
+    if key not in memo:
+        frames = greedy_frame(ide, fdf, brs, dlc)
+        size = DLC_SIZE[dlc] if fdf else min(dlc, 8)
+        frames += [(0, [v] * size) for v in (0x00, 0xFF, 0x0F, 0xF0)]
+        memo[key] = max(frame_time(i, ide, fdf, brs, dlc, d, ratio) for i, d in frames)
+    t = memo[key] / ntu
+    return int(t) + (1 if t > int(t) else 0)
+
+
+def pow2(v):
+    return v != 0 and (v & (v - 1)) == 0
+
+
+def param_error(m):
+    """按 can_ttc_sched.h 的字段说明判断参数错误: None 或 (返回值, 出错时隙)"""
+    if (not m['slots'] or m['cycles'] == 0 or m['cycles'] > 64 or not pow2(m['cycles']) or
+            len(m['msgs']) > MSG_MAX or m['ntu'] not in (1, 2, 4, 8) or m['ratio'] == 0):
+        return (SCHED_ERR_PARAM, POS_INVD)
+    prev = None
+    for i, (t, typ, tew, base, rep, msg) in enumerate(m['slots']):
+        if (typ > RX or not 1 <= tew <= 16 or rep == 0 or rep > m['cycles'] or not pow2(rep) or base >= rep or
+                t > m['cycle_time'] or (prev is not None and t <= prev) or
+                (typ <= ARBIT_START and msg >= len(m['msgs']))):
+            return (SCHED_ERR_PARAM, i)
+        prev = t
+    return None
+
+
+def replay(m, rnd, worst):
+    """总线回放, 返回第一个出问题的 (周期, 时隙) 或 None; worst 为真时帧总在窗口末端开始"""
+    ntu, ratio = m['ntu'], m['ratio']
+    for cyc in range(m['cycles']):
+        active = [(i, s) for i, s in enumerate(m['slots']) if (cyc & (s[4] - 1)) == s[3]]
+        free = 0            # 前面的窗口占用总线到此刻
+        window = None       # 合并窗口内的帧: [(ID, 就绪时刻, 长度)]
+        for i, (t, typ, tew, base, rep, msg) in active:
+            if typ != ARBIT_START and window is None and t < free:
+                return (cyc, i)
+            if window is not None and typ == EXCLUSIVE:
+                return (cyc, i)
+            if typ == EXCLUSIVE:
+                length = fmt_time(m['msgs'][msg], ntu, ratio)
+                start = t + tew if worst else t + rnd.randint(0, tew)
+                free = start + length
+            elif typ == ARBIT_START:
+                if window is None:
+                    if t < free:
+                        return (cyc, i)
+                    window = []
+                window.append((msg, t, fmt_time(m['msgs'][msg], ntu, ratio)))
+            elif typ == ARBIT_STOP:
+                if window is None:
+                    return (cyc, i)
+                # 窗口内按就绪时刻和 ID 仲裁, 结束触发前开始的帧发完
+                bus = free
+                pending = sorted(window, key=lambda f: (f[1], f[0]))
+                while pending:
+                    ready = [f for f in pending if f[1] <= max(bus, pending[0][1])]
+                    f = min(ready, key=lambda f: f[0])
+                    start = max(bus, f[1])
+                    if not worst:
+                        start += rnd.randint(0, 2)
+                    if start >= t:
+                        break
+                    bus = start + f[2]
+                    pending.remove(f)
+                if worst and window:
+                    bus = max(bus, t - 1 + max(f[2] for f in window))
+                free = max(free, bus)
+                window = None
+        if window is not None or free > m['cycle_time']:
+            return (cyc, len(m['slots']) - 1)
+    return None
+
+
+def gen_fmt(rnd):
+    fdf = rnd.random() < 0.4
+    return (rnd.randrange(16 if fdf else 9), rnd.randrange(2), int(fdf), int(fdf and rnd.random() < 0.6))
+
+
+def gen_matrix(rnd, bad_param):
+    cycles = rnd.choice((1, 2, 4, 8, 16, 64))
+    msgs = [gen_fmt(rnd) for _ in range(rnd.randrange(1, MSG_MAX + 1))]
+    ntu = rnd.choice((1, 2, 4, 8))
+    ratio = rnd.choice((1, 2, 4, 5))
+    slots = []
+    t = rnd.randrange(0, 20)
+    open_window = False
+    for _ in range(rnd.randrange(1, 20)):
+        rep = rnd.choice([r for r in (1, 2, 4, 8, 16, 32, 64) if r <= cycles])
+        base = rnd.randrange(rep)
+        msg = rnd.randrange(len(msgs))
+        tew = rnd.randrange(1, 17)
+        # 少量放在不合法位置: 合并窗口内的独占窗口、窗口外的结束触发
+        if open_window:
+            typ = rnd.choice((ARBIT_START, ARBIT_STOP, ARBIT_STOP, ARBIT_STOP, RX, RX, EXCLUSIVE))
+            rep, base = slots[-1][4], slots[-1][3]
+        else:
+            typ = rnd.choice((EXCLUSIVE, EXCLUSIVE, EXCLUSIVE, ARBIT_START, ARBIT_START, RX, RX, ARBIT_STOP))
+        open_window = typ == ARBIT_START or (open_window and typ != ARBIT_STOP)
+        slots.append((t, typ, tew, base, rep, msg))
+        t += rnd.randrange(1, 70 if rnd.random() < 0.5 else 40) * (2 if ntu == 1 else 1)
+    if open_window:
+        rep, base = slots[-1][4], slots[-1][3]
+        slots.append((t, ARBIT_STOP, 1, base, rep, 0))
+        t += 60
+    m = dict(cycle_time=max(0, t + rnd.randrange(-20, 80)), cycles=cycles, ntu=ntu, ratio=ratio, slots=slots, msgs=msgs)
+    if bad_param:
+        k = rnd.randrange(12)
+        i = rnd.randrange(len(slots))
+        s = list(slots[i])
+        if k == 0:
+            m['cycles'] = rnd.choice((0, 3, 128))
+        elif k == 1:
+            m['ntu'] = rnd.choice((0, 3, 16))
+        elif k == 2:
+            m['ratio'] = 0
+        elif k == 3:
+            s[1] = 4 + rnd.randrange(4)
+        elif k == 4:
+            s[2] = rnd.choice((0, 17))
+        elif k == 5:
+            s[4] = rnd.choice((0, 3, 2 * cycles))
+        elif k == 6:
+            s[3] = s[4]
+        elif k == 7:
+            s[0] = m['cycle_time'] + 1
+        elif k == 8 and i > 0:
+            s[0] = slots[i - 1][0]
+        elif k == 9:
+            s[1], s[5] = EXCLUSIVE, len(msgs)
+        elif k == 10:
+            m['slots'] = []
+        else:
+            m['msgs'] = msgs + [gen_fmt(rnd) for _ in range(MSG_MAX + 1 - len(msgs))]
+        if m['slots']:
+            m['slots'][i] = tuple(s)
+    return m
+
+
+def matrix_query(m):
+    q = ['M %d %d %d %d %d %d' % (m['cycle_time'], m['cycles'], m['ntu'], m['ratio'], len(m['slots']), len(m['msgs']))]
+    q += ['%d %d %d %d %d %d' % s for s in m['slots']]
+    q += ['%d %d %d %d' % f for f in m['msgs']]
+    return q
+
+
+def run_check(args, exe):
+    rnd = random.Random(args.seed)
+    mats = [gen_matrix(rnd, i % 4 == 3) for i in range(args.matrices)]
+    queries = []
+    for m in mats:
+        queries += matrix_query(m)
+    r = subprocess.run([exe], input='\n'.join(queries) + '\n', stdout=subprocess.PIPE, universal_newlines=True)
+    lines = r.stdout.splitlines()
+    if r.returncode != 0 or len(lines) != len(mats):
+        print('驱动异常退出: 返回 %d' % r.returncode)
+        return 1
+    bad = 0
+    count = {SCHED_OK: 0, SCHED_ERR_PARAM: 0, SCHED_ERR_OVERLAP: 0}
+    pessimistic = 0
+    for no, (line, m) in enumerate(zip(lines, mats)):
+        ret, err = (int(v) for v in line.split())
+        count[ret] = count.get(ret, 0) + 1
+        exp = param_error(m)
+        msg = None
+        if exp is not None:
+            if (ret, err) != exp:
+                msg = '参数错误: 返回 (%d, %d), 应为 %s' % (ret, err, exp)
+        elif ret == SCHED_ERR_PARAM:
+            msg = '合法矩阵被判为参数错误, 时隙 %d' % err
+        elif ret == SCHED_OK:
+            hit = replay(m, rnd, True)
+            for _ in range(20):
+                hit = hit or replay(m, rnd, False)
+            if hit is not None:
+                msg = '检查通过, 回放在周期 %d 时隙 %d 出问题' % hit
+        elif replay(m, rnd, True) is None:
+            pessimistic += 1
+        if msg:
+            if bad < MAX_REPORT:
+                print('矩阵 %d: %s' % (no, msg))
+            bad += 1
+    print('check: %d 个矩阵, 通过 %d, 参数错误 %d, 重叠 %d(其中最坏回放放得下 %d), 差异 %d 项' % (
+        len(mats), count[SCHED_OK], count[SCHED_ERR_PARAM], count[SCHED_ERR_OVERLAP], pessimistic, bad))
+    return 1 if bad else 0
+
+
+# ---------------------------------------------------------------- 调度引擎
+
+def spaced_matrix(rnd, cycles, kinds, empty_cycles=False):
+    """按最坏帧长留足间隔, 生成一定能通过检查的矩阵"""
+    ntu = rnd.choice((1, 2, 4))
+    ratio = rnd.choice((1, 2, 4))
+    msgs = [gen_fmt(rnd) for _ in range(rnd.randrange(1, MSG_MAX + 1))]
+    longest = max(fmt_time(f, ntu, 1) for f in msgs) + 8       # 上界比实际最坏多出的几位
+    slots = []
+    t = rnd.randrange(1, 10)
+    reps = [r for r in (1, 2, 4, 8, 16, 32, 64) if r <= cycles]
+    n = rnd.randrange(2, 12)
+    k = 0
+    while k < n:
+        rep = rnd.choice(reps)
+        base = rnd.randrange(rep)
+        if empty_cycles and cycles > 1:
+            # 所有时隙只出现在偶数周期, 奇数周期为空
+            rep = max(2, rep)
+            base &= ~1
+        typ = rnd.choice(kinds)
+        if typ == ARBIT_START:
+            for _ in range(rnd.randrange(1, 4)):
+                slots.append((t, ARBIT_START, rnd.randrange(1, 17), base, rep, rnd.randrange(len(msgs))))
+                t += rnd.randrange(1, 10)
+            slots.append((t, ARBIT_STOP, 1, base, rep, 0))
+            t += longest + 1
+        else:
+            slots.append((t, typ, rnd.randrange(1, 17), base, rep, rnd.randrange(len(msgs))))
+            t += 17 + longest + rnd.randrange(0, 20)
+        k += 1
+    return dict(cycle_time=t + 5, cycles=cycles, ntu=ntu, ratio=ratio, slots=slots, msgs=msgs)
+
+
+def run_engine(args, exe, sched_exe):
+    rnd = random.Random(args.seed)
+    tx = (EXCLUSIVE, EXCLUSIVE, ARBIT_START, RX)
+    scenarios = [
+        ('clean', dict(miss=0, jump=0), lambda: spaced_matrix(rnd, rnd.choice((2, 4, 8, 16, 64)), tx)),
+        ('faults', dict(miss=30, jump=30), lambda: spaced_matrix(rnd, rnd.choice((2, 4, 8, 16, 64)), tx)),
+        ('single', dict(miss=20, jump=20), lambda: spaced_matrix(rnd, 1, tx)),
+        ('empty', dict(miss=20, jump=20), lambda: spaced_matrix(rnd, rnd.choice((2, 4, 8)), tx, True)),
+        ('rx-only', dict(miss=20, jump=20), lambda: spaced_matrix(rnd, rnd.choice((1, 4)), (RX,))),
+    ]
+    bad = 0
+    print('%-8s %6s %8s %8s %8s %6s %6s %6s' % ('场景', '周期', '触发', '发送', '更新', '丢失', '跳变', '对齐'))
+    for name, faults, make in scenarios:
+        tot = {}
+        fails = []
+        for k in range(args.matrices_engine):
+            m = make()
+            r = subprocess.run([sched_exe], input='\n'.join(matrix_query(m)) + '\n', stdout=subprocess.PIPE,
+                               universal_newlines=True)
+            if r.stdout.split()[:1] != ['0']:
+                fails.append('生成的矩阵没有通过检查: %s' % r.stdout.strip())
+                continue
+            q = matrix_query(m)
+            text = '\n'.join([q[0][2:]] + q[1:]) + '\n'
+            cmd = [exe, 'seed=%d' % (args.seed * 1000 + k), 'cycles=%d' % args.cycles] + \
+                  ['%s=%d' % kv for kv in sorted(faults.items())]
+            r = subprocess.run(cmd, input=text, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                               universal_newlines=True)
+            for line in r.stdout.splitlines():
+                if line.startswith('fail: '):
+                    fails.append('矩阵 %d: %s' % (k, line[6:]))
+                elif '=' in line:
+                    key, v = line.split('=', 1)
+                    tot[key] = tot.get(key, 0) + int(v)
+            if r.returncode != 0 and not any(l.startswith('fail: ') for l in r.stdout.splitlines()):
+                fails.append('矩阵 %d: 驱动异常退出: 返回 %d' % (k, r.returncode))
+        print('%-8s %8d %8d %8d %8d %6d %6d %6d' % (
+            name, tot.get('cycles', 0), tot.get('triggers', 0), tot.get('tx', 0), tot.get('updates', 0),
+            tot.get('misses', 0), tot.get('jumps', 0), tot.get('resync', 0)))
+        for msg in fails[:MAX_REPORT]:
+            print('    ' + msg)
+        bad += 1 if fails else 0
+    print('engine: %d 个场景, 失败 %d 个' % (len(scenarios), bad))
+    return 1 if bad else 0
+
+
+# ---------------------------------------------------------------- 编译
+
+def compile_exe(args, tmp, name, sources, driver, incs):
+    path = os.path.join(tmp, name + '.c')
+    exe = os.path.join(tmp, name)
+    with open(path, 'w', encoding='utf-8') as f:
+        f.write(driver)
+    cmd = [args.cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-Werror']
+    for inc in incs:
+        cmd += ['-I', inc]
+    cmd += sources + [path, '-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def write_stub(tmp):
+    with open(LL_DEF, encoding='utf-8') as f:
+        defs = [l.rstrip() for l in f if re.match(r'#define\s+(LL_OK|LL_ERR\w*|LL_MAX|LL_MIN)\b', l)]
+    with open(DEVICE, encoding='utf-8') as f:
+        dev = f.read()
+    struct = re.search(r'typedef struct \{\n\s+__I\s+uint32_t RBUF;.*?\} CM_CAN_TypeDef;', dev, re.S).group(0)
+    regs = re.findall(r'#define\s+CAN_(?:TCTRL_TTTBM|TBSLOT_\w+|TTCFG_\w+|TRG_CFG_\w+)\s+\S+', dev)
+    with open(LL_CAN, encoding='utf-8') as f:
+        can = f.read()
+    frame = re.search(r'typedef struct \{\n\s+uint32_t u32ID;(?:(?!typedef).)*?\} stc_can_tx_frame_t;', can, re.S).group(0)
+    ttc = re.findall(r'#define\s+CAN_TTC_(?:INT|FLAG|TRIG)_\w+(?:[^\n]*\\\n)*[^\n]*', can)
+    with open(os.path.join(tmp, 'hc32_ll.h'), 'w', encoding='utf-8') as f:
+        f.write(STUB % '\n'.join(defs + regs + [struct, frame] + ttc))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('cmd', nargs='?', choices=('all', 'frame', 'check', 'engine'), default='all')
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--frames', type=int, default=300, help='frame: 每种格式的随机帧数')
+    ap.add_argument('--matrices', type=int, default=3000, help='check: 随机矩阵个数')
+    ap.add_argument('--matrices-engine', type=int, default=40, help='engine: 每个场景的矩阵个数')
+    ap.add_argument('--cycles', type=int, default=4000, help='engine: 每个矩阵运行的基本周期数')
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp()
+    try:
+        sched_exe = compile_exe(args, tmp, 'sched', [SCHED], SCHED_DRIVER, [BSP])
+        if sched_exe is None:
+            return 1
+        ret = 0
+        if args.cmd in ('all', 'frame'):
+            ret |= run_frame(args, sched_exe)
+        if args.cmd in ('all', 'check'):
+            ret |= run_check(args, sched_exe)
+        if args.cmd in ('all', 'engine'):
+            write_stub(tmp)
+            exe = compile_exe(args, tmp, 'engine', [ENGINE, SCHED], ENGINE_DRIVER, [tmp, BSP])
+            if exe is None:
+                return 1
+            ret |= run_engine(args, exe, sched_exe)
+        return ret
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
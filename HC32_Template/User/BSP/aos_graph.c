@@ -0,0 +1,594 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : aos_graph.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : AOS 事件链路图
+                   1. 每个 AOS 目标寄存器有一个 TRGSEL(选一个事件)和两个公共触发使能位,
+                      同一目标的第 2、3 路输入经 COMTRG1/COMTRG2 合并; 公共触发全局只有两个,
+                      不同目标使用同一事件时共用一个;
+                   2. 图的节点是外设模块: 连线把源事件所属模块接到目标模块, 目标模块再产生
+                      下一条连线的源事件; 模块图有回环时事件会无限传递, 检查时拒绝;
+                   3. 源事件归属按 en_event_src_t 的编号区间查表(m_astcSrcRange), 不在表内的
+                      事件(端口、软件、串口等)只能作根;
+                   4. Apply 前逐个读回寄存器, 已被其他代码设为别的事件(如 motor_pwm 的 ADC 触发)
+                      时不覆盖, 返回 LL_ERR_BUSY.
+                   Tools/aos_graph.py selftest 会对照设备头文件检查本文件的两张表.
+  * Function List:
+
+  **********************************************************
+ */
+#include "aos_graph.h"
+
+#define AOSG_TRGSEL_MASK            (AOS_DCU_TRGSEL_TRGSEL)         /*!< 各目标寄存器位域相同 */
+#define AOSG_COMM_EN_POS            (AOS_DCU_TRGSEL_COMTRG_EN_POS)
+
+/* 模块, 图中的节点 */
+enum {
+    AOSG_MOD_DMA1 = 0, AOSG_MOD_DMA2, AOSG_MOD_DMA_RC,
+    AOSG_MOD_DCU1, AOSG_MOD_DCU2, AOSG_MOD_DCU3, AOSG_MOD_DCU4,
+    AOSG_MOD_TMR0, AOSG_MOD_TMR2, AOSG_MOD_TMR6, AOSG_MOD_TMRA,
+    AOSG_MOD_PORT12, AOSG_MOD_PORT34, AOSG_MOD_HASH, AOSG_MOD_OTS,
+    AOSG_MOD_ADC1, AOSG_MOD_ADC2, AOSG_MOD_ADC3,
+    AOSG_MOD_NUM,
+    AOSG_MOD_NONE = 0xFF
+};
+
+typedef struct {
+    __IO uint32_t *pu32Reg;
+    uint8_t u8Mod;
+    const char *pcName;
+} stc_aosg_target_t;
+
+typedef struct {
+    uint16_t u16Lo;
+    uint16_t u16Hi;
+    uint8_t u8Mod;
+} stc_aosg_range_t;
+
+static const stc_aosg_target_t m_astcTarget[] = {
+    {&CM_AOS->DCU_TRGSEL1,    AOSG_MOD_DCU1,   "DCU1"},
+    {&CM_AOS->DCU_TRGSEL2,    AOSG_MOD_DCU2,   "DCU2"},
+    {&CM_AOS->DCU_TRGSEL3,    AOSG_MOD_DCU3,   "DCU3"},
+    {&CM_AOS->DCU_TRGSEL4,    AOSG_MOD_DCU4,   "DCU4"},
+    {&CM_AOS->DMA1_TRGSEL0,   AOSG_MOD_DMA1,   "DMA1_0"},
+    {&CM_AOS->DMA1_TRGSEL1,   AOSG_MOD_DMA1,   "DMA1_1"},
+    {&CM_AOS->DMA1_TRGSEL2,   AOSG_MOD_DMA1,   "DMA1_2"},
+    {&CM_AOS->DMA1_TRGSEL3,   AOSG_MOD_DMA1,   "DMA1_3"},
+    {&CM_AOS->DMA1_TRGSEL4,   AOSG_MOD_DMA1,   "DMA1_4"},
+    {&CM_AOS->DMA1_TRGSEL5,   AOSG_MOD_DMA1,   "DMA1_5"},
+    {&CM_AOS->DMA1_TRGSEL6,   AOSG_MOD_DMA1,   "DMA1_6"},
+    {&CM_AOS->DMA1_TRGSEL7,   AOSG_MOD_DMA1,   "DMA1_7"},
+    {&CM_AOS->DMA2_TRGSEL0,   AOSG_MOD_DMA2,   "DMA2_0"},
+    {&CM_AOS->DMA2_TRGSEL1,   AOSG_MOD_DMA2,   "DMA2_1"},
+    {&CM_AOS->DMA2_TRGSEL2,   AOSG_MOD_DMA2,   "DMA2_2"},
+    {&CM_AOS->DMA2_TRGSEL3,   AOSG_MOD_DMA2,   "DMA2_3"},
+    {&CM_AOS->DMA2_TRGSEL4,   AOSG_MOD_DMA2,   "DMA2_4"},
+    {&CM_AOS->DMA2_TRGSEL5,   AOSG_MOD_DMA2,   "DMA2_5"},
+    {&CM_AOS->DMA2_TRGSEL6,   AOSG_MOD_DMA2,   "DMA2_6"},
+    {&CM_AOS->DMA2_TRGSEL7,   AOSG_MOD_DMA2,   "DMA2_7"},
+    {&CM_AOS->DMA_TRGSELRC,   AOSG_MOD_DMA_RC, "DMA_RC"},
+    {&CM_AOS->TMR6_HTSSR0,    AOSG_MOD_TMR6,   "TMR6_0"},
+    {&CM_AOS->TMR6_HTSSR1,    AOSG_MOD_TMR6,   "TMR6_1"},
+    {&CM_AOS->TMR6_HTSSR2,    AOSG_MOD_TMR6,   "TMR6_2"},
+    {&CM_AOS->TMR6_HTSSR3,    AOSG_MOD_TMR6,   "TMR6_3"},
+    {&CM_AOS->PEVNTTRGSR12,   AOSG_MOD_PORT12, "EVTPORT12"},
+    {&CM_AOS->PEVNTTRGSR34,   AOSG_MOD_PORT34, "EVTPORT34"},
+    {&CM_AOS->TMR0_HTSSR,     AOSG_MOD_TMR0,   "TMR0"},
+    {&CM_AOS->TMR2_HTSSR,     AOSG_MOD_TMR2,   "TMR2"},
+    {&CM_AOS->HASH_ITRGSELA,  AOSG_MOD_HASH,   "HASH_A"},
+    {&CM_AOS->HASH_ITRGSELB,  AOSG_MOD_HASH,   "HASH_B"},
+    {&CM_AOS->TMRA_HTSSR0,    AOSG_MOD_TMRA,   "TMRA_0"},
+    {&CM_AOS->TMRA_HTSSR1,    AOSG_MOD_TMRA,   "TMRA_1"},
+    {&CM_AOS->TMRA_HTSSR2,    AOSG_MOD_TMRA,   "TMRA_2"},
+    {&CM_AOS->TMRA_HTSSR3,    AOSG_MOD_TMRA,   "TMRA_3"},
+    {&CM_AOS->OTS_TRG,        AOSG_MOD_OTS,    "OTS"},
+    {&CM_AOS->ADC1_ITRGSELR0, AOSG_MOD_ADC1,   "ADC1_0"},
+    {&CM_AOS->ADC1_ITRGSELR1, AOSG_MOD_ADC1,   "ADC1_1"},
+    {&CM_AOS->ADC2_ITRGSELR0, AOSG_MOD_ADC2,   "ADC2_0"},
+    {&CM_AOS->ADC2_ITRGSELR1, AOSG_MOD_ADC2,   "ADC2_1"},
+    {&CM_AOS->ADC3_ITRGSELR0, AOSG_MOD_ADC3,   "ADC3_0"},
+    {&CM_AOS->ADC3_ITRGSELR1, AOSG_MOD_ADC3,   "ADC3_1"},
+};
+
+#define AOSG_TARGET_NUM             (sizeof(m_astcTarget) / sizeof(m_astcTarget[0]))
+
+/* 可作为目标的模块所产生的事件编号区间, 按编号递增; TMR6 与 TMRA 的编号交错 */
+static const stc_aosg_range_t m_astcSrcRange[] = {
+    {32U,  47U,  AOSG_MOD_DMA1},
+    {55U,  55U,  AOSG_MOD_DCU1},
+    {56U,  56U,  AOSG_MOD_DCU2},
+    {57U,  57U,  AOSG_MOD_DCU3},
+    {58U,  58U,  AOSG_MOD_DCU4},
+    {64U,  79U,  AOSG_MOD_DMA2},
+    {96U,  99U,  AOSG_MOD_TMR0},
+    {100U, 115U, AOSG_MOD_TMR2},
+    {128U, 135U, AOSG_MOD_TMR6},
+    {144U, 151U, AOSG_MOD_TMR6},
+    {160U, 167U, AOSG_MOD_TMR6},
+    {179U, 180U, AOSG_MOD_TMR6},
+    {187U, 188U, AOSG_MOD_TMR6},
+    {195U, 196U, AOSG_MOD_TMR6},
+    {208U, 215U, AOSG_MOD_TMR6},
+    {219U, 220U, AOSG_MOD_TMR6},
+    {224U, 231U, AOSG_MOD_TMR6},
+    {235U, 236U, AOSG_MOD_TMR6},
+    {237U, 239U, AOSG_MOD_TMRA},
+    {240U, 247U, AOSG_MOD_TMR6},
+    {251U, 252U, AOSG_MOD_TMR6},
+    {253U, 255U, AOSG_MOD_TMRA},
+    {256U, 263U, AOSG_MOD_TMR6},
+    {267U, 268U, AOSG_MOD_TMR6},
+    {269U, 271U, AOSG_MOD_TMRA},
+    {272U, 279U, AOSG_MOD_TMR6},
+    {283U, 284U, AOSG_MOD_TMR6},
+    {285U, 287U, AOSG_MOD_TMRA},
+    {320U, 331U, AOSG_MOD_TMRA},
+    {352U, 363U, AOSG_MOD_TMRA},
+    {401U, 401U, AOSG_MOD_HASH},
+    {408U, 409U, AOSG_MOD_PORT12},
+    {410U, 411U, AOSG_MOD_PORT34},
+    {463U, 463U, AOSG_MOD_OTS},
+    {480U, 483U, AOSG_MOD_ADC1},
+    {484U, 487U, AOSG_MOD_ADC2},
+    {488U, 491U, AOSG_MOD_ADC3},
+};
+
+#define AOSG_RANGE_NUM              (sizeof(m_astcSrcRange) / sizeof(m_astcSrcRange[0]))
+
+/* 只在 AOSG_Describe 中使用 */
+static const char *const m_apcModName[AOSG_MOD_NUM] = {
+    "DMA1", "DMA2", "DMA_RC", "DCU1", "DCU2", "DCU3", "DCU4",
+    "TMR0", "TMR2", "TMR6", "TMRA", "PORT12", "PORT34", "HASH", "OTS",
+    "ADC1", "ADC2", "ADC3",
+};
+
+/**
+ * @brief  查找目标寄存器
+ * @param  [in]  u32Target              AOS_xxx
+ * @retval uint8_t:                     m_astcTarget 序号, 找不到为 0xFF
+ */
+static uint8_t AOSG_FindTarget(uint32_t u32Target) {
+    uint8_t i;
+
+    for (i = 0U; i < AOSG_TARGET_NUM; i++) {
+        if ((uint32_t)m_astcTarget[i].pu32Reg == u32Target) {
+            return i;
+        }
+    }
+
+    return 0xFFU;
+}
+
+/**
+ * @brief  事件由哪个模块产生
+ * @param  [in]  enSrc                  事件
+ * @retval uint8_t:                     AOSG_MOD_xxx, 不是图内可作目标的模块时为 AOSG_MOD_NONE
+ */
+static uint8_t AOSG_SrcModule(en_event_src_t enSrc) {
+    uint8_t i;
+
+    for (i = 0U; i < AOSG_RANGE_NUM; i++) {
+        if ((uint32_t)enSrc < m_astcSrcRange[i].u16Lo) {
+            break;
+        }
+
+        if ((uint32_t)enSrc <= m_astcSrcRange[i].u16Hi) {
+            return m_astcSrcRange[i].u8Mod;
+        }
+    }
+
+    return AOSG_MOD_NONE;
+}
+
+/**
+ * @brief  从一条连线往下的最长级数
+ * @param  [in]  pstcLink               连线表
+ * @param  [in]  u8Num                  连线数
+ * @param  [in]  pstcPlan               检查结果(已确认无回环)
+ * @param  [in]  u8Link                 起始连线
+ * @retval uint8_t:                     级数, 含起始连线
+ */
+static uint8_t AOSG_Depth(const stc_aosg_link_t *pstcLink, uint8_t u8Num, const stc_aosg_plan_t *pstcPlan, uint8_t u8Link) {
+    uint8_t u8Mod = m_astcTarget[pstcPlan->au8Target[u8Link]].u8Mod;
+    uint8_t u8Max = 0U;
+    uint8_t u8Depth;
+    uint8_t i;
+
+    for (i = 0U; i < u8Num; i++) {
+        if (AOSG_SrcModule(pstcLink[i].enSrc) == u8Mod) {
+            u8Depth = AOSG_Depth(pstcLink, u8Num, pstcPlan, i);
+
+            if (u8Depth > u8Max) {
+                u8Max = u8Depth;
+            }
+        }
+    }
+
+    return u8Max + 1U;
+}
+
+/**
+ * @brief  检查连线表并分配输入位置
+ * @param  [in]  pstcLink               连线表
+ * @param  [in]  u8Num                  连线数, 不超过 AOSG_LINK_MAX
+ * @param  [out] pstcPlan               检查结果, 失败时 u8Err/u8ErrLink 指出原因
+ * @retval int32_t:
+ *           - LL_OK:                   可以下发
+ *           - LL_ERR_INVD_PARAM:       目标/源无效或连线重复
+ *           - LL_ERR_BUSY:             公共触发不够
+ *           - LL_ERR:                  模块之间有回环
+ */
+int32_t AOSG_Check(const stc_aosg_link_t *pstcLink, uint8_t u8Num, stc_aosg_plan_t *pstcPlan) {
+    uint32_t au32Adj[AOSG_MOD_NUM] = {0UL};
+    uint32_t u32Used = 0UL;
+    uint32_t u32Left;
+    uint8_t au8In[AOSG_MOD_NUM] = {0U};
+    uint8_t u8SrcMod;
+    uint8_t u8TgtMod;
+    uint8_t u8Progress;
+    uint8_t i;
+    uint8_t j;
+    uint8_t k;
+
+    pstcPlan->aenComm[0] = (en_event_src_t)AOSG_TRGSEL_NONE;
+    pstcPlan->aenComm[1] = (en_event_src_t)AOSG_TRGSEL_NONE;
+    pstcPlan->u8Depth = 0U;
+    pstcPlan->u8Roots = 0U;
+    pstcPlan->u8Err = AOSG_ERR_NONE;
+    pstcPlan->u8ErrLink = 0U;
+
+    if ((NULL == pstcLink) || (0U == u8Num) || (u8Num > AOSG_LINK_MAX)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    for (i = 0U; i < u8Num; i++) {
+        pstcPlan->u8ErrLink = i;
+        pstcPlan->au8Target[i] = AOSG_FindTarget(pstcLink[i].u32Target);
+
+        if (0xFFU == pstcPlan->au8Target[i]) {
+            pstcPlan->u8Err = AOSG_ERR_TARGET;
+            return LL_ERR_INVD_PARAM;
+        }
+
+        if ((uint32_t)pstcLink[i].enSrc >= AOSG_TRGSEL_NONE) {
+            pstcPlan->u8Err = AOSG_ERR_SOURCE;
+            return LL_ERR_INVD_PARAM;
+        }
+
+        /* 同一目标之前已有连线: 本条走公共触发 */
+        pstcPlan->au8Slot[i] = AOSG_SLOT_TRGSEL;
+
+        for (j = 0U; j < i; j++) {
+            if (pstcPlan->au8Target[j] != pstcPlan->au8Target[i]) {
+                continue;
+            }
+
+            if (pstcLink[j].enSrc == pstcLink[i].enSrc) {
+                pstcPlan->u8Err = AOSG_ERR_DUPLICATE;
+                return LL_ERR_INVD_PARAM;
+            }
+
+            pstcPlan->au8Slot[i] = AOSG_SLOT_COMM1;
+        }
+
+        if (AOSG_SLOT_TRGSEL != pstcPlan->au8Slot[i]) {
+            for (k = 0U; k < AOSG_COMM_NUM; k++) {
+                if ((pstcPlan->aenComm[k] == pstcLink[i].enSrc) ||
+                        ((en_event_src_t)AOSG_TRGSEL_NONE == pstcPlan->aenComm[k])) {
+                    break;
+                }
+            }
+
+            if (AOSG_COMM_NUM == k) {
+                pstcPlan->u8Err = AOSG_ERR_COMM_FULL;
+                return LL_ERR_BUSY;
+            }
+
+            /* 同一目标不能两次使能同一个公共触发 */
+            for (j = 0U; j < i; j++) {
+                if ((pstcPlan->au8Target[j] == pstcPlan->au8Target[i]) &&
+                        (pstcPlan->au8Slot[j] == (AOSG_SLOT_COMM1 + k))) {
+                    pstcPlan->u8Err = AOSG_ERR_DUPLICATE;
+                    return LL_ERR_INVD_PARAM;
+                }
+            }
+
+            pstcPlan->aenComm[k] = pstcLink[i].enSrc;
+            pstcPlan->au8Slot[i] = AOSG_SLOT_COMM1 + k;
+        }
+
+        u8SrcMod = AOSG_SrcModule(pstcLink[i].enSrc);
+        u8TgtMod = m_astcTarget[pstcPlan->au8Target[i]].u8Mod;
+        u32Used |= 1UL << u8TgtMod;
+
+        if (AOSG_MOD_NONE != u8SrcMod) {
+            u32Used |= 1UL << u8SrcMod;
+
+            if (0UL == (au32Adj[u8SrcMod] & (1UL << u8TgtMod))) {
+                au32Adj[u8SrcMod] |= 1UL << u8TgtMod;
+                au8In[u8TgtMod]++;
+            }
+        }
+    }
+
+    /* 逐个摘掉没有输入的模块, 摘不完说明有回环 */
+    u32Left = u32Used;
+
+    do {
+        u8Progress = 0U;
+
+        for (i = 0U; i < AOSG_MOD_NUM; i++) {
+            if ((0UL != (u32Left & (1UL << i))) && (0U == au8In[i])) {
+                u32Left &= ~(1UL << i);
+                u8Progress = 1U;
+
+                for (j = 0U; j < AOSG_MOD_NUM; j++) {
+                    if (0UL != (au32Adj[i] & (1UL << j))) {
+                        au8In[j]--;
+                    }
+                }
+            }
+        }
+    } while ((0U != u8Progress) && (0UL != u32Left));
+
+    if (0UL != u32Left) {
+        for (i = 0U; i < u8Num; i++) {
+            if (0UL != (u32Left & (1UL << m_astcTarget[pstcPlan->au8Target[i]].u8Mod))) {
+                pstcPlan->u8ErrLink = i;
+                break;
+            }
+        }
+
+        pstcPlan->u8Err = AOSG_ERR_LOOP;
+        return LL_ERR;
+    }
+
+    for (i = 0U; i < u8Num; i++) {
+        /* 源模块本身被图内连线触发的不是根 */
+        u8SrcMod = AOSG_SrcModule(pstcLink[i].enSrc);
+
+        for (j = 0U; j < u8Num; j++) {
+            if (m_astcTarget[pstcPlan->au8Target[j]].u8Mod == u8SrcMod) {
+                break;
+            }
+        }
+
+        if (j < u8Num) {
+            continue;
+        }
+
+        pstcPlan->u8Roots++;
+        k = AOSG_Depth(pstcLink, u8Num, pstcPlan, i);
+
+        if (k > pstcPlan->u8Depth) {
+            pstcPlan->u8Depth = k;
+        }
+    }
+
+    pstcPlan->u8ErrLink = 0U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  检查并写 AOS 触发选择寄存器
+ * @param  [in]  pstcLink               连线表
+ * @param  [in]  u8Num                  连线数
+ * @param  [out] pstcPlan               检查结果
+ * @retval int32_t:
+ *           - LL_OK:                   已下发, 整条链由硬件传递
+ *           - LL_ERR_BUSY:             公共触发不够, 或寄存器已被其他代码设为别的事件
+ *           - 其余同 AOSG_Check, 此时不写任何寄存器
+ */
+int32_t AOSG_Apply(const stc_aosg_link_t *pstcLink, uint8_t u8Num, stc_aosg_plan_t *pstcPlan) {
+    __IO uint32_t *pu32Reg;
+    uint32_t u32Sel;
+    int32_t i32Ret;
+    uint8_t i;
+
+    i32Ret = AOSG_Check(pstcLink, u8Num, pstcPlan);
+
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_AOS, ENABLE);
+
+    /* 先全部读回检查, 冲突时一个都不写 */
+    for (i = 0U; i < AOSG_COMM_NUM; i++) {
+        pu32Reg = (0U == i) ? &CM_AOS->COMTRG1 : &CM_AOS->COMTRG2;
+        u32Sel = READ_REG32(*pu32Reg) & AOS_COMTRG1_COMTRG;
+
+        if (((en_event_src_t)AOSG_TRGSEL_NONE != pstcPlan->aenComm[i]) &&
+                (AOSG_TRGSEL_NONE != u32Sel) && ((uint32_t)pstcPlan->aenComm[i] != u32Sel)) {
+            pstcPlan->u8Err = AOSG_ERR_OCCUPIED;
+            pstcPlan->u8ErrLink = 0xFFU;
+            return LL_ERR_BUSY;
+        }
+    }
+
+    for (i = 0U; i < u8Num; i++) {
+        if (AOSG_SLOT_TRGSEL != pstcPlan->au8Slot[i]) {
+            continue;
+        }
+
+        u32Sel = READ_REG32(*m_astcTarget[pstcPlan->au8Target[i]].pu32Reg) & AOSG_TRGSEL_MASK;
+
+        if ((AOSG_TRGSEL_NONE != u32Sel) && ((uint32_t)pstcLink[i].enSrc != u32Sel)) {
+            pstcPlan->u8Err = AOSG_ERR_OCCUPIED;
+            pstcPlan->u8ErrLink = i;
+            return LL_ERR_BUSY;
+        }
+    }
+
+    /* 公共触发先选好事件, 目标再使能, 避免使能瞬间选中的是旧事件 */
+    for (i = 0U; i < AOSG_COMM_NUM; i++) {
+        if ((en_event_src_t)AOSG_TRGSEL_NONE != pstcPlan->aenComm[i]) {
+            pu32Reg = (0U == i) ? &CM_AOS->COMTRG1 : &CM_AOS->COMTRG2;
+            WRITE_REG32(*pu32Reg, (uint32_t)pstcPlan->aenComm[i]);
+        }
+    }
+
+    for (i = 0U; i < u8Num; i++) {
+        pu32Reg = m_astcTarget[pstcPlan->au8Target[i]].pu32Reg;
+
+        if (AOSG_SLOT_TRGSEL == pstcPlan->au8Slot[i]) {
+            MODIFY_REG32(*pu32Reg, AOSG_TRGSEL_MASK, (uint32_t)pstcLink[i].enSrc);
+        } else {
+            SET_REG32_BIT(*pu32Reg, 1UL << (AOSG_COMM_EN_POS + pstcPlan->au8Slot[i] - AOSG_SLOT_COMM1));
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  撤销一张已下发的图, 目标寄存器恢复复位值
+ * @param  [in]  pstcLink               连线表
+ * @param  [in]  u8Num                  连线数
+ * @param  [in]  pstcPlan               AOSG_Apply 得到的检查结果
+ * @retval 无
+ */
+void AOSG_Release(const stc_aosg_link_t *pstcLink, uint8_t u8Num, const stc_aosg_plan_t *pstcPlan) {
+    uint8_t i;
+
+    (void)pstcLink;
+
+    for (i = 0U; (i < u8Num) && (i < AOSG_LINK_MAX); i++) {
+        WRITE_REG32(*m_astcTarget[pstcPlan->au8Target[i]].pu32Reg, AOSG_TRGSEL_NONE);
+    }
+
+    if ((en_event_src_t)AOSG_TRGSEL_NONE != pstcPlan->aenComm[0]) {
+        WRITE_REG32(CM_AOS->COMTRG1, AOSG_TRGSEL_NONE);
+    }
+
+    if ((en_event_src_t)AOSG_TRGSEL_NONE != pstcPlan->aenComm[1]) {
+        WRITE_REG32(CM_AOS->COMTRG2, AOSG_TRGSEL_NONE);
+    }
+}
+
+/**
+ * @brief  追加字符串, 超出时截断
+ * @param  [in]  pcBuf                  缓冲
+ * @param  [in]  u32Size                缓冲大小
+ * @param  [in]  u32Pos                 当前长度
+ * @param  [in]  pcStr                  追加内容
+ * @retval uint32_t:                    新长度
+ */
+static uint32_t AOSG_Append(char *pcBuf, uint32_t u32Size, uint32_t u32Pos, const char *pcStr) {
+    while (('\0' != *pcStr) && (u32Pos + 1UL < u32Size)) {
+        pcBuf[u32Pos++] = *pcStr++;
+    }
+
+    pcBuf[u32Pos] = '\0';
+
+    return u32Pos;
+}
+
+/**
+ * @brief  追加 "名称(事件号)"
+ */
+static uint32_t AOSG_AppendSrc(char *pcBuf, uint32_t u32Size, uint32_t u32Pos, en_event_src_t enSrc) {
+    char acNum[6];
+    uint32_t u32Val = (uint32_t)enSrc;
+    uint8_t u8Mod = AOSG_SrcModule(enSrc);
+    uint8_t i = sizeof(acNum) - 1U;
+
+    acNum[i] = '\0';
+
+    do {
+        acNum[--i] = (char)('0' + (u32Val % 10UL));
+        u32Val /= 10UL;
+    } while ((0UL != u32Val) && (i > 0U));
+
+    u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, (AOSG_MOD_NONE == u8Mod) ? "EVT" : m_apcModName[u8Mod]);
+    u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, "(");
+    u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, &acNum[i]);
+
+    return AOSG_Append(pcBuf, u32Size, u32Pos, ")");
+}
+
+/**
+ * @brief  从一条连线往下逐条路径输出
+ * @param  [in]  au8Path                当前路径上的连线
+ * @param  [in]  u8Len                  路径长度(含 u8Link)
+ */
+static uint32_t AOSG_Walk(const stc_aosg_link_t *pstcLink, uint8_t u8Num, const uint8_t *au8Target,
+                          uint8_t *au8Path, uint8_t u8Len, char *pcBuf, uint32_t u32Size, uint32_t u32Pos) {
+    uint8_t u8Mod = m_astcTarget[au8Target[au8Path[u8Len - 1U]]].u8Mod;
+    uint8_t u8Leaf = 1U;
+    uint8_t i;
+
+    for (i = 0U; (i < u8Num) && (u8Len < AOSG_LINK_MAX); i++) {
+        if (AOSG_SrcModule(pstcLink[i].enSrc) == u8Mod) {
+            u8Leaf = 0U;
+            au8Path[u8Len] = i;
+            u32Pos = AOSG_Walk(pstcLink, u8Num, au8Target, au8Path, u8Len + 1U, pcBuf, u32Size, u32Pos);
+        }
+    }
+
+    if (0U != u8Leaf) {
+        for (i = 0U; i < u8Len; i++) {
+            u32Pos = AOSG_AppendSrc(pcBuf, u32Size, u32Pos, pstcLink[au8Path[i]].enSrc);
+            u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, " -> ");
+            u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, m_astcTarget[au8Target[au8Path[i]]].pcName);
+            u32Pos = AOSG_Append(pcBuf, u32Size, u32Pos, (i + 1U < u8Len) ? " => " : "\n");
+        }
+    }
+
+    return u32Pos;
+}
+
+/**
+ * @brief  输出硬件数据流, 每行一条从根事件到末端的路径
+ * @param  [in]  pstcLink               连线表(须已通过 AOSG_Check)
+ * @param  [in]  u8Num                  连线数
+ * @param  [out] pcBuf                  文本, 如 "TMR6(128) -> ADC1_0 => ADC1(480) -> DMA1_0 => DMA1(32) -> DCU1"
+ * @param  [in]  u32Size                缓冲大小
+ * @retval uint32_t:                    文本长度, 0 表示图未通过检查
+ * @note   "=>" 两侧为同一模块: 左边的目标模块产生右边的源事件
+ */
+uint32_t AOSG_Describe(const stc_aosg_link_t *pstcLink, uint8_t u8Num, char *pcBuf, uint32_t u32Size) {
+    stc_aosg_plan_t stcPlan;
+    uint8_t au8Path[AOSG_LINK_MAX];
+    uint32_t u32Pos = 0UL;
+    uint8_t u8SrcMod;
+    uint8_t i;
+    uint8_t j;
+
+    if ((NULL == pcBuf) || (0UL == u32Size)) {
+        return 0UL;
+    }
+
+    pcBuf[0] = '\0';
+
+    if (LL_OK != AOSG_Check(pstcLink, u8Num, &stcPlan)) {
+        return 0UL;
+    }
+
+    for (i = 0U; i < u8Num; i++) {
+        u8SrcMod = AOSG_SrcModule(pstcLink[i].enSrc);
+
+        for (j = 0U; j < u8Num; j++) {
+            if (m_astcTarget[stcPlan.au8Target[j]].u8Mod == u8SrcMod) {
+                break;
+            }
+        }
+
+        if (j == u8Num) {
+            au8Path[0] = i;
+            u32Pos = AOSG_Walk(pstcLink, u8Num, stcPlan.au8Target, au8Path, 1U, pcBuf, u32Size, u32Pos);
+        }
+    }
+
+    return u32Pos;
+}
@@ -0,0 +1,76 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : aos_graph.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : AOS 事件链路图
+                   用"源事件 -> AOS 目标"的连线表描述整条外设链(如定时器比较 -> ADC -> DMA -> DCU),
+                   AOSG_Check 检查目标是否存在、同一目标多路输入能否用公共触发合并、模块之间
+                   有无回环, AOSG_Apply 写 AOS 触发选择寄存器, 此后整条链由硬件传递, 不进中断.
+                   AOSG_Describe 输出每条从根事件到末端的硬件数据流.
+                   离线检查与时延仿真: Tools/aos_graph.py, 连线写法与本模块相同.
+  * Function List:
+                   AOSG_Check
+                   AOSG_Apply
+                   AOSG_Release
+                   AOSG_Describe
+  ******************************************************
+**/
+
+#ifndef __AOS_GRAPH_H_
+#define __AOS_GRAPH_H_
+
+#include "hc32_ll.h"
+
+#define AOSG_LINK_MAX               (16U)       /*!< 一张图最多连线数 */
+#define AOSG_COMM_NUM               (2U)        /*!< 公共触发 COMTRG1/COMTRG2, 全局共用 */
+#define AOSG_TRGSEL_NONE            (0x1FFUL)   /*!< 触发选择复位值, 不选任何事件 */
+
+/* 连线的输入位置 */
+#define AOSG_SLOT_TRGSEL            (0U)        /*!< 目标自己的 TRGSEL */
+#define AOSG_SLOT_COMM1             (1U)        /*!< 经 COMTRG1 */
+#define AOSG_SLOT_COMM2             (2U)        /*!< 经 COMTRG2 */
+
+/* 检查失败原因 */
+#define AOSG_ERR_NONE               (0U)
+#define AOSG_ERR_TARGET             (1U)        /*!< 目标不是 AOS_xxx 之一 */
+#define AOSG_ERR_SOURCE             (2U)        /*!< 源事件超出范围 */
+#define AOSG_ERR_DUPLICATE          (3U)        /*!< 同一连线重复 */
+#define AOSG_ERR_COMM_FULL          (4U)        /*!< 多路输入需要的公共触发超过 2 个 */
+#define AOSG_ERR_LOOP               (5U)        /*!< 模块之间形成回环, 事件会自激 */
+#define AOSG_ERR_OCCUPIED           (6U)        /*!< 寄存器已被其他代码设置(Apply 时检查) */
+
+/**
+ * @brief 一条连线: enSrc 事件发生时触发 u32Target
+ */
+typedef struct {
+    en_event_src_t enSrc;
+    uint32_t u32Target;                 /*!< AOS_DCU1 / AOS_DMA1_0 / AOS_ADC1_0 ... */
+} stc_aosg_link_t;
+
+/**
+ * @brief 检查结果, 也是 Apply 写寄存器的依据
+ */
+typedef struct {
+    uint8_t au8Target[AOSG_LINK_MAX];   /*!< 目标在内部表中的序号 */
+    uint8_t au8Slot[AOSG_LINK_MAX];     /*!< AOSG_SLOT_xxx */
+    en_event_src_t aenComm[AOSG_COMM_NUM];  /*!< 公共触发所选事件, 未用为 AOSG_TRGSEL_NONE */
+    uint8_t u8Depth;                    /*!< 最长链的级数 */
+    uint8_t u8Roots;                    /*!< 根连线数(源事件不由图内模块产生) */
+    uint8_t u8Err;                      /*!< AOSG_ERR_xxx */
+    uint8_t u8ErrLink;                  /*!< 出错的连线序号 */
+} stc_aosg_plan_t;
+
+int32_t AOSG_Check(const stc_aosg_link_t *pstcLink, uint8_t u8Num, stc_aosg_plan_t *pstcPlan);
+int32_t AOSG_Apply(const stc_aosg_link_t *pstcLink, uint8_t u8Num, stc_aosg_plan_t *pstcPlan);
+void AOSG_Release(const stc_aosg_link_t *pstcLink, uint8_t u8Num, const stc_aosg_plan_t *pstcPlan);
+uint32_t AOSG_Describe(const stc_aosg_link_t *pstcLink, uint8_t u8Num, char *pcBuf, uint32_t u32Size);
+
+#endif
@@ -0,0 +1,708 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : cam_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DVP 摄像头采集引擎
+                   1. DVP 的 DMA 请求经 AOS 接到 DMA 通道触发, 每个请求从 DMR 搬一个字;
+                      连线在 Cam_Init 中用 AOSG_Apply 建立;
+                   2. 帧模式: 不用链表, 一次传完一帧后在传输完成中断里切到另一块缓冲,
+                      帧消隐期内完成重装; Cam_Process 正在使用的缓冲不会被 DMA 选中,
+                      两块都不可用时覆盖刚采完的帧并计一次丢帧;
+                   3. 行模式: 两个描述符互相链接(DMA_LLP_WAIT), 相当于 STM32 的双缓冲模式,
+                      每完成一块就把空闲描述符的目的地址改到环里的下一块, DMA 自身不停;
+                      空闲描述符由通道的 LLP 寄存器(下一个要装入的描述符)判断;
+                      环满时改写到丢弃区, 不阻塞 DVP;
+                   4. 每帧结束核对 DMA 位置, 帧长与配置不符时在消隐期重装 DMA;
+                      FIFO 溢出丢了字, 本帧余下的数据整体错位, 作废到帧结束再重装;
+                      DMA 传输错误时通道停下, 帧结束核对位置时按帧长错误重装;
+                   5. 中断只做缓冲调度, 回调都在 Cam_Process(主循环)中执行.
+                   调度逻辑与 STM32_Template/Hardware/cam_capture.c 相同, 后者在主机上有
+                   寄存器模型测试(Tools/cam_pipeline_sim.py), 改动调度时两边同步.
+  * Function List:
+
+  **********************************************************
+ */
+#include "cam_capture.h"
+#include "string.h"
+
+/* 通道的 LLP 寄存器, 各通道寄存器间隔 0x40 */
+#define CAM_DMA_LLP         (*(__IO uint32_t *)((uint32_t)&CAM_DMA->LLP0 + 0x40UL * (uint32_t)CAM_DMA_CH))
+#define CAM_DMA_FLAG_ALL    ((DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << CAM_DMA_CH)
+
+#define CAM_BLOCK_DROP      (0x80U)     /*!< 作废的块, 保持块序号连续, Cam_Process 跳过 */
+
+/* 板级引脚 */
+static const uint8_t m_au8PinPort[] = {GPIO_PORT_A, GPIO_PORT_H, GPIO_PORT_I, GPIO_PORT_H, GPIO_PORT_H,
+                                       GPIO_PORT_H, GPIO_PORT_H, GPIO_PORT_H, GPIO_PORT_I, GPIO_PORT_I,
+                                       GPIO_PORT_I};
+static const uint16_t m_au16Pin[] = {GPIO_PIN_06, GPIO_PIN_08, GPIO_PIN_05, GPIO_PIN_09, GPIO_PIN_10,
+                                     GPIO_PIN_11, GPIO_PIN_12, GPIO_PIN_14, GPIO_PIN_04, GPIO_PIN_06,
+                                     GPIO_PIN_07};
+
+static uint8_t m_u8Init = 0U;
+static stc_aosg_link_t m_stcLink;
+static stc_aosg_plan_t m_stcPlan;
+static Cam_Config m_stcCfg;
+static Cam_Stats m_stcStats;
+static uint32_t m_u32BlockBytes;
+static uint32_t m_u32XferWords;                 /*!< 一次 DMA 传输的字数: 帧模式一帧, 行模式一块 */
+static volatile uint8_t m_u8Skip;               /*!< FIFO 溢出后到帧结束前写满的数据作废 */
+static volatile uint8_t m_u8Snap;               /*!< 帧进行中收到的快照请求, 帧结束时补发 */
+
+/* 帧模式 */
+static int8_t m_i8Filling;                      /*!< DMA 正在写的缓冲 */
+static volatile int8_t m_i8Ready;               /*!< 最新完整帧, -1 为无; 只由中断写 */
+static volatile uint32_t m_u32ReadySeq;
+static volatile int8_t m_i8Held;                /*!< Cam_Process 正在使用的缓冲; 只由 Cam_Process 写 */
+static volatile uint32_t m_u32TakenSeq;         /*!< 最后交付的帧序号; 只由 Cam_Process 写 */
+
+/* 行模式: 块按编程顺序写完, m_u32Prog/m_u32Head/m_u32Tail 都是块序号(不取模) */
+static Cam_Block m_astcBlock[CAM_RING_MAX];
+static stc_dma_llp_descriptor_t m_astcDesc[2];
+static uint32_t m_u32Prog;                      /*!< 已编程给 DMA 的块 */
+static volatile uint32_t m_u32Head;             /*!< 已写满的块; 只由中断写 */
+static volatile uint32_t m_u32Tail;             /*!< 已处理的块; 只由 Cam_Process 写 */
+static uint8_t m_au8Target[2];                  /*!< 两个描述符当前指向的块, RingBlocks 为丢弃区 */
+static uint16_t m_u16Line;                      /*!< 本帧已写入的行 */
+static uint32_t m_u32Frame;
+static uint8_t m_u8Gap;
+
+static uint8_t *Cam_BlockAddr(uint8_t u8Block) {
+    return m_stcCfg.Ring + (uint32_t)u8Block * m_u32BlockBytes;
+}
+
+/* 描述符的通道控制字, 与 Cam_Init 中 DMA_Init + DMA_LlpInit 写入的一致 */
+static void Cam_SetDesc(uint8_t u8Desc) {
+    stc_dma_llp_descriptor_t *pstcDesc = &m_astcDesc[u8Desc];
+
+    pstcDesc->SARx = (uint32_t)&CM_DVP->DMR;
+    pstcDesc->DARx = (uint32_t)Cam_BlockAddr(m_au8Target[u8Desc]);
+    pstcDesc->DTCTLx = 1UL | (m_u32XferWords << DMA_DTCTL_CNT_POS);
+    pstcDesc->RPTx = 0UL;
+    pstcDesc->SNSEQCTLx = 0UL;
+    pstcDesc->DNSEQCTLx = 0UL;
+    pstcDesc->LLPx = (uint32_t)&m_astcDesc[u8Desc ^ 1U];
+    pstcDesc->CHCTLx = DMA_SRC_ADDR_FIX | DMA_DEST_ADDR_INC | DMA_DATAWIDTH_32BIT | DMA_INT_ENABLE |
+                       DMA_LLP_ENABLE | DMA_LLP_WAIT;
+}
+
+/* 行模式下空闲的描述符: LLP 寄存器指向下一个要装入的描述符 */
+static uint8_t Cam_IdleDesc(void) {
+    return (CAM_DMA_LLP == (uint32_t)&m_astcDesc[1]) ? 1U : 0U;
+}
+
+/**
+ * @brief  取环中下一块给 DMA
+ * @param  无
+ * @retval uint8_t:                     块号, 环满时为丢弃区
+ * @note   序号在 [m_u32Tail, m_u32Prog) 的块还没处理完, 个数不到 RingBlocks 时
+ *         m_u32Prog 对应的块一定空闲.
+ */
+static uint8_t Cam_NextBlock(void) {
+    uint8_t u8Block;
+
+    if ((m_u32Prog - m_u32Tail) >= m_stcCfg.RingBlocks) {
+        return m_stcCfg.RingBlocks;
+    }
+
+    u8Block = (uint8_t)(m_u32Prog % m_stcCfg.RingBlocks);
+    m_u32Prog++;
+    return u8Block;
+}
+
+/**
+ * @brief  关闭 DMA 通道并等待生效
+ * @param  无
+ * @retval 无
+ * @note   重新使能前该通道的完成和错误标志都要清除.
+ */
+static void Cam_DMAStop(void) {
+    (void)DMA_ChCmd(CAM_DMA, CAM_DMA_CH, DISABLE);
+
+    while (SET == DMA_GetTransStatus(CAM_DMA, DMA_STAT_TRANS_CH0 << CAM_DMA_CH)) {
+    }
+
+    DMA_ClearTransCompleteStatus(CAM_DMA, CAM_DMA_FLAG_ALL);
+    DMA_ClearErrStatus(CAM_DMA, (DMA_FLAG_TRANS_ERR_CH0 | DMA_FLAG_REQ_ERR_CH0) << CAM_DMA_CH);
+}
+
+/**
+ * @brief  从头装载 DMA, 调用前通道已关闭
+ * @param  无
+ * @retval 无
+ * @note   帧模式写 m_i8Filling; 行模式通道先写 m_au8Target[0], LLP 指向描述符 1.
+ */
+static void Cam_DMAArm(void) {
+    if (CAM_MODE_FRAME == m_stcCfg.Mode) {
+        (void)DMA_SetDestAddr(CAM_DMA, CAM_DMA_CH, (uint32_t)m_stcCfg.Frame[m_i8Filling]);
+    } else {
+        Cam_SetDesc(0U);
+        Cam_SetDesc(1U);
+        (void)DMA_SetDestAddr(CAM_DMA, CAM_DMA_CH, m_astcDesc[0].DARx);
+        DMA_SetLlpAddr(CAM_DMA, CAM_DMA_CH, (uint32_t)&m_astcDesc[1]);
+    }
+
+    (void)DMA_SetTransCount(CAM_DMA, CAM_DMA_CH, (uint16_t)m_u32XferWords);
+    (void)DMA_ChCmd(CAM_DMA, CAM_DMA_CH, ENABLE);
+}
+
+/**
+ * @brief  登记一个中断源
+ * @param  [in]  enSrc                  中断源
+ * @param  [in]  enIRQn                 INT000~031
+ * @param  [in]  pfnCallback            处理函数
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_BUSY:             enIRQn 已被其他代码占用
+ */
+static int32_t Cam_IrqSignIn(en_int_src_t enSrc, IRQn_Type enIRQn, func_ptr_t pfnCallback) {
+    stc_irq_signin_config_t stcIrq;
+
+    stcIrq.enIntSrc = enSrc;
+    stcIrq.enIRQn = enIRQn;
+    stcIrq.pfnCallback = pfnCallback;
+    if (LL_OK != INTC_IrqSignIn(&stcIrq)) {
+        return LL_ERR_BUSY;
+    }
+
+    NVIC_ClearPendingIRQ(enIRQn);
+    NVIC_SetPriority(enIRQn, CAM_IRQ_PRIO);
+    NVIC_EnableIRQ(enIRQn);
+    return LL_OK;
+}
+
+static void Cam_IrqSignOut(void) {
+    (void)INTC_IrqSignOut(CAM_DMA_IRQn);
+    (void)INTC_IrqSignOut(CAM_DVP_IRQn);
+    (void)INTC_IrqSignOut(CAM_OVF_IRQn);
+}
+
+/**
+ * @brief  初始化引脚、DVP、DMA 和 AOS 连线, 登记 DMA 与 DVP 中断
+ * @param  [in]  Config                 采集配置, 内容被复制
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       配置不合法
+ *           - LL_ERR_BUSY:             DMA 通道的触发选择或中断号已被其他代码占用
+ * @note   Cam_DMA_IRQHandler / Cam_DVP_IRQHandler 在这里用 INTC_IrqSignIn 登记, 不需要在中断向量中调用.
+ *         三个中断同一优先级, 互不嵌套. 重复调用时先释放上一次的连线和中断.
+ */
+int32_t Cam_Init(const Cam_Config *Config) {
+    stc_gpio_init_t stcGpio;
+    stc_dvp_init_t stcDvp;
+    stc_dvp_crop_window_config_t stcCrop;
+    stc_dma_init_t stcDma;
+    stc_dma_llp_init_t stcLlp;
+    uint32_t u32LineBytes;
+    uint32_t i;
+    int32_t i32Ret;
+
+    u32LineBytes = (uint32_t)Config->Width * Config->BytesPerPixel;
+
+    if ((0U == Config->Width) || (0U == Config->Height) || (0UL != (u32LineBytes & 3UL)) ||
+            ((1U != Config->BytesPerPixel) && (2U != Config->BytesPerPixel))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (CAM_MODE_FRAME == Config->Mode) {
+        m_u32XferWords = u32LineBytes * Config->Height / 4UL;
+
+        if ((NULL == Config->Frame[0]) || (NULL == Config->Frame[1]) || (NULL == Config->FrameCallback) ||
+                (0UL != (((uint32_t)Config->Frame[0] | (uint32_t)Config->Frame[1]) & 3UL))) {
+            return LL_ERR_INVD_PARAM;
+        }
+    } else if (CAM_MODE_LINES == Config->Mode) {
+        if ((0U == Config->LinesPerBlock) || (0U != (Config->Height % Config->LinesPerBlock)) ||
+                (Config->RingBlocks < 3U) || (Config->RingBlocks > CAM_RING_MAX) ||
+                (NULL == Config->Ring) || (0UL != ((uint32_t)Config->Ring & 3UL)) ||
+                (NULL == Config->LineCallback)) {
+            return LL_ERR_INVD_PARAM;
+        }
+
+        m_u32XferWords = u32LineBytes * Config->LinesPerBlock / 4UL;
+    } else {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (m_u32XferWords > 0xFFFFUL) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    /* 裁剪窗口以像素时钟为单位, 8 位接口每个时钟一个字节 */
+    if ((0U != Config->Crop) && ((u32LineBytes > 0x3FFFUL) || (Config->Height < 4U) ||
+                                 (((uint32_t)Config->CropX * Config->BytesPerPixel) > 0x3FFFUL) ||
+                                 (Config->CropY > 0x3FFFU))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (0U != m_u8Init) {
+        Cam_Stop();
+        Cam_IrqSignOut();
+        AOSG_Release(&m_stcLink, 1U, &m_stcPlan);
+        m_u8Init = 0U;
+    }
+
+    m_stcCfg = *Config;
+    m_u32BlockBytes = m_u32XferWords * 4UL;
+
+    for (i = 0UL; (i < m_stcCfg.RingBlocks) && (CAM_MODE_LINES == m_stcCfg.Mode); i++) {
+        m_astcBlock[i].Data = Cam_BlockAddr((uint8_t)i);
+        m_astcBlock[i].Lines = m_stcCfg.LinesPerBlock;
+    }
+
+    FCG_Fcg0PeriphClockCmd(CAM_DMA_FCG, ENABLE);
+    FCG_Fcg3PeriphClockCmd(FCG3_PERIPH_DVP, ENABLE);
+
+    (void)GPIO_StructInit(&stcGpio);
+    stcGpio.u16PinDrv = PIN_HIGH_DRV;
+    for (i = 0UL; i < sizeof(m_au16Pin) / sizeof(m_au16Pin[0]); i++) {
+        (void)GPIO_Init(m_au8PinPort[i], m_au16Pin[i], &stcGpio);
+        GPIO_SetFunc(m_au8PinPort[i], m_au16Pin[i], GPIO_FUNC_13);
+    }
+
+    DVP_DeInit();
+    (void)DVP_StructInit(&stcDvp);
+    stcDvp.u32SyncMode = DVP_SYNC_MD_HW;
+    stcDvp.u32DataWidth = DVP_DATA_WIDTH_8BIT;
+    stcDvp.u32CaptureMode = (0U != m_stcCfg.Snapshot) ? DVP_CAPT_MD_SINGLE_FRAME : DVP_CAPT_MD_CONTINUOS_FRAME;
+    stcDvp.u32CaptureFreq = DVP_CAPT_FREQ_ALL_FRAME;
+    stcDvp.u32PIXCLKPolarity = m_stcCfg.PCKPolarity;
+    stcDvp.u32HSYNCPolarity = m_stcCfg.HSPolarity;
+    stcDvp.u32VSYNCPolarity = m_stcCfg.VSPolarity;
+    (void)DVP_Init(&stcDvp);
+
+    if (0U != m_stcCfg.Crop) {
+        stcCrop.u16RowStartLine = m_stcCfg.CropY;
+        stcCrop.u16ColoumStartLine = (uint16_t)(m_stcCfg.CropX * m_stcCfg.BytesPerPixel);
+        stcCrop.u16RowLineSize = m_stcCfg.Height;
+        stcCrop.u16ColoumLineSize = (uint16_t)u32LineBytes;
+        (void)DVP_CropWindowConfig(&stcCrop);
+        DVP_CropCmd(ENABLE);
+    }
+
+    DMA_Cmd(CAM_DMA, ENABLE);
+    (void)DMA_ChCmd(CAM_DMA, CAM_DMA_CH, DISABLE);
+    DMA_DeInit(CAM_DMA, CAM_DMA_CH);
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = DMA_INT_ENABLE;
+    stcDma.u32SrcAddr = (uint32_t)&CM_DVP->DMR;
+    stcDma.u32DestAddr = (CAM_MODE_FRAME == m_stcCfg.Mode) ? (uint32_t)m_stcCfg.Frame[0] : (uint32_t)m_stcCfg.Ring;
+    stcDma.u32DataWidth = DMA_DATAWIDTH_32BIT;
+    stcDma.u32BlockSize = 1UL;
+    stcDma.u32TransCount = m_u32XferWords;
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_INC;
+    (void)DMA_Init(CAM_DMA, CAM_DMA_CH, &stcDma);
+
+    if (CAM_MODE_LINES == m_stcCfg.Mode) {
+        (void)DMA_LlpStructInit(&stcLlp);
+        stcLlp.u32State = DMA_LLP_ENABLE;
+        stcLlp.u32Mode = DMA_LLP_WAIT;
+        stcLlp.u32Addr = (uint32_t)&m_astcDesc[1];
+        (void)DMA_LlpInit(CAM_DMA, CAM_DMA_CH, &stcLlp);
+    }
+
+    DMA_TransCompleteIntCmd(CAM_DMA, DMA_INT_BTC_CH0 << CAM_DMA_CH, DISABLE);
+    DMA_TransCompleteIntCmd(CAM_DMA, DMA_INT_TC_CH0 << CAM_DMA_CH, ENABLE);
+
+    m_stcLink.enSrc = EVT_SRC_DVP_DMAREQ;
+    m_stcLink.u32Target = ((CM_DMA1 == CAM_DMA) ? AOS_DMA1_0 : AOS_DMA2_0) + 4UL * (uint32_t)CAM_DMA_CH;
+    if (LL_OK != AOSG_Apply(&m_stcLink, 1U, &m_stcPlan)) {
+        return LL_ERR_BUSY;
+    }
+
+    /* 登记失败时只注销本模块已登记的中断号 */
+    i32Ret = Cam_IrqSignIn((en_int_src_t)((uint32_t)CAM_DMA_INT_SRC + (uint32_t)CAM_DMA_CH), CAM_DMA_IRQn,
+                           &Cam_DMA_IRQHandler);
+    if (LL_OK == i32Ret) {
+        i32Ret = Cam_IrqSignIn(INT_SRC_DVP_FRAMEND, CAM_DVP_IRQn, &Cam_DVP_IRQHandler);
+        if (LL_OK != i32Ret) {
+            (void)INTC_IrqSignOut(CAM_DMA_IRQn);
+        }
+    }
+    if (LL_OK == i32Ret) {
+        i32Ret = Cam_IrqSignIn(INT_SRC_DVP_FIFOERR, CAM_OVF_IRQn, &Cam_DVP_IRQHandler);
+        if (LL_OK != i32Ret) {
+            (void)INTC_IrqSignOut(CAM_DMA_IRQn);
+            (void)INTC_IrqSignOut(CAM_DVP_IRQn);
+        }
+    }
+    if (LL_OK != i32Ret) {
+        AOSG_Release(&m_stcLink, 1U, &m_stcPlan);
+        return i32Ret;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    m_u8Init = 1U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  复位缓冲调度并开始采集
+ * @param  无
+ * @retval 无
+ * @note   连续模式从下一个 VSYNC 开始采集; 快照模式只装好 DMA, 等 Cam_Snapshot.
+ */
+void Cam_Start(void) {
+    if (0U == m_u8Init) {
+        return;
+    }
+
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+    m_i8Filling = 0;
+    m_i8Ready = -1;
+    m_u32ReadySeq = 0UL;
+    m_i8Held = -1;
+    m_u32TakenSeq = 0UL;
+    m_u32Prog = 0UL;
+    m_u32Head = 0UL;
+    m_u32Tail = 0UL;
+    m_u16Line = 0U;
+    m_u32Frame = 0UL;
+    m_u8Gap = 0U;
+    m_u8Skip = 0U;
+    m_u8Snap = 0U;
+
+    if (CAM_MODE_LINES == m_stcCfg.Mode) {
+        m_au8Target[0] = Cam_NextBlock();
+        m_au8Target[1] = Cam_NextBlock();
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+
+    DVP_ClearStatus(DVP_FLAG_FRAME_END | DVP_FLAG_FIFO_OVF);
+    DVP_IntCmd(DVP_INT_FRAME_END | DVP_INT_FIFO_OVF, ENABLE);
+    DVP_Cmd(ENABLE);
+
+    if (0U == m_stcCfg.Snapshot) {
+        DVP_CaptrueCmd(ENABLE);
+    }
+}
+
+/**
+ * @brief  立即停止采集, 可再次 Cam_Start
+ * @param  无
+ * @retval 无
+ */
+void Cam_Stop(void) {
+    if (0U == m_u8Init) {
+        return;
+    }
+
+    DVP_CaptrueCmd(DISABLE);
+    DVP_IntCmd(DVP_INT_FRAME_END | DVP_INT_FIFO_OVF, DISABLE);
+    DVP_Cmd(DISABLE);
+    Cam_DMAStop();
+}
+
+/**
+ * @brief  快照模式下采集下一帧
+ * @param  无
+ * @retval 无
+ * @note   DVP 等到下一个 VSYNC 开始, 一帧结束后自动清除 CAPEN.
+ *         裁剪时最后一块在帧结束前就已交付, 此时 CAPEN 仍置位, 直接置位会被帧结束清掉,
+ *         所以记下请求由帧结束中断补发. 检查期间屏蔽帧结束中断.
+ */
+void Cam_Snapshot(void) {
+    DVP_IntCmd(DVP_INT_FRAME_END, DISABLE);
+
+    if (0UL != READ_REG32_BIT(CM_DVP->CTR, DVP_CTR_CAPEN)) {
+        m_u8Snap = 1U;
+    } else {
+        DVP_CaptrueCmd(ENABLE);
+    }
+
+    DVP_IntCmd(DVP_INT_FRAME_END, ENABLE);
+}
+
+/**
+ * @brief  本次传输是否含溢出后的错位数据
+ * @param  无
+ * @retval uint8_t:                     1: 作废
+ * @note   传输完成中断先于 DVP 溢出中断处理时 m_u8Skip 还没置位, 直接看溢出标志.
+ */
+static uint8_t Cam_Corrupted(void) {
+    return ((0U != m_u8Skip) || (SET == DVP_GetStatus(DVP_FLAG_FIFO_OVF))) ? 1U : 0U;
+}
+
+/**
+ * @brief  帧模式: 一帧传完, 选下一块缓冲并重装 DMA
+ * @param  无
+ * @retval 无
+ * @note   另一块正被 Cam_Process 使用时只能覆盖刚采完的这块(丢弃它);
+ *         否则写另一块, 若那块是尚未交付的旧帧则它被丢弃. 溢出作废的帧原地重写.
+ */
+static void Cam_FrameDone(void) {
+    int8_t i8Done = m_i8Filling;
+    int8_t i8Other = i8Done ^ 1;
+
+    m_stcStats.Frames++;
+
+    if ((m_i8Held == i8Other) || (0U != Cam_Corrupted())) {
+        m_stcStats.FramesDropped++;
+    } else {
+        if ((m_i8Ready == i8Other) && (m_u32ReadySeq != m_u32TakenSeq)) {
+            m_stcStats.FramesDropped++;
+        }
+
+        m_u32ReadySeq = m_stcStats.Frames;
+        m_i8Ready = i8Done;
+        m_i8Filling = i8Other;
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+}
+
+/**
+ * @brief  行模式: 一块写满, 登记并把空闲描述符改到下一块
+ * @param  无
+ * @retval 无
+ * @note   DMA 已装入另一个描述符, 刚写满的是空闲描述符指向的块, 改写它不影响当前传输.
+ *         溢出作废的块照常登记(块按编程顺序写满), 带 CAM_BLOCK_DROP, 由 Cam_Process 跳过.
+ */
+static void Cam_BlockDone(void) {
+    uint8_t u8Idle = Cam_IdleDesc();
+    uint8_t u8Done = m_au8Target[u8Idle];
+    uint8_t u8Flags = (0U == m_u16Line) ? CAM_BLOCK_FIRST : 0U;
+    uint8_t u8Bad = Cam_Corrupted();
+    uint32_t u32Backlog;
+
+    m_u16Line += m_stcCfg.LinesPerBlock;
+
+    if (m_u16Line >= m_stcCfg.Height) {
+        u8Flags |= CAM_BLOCK_LAST;
+    }
+
+    if (u8Done < m_stcCfg.RingBlocks) {
+        m_astcBlock[u8Done].Frame = m_u32Frame;
+        m_astcBlock[u8Done].Line = (uint16_t)(m_u16Line - m_stcCfg.LinesPerBlock);
+        m_astcBlock[u8Done].Flags = (0U != u8Bad) ? CAM_BLOCK_DROP :
+                                    (uint8_t)(u8Flags | ((0U != m_u8Gap) ? CAM_BLOCK_GAP : 0U));
+        m_u32Head++;
+        u32Backlog = m_u32Head - m_u32Tail;
+
+        if (u32Backlog > m_stcStats.MaxBacklog) {
+            m_stcStats.MaxBacklog = u32Backlog;
+        }
+    }
+
+    if ((u8Done >= m_stcCfg.RingBlocks) || (0U != u8Bad)) {
+        m_stcStats.BlocksDropped++;
+
+        if (0U == m_u8Gap) {
+            m_stcStats.FramesDropped++;
+        }
+
+        m_u8Gap = 1U;
+    }
+
+    if (0U != (u8Flags & CAM_BLOCK_LAST)) {
+        m_stcStats.Frames++;
+        m_u32Frame++;
+        m_u16Line = 0U;
+        m_u8Gap = 0U;
+    }
+
+    m_au8Target[u8Idle] = Cam_NextBlock();
+    m_astcDesc[u8Idle].DARx = (uint32_t)Cam_BlockAddr(m_au8Target[u8Idle]);
+}
+
+/**
+ * @brief  DMA 传输完成中断, 由 Cam_Init 登记到 CAM_DMA_IRQn
+ * @param  无
+ * @retval 无
+ */
+void Cam_DMA_IRQHandler(void) {
+    if (RESET == DMA_GetTransCompleteStatus(CAM_DMA, DMA_FLAG_TC_CH0 << CAM_DMA_CH)) {
+        return;
+    }
+
+    DMA_ClearTransCompleteStatus(CAM_DMA, CAM_DMA_FLAG_ALL);
+
+    if (CAM_MODE_FRAME == m_stcCfg.Mode) {
+        Cam_FrameDone();
+    } else {
+        Cam_BlockDone();
+    }
+}
+
+/**
+ * @brief  DVP 帧结束和 FIFO 溢出中断, 由 Cam_Init 登记到 CAM_DVP_IRQn / CAM_OVF_IRQn
+ * @param  无
+ * @retval 无
+ * @note   帧结束时 DMA 应该刚好传完(最多还差 FIFO 中的几个字, 其完成中断随后到来)
+ *         或已经重装好等下一帧; 其他位置说明帧比配置短或长(或 DMA 因传输错误停下),
+ *         此时处于消隐期, 关掉 DMA 从本帧开头重装. 行模式下已交付的块保留, 下一块带 CAM_BLOCK_FIRST.
+ *         先处理挂起的传输完成再核对位置. 本帧溢出过时不核对, 直接重装;
+ *         重装时关一下 DVP 清空其 FIFO, 否则上一帧残留的字会写到新缓冲开头.
+ */
+void Cam_DVP_IRQHandler(void) {
+    uint32_t u32Remain;
+    uint8_t u8Ok;
+    uint8_t u8Cur;
+    uint8_t u8First;
+
+    if (SET == DVP_GetStatus(DVP_FLAG_FIFO_OVF)) {
+        DVP_ClearStatus(DVP_FLAG_FIFO_OVF);
+        m_stcStats.Overflows++;
+        m_u8Skip = 1U;
+    }
+
+    if (RESET == DVP_GetStatus(DVP_FLAG_FRAME_END)) {
+        return;
+    }
+
+    DVP_ClearStatus(DVP_FLAG_FRAME_END);
+
+    if (0U != m_u8Snap) {
+        m_u8Snap = 0U;
+        DVP_CaptrueCmd(ENABLE);
+    }
+
+    if (SET == DMA_GetTransCompleteStatus(CAM_DMA, DMA_FLAG_TC_CH0 << CAM_DMA_CH)) {
+        Cam_DMA_IRQHandler();
+    }
+
+    u32Remain = DMA_GetTransCount(CAM_DMA, CAM_DMA_CH);
+
+    if (CAM_MODE_FRAME == m_stcCfg.Mode) {
+        u8Ok = ((u32Remain == m_u32XferWords) || (u32Remain <= CAM_FIFO_WORDS)) ? 1U : 0U;
+    } else {
+        u8Ok = (((0U == m_u16Line) && (u32Remain == m_u32XferWords)) ||
+                ((m_u16Line == (m_stcCfg.Height - m_stcCfg.LinesPerBlock)) && (u32Remain <= CAM_FIFO_WORDS))) ? 1U : 0U;
+    }
+
+    if (SET == DMA_GetErrStatus(CAM_DMA, DMA_FLAG_TRANS_ERR_CH0 << CAM_DMA_CH)) {
+        u8Ok = 0U;
+    }
+
+    if ((0U != u8Ok) && (0U == m_u8Skip)) {
+        return;
+    }
+
+    if (0U == m_u8Skip) {
+        m_stcStats.SyncErrors++;
+    }
+
+    DVP_Cmd(DISABLE);
+    Cam_DMAStop();
+
+    if (CAM_MODE_LINES == m_stcCfg.Mode) {
+        /* 先编程的块放描述符 0, 保持块按编程顺序写满 */
+        u8Cur = Cam_IdleDesc() ^ 1U;
+        u8First = m_au8Target[u8Cur];
+
+        m_au8Target[1] = m_au8Target[u8Cur ^ 1U];
+        m_au8Target[0] = u8First;
+
+        if ((0U == m_u8Gap) && ((0U != m_u16Line) || (0U != m_u8Skip))) {
+            m_stcStats.FramesDropped++;
+        }
+
+        m_u16Line = 0U;
+        m_u8Gap = 0U;
+        m_u32Frame++;
+    }
+
+    m_u8Skip = 0U;
+    Cam_DMAArm();
+    DVP_Cmd(ENABLE);
+}
+
+/**
+ * @brief  把已采集的数据交给回调, 在主循环中调用
+ * @param  无
+ * @retval uint32_t:                    交付的帧数(帧模式, 0 或 1)或块数(行模式)
+ * @note   帧模式: 先登记 m_i8Held 再复查 m_i8Ready, 中断若在两者之间把这块选作 DMA 目标,
+ *         复查会发现 m_i8Ready 已变并重试; 登记之后中断不会再选它.
+ *         行模式: 回调返回后该块才归还, 回调期间 DMA 写的是环里的其他块;
+ *         只处理进入时已写满的块, 回调比传感器慢时也能回到主循环.
+ */
+uint32_t Cam_Process(void) {
+    uint32_t u32Num = 0UL;
+    uint32_t u32Start;
+    uint32_t u32Cycles;
+    uint32_t u32Seq;
+    uint32_t u32Head;
+    int8_t i8Buf;
+
+    if (0U == m_u8Init) {
+        return 0UL;
+    }
+
+    if (CAM_MODE_FRAME == m_stcCfg.Mode) {
+        for (;;) {
+            i8Buf = m_i8Ready;
+            u32Seq = m_u32ReadySeq;
+
+            if ((i8Buf < 0) || (u32Seq == m_u32TakenSeq)) {
+                return 0UL;
+            }
+
+            m_i8Held = i8Buf;
+
+            if ((m_i8Ready == i8Buf) && (m_u32ReadySeq == u32Seq)) {
+                break;
+            }
+
+            m_i8Held = -1;
+        }
+
+        u32Start = DWT->CYCCNT;
+        m_stcCfg.FrameCallback(m_stcCfg.Frame[i8Buf], u32Seq);
+        u32Cycles = DWT->CYCCNT - u32Start;
+        m_u32TakenSeq = u32Seq;
+        m_i8Held = -1;
+        u32Num = 1UL;
+    } else {
+        u32Start = DWT->CYCCNT;
+        u32Head = m_u32Head;
+
+        while (m_u32Tail != u32Head) {
+            if (0U == (m_astcBlock[m_u32Tail % m_stcCfg.RingBlocks].Flags & CAM_BLOCK_DROP)) {
+                m_stcCfg.LineCallback(&m_astcBlock[m_u32Tail % m_stcCfg.RingBlocks]);
+                u32Num++;
+            }
+
+            m_u32Tail++;
+        }
+
+        if (0UL == u32Num) {
+            return 0UL;
+        }
+
+        u32Cycles = DWT->CYCCNT - u32Start;
+    }
+
+    m_stcStats.Delivered += u32Num;
+    m_stcStats.LastCycles = u32Cycles;
+
+    if (u32Cycles > m_stcStats.MaxCycles) {
+        m_stcStats.MaxCycles = u32Cycles;
+    }
+
+    return u32Num;
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] Stats                  输出
+ * @retval 无
+ */
+void Cam_GetStats(Cam_Stats *Stats) {
+    *Stats = m_stcStats;
+}
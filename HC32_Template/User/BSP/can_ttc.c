@@ -0,0 +1,384 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_ttc.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TTCAN 调度引擎
+                   1. CAN 需先用 CAN_Init 初始化, 且 TTCAN 发送缓冲区为全 TTCAN 模式
+                      (u8TxBufMode = CAN_TTC_TX_BUF_MD_TTCAN), PTB 和 STB1~3 共 4 个
+                      缓冲区轮流使用;
+                   2. 硬件同一时刻只有一个触发器: 每次时间触发中断里装载下一个时隙的
+                      触发, 并保证后面 TTCAN_FILL_AHEAD 个发送时隙的帧已写入缓冲区;
+                   3. 基本周期最后一个时隙触发后等待参考报文, 由 TTCAN_CycleStart
+                      装载新周期的第一个触发.
+                   CAN 的中断源只有一个, 本模块不登记中断, 由用户在 CAN 中断回调中
+                   调用 TTCAN_IrqHandler, 收到/发出参考报文时调用 TTCAN_CycleStart.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_ttc.h"
+#include "string.h"
+
+#define TTCAN_TX_BUF_NUM            (4U)        /* PTB + STB1~3 */
+
+typedef struct {
+    stc_can_tx_frame_t astcFrame[2];
+    volatile uint8_t u8Active;
+} stc_ttcan_msg_t;
+
+static const uint8_t m_au8DlcSize[16U] = {
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+static const uint16_t m_au16TrigType[4U] = {
+    CAN_TTC_TRIG_SINGLESHOT_TX_TRIG,
+    CAN_TTC_TRIG_TX_START_TRIG,
+    CAN_TTC_TRIG_TX_STOP_TRIG,
+    CAN_TTC_TRIG_TIME_TRIG
+};
+
+static CM_CAN_TypeDef *m_pstcCan;
+static const stc_ttcan_matrix_t *m_pstcMatrix;
+static stc_ttcan_msg_t m_astcMsg[TTCAN_MSG_MAX];
+static stc_ttcan_stats_t m_stcStats;
+
+/* 调度位置 = 基本周期序号 * 时隙数 + 时隙序号 */
+static uint16_t m_u16PosNum;
+static uint16_t m_u16TrigPos;       /* 已装载(或等待参考报文)的触发 */
+static uint16_t m_u16FillPos;       /* 最后一个已写入缓冲区的发送时隙 */
+static uint8_t m_u8TrigBuf;         /* 下一个发送触发使用的缓冲区 */
+static uint8_t m_u8FillBuf;         /* 下一个写入的缓冲区 */
+static uint8_t m_u8LastTxBuf;       /* 最近一个发送触发的缓冲区, 合并窗口结束触发用 */
+static uint8_t m_u8Ahead;           /* 已写入但尚未触发的发送时隙数 */
+static uint8_t m_u8HasTx;
+static uint8_t m_u8WaitRef;
+
+/**
+ * @brief  检查调度矩阵
+ * @param  [in]  pstcMatrix             调度矩阵
+ * @param  [out] pu16ErrSlot            出错的时隙序号, 矩阵参数错误时为 0xFFFF, 可为 NULL
+ * @retval int32_t:
+ *           - LL_OK:                   矩阵合法, 各周期内时隙不重叠
+ *           - LL_ERR_INVD_PARAM:       参数错误或时隙重叠
+ * @note   取出各报文的格式后由 TTCAN_SchedCheck 检查, 规则见 can_ttc_sched.c.
+ *         可在目标板上初始化前调用; 离线检查矩阵时在主机上编译 can_ttc_sched.c.
+ */
+int32_t TTCAN_CheckMatrix(const stc_ttcan_matrix_t *pstcMatrix, uint16_t *pu16ErrSlot) {
+    stc_ttcan_frame_fmt_t astcFmt[TTCAN_MSG_MAX];
+    stc_ttcan_sched_t stcSched;
+    uint8_t i;
+    int32_t i32Ret = LL_ERR_INVD_PARAM;
+
+    if ((pstcMatrix != NULL) && (pstcMatrix->u8MsgNum <= TTCAN_MSG_MAX) &&
+            ((pstcMatrix->u8MsgNum == 0U) || (pstcMatrix->pstcMsg != NULL))) {
+        for (i = 0U; i < pstcMatrix->u8MsgNum; i++) {
+            astcFmt[i].u8Dlc = (uint8_t)pstcMatrix->pstcMsg[i].DLC;
+            astcFmt[i].u8Ide = (uint8_t)pstcMatrix->pstcMsg[i].IDE;
+            astcFmt[i].u8Fdf = (uint8_t)pstcMatrix->pstcMsg[i].FDF;
+            astcFmt[i].u8Brs = (uint8_t)pstcMatrix->pstcMsg[i].BRS;
+        }
+
+        stcSched.pstcSlot = pstcMatrix->pstcSlot;
+        stcSched.u8SlotNum = pstcMatrix->u8SlotNum;
+        stcSched.u8CycleNum = pstcMatrix->u8CycleNum;
+        stcSched.u16CycleTime = pstcMatrix->u16CycleTime;
+        stcSched.pstcFmt = astcFmt;
+        stcSched.u8MsgNum = pstcMatrix->u8MsgNum;
+        stcSched.u8NtuBits = pstcMatrix->u8NtuBits;
+        stcSched.u8FdDataRatio = pstcMatrix->u8FdDataRatio;
+
+        if (TTCAN_SchedCheck(&stcSched, pu16ErrSlot) == TTCAN_SCHED_OK) {
+            i32Ret = LL_OK;
+        }
+    } else if (pu16ErrSlot != NULL) {
+        *pu16ErrSlot = TTCAN_SCHED_POS_INVD;
+    } else {
+        /* 无需输出出错位置 */
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  下一个有效调度位置
+ * @param  [in]  u16Pos                 当前位置
+ * @param  [in]  u8TxOnly               1: 只找发送时隙
+ * @retval 下一个位置, 矩阵中没有符合条件的时隙时返回 u16Pos
+ */
+static uint16_t TTCAN_NextPos(uint16_t u16Pos, uint8_t u8TxOnly) {
+    const stc_ttcan_slot_t *pstcSlot;
+    uint16_t i;
+
+    for (i = 0U; i < m_u16PosNum; i++) {
+        u16Pos++;
+
+        if (u16Pos >= m_u16PosNum) {
+            u16Pos = 0U;
+        }
+
+        pstcSlot = &m_pstcMatrix->pstcSlot[u16Pos % m_pstcMatrix->u8SlotNum];
+
+        if ((TTCAN_SlotActive(pstcSlot, (uint8_t)(u16Pos / m_pstcMatrix->u8SlotNum)) != 0U) &&
+                ((u8TxOnly == 0U) || (TTCAN_SlotIsTx(pstcSlot->u8Type) != 0U))) {
+            break;
+        }
+    }
+
+    return u16Pos;
+}
+
+/**
+ * @brief  把后面的发送时隙写入缓冲区, 直到提前量达到 TTCAN_FILL_AHEAD
+ * @param  无
+ * @retval 无
+ */
+static void TTCAN_TopUp(void) {
+    const stc_ttcan_slot_t *pstcSlot;
+    const stc_ttcan_msg_t *pstcMsg;
+    const stc_can_tx_frame_t *pstcFrame;
+    const uint32_t *pu32Data;
+    __IO uint32_t *reg32TBUF = (__IO uint32_t *)&m_pstcCan->TBUF;
+    uint8_t u8WordLen;
+    uint8_t i;
+
+    if (m_u8HasTx == 0U) {
+        return;
+    }
+
+    while (m_u8Ahead < TTCAN_FILL_AHEAD) {
+        m_u16FillPos = TTCAN_NextPos(m_u16FillPos, 1U);
+        pstcSlot = &m_pstcMatrix->pstcSlot[m_u16FillPos % m_pstcMatrix->u8SlotNum];
+        pstcMsg = &m_astcMsg[pstcSlot->u8MsgIndex];
+        pstcFrame = &pstcMsg->astcFrame[pstcMsg->u8Active];
+        pu32Data = (const uint32_t *)(const void *)&pstcFrame->au8Data[0U];
+        u8WordLen = (m_au8DlcSize[pstcFrame->DLC] + 3U) / 4U;
+
+        /* TBPTR 指向要写的缓冲区, 先标记为空, 写完再标记为已填充 */
+        WRITE_REG8(m_pstcCan->TBSLOT, m_u8FillBuf | CAN_TBSLOT_TBE);
+        reg32TBUF[0U] = pstcFrame->u32ID;
+        reg32TBUF[1U] = pstcFrame->u32Ctrl;
+
+        for (i = 0U; i < u8WordLen; i++) {
+            reg32TBUF[2U + i] = pu32Data[i];
+        }
+
+        WRITE_REG8(m_pstcCan->TBSLOT, m_u8FillBuf | CAN_TBSLOT_TBF);
+
+        m_u8FillBuf = (m_u8FillBuf + 1U) % TTCAN_TX_BUF_NUM;
+        m_u8Ahead++;
+    }
+}
+
+/**
+ * @brief  装载 m_u16TrigPos 的触发器
+ * @param  无
+ * @retval 无
+ * @note   写 TT_TRIG 高字节后触发器生效.
+ */
+static void TTCAN_Program(void) {
+    const stc_ttcan_slot_t *pstcSlot = &m_pstcMatrix->pstcSlot[m_u16TrigPos % m_pstcMatrix->u8SlotNum];
+    uint16_t u16Cfg;
+
+    u16Cfg = m_au16TrigType[pstcSlot->u8Type] |
+             (uint16_t)((pstcSlot->u8TxEnableWindow - 1U) << CAN_TRG_CFG_TEW_POS);
+
+    if (TTCAN_SlotIsTx(pstcSlot->u8Type) != 0U) {
+        m_u8LastTxBuf = m_u8TrigBuf;
+        m_u8TrigBuf = (m_u8TrigBuf + 1U) % TTCAN_TX_BUF_NUM;
+        m_u8Ahead--;
+        u16Cfg |= m_u8LastTxBuf;
+    } else if (pstcSlot->u8Type == TTCAN_SLOT_ARBIT_STOP) {
+        u16Cfg |= m_u8LastTxBuf;
+    } else {
+        /* 接收触发不使用缓冲区 */
+    }
+
+    WRITE_REG16(m_pstcCan->TRG_CFG, u16Cfg);
+    WRITE_REG16(m_pstcCan->TT_TRIG, pstcSlot->u16Time);
+
+    if (READ_REG8_BIT(m_pstcCan->TTCFG, CAN_TTCFG_TEIF) != 0U) {
+        m_stcStats.u32TrigErrors++;
+    }
+}
+
+/**
+ * @brief  初始化调度引擎
+ * @param  [in]  CANx                   CM_CAN1 或 CM_CAN2, 已用 CAN_Init 初始化为全 TTCAN 缓冲区模式
+ * @param  [in]  pstcMatrix             调度矩阵, 运行期间须保持有效
+ * @retval int32_t:
+ *           - LL_OK:                   成功, 等待第一次 TTCAN_CycleStart
+ *           - LL_ERR_INVD_PARAM:       CANx 错误或矩阵检查不通过
+ *           - LL_ERR_INVD_MD:          TTCAN 发送缓冲区不是全 TTCAN 模式
+ */
+int32_t TTCAN_Init(CM_CAN_TypeDef *CANx, const stc_ttcan_matrix_t *pstcMatrix) {
+    uint8_t i;
+
+    if (((CANx != CM_CAN1) && (CANx != CM_CAN2)) || (TTCAN_CheckMatrix(pstcMatrix, NULL) != LL_OK)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (READ_REG8_BIT(CANx->TCTRL, CAN_TCTRL_TTTBM) == 0U) {
+        return LL_ERR_INVD_MD;
+    }
+
+    m_pstcCan = CANx;
+    m_pstcMatrix = pstcMatrix;
+    m_u16PosNum = (uint16_t)pstcMatrix->u8CycleNum * pstcMatrix->u8SlotNum;
+    m_u16TrigPos = TTCAN_SCHED_POS_INVD;
+    m_u16FillPos = 0U;
+    m_u8TrigBuf = 0U;
+    m_u8FillBuf = 0U;
+    m_u8LastTxBuf = 0U;
+    m_u8Ahead = 0U;
+    m_u8HasTx = 0U;
+    m_u8WaitRef = 1U;
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    for (i = 0U; i < pstcMatrix->u8MsgNum; i++) {
+        m_astcMsg[i].astcFrame[0U] = pstcMatrix->pstcMsg[i];
+        m_astcMsg[i].astcFrame[1U] = pstcMatrix->pstcMsg[i];
+        m_astcMsg[i].u8Active = 0U;
+    }
+
+    for (i = 0U; i < pstcMatrix->u8SlotNum; i++) {
+        if (TTCAN_SlotIsTx(pstcMatrix->pstcSlot[i].u8Type) != 0U) {
+            m_u8HasTx = 1U;
+        }
+    }
+
+    CAN_TTC_IntCmd(CANx, CAN_TTC_INT_TIME_TRIG | CAN_TTC_INT_WATCH_TRIG, ENABLE);
+    CAN_TTC_Cmd(CANx, ENABLE);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  开始一个基本周期
+ * @param  [in]  u8Cycle                参考报文中的周期计数
+ * @retval 无
+ * @note   时间从节点收到参考报文、时间主节点发出参考报文后, 在 CAN 中断中调用.
+ *         周期计数与引擎预期的位置一致时直接装载已准备好的触发; 不一致时(首次启动、
+ *         参考报文丢失)丢弃已写入的缓冲区, 从该周期的第一个时隙重新开始.
+ *         矩阵中该周期没有时隙时不装载触发.
+ */
+void TTCAN_CycleStart(uint8_t u8Cycle) {
+    uint16_t u16Start;
+    uint16_t u16Pos;
+
+    if (m_pstcMatrix == NULL) {
+        return;
+    }
+
+    u16Start = (uint16_t)(u8Cycle & (m_pstcMatrix->u8CycleNum - 1U)) * m_pstcMatrix->u8SlotNum;
+    u16Pos = TTCAN_NextPos((u16Start + m_u16PosNum - 1U) % m_u16PosNum, 0U);
+    m_stcStats.u32Cycles++;
+
+    /* 本周期没有时隙: 找到的是后面周期的时隙, 不能在本周期装载, 继续等参考报文 */
+    if ((u16Pos / m_pstcMatrix->u8SlotNum) != (u16Start / m_pstcMatrix->u8SlotNum)) {
+        m_u8WaitRef = 1U;
+        return;
+    }
+
+    if ((m_u8WaitRef == 0U) || (u16Pos != m_u16TrigPos)) {
+        m_u16TrigPos = u16Pos;
+        m_u16FillPos = (u16Pos + m_u16PosNum - 1U) % m_u16PosNum;
+        m_u8TrigBuf = m_u8FillBuf;
+        m_u8Ahead = 0U;
+        TTCAN_TopUp();
+        m_stcStats.u32Resync++;
+    }
+
+    m_u8WaitRef = 0U;
+    TTCAN_Program();
+}
+
+/**
+ * @brief  更新报文数据
+ * @param  [in]  u8Index                报文序号
+ * @param  [in]  pu8Data                数据, 长度由该报文的 DLC 决定
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       序号越界或 pu8Data == NULL
+ * @note   写入非活动的一份后切换, 中断里总是读到完整的一份. 数据在发送前
+ *         TTCAN_FILL_AHEAD 个发送时隙时被采样.
+ */
+int32_t TTCAN_UpdateMsg(uint8_t u8Index, const uint8_t *pu8Data) {
+    stc_ttcan_msg_t *pstcMsg;
+    uint8_t u8Next;
+
+    if ((m_pstcMatrix == NULL) || (u8Index >= m_pstcMatrix->u8MsgNum) || (pu8Data == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    pstcMsg = &m_astcMsg[u8Index];
+    u8Next = pstcMsg->u8Active ^ 1U;
+    (void)memcpy(pstcMsg->astcFrame[u8Next].au8Data, pu8Data, m_au8DlcSize[pstcMsg->astcFrame[u8Next].DLC]);
+    __DMB();
+    pstcMsg->u8Active = u8Next;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  TTCAN 中断处理, 在 CAN 中断回调中调用
+ * @param  无
+ * @retval 无
+ */
+void TTCAN_IrqHandler(void) {
+    const stc_ttcan_slot_t *pstcSlot;
+    uint16_t u16Prev;
+    uint8_t u8Flag;
+
+    if (m_pstcMatrix == NULL) {
+        return;
+    }
+
+    u8Flag = CAN_TTC_GetStatusValue(m_pstcCan);
+
+    if ((u8Flag & CAN_TTC_FLAG_TIME_TRIG) != 0U) {
+        CAN_TTC_ClearStatus(m_pstcCan, CAN_TTC_FLAG_TIME_TRIG);
+        m_stcStats.u32Triggers++;
+
+        pstcSlot = &m_pstcMatrix->pstcSlot[m_u16TrigPos % m_pstcMatrix->u8SlotNum];
+
+        if (TTCAN_SlotIsTx(pstcSlot->u8Type) != 0U) {
+            m_stcStats.u32TxSlots++;
+        }
+
+        u16Prev = m_u16TrigPos;
+        m_u16TrigPos = TTCAN_NextPos(m_u16TrigPos, 0U);
+        TTCAN_TopUp();
+
+        /* 进入下一个基本周期: 周期时间在参考报文处清零, 等参考报文再装载 */
+        if (((m_u16TrigPos / m_pstcMatrix->u8SlotNum) != (u16Prev / m_pstcMatrix->u8SlotNum)) ||
+                (m_u16TrigPos <= u16Prev)) {
+            m_u8WaitRef = 1U;
+        } else {
+            TTCAN_Program();
+        }
+    }
+
+    if ((u8Flag & CAN_TTC_FLAG_WATCH_TRIG) != 0U) {
+        CAN_TTC_ClearStatus(m_pstcCan, CAN_TTC_FLAG_WATCH_TRIG);
+        m_stcStats.u32WatchTrigs++;
+        m_u8WaitRef = 1U;
+    }
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              输出
+ * @retval 无
+ */
+void TTCAN_GetStats(stc_ttcan_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
@@ -0,0 +1,68 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_ttc.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TTCAN 调度引擎
+                   按静态调度矩阵(基本周期 x 时隙)在中断中逐个装载触发器,
+                   并提前把后面 TTCAN_FILL_AHEAD 个发送时隙的帧写入 TTC 发送缓冲区.
+                   时隙定义和矩阵检查在 can_ttc_sched.c, 不依赖 DDL, 可在主机上编译.
+  * Function List:
+                   TTCAN_CheckMatrix
+                   TTCAN_Init
+                   TTCAN_CycleStart
+                   TTCAN_UpdateMsg
+                   TTCAN_IrqHandler
+                   TTCAN_GetStats
+  ******************************************************
+**/
+
+#ifndef __CAN_TTC_H_
+#define __CAN_TTC_H_
+
+#include "hc32_ll.h"
+#include "can_ttc_sched.h"
+
+#define TTCAN_FILL_AHEAD            (2U)    /*!< 提前装入缓冲区的发送时隙数, 4 个 TTC 缓冲区留 1 个余量 */
+
+/**
+ * @brief 调度矩阵
+ */
+typedef struct {
+    const stc_ttcan_slot_t *pstcSlot;   /*!< 时隙表, 按 u16Time 严格递增 */
+    uint8_t u8SlotNum;
+    uint8_t u8CycleNum;                 /*!< 矩阵的基本周期数, 2 的幂, [1, 64] */
+    uint16_t u16CycleTime;              /*!< 基本周期长度(NTU) */
+    const stc_can_tx_frame_t *pstcMsg;  /*!< 报文初值(ID、DLC、FDF/BRS、数据) */
+    uint8_t u8MsgNum;
+    uint8_t u8NtuBits;                  /*!< 每个 NTU 的位时间数, 与 NTU 预分频一致: 1/2/4/8 */
+    uint8_t u8FdDataRatio;              /*!< CAN FD 数据段与仲裁段波特率之比, 不用 FD 时为 1 */
+} stc_ttcan_matrix_t;
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32Triggers;           /*!< 已到达的触发 */
+    uint32_t u32TxSlots;            /*!< 已到达的发送触发 */
+    uint32_t u32Cycles;             /*!< CycleStart 次数 */
+    uint32_t u32Resync;             /*!< 周期计数与调度位置不符而重新对齐的次数 */
+    uint32_t u32TrigErrors;         /*!< 触发错误(TEIF) */
+    uint32_t u32WatchTrigs;         /*!< 看门触发, 参考报文丢失 */
+} stc_ttcan_stats_t;
+
+int32_t TTCAN_CheckMatrix(const stc_ttcan_matrix_t *pstcMatrix, uint16_t *pu16ErrSlot);
+int32_t TTCAN_Init(CM_CAN_TypeDef *CANx, const stc_ttcan_matrix_t *pstcMatrix);
+void TTCAN_CycleStart(uint8_t u8Cycle);
+int32_t TTCAN_UpdateMsg(uint8_t u8Index, const uint8_t *pu8Data);
+void TTCAN_IrqHandler(void);
+void TTCAN_GetStats(stc_ttcan_stats_t *pstcStats);
+
+#endif
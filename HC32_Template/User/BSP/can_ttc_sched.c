@@ -0,0 +1,200 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_ttc_sched.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TTCAN 调度矩阵检查
+                   1. 帧长取最坏情况: 可填充区 n 位最多 (n - 1) / 4 个填充位; CAN FD 的
+                      仲裁段和数据段分开取整, 扩展帧仲裁段多算 1 位, 保证不小于连续填充的结果;
+                   2. 逐个基本周期检查: 发送时隙从触发时间起, 经发送使能窗口和帧的最长占用
+                      时间后, 必须早于同周期下一个时隙; 合并窗口结束后还要留出窗口内最长帧的时间;
+                      最后一个时隙结束不得晚于周期长度.
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_ttc_sched.h"
+
+static const uint8_t m_au8DlcSize[16U] = {
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+/**
+ * @brief  是否为发送时隙
+ * @param  [in]  u8Type                 时隙类型 @ref TTCAN_Slot_Type
+ * @retval uint8_t:                     1: 独占窗口或合并窗口开始; 0: 其它
+ */
+uint8_t TTCAN_SlotIsTx(uint8_t u8Type) {
+    return (uint8_t)(u8Type <= TTCAN_SLOT_ARBIT_START);
+}
+
+/**
+ * @brief  时隙是否出现在某个基本周期
+ * @param  [in]  pstcSlot               时隙
+ * @param  [in]  u8Cycle                基本周期序号, 小于矩阵的基本周期数
+ * @retval uint8_t:                     1: 出现; 0: 不出现
+ */
+uint8_t TTCAN_SlotActive(const stc_ttcan_slot_t *pstcSlot, uint8_t u8Cycle) {
+    return (uint8_t)((u8Cycle & (pstcSlot->u8CycleRepeat - 1U)) == pstcSlot->u8CycleBase);
+}
+
+/**
+ * @brief  帧在总线上的最长占用时间
+ * @param  [in]  pstcFmt                报文格式
+ * @param  [in]  u8NtuBits              每个 NTU 的位时间数
+ * @param  [in]  u8FdDataRatio          FD 数据段与仲裁段波特率之比
+ * @retval uint16_t:                    占用时间(NTU), 含填充位和帧间隔, 向上取整
+ */
+uint16_t TTCAN_FrameNtu(const stc_ttcan_frame_fmt_t *pstcFmt, uint8_t u8NtuBits, uint8_t u8FdDataRatio) {
+    uint32_t u32Size = m_au8DlcSize[pstcFmt->u8Dlc & 0x0FU];
+    uint32_t u32Nom;
+    uint32_t u32Data = 0U;
+
+    if (pstcFmt->u8Fdf == 0U) {
+        if (pstcFmt->u8Ide != 0U) {
+            u32Nom = 67U + 8U * u32Size + (54U + 8U * u32Size - 1U) / 4U;
+        } else {
+            u32Nom = 47U + 8U * u32Size + (34U + 8U * u32Size - 1U) / 4U;
+        }
+    } else {
+        /* 仲裁段: SOF~BRS 及填充位, 加 CRC 界定符~帧间隔 13 位 */
+        u32Nom = ((pstcFmt->u8Ide != 0U) ? (36U + 9U) : (17U + 4U)) + 13U;
+        /* 数据段: ESI、DLC、数据及填充位, 加填充计数、CRC 和固定填充位 */
+        u32Data = 5U + 8U * u32Size + (5U + 8U * u32Size - 1U) / 4U + ((u32Size > 16U) ? 32U : 27U);
+
+        if (pstcFmt->u8Brs != 0U) {
+            u32Data = (u32Data + u8FdDataRatio - 1U) / u8FdDataRatio;
+        }
+    }
+
+    return (uint16_t)((u32Nom + u32Data + u8NtuBits - 1U) / u8NtuBits);
+}
+
+/**
+ * @brief  检查调度矩阵
+ * @param  [in]  pstcSched              调度矩阵
+ * @param  [out] pu16ErrSlot            出错的时隙序号, 矩阵参数错误时为 TTCAN_SCHED_POS_INVD, 可为 0
+ * @retval int32_t:
+ *           - TTCAN_SCHED_OK:          矩阵合法, 各周期内时隙不重叠
+ *           - TTCAN_SCHED_ERR_PARAM:   矩阵或时隙参数非法
+ *           - TTCAN_SCHED_ERR_OVERLAP: 时隙重叠、合并窗口未结束或超出周期
+ */
+int32_t TTCAN_SchedCheck(const stc_ttcan_sched_t *pstcSched, uint16_t *pu16ErrSlot) {
+    const stc_ttcan_slot_t *pstcSlot;
+    uint32_t u32Busy;
+    uint16_t u16Ntu;
+    uint16_t u16WinMax;
+    uint16_t u16Err = TTCAN_SCHED_POS_INVD;
+    uint8_t u8Open;
+    uint8_t u8Cycle;
+    uint8_t i;
+    int32_t i32Ret = TTCAN_SCHED_ERR_PARAM;
+
+    if ((0 == pstcSched) || (0 == pstcSched->pstcSlot) || (pstcSched->u8SlotNum == 0U) ||
+            (pstcSched->u8CycleNum == 0U) || (pstcSched->u8CycleNum > 64U) ||
+            ((pstcSched->u8CycleNum & (pstcSched->u8CycleNum - 1U)) != 0U) ||
+            (pstcSched->u8MsgNum > TTCAN_MSG_MAX) || ((pstcSched->u8MsgNum != 0U) && (0 == pstcSched->pstcFmt)) ||
+            (pstcSched->u8NtuBits == 0U) || (pstcSched->u8NtuBits > 8U) ||
+            ((pstcSched->u8NtuBits & (pstcSched->u8NtuBits - 1U)) != 0U) || (pstcSched->u8FdDataRatio == 0U)) {
+        if (0 != pu16ErrSlot) {
+            *pu16ErrSlot = u16Err;
+        }
+
+        return i32Ret;
+    }
+
+    for (i = 0U; i < pstcSched->u8SlotNum; i++) {
+        pstcSlot = &pstcSched->pstcSlot[i];
+
+        if ((pstcSlot->u8Type > TTCAN_SLOT_RX) || (pstcSlot->u8TxEnableWindow == 0U) ||
+                (pstcSlot->u8TxEnableWindow > 16U) || (pstcSlot->u8CycleRepeat == 0U) ||
+                (pstcSlot->u8CycleRepeat > pstcSched->u8CycleNum) ||
+                ((pstcSlot->u8CycleRepeat & (pstcSlot->u8CycleRepeat - 1U)) != 0U) ||
+                (pstcSlot->u8CycleBase >= pstcSlot->u8CycleRepeat) ||
+                (pstcSlot->u16Time > pstcSched->u16CycleTime) ||
+                ((i > 0U) && (pstcSlot->u16Time <= pstcSched->pstcSlot[i - 1U].u16Time)) ||
+                ((TTCAN_SlotIsTx(pstcSlot->u8Type) != 0U) && (pstcSlot->u8MsgIndex >= pstcSched->u8MsgNum))) {
+            u16Err = i;
+            break;
+        }
+    }
+
+    if (u16Err == TTCAN_SCHED_POS_INVD) {
+        i32Ret = TTCAN_SCHED_ERR_OVERLAP;
+    }
+
+    for (u8Cycle = 0U; (u8Cycle < pstcSched->u8CycleNum) && (u16Err == TTCAN_SCHED_POS_INVD); u8Cycle++) {
+        u32Busy = 0U;
+        u16WinMax = 0U;
+        u8Open = 0U;
+
+        for (i = 0U; i < pstcSched->u8SlotNum; i++) {
+            pstcSlot = &pstcSched->pstcSlot[i];
+
+            if (TTCAN_SlotActive(pstcSlot, u8Cycle) == 0U) {
+                continue;
+            }
+
+            if (pstcSlot->u16Time < u32Busy) {
+                u16Err = i;
+                break;
+            }
+
+            if (TTCAN_SlotIsTx(pstcSlot->u8Type) != 0U) {
+                u16Ntu = TTCAN_FrameNtu(&pstcSched->pstcFmt[pstcSlot->u8MsgIndex],
+                                        pstcSched->u8NtuBits, pstcSched->u8FdDataRatio);
+            } else {
+                u16Ntu = 0U;
+            }
+
+            if (pstcSlot->u8Type == TTCAN_SLOT_EXCLUSIVE) {
+                if (u8Open != 0U) {
+                    u16Err = i;
+                    break;
+                }
+
+                u32Busy = (uint32_t)pstcSlot->u16Time + pstcSlot->u8TxEnableWindow + u16Ntu;
+            } else if (pstcSlot->u8Type == TTCAN_SLOT_ARBIT_START) {
+                u8Open = 1U;
+
+                if (u16Ntu > u16WinMax) {
+                    u16WinMax = u16Ntu;
+                }
+            } else if (pstcSlot->u8Type == TTCAN_SLOT_ARBIT_STOP) {
+                if (u8Open == 0U) {
+                    u16Err = i;
+                    break;
+                }
+
+                /* 结束触发前刚开始发送的帧仍会发完 */
+                u32Busy = (uint32_t)pstcSlot->u16Time + u16WinMax;
+                u16WinMax = 0U;
+                u8Open = 0U;
+            } else {
+                /* 接收触发不占用总线 */
+            }
+        }
+
+        if ((u16Err == TTCAN_SCHED_POS_INVD) && ((u8Open != 0U) || (u32Busy > pstcSched->u16CycleTime))) {
+            u16Err = (uint16_t)(pstcSched->u8SlotNum - 1U);
+        }
+    }
+
+    if (u16Err == TTCAN_SCHED_POS_INVD) {
+        i32Ret = TTCAN_SCHED_OK;
+    }
+
+    if (0 != pu16ErrSlot) {
+        *pu16ErrSlot = u16Err;
+    }
+
+    return i32Ret;
+}
@@ -0,0 +1,89 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_ttc_sched.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TTCAN 调度矩阵的时隙定义和离线检查
+                   只依赖 stdint.h, 不访问寄存器, 可在主机上编译;
+                   can_ttc.c 的 TTCAN_CheckMatrix 调用这里的 TTCAN_SchedCheck,
+                   Tools/ttcan_sched_sim.py 用逐位展开的帧长和总线回放验证本检查.
+  * Function List:
+                   TTCAN_SlotIsTx
+                   TTCAN_SlotActive
+                   TTCAN_FrameNtu
+                   TTCAN_SchedCheck
+  ******************************************************
+**/
+
+#ifndef __CAN_TTC_SCHED_H_
+#define __CAN_TTC_SCHED_H_
+
+#include <stdint.h>
+
+#define TTCAN_MSG_MAX               (16U)   /*!< 报文表上限 */
+#define TTCAN_SCHED_POS_INVD        (0xFFFFU)
+
+/**
+ * @defgroup TTCAN_Slot_Type 时隙类型
+ */
+#define TTCAN_SLOT_EXCLUSIVE        (0U)    /*!< 独占窗口, 单次发送触发 */
+#define TTCAN_SLOT_ARBIT_START      (1U)    /*!< 合并仲裁窗口开始, 发送开始触发 */
+#define TTCAN_SLOT_ARBIT_STOP       (2U)    /*!< 合并仲裁窗口结束, 未发出的帧被撤销, 不带报文 */
+#define TTCAN_SLOT_RX               (3U)    /*!< 接收触发, 只产生时间触发中断, 不带报文 */
+
+/**
+ * @defgroup TTCAN_Sched_Result 检查结果
+ */
+#define TTCAN_SCHED_OK              (0)
+#define TTCAN_SCHED_ERR_PARAM       (-1)    /*!< 矩阵或时隙参数非法 */
+#define TTCAN_SCHED_ERR_OVERLAP     (-2)    /*!< 某个基本周期内时隙重叠或超出周期 */
+
+/**
+ * @brief 调度矩阵中的一个时隙
+ */
+typedef struct {
+    uint16_t u16Time;               /*!< 触发时间(NTU), 相对参考报文 */
+    uint8_t u8Type;                 /*!< @ref TTCAN_Slot_Type */
+    uint8_t u8TxEnableWindow;       /*!< 发送使能窗口(NTU), [1, 16] */
+    uint8_t u8CycleBase;            /*!< 首次出现的基本周期, 小于 u8CycleRepeat */
+    uint8_t u8CycleRepeat;          /*!< 重复间隔(基本周期数), 2 的幂且不大于 u8CycleNum */
+    uint8_t u8MsgIndex;             /*!< 发送时隙使用的报文序号 */
+} stc_ttcan_slot_t;
+
+/**
+ * @brief 决定帧长的报文格式, 与 stc_can_tx_frame_t 的同名位相同
+ */
+typedef struct {
+    uint8_t u8Dlc;
+    uint8_t u8Ide;
+    uint8_t u8Fdf;
+    uint8_t u8Brs;
+} stc_ttcan_frame_fmt_t;
+
+/**
+ * @brief 检查用的调度矩阵, 字段含义与 stc_ttcan_matrix_t 相同, 报文只取格式
+ */
+typedef struct {
+    const stc_ttcan_slot_t *pstcSlot;   /*!< 时隙表, 按 u16Time 严格递增 */
+    uint8_t u8SlotNum;
+    uint8_t u8CycleNum;                 /*!< 矩阵的基本周期数, 2 的幂, [1, 64] */
+    uint16_t u16CycleTime;              /*!< 基本周期长度(NTU) */
+    const stc_ttcan_frame_fmt_t *pstcFmt;
+    uint8_t u8MsgNum;
+    uint8_t u8NtuBits;                  /*!< 每个 NTU 的位时间数: 1/2/4/8 */
+    uint8_t u8FdDataRatio;              /*!< CAN FD 数据段与仲裁段波特率之比, 不用 FD 时为 1 */
+} stc_ttcan_sched_t;
+
+uint8_t TTCAN_SlotIsTx(uint8_t u8Type);
+uint8_t TTCAN_SlotActive(const stc_ttcan_slot_t *pstcSlot, uint8_t u8Cycle);
+uint16_t TTCAN_FrameNtu(const stc_ttcan_frame_fmt_t *pstcFmt, uint8_t u8NtuBits, uint8_t u8FdDataRatio);
+int32_t TTCAN_SchedCheck(const stc_ttcan_sched_t *pstcSched, uint16_t *pu16ErrSlot);
+
+#endif
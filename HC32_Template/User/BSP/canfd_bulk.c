@@ -0,0 +1,312 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : canfd_bulk.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN FD 批量传输
+                   1. 只用于 CM_CAN2(CM_CAN1 只支持 CAN2.0), CAN 需先用 CAN_Init 配置好
+                      FD 波特率, 且不开启 TTCAN;
+                   2. STB 设为 FIFO 模式, 每批先写 PTB 再写 3 个 STB, 然后同时启动,
+                      PTB 优先级最高, 总线上的顺序与序号一致;
+                   3. PTB 和 STB 都发送完成后在中断里装下一批, 一批之间 CPU 不参与.
+                   本模块不登记中断, 由用户在 CAN 中断回调中调用 CANFD_Bulk_IrqHandler,
+                   收到本 ID 的帧时调用 CANFD_Bulk_RxFrame.
+  * Function List:
+
+  **********************************************************
+ */
+#include "canfd_bulk.h"
+#include "string.h"
+
+#define CANFD_BULK_WAIT_PTB         (0x01U)
+#define CANFD_BULK_WAIT_STB         (0x02U)
+#define CANFD_BULK_RX_IDLE          (0xFFU)
+
+static const uint8_t m_au8DlcSize[16U] = {
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+static CM_CAN_TypeDef *m_pstcCan;
+static stc_can_tx_frame_t m_stcTxFrame;
+static stc_canfd_bulk_stats_t m_stcStats;
+
+static const uint8_t *m_pu8TxData;
+static uint32_t m_u32TxRemain;
+static uint8_t m_u8TxSeq;
+static uint8_t m_u8TxLast;          /* 最后一帧已装入缓冲区 */
+static volatile uint8_t m_u8TxBusy;
+static volatile uint8_t m_u8TxWait; /* 尚未发送完成的缓冲区 */
+
+static uint8_t m_u8RxSeq = CANFD_BULK_RX_IDLE;
+static uint32_t m_u32RxLen;
+
+/* 序号 0 只用于数据块的第一帧, 之后在 1~127 间循环 */
+static uint8_t CANFD_Bulk_NextSeq(uint8_t u8Seq) {
+    return (u8Seq == CANFD_BULK_SEQ_MASK) ? 1U : (uint8_t)(u8Seq + 1U);
+}
+
+/**
+ * @brief  按剩余数据组一帧
+ * @param  无
+ * @retval 无
+ */
+static void CANFD_Bulk_BuildFrame(void) {
+    uint32_t u32Len;
+    uint32_t u32Size;
+    uint8_t u8Dlc = CAN_DLC64;
+
+    (void)memset(m_stcTxFrame.au8Data, 0, sizeof(m_stcTxFrame.au8Data));
+
+    if (m_u32TxRemain > CANFD_BULK_LAST_DATA) {
+        u32Len = CANFD_BULK_FRAME_DATA;
+        m_stcTxFrame.au8Data[0U] = m_u8TxSeq;
+        (void)memcpy(&m_stcTxFrame.au8Data[1U], m_pu8TxData, u32Len);
+    } else {
+        u32Len = m_u32TxRemain;
+        m_stcTxFrame.au8Data[0U] = m_u8TxSeq | CANFD_BULK_LAST;
+        m_stcTxFrame.au8Data[1U] = (uint8_t)u32Len;
+        (void)memcpy(&m_stcTxFrame.au8Data[2U], m_pu8TxData, u32Len);
+        m_u8TxLast = 1U;
+
+        /* 选能装下的最小 DLC */
+        u32Size = u32Len + 2U;
+
+        for (u8Dlc = CAN_DLC0; m_au8DlcSize[u8Dlc] < u32Size; u8Dlc++) {
+        }
+    }
+
+    m_stcTxFrame.DLC = u8Dlc;
+    m_pu8TxData += u32Len;
+    m_u32TxRemain -= u32Len;
+    m_u8TxSeq = CANFD_Bulk_NextSeq(m_u8TxSeq);
+}
+
+/**
+ * @brief  装入并启动一批帧
+ * @param  无
+ * @retval 无
+ * @note   调用时 PTB 和 STB 都已发送完成, 写缓冲区不会失败.
+ */
+static void CANFD_Bulk_StartBatch(void) {
+    uint8_t i;
+
+    CANFD_Bulk_BuildFrame();
+    (void)CAN_FillTxFrame(m_pstcCan, CAN_TX_BUF_PTB, &m_stcTxFrame);
+    m_u8TxWait = CANFD_BULK_WAIT_PTB;
+
+    for (i = 1U; (i < CANFD_BULK_BATCH) && (m_u8TxLast == 0U); i++) {
+        CANFD_Bulk_BuildFrame();
+        (void)CAN_FillTxFrame(m_pstcCan, CAN_TX_BUF_STB, &m_stcTxFrame);
+    }
+
+    if (i > 1U) {
+        m_u8TxWait |= CANFD_BULK_WAIT_STB;
+    }
+
+    m_stcStats.u32TxFrames += i;
+    m_stcStats.u32TxBatches++;
+
+    CAN_StartTx(m_pstcCan, CAN_TX_REQ_PTB);
+
+    if (i > 1U) {
+        CAN_StartTx(m_pstcCan, CAN_TX_REQ_STB_ALL);
+    }
+}
+
+/**
+ * @brief  初始化批量传输
+ * @param  [in]  CANx                   CM_CAN2, 已用 CAN_Init 初始化为 CAN FD
+ * @param  [in]  u32ID                  批量传输使用的帧 ID
+ * @param  [in]  u32IDE                 0: 标准帧, 1: 扩展帧
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       CANx 不支持 CAN FD
+ */
+int32_t CANFD_Bulk_Init(CM_CAN_TypeDef *CANx, uint32_t u32ID, uint32_t u32IDE) {
+    if (CANx != CM_CAN2) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_pstcCan = CANx;
+    m_u8TxBusy = 0U;
+    m_u8TxWait = 0U;
+    m_u8RxSeq = CANFD_BULK_RX_IDLE;
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    m_stcTxFrame.u32Ctrl = 0U;
+    m_stcTxFrame.u32ID = u32ID;
+    m_stcTxFrame.IDE = (u32IDE != 0U) ? 1U : 0U;
+    m_stcTxFrame.FDF = 1U;
+    m_stcTxFrame.BRS = 1U;
+
+    /* STB 按写入顺序发送 */
+    CLR_REG8_BIT(CANx->TCTRL, CAN_TCTRL_TSMODE);
+    CAN_ClearStatus(CANx, CAN_FLAG_PTB_TX | CAN_FLAG_STB_TX);
+    CAN_IntCmd(CANx, CAN_INT_PTB_TX | CAN_INT_STB_TX, ENABLE);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  发送一块数据
+ * @param  [in]  pu8Data                数据, 发送完成前须保持有效
+ * @param  [in]  u32Len                 长度, 可为 0
+ * @retval int32_t:
+ *           - LL_OK:                   已开始发送
+ *           - LL_ERR_BUSY:             上一块还在发送
+ *           - LL_ERR_INVD_PARAM:       未初始化或 pu8Data == NULL
+ */
+int32_t CANFD_Bulk_Send(const uint8_t *pu8Data, uint32_t u32Len) {
+    if ((m_pstcCan == NULL) || ((pu8Data == NULL) && (u32Len != 0U))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (m_u8TxBusy != 0U) {
+        return LL_ERR_BUSY;
+    }
+
+    m_pu8TxData = pu8Data;
+    m_u32TxRemain = u32Len;
+    m_u8TxSeq = 0U;
+    m_u8TxLast = 0U;
+    m_u8TxBusy = 1U;
+
+    /* 装批时不能被发送完成中断打断 */
+    CAN_IntCmd(m_pstcCan, CAN_INT_PTB_TX | CAN_INT_STB_TX, DISABLE);
+    CANFD_Bulk_StartBatch();
+    CAN_IntCmd(m_pstcCan, CAN_INT_PTB_TX | CAN_INT_STB_TX, ENABLE);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  是否正在发送
+ * @param  无
+ * @retval 1: 正在发送; 0: 空闲
+ */
+uint8_t CANFD_Bulk_IsBusy(void) {
+    return m_u8TxBusy;
+}
+
+/**
+ * @brief  发送完成中断处理, 在 CAN 中断回调中调用
+ * @param  无
+ * @retval 无
+ */
+void CANFD_Bulk_IrqHandler(void) {
+    if (m_pstcCan == NULL) {
+        return;
+    }
+
+    if (CAN_GetStatus(m_pstcCan, CAN_FLAG_PTB_TX) == SET) {
+        CAN_ClearStatus(m_pstcCan, CAN_FLAG_PTB_TX);
+        m_u8TxWait &= (uint8_t)~CANFD_BULK_WAIT_PTB;
+    }
+
+    if (CAN_GetStatus(m_pstcCan, CAN_FLAG_STB_TX) == SET) {
+        CAN_ClearStatus(m_pstcCan, CAN_FLAG_STB_TX);
+        m_u8TxWait &= (uint8_t)~CANFD_BULK_WAIT_STB;
+    }
+
+    if ((m_u8TxBusy == 0U) || (m_u8TxWait != 0U)) {
+        return;
+    }
+
+    if (m_u8TxLast != 0U) {
+        m_u8TxBusy = 0U;
+        m_stcStats.u32TxDone++;
+    } else {
+        CANFD_Bulk_StartBatch();
+    }
+}
+
+/**
+ * @brief  重组接收到的帧
+ * @param  [in]  pstcRx                 CAN_GetRxFrame 读到的帧, 须为 CANFD_Bulk_Init 中设定的 ID
+ * @param  [out] pu8Buf                 接收缓冲区, 重组过程中保持不变
+ * @param  [in]  u32Size                接收缓冲区大小
+ * @param  [out] pu32Len                数据块完成时输出长度
+ * @retval int32_t:
+ *           - LL_OK:                   一个数据块接收完成
+ *           - LL_ERR_NOT_RDY:          数据块尚未结束
+ *           - LL_ERR:                  序号不连续或缓冲区不够, 丢弃到下一个序号 0
+ *           - LL_ERR_INVD_PARAM:       参数错误或不是 FD 帧
+ */
+int32_t CANFD_Bulk_RxFrame(const stc_can_rx_frame_t *pstcRx, uint8_t *pu8Buf, uint32_t u32Size, uint32_t *pu32Len) {
+    uint32_t u32Len;
+    uint32_t u32Size0;
+    uint8_t u8Seq;
+    uint8_t u8Offset;
+
+    if ((pstcRx == NULL) || (pu8Buf == NULL) || (pu32Len == NULL) || (pstcRx->FDF == 0U) || (pstcRx->DLC == 0U)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcStats.u32RxFrames++;
+    u32Size0 = m_au8DlcSize[pstcRx->DLC];
+    u8Seq = pstcRx->au8Data[0U] & CANFD_BULK_SEQ_MASK;
+
+    /* 序号 0 总是开始一个新数据块 */
+    if (u8Seq == 0U) {
+        m_u8RxSeq = 0U;
+        m_u32RxLen = 0U;
+    } else if (u8Seq != m_u8RxSeq) {
+        if (m_u8RxSeq != CANFD_BULK_RX_IDLE) {
+            m_stcStats.u32RxSeqErr++;
+            m_u8RxSeq = CANFD_BULK_RX_IDLE;
+        }
+
+        return LL_ERR;
+    }
+
+    if ((pstcRx->au8Data[0U] & CANFD_BULK_LAST) != 0U) {
+        u8Offset = 2U;
+        u32Len = pstcRx->au8Data[1U];
+    } else {
+        u8Offset = 1U;
+        u32Len = CANFD_BULK_FRAME_DATA;
+    }
+
+    if ((u32Len + u8Offset) > u32Size0) {
+        m_stcStats.u32RxSeqErr++;
+        m_u8RxSeq = CANFD_BULK_RX_IDLE;
+        return LL_ERR;
+    }
+
+    if ((m_u32RxLen + u32Len) > u32Size) {
+        m_stcStats.u32RxOverflow++;
+        m_u8RxSeq = CANFD_BULK_RX_IDLE;
+        return LL_ERR;
+    }
+
+    (void)memcpy(&pu8Buf[m_u32RxLen], &pstcRx->au8Data[u8Offset], u32Len);
+    m_u32RxLen += u32Len;
+
+    if (u8Offset == 2U) {
+        *pu32Len = m_u32RxLen;
+        m_u8RxSeq = CANFD_BULK_RX_IDLE;
+        m_stcStats.u32RxDone++;
+        return LL_OK;
+    }
+
+    m_u8RxSeq = CANFD_Bulk_NextSeq(u8Seq);
+
+    return LL_ERR_NOT_RDY;
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              输出
+ * @retval 无
+ */
+void CANFD_Bulk_GetStats(stc_canfd_bulk_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
@@ -0,0 +1,62 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : canfd_bulk.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CAN FD 批量传输
+                   把一块数据拆成 64 字节的 FD 帧, 每批占满 PTB 和 3 个 STB 后一起启动发送,
+                   接收端按序号重组.
+  * Function List:
+                   CANFD_Bulk_Init
+                   CANFD_Bulk_Send
+                   CANFD_Bulk_IsBusy
+                   CANFD_Bulk_IrqHandler
+                   CANFD_Bulk_RxFrame
+                   CANFD_Bulk_GetStats
+  ******************************************************
+**/
+
+#ifndef __CANFD_BULK_H_
+#define __CANFD_BULK_H_
+
+#include "hc32_ll.h"
+
+/*
+ * 帧格式: 数据第 0 字节为序号(首帧为 0, 之后 1~127 循环), 最后一帧置 CANFD_BULK_LAST;
+ * 中间帧第 1~63 字节为数据; 最后一帧第 1 字节为本帧数据长度(0~62), 其后为数据,
+ * DLC 取能容纳的最小长度, 多余部分填 0.
+ */
+#define CANFD_BULK_LAST             (0x80U)
+#define CANFD_BULK_SEQ_MASK         (0x7FU)
+#define CANFD_BULK_FRAME_DATA       (63U)       /*!< 中间帧的数据字节数 */
+#define CANFD_BULK_LAST_DATA        (62U)       /*!< 最后一帧最多的数据字节数 */
+#define CANFD_BULK_BATCH            (4U)        /*!< 每批帧数: PTB + 3 个 STB */
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32TxFrames;
+    uint32_t u32TxBatches;
+    uint32_t u32TxDone;             /*!< 发送完成的数据块 */
+    uint32_t u32RxFrames;
+    uint32_t u32RxDone;             /*!< 重组完成的数据块 */
+    uint32_t u32RxSeqErr;           /*!< 序号不连续, 丢弃当前数据块 */
+    uint32_t u32RxOverflow;         /*!< 数据块超过接收缓冲区, 丢弃 */
+} stc_canfd_bulk_stats_t;
+
+int32_t CANFD_Bulk_Init(CM_CAN_TypeDef *CANx, uint32_t u32ID, uint32_t u32IDE);
+int32_t CANFD_Bulk_Send(const uint8_t *pu8Data, uint32_t u32Len);
+uint8_t CANFD_Bulk_IsBusy(void);
+void CANFD_Bulk_IrqHandler(void);
+int32_t CANFD_Bulk_RxFrame(const stc_can_rx_frame_t *pstcRx, uint8_t *pu8Buf, uint32_t u32Size, uint32_t *pu32Len);
+void CANFD_Bulk_GetStats(stc_canfd_bulk_stats_t *pstcStats);
+
+#endif
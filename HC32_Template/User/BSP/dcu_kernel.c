@@ -0,0 +1,738 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : dcu_kernel.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCU + DMA 批量运算
+                   1. 批量任务按块进行: 每块设置 DMA 源地址和块长, 由 AOS 软件触发(EVT_SRC_AOS_STRG)
+                      搬运整块, 传输完成中断里处理该块并启动下一块; 软件触发会同时触发所有选择
+                      EVT_SRC_AOS_STRG 的目标, 其他代码不要再用它;
+                   2. 越限检查: DCU 比较模式, DATA1 = 上限, DATA2 = 下限, DMA 写 DATA0 触发比较;
+                      DATA0 > DATA1 或 DATA0 < DATA2 产生 DCU 中断, 中断里只记录本块命中并关闭
+                      DCU 中断, 每块至多一次; 块结束时 CPU 只扫描命中的块给出准确序号;
+                      DCUK_LIMIT_FIRST 时 DCU 中断立即停 DMA, 从块首扫描到 DMA 当前地址;
+                   3. 累加: DCU 32 位加法模式, DMA 写 DATA1 使 DATA0 += DATA1; 块长取
+                      0xFFFFFFFF / 最大样本值, 保证一块内至多进位一次, 进位由 DCU 中断计数;
+                   4. DCU 标志是否保持到清除手册未写明, 块结束时同时查标志和 DCU 中断挂起位,
+                      两者任一有效即算命中/进位, 不依赖标志保持;
+                   5. 波形: DCU 由 AOS 目标 DCU_TRGSELx 步进, DMA 同一事件搬运 DATA0, 传输次数
+                      为 0 即无限次; DMA 与 DCU 谁先响应同一事件不确定, DAC 可能比 DCU 晚一步,
+                      波形本身不变;
+                   6. 波形边界处理按手册描述建模(DCUK_WaveNext), DCUK_SelfTest 在板上逐步对照,
+                      与硬件不一致时同时修改本文件和 Tools/dcu_model.py.
+  * Function List:
+
+  **********************************************************
+ */
+#include "dcu_kernel.h"
+
+#define DCUK_TEST_SEED              (0x20261019UL)
+#define DCUK_TEST_LOW               (0x040UL)
+#define DCUK_TEST_HIGH              (0xFC0UL)
+#define DCUK_TEST_WAVE_STEPS        (64U)
+
+enum {
+    DCUK_JOB_NONE = 0,
+    DCUK_JOB_LIMIT,
+    DCUK_JOB_ACCUM,
+};
+
+static stc_dcuk_config_t m_stcCfg;
+static uint8_t m_u8Ready = 0U;
+
+static volatile uint8_t m_u8Job = DCUK_JOB_NONE;
+static const uint8_t *m_pu8Buf;
+static uint32_t m_u32Num;
+static uint32_t m_u32Next;                  /*!< 当前块首样本序号 */
+static uint32_t m_u32BlkLen;                /*!< 当前块长 */
+static uint32_t m_u32BlkMax;
+static uint8_t m_u8Width;
+static uint8_t m_u8Mode;
+static uint32_t m_u32Low;
+static uint32_t m_u32High;
+static func_dcuk_match_t m_pfnMatch;
+static volatile uint8_t m_u8Hit;            /*!< 本块有越限 */
+static volatile uint32_t m_u32Carry;
+static stc_dcuk_result_t m_stcResult;
+
+static uint32_t m_u32TestCount;             /*!< 自检回调计数 */
+static uint8_t m_u8TestBad;
+
+static uint8_t DCUK_Unit(const CM_DCU_TypeDef *DCUx) {
+    return (uint8_t)(((uint32_t)DCUx - CM_DCU1_BASE) >> 10U);
+}
+
+static uint32_t DCUK_DmaTarget(const CM_DMA_TypeDef *DMAx, uint8_t u8Ch) {
+    return ((CM_DMA1 == DMAx) ? AOS_DMA1_0 : AOS_DMA2_0) + 4UL * (uint32_t)u8Ch;
+}
+
+static uint32_t DCUK_Sample(const uint8_t *pu8Buf, uint8_t u8Width, uint32_t u32Index) {
+    uint32_t u32Val;
+
+    if (DCUK_WIDTH_8BIT == u8Width) {
+        u32Val = pu8Buf[u32Index];
+    } else if (DCUK_WIDTH_16BIT == u8Width) {
+        u32Val = ((const uint16_t *)(const void *)pu8Buf)[u32Index];
+    } else {
+        u32Val = ((const uint32_t *)(const void *)pu8Buf)[u32Index];
+    }
+
+    return u32Val;
+}
+
+/* CPU 定位 [u32Start, u32End) 内的越限样本, 也是越限检查的参考实现 */
+static void DCUK_Scan(uint32_t u32Start, uint32_t u32End) {
+    uint32_t i;
+    uint32_t u32Val;
+
+    for (i = u32Start; i < u32End; i++) {
+        u32Val = DCUK_Sample(m_pu8Buf, m_u8Width, i);
+
+        if ((u32Val < m_u32Low) || (u32Val > m_u32High)) {
+            if (0UL == m_stcResult.u32Matches) {
+                m_stcResult.u32FirstIndex = i;
+            }
+            m_stcResult.u32Matches++;
+
+            if (NULL != m_pfnMatch) {
+                m_pfnMatch(i, u32Val);
+            }
+
+            if (DCUK_LIMIT_FIRST == m_u8Mode) {
+                break;
+            }
+        }
+    }
+}
+
+static void DCUK_Finish(void) {
+    (void)DMA_ChCmd(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, DISABLE);
+    DCU_GlobalIntCmd(m_stcCfg.DCUx, DISABLE);
+    m_u8Job = DCUK_JOB_NONE;
+}
+
+static void DCUK_StartBlock(void) {
+    m_u32BlkLen = m_u32Num - m_u32Next;
+    if (m_u32BlkLen > m_u32BlkMax) {
+        m_u32BlkLen = m_u32BlkMax;
+    }
+
+    (void)DMA_SetSrcAddr(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, (uint32_t)&m_pu8Buf[m_u32Next * m_u8Width]);
+    /* 块长 1024 写 0 */
+    (void)DMA_SetBlockSize(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, (uint16_t)(m_u32BlkLen & 0x3FFUL));
+    (void)DMA_SetTransCount(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, 1U);
+
+    if (DCUK_JOB_LIMIT == m_u8Job) {
+        m_u8Hit = 0U;
+        DCU_ClearStatus(m_stcCfg.DCUx, DCU_FLAG_ALL);
+        DCU_GlobalIntCmd(m_stcCfg.DCUx, ENABLE);
+    }
+
+    (void)DMA_ChCmd(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, ENABLE);
+    AOS_SW_Trigger();
+}
+
+/* DCU 中断或块结束时发现 DCU 中断挂起 */
+static void DCUK_DcuService(void) {
+    uint32_t u32End;
+
+    DCU_ClearStatus(m_stcCfg.DCUx, DCU_FLAG_ALL);
+
+    if (DCUK_JOB_ACCUM == m_u8Job) {
+        m_u32Carry++;
+    } else if (DCUK_JOB_LIMIT == m_u8Job) {
+        /* 本块已命中, 剩余部分由 CPU 扫描, 不再进 DCU 中断 */
+        DCU_GlobalIntCmd(m_stcCfg.DCUx, DISABLE);
+        m_u8Hit = 1U;
+
+        if (DCUK_LIMIT_FIRST == m_u8Mode) {
+            (void)DMA_ChCmd(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, DISABLE);
+            /* MONSAR 为下一个要读的地址, 命中样本在它之前 */
+            u32End = (DMA_GetSrcAddr(m_stcCfg.DMAx, m_stcCfg.u8DmaCh) - (uint32_t)m_pu8Buf) / m_u8Width;
+            if ((u32End <= m_u32Next) || (u32End > (m_u32Next + m_u32BlkLen))) {
+                u32End = m_u32Next + m_u32BlkLen;
+            }
+
+            m_stcResult.u32ScanBlocks++;
+            DCUK_Scan(m_u32Next, u32End);
+            if (0UL == m_stcResult.u32Matches) {
+                DCUK_Scan(u32End, m_u32Next + m_u32BlkLen);
+            }
+            m_stcResult.u32Blocks++;
+            m_stcResult.u32Done = m_u32Next + m_u32BlkLen;
+            DMA_ClearTransCompleteStatus(m_stcCfg.DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << m_stcCfg.u8DmaCh);
+            NVIC_ClearPendingIRQ(m_stcCfg.enDmaIRQn);
+            DCUK_Finish();
+        }
+    } else {
+        DCU_GlobalIntCmd(m_stcCfg.DCUx, DISABLE);
+    }
+}
+
+static void DCUK_DcuIrqHandler(void) {
+    DCUK_DcuService();
+}
+
+static void DCUK_DmaIrqHandler(void) {
+    DMA_ClearTransCompleteStatus(m_stcCfg.DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << m_stcCfg.u8DmaCh);
+
+    if (DCUK_JOB_NONE == m_u8Job) {
+        return;
+    }
+
+    /* 最后一个样本的 DCU 中断可能还没响应 */
+    if ((0UL != NVIC_GetPendingIRQ(m_stcCfg.enDcuIRQn)) ||
+            ((DCUK_JOB_LIMIT == m_u8Job) && (0U == m_u8Hit) &&
+             (0UL != READ_REG32_BIT(m_stcCfg.DCUx->FLAG, DCU_FLAG_DATA0_LT_DATA2 | DCU_FLAG_DATA0_GT_DATA1)))) {
+        NVIC_ClearPendingIRQ(m_stcCfg.enDcuIRQn);
+        DCUK_DcuService();
+        if (DCUK_JOB_NONE == m_u8Job) {
+            return;
+        }
+    }
+
+    if (DCUK_JOB_LIMIT == m_u8Job) {
+        if (0U != m_u8Hit) {
+            m_stcResult.u32ScanBlocks++;
+            DCUK_Scan(m_u32Next, m_u32Next + m_u32BlkLen);
+        }
+    } else {
+        m_stcResult.u64Sum = ((uint64_t)m_u32Carry << 32U) | DCU_ReadData32(m_stcCfg.DCUx, DCU_DATA0_IDX);
+    }
+
+    m_stcResult.u32Blocks++;
+    m_u32Next += m_u32BlkLen;
+    m_stcResult.u32Done = m_u32Next;
+
+    if ((m_u32Next >= m_u32Num) ||
+            ((DCUK_LIMIT_FIRST == m_u8Mode) && (0UL != m_stcResult.u32Matches))) {
+        DCUK_Finish();
+    } else {
+        DCUK_StartBlock();
+    }
+}
+
+static int32_t DCUK_Begin(const void *pvBuf, uint32_t u32Num, uint8_t u8Width, uint32_t u32Dest) {
+    stc_dma_init_t stcDma;
+    uint32_t u32DmaWidth;
+
+    if (0U == m_u8Ready) {
+        return LL_ERR_UNINIT;
+    }
+    if (DCUK_JOB_NONE != m_u8Job) {
+        return LL_ERR_BUSY;
+    }
+
+    if (DCUK_WIDTH_8BIT == u8Width) {
+        u32DmaWidth = DMA_DATAWIDTH_8BIT;
+    } else if (DCUK_WIDTH_16BIT == u8Width) {
+        u32DmaWidth = DMA_DATAWIDTH_16BIT;
+    } else {
+        u32DmaWidth = DMA_DATAWIDTH_32BIT;
+    }
+
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = DMA_INT_ENABLE;
+    stcDma.u32SrcAddr = (uint32_t)pvBuf;
+    stcDma.u32DestAddr = u32Dest;
+    stcDma.u32DataWidth = u32DmaWidth;
+    stcDma.u32BlockSize = 1UL;
+    stcDma.u32TransCount = 1UL;
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_INC;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, &stcDma);
+    DMA_ClearTransCompleteStatus(m_stcCfg.DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << m_stcCfg.u8DmaCh);
+
+    m_pu8Buf = (const uint8_t *)pvBuf;
+    m_u32Num = u32Num;
+    m_u32Next = 0UL;
+    m_u8Width = u8Width;
+    m_u32Carry = 0UL;
+    m_stcResult.u32Done = 0UL;
+    m_stcResult.u32Matches = 0UL;
+    m_stcResult.u32FirstIndex = DCUK_INDEX_NONE;
+    m_stcResult.u32Blocks = 0UL;
+    m_stcResult.u32ScanBlocks = 0UL;
+    m_stcResult.u64Sum = 0ULL;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  初始化批量任务使用的 DCU/DMA 通道并登记中断
+ * @param  [in]  pstcConfig             硬件选择
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       参数错误
+ *           - LL_ERR_BUSY:             DMA 通道的 AOS 触发已被占用, 或中断号已被登记
+ */
+int32_t DCUK_Init(const stc_dcuk_config_t *pstcConfig) {
+    stc_irq_signin_config_t stcIrq;
+    stc_aosg_link_t stcLink;
+    stc_aosg_plan_t stcPlan;
+    int32_t i32Ret;
+    uint8_t u8Unit;
+
+    if ((NULL == pstcConfig) || (pstcConfig->u8DmaCh > DMA_CH7) ||
+            ((CM_DMA1 != pstcConfig->DMAx) && (CM_DMA2 != pstcConfig->DMAx)) ||
+            ((uint32_t)pstcConfig->DCUx < CM_DCU1_BASE) || ((uint32_t)pstcConfig->DCUx > CM_DCU8_BASE)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcCfg = *pstcConfig;
+    m_u8Job = DCUK_JOB_NONE;
+    u8Unit = DCUK_Unit(m_stcCfg.DCUx);
+
+    FCG_Fcg0PeriphClockCmd((FCG0_PERIPH_DCU1 << u8Unit) |
+                           ((CM_DMA1 == m_stcCfg.DMAx) ? FCG0_PERIPH_DMA1 : FCG0_PERIPH_DMA2), ENABLE);
+    (void)DCU_DeInit(m_stcCfg.DCUx);
+    DMA_Cmd(m_stcCfg.DMAx, ENABLE);
+    (void)DMA_ChCmd(m_stcCfg.DMAx, m_stcCfg.u8DmaCh, DISABLE);
+    DMA_TransCompleteIntCmd(m_stcCfg.DMAx, DMA_INT_TC_CH0 << m_stcCfg.u8DmaCh, ENABLE);
+
+    /* 每块由软件触发搬运 */
+    stcLink.enSrc = EVT_SRC_AOS_STRG;
+    stcLink.u32Target = DCUK_DmaTarget(m_stcCfg.DMAx, m_stcCfg.u8DmaCh);
+    i32Ret = AOSG_Apply(&stcLink, 1U, &stcPlan);
+
+    if (LL_OK == i32Ret) {
+        stcIrq.enIntSrc = (en_int_src_t)((uint32_t)((CM_DMA1 == m_stcCfg.DMAx) ? INT_SRC_DMA1_TC0 : INT_SRC_DMA2_TC0) +
+                                         (uint32_t)m_stcCfg.u8DmaCh);
+        stcIrq.enIRQn = m_stcCfg.enDmaIRQn;
+        stcIrq.pfnCallback = &DCUK_DmaIrqHandler;
+        i32Ret = INTC_IrqSignIn(&stcIrq);
+    }
+
+    if (LL_OK == i32Ret) {
+        stcIrq.enIntSrc = (en_int_src_t)((uint32_t)INT_SRC_DCU1 + (uint32_t)u8Unit);
+        stcIrq.enIRQn = m_stcCfg.enDcuIRQn;
+        stcIrq.pfnCallback = &DCUK_DcuIrqHandler;
+        i32Ret = INTC_IrqSignIn(&stcIrq);
+    }
+
+    if (LL_OK == i32Ret) {
+        NVIC_ClearPendingIRQ(m_stcCfg.enDmaIRQn);
+        NVIC_SetPriority(m_stcCfg.enDmaIRQn, m_stcCfg.u32IrqPrio);
+        NVIC_EnableIRQ(m_stcCfg.enDmaIRQn);
+        NVIC_ClearPendingIRQ(m_stcCfg.enDcuIRQn);
+        NVIC_SetPriority(m_stcCfg.enDcuIRQn, m_stcCfg.u32IrqPrio);
+        NVIC_EnableIRQ(m_stcCfg.enDcuIRQn);
+        m_u8Ready = 1U;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  启动越限检查, 样本按无符号数比较
+ * @param  [in]  pvBuf                  样本缓冲区, 按宽度对齐, 完成前不能改动
+ * @param  [in]  u32Num                 样本数
+ * @param  [in]  u8Width                @ref DCUK_Width
+ * @param  [in]  u32Low                 下限, 小于它为越限
+ * @param  [in]  u32High                上限, 大于它为越限
+ * @param  [in]  u8Mode                 @ref DCUK_Limit_Mode
+ * @param  [in]  pfnMatch               越限回调, 可为 NULL, 此时只统计
+ * @retval int32_t:
+ *           - LL_OK:                   已启动, 用 DCUK_GetResult 查询
+ *           - LL_ERR_INVD_PARAM:       参数错误
+ *           - LL_ERR_UNINIT:           未初始化
+ *           - LL_ERR_BUSY:             上一个任务未完成
+ */
+int32_t DCUK_LimitStart(const void *pvBuf, uint32_t u32Num, uint8_t u8Width,
+                        uint32_t u32Low, uint32_t u32High, uint8_t u8Mode, func_dcuk_match_t pfnMatch) {
+    stc_dcu_init_t stcDcu;
+    int32_t i32Ret;
+
+    if ((NULL == pvBuf) || (0UL == u32Num) || (u32Low > u32High) ||
+            ((DCUK_WIDTH_8BIT != u8Width) && (DCUK_WIDTH_16BIT != u8Width) && (DCUK_WIDTH_32BIT != u8Width))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    i32Ret = DCUK_Begin(pvBuf, u32Num, u8Width, (uint32_t)&m_stcCfg.DCUx->DATA0);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    m_u32Low = u32Low;
+    m_u32High = u32High;
+    m_u8Mode = u8Mode;
+    m_pfnMatch = pfnMatch;
+    m_u32BlkMax = DCUK_BLOCK_MAX;
+
+    stcDcu.u32Mode = DCU_MD_CMP;
+    stcDcu.u32DataWidth = (DCUK_WIDTH_8BIT == u8Width) ? DCU_DATA_WIDTH_8BIT :
+                          ((DCUK_WIDTH_16BIT == u8Width) ? DCU_DATA_WIDTH_16BIT : DCU_DATA_WIDTH_32BIT);
+    (void)DCU_Init(m_stcCfg.DCUx, &stcDcu);
+    DCU_SetCompareCond(m_stcCfg.DCUx, DCU_CMP_TRIG_DATA0);
+    DCU_WriteData32(m_stcCfg.DCUx, DCU_DATA1_IDX, u32High);
+    DCU_WriteData32(m_stcCfg.DCUx, DCU_DATA2_IDX, u32Low);
+    DCU_IntCmd(m_stcCfg.DCUx, DCU_CATEGORY_CMP_NON_WIN,
+               DCU_INT_CMP_DATA0_GT_DATA1 | DCU_INT_CMP_DATA0_LT_DATA2, ENABLE);
+    DCU_ClearStatus(m_stcCfg.DCUx, DCU_FLAG_ALL);
+    NVIC_ClearPendingIRQ(m_stcCfg.enDcuIRQn);
+
+    m_u8Job = DCUK_JOB_LIMIT;
+    DCUK_StartBlock();
+
+    return LL_OK;
+}
+
+/**
+ * @brief  启动 32 位无符号累加, 结果为 64 位
+ * @param  [in]  pu32Buf                样本缓冲区, 完成前不能改动
+ * @param  [in]  u32Num                 样本数
+ * @param  [in]  u32MaxSample           样本最大值, 决定块长; 如 12 位 ADC 为 0xFFF
+ * @retval int32_t:
+ *           - LL_OK:                   已启动, 用 DCUK_GetResult 查询
+ *           - LL_ERR_INVD_PARAM:       参数错误
+ *           - LL_ERR_UNINIT:           未初始化
+ *           - LL_ERR_BUSY:             上一个任务未完成
+ */
+int32_t DCUK_AccumStart(const uint32_t *pu32Buf, uint32_t u32Num, uint32_t u32MaxSample) {
+    stc_dcu_init_t stcDcu;
+    int32_t i32Ret;
+
+    if ((NULL == pu32Buf) || (0UL == u32Num)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    i32Ret = DCUK_Begin(pu32Buf, u32Num, DCUK_WIDTH_32BIT, (uint32_t)&m_stcCfg.DCUx->DATA1);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    m_u8Mode = DCUK_LIMIT_ALL;
+    /* 一块之和不超过 0xFFFFFFFF, 块内至多进位一次 */
+    m_u32BlkMax = (0UL == u32MaxSample) ? DCUK_BLOCK_MAX : (0xFFFFFFFFUL / u32MaxSample);
+    if (m_u32BlkMax > DCUK_BLOCK_MAX) {
+        m_u32BlkMax = DCUK_BLOCK_MAX;
+    }
+
+    stcDcu.u32Mode = DCU_MD_ADD;
+    stcDcu.u32DataWidth = DCU_DATA_WIDTH_32BIT;
+    (void)DCU_Init(m_stcCfg.DCUx, &stcDcu);
+    DCU_WriteData32(m_stcCfg.DCUx, DCU_DATA0_IDX, 0UL);
+    DCU_IntCmd(m_stcCfg.DCUx, DCU_CATEGORY_OP, DCU_INT_OP_CARRY, ENABLE);
+    DCU_ClearStatus(m_stcCfg.DCUx, DCU_FLAG_ALL);
+    NVIC_ClearPendingIRQ(m_stcCfg.enDcuIRQn);
+    DCU_GlobalIntCmd(m_stcCfg.DCUx, ENABLE);
+
+    m_u8Job = DCUK_JOB_ACCUM;
+    DCUK_StartBlock();
+
+    return LL_OK;
+}
+
+/**
+ * @brief  停止当前批量任务, 结果保留到已完成的块
+ * @param  无
+ * @retval 无
+ */
+void DCUK_Abort(void) {
+    if (0U != m_u8Ready) {
+        NVIC_DisableIRQ(m_stcCfg.enDmaIRQn);
+        NVIC_DisableIRQ(m_stcCfg.enDcuIRQn);
+        DCUK_Finish();
+        NVIC_EnableIRQ(m_stcCfg.enDcuIRQn);
+        NVIC_EnableIRQ(m_stcCfg.enDmaIRQn);
+    }
+}
+
+/**
+ * @brief  读取批量任务结果
+ * @param  [out] pstcResult             结果, 运行中为已完成各块的结果
+ * @retval int32_t:
+ *           - LL_OK:                   任务已完成
+ *           - LL_ERR_BUSY:             任务运行中
+ *           - LL_ERR_INVD_PARAM:       pstcResult 为 NULL
+ *           - LL_ERR_UNINIT:           未初始化
+ */
+int32_t DCUK_GetResult(stc_dcuk_result_t *pstcResult) {
+    uint8_t u8Job;
+
+    if (NULL == pstcResult) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (0U == m_u8Ready) {
+        return LL_ERR_UNINIT;
+    }
+
+    /* 结果和任务状态在同一次关中断内读取; DCUK_LIMIT_FIRST 时 DCU 中断也会结束任务 */
+    NVIC_DisableIRQ(m_stcCfg.enDmaIRQn);
+    NVIC_DisableIRQ(m_stcCfg.enDcuIRQn);
+    *pstcResult = m_stcResult;
+    u8Job = m_u8Job;
+    NVIC_EnableIRQ(m_stcCfg.enDcuIRQn);
+    NVIC_EnableIRQ(m_stcCfg.enDmaIRQn);
+
+    return (DCUK_JOB_NONE == u8Job) ? LL_OK : LL_ERR_BUSY;
+}
+
+/**
+ * @brief  波形下一步的参考模型, 与 Tools/dcu_model.py 的 wave_next 一致
+ * @param  [in]  u32Mode                @ref DCUK_Wave_Mode
+ * @param  [in]  u32Val                 当前值
+ * @param  [in]  pu8Down                三角波方向, 1 为下降
+ * @param  [in]  pstcWave               上下限与步长
+ * @retval 下一步的值
+ */
+static uint32_t DCUK_WaveNext(uint32_t u32Mode, uint32_t u32Val, uint8_t *pu8Down, const stc_dcuk_wave_t *pstcWave) {
+    if (DCUK_WAVE_SAW_UP == u32Mode) {
+        u32Val = ((u32Val + pstcWave->u32Step) > pstcWave->u32Upper) ? pstcWave->u32Lower : (u32Val + pstcWave->u32Step);
+    } else if (DCUK_WAVE_SAW_DOWN == u32Mode) {
+        u32Val = (u32Val < (pstcWave->u32Lower + pstcWave->u32Step)) ? pstcWave->u32Upper : (u32Val - pstcWave->u32Step);
+    } else if (0U == *pu8Down) {
+        if ((u32Val + pstcWave->u32Step) >= pstcWave->u32Upper) {
+            u32Val = pstcWave->u32Upper;
+            *pu8Down = 1U;
+        } else {
+            u32Val += pstcWave->u32Step;
+        }
+    } else {
+        if (u32Val <= (pstcWave->u32Lower + pstcWave->u32Step)) {
+            u32Val = pstcWave->u32Lower;
+            *pu8Down = 0U;
+        } else {
+            u32Val -= pstcWave->u32Step;
+        }
+    }
+
+    return u32Val;
+}
+
+static void DCUK_WaveDcu(const stc_dcuk_wave_t *pstcWave) {
+    stc_dcu_init_t stcDcu;
+    stc_dcu_wave_config_t stcWave;
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DCU1 << DCUK_Unit(pstcWave->DCUx), ENABLE);
+    stcDcu.u32Mode = pstcWave->u32Mode;
+    stcDcu.u32DataWidth = DCU_DATA_WIDTH_16BIT;
+    (void)DCU_Init(pstcWave->DCUx, &stcDcu);
+    stcWave.u32LowerLimit = pstcWave->u32Lower;
+    stcWave.u32UpperLimit = pstcWave->u32Upper;
+    stcWave.u32Step = pstcWave->u32Step;
+    (void)DCU_WaveConfig(pstcWave->DCUx, &stcWave);
+    /* 从起点开始, 不从 0 开始 */
+    DCU_WriteData32(pstcWave->DCUx, DCU_DATA0_IDX,
+                    (DCUK_WAVE_SAW_DOWN == pstcWave->u32Mode) ? pstcWave->u32Upper : pstcWave->u32Lower);
+}
+
+static int32_t DCUK_WaveCheck(const stc_dcuk_wave_t *pstcWave) {
+    if ((NULL == pstcWave) ||
+            ((uint32_t)pstcWave->DCUx < CM_DCU1_BASE) || ((uint32_t)pstcWave->DCUx > CM_DCU4_BASE) ||
+            ((DCUK_WAVE_TRIANGLE != pstcWave->u32Mode) && (DCUK_WAVE_SAW_UP != pstcWave->u32Mode) &&
+             (DCUK_WAVE_SAW_DOWN != pstcWave->u32Mode)) ||
+            (pstcWave->u32Upper > DCUK_WAVE_MAX) || (pstcWave->u32Lower >= pstcWave->u32Upper) ||
+            (0UL == pstcWave->u32Step) || (pstcWave->u32Step > DCUK_WAVE_MAX)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  启动 DCU 波形输出, 每个 enTrigSrc 事件走一步并写入目的寄存器
+ * @param  [in]  pstcWave               波形参数, 停止前不能释放
+ * @retval int32_t:
+ *           - LL_OK:                   已启动, 不占用 CPU
+ *           - LL_ERR_INVD_PARAM:       参数错误(DCU5~8 没有波形功能)
+ *           - LL_ERR_BUSY:             AOS 触发已被占用
+ */
+int32_t DCUK_WaveStart(stc_dcuk_wave_t *pstcWave) {
+    stc_dma_init_t stcDma;
+    int32_t i32Ret;
+
+    i32Ret = DCUK_WaveCheck(pstcWave);
+    if ((LL_OK != i32Ret) || (pstcWave->u8DmaCh > DMA_CH7) ||
+            ((CM_DMA1 != pstcWave->DMAx) && (CM_DMA2 != pstcWave->DMAx))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    DCUK_WaveDcu(pstcWave);
+
+    FCG_Fcg0PeriphClockCmd((CM_DMA1 == pstcWave->DMAx) ? FCG0_PERIPH_DMA1 : FCG0_PERIPH_DMA2, ENABLE);
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = DMA_INT_DISABLE;
+    stcDma.u32SrcAddr = (uint32_t)&pstcWave->DCUx->DATA0;
+    stcDma.u32DestAddr = pstcWave->u32DestAddr;
+    stcDma.u32DataWidth = DMA_DATAWIDTH_16BIT;
+    stcDma.u32BlockSize = 1UL;
+    stcDma.u32TransCount = 0UL;             /* 0: 无限次 */
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(pstcWave->DMAx, pstcWave->u8DmaCh, &stcDma);
+    DMA_Cmd(pstcWave->DMAx, ENABLE);
+    (void)DMA_ChCmd(pstcWave->DMAx, pstcWave->u8DmaCh, ENABLE);
+
+    pstcWave->astcLink[0].enSrc = pstcWave->enTrigSrc;
+    pstcWave->astcLink[0].u32Target = AOS_DCU1 + 4UL * (uint32_t)DCUK_Unit(pstcWave->DCUx);
+    pstcWave->astcLink[1].enSrc = pstcWave->enTrigSrc;
+    pstcWave->astcLink[1].u32Target = DCUK_DmaTarget(pstcWave->DMAx, pstcWave->u8DmaCh);
+    i32Ret = AOSG_Apply(pstcWave->astcLink, 2U, &pstcWave->stcPlan);
+
+    if (LL_OK != i32Ret) {
+        (void)DMA_ChCmd(pstcWave->DMAx, pstcWave->u8DmaCh, DISABLE);
+        (void)DCU_DeInit(pstcWave->DCUx);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  停止波形输出, 目的寄存器保持最后一个值
+ * @param  [in]  pstcWave               DCUK_WaveStart 成功的参数
+ * @retval 无
+ */
+void DCUK_WaveStop(stc_dcuk_wave_t *pstcWave) {
+    AOSG_Release(pstcWave->astcLink, 2U, &pstcWave->stcPlan);
+    (void)DMA_ChCmd(pstcWave->DMAx, pstcWave->u8DmaCh, DISABLE);
+    (void)DCU_DeInit(pstcWave->DCUx);
+}
+
+static void DCUK_TestMatch(uint32_t u32Index, uint32_t u32Value) {
+    if (((u32Value >= DCUK_TEST_LOW) && (u32Value <= DCUK_TEST_HIGH)) || (u32Index >= m_u32Num)) {
+        m_u8TestBad = 1U;
+    }
+    m_u32TestCount++;
+}
+
+static int32_t DCUK_TestWait(stc_dcuk_result_t *pstcResult, uint32_t u32Num) {
+    uint32_t u32Timeout = 100000UL + 100UL * u32Num;
+
+    while (LL_ERR_BUSY == DCUK_GetResult(pstcResult)) {
+        if (0UL == u32Timeout--) {
+            DCUK_Abort();
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    return LL_OK;
+}
+
+/* 与 Tools/dcu_model.py 的 lcg 相同 */
+static uint32_t DCUK_Lcg(uint32_t *pu32State) {
+    *pu32State = *pu32State * 1664525UL + 1013904223UL;
+    return *pu32State;
+}
+
+/**
+ * @brief  用 DCUK_Init 配置的硬件对照 CPU 参考实现自检; 配置的是 DCU1~4 时再对照波形模型
+ *         期望值也可由 Tools/dcu_model.py selftest --num <u32Num> 算出
+ * @param  [in]  pu32Work               工作缓冲区, 内容会被改写
+ * @param  [in]  u32Num                 缓冲区字数, 取数千以上才能覆盖多块和进位
+ * @retval int32_t:
+ *           - LL_OK:                   全部一致
+ *           - LL_ERR:                  结果不一致
+ *           - LL_ERR_TIMEOUT:          任务未在预期时间内完成
+ *           - 其余同 DCUK_LimitStart
+ */
+int32_t DCUK_SelfTest(uint32_t *pu32Work, uint32_t u32Num) {
+    stc_dcuk_result_t stcRes;
+    stc_dcuk_wave_t stcWave;
+    uint16_t *pu16Work = (uint16_t *)(void *)pu32Work;
+    uint64_t u64Sum = 0ULL;
+    uint32_t u32Matches = 0UL;
+    uint32_t u32First = DCUK_INDEX_NONE;
+    uint32_t u32State;
+    uint32_t u32Val;
+    uint32_t u32Hw;
+    uint32_t i;
+    uint8_t u8Down = 0U;
+    int32_t i32Ret;
+
+    if ((NULL == pu32Work) || (0UL == u32Num)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    /* 1. 24 位样本累加, 块长 256, 覆盖进位 */
+    u32State = DCUK_TEST_SEED;
+    for (i = 0UL; i < u32Num; i++) {
+        pu32Work[i] = DCUK_Lcg(&u32State) >> 8U;
+        u64Sum += pu32Work[i];
+    }
+    i32Ret = DCUK_AccumStart(pu32Work, u32Num, 0x00FFFFFFUL);
+    if (LL_OK == i32Ret) {
+        i32Ret = DCUK_TestWait(&stcRes, u32Num);
+    }
+    if ((LL_OK == i32Ret) && (stcRes.u64Sum != u64Sum)) {
+        i32Ret = LL_ERR;
+    }
+
+    /* 2. 12 位样本越限检查, 全部回调 */
+    if (LL_OK == i32Ret) {
+        u32State = DCUK_TEST_SEED;
+        for (i = 0UL; i < u32Num; i++) {
+            pu16Work[i] = (uint16_t)(DCUK_Lcg(&u32State) >> 20U);
+            if ((pu16Work[i] < DCUK_TEST_LOW) || (pu16Work[i] > DCUK_TEST_HIGH)) {
+                if (0UL == u32Matches) {
+                    u32First = i;
+                }
+                u32Matches++;
+            }
+        }
+
+        m_u32TestCount = 0UL;
+        m_u8TestBad = 0U;
+        i32Ret = DCUK_LimitStart(pu16Work, u32Num, DCUK_WIDTH_16BIT, DCUK_TEST_LOW, DCUK_TEST_HIGH,
+                                 DCUK_LIMIT_ALL, &DCUK_TestMatch);
+        if (LL_OK == i32Ret) {
+            i32Ret = DCUK_TestWait(&stcRes, u32Num);
+        }
+        if ((LL_OK == i32Ret) && ((stcRes.u32Matches != u32Matches) || (stcRes.u32FirstIndex != u32First) ||
+                                  (m_u32TestCount != u32Matches) || (0U != m_u8TestBad))) {
+            i32Ret = LL_ERR;
+        }
+    }
+
+    /* 3. 同一数据, 首个越限即停 */
+    if (LL_OK == i32Ret) {
+        i32Ret = DCUK_LimitStart(pu16Work, u32Num, DCUK_WIDTH_16BIT, DCUK_TEST_LOW, DCUK_TEST_HIGH,
+                                 DCUK_LIMIT_FIRST, NULL);
+        if (LL_OK == i32Ret) {
+            i32Ret = DCUK_TestWait(&stcRes, u32Num);
+        }
+        if ((LL_OK == i32Ret) &&
+                ((stcRes.u32FirstIndex != u32First) || (stcRes.u32Matches != ((0UL == u32Matches) ? 0UL : 1UL)))) {
+            i32Ret = LL_ERR;
+        }
+    }
+
+    /* 4. 三角波逐步对照模型, 软件触发步进 */
+    if ((LL_OK == i32Ret) && ((uint32_t)m_stcCfg.DCUx <= CM_DCU4_BASE)) {
+        stcWave.DCUx = m_stcCfg.DCUx;
+        stcWave.u32Mode = DCUK_WAVE_TRIANGLE;
+        stcWave.u32Lower = 0x100UL;
+        stcWave.u32Upper = 0xE00UL;
+        stcWave.u32Step = 0x0B3UL;
+        DCUK_WaveDcu(&stcWave);
+
+        stcWave.astcLink[0].enSrc = EVT_SRC_AOS_STRG;
+        stcWave.astcLink[0].u32Target = AOS_DCU1 + 4UL * (uint32_t)DCUK_Unit(stcWave.DCUx);
+        i32Ret = AOSG_Apply(stcWave.astcLink, 1U, &stcWave.stcPlan);
+
+        u32Val = stcWave.u32Lower;
+        for (i = 0UL; (LL_OK == i32Ret) && (i < DCUK_TEST_WAVE_STEPS); i++) {
+            AOS_SW_Trigger();
+            u32Val = DCUK_WaveNext(stcWave.u32Mode, u32Val, &u8Down, &stcWave);
+            u32Hw = DCU_ReadData32(stcWave.DCUx, DCU_DATA0_IDX) & 0xFFFFUL;
+            if (u32Hw != u32Val) {
+                i32Ret = LL_ERR;
+            }
+        }
+
+        if (LL_ERR_BUSY != i32Ret) {
+            AOSG_Release(stcWave.astcLink, 1U, &stcWave.stcPlan);
+        }
+        (void)DCU_DeInit(stcWave.DCUx);
+    }
+
+    return i32Ret;
+}
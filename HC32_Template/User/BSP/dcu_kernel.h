@@ -0,0 +1,120 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : dcu_kernel.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCU + DMA 批量运算
+                   DCUK_LimitStart: DMA 把缓冲区逐个写入 DCU 比较, 超出 [下限, 上限] 的样本由 DCU
+                   中断标记所在块, 只对被标记的块用 CPU 定位, 其余块 CPU 不碰;
+                   DCUK_AccumStart: DMA 把 32 位样本逐个写入 DCU 加法, 按块统计进位, 得到 64 位和;
+                   DCUK_WaveStart: DCU1~4 的三角波/锯齿波由定时器事件步进, 同一事件让 DMA 把
+                   结果搬到 DAC 数据寄存器, 运行中不进中断.
+                   同一时间只运行一个批量任务; 波形与批量任务使用各自的 DCU/DMA 通道.
+                   逐位一致的主机模型: Tools/dcu_model.py, 其 ctest 在主机上编译本模块对照模型.
+  * Function List:
+                   DCUK_Init
+                   DCUK_LimitStart
+                   DCUK_AccumStart
+                   DCUK_Abort
+                   DCUK_GetResult
+                   DCUK_WaveStart
+                   DCUK_WaveStop
+                   DCUK_SelfTest
+  ******************************************************
+**/
+
+#ifndef __DCU_KERNEL_H_
+#define __DCU_KERNEL_H_
+
+#include "hc32_ll.h"
+#include "aos_graph.h"
+
+#define DCUK_BLOCK_MAX              (1024U)     /*!< DMA 一块最多 1024 个数据 */
+#define DCUK_INDEX_NONE             (0xFFFFFFFFUL)
+
+/**
+ * @defgroup DCUK_Width 样本宽度(字节)
+ */
+#define DCUK_WIDTH_8BIT             (1U)
+#define DCUK_WIDTH_16BIT            (2U)
+#define DCUK_WIDTH_32BIT            (4U)
+
+/**
+ * @defgroup DCUK_Limit_Mode 越限检查方式
+ */
+#define DCUK_LIMIT_ALL              (0U)        /*!< 每个越限样本回调一次 */
+#define DCUK_LIMIT_FIRST            (1U)        /*!< 第一个越限样本回调后停止 */
+
+/**
+ * @defgroup DCUK_Wave_Mode 波形
+ */
+#define DCUK_WAVE_TRIANGLE          (DCU_MD_TRIANGLE_WAVE)
+#define DCUK_WAVE_SAW_UP            (DCU_MD_SAWTOOTH_WAVE_INC)
+#define DCUK_WAVE_SAW_DOWN          (DCU_MD_SAWTOOTH_WAVE_DEC)
+#define DCUK_WAVE_MAX               (0xFFFUL)   /*!< 上下限与步长均为 12 位 */
+
+/**
+ * @brief 越限回调, 在中断中执行
+ */
+typedef void (*func_dcuk_match_t)(uint32_t u32Index, uint32_t u32Value);
+
+/**
+ * @brief 批量任务使用的硬件
+ */
+typedef struct {
+    CM_DCU_TypeDef *DCUx;           /*!< CM_DCU1~8 */
+    CM_DMA_TypeDef *DMAx;           /*!< CM_DMA1 / CM_DMA2 */
+    uint8_t u8DmaCh;                /*!< DMA_CH0~7 */
+    IRQn_Type enDmaIRQn;            /*!< 登记该通道传输完成中断 */
+    IRQn_Type enDcuIRQn;            /*!< 登记 DCU 中断 */
+    uint32_t u32IrqPrio;            /*!< DDL_IRQ_PRIO_xx, 两个中断同一优先级 */
+} stc_dcuk_config_t;
+
+/**
+ * @brief 批量任务结果
+ */
+typedef struct {
+    uint32_t u32Done;               /*!< 已处理的样本数 */
+    uint32_t u32Matches;            /*!< 越限样本数 */
+    uint32_t u32FirstIndex;         /*!< 第一个越限样本的序号, 没有时为 DCUK_INDEX_NONE */
+    uint32_t u32Blocks;             /*!< DMA 块数 */
+    uint32_t u32ScanBlocks;         /*!< 由 CPU 定位过的块数 */
+    uint64_t u64Sum;                /*!< 累加结果, 运行中为已完成各块之和 */
+} stc_dcuk_result_t;
+
+/**
+ * @brief 波形输出. 前半部分由调用者填写, 后半部分由本模块使用, 停止前不能释放.
+ */
+typedef struct {
+    CM_DCU_TypeDef *DCUx;           /*!< CM_DCU1~4 */
+    CM_DMA_TypeDef *DMAx;
+    uint8_t u8DmaCh;
+    en_event_src_t enTrigSrc;       /*!< 步进事件, 如定时器上溢 */
+    uint32_t u32Mode;               /*!< @ref DCUK_Wave_Mode */
+    uint32_t u32Lower;
+    uint32_t u32Upper;
+    uint32_t u32Step;
+    uint32_t u32DestAddr;           /*!< 如 (uint32_t)&CM_DAC1->DADR1, 16 位写入 */
+
+    stc_aosg_link_t astcLink[2];
+    stc_aosg_plan_t stcPlan;
+} stc_dcuk_wave_t;
+
+int32_t DCUK_Init(const stc_dcuk_config_t *pstcConfig);
+int32_t DCUK_LimitStart(const void *pvBuf, uint32_t u32Num, uint8_t u8Width,
+                        uint32_t u32Low, uint32_t u32High, uint8_t u8Mode, func_dcuk_match_t pfnMatch);
+int32_t DCUK_AccumStart(const uint32_t *pu32Buf, uint32_t u32Num, uint32_t u32MaxSample);
+void DCUK_Abort(void);
+int32_t DCUK_GetResult(stc_dcuk_result_t *pstcResult);
+int32_t DCUK_WaveStart(stc_dcuk_wave_t *pstcWave);
+void DCUK_WaveStop(stc_dcuk_wave_t *pstcWave);
+int32_t DCUK_SelfTest(uint32_t *pu32Work, uint32_t u32Num);
+
+#endif
@@ -0,0 +1,102 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : drv_profile.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 驱动构建配置的速度对比
+                   1. 每项先测一次空循环, 结果扣除空循环的周期数后除以 DRVPROF_LOOP;
+                   2. GPIO 项会让指定引脚翻转 2 * DRVPROF_LOOP 次, 结束后电平不变;
+                   3. DMA 项只写 DMA1 通道 0 的地址/计数寄存器并关闭通道, 不会启动传输,
+                      测量前该通道不能在用.
+  * Function List:
+
+  **********************************************************
+ */
+#include "drv_profile.h"
+
+#define DRVPROF_POTR(port)          (*(__IO uint16_t *)((uint32_t)&CM_GPIO->POTRA + 0x10UL * (uint32_t)(port)))
+
+static uint32_t DRVPROF_Empty(void) {
+    __IO uint32_t u32Loop;
+    uint32_t u32Start = DWT->CYCCNT;
+
+    for (u32Loop = 0UL; u32Loop < DRVPROF_LOOP; u32Loop++) {
+    }
+
+    return DWT->CYCCNT - u32Start;
+}
+
+static uint32_t DRVPROF_Avg(uint32_t u32Cycles, uint32_t u32Empty) {
+    return (u32Cycles > u32Empty) ? ((u32Cycles - u32Empty) / DRVPROF_LOOP) : 0UL;
+}
+
+/**
+ * @brief  测量当前构建配置下驱动函数与直接写寄存器的周期数
+ * @param  [in]  u8Port                 用于 GPIO 测试的端口, 须已配置为输出
+ * @param  [in]  u16Pin                 用于 GPIO 测试的引脚
+ * @param  [out] pstcResult             结果
+ * @retval 无
+ */
+void DRVPROF_Run(uint8_t u8Port, uint16_t u16Pin, stc_drvprof_result_t *pstcResult) {
+    __IO uint32_t u32Loop;
+    uint32_t u32Empty;
+    uint32_t u32Start;
+
+#ifdef __DEBUG
+    pstcResult->pcProfile = "checked";
+#else
+    pstcResult->pcProfile = "release";
+#endif
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0UL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    u32Empty = DRVPROF_Empty();
+
+    u32Start = DWT->CYCCNT;
+    for (u32Loop = 0UL; u32Loop < DRVPROF_LOOP; u32Loop++) {
+        GPIO_TogglePins(u8Port, u16Pin);
+    }
+    pstcResult->u32GpioDrv = DRVPROF_Avg(DWT->CYCCNT - u32Start, u32Empty);
+
+    u32Start = DWT->CYCCNT;
+    for (u32Loop = 0UL; u32Loop < DRVPROF_LOOP; u32Loop++) {
+        WRITE_REG16(DRVPROF_POTR(u8Port), u16Pin);
+    }
+    pstcResult->u32GpioReg = DRVPROF_Avg(DWT->CYCCNT - u32Start, u32Empty);
+
+#if (LL_DMA_ENABLE == DDL_ON)
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DMA1, ENABLE);
+    DMA_Cmd(CM_DMA1, ENABLE);
+
+    u32Start = DWT->CYCCNT;
+    for (u32Loop = 0UL; u32Loop < DRVPROF_LOOP; u32Loop++) {
+        (void)DMA_SetSrcAddr(CM_DMA1, DMA_CH0, u32Loop);
+        (void)DMA_SetDestAddr(CM_DMA1, DMA_CH0, u32Loop);
+        (void)DMA_SetTransCount(CM_DMA1, DMA_CH0, 1U);
+        (void)DMA_ChCmd(CM_DMA1, DMA_CH0, DISABLE);
+    }
+    pstcResult->u32DmaDrv = DRVPROF_Avg(DWT->CYCCNT - u32Start, u32Empty);
+
+    u32Start = DWT->CYCCNT;
+    for (u32Loop = 0UL; u32Loop < DRVPROF_LOOP; u32Loop++) {
+        WRITE_REG32(CM_DMA1->SAR0, u32Loop);
+        WRITE_REG32(CM_DMA1->DAR0, u32Loop);
+        MODIFY_REG32(CM_DMA1->DTCTL0, DMA_DTCTL_CNT, 1UL << DMA_DTCTL_CNT_POS);
+        WRITE_REG32(CM_DMA1->CHENCLR, 1UL << DMA_CH0);
+    }
+    pstcResult->u32DmaReg = DRVPROF_Avg(DWT->CYCCNT - u32Start, u32Empty);
+#else
+    pstcResult->u32DmaDrv = 0UL;
+    pstcResult->u32DmaReg = 0UL;
+#endif
+}
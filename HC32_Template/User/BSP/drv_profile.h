@@ -0,0 +1,43 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : drv_profile.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 驱动构建配置的速度对比
+                   Debug 目标(__DEBUG)保留 DDL_ASSERT, 寄存器访问函数为普通函数;
+                   release 目标去掉 DDL_ASSERT, 并由 LL_INLINE_ENABLE 把 DMA/GPIO 的寄存器访问函数内联.
+                   DRVPROF_Run 用 DWT 周期计数器分别测量通过驱动函数和直接写寄存器完成同一操作的周期数,
+                   两个目标各运行一次即可对比; 代码大小见链接后生成的 Template_size.txt 和 .map.
+  * Function List:
+                   DRVPROF_Run
+  ******************************************************
+**/
+
+#ifndef __DRV_PROFILE_H_
+#define __DRV_PROFILE_H_
+
+#include "hc32_ll.h"
+
+#define DRVPROF_LOOP                (256U)      /*!< 每项重复次数, 结果取平均 */
+
+/**
+ * @brief 测量结果, 单位: CPU 周期/次, 已扣除循环本身的开销
+ */
+typedef struct {
+    const char *pcProfile;          /*!< "checked" 或 "release" */
+    uint32_t u32GpioDrv;            /*!< GPIO_TogglePins */
+    uint32_t u32GpioReg;            /*!< 直接写 POTR */
+    uint32_t u32DmaDrv;             /*!< DMA 重新装载一次: 源地址、目的地址、传输次数、关闭通道, 需 LL_DMA_ENABLE */
+    uint32_t u32DmaReg;             /*!< 同上, 直接写寄存器 */
+} stc_drvprof_result_t;
+
+void DRVPROF_Run(uint8_t u8Port, uint16_t u16Pin, stc_drvprof_result_t *pstcResult);
+
+#endif
@@ -0,0 +1,529 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : eth_netif.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 以太网网络接口驱动
+                   1. 接收描述符按序号每 u8RxCoalesce 个中有一个不置 DIC, 其余置 DIC 的帧只在 RX 看门狗
+                      到期后产生 RI; 中断里屏蔽 RIE 并通知任务, ETHIF_Poll 收空描述符环后再打开 RIE,
+                      突发时一次中断处理一批帧;
+                   2. 接收描述符不绑定固定缓冲区, 每收一帧把缓冲区整块交给协议栈, 空出的描述符
+                      攒到 ETHIF_RX_REFILL_BATCH 个再从缓冲区池统一补上, 一批只写一次 RXPOLLR;
+                   3. MAC 打开 IPC 校验, DMA 丢弃 TCP/IP 校验和错误的帧, 通过的帧按 RDES4 置
+                      ETHIF_BUF_FLAG_xx; 发送描述符的 CIC 为 TCPUDPICMP_FULL, 由硬件填 IPv4 头和
+                      TCP/UDP/ICMP 校验和(含伪首部), 需保持发送 store-and-forward(默认);
+                   4. 发送一个缓冲区占一个描述符, 首描述符最后交给 DMA; 已发完的缓冲区在 ETHIF_Output
+                      和 ETHIF_Poll 中回收, 不用发送中断;
+                   5. ETHIF_Poll 和 ETHIF_Output 须在同一任务中调用(如 lwIP 的 tcpip 线程),
+                      ETHIF_BufAlloc/ETHIF_BufFree 可在任意上下文调用;
+                   6. ETH 引脚和 PHY 时钟须在 ETHIF_Init 前配置好, PHY 参数见 hc32f4xx_conf.h.
+  * Function List:
+
+  **********************************************************
+ */
+#include "eth_netif.h"
+#include "string.h"
+
+#define ETHIF_RX_FRAL_POS           (16U)
+#define ETHIF_RX_INT                (ETH_DMA_INT_NIE | ETH_DMA_INT_RIE | ETH_DMA_INT_AIE | \
+                                     ETH_DMA_INT_RUE | ETH_DMA_INT_OVE)
+#define ETHIF_NEXT(idx, num)        (((idx) + 1UL < (num)) ? ((idx) + 1UL) : 0UL)
+
+__ALIGN_BEGIN static stc_eth_dma_desc_t m_astcRxDesc[ETHIF_RX_DESC_NUM];
+__ALIGN_BEGIN static stc_eth_dma_desc_t m_astcTxDesc[ETHIF_TX_DESC_NUM];
+__ALIGN_BEGIN static stc_ethif_buf_t m_astcBuf[ETHIF_BUF_NUM];
+
+static stc_ethif_buf_t *m_apstcRxBuf[ETHIF_RX_DESC_NUM];
+static stc_ethif_buf_t *m_apstcTxBuf[ETHIF_TX_DESC_NUM];
+static stc_ethif_buf_t *m_pstcFree;
+
+static stc_eth_handle_t m_stcEthHandle;
+static func_ethif_input_t m_pfnInput;
+static func_ethif_notify_t m_pfnNotify;
+static func_ethif_txts_t m_pfnTxTimestamp;
+static IRQn_Type m_enIRQn;
+static uint8_t m_u8RxWatchdog;
+static uint8_t m_u8RxCoalesce;
+
+/* 接收环: m_u32RxHead 起 m_u32RxArmed 个描述符挂有缓冲区, m_u32RxTail 为下一个待补的描述符 */
+static uint32_t m_u32RxHead;
+static uint32_t m_u32RxTail;
+static uint32_t m_u32RxArmed;
+/* 发送环: m_u32TxTail 起 m_u32TxUsed 个描述符未回收, m_u32TxHead 为下一个可用描述符 */
+static uint32_t m_u32TxHead;
+static uint32_t m_u32TxTail;
+static uint32_t m_u32TxUsed;
+
+static stc_ethif_stats_t m_stcStats;
+
+static void ETHIF_RxArm(uint32_t u32Idx, stc_ethif_buf_t *pstcBuf) {
+    stc_eth_dma_desc_t *pstcDesc = &m_astcRxDesc[u32Idx];
+    uint32_t u32Ctrl = ETHIF_BUF_SIZE | ETH_DMA_RXDESC_RSAC;
+
+    /* 看门狗为 0 时 DIC 帧不会产生 RI, 只能每帧中断 */
+    if ((0U != m_u8RxWatchdog) && (0UL != ((u32Idx + 1UL) % m_u8RxCoalesce))) {
+        u32Ctrl |= ETH_DMA_RXDESC_DIC;
+    }
+
+    m_apstcRxBuf[u32Idx] = pstcBuf;
+    pstcDesc->u32Buf1Addr = (uint32_t)pstcBuf->au8Data;
+    pstcDesc->u32ControlBufSize = u32Ctrl;
+    /* 时间戳字只在取到时间戳时由 DMA 写入, 清零后用非零判断是否有效 */
+    pstcDesc->u32TimestampLow = 0UL;
+    pstcDesc->u32TimestampHigh = 0UL;
+    __DMB();
+    pstcDesc->u32ControlStatus = ETH_DMA_RXDESC_OWN;
+}
+
+static void ETHIF_RxRefill(void) {
+    stc_ethif_buf_t *pstcBuf;
+    uint32_t u32Num = 0UL;
+
+    while (m_u32RxArmed < ETHIF_RX_DESC_NUM) {
+        pstcBuf = ETHIF_BufAlloc();
+
+        if (NULL == pstcBuf) {
+            m_stcStats.u32RxNoBuf++;
+            break;
+        }
+
+        ETHIF_RxArm(m_u32RxTail, pstcBuf);
+        m_u32RxTail = ETHIF_NEXT(m_u32RxTail, ETHIF_RX_DESC_NUM);
+        m_u32RxArmed++;
+        u32Num++;
+    }
+
+    if (0UL != u32Num) {
+        /* DMA 因无可用描述符挂起时从这里恢复 */
+        WRITE_REG32(CM_ETH->DMA_RXPOLLR, 0UL);
+    }
+}
+
+static uint16_t ETHIF_RxFlags(uint32_t u32Ext) {
+    uint16_t u16Flags = 0U;
+    uint32_t u32Type = u32Ext & ETH_DMA_RXDESC_IPPT;
+
+    if ((0UL == (u32Ext & (ETH_DMA_RXDESC_IPV4DR | ETH_DMA_RXDESC_IPV6DR))) ||
+        (0UL != (u32Ext & (ETH_DMA_RXDESC_IPCB | ETH_DMA_RXDESC_IPHE)))) {
+        return 0U;
+    }
+
+    if (0UL != (u32Ext & ETH_DMA_RXDESC_IPV6DR)) {
+        u16Flags |= ETHIF_BUF_FLAG_IPV6;
+    } else {
+        u16Flags |= ETHIF_BUF_FLAG_IP_CSUM_OK;
+    }
+
+    if ((ETH_DMA_RXDESC_IPPT_UNKNOWN != u32Type) && (0UL == (u32Ext & ETH_DMA_RXDESC_IPPE))) {
+        u16Flags |= ETHIF_BUF_FLAG_L4_CSUM_OK;
+    }
+
+    return u16Flags;
+}
+
+static void ETHIF_TxReclaim(void) {
+    stc_eth_dma_desc_t *pstcDesc;
+    uint32_t u32Status;
+
+    while (0UL != m_u32TxUsed) {
+        pstcDesc = &m_astcTxDesc[m_u32TxTail];
+        u32Status = pstcDesc->u32ControlStatus;
+
+        if (0UL != (u32Status & ETH_DMA_TXDESC_OWN)) {
+            break;
+        }
+
+        if (0UL != (u32Status & ETH_DMA_TXDESC_TLS)) {
+            if (0UL != (u32Status & ETH_DMA_TXDESC_ETSUM)) {
+                m_stcStats.u32TxErrors++;
+            }
+
+            /* 时间戳写在帧的最后一个描述符 */
+            if ((0UL != (u32Status & ETH_DMA_TXDESC_TTSS)) && (NULL != m_pfnTxTimestamp)) {
+                m_pfnTxTimestamp(pstcDesc->u32TimestampHigh, pstcDesc->u32TimestampLow);
+            }
+        }
+
+        ETHIF_BufFree(m_apstcTxBuf[m_u32TxTail]);
+        m_apstcTxBuf[m_u32TxTail] = NULL;
+        m_u32TxTail = ETHIF_NEXT(m_u32TxTail, ETHIF_TX_DESC_NUM);
+        m_u32TxUsed--;
+    }
+}
+
+/**
+ * @brief  初始化 MAC/PHY、描述符环和缓冲区池, 登记 ETH 中断
+ * @param  [in]  pstcConfig             初始化参数
+ * @retval int32_t:
+ *           - LL_OK: 成功
+ *           - LL_ERR_INVD_PARAM: 参数错误或 PHY 无响应
+ *           - LL_ERR_TIMEOUT: PHY 复位或自协商超时
+ *           - LL_ERR_UNINIT: 中断号已被占用
+ */
+int32_t ETHIF_Init(const stc_ethif_config_t *pstcConfig) {
+    stc_eth_init_t stcEthInit;
+    stc_irq_signin_config_t stcIrq;
+    int32_t i32Ret;
+    uint32_t i;
+
+    if ((NULL == pstcConfig) || (NULL == pstcConfig->pfnInput) ||
+        (0U == pstcConfig->u8RxCoalesce) || (pstcConfig->u8RxCoalesce > ETHIF_RX_DESC_NUM)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_pfnInput = pstcConfig->pfnInput;
+    m_pfnNotify = pstcConfig->pfnNotify;
+    m_pfnTxTimestamp = pstcConfig->pfnTxTimestamp;
+    m_enIRQn = pstcConfig->enIRQn;
+    m_u8RxWatchdog = pstcConfig->u8RxWatchdog;
+    m_u8RxCoalesce = pstcConfig->u8RxCoalesce;
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    FCG_Fcg1PeriphClockCmd(FCG1_PERIPH_ETHMAC, ENABLE);
+    (void)ETH_DeInit();
+
+    (void)ETH_CommStructInit(&m_stcEthHandle.stcCommInit);
+    (void)memcpy(m_stcEthHandle.stcCommInit.au8MacAddr, pstcConfig->au8MacAddr, 6U);
+    m_stcEthHandle.stcCommInit.u32Interface = pstcConfig->u32Interface;
+    m_stcEthHandle.stcCommInit.u32ChecksumMode = ETH_MAC_CHECKSUM_MD_HW;
+    m_stcEthHandle.stcCommInit.u32ReceiveMode = ETH_RX_MD_INT;
+
+    (void)ETH_StructInit(&stcEthInit);
+    /* 所有帧都去掉 FCS, RDES0 的帧长即协议栈看到的长度 */
+    stcEthInit.stcMacInit.u32TypeFrameStripFCS = ETH_MAC_TYPE_FRAME_STRIP_FCS_ENABLE;
+    stcEthInit.stcMacInit.u32AutoStripPadFCS = ETH_MAC_AUTO_STRIP_PAD_FCS_ENABLE;
+    /* RDES4 的校验结果只在增强描述符中有 */
+    stcEthInit.stcDmaInit.u32EnhanceDesc = ETH_DMA_ENHANCE_DESC_ENABLE;
+    stcEthInit.stcDmaInit.u32DropChecksumErrorFrame = ETH_DMA_DROP_CHECKSUM_ERR_FRAME_ENABLE;
+    stcEthInit.stcDmaInit.u32TransStoreForward = ETH_DMA_TRANS_STORE_FORWARD_ENABLE;
+
+    i32Ret = ETH_Init(&m_stcEthHandle, &stcEthInit);
+
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    m_pstcFree = NULL;
+
+    for (i = 0UL; i < ETHIF_BUF_NUM; i++) {
+        ETHIF_BufFree(&m_astcBuf[i]);
+    }
+
+    for (i = 0UL; i < ETHIF_RX_DESC_NUM; i++) {
+        m_astcRxDesc[i].u32ControlStatus = 0UL;
+        m_astcRxDesc[i].u32Buf2NextDescAddr = (uint32_t)&m_astcRxDesc[ETHIF_NEXT(i, ETHIF_RX_DESC_NUM)];
+        m_apstcRxBuf[i] = NULL;
+    }
+
+    for (i = 0UL; i < ETHIF_TX_DESC_NUM; i++) {
+        m_astcTxDesc[i].u32ControlStatus = 0UL;
+        m_astcTxDesc[i].u32Buf2NextDescAddr = (uint32_t)&m_astcTxDesc[ETHIF_NEXT(i, ETHIF_TX_DESC_NUM)];
+        m_apstcTxBuf[i] = NULL;
+    }
+
+    m_u32RxHead = 0UL;
+    m_u32RxTail = 0UL;
+    m_u32RxArmed = 0UL;
+    m_u32TxHead = 0UL;
+    m_u32TxTail = 0UL;
+    m_u32TxUsed = 0UL;
+
+    WRITE_REG32(CM_ETH->DMA_RXDLADR, (uint32_t)m_astcRxDesc);
+    WRITE_REG32(CM_ETH->DMA_TXDLADR, (uint32_t)m_astcTxDesc);
+    ETHIF_RxRefill();
+
+    ETH_DMA_SetRxWatchdogCounter(m_u8RxWatchdog);
+    ETH_DMA_IntCmd(ETH_DMA_INT_ALL, DISABLE);
+    ETH_DMA_ClearStatus(ETH_DMA_FLAG_CLR_ALL);
+    ETH_DMA_IntCmd(ETHIF_RX_INT, ENABLE);
+
+    stcIrq.enIntSrc = INT_SRC_ETH_GLB_INT;
+    stcIrq.enIRQn = m_enIRQn;
+    stcIrq.pfnCallback = &ETHIF_IrqHandler;
+    i32Ret = INTC_IrqSignIn(&stcIrq);
+
+    if (LL_OK == i32Ret) {
+        NVIC_ClearPendingIRQ(m_enIRQn);
+        NVIC_SetPriority(m_enIRQn, pstcConfig->u32IrqPrio);
+        NVIC_EnableIRQ(m_enIRQn);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  启动 MAC 和 DMA 收发
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK: 成功
+ *           - LL_ERR_TIMEOUT: 发送 FIFO 清空超时
+ */
+int32_t ETHIF_Start(void) {
+    return ETH_Start();
+}
+
+/**
+ * @brief  停止 MAC 和 DMA 收发, 描述符和缓冲区保持不变
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK: 成功
+ *           - LL_ERR_TIMEOUT: 发送 FIFO 清空超时
+ */
+int32_t ETHIF_Stop(void) {
+    NVIC_DisableIRQ(m_enIRQn);
+
+    return ETH_Stop();
+}
+
+/**
+ * @brief  收取已完成的帧交给协议栈, 补接收描述符, 回收已发送的缓冲区
+ * @param  [in]  u32Budget              本次最多收取的帧数
+ * @retval 本次交给协议栈的帧数, 等于 u32Budget 时环中可能还有帧, 应再次调用
+ * @note   收空描述符环后重新打开接收中断
+ */
+uint32_t ETHIF_Poll(uint32_t u32Budget) {
+    stc_eth_dma_desc_t *pstcDesc;
+    stc_ethif_buf_t *pstcBuf;
+    uint32_t u32Status;
+    uint32_t u32Num = 0UL;
+
+    ETHIF_TxReclaim();
+
+    while ((u32Num < u32Budget) && (0UL != m_u32RxArmed)) {
+        pstcDesc = &m_astcRxDesc[m_u32RxHead];
+        u32Status = pstcDesc->u32ControlStatus;
+
+        if (0UL != (u32Status & ETH_DMA_RXDESC_OWN)) {
+            break;
+        }
+
+        pstcBuf = m_apstcRxBuf[m_u32RxHead];
+        m_apstcRxBuf[m_u32RxHead] = NULL;
+        m_u32RxHead = ETHIF_NEXT(m_u32RxHead, ETHIF_RX_DESC_NUM);
+        m_u32RxArmed--;
+
+        /* 缓冲区能放下最大帧, 跨描述符的帧只可能是超长帧 */
+        if ((ETH_DMA_RXDESC_RFS | ETH_DMA_RXDESC_RLS) !=
+            (u32Status & (ETH_DMA_RXDESC_ERSUM | ETH_DMA_RXDESC_RFS | ETH_DMA_RXDESC_RLS))) {
+            m_stcStats.u32RxErrors++;
+            ETHIF_BufFree(pstcBuf);
+        } else {
+            pstcBuf->pstcNext = NULL;
+            pstcBuf->pu8Payload = pstcBuf->au8Data;
+            pstcBuf->u16Len = (uint16_t)((u32Status & ETH_DMA_RXDESC_FRAL) >> ETHIF_RX_FRAL_POS);
+            pstcBuf->u16Flags = ETHIF_RxFlags(pstcDesc->u32ExtendStatus);
+            pstcBuf->u32TsSec = pstcDesc->u32TimestampHigh;
+            pstcBuf->u32TsSubsec = pstcDesc->u32TimestampLow;
+
+            if (0UL != (pstcBuf->u32TsSec | pstcBuf->u32TsSubsec)) {
+                pstcBuf->u16Flags |= ETHIF_BUF_FLAG_TIMESTAMP;
+            }
+
+            if (LL_OK == m_pfnInput(pstcBuf)) {
+                m_stcStats.u32RxFrames++;
+            } else {
+                m_stcStats.u32RxRejected++;
+                ETHIF_BufFree(pstcBuf);
+            }
+
+            u32Num++;
+        }
+
+        if ((ETHIF_RX_DESC_NUM - m_u32RxArmed) >= ETHIF_RX_REFILL_BATCH) {
+            ETHIF_RxRefill();
+        }
+    }
+
+    /* 不足一批的空描述符留到下次; 池空时补不上的在这里重试 */
+    if ((ETHIF_RX_DESC_NUM - m_u32RxArmed) >= ETHIF_RX_REFILL_BATCH) {
+        ETHIF_RxRefill();
+    }
+
+    if (u32Num > m_stcStats.u32RxMaxBatch) {
+        m_stcStats.u32RxMaxBatch = u32Num;
+    }
+
+    if (u32Num < u32Budget) {
+        /* RIS 已在中断里清除, 此后完成的帧会重新置位 RIS, 打开 RIE 后立即进中断, 不会漏帧 */
+        ETH_DMA_IntCmd(ETH_DMA_INT_RIE, ENABLE);
+    }
+
+    return u32Num;
+}
+
+/**
+ * @brief  发送一帧
+ * @param  [in]  pstcChain              由 ETHIF_BufAlloc 分配的缓冲区经 pstcNext 串成的一帧
+ * @retval int32_t:
+ *           - LL_OK: 已交给 DMA, 缓冲区发完后由驱动回收
+ *           - LL_ERR_INVD_PARAM: 空帧或某段长度超出描述符
+ *           - LL_ERR_BUSY: 发送描述符不够, 缓冲区仍归调用者
+ */
+int32_t ETHIF_Output(stc_ethif_buf_t *pstcChain) {
+    stc_ethif_buf_t *pstcBuf;
+    stc_eth_dma_desc_t *pstcDesc;
+    uint32_t u32Num = 0UL;
+    uint32_t u32First;
+    uint32_t u32FirstCtrl = 0UL;
+    uint32_t u32Ctrl;
+    uint32_t u32Idx;
+
+    for (pstcBuf = pstcChain; NULL != pstcBuf; pstcBuf = pstcBuf->pstcNext) {
+        if ((0U == pstcBuf->u16Len) || (pstcBuf->u16Len > ETH_DMA_TXDESC_TBS1)) {
+            return LL_ERR_INVD_PARAM;
+        }
+
+        u32Num++;
+    }
+
+    if (0UL == u32Num) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    ETHIF_TxReclaim();
+
+    if (u32Num > (ETHIF_TX_DESC_NUM - m_u32TxUsed)) {
+        m_stcStats.u32TxBusy++;
+        return LL_ERR_BUSY;
+    }
+
+    u32First = m_u32TxHead;
+    u32Idx = u32First;
+
+    for (pstcBuf = pstcChain; NULL != pstcBuf; pstcBuf = pstcBuf->pstcNext) {
+        pstcDesc = &m_astcTxDesc[u32Idx];
+        m_apstcTxBuf[u32Idx] = pstcBuf;
+        pstcDesc->u32Buf1Addr = (uint32_t)pstcBuf->pu8Payload;
+        pstcDesc->u32ControlBufSize = pstcBuf->u16Len;
+
+        u32Ctrl = ETH_DMA_TXDESC_TSAC | ETH_DMA_TXDESC_CHECKSUM_TCPUDPICMP_FULL;
+
+        if (NULL == pstcBuf->pstcNext) {
+            u32Ctrl |= ETH_DMA_TXDESC_TLS;
+        }
+
+        /* DMA 停在首描述符上, 后面的描述符可以先交出去 */
+        if (u32Idx == u32First) {
+            u32FirstCtrl = u32Ctrl | ETH_DMA_TXDESC_TFS;
+
+            if (0U != (pstcBuf->u16Flags & ETHIF_BUF_FLAG_TIMESTAMP)) {
+                u32FirstCtrl |= ETH_DMA_TXDESC_TTSE;
+            }
+        } else {
+            pstcDesc->u32ControlStatus = u32Ctrl | ETH_DMA_TXDESC_OWN;
+        }
+
+        u32Idx = ETHIF_NEXT(u32Idx, ETHIF_TX_DESC_NUM);
+    }
+
+    __DMB();
+    m_astcTxDesc[u32First].u32ControlStatus = u32FirstCtrl | ETH_DMA_TXDESC_OWN;
+    m_u32TxHead = u32Idx;
+    m_u32TxUsed += u32Num;
+    m_stcStats.u32TxFrames++;
+
+    WRITE_REG32(CM_ETH->DMA_TXPOLLR, 0UL);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  从缓冲区池取一个缓冲区
+ * @param  无
+ * @retval 缓冲区, pu8Payload 指向数据区起始; 池空时返回 NULL
+ */
+stc_ethif_buf_t *ETHIF_BufAlloc(void) {
+    stc_ethif_buf_t *pstcBuf;
+    uint32_t u32Primask = __get_PRIMASK();
+
+    __disable_irq();
+    pstcBuf = m_pstcFree;
+
+    if (NULL != pstcBuf) {
+        m_pstcFree = pstcBuf->pstcNext;
+    }
+
+    __set_PRIMASK(u32Primask);
+
+    if (NULL != pstcBuf) {
+        pstcBuf->pstcNext = NULL;
+        pstcBuf->pu8Payload = pstcBuf->au8Data;
+        pstcBuf->u16Len = 0U;
+        pstcBuf->u16Flags = 0U;
+        pstcBuf->u32TsSec = 0UL;
+        pstcBuf->u32TsSubsec = 0UL;
+    }
+
+    return pstcBuf;
+}
+
+/**
+ * @brief  归还一个缓冲区, 只归还这一个, 不沿 pstcNext 释放
+ * @param  [in]  pstcBuf                缓冲区
+ * @retval 无
+ */
+void ETHIF_BufFree(stc_ethif_buf_t *pstcBuf) {
+    uint32_t u32Primask;
+
+    if (NULL == pstcBuf) {
+        return;
+    }
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+    pstcBuf->pstcNext = m_pstcFree;
+    m_pstcFree = pstcBuf;
+    __set_PRIMASK(u32Primask);
+}
+
+/**
+ * @brief  ETH 全局中断处理, 由 ETHIF_Init 登记
+ * @param  无
+ * @retval 无
+ */
+void ETHIF_IrqHandler(void) {
+    uint32_t u32Status = READ_REG32(CM_ETH->DMA_DMASTSR);
+    uint32_t u32Clear = 0UL;
+
+    if (0UL != (u32Status & ETH_DMA_FLAG_RIS)) {
+        /* 屏蔽到 ETHIF_Poll 收空描述符环为止 */
+        ETH_DMA_IntCmd(ETH_DMA_INT_RIE, DISABLE);
+        u32Clear |= ETH_DMA_FLAG_RIS | ETH_DMA_FLAG_NIS;
+        m_stcStats.u32RxIrqs++;
+    }
+
+    if (0UL != (u32Status & ETH_DMA_FLAG_AIS)) {
+        if (0UL != (u32Status & ETH_DMA_FLAG_RUS)) {
+            m_stcStats.u32RxUnavail++;
+        }
+
+        if (0UL != (u32Status & ETH_DMA_FLAG_OVS)) {
+            m_stcStats.u32RxOverflow++;
+        }
+
+        u32Clear |= ETH_DMA_FLAG_AIS | ETH_DMA_FLAG_RUS | ETH_DMA_FLAG_OVS;
+    }
+
+    WRITE_REG32(CM_ETH->DMA_DMASTSR, u32Clear);
+
+    if ((0UL != u32Clear) && (NULL != m_pfnNotify)) {
+        m_pfnNotify();
+    }
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              统计
+ * @retval 无
+ */
+void ETHIF_GetStats(stc_ethif_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
@@ -0,0 +1,127 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : eth_netif.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 以太网网络接口驱动
+                   协议栈与 ETH DMA 之间的收发层: 接收缓冲区由 DMA 直接写入后整块交给协议栈,
+                   不做拷贝; 接收中断用 RX 看门狗合并, 一次中断在 ETHIF_Poll 中收完所有已完成的帧;
+                   IP/TCP/UDP/ICMP 校验和收发两个方向都由硬件完成.
+                   stc_ethif_buf_t 预留 au32Priv, 可放 lwIP 的 struct pbuf_custom, 由 pbuf_alloced_custom
+                   把接收缓冲区直接包成 pbuf, custom_free_function 中调用 ETHIF_BufFree;
+                   协议栈须关闭软件校验和(lwIP: CHECKSUM_GEN_xxx / CHECKSUM_CHECK_xxx 置 0).
+  * Function List:
+                   ETHIF_Init
+                   ETHIF_Start
+                   ETHIF_Stop
+                   ETHIF_Poll
+                   ETHIF_Output
+                   ETHIF_BufAlloc
+                   ETHIF_BufFree
+                   ETHIF_IrqHandler
+                   ETHIF_GetStats
+  ******************************************************
+**/
+
+#ifndef __ETH_NETIF_H_
+#define __ETH_NETIF_H_
+
+#include "hc32_ll.h"
+
+#define ETHIF_RX_DESC_NUM           (16U)       /*!< 接收描述符数 */
+#define ETHIF_TX_DESC_NUM           (16U)       /*!< 发送描述符数, 一个缓冲区占一个 */
+#define ETHIF_BUF_NUM               (40U)       /*!< 缓冲区池, 收发共用, 应大于 ETHIF_RX_DESC_NUM, 余量给协议栈持有和发送 */
+#define ETHIF_BUF_SIZE              (1536U)     /*!< 单个缓冲区, 4 的倍数且不小于 ETH_MAX_PACKET_SIZE, 一帧只占一个接收描述符 */
+#define ETHIF_BUF_PRIV_WORDS        (6U)        /*!< 协议栈私有区(字), 够放 lwIP 的 struct pbuf_custom */
+#define ETHIF_RX_REFILL_BATCH       (4U)        /*!< 空出这么多接收描述符才补一次, 每批只有一次屏障和一次 RXPOLLR 写 */
+
+/**
+ * @defgroup ETHIF_Buf_Flag 缓冲区标志
+ */
+#define ETHIF_BUF_FLAG_IP_CSUM_OK   (0x0001U)   /*!< 硬件已校验 IPv4 头校验和 */
+#define ETHIF_BUF_FLAG_L4_CSUM_OK   (0x0002U)   /*!< 硬件已校验 TCP/UDP/ICMP 校验和 */
+#define ETHIF_BUF_FLAG_IPV6         (0x0004U)
+#define ETHIF_BUF_FLAG_TIMESTAMP    (0x0008U)   /*!< 接收: u32TsSec/u32TsSubsec 有效; 发送: 置于首段, 请求发送时间戳 */
+
+/**
+ * @brief 帧缓冲区
+ * 接收: pu8Payload 指向以太网头, u16Len 为去掉 FCS 的帧长.
+ * 发送: 用 pstcNext 串成一帧, 每段 pu8Payload/u16Len 指定数据, 段内校验和字段填 0.
+ */
+typedef struct stc_ethif_buf {
+    struct stc_ethif_buf *pstcNext;
+    uint8_t *pu8Payload;
+    uint16_t u16Len;
+    uint16_t u16Flags;                          /*!< @ref ETHIF_Buf_Flag */
+    uint32_t u32TsSec;                          /*!< PTP 接收时间戳, 秒 */
+    uint32_t u32TsSubsec;                       /*!< PTP 接收时间戳, 亚秒 */
+    uint32_t au32Priv[ETHIF_BUF_PRIV_WORDS];    /*!< 协议栈私有, 驱动不使用 */
+    uint8_t au8Data[ETHIF_BUF_SIZE];
+} stc_ethif_buf_t;
+
+/**
+ * @brief 接收回调, 在 ETHIF_Poll 的调用者上下文中执行
+ * @retval LL_OK: 协议栈接管缓冲区, 用完后调用 ETHIF_BufFree; 其他值: 驱动回收缓冲区
+ */
+typedef int32_t (*func_ethif_input_t)(stc_ethif_buf_t *pstcBuf);
+
+/**
+ * @brief 接收通知, 在中断中执行, 用于唤醒调用 ETHIF_Poll 的任务
+ */
+typedef void (*func_ethif_notify_t)(void);
+
+/**
+ * @brief 发送时间戳回调, 带 ETHIF_BUF_FLAG_TIMESTAMP 的帧发出后在回收它的 ETHIF_Poll/ETHIF_Output 中执行
+ */
+typedef void (*func_ethif_txts_t)(uint32_t u32Sec, uint32_t u32Subsec);
+
+/**
+ * @brief 初始化参数
+ */
+typedef struct {
+    uint8_t au8MacAddr[6];
+    uint32_t u32Interface;          /*!< ETH_MAC_IF_MII / ETH_MAC_IF_RMII */
+    IRQn_Type enIRQn;               /*!< 登记 INT_SRC_ETH_GLB_INT 使用的中断号 */
+    uint32_t u32IrqPrio;            /*!< DDL_IRQ_PRIO_xx */
+    uint8_t u8RxWatchdog;           /*!< 接收合并时间, 单位 256 个 HCLK 周期, 0 为每帧一次中断 */
+    uint8_t u8RxCoalesce;           /*!< 每收满这么多帧立即中断, 不等看门狗, [1, ETHIF_RX_DESC_NUM] */
+    func_ethif_input_t pfnInput;
+    func_ethif_notify_t pfnNotify;  /*!< 可为 NULL, 此时由主循环查询 ETHIF_Poll */
+    func_ethif_txts_t pfnTxTimestamp;   /*!< 可为 NULL, 用 PTP 时填 PTP_TxTimestamp */
+} stc_ethif_config_t;
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32RxIrqs;             /*!< 接收中断次数, 与 u32RxFrames 之比即合并效果 */
+    uint32_t u32RxFrames;           /*!< 交给协议栈的帧 */
+    uint32_t u32RxMaxBatch;         /*!< 单次 ETHIF_Poll 收到的最多帧数 */
+    uint32_t u32RxErrors;           /*!< 描述符报错或跨描述符的帧, 已丢弃 */
+    uint32_t u32RxRejected;         /*!< 协议栈拒收 */
+    uint32_t u32RxNoBuf;            /*!< 补描述符时缓冲区池已空 */
+    uint32_t u32RxUnavail;          /*!< DMA 遇到无可用描述符(RUS) */
+    uint32_t u32RxOverflow;         /*!< 接收 FIFO 溢出(OVS) */
+    uint32_t u32TxFrames;
+    uint32_t u32TxBusy;             /*!< 发送描述符不够, ETHIF_Output 返回 LL_ERR_BUSY */
+    uint32_t u32TxErrors;           /*!< 发送描述符报错 */
+} stc_ethif_stats_t;
+
+int32_t ETHIF_Init(const stc_ethif_config_t *pstcConfig);
+int32_t ETHIF_Start(void);
+int32_t ETHIF_Stop(void);
+uint32_t ETHIF_Poll(uint32_t u32Budget);
+int32_t ETHIF_Output(stc_ethif_buf_t *pstcChain);
+stc_ethif_buf_t *ETHIF_BufAlloc(void);
+void ETHIF_BufFree(stc_ethif_buf_t *pstcBuf);
+void ETHIF_IrqHandler(void);
+void ETHIF_GetStats(stc_ethif_stats_t *pstcStats);
+
+#endif
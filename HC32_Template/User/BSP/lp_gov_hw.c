@@ -0,0 +1,194 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 HC32F4A0 部分, 接到 Common/lp_gov
+                   1. WKTM 比较值 12 位, 32768Hz 时钟下一次最长 125ms;
+                   2. 时钟恢复: 停止前设置唤醒后切到 MRC, 唤醒后按 Lp_Init 保存的时钟快照(CLK_SnapshotSave)
+                      重新打开振荡器, 起振期间执行 Wake, 再打开 PLL 并切回原时钟源;
+                   3. 进入耗时和恢复耗时用 DWT 周期计数实测, 恢复耗时按 MRC 周期计.
+                   使用前需解除 PWC/CLK/FCG/INTC 寄存器写保护.
+  * Function List:
+
+  **********************************************************
+ */
+#include "lp_gov_hw.h"
+
+#define LP_WKT_HZ                   (32768UL)
+#define LP_WKT_MAX_TICK             (0x1000UL)
+#define LP_WKT_MAX_US               ((uint32_t)(LP_WKT_MAX_TICK * 1000000ULL / LP_WKT_HZ))
+#define LP_MRC_MHZ                  (MRC_VALUE / 1000000UL)
+#define LP_CLK_POLL_MAX             (0x4000UL)
+
+/* 唤醒后要恢复的时钟 */
+static stc_clock_snapshot_t m_stcClk;
+
+/* 默认时延: 停止唤醒按手册约 20us, 恢复时间按 XTAL 起振 + PLLH 锁定约 2ms 估计, 首次唤醒后由实测替换 */
+static const Lp_Latency m_astcLatDefault[LP_MODE_NUM] = {
+    {0UL, 0UL,  0UL,    0UL},
+    {1UL, 1UL,  0UL,    0UL},
+    {5UL, 20UL, 2100UL, 3000UL},
+};
+
+static uint32_t Lp_Lock(void) {
+    uint32_t u32Primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return u32Primask;
+}
+
+static void Lp_Unlock(uint32_t u32State) {
+    __set_PRIMASK(u32State);
+}
+
+static uint32_t Lp_Cycles(void) {
+    return DWT->CYCCNT;
+}
+
+static uint32_t Lp_CpuMhz(void) {
+    return SystemCoreClock / 1000000UL;
+}
+
+/* 返回实际定时的 us */
+static uint32_t Lp_WktStart(uint8_t u8Mode, uint32_t u32Us) {
+    uint32_t u32Tick;
+
+    (void)u8Mode;
+
+    if (u32Us > LP_WKT_MAX_US) {
+        u32Us = LP_WKT_MAX_US;
+    }
+
+    u32Tick = (uint32_t)((uint64_t)u32Us * LP_WKT_HZ / 1000000UL);
+    if (0UL == u32Tick) {
+        u32Tick = 1UL;
+    }
+
+    PWC_WKT_Cmd(DISABLE);
+    PWC_WKT_Config(LP_WKT_CLK, (uint16_t)(u32Tick - 1UL));
+    PWC_WKT_ClearStatus();
+    NVIC_ClearPendingIRQ(LP_WKT_IRQn);
+    PWC_WKT_Cmd(ENABLE);
+
+    return (uint32_t)((uint64_t)u32Tick * 1000000UL / LP_WKT_HZ);
+}
+
+/* 返回 1: 定时已到 */
+static uint8_t Lp_WktStop(void) {
+    uint8_t u8Fired = (SET == PWC_WKT_GetStatus()) ? 1U : 0U;
+
+    PWC_WKT_Cmd(DISABLE);
+    PWC_WKT_ClearStatus();
+    NVIC_ClearPendingIRQ(LP_WKT_IRQn);
+
+    return u8Fired;
+}
+
+static void Lp_WktIrqHandler(void) {
+    PWC_WKT_ClearStatus();
+}
+
+/**
+ * @brief  进入 u8Mode 直到唤醒, 停止模式唤醒后恢复时钟
+ * @param  [in]  u8Mode                 LP_MODE_SLEEP / LP_MODE_STOP
+ * @param  [in]  pfnWake                等待振荡器稳定时调用, 可为 NULL
+ * @param  [out] pstcInfo               停止模式唤醒后填写
+ * @retval 无
+ * @note   振荡器或 PLL 超时未稳定时留在 MRC, 恢复耗时按超时前用掉的周期计.
+ */
+static void Lp_Enter(uint8_t u8Mode, void (*pfnWake)(uint8_t u8Mode), Lp_Wake *pstcInfo) {
+    uint32_t u32Poll;
+    int32_t i32Ret;
+
+    if (LP_MODE_SLEEP == u8Mode) {
+        PWC_SLEEP_Enter();
+        return;
+    }
+
+    PWC_STOP_Enter(PWC_STOP_WFI);
+
+    /* 此时运行在 MRC 上, 振荡器起振期间执行 pfnWake */
+    CLK_SnapshotRestoreStart(&m_stcClk);
+    if (NULL != pfnWake) {
+        pfnWake(u8Mode);
+    }
+
+    u32Poll = 0UL;
+    do {
+        i32Ret = CLK_SnapshotRestorePoll(&m_stcClk);
+        u32Poll++;
+    } while ((LL_ERR_BUSY == i32Ret) && (u32Poll < LP_CLK_POLL_MAX));
+
+    if (LL_OK == i32Ret) {
+        pstcInfo->RestoreCycles = m_stcClk.u32WakeCycles;
+    } else {
+        pstcInfo->RestoreCycles = DWT->CYCCNT - m_stcClk.u32StartCycle;
+        SystemCoreClockUpdate();
+        pstcInfo->ClockFail = 1U;
+    }
+
+    pstcInfo->RestoreMhz = LP_MRC_MHZ;
+    pstcInfo->Fired = Lp_WktStop();
+}
+
+static const Lp_Port m_stcPort = {
+    LP_MODE_NUM, LP_MODE_STOP, m_astcLatDefault,
+    &Lp_Lock, &Lp_Unlock, &Lp_Cycles, &Lp_CpuMhz, NULL, &Lp_WktStart, &Lp_Enter
+};
+
+/**
+ * @brief  记录当前时钟设置, 配置停止模式和唤醒定时器
+ * @param  [in]  pstcConfig             回调, NextDeadline 不能为 NULL
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       参数错误
+ *           - LL_ERR_BUSY:             LP_WKT_IRQn 已被登记
+ * @note   在系统时钟配置完成后调用, 之后修改系统时钟需重新调用.
+ */
+int32_t Lp_Init(const Lp_Config *pstcConfig) {
+    stc_irq_signin_config_t stcIrq;
+    stc_pwc_stop_mode_config_t stcStop;
+    int32_t i32Ret;
+
+    if ((NULL == pstcConfig) || (NULL == pstcConfig->NextDeadline)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    (void)CLK_SnapshotSave(&m_stcClk);
+
+    (void)PWC_STOP_StructInit(&stcStop);
+    stcStop.u16Clock = PWC_STOP_CLK_MRC;
+    (void)PWC_STOP_Config(&stcStop);
+
+    PWC_WKT_Cmd(DISABLE);
+    PWC_WKT_ClearStatus();
+    INTC_WakeupSrcCmd(INTC_STOP_WKUP_WKTM, ENABLE);
+
+    stcIrq.enIntSrc = INT_SRC_WKTM_PRD;
+    stcIrq.enIRQn = LP_WKT_IRQn;
+    stcIrq.pfnCallback = &Lp_WktIrqHandler;
+    i32Ret = INTC_IrqSignIn(&stcIrq);
+
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    NVIC_ClearPendingIRQ(LP_WKT_IRQn);
+    NVIC_SetPriority(LP_WKT_IRQn, LP_IRQ_PRIO);
+    NVIC_EnableIRQ(LP_WKT_IRQn);
+
+    return (LP_OK == Lp_GovInit(&m_stcPort, pstcConfig)) ? LL_OK : LL_ERR_INVD_PARAM;
+}
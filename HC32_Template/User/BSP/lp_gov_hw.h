@@ -0,0 +1,43 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 HC32F4A0 部分
+                   接口与 STM32/SWM32 模板的 lp_gov_hw.h 相同, 模式选择、时延学习、Lp_Block 计数和
+                   驻留统计在 Common/lp_gov.c, 这里只管睡眠 / 停止的进入、唤醒定时器(WKTM)和
+                   唤醒后的时钟恢复; Lp_Idle / Lp_Block / Lp_SetMaxLatency / Lp_GetStats 等见 lp_gov.h.
+                   唤醒后系统时钟为 MRC, 按初始化时保存的时钟快照直接恢复, 不重新计算分频.
+                   掉电模式唤醒即复位, 不作为空闲模式.
+  * Function List:
+                   Lp_Init
+  ******************************************************
+**/
+
+#ifndef __LP_GOV_HW_H_
+#define __LP_GOV_HW_H_
+
+#include "hc32_ll.h"
+#include "lp_gov.h"
+
+#define LP_WKT_CLK                  (PWC_WKT_CLK_SRC_XTAL32)    /*!< 或 PWC_WKT_CLK_SRC_RTCLRC, 须已起振 */
+#define LP_WKT_IRQn                 (INT025_IRQn)       /*!< INT000~031 可登记任意中断源 */
+#define LP_IRQ_PRIO                 (DDL_IRQ_PRIO_00)   /*!< 只用来唤醒, 立即返回 */
+
+/**
+ * @defgroup Lp_Mode 模式, 数值越大越深
+ */
+#define LP_MODE_SLEEP               (1U)        /*!< 睡眠, 时钟不停, 任何中断唤醒 */
+#define LP_MODE_STOP                (2U)        /*!< 停止, 唤醒定时器或已允许的唤醒源唤醒 */
+#define LP_MODE_NUM                 (3U)
+
+int32_t Lp_Init(const Lp_Config *pstcConfig);
+
+#endif
@@ -0,0 +1,473 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : motor_pwm.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 三相电机 PWM 更新引擎
+                   1. 三角波从 0 计到周期值 P 再回到 0, PWMA 在计数 < GCMAR 时为高(以波谷为中心),
+                      PWMB 在计数 > GCMBR 时为高(以波峰为中心), GCMBR = GCMAR + 死区, 两个边沿的
+                      死区相等; 上桥脉宽 = 2 * GCMAR 个计数;
+                   2. GCMAR/GCMBR 使用单缓冲, 只在波谷由 GCMCR/GCMDR 传送, 三相在同一个波谷换值,
+                      不会出现一相新值一相旧值的周期;
+                   3. 主单元的波峰事件经 AOS 触发 ADC 序列 A, 采样落在下桥导通的中心,
+                      ADC 完成中断离下一个波谷还有约半个周期, 在其中 Prepare + Commit;
+                   4. HRPWM 的延迟单元比一个计数细得多: 脉宽按延迟单元换算后, 整数部分写比较值,
+                      余量小于一个计数时推迟上桥下降沿, 否则比较值加 1 并推迟上桥上升沿,
+                      下桥对应边沿推迟同样的量, 死区保持不变;
+                   5. HRPWM 的 CRx 没有缓冲, 写入立即生效. Commit 只写暂存区, 主单元的波谷事件经 AOS
+                      触发 DMA, 三段链表描述符(段间 DMA_LLP_RUN, 最后一段 DMA_LLP_WAIT)一次把三相
+                      的 CRx 从暂存区写入, 与 GCMCR/GCMDR 的传送在同一个波谷; DMA 在波谷后几十个
+                      时钟内写完, 比较值小于这段时间的极窄脉冲, 波谷后的第一个边沿仍按旧的延迟.
+  * Function List:
+
+  **********************************************************
+ */
+#include "motor_pwm.h"
+
+#define MPWM_UNIT_MAX               (8U)
+#define MPWM_TMR6_STRIDE            (CM_TMR6_2_BASE - CM_TMR6_1_BASE)
+
+#define MPWM_HR_CR(ch)              ((__IO uint32_t *)((uint32_t)&CM_HRPWM->CR1 + 4UL * ((ch) - 1UL)))
+
+static const en_event_src_t m_aenOvfEvt[MPWM_UNIT_MAX] = {
+    EVT_SRC_TMR6_1_OVF, EVT_SRC_TMR6_2_OVF, EVT_SRC_TMR6_3_OVF, EVT_SRC_TMR6_4_OVF,
+    EVT_SRC_TMR6_5_OVF, EVT_SRC_TMR6_6_OVF, EVT_SRC_TMR6_7_OVF, EVT_SRC_TMR6_8_OVF
+};
+
+static const en_event_src_t m_aenUdfEvt[MPWM_UNIT_MAX] = {
+    EVT_SRC_TMR6_1_UDF, EVT_SRC_TMR6_2_UDF, EVT_SRC_TMR6_3_UDF, EVT_SRC_TMR6_4_UDF,
+    EVT_SRC_TMR6_5_UDF, EVT_SRC_TMR6_6_UDF, EVT_SRC_TMR6_7_UDF, EVT_SRC_TMR6_8_UDF
+};
+
+static CM_TMR6_TypeDef *m_apstcTmr6[MPWM_PHASE_NUM];
+static __IO uint32_t *m_apu32HrCr[MPWM_PHASE_NUM];     /* PWMA 的 CRx, PWMB 为下一个 */
+static uint32_t m_u32SyncMask;
+static uint32_t m_u32CmpMax;
+static uint32_t m_u32Guard;
+static uint32_t m_u32HrSpan;        /* 一个 PWM 周期的延迟单元数 2 * P * code */
+static uint32_t m_u32HrStep;        /* 比较值加 1 对应的延迟单元数 2 * code */
+static uint8_t m_u8HighRes;
+static stc_mpwm_stats_t m_stcStats;
+static uint32_t m_au32HrStage[MPWM_PHASE_NUM][2];  /* 下一个波谷写入的 CRx, [相][PWMA/PWMB] */
+static stc_dma_llp_descriptor_t m_astcHrDesc[MPWM_PHASE_NUM];
+static stc_aosg_link_t m_stcHrLink;
+static stc_aosg_plan_t m_stcHrPlan;
+static uint8_t m_u8HrDma = 0U;
+
+static CM_TMR6_TypeDef *MPWM_Unit(uint8_t u8Unit) {
+    return (CM_TMR6_TypeDef *)(CM_TMR6_1_BASE + MPWM_TMR6_STRIDE * ((uint32_t)u8Unit - 1UL));
+}
+
+/**
+ * @brief  配置一个单元: 三角波、两路互补输出、波谷缓冲传送
+ * @param  [in]  TMR6x                  TMR6 单元
+ * @retval 无
+ */
+static void MPWM_UnitInit(CM_TMR6_TypeDef *TMR6x) {
+    stc_tmr6_init_t stcInit;
+    stc_tmr6_pwm_init_t stcPwm;
+    stc_tmr6_buf_config_t stcBuf;
+    uint32_t u32CmpA = m_stcStats.u32Period / 2UL;
+
+    (void)TMR6_StructInit(&stcInit);
+    stcInit.sw_count.u32ClockDiv = TMR6_CLK_DIV1;
+    stcInit.sw_count.u32CountMode = TMR6_MD_TRIANGLE;
+    stcInit.sw_count.u32CountDir = TMR6_CNT_UP;
+    stcInit.u32PeriodValue = m_stcStats.u32Period;
+    (void)TMR6_Init(TMR6x, &stcInit);
+
+    /* 上桥: 计数 < GCMAR 为高 */
+    stcPwm.u32CompareValue = u32CmpA;
+    stcPwm.u32StartPolarity = TMR6_PWM_LOW;
+    stcPwm.u32StopPolarity = TMR6_PWM_LOW;
+    stcPwm.u32CountUpMatchAPolarity = TMR6_PWM_LOW;
+    stcPwm.u32CountDownMatchAPolarity = TMR6_PWM_HIGH;
+    stcPwm.u32CountUpMatchBPolarity = TMR6_PWM_HOLD;
+    stcPwm.u32CountDownMatchBPolarity = TMR6_PWM_HOLD;
+    stcPwm.u32UdfPolarity = TMR6_PWM_HOLD;
+    stcPwm.u32OvfPolarity = TMR6_PWM_HOLD;
+    (void)TMR6_PWM_Init(TMR6x, TMR6_CH_A, &stcPwm);
+
+    /* 下桥: 计数 > GCMBR 为高 */
+    stcPwm.u32CompareValue = u32CmpA + m_stcStats.u32DeadTime;
+    stcPwm.u32CountUpMatchAPolarity = TMR6_PWM_HOLD;
+    stcPwm.u32CountDownMatchAPolarity = TMR6_PWM_HOLD;
+    stcPwm.u32CountUpMatchBPolarity = TMR6_PWM_HIGH;
+    stcPwm.u32CountDownMatchBPolarity = TMR6_PWM_LOW;
+    (void)TMR6_PWM_Init(TMR6x, TMR6_CH_B, &stcPwm);
+
+    stcBuf.u32BufNum = TMR6_BUF_SINGLE;
+    stcBuf.u32BufTransCond = TMR6_BUF_TRANS_UDF;
+    (void)TMR6_GeneralBufConfig(TMR6x, TMR6_CH_A, &stcBuf);
+    (void)TMR6_GeneralBufConfig(TMR6x, TMR6_CH_B, &stcBuf);
+    WRITE_REG32(TMR6x->GCMCR, u32CmpA);
+    WRITE_REG32(TMR6x->GCMDR, u32CmpA + m_stcStats.u32DeadTime);
+    TMR6_GeneralBufCmd(TMR6x, TMR6_CH_A, ENABLE);
+    TMR6_GeneralBufCmd(TMR6x, TMR6_CH_B, ENABLE);
+
+    TMR6_PWM_OutputCmd(TMR6x, TMR6_CH_A, ENABLE);
+    TMR6_PWM_OutputCmd(TMR6x, TMR6_CH_B, ENABLE);
+}
+
+/**
+ * @brief  波峰事件经 AOS 触发 ADC 序列 A
+ * @param  [in]  ADCx                   ADC 单元
+ * @param  [in]  u8Unit                 主单元号
+ * @retval 无
+ */
+static void MPWM_AdcTrigInit(CM_ADC_TypeDef *ADCx, uint8_t u8Unit) {
+    __IO uint32_t *pu32Sel;
+
+    if (CM_ADC1 == ADCx) {
+        pu32Sel = &CM_AOS->ADC1_ITRGSELR0;
+    } else if (CM_ADC2 == ADCx) {
+        pu32Sel = &CM_AOS->ADC2_ITRGSELR0;
+    } else {
+        pu32Sel = &CM_AOS->ADC3_ITRGSELR0;
+    }
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_AOS, ENABLE);
+    MODIFY_REG32(*pu32Sel, AOS_ADC1_ITRGSELR_TRGSEL, (uint32_t)m_aenOvfEvt[u8Unit - 1U]);
+
+    ADC_TriggerConfig(ADCx, ADC_SEQ_A, ADC_HARDTRIG_EVT0);
+    ADC_TriggerCmd(ADCx, ADC_SEQ_A, ENABLE);
+}
+
+/**
+ * @brief  波谷事件经 AOS 触发 DMA, 把暂存区的三相 CRx 写入 HRPWM
+ * @param  [in]  u8Unit                 主单元号
+ * @retval int32_t:
+ *         - LL_OK:                     成功
+ *         - LL_ERR_BUSY:               MPWM_HR_DMA_CH 的触发选择已被其他代码占用
+ * @note   每相一段描述符, 一块 2 个字(PWMA/PWMB 的 CRx 相邻); 前两段结束后立即装入并执行
+ *         下一段, 第三段结束后装回第一段, 等下一个波谷.
+ */
+static int32_t MPWM_HrDmaInit(uint8_t u8Unit) {
+    stc_dma_init_t stcDma;
+    stc_dma_llp_init_t stcLlp;
+    uint32_t u32Run;
+    uint8_t i;
+
+    for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+        u32Run = (i < (MPWM_PHASE_NUM - 1U)) ? DMA_LLP_RUN : DMA_LLP_WAIT;
+        m_astcHrDesc[i].SARx = (uint32_t)m_au32HrStage[i];
+        m_astcHrDesc[i].DARx = (uint32_t)m_apu32HrCr[i];
+        m_astcHrDesc[i].DTCTLx = 2UL | (1UL << DMA_DTCTL_CNT_POS);
+        m_astcHrDesc[i].RPTx = 0UL;
+        m_astcHrDesc[i].SNSEQCTLx = 0UL;
+        m_astcHrDesc[i].DNSEQCTLx = 0UL;
+        m_astcHrDesc[i].LLPx = (uint32_t)&m_astcHrDesc[(i + 1U) % MPWM_PHASE_NUM];
+        m_astcHrDesc[i].CHCTLx = DMA_SRC_ADDR_INC | DMA_DEST_ADDR_INC | DMA_DATAWIDTH_32BIT | DMA_INT_DISABLE |
+                                 DMA_LLP_ENABLE | u32Run;
+    }
+
+    FCG_Fcg0PeriphClockCmd(MPWM_HR_DMA_FCG, ENABLE);
+    DMA_Cmd(MPWM_HR_DMA, ENABLE);
+    (void)DMA_ChCmd(MPWM_HR_DMA, MPWM_HR_DMA_CH, DISABLE);
+    DMA_DeInit(MPWM_HR_DMA, MPWM_HR_DMA_CH);
+
+    /* 通道寄存器装入第一段 */
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = DMA_INT_DISABLE;
+    stcDma.u32SrcAddr = m_astcHrDesc[0].SARx;
+    stcDma.u32DestAddr = m_astcHrDesc[0].DARx;
+    stcDma.u32DataWidth = DMA_DATAWIDTH_32BIT;
+    stcDma.u32BlockSize = 2UL;
+    stcDma.u32TransCount = 1UL;
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_INC;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_INC;
+    (void)DMA_Init(MPWM_HR_DMA, MPWM_HR_DMA_CH, &stcDma);
+
+    (void)DMA_LlpStructInit(&stcLlp);
+    stcLlp.u32State = DMA_LLP_ENABLE;
+    stcLlp.u32Mode = DMA_LLP_RUN;
+    stcLlp.u32Addr = m_astcHrDesc[0].LLPx;
+    (void)DMA_LlpInit(MPWM_HR_DMA, MPWM_HR_DMA_CH, &stcLlp);
+
+    m_stcHrLink.enSrc = m_aenUdfEvt[u8Unit - 1U];
+    m_stcHrLink.u32Target = ((CM_DMA1 == MPWM_HR_DMA) ? AOS_DMA1_0 : AOS_DMA2_0) + 4UL * (uint32_t)MPWM_HR_DMA_CH;
+    if (LL_OK != AOSG_Apply(&m_stcHrLink, 1U, &m_stcHrPlan)) {
+        return LL_ERR_BUSY;
+    }
+
+    (void)DMA_ChCmd(MPWM_HR_DMA, MPWM_HR_DMA_CH, ENABLE);
+    m_u8HrDma = 1U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  初始化三相 PWM, 计数器不启动
+ * @param  [in]  pstcConfig             初始化参数
+ * @retval int32_t:
+ *         - LL_OK:                     成功, 高分辨率是否可用见 MPWM_GetStats 的 u8HrCode
+ *         - LL_ERR_INVD_PARAM:         单元号重复或越界, 频率超出计数范围, 死区过大
+ *         - LL_ERR_BUSY:               MPWM_HR_DMA_CH 的触发选择已被占用, 退回整数分辨率
+ * @note   重复调用时先释放上一次的 DMA 触发连线.
+ */
+int32_t MPWM_Init(const stc_mpwm_config_t *pstcConfig) {
+    stc_clock_freq_t stcClk;
+    uint32_t u32Period;
+    uint32_t u32DeadTime;
+    uint32_t u32Mhz;
+    uint32_t u32HrCr;
+    int32_t i32Ret = LL_OK;
+    uint8_t u8Unit;
+    uint8_t i;
+
+    if ((NULL == pstcConfig) || (0UL == pstcConfig->u32Freq)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (0U != m_u8HrDma) {
+        (void)DMA_ChCmd(MPWM_HR_DMA, MPWM_HR_DMA_CH, DISABLE);
+        AOSG_Release(&m_stcHrLink, 1U, &m_stcHrPlan);
+        m_u8HrDma = 0U;
+    }
+
+    m_u32SyncMask = 0UL;
+
+    for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+        u8Unit = pstcConfig->au8Unit[i];
+
+        if ((0U == u8Unit) || (u8Unit > MPWM_UNIT_MAX) || (0UL != (m_u32SyncMask & (TMR6_SW_SYNC_U1 << (u8Unit - 1U))))) {
+            return LL_ERR_INVD_PARAM;
+        }
+
+        m_u32SyncMask |= TMR6_SW_SYNC_U1 << (u8Unit - 1U);
+    }
+
+    (void)CLK_GetClockFreq(&stcClk);
+    u32Period = stcClk.u32Pclk0Freq / (2UL * pstcConfig->u32Freq);
+    u32Mhz = stcClk.u32Pclk0Freq / 1000000UL;
+    u32DeadTime = ((uint32_t)pstcConfig->u16DeadTimeNs * u32Mhz + 999UL) / 1000UL;
+
+    /* 5~8 号单元为 16 位 */
+    if ((u32Period > 0xFFFFUL) || ((u32DeadTime + 2UL * MPWM_CMP_MIN) >= u32Period)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcStats.u32Period = u32Period;
+    m_stcStats.u32DeadTime = u32DeadTime;
+    m_stcStats.u32Commits = 0UL;
+    m_stcStats.u32Late = 0UL;
+    m_stcStats.u32Clamped = 0UL;
+    m_stcStats.u8HrCode = 0U;
+    m_u32CmpMax = u32Period - MPWM_CMP_MIN;
+    m_u32Guard = ((uint32_t)MPWM_COMMIT_GUARD_NS * u32Mhz + 999UL) / 1000UL;
+
+    FCG_Fcg2PeriphClockCmd(m_u32SyncMask, ENABLE);      /* FCG2 的 TMR6_1~8 与同步启动位顺序相同 */
+
+    for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+        m_apstcTmr6[i] = MPWM_Unit(pstcConfig->au8Unit[i]);
+        m_apu32HrCr[i] = MPWM_HR_CR(2UL * pstcConfig->au8Unit[i] - 1UL);
+        MPWM_UnitInit(m_apstcTmr6[i]);
+    }
+
+    m_u8HighRes = pstcConfig->u8HighRes;
+
+    if (1U == m_u8HighRes) {
+        FCG_Fcg2PeriphClockCmd(FCG2_PERIPH_HRPWM, ENABLE);
+        u32HrCr = (LL_OK == MPWM_Calibrate()) ? HRPWM_CR_EN : 0UL;
+
+        for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+            m_au32HrStage[i][0] = u32HrCr;
+            m_au32HrStage[i][1] = u32HrCr;
+            WRITE_REG32(m_apu32HrCr[i][0], u32HrCr);
+            WRITE_REG32(m_apu32HrCr[i][1], u32HrCr);
+        }
+
+        if (LL_OK != MPWM_HrDmaInit(pstcConfig->au8Unit[0])) {
+            m_u8HighRes = 0U;
+            m_stcStats.u8HrCode = 0U;
+            i32Ret = LL_ERR_BUSY;
+        }
+    }
+
+    if (NULL != pstcConfig->ADCx) {
+        MPWM_AdcTrigInit(pstcConfig->ADCx, pstcConfig->au8Unit[0]);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  三个单元同时从 0 开始计数
+ * @param  无
+ * @retval 无
+ */
+void MPWM_Start(void) {
+    TMR6_SWSyncClear(m_u32SyncMask);
+    TMR6_SWSyncStart(m_u32SyncMask);
+}
+
+/**
+ * @brief  停止计数, 输出回到低电平
+ * @param  无
+ * @retval 无
+ */
+void MPWM_Stop(void) {
+    TMR6_SWSyncStop(m_u32SyncMask);
+}
+
+/**
+ * @brief  重新校准 HRPWM 延迟单元
+ * @param  无
+ * @retval int32_t:
+ *         - LL_OK:                     成功, 之后 Prepare 的帧按新的校准码换算
+ *         - LL_ERR_INVD_MD:            未使能高分辨率, 或时钟不满足(需 PLL 且 PCLK0 >= 120MHz)
+ *         - LL_ERR_TIMEOUT:            校准超时, 退回整数分辨率
+ * @note   延迟单元随温度和电压漂移, 可在主循环里每隔几秒调用一次.
+ */
+int32_t MPWM_Calibrate(void) {
+    int32_t i32Ret;
+    uint8_t u8Code = 0U;
+
+    if ((1U != m_u8HighRes) || (ENABLE != HRPWM_CondConfirm())) {
+        return LL_ERR_INVD_MD;
+    }
+
+    i32Ret = HRPWM_CalibrateProcess(HRPWM_CAL_UNIT0, &u8Code);
+
+    if (LL_OK != i32Ret) {
+        u8Code = 0U;
+    }
+
+    m_u32HrStep = 2UL * u8Code;
+    m_u32HrSpan = m_u32HrStep * m_stcStats.u32Period;
+    m_stcStats.u8HrCode = u8Code;
+
+    return i32Ret;
+}
+
+/**
+ * @brief  把三相占空比换算成一帧寄存器值
+ * @param  [out] pstcFrame              输出帧
+ * @param  [in]  au16Duty               三相上桥占空比, Q15, 32768 为 100%
+ * @retval 无
+ * @note   只做计算, 不访问外设, 可在 ADC 完成中断中调用, 也可以提前算好多帧.
+ */
+void MPWM_Prepare(stc_mpwm_frame_t *pstcFrame, const uint16_t au16Duty[MPWM_PHASE_NUM]) {
+    uint32_t u32Duty;
+    uint32_t u32Width;
+    uint32_t u32Cmp;
+    uint32_t u32Rem;
+    uint32_t u32HrA;
+    uint32_t u32HrB;
+    uint8_t u8Code = m_stcStats.u8HrCode;
+    uint8_t i;
+
+    for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+        u32Duty = (au16Duty[i] > MPWM_DUTY_MAX) ? MPWM_DUTY_MAX : au16Duty[i];
+        u32HrA = HRPWM_CR_EN;
+        u32HrB = HRPWM_CR_EN;
+
+        if (0U == u8Code) {
+            u32Cmp = (u32Duty * m_stcStats.u32Period + 16384UL) >> 15;
+        } else {
+            u32Width = (uint32_t)(((uint64_t)u32Duty * m_u32HrSpan + 16384ULL) >> 15);
+            u32Cmp = u32Width / m_u32HrStep;
+            u32Rem = u32Width - u32Cmp * m_u32HrStep;
+
+            if (0UL == u32Rem) {
+                /* 正好整数个计数 */
+            } else if (u32Rem < u8Code) {
+                /* 上桥下降沿和下桥上升沿推迟 u32Rem */
+                u32HrA |= HRPWM_CR_NE | ((u32Rem - 1UL) << HRPWM_CR_NSEL_POS);
+                u32HrB |= HRPWM_CR_PE | ((u32Rem - 1UL) << HRPWM_CR_PSEL_POS);
+            } else {
+                /* 多给一个计数, 上桥上升沿和下桥下降沿推迟补回 */
+                u32Cmp++;
+                u32Rem = m_u32HrStep - u32Rem;
+                u32HrA |= HRPWM_CR_PE | ((u32Rem - 1UL) << HRPWM_CR_PSEL_POS);
+                u32HrB |= HRPWM_CR_NE | ((u32Rem - 1UL) << HRPWM_CR_NSEL_POS);
+            }
+        }
+
+        if ((u32Cmp < MPWM_CMP_MIN) || (u32Cmp > m_u32CmpMax)) {
+            u32Cmp = (u32Cmp < MPWM_CMP_MIN) ? MPWM_CMP_MIN : m_u32CmpMax;
+            u32HrA = HRPWM_CR_EN;
+            u32HrB = HRPWM_CR_EN;
+            m_stcStats.u32Clamped++;
+        }
+
+        pstcFrame->au32CmpA[i] = u32Cmp;
+        pstcFrame->au32CmpB[i] = u32Cmp + m_stcStats.u32DeadTime;
+        pstcFrame->au32HrA[i] = u32HrA;
+        pstcFrame->au32HrB[i] = u32HrB;
+    }
+}
+
+/**
+ * @brief  写入一帧, 三相在下一个波谷同时生效
+ * @param  [in]  pstcFrame              MPWM_Prepare 算好的帧
+ * @retval int32_t:
+ *         - LL_OK:                     在波峰之后、波谷之前写完
+ *         - LL_ERR_BUSY:               写入时已过波谷或离波谷太近, 整帧推迟一个周期生效
+ * @note   写缓冲期间关中断, 6 次外设写和 6 次暂存区写; 离波谷不足 MPWM_COMMIT_GUARD_NS 时先等
+ *         波谷过去, 已过波谷时再等本次波谷的 CRx DMA 写完, 保证一帧不会被波谷传送拆成两半.
+ */
+int32_t MPWM_Commit(const stc_mpwm_frame_t *pstcFrame) {
+    CM_TMR6_TypeDef *TMR6x = m_apstcTmr6[0];
+    int32_t i32Ret = LL_OK;
+    uint32_t u32Primask;
+    uint8_t i;
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (0UL != READ_REG32_BIT(TMR6x->STFLR, TMR6_STFLR_DIRF)) {
+        /* 递增计数: 本周期的波谷已经过去 */
+        i32Ret = LL_ERR_BUSY;
+    } else if (READ_REG32(TMR6x->CNTER) < m_u32Guard) {
+        while (0UL == READ_REG32_BIT(TMR6x->STFLR, TMR6_STFLR_DIRF)) {
+        }
+
+        i32Ret = LL_ERR_BUSY;
+    }
+
+    if ((LL_OK != i32Ret) && (0U != m_u8HrDma)) {
+        while ((SET == DMA_GetRequestStatus(MPWM_HR_DMA, DMA_STAT_REQ_CH0 << MPWM_HR_DMA_CH)) ||
+               (SET == DMA_GetTransStatus(MPWM_HR_DMA, DMA_STAT_TRANS_CH0 << MPWM_HR_DMA_CH))) {
+        }
+    }
+
+    for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+        WRITE_REG32(m_apstcTmr6[i]->GCMCR, pstcFrame->au32CmpA[i]);
+        WRITE_REG32(m_apstcTmr6[i]->GCMDR, pstcFrame->au32CmpB[i]);
+    }
+
+    if (0U != m_u8HrDma) {
+        for (i = 0U; i < MPWM_PHASE_NUM; i++) {
+            m_au32HrStage[i][0] = pstcFrame->au32HrA[i];
+            m_au32HrStage[i][1] = pstcFrame->au32HrB[i];
+        }
+    }
+
+    __set_PRIMASK(u32Primask);
+
+    m_stcStats.u32Commits++;
+
+    if (LL_OK != i32Ret) {
+        m_stcStats.u32Late++;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              统计
+ * @retval 无
+ */
+void MPWM_GetStats(stc_mpwm_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
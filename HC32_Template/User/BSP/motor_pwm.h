@@ -0,0 +1,88 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : motor_pwm.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 三相电机 PWM 更新引擎(Timer6 三角波 + HRPWM)
+                   三个 TMR6 单元同步启动, PWMA 为上桥、PWMB 为带死区的下桥, 比较值经
+                   GCMCR/GCMDR 缓冲在波谷统一传送; 波峰(下桥导通中心)经 AOS 触发 ADC 序列 A.
+                   控制环在 ADC 完成中断里用 MPWM_Prepare 把三相占空比预先算成寄存器值,
+                   再用 MPWM_Commit 一次写入, 三相在同一个波谷生效.
+                   HRPWM 可用时, 不足一个计数的脉宽余量用边沿延迟补上; HRPWM 的 CRx 没有缓冲,
+                   由主单元的波谷事件经 AOS 触发 DMA 从暂存区写入, 与比较值在同一个波谷生效.
+  * Function List:
+                   MPWM_Init
+                   MPWM_Start
+                   MPWM_Stop
+                   MPWM_Calibrate
+                   MPWM_Prepare
+                   MPWM_Commit
+                   MPWM_GetStats
+  ******************************************************
+**/
+
+#ifndef __MOTOR_PWM_H_
+#define __MOTOR_PWM_H_
+
+#include "hc32_ll.h"
+#include "aos_graph.h"
+
+#define MPWM_PHASE_NUM              (3U)
+#define MPWM_DUTY_MAX               (32768U)    /*!< 占空比 Q15, 32768 为 100% */
+#define MPWM_CMP_MIN                (1UL)       /*!< 上桥最窄 2 个计数, 比较值不取 0 和周期值 */
+#define MPWM_COMMIT_GUARD_NS        (500U)      /*!< 离波谷不足该时间时不写缓冲, 等到波谷之后 */
+
+/* 波谷把 HRPWM CRx 暂存区搬到 HRPWM 的 DMA 通道, 仅 u8HighRes = 1 时占用 */
+#define MPWM_HR_DMA                 (CM_DMA1)
+#define MPWM_HR_DMA_CH              (DMA_CH7)
+#define MPWM_HR_DMA_FCG             (FCG0_PERIPH_DMA1)
+
+/**
+ * @brief 初始化参数
+ */
+typedef struct {
+    uint8_t au8Unit[MPWM_PHASE_NUM];    /*!< U/V/W 三相使用的 TMR6 单元号 1~8, au8Unit[0] 为主单元 */
+    uint32_t u32Freq;                   /*!< PWM 频率(Hz), 计数时钟为 PCLK0 */
+    uint16_t u16DeadTimeNs;             /*!< 死区时间(ns), 上下桥两个边沿相同 */
+    uint8_t u8HighRes;                  /*!< 1: 使能 HRPWM 细调(占用 MPWM_HR_DMA_CH), 条件不满足时退回整数分辨率 */
+    CM_ADC_TypeDef *ADCx;               /*!< 在波峰触发序列 A 的 ADC, NULL 不触发 */
+} stc_mpwm_config_t;
+
+/**
+ * @brief 预先算好的一帧寄存器值
+ */
+typedef struct {
+    uint32_t au32CmpA[MPWM_PHASE_NUM];  /*!< GCMCR, 波谷传送到 GCMAR */
+    uint32_t au32CmpB[MPWM_PHASE_NUM];  /*!< GCMDR, 波谷传送到 GCMBR */
+    uint32_t au32HrA[MPWM_PHASE_NUM];   /*!< PWMA 对应的 HRPWM CRx, 波谷由 DMA 写入 */
+    uint32_t au32HrB[MPWM_PHASE_NUM];   /*!< PWMB 对应的 HRPWM CRx, 波谷由 DMA 写入 */
+} stc_mpwm_frame_t;
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32Period;             /*!< 周期值(三角波峰值), 一个 PWM 周期为 2 倍 */
+    uint32_t u32DeadTime;           /*!< 死区(计数) */
+    uint32_t u32Commits;
+    uint32_t u32Late;               /*!< 没能赶在下一个波谷之前写完, 推迟一个周期生效的次数 */
+    uint32_t u32Clamped;            /*!< 占空比超出可输出范围而被限幅的次数 */
+    uint8_t u8HrCode;               /*!< HRPWM 校准码(每个 PCLK0 周期的延迟单元数), 0 为整数分辨率 */
+} stc_mpwm_stats_t;
+
+int32_t MPWM_Init(const stc_mpwm_config_t *pstcConfig);
+void MPWM_Start(void);
+void MPWM_Stop(void);
+int32_t MPWM_Calibrate(void);
+void MPWM_Prepare(stc_mpwm_frame_t *pstcFrame, const uint16_t au16Duty[MPWM_PHASE_NUM]);
+int32_t MPWM_Commit(const stc_mpwm_frame_t *pstcFrame);
+void MPWM_GetStats(stc_mpwm_stats_t *pstcStats);
+
+#endif
@@ -0,0 +1,1027 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : nand_ftl.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : NAND 闪存转换层(FTL)
+                   1. 每页备用区写入标签: 逻辑页号、全局写入序号和所在块的擦除次数,
+                      标签第 0 字节固定为 0xFF, 不会被误认为坏块标记;
+                   2. 挂载时按块首页序号从旧到新扫描所有页, 同一逻辑页以后写入的为准,
+                      擦除次数从块首页标签中恢复, 已擦除未写入的块取平均值;
+                      最新的块尾部都已擦除时接着作为活动块, 掉电不丢掉它剩余的页;
+                   3. 写入只追加到活动块, 活动块写满后分配擦除次数最少的空闲块;
+                   4. 回收: 最后 NAND_FTL_RESERVE_BLOCKS 个空闲块只给前台回收搬移用; 主机写入要分配新块时
+                      空闲块不多于该数, 或掉电打断回收后空闲块少于该数, 先前台回收, 选有效页最少的块;
+                      后台在空闲块只比保留块多一块时选有效页最少的块, 每次最多搬移指定页数,
+                      擦除次数差超过 NAND_FTL_WL_THRESHOLD 时优先搬移擦除次数最少的数据块(冷数据),
+                      让它回到空闲池; 后台不动用保留块, 否则回收到一半时主机写满活动块, 前台回收就没有块可写;
+                   5. 编程失败的块不再写入, 回收后标记为坏块; 擦除失败直接标记为坏块;
+                   6. 合并时旧页 ECC 不可纠正, 缺少的扇区按未写过(0xFF)补齐, 与回收时丢弃读不出的页一致,
+                      主机新写的扇区照常写入, 不让一个坏页卡住缓存.
+                   Tools/nand_ftl_sim.py 在主机上用带故障注入的 NAND 模型(坏块、编程/擦除失败、掉电、
+                   读干扰)检查本文件, 修改后运行一次.
+  * Function List:
+
+  **********************************************************
+ */
+#include "nand_ftl.h"
+#include "string.h"
+
+#define NAND_FTL_INVD               (0xFFFFFFFFUL)
+#define NAND_FTL_TAG_MAGIC          (0x4654414EUL)
+#define NAND_FTL_PAGE_LEN_MAX       (NAND_FTL_PAGE_MAX + NAND_FTL_TAG_SIZE)
+
+/* 备用区标签, 位于页缓冲区的数据区之后 */
+typedef struct {
+    uint32_t u32Erase;              /* [7:0] 固定 0xFF, [31:8] 块擦除次数 */
+    uint32_t u32Lpn;
+    uint32_t u32Seq;
+    uint32_t u32Check;
+} stc_nand_ftl_tag_t;
+
+typedef struct {
+    uint32_t au32Buf[NAND_FTL_PAGE_LEN_MAX / 4U];
+    uint32_t u32Lpn;
+    uint32_t u32Mask;               /* 已写入的扇区 */
+    uint32_t u32Stamp;
+} stc_nand_ftl_cache_t;
+
+static const stc_nand_ftl_cfg_t *m_pstcCfg;
+static stc_nand_ftl_stats_t m_stcStats;
+static stc_nand_ftl_cache_t m_astcCache[NAND_FTL_CACHE_NUM];
+static uint32_t m_au32Scratch[NAND_FTL_PAGE_LEN_MAX / 4U];
+static uint32_t m_u32ScratchLpn;    /* 读缓冲区中的逻辑页, 用于连续扇区读 */
+/* 坏块标记页; 不能借用 m_au32Scratch, 回收搬移中分配新块失败时它正装着待写的数据 */
+static const uint32_t m_au32BadMark[(NAND_FTL_PAGE_MAX + 4U) / 4U] = {0UL};
+
+static uint32_t m_u32PageLen;
+static uint32_t m_u32FullMask;
+static uint32_t m_u32Seq;
+static uint32_t m_u32Stamp;
+static uint32_t m_u32FreeNum;
+static uint32_t m_u32ActBlock;
+static uint32_t m_u32ActPage;
+static uint32_t m_u32GcBlock;
+static uint32_t m_u32GcPage;
+
+static uint32_t NAND_FTL_TagCheck(const stc_nand_ftl_tag_t *pstcTag) {
+    return pstcTag->u32Erase ^ pstcTag->u32Lpn ^ pstcTag->u32Seq ^ NAND_FTL_TAG_MAGIC;
+}
+
+static stc_nand_ftl_tag_t *NAND_FTL_Tag(uint32_t au32Buf[]) {
+    return (stc_nand_ftl_tag_t *)&au32Buf[m_pstcCfg->u16PageSize / 4U];
+}
+
+/**
+ * @brief  读一页并检查标签
+ * @param  [in]  u32Page                页地址
+ * @param  [out] au32Buf                页缓冲区
+ * @retval int32_t:
+ *           - LL_OK:                   读取成功且标签有效
+ *           - LL_ERR:                  ECC 不可纠正
+ *           - LL_ERR_NOT_RDY:          没有有效标签(已擦除或未写完)
+ */
+static int32_t NAND_FTL_ReadTagged(uint32_t u32Page, uint32_t au32Buf[]) {
+    const stc_nand_ftl_tag_t *pstcTag;
+
+    m_stcStats.u32PageReads++;
+
+    if (m_pstcCfg->pstcOps->pfnReadPage(u32Page, (uint8_t *)au32Buf, m_u32PageLen) != LL_OK) {
+        return LL_ERR;
+    }
+
+    pstcTag = NAND_FTL_Tag(au32Buf);
+
+    if (((pstcTag->u32Erase & 0xFFUL) != 0xFFUL) || (pstcTag->u32Check != NAND_FTL_TagCheck(pstcTag))) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  标记坏块
+ * @param  [in]  u32Block               块号
+ * @retval 无
+ * @note   把块首页备用区第 0 字节写为 0, 与出厂坏块标记相同.
+ */
+static void NAND_FTL_MarkBad(uint32_t u32Block) {
+    stc_nand_ftl_block_t *pstcBlk = &m_pstcCfg->pstcBlock[u32Block];
+
+    if ((pstcBlk->u8State == NAND_FTL_BLK_FREE) || (pstcBlk->u8State == NAND_FTL_BLK_ERASED)) {
+        m_u32FreeNum--;
+    }
+
+    pstcBlk->u8State = NAND_FTL_BLK_BAD;
+    pstcBlk->u16Valid = 0U;
+    m_stcStats.u32BadBlocks++;
+
+    (void)m_pstcCfg->pstcOps->pfnWriteRaw(u32Block * m_pstcCfg->u16PagesPerBlock,
+                                          (const uint8_t *)m_au32BadMark, m_pstcCfg->u16PageSize + 4U);
+}
+
+/**
+ * @brief  擦除块
+ * @param  [in]  u32Block               块号
+ * @retval int32_t:
+ *           - LL_OK:                   成功, 块状态为 NAND_FTL_BLK_ERASED
+ *           - LL_ERR:                  擦除失败, 已标记为坏块
+ */
+static int32_t NAND_FTL_Erase(uint32_t u32Block) {
+    stc_nand_ftl_block_t *pstcBlk = &m_pstcCfg->pstcBlock[u32Block];
+
+    pstcBlk->u32EraseCnt++;
+    m_stcStats.u32Erases++;
+
+    if (m_pstcCfg->pstcOps->pfnEraseBlock(u32Block * m_pstcCfg->u16PagesPerBlock) != LL_OK) {
+        NAND_FTL_MarkBad(u32Block);
+        return LL_ERR;
+    }
+
+    if ((pstcBlk->u8State != NAND_FTL_BLK_FREE) && (pstcBlk->u8State != NAND_FTL_BLK_ERASED)) {
+        m_u32FreeNum++;
+    }
+
+    pstcBlk->u8State = NAND_FTL_BLK_ERASED;
+    pstcBlk->u16Valid = 0U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  分配擦除次数最少的空闲块作为活动块
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_BUF_FULL:         没有空闲块
+ */
+static int32_t NAND_FTL_AllocBlock(void) {
+    stc_nand_ftl_block_t *pstcBlk;
+    uint32_t u32Best;
+    uint32_t i;
+
+    for (;;) {
+        u32Best = NAND_FTL_INVD;
+
+        for (i = 0U; i < m_pstcCfg->u32BlockNum; i++) {
+            pstcBlk = &m_pstcCfg->pstcBlock[i];
+
+            if (((pstcBlk->u8State == NAND_FTL_BLK_FREE) || (pstcBlk->u8State == NAND_FTL_BLK_ERASED)) &&
+                    ((u32Best == NAND_FTL_INVD) || (pstcBlk->u32EraseCnt < m_pstcCfg->pstcBlock[u32Best].u32EraseCnt))) {
+                u32Best = i;
+            }
+        }
+
+        if (u32Best == NAND_FTL_INVD) {
+            return LL_ERR_BUF_FULL;
+        }
+
+        if ((m_pstcCfg->pstcBlock[u32Best].u8State == NAND_FTL_BLK_ERASED) || (NAND_FTL_Erase(u32Best) == LL_OK)) {
+            break;
+        }
+    }
+
+    pstcBlk = &m_pstcCfg->pstcBlock[u32Best];
+    pstcBlk->u8State = NAND_FTL_BLK_DATA;
+    pstcBlk->u32Seq = m_u32Seq + 1U;
+    m_u32FreeNum--;
+    m_u32ActBlock = u32Best;
+    m_u32ActPage = 0U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  把一页写到活动块的下一页并更新映射
+ * @param  [in]  u32Lpn                 逻辑页号
+ * @param  [in]  au32Buf                页缓冲区, 标签由本函数填写
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_BUF_FULL:         没有空闲块
+ */
+static int32_t NAND_FTL_Program(uint32_t u32Lpn, uint32_t au32Buf[]) {
+    stc_nand_ftl_tag_t *pstcTag = NAND_FTL_Tag(au32Buf);
+    stc_nand_ftl_block_t *pstcBlk;
+    uint32_t u32Ppn;
+    uint32_t u32Old;
+    int32_t i32Ret;
+
+    for (;;) {
+        if ((m_u32ActBlock == NAND_FTL_INVD) || (m_u32ActPage >= m_pstcCfg->u16PagesPerBlock)) {
+            i32Ret = NAND_FTL_AllocBlock();
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+        }
+
+        pstcBlk = &m_pstcCfg->pstcBlock[m_u32ActBlock];
+        u32Ppn = m_u32ActBlock * m_pstcCfg->u16PagesPerBlock + m_u32ActPage;
+        m_u32ActPage++;
+
+        pstcTag->u32Erase = 0xFFUL | (pstcBlk->u32EraseCnt << 8U);
+        pstcTag->u32Lpn = u32Lpn;
+        pstcTag->u32Seq = ++m_u32Seq;
+        pstcTag->u32Check = NAND_FTL_TagCheck(pstcTag);
+        m_stcStats.u32PageWrites++;
+
+        if (m_pstcCfg->pstcOps->pfnWritePage(u32Ppn, (const uint8_t *)au32Buf, m_u32PageLen) == LL_OK) {
+            break;
+        }
+
+        /* 块内已有的数据仍可读, 等回收后再标记为坏块 */
+        pstcBlk->u8State = NAND_FTL_BLK_RETIRE;
+        m_u32ActPage = m_pstcCfg->u16PagesPerBlock;
+    }
+
+    u32Old = m_pstcCfg->pu32Map[u32Lpn];
+
+    if (u32Old != NAND_FTL_INVD) {
+        m_pstcCfg->pstcBlock[u32Old / m_pstcCfg->u16PagesPerBlock].u16Valid--;
+    }
+
+    m_pstcCfg->pu32Map[u32Lpn] = u32Ppn;
+    pstcBlk->u16Valid++;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  选回收块
+ * @param  [in]  u8Wl                   1: 擦除次数差超过阈值时选擦除次数最少的数据块
+ * @param  [in]  u8Greedy               1: 允许选有效页最少的块
+ * @retval 块号, 没有可回收的块时为 NAND_FTL_INVD
+ * @note   待退役的块总是优先回收.
+ */
+static uint32_t NAND_FTL_PickVictim(uint8_t u8Wl, uint8_t u8Greedy) {
+    const stc_nand_ftl_block_t *pstcBlk;
+    uint32_t u32Greedy = NAND_FTL_INVD;
+    uint32_t u32Cold = NAND_FTL_INVD;
+    uint32_t u32MaxErase = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < m_pstcCfg->u32BlockNum; i++) {
+        pstcBlk = &m_pstcCfg->pstcBlock[i];
+
+        if (pstcBlk->u8State != NAND_FTL_BLK_BAD) {
+            u32MaxErase = LL_MAX(u32MaxErase, pstcBlk->u32EraseCnt);
+        }
+
+        if (i == m_u32ActBlock) {
+            continue;
+        }
+
+        if (pstcBlk->u8State == NAND_FTL_BLK_RETIRE) {
+            return i;
+        }
+
+        if (pstcBlk->u8State != NAND_FTL_BLK_DATA) {
+            continue;
+        }
+
+        if ((u32Greedy == NAND_FTL_INVD) || (pstcBlk->u16Valid < m_pstcCfg->pstcBlock[u32Greedy].u16Valid)) {
+            u32Greedy = i;
+        }
+
+        if ((u32Cold == NAND_FTL_INVD) || (pstcBlk->u32EraseCnt < m_pstcCfg->pstcBlock[u32Cold].u32EraseCnt)) {
+            u32Cold = i;
+        }
+    }
+
+    if ((u8Wl != 0U) && (u32Cold != NAND_FTL_INVD) &&
+            ((u32MaxErase - m_pstcCfg->pstcBlock[u32Cold].u32EraseCnt) > NAND_FTL_WL_THRESHOLD)) {
+        m_stcStats.u32WlMoves++;
+        return u32Cold;
+    }
+
+    /* 全是有效页的块回收不出空间 */
+    if ((u8Greedy == 0U) || (u32Greedy == NAND_FTL_INVD) ||
+            (m_pstcCfg->pstcBlock[u32Greedy].u16Valid >= m_pstcCfg->u16PagesPerBlock)) {
+        return NAND_FTL_INVD;
+    }
+
+    return u32Greedy;
+}
+
+/**
+ * @brief  回收: 搬移回收块中的有效页, 完成后擦除
+ * @param  [in]  u32MaxPages            本次最多检查的页数
+ * @param  [in]  u8Foreground           1: 前台回收, 可以使用保留的空闲块
+ * @retval int32_t:
+ *           - LL_OK:                   已处理
+ *           - LL_ERR_NOT_RDY:          后台回收需要分配新块, 但空闲块只剩保留块
+ *           - LL_ERR_BUF_FULL:         没有空闲块可写
+ */
+static int32_t NAND_FTL_GcStep(uint32_t u32MaxPages, uint8_t u8Foreground) {
+    stc_nand_ftl_block_t *pstcBlk = &m_pstcCfg->pstcBlock[m_u32GcBlock];
+    const stc_nand_ftl_tag_t *pstcTag = NAND_FTL_Tag(m_au32Scratch);
+    uint32_t u32Base = m_u32GcBlock * m_pstcCfg->u16PagesPerBlock;
+    uint32_t u32Ppn;
+    uint32_t i;
+    int32_t i32Ret;
+
+    m_u32ScratchLpn = NAND_FTL_INVD;
+
+    while ((m_u32GcPage < m_pstcCfg->u16PagesPerBlock) && (pstcBlk->u16Valid != 0U) && (u32MaxPages != 0U)) {
+        u32Ppn = u32Base + m_u32GcPage;
+        u32MaxPages--;
+
+        if ((NAND_FTL_ReadTagged(u32Ppn, m_au32Scratch) == LL_OK) && (pstcTag->u32Lpn < m_pstcCfg->u32LpnNum) &&
+                (m_pstcCfg->pu32Map[pstcTag->u32Lpn] == u32Ppn)) {
+            if ((u8Foreground == 0U) && (m_u32FreeNum <= NAND_FTL_RESERVE_BLOCKS) &&
+                    ((m_u32ActBlock == NAND_FTL_INVD) || (m_u32ActPage >= m_pstcCfg->u16PagesPerBlock))) {
+                m_u32ScratchLpn = NAND_FTL_INVD;
+                return LL_ERR_NOT_RDY;
+            }
+
+            i32Ret = NAND_FTL_Program(pstcTag->u32Lpn, m_au32Scratch);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+
+            m_stcStats.u32GcPages++;
+        }
+
+        m_u32GcPage++;
+    }
+
+    if ((m_u32GcPage < m_pstcCfg->u16PagesPerBlock) && (pstcBlk->u16Valid != 0U)) {
+        return LL_OK;
+    }
+
+    /* 读不出的页无法得知逻辑页号, 从映射表中清除指向本块的项 */
+    if (pstcBlk->u16Valid != 0U) {
+        for (i = 0U; i < m_pstcCfg->u32LpnNum; i++) {
+            if ((m_pstcCfg->pu32Map[i] != NAND_FTL_INVD) && ((m_pstcCfg->pu32Map[i] - u32Base) < m_pstcCfg->u16PagesPerBlock)) {
+                m_pstcCfg->pu32Map[i] = NAND_FTL_INVD;
+                m_stcStats.u32EccFails++;
+            }
+        }
+    }
+
+    if (pstcBlk->u8State == NAND_FTL_BLK_RETIRE) {
+        NAND_FTL_MarkBad(m_u32GcBlock);
+    } else {
+        (void)NAND_FTL_Erase(m_u32GcBlock);
+    }
+
+    m_u32GcBlock = NAND_FTL_INVD;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  前台回收, 直到空闲块多于 NAND_FTL_RESERVE_BLOCKS
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_BUF_FULL:         已没有可回收的空间
+ */
+static int32_t NAND_FTL_GcForeground(void) {
+    int32_t i32Ret;
+
+    while (m_u32FreeNum <= NAND_FTL_RESERVE_BLOCKS) {
+        if (m_u32GcBlock == NAND_FTL_INVD) {
+            m_u32GcBlock = NAND_FTL_PickVictim(0U, 1U);
+            m_u32GcPage = 0U;
+
+            if (m_u32GcBlock == NAND_FTL_INVD) {
+                return (m_u32FreeNum != 0U) ? LL_OK : LL_ERR_BUF_FULL;
+            }
+        }
+
+        i32Ret = NAND_FTL_GcStep(NAND_FTL_INVD, 1U);
+
+        if (i32Ret != LL_OK) {
+            return i32Ret;
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  把缓存页写入闪存
+ * @param  [in]  pstcCache              缓存页
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_BUF_FULL:         闪存已满
+ * @note   未写满的页先读出旧页, 在 RAM 中补齐缺少的扇区, 不做擦除;
+ *         旧页不可纠正时缺少的扇区补 0xFF.
+ */
+static int32_t NAND_FTL_Flush(stc_nand_ftl_cache_t *pstcCache) {
+    uint32_t u32Ppn;
+    uint32_t u32Sec;
+    uint32_t u32Off;
+    int32_t i32Ret;
+
+    if (pstcCache->u32Mask == 0U) {
+        return LL_OK;
+    }
+
+    if (pstcCache->u32Mask != m_u32FullMask) {
+        u32Ppn = m_pstcCfg->pu32Map[pstcCache->u32Lpn];
+        m_u32ScratchLpn = NAND_FTL_INVD;
+
+        if ((u32Ppn != NAND_FTL_INVD) && (NAND_FTL_ReadTagged(u32Ppn, m_au32Scratch) == LL_OK)) {
+            m_u32ScratchLpn = pstcCache->u32Lpn;
+        } else {
+            if (u32Ppn != NAND_FTL_INVD) {
+                m_stcStats.u32EccFails++;
+            }
+
+            (void)memset(m_au32Scratch, 0xFF, m_pstcCfg->u16PageSize);
+        }
+
+        for (u32Sec = 0U; (m_u32FullMask >> u32Sec) != 0U; u32Sec++) {
+            if ((pstcCache->u32Mask & (1UL << u32Sec)) == 0U) {
+                u32Off = u32Sec * (NAND_FTL_SECTOR_SIZE / 4U);
+                (void)memcpy(&pstcCache->au32Buf[u32Off], &m_au32Scratch[u32Off], NAND_FTL_SECTOR_SIZE);
+            }
+        }
+
+        m_stcStats.u32Merges++;
+    }
+
+    /* 掉电打断回收后空闲块可能少于保留数, 此时活动块剩余的页也先留给回收 */
+    if ((m_u32FreeNum < NAND_FTL_RESERVE_BLOCKS) ||
+            (((m_u32ActBlock == NAND_FTL_INVD) || (m_u32ActPage >= m_pstcCfg->u16PagesPerBlock)) &&
+             (m_u32FreeNum <= NAND_FTL_RESERVE_BLOCKS))) {
+        i32Ret = NAND_FTL_GcForeground();
+
+        if (i32Ret != LL_OK) {
+            return i32Ret;
+        }
+    }
+
+    i32Ret = NAND_FTL_Program(pstcCache->u32Lpn, pstcCache->au32Buf);
+
+    if (i32Ret == LL_OK) {
+        if (m_u32ScratchLpn == pstcCache->u32Lpn) {
+            m_u32ScratchLpn = NAND_FTL_INVD;
+        }
+
+        pstcCache->u32Mask = 0U;
+        pstcCache->u32Lpn = NAND_FTL_INVD;
+    }
+
+    return i32Ret;
+}
+
+static void NAND_FTL_Reset(const stc_nand_ftl_cfg_t *pstcCfg) {
+    uint32_t i;
+
+    m_pstcCfg = pstcCfg;
+    m_u32PageLen = (uint32_t)pstcCfg->u16PageSize + NAND_FTL_TAG_SIZE;
+    m_u32FullMask = (1UL << (pstcCfg->u16PageSize / NAND_FTL_SECTOR_SIZE)) - 1UL;
+    m_u32Seq = 0U;
+    m_u32FreeNum = 0U;
+    m_u32ActBlock = NAND_FTL_INVD;
+    m_u32GcBlock = NAND_FTL_INVD;
+    m_u32ScratchLpn = NAND_FTL_INVD;
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    for (i = 0U; i < NAND_FTL_CACHE_NUM; i++) {
+        m_astcCache[i].u32Lpn = NAND_FTL_INVD;
+        m_astcCache[i].u32Mask = 0U;
+    }
+
+    for (i = 0U; i < pstcCfg->u32LpnNum; i++) {
+        pstcCfg->pu32Map[i] = NAND_FTL_INVD;
+    }
+}
+
+static int32_t NAND_FTL_CheckCfg(const stc_nand_ftl_cfg_t *pstcCfg) {
+    if ((pstcCfg == NULL) || (pstcCfg->pstcOps == NULL) || (pstcCfg->pu32Map == NULL) || (pstcCfg->pstcBlock == NULL) ||
+            (pstcCfg->u16PageSize == 0U) || (pstcCfg->u16PageSize > NAND_FTL_PAGE_MAX) ||
+            ((pstcCfg->u16PageSize % NAND_FTL_SECTOR_SIZE) != 0U) || (pstcCfg->u16PagesPerBlock == 0U) ||
+            (pstcCfg->u32BlockNum <= NAND_FTL_RESERVE_BLOCKS) ||
+            (pstcCfg->u32LpnNum > (pstcCfg->u32BlockNum - NAND_FTL_RESERVE_BLOCKS - 1U) * pstcCfg->u16PagesPerBlock)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  块是否为坏块
+ * @param  [in]  u32Block               块号
+ * @retval 1: 坏块; 0: 好块
+ */
+static uint8_t NAND_FTL_IsBad(uint32_t u32Block) {
+    const uint8_t *pu8Spare = (const uint8_t *)m_au32Scratch + m_pstcCfg->u16PageSize;
+
+    m_u32ScratchLpn = NAND_FTL_INVD;
+
+    if (m_pstcCfg->pstcOps->pfnReadRaw(u32Block * m_pstcCfg->u16PagesPerBlock, (uint8_t *)m_au32Scratch,
+                                       m_pstcCfg->u16PageSize + 4U) != LL_OK) {
+        return 1U;
+    }
+
+    return (uint8_t)(pu8Spare[0] != 0xFFU);
+}
+
+/**
+ * @brief  块内从指定页到块尾是否都已擦除
+ * @param  [in]  u32Block               块号
+ * @param  [in]  u32Page                块内起始页
+ * @retval 1: 都已擦除, 可以接着编程; 0: 有页读取失败或不全为 0xFF(编程被掉电打断)
+ */
+static uint8_t NAND_FTL_IsErased(uint32_t u32Block, uint32_t u32Page) {
+    uint32_t i;
+
+    m_u32ScratchLpn = NAND_FTL_INVD;
+
+    for (; u32Page < m_pstcCfg->u16PagesPerBlock; u32Page++) {
+        m_stcStats.u32PageReads++;
+
+        if (m_pstcCfg->pstcOps->pfnReadPage(u32Block * m_pstcCfg->u16PagesPerBlock + u32Page,
+                                            (uint8_t *)m_au32Scratch, m_u32PageLen) != LL_OK) {
+            return 0U;
+        }
+
+        for (i = 0U; i < (m_u32PageLen / 4U); i++) {
+            if (m_au32Scratch[i] != 0xFFFFFFFFUL) {
+                return 0U;
+            }
+        }
+    }
+
+    return 1U;
+}
+
+/**
+ * @brief  格式化: 擦除所有好块
+ * @param  [in]  pstcCfg                配置, 运行期间须保持有效
+ * @retval int32_t:
+ *           - LL_OK:                   成功, 可直接读写
+ *           - LL_ERR_INVD_PARAM:       配置错误
+ * @note   能读出标签的块保留原擦除次数.
+ */
+int32_t NAND_FTL_Format(const stc_nand_ftl_cfg_t *pstcCfg) {
+    stc_nand_ftl_block_t *pstcBlk;
+    uint32_t i;
+
+    if (NAND_FTL_CheckCfg(pstcCfg) != LL_OK) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    NAND_FTL_Reset(pstcCfg);
+
+    for (i = 0U; i < pstcCfg->u32BlockNum; i++) {
+        pstcBlk = &pstcCfg->pstcBlock[i];
+        pstcBlk->u32EraseCnt = 0U;
+        pstcBlk->u32Seq = 0U;
+        pstcBlk->u16Valid = 0U;
+        pstcBlk->u8State = NAND_FTL_BLK_BAD;
+
+        if (NAND_FTL_IsBad(i) != 0U) {
+            m_stcStats.u32BadBlocks++;
+            continue;
+        }
+
+        if (NAND_FTL_ReadTagged(i * pstcCfg->u16PagesPerBlock, m_au32Scratch) == LL_OK) {
+            pstcBlk->u32EraseCnt = NAND_FTL_Tag(m_au32Scratch)->u32Erase >> 8U;
+        }
+
+        (void)NAND_FTL_Erase(i);
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  挂载: 扫描闪存重建映射表和块信息
+ * @param  [in]  pstcCfg                配置, 运行期间须保持有效
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       配置错误
+ * @note   每个数据块的页都要读一遍, 耗时与已写入的页数成正比.
+ *         最新的块尾部都已擦除时接着写入: 每次挂载都另起新块的话, 回收搬移途中反复掉电,
+ *         每次都丢掉目标块剩余的页, 空闲块会被耗尽, 回收再也没有块可写.
+ */
+int32_t NAND_FTL_Mount(const stc_nand_ftl_cfg_t *pstcCfg) {
+    stc_nand_ftl_block_t *pstcBlk;
+    const stc_nand_ftl_tag_t *pstcTag;
+    uint32_t u32Block;
+    uint32_t u32Newest = NAND_FTL_INVD;
+    uint32_t u32Next = 0U;
+    uint32_t u32Last = 0U;
+    uint32_t u32Sum = 0U;
+    uint32_t u32Known = 0U;
+    uint32_t u32Ppn;
+    uint32_t u32Old;
+    uint32_t i;
+    uint32_t j;
+    int32_t i32Ret;
+
+    if (NAND_FTL_CheckCfg(pstcCfg) != LL_OK) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    NAND_FTL_Reset(pstcCfg);
+    pstcTag = NAND_FTL_Tag(m_au32Scratch);
+
+    for (i = 0U; i < pstcCfg->u32BlockNum; i++) {
+        pstcBlk = &pstcCfg->pstcBlock[i];
+        pstcBlk->u32EraseCnt = NAND_FTL_INVD;
+        pstcBlk->u32Seq = 0U;
+        pstcBlk->u16Valid = 0U;
+
+        if (NAND_FTL_IsBad(i) != 0U) {
+            pstcBlk->u8State = NAND_FTL_BLK_BAD;
+            m_stcStats.u32BadBlocks++;
+        } else if (NAND_FTL_ReadTagged(i * pstcCfg->u16PagesPerBlock, m_au32Scratch) == LL_OK) {
+            pstcBlk->u8State = NAND_FTL_BLK_DATA;
+            pstcBlk->u32EraseCnt = pstcTag->u32Erase >> 8U;
+            pstcBlk->u32Seq = pstcTag->u32Seq;
+            u32Sum += pstcBlk->u32EraseCnt;
+            u32Known++;
+        } else {
+            pstcBlk->u8State = NAND_FTL_BLK_FREE;
+            m_u32FreeNum++;
+        }
+    }
+
+    /* 按块首页序号从旧到新扫描, 后写入的覆盖先写入的 */
+    for (;;) {
+        u32Block = NAND_FTL_INVD;
+
+        for (i = 0U; i < pstcCfg->u32BlockNum; i++) {
+            pstcBlk = &pstcCfg->pstcBlock[i];
+
+            if ((pstcBlk->u8State == NAND_FTL_BLK_DATA) && (pstcBlk->u32Seq > u32Last) &&
+                    ((u32Block == NAND_FTL_INVD) || (pstcBlk->u32Seq < pstcCfg->pstcBlock[u32Block].u32Seq))) {
+                u32Block = i;
+            }
+        }
+
+        if (u32Block == NAND_FTL_INVD) {
+            break;
+        }
+
+        u32Last = pstcCfg->pstcBlock[u32Block].u32Seq;
+
+        for (j = 0U; j < pstcCfg->u16PagesPerBlock; j++) {
+            u32Ppn = u32Block * pstcCfg->u16PagesPerBlock + j;
+            i32Ret = NAND_FTL_ReadTagged(u32Ppn, m_au32Scratch);
+
+            if (i32Ret == LL_ERR_NOT_RDY) {
+                break;
+            }
+
+            if ((i32Ret != LL_OK) || (pstcTag->u32Lpn >= pstcCfg->u32LpnNum)) {
+                continue;
+            }
+
+            u32Old = pstcCfg->pu32Map[pstcTag->u32Lpn];
+
+            if (u32Old != NAND_FTL_INVD) {
+                pstcCfg->pstcBlock[u32Old / pstcCfg->u16PagesPerBlock].u16Valid--;
+            }
+
+            pstcCfg->pu32Map[pstcTag->u32Lpn] = u32Ppn;
+            pstcCfg->pstcBlock[u32Block].u16Valid++;
+            m_u32Seq = LL_MAX(m_u32Seq, pstcTag->u32Seq);
+        }
+
+        u32Newest = u32Block;
+        u32Next = j;
+    }
+
+    if ((u32Newest != NAND_FTL_INVD) && (NAND_FTL_IsErased(u32Newest, u32Next) != 0U)) {
+        m_u32ActBlock = u32Newest;
+        m_u32ActPage = u32Next;
+    }
+
+    /* 已擦除未写入的块不知道擦除次数, 取平均值 */
+    for (i = 0U; i < pstcCfg->u32BlockNum; i++) {
+        if (pstcCfg->pstcBlock[i].u32EraseCnt == NAND_FTL_INVD) {
+            pstcCfg->pstcBlock[i].u32EraseCnt = (u32Known != 0U) ? (u32Sum / u32Known) : 0U;
+        }
+    }
+
+    m_u32ScratchLpn = NAND_FTL_INVD;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  读扇区
+ * @param  [in]  u32Sector              起始扇区
+ * @param  [out] pu8Buf                 数据
+ * @param  [in]  u32Count               扇区数
+ * @retval int32_t:
+ *           - LL_OK:                   成功, 未写过的扇区读出 0xFF
+ *           - LL_ERR_INVD_PARAM:       越界
+ *           - LL_ERR_UNINIT:           未挂载
+ *           - LL_ERR:                  ECC 不可纠正
+ */
+int32_t NAND_FTL_Read(uint32_t u32Sector, uint8_t *pu8Buf, uint32_t u32Count) {
+    uint32_t u32Spp;
+    uint32_t u32Lpn;
+    uint32_t u32Sec;
+    uint32_t u32Ppn;
+    uint32_t i;
+    const uint32_t *pu32Src;
+
+    if (m_pstcCfg == NULL) {
+        return LL_ERR_UNINIT;
+    }
+
+    u32Spp = m_pstcCfg->u16PageSize / NAND_FTL_SECTOR_SIZE;
+
+    if ((pu8Buf == NULL) || ((u32Sector + u32Count) > m_pstcCfg->u32LpnNum * u32Spp) || ((u32Sector + u32Count) < u32Sector)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    while (u32Count != 0U) {
+        u32Lpn = u32Sector / u32Spp;
+        u32Sec = u32Sector % u32Spp;
+        pu32Src = NULL;
+
+        for (i = 0U; i < NAND_FTL_CACHE_NUM; i++) {
+            if ((m_astcCache[i].u32Lpn == u32Lpn) && ((m_astcCache[i].u32Mask & (1UL << u32Sec)) != 0U)) {
+                pu32Src = m_astcCache[i].au32Buf;
+            }
+        }
+
+        if (pu32Src == NULL) {
+            u32Ppn = m_pstcCfg->pu32Map[u32Lpn];
+
+            if (u32Ppn == NAND_FTL_INVD) {
+                (void)memset(pu8Buf, 0xFF, NAND_FTL_SECTOR_SIZE);
+            } else {
+                if (m_u32ScratchLpn != u32Lpn) {
+                    m_u32ScratchLpn = NAND_FTL_INVD;
+
+                    if (NAND_FTL_ReadTagged(u32Ppn, m_au32Scratch) != LL_OK) {
+                        m_stcStats.u32EccFails++;
+                        return LL_ERR;
+                    }
+
+                    m_u32ScratchLpn = u32Lpn;
+                }
+
+                pu32Src = m_au32Scratch;
+            }
+        }
+
+        if (pu32Src != NULL) {
+            (void)memcpy(pu8Buf, &pu32Src[u32Sec * (NAND_FTL_SECTOR_SIZE / 4U)], NAND_FTL_SECTOR_SIZE);
+        }
+
+        pu8Buf += NAND_FTL_SECTOR_SIZE;
+        u32Sector++;
+        u32Count--;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  写扇区
+ * @param  [in]  u32Sector              起始扇区
+ * @param  [in]  pu8Buf                 数据
+ * @param  [in]  u32Count               扇区数
+ * @retval int32_t:
+ *           - LL_OK:                   成功(可能仍在 RAM 缓存中, 掉电前调用 NAND_FTL_Sync)
+ *           - LL_ERR_INVD_PARAM:       越界
+ *           - LL_ERR_UNINIT:           未挂载
+ *           - LL_ERR_BUF_FULL:         闪存已满
+ * @note   同一逻辑页的扇区在缓存中合并, 写满整页立即编程, 否则等被换出或 Sync.
+ */
+int32_t NAND_FTL_Write(uint32_t u32Sector, const uint8_t *pu8Buf, uint32_t u32Count) {
+    stc_nand_ftl_cache_t *pstcCache;
+    uint32_t u32Spp;
+    uint32_t u32Lpn;
+    uint32_t u32Sec;
+    uint32_t i;
+    int32_t i32Ret;
+
+    if (m_pstcCfg == NULL) {
+        return LL_ERR_UNINIT;
+    }
+
+    u32Spp = m_pstcCfg->u16PageSize / NAND_FTL_SECTOR_SIZE;
+
+    if ((pu8Buf == NULL) || ((u32Sector + u32Count) > m_pstcCfg->u32LpnNum * u32Spp) || ((u32Sector + u32Count) < u32Sector)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    while (u32Count != 0U) {
+        u32Lpn = u32Sector / u32Spp;
+        u32Sec = u32Sector % u32Spp;
+        pstcCache = NULL;
+
+        for (i = 0U; i < NAND_FTL_CACHE_NUM; i++) {
+            if (m_astcCache[i].u32Lpn == u32Lpn) {
+                pstcCache = &m_astcCache[i];
+            }
+        }
+
+        if (pstcCache == NULL) {
+            /* 换出最久未写的缓存页 */
+            pstcCache = &m_astcCache[0];
+
+            for (i = 1U; i < NAND_FTL_CACHE_NUM; i++) {
+                if ((m_astcCache[i].u32Mask == 0U) ||
+                        ((pstcCache->u32Mask != 0U) && ((int32_t)(m_astcCache[i].u32Stamp - pstcCache->u32Stamp) < 0))) {
+                    pstcCache = &m_astcCache[i];
+                }
+            }
+
+            i32Ret = NAND_FTL_Flush(pstcCache);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+
+            pstcCache->u32Lpn = u32Lpn;
+        }
+
+        (void)memcpy(&pstcCache->au32Buf[u32Sec * (NAND_FTL_SECTOR_SIZE / 4U)], pu8Buf, NAND_FTL_SECTOR_SIZE);
+        pstcCache->u32Mask |= 1UL << u32Sec;
+        pstcCache->u32Stamp = ++m_u32Stamp;
+        m_stcStats.u32HostSectors++;
+
+        if (pstcCache->u32Mask == m_u32FullMask) {
+            i32Ret = NAND_FTL_Flush(pstcCache);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+        }
+
+        pu8Buf += NAND_FTL_SECTOR_SIZE;
+        u32Sector++;
+        u32Count--;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  把缓存中的数据全部写入闪存
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - 其它:                    同 NAND_FTL_Write
+ */
+int32_t NAND_FTL_Sync(void) {
+    uint32_t i;
+    int32_t i32Ret;
+
+    if (m_pstcCfg == NULL) {
+        return LL_ERR_UNINIT;
+    }
+
+    for (i = 0U; i < NAND_FTL_CACHE_NUM; i++) {
+        i32Ret = NAND_FTL_Flush(&m_astcCache[i]);
+
+        if (i32Ret != LL_OK) {
+            return i32Ret;
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  后台回收, 在空闲时调用
+ * @param  [in]  u32MaxPages            本次最多检查的页数, 用来限制单次耗时
+ * @retval int32_t:
+ *           - LL_OK:                   做了回收工作
+ *           - LL_ERR_NOT_RDY:          没有需要回收的块, 或空闲块只剩保留块(留给写入时的前台回收)
+ *           - LL_ERR_UNINIT:           未挂载
+ *           - LL_ERR_BUF_FULL:         没有空闲块可写
+ * @note   空闲块只比保留块多一块或需要磨损均衡时才回收, 把擦除的延迟挪出写路径;
+ *         回收得更早时选中的块有效页更多, 写放大成倍增加(Tools/nand_ftl_sim.py bench).
+ */
+int32_t NAND_FTL_BackgroundGc(uint32_t u32MaxPages) {
+    if (m_pstcCfg == NULL) {
+        return LL_ERR_UNINIT;
+    }
+
+    if (m_u32GcBlock == NAND_FTL_INVD) {
+        if (m_u32FreeNum <= NAND_FTL_RESERVE_BLOCKS) {
+            return LL_ERR_NOT_RDY;
+        }
+
+        /* 空闲块充足时只做磨损均衡 */
+        m_u32GcBlock = NAND_FTL_PickVictim(1U, (uint8_t)(m_u32FreeNum <= (NAND_FTL_RESERVE_BLOCKS + 1U)));
+        m_u32GcPage = 0U;
+
+        if (m_u32GcBlock == NAND_FTL_INVD) {
+            return LL_ERR_NOT_RDY;
+        }
+    }
+
+    return NAND_FTL_GcStep(u32MaxPages, 0U);
+}
+
+/**
+ * @brief  逻辑扇区数
+ * @param  无
+ * @retval 扇区数, 未挂载时为 0
+ */
+uint32_t NAND_FTL_GetSectorNum(void) {
+    if (m_pstcCfg == NULL) {
+        return 0U;
+    }
+
+    return m_pstcCfg->u32LpnNum * (m_pstcCfg->u16PageSize / NAND_FTL_SECTOR_SIZE);
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              输出
+ * @retval 无
+ */
+void NAND_FTL_GetStats(stc_nand_ftl_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
+
+#if (LL_NFC_ENABLE == DDL_ON)
+/*
+ * EXMC NFC 实现: 需用 EXMC_NFC_Init 配置为 1 位 ECC, 备用区用户数据大小为 NAND_FTL_TAG_SIZE.
+ * 1 位 ECC 每 512 字节一段, 单比特错误由软件按硬件给出的位置纠正.
+ */
+#define NAND_FTL_NFC_STATUS_FAIL    (0x01UL)
+
+static int32_t NAND_FTL_NfcReadPage(uint32_t u32Page, uint8_t *pu8Buf, uint32_t u32Len) {
+    uint32_t u32Section;
+    uint32_t u32Result;
+    uint32_t u32Byte;
+    int32_t i32Ret;
+
+    EXMC_NFC_ClearStatus(EXMC_NFC_FLAG_ECC_ERR);
+    i32Ret = EXMC_NFC_ReadPageHwEcc(NAND_FTL_NFC_BANK, u32Page, pu8Buf, u32Len, EXMC_NFC_MAX_TIMEOUT);
+
+    if ((i32Ret != LL_OK) || (EXMC_NFC_GetStatus(EXMC_NFC_FLAG_ECC_ERR) == RESET)) {
+        return i32Ret;
+    }
+
+    for (u32Section = 0U; u32Section < LL_MIN((u32Len + 511U) / 512U, 16UL); u32Section++) {
+        u32Result = EXMC_NFC_Get1BitEccResult(u32Section);
+
+        if (u32Result == EXMC_NFC_1BIT_ECC_MULTIPLE_BITS_ERR) {
+            i32Ret = LL_ERR;
+            break;
+        }
+
+        if (u32Result == EXMC_NFC_1BIT_ECC_SINGLE_BIT_ERR) {
+            u32Byte = u32Section * 512U + EXMC_NFC_Get1BitEccErrByteLocation(u32Section);
+
+            if (u32Byte < u32Len) {
+                pu8Buf[u32Byte] ^= (uint8_t)(1U << EXMC_NFC_Get1BitEccErrBitLocation(u32Section));
+            }
+        }
+    }
+
+    EXMC_NFC_ClearStatus(EXMC_NFC_FLAG_ECC_ERR);
+
+    return i32Ret;
+}
+
+static int32_t NAND_FTL_NfcWritePage(uint32_t u32Page, const uint8_t *pu8Buf, uint32_t u32Len) {
+    if (EXMC_NFC_WritePageHwEcc(NAND_FTL_NFC_BANK, u32Page, pu8Buf, u32Len, EXMC_NFC_MAX_TIMEOUT) != LL_OK) {
+        return LL_ERR;
+    }
+
+    return ((EXMC_NFC_ReadStatus(NAND_FTL_NFC_BANK) & NAND_FTL_NFC_STATUS_FAIL) != 0U) ? LL_ERR : LL_OK;
+}
+
+static int32_t NAND_FTL_NfcReadRaw(uint32_t u32Page, uint8_t *pu8Buf, uint32_t u32Len) {
+    return EXMC_NFC_ReadPageMeta(NAND_FTL_NFC_BANK, u32Page, pu8Buf, u32Len, EXMC_NFC_MAX_TIMEOUT);
+}
+
+static int32_t NAND_FTL_NfcWriteRaw(uint32_t u32Page, const uint8_t *pu8Buf, uint32_t u32Len) {
+    return EXMC_NFC_WritePageMeta(NAND_FTL_NFC_BANK, u32Page, pu8Buf, u32Len, EXMC_NFC_MAX_TIMEOUT);
+}
+
+static int32_t NAND_FTL_NfcEraseBlock(uint32_t u32Page) {
+    if (EXMC_NFC_EraseBlock(NAND_FTL_NFC_BANK, u32Page, EXMC_NFC_MAX_TIMEOUT) != LL_OK) {
+        return LL_ERR;
+    }
+
+    return ((EXMC_NFC_ReadStatus(NAND_FTL_NFC_BANK) & NAND_FTL_NFC_STATUS_FAIL) != 0U) ? LL_ERR : LL_OK;
+}
+
+const stc_nand_ftl_ops_t NAND_FTL_NfcOps = {
+    NAND_FTL_NfcReadPage,
+    NAND_FTL_NfcWritePage,
+    NAND_FTL_NfcReadRaw,
+    NAND_FTL_NfcWriteRaw,
+    NAND_FTL_NfcEraseBlock
+};
+#endif
@@ -0,0 +1,121 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : nand_ftl.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : NAND 闪存转换层(FTL)
+                   日志结构: 逻辑页的每次更新都写到当前活动块的下一页, 不擦除原块;
+                   映射表常驻 RAM, 挂载时由各页备用区标签重建;
+                   512 字节扇区先在 RAM 页缓存中合并, 整页写满或被换出时才编程;
+                   空闲块不足时回收有效页最少的块, 后台回收时兼做静态磨损均衡.
+                   闪存读写通过 stc_nand_ftl_ops_t 接入, NAND_FTL_NfcOps 为 EXMC NFC 硬件 ECC 实现;
+                   Tools/nand_ftl_sim.py 接入带故障注入的 NAND 模型做主机测试和性能对比.
+  * Function List:
+                   NAND_FTL_Format
+                   NAND_FTL_Mount
+                   NAND_FTL_Read
+                   NAND_FTL_Write
+                   NAND_FTL_Sync
+                   NAND_FTL_BackgroundGc
+                   NAND_FTL_GetSectorNum
+                   NAND_FTL_GetStats
+  ******************************************************
+**/
+
+#ifndef __NAND_FTL_H_
+#define __NAND_FTL_H_
+
+#include "hc32_ll.h"
+
+#define NAND_FTL_SECTOR_SIZE        (512U)
+#define NAND_FTL_PAGE_MAX           (2048U)     /*!< 支持的最大页(数据区)字节数 */
+#define NAND_FTL_TAG_SIZE           (16U)       /*!< 备用区中受 ECC 保护的用户数据字节数 */
+#define NAND_FTL_CACHE_NUM          (2U)        /*!< 写合并缓存页数 */
+#define NAND_FTL_RESERVE_BLOCKS     (2U)        /*!< 保留给前台回收搬移的空闲块, 主机写入和后台回收不占用 */
+#define NAND_FTL_WL_THRESHOLD       (256U)      /*!< 擦除次数差超过该值时后台回收做静态磨损均衡 */
+
+#define NAND_FTL_NFC_BANK           (EXMC_NFC_BANK0)
+
+/**
+ * @defgroup NAND_FTL_Block_State 块状态
+ */
+#define NAND_FTL_BLK_FREE           (0U)        /*!< 空闲, 未擦除 */
+#define NAND_FTL_BLK_ERASED         (1U)        /*!< 空闲, 已擦除 */
+#define NAND_FTL_BLK_DATA           (2U)
+#define NAND_FTL_BLK_RETIRE         (3U)        /*!< 编程失败, 回收后标记为坏块 */
+#define NAND_FTL_BLK_BAD            (4U)
+
+/**
+ * @brief 闪存操作, 页地址为整个器件的行地址
+ * @note  pfnReadPage/pfnWritePage 读写数据区加 NAND_FTL_TAG_SIZE 字节备用区并使用 ECC,
+ *        不可纠正时返回 LL_ERR; pfnReadRaw/pfnWriteRaw 不使用 ECC, 用于坏块标记;
+ *        编程或擦除状态失败返回 LL_ERR.
+ */
+typedef struct {
+    int32_t (*pfnReadPage)(uint32_t u32Page, uint8_t *pu8Buf, uint32_t u32Len);
+    int32_t (*pfnWritePage)(uint32_t u32Page, const uint8_t *pu8Buf, uint32_t u32Len);
+    int32_t (*pfnReadRaw)(uint32_t u32Page, uint8_t *pu8Buf, uint32_t u32Len);
+    int32_t (*pfnWriteRaw)(uint32_t u32Page, const uint8_t *pu8Buf, uint32_t u32Len);
+    int32_t (*pfnEraseBlock)(uint32_t u32Page);
+} stc_nand_ftl_ops_t;
+
+/**
+ * @brief 块信息, 由用户提供 u32BlockNum 个
+ */
+typedef struct {
+    uint32_t u32EraseCnt;
+    uint32_t u32Seq;                /*!< 块内第一页的写入序号 */
+    uint16_t u16Valid;              /*!< 有效页数 */
+    uint8_t u8State;                /*!< @ref NAND_FTL_Block_State */
+    uint8_t u8Rsvd;
+} stc_nand_ftl_block_t;
+
+/**
+ * @brief 配置
+ */
+typedef struct {
+    const stc_nand_ftl_ops_t *pstcOps;
+    uint32_t u32BlockNum;
+    uint16_t u16PagesPerBlock;
+    uint16_t u16PageSize;           /*!< 数据区字节数, NAND_FTL_SECTOR_SIZE 的整数倍, 不大于 NAND_FTL_PAGE_MAX */
+    uint32_t u32LpnNum;             /*!< 逻辑页数, 须给坏块和回收留出余量 */
+    uint32_t *pu32Map;              /*!< 映射表, u32LpnNum 个 */
+    stc_nand_ftl_block_t *pstcBlock;    /*!< 块信息, u32BlockNum 个 */
+} stc_nand_ftl_cfg_t;
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32HostSectors;        /*!< 主机写入的扇区 */
+    uint32_t u32PageWrites;         /*!< 闪存页编程次数(含回收搬移) */
+    uint32_t u32PageReads;
+    uint32_t u32Merges;             /*!< 未写满的缓存页与旧页在 RAM 中合并的次数 */
+    uint32_t u32GcPages;            /*!< 回收搬移的页 */
+    uint32_t u32Erases;
+    uint32_t u32WlMoves;            /*!< 静态磨损均衡回收的块 */
+    uint32_t u32BadBlocks;
+    uint32_t u32EccFails;           /*!< 不可纠正的读错误 */
+} stc_nand_ftl_stats_t;
+
+int32_t NAND_FTL_Format(const stc_nand_ftl_cfg_t *pstcCfg);
+int32_t NAND_FTL_Mount(const stc_nand_ftl_cfg_t *pstcCfg);
+int32_t NAND_FTL_Read(uint32_t u32Sector, uint8_t *pu8Buf, uint32_t u32Count);
+int32_t NAND_FTL_Write(uint32_t u32Sector, const uint8_t *pu8Buf, uint32_t u32Count);
+int32_t NAND_FTL_Sync(void);
+int32_t NAND_FTL_BackgroundGc(uint32_t u32MaxPages);
+uint32_t NAND_FTL_GetSectorNum(void);
+void NAND_FTL_GetStats(stc_nand_ftl_stats_t *pstcStats);
+
+#if (LL_NFC_ENABLE == DDL_ON)
+extern const stc_nand_ftl_ops_t NAND_FTL_NfcOps;
+#endif
+
+#endif
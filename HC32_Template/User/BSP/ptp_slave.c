@@ -0,0 +1,628 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : ptp_slave.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : IEEE 1588v2 从时钟
+                   1. 系统时间用十进制亚秒(亚秒即 ns)和精调模式: 每个 HCLK 把加数加到 32 位累加器,
+                      溢出时亚秒加 m_u8Inc ns; m_u8Inc 取 2e9/HCLK 向上取整, 累加器溢出频率约为
+                      HCLK/2, 加数 1 个 LSB 约 0.5ppb;
+                   2. 偏差: offset = t2 - t1 - delay, delay = ((t2 - t1) + (t4 - t3)) / 2,
+                      t1/t4 已计入 correctionField;
+                   3. 伺服: UNLOCKED 记下第一个样本; FREQ_EST 用两个样本的偏差变化估计频偏,
+                      一次补足并作为积分初值; TRACKING 为 PI. 任何状态下偏差超过 u32StepNs
+                      都阶跃系统时间, 阶跃后丢弃跨越阶跃的 Sync/Delay_Req, 重新估计频偏.
+                      PI 系数按 1s 样本间隔给出, 按实际样本间隔换算, 环路按样本计的动态与同步间隔无关.
+                      Tools/ptp_servo_sim.py 在主机上编译本文件, 接到从时钟模型上做闭环仿真和回归;
+                   4. 报文解析只读取需要的字段, 不检查 Announce, 不支持 P2P 延迟测量.
+  * Function List:
+
+  **********************************************************
+ */
+#include "ptp_slave.h"
+#include "string.h"
+
+#define PTP_ETHERTYPE               (0x88F7U)
+#define PTP_ETHERTYPE_IPV4          (0x0800U)
+#define PTP_EVENT_PORT              (319U)
+#define PTP_GENERAL_PORT            (320U)
+#define PTP_IPV4_MCAST              (0xE0000181UL)      /* 224.0.1.129 */
+
+#define PTP_MSG_SYNC                (0x0U)
+#define PTP_MSG_DELAY_REQ           (0x1U)
+#define PTP_MSG_FOLLOW_UP           (0x8U)
+#define PTP_MSG_DELAY_RESP          (0x9U)
+
+#define PTP_HDR_LEN                 (34U)
+#define PTP_DELAY_REQ_LEN           (44U)
+#define PTP_DELAY_RESP_LEN          (54U)
+#define PTP_PORT_ID_LEN             (10U)
+#define PTP_FLAG_TWO_STEP           (0x02U)             /* flagField 第 0 字节 */
+
+#define PTP_ETH_HDR_LEN             (14U)
+#define PTP_IP_HDR_LEN              (20U)
+#define PTP_UDP_HDR_LEN             (8U)
+
+#define PTP_NS_PER_SEC              (1000000000LL)
+
+static const uint8_t m_au8L2Mcast[6] = {0x01U, 0x1BU, 0x19U, 0x00U, 0x00U, 0x00U};
+static const uint8_t m_au8Ip4Mcast[6] = {0x01U, 0x00U, 0x5EU, 0x00U, 0x01U, 0x81U};
+
+static stc_ptp_config_t m_stcConfig;
+static stc_ptp_stats_t m_stcStats;
+static uint8_t m_au8PortId[PTP_PORT_ID_LEN];        /* 本机 clockIdentity + portNumber 1 */
+static uint8_t m_au8Parent[PTP_PORT_ID_LEN];
+static uint8_t m_u8HaveParent;
+static int64_t m_i64ParentSeen;                     /* 最近一次收到主时钟 Sync 的本地时间 */
+
+static uint32_t m_u32AddendBase;
+static uint8_t m_u8Inc;
+
+/* 两步 Sync 等 Follow_Up */
+static uint8_t m_u8SyncPending;
+static uint16_t m_u16SyncSeq;
+static int64_t m_i64SyncT2;
+static int64_t m_i64SyncCorr;
+
+/* 最近一个 Sync 样本的 t2 - t1, 延迟测量用 */
+static uint8_t m_u8MsValid;
+static int64_t m_i64Ms;
+static uint8_t m_u8SyncCount;
+
+/* Delay_Req 往返 */
+static uint8_t m_u8DelayReqPending;
+static uint16_t m_u16DelayReqSeq;
+static uint8_t m_u8T3Valid;
+static uint8_t m_u8T4Valid;
+static int64_t m_i64T3;
+static int64_t m_i64T4;
+static uint8_t m_u8DelayValid;
+static int64_t m_i64Delay;
+
+/* 伺服 */
+static uint8_t m_u8State;
+static int64_t m_i64RefOffset;
+static int64_t m_i64RefLocal;
+static float m_fFreq;
+static float m_fInteg;
+static uint8_t m_u8LockCnt;
+
+static uint16_t PTP_Get16(const uint8_t *pu8Buf) {
+    return (uint16_t)(((uint16_t)pu8Buf[0] << 8U) | pu8Buf[1]);
+}
+
+static void PTP_Put16(uint8_t *pu8Buf, uint16_t u16Val) {
+    pu8Buf[0] = (uint8_t)(u16Val >> 8U);
+    pu8Buf[1] = (uint8_t)u16Val;
+}
+
+static void PTP_Put32(uint8_t *pu8Buf, uint32_t u32Val) {
+    PTP_Put16(pu8Buf, (uint16_t)(u32Val >> 16U));
+    PTP_Put16(&pu8Buf[2], (uint16_t)u32Val);
+}
+
+/* 10 字节时间戳: 48 位秒 + 32 位 ns */
+static int64_t PTP_GetTimestamp(const uint8_t *pu8Buf) {
+    uint64_t u64Sec = 0ULL;
+    uint32_t u32Ns = 0UL;
+    uint32_t i;
+
+    for (i = 0UL; i < 6UL; i++) {
+        u64Sec = (u64Sec << 8U) | pu8Buf[i];
+    }
+
+    for (i = 6UL; i < 10UL; i++) {
+        u32Ns = (u32Ns << 8U) | pu8Buf[i];
+    }
+
+    return ((int64_t)u64Sec * PTP_NS_PER_SEC) + (int64_t)u32Ns;
+}
+
+/* correctionField: ns * 2^16 */
+static int64_t PTP_GetCorrection(const uint8_t *pu8Buf) {
+    uint64_t u64Val = 0ULL;
+    uint32_t i;
+
+    for (i = 0UL; i < 8UL; i++) {
+        u64Val = (u64Val << 8U) | pu8Buf[i];
+    }
+
+    return ((int64_t)u64Val) / 65536LL;
+}
+
+static float PTP_Clamp(float fVal, float fLimit) {
+    if (fVal > fLimit) {
+        return fLimit;
+    }
+
+    if (fVal < -fLimit) {
+        return -fLimit;
+    }
+
+    return fVal;
+}
+
+static int64_t PTP_Abs(int64_t i64Val) {
+    return (i64Val < 0LL) ? -i64Val : i64Val;
+}
+
+/**
+ * 伺服一步
+ * 返回要从本地时间减去的量, 0 为不阶跃; 新的频率调整在 m_fFreq
+ */
+static int64_t PTP_Servo(int64_t i64Offset, int64_t i64Local) {
+    float fLimit = (float)m_stcConfig.u32MaxPpb;
+    int64_t i64Step = 0LL;
+    int64_t i64Dt;
+    float fScale;
+
+    switch (m_u8State) {
+        case PTP_SERVO_UNLOCKED:
+            m_i64RefOffset = i64Offset;
+            m_i64RefLocal = i64Local;
+            m_u8State = PTP_SERVO_FREQ_EST;
+            break;
+
+        case PTP_SERVO_FREQ_EST:
+            i64Dt = i64Local - m_i64RefLocal;
+
+            if (i64Dt <= 0LL) {
+                m_i64RefOffset = i64Offset;
+                m_i64RefLocal = i64Local;
+                break;
+            }
+
+            /* 本地时钟比主时钟快的 ppb */
+            m_fFreq = PTP_Clamp(m_fFreq - ((float)(i64Offset - m_i64RefOffset) * 1.0e9F / (float)i64Dt), fLimit);
+            m_fInteg = m_fFreq;
+
+            if (PTP_Abs(i64Offset) > (int64_t)m_stcConfig.u32StepNs) {
+                i64Step = i64Offset;
+            }
+
+            /* 下一个样本的间隔按阶跃后的时间轴算 */
+            m_i64RefLocal = i64Local - i64Step;
+            m_u8State = PTP_SERVO_TRACKING;
+            break;
+
+        default:
+            i64Dt = i64Local - m_i64RefLocal;
+            m_i64RefLocal = i64Local;
+
+            if (PTP_Abs(i64Offset) > (int64_t)m_stcConfig.u32StepNs) {
+                i64Step = i64Offset;
+                m_u8State = PTP_SERVO_UNLOCKED;
+            } else if (i64Dt > 0LL) {
+                fScale = (float)PTP_NS_PER_SEC / (float)i64Dt;
+                m_fInteg = PTP_Clamp(m_fInteg - (m_stcConfig.fKi * fScale * (float)i64Offset), fLimit);
+                m_fFreq = PTP_Clamp(m_fInteg - (m_stcConfig.fKp * fScale * (float)i64Offset), fLimit);
+            } else {
+                /* 时间没有前进, 保持原频率 */
+            }
+            break;
+    }
+
+    return i64Step;
+}
+
+static void PTP_SetFreq(int32_t i32Ppb) {
+    int64_t i64Addend = (int64_t)m_u32AddendBase +
+                        (((int64_t)m_u32AddendBase * (int64_t)i32Ppb) / PTP_NS_PER_SEC);
+
+    ETH_PTP_SetBasicAddend((uint32_t)i64Addend, m_u8Inc);
+    (void)ETH_PTP_UpdateBasicAddend();
+}
+
+static void PTP_StepTime(int64_t i64Step) {
+    uint64_t u64Abs = (uint64_t)PTP_Abs(i64Step);
+    uint32_t u32Sign = (i64Step > 0LL) ? ETH_PTP_TIME_UPDATE_SIGN_MINUS : ETH_PTP_TIME_UPDATE_SIGN_PLUS;
+
+    ETH_PTP_SetUpdateTime(u32Sign, (uint32_t)(u64Abs / (uint64_t)PTP_NS_PER_SEC),
+                          (uint32_t)(u64Abs % (uint64_t)PTP_NS_PER_SEC));
+    (void)ETH_PTP_UpdateSysTime();
+
+    /* 阶跃前取的时间戳和阶跃后的不在同一时间轴上; 父时钟的静默计时换到新时间轴 */
+    m_i64ParentSeen -= i64Step;
+    m_u8SyncPending = 0U;
+    m_u8MsValid = 0U;
+    m_u8DelayReqPending = 0U;
+    m_stcStats.u32Steps++;
+}
+
+static void PTP_ServoReset(void) {
+    m_u8State = PTP_SERVO_UNLOCKED;
+    m_u8LockCnt = 0U;
+    m_u8SyncPending = 0U;
+    m_u8MsValid = 0U;
+    m_u8DelayReqPending = 0U;
+    m_u8DelayValid = 0U;
+    m_u8SyncCount = 0U;
+}
+
+static void PTP_SendDelayReq(void) {
+    stc_ethif_buf_t *pstcBuf = ETHIF_BufAlloc();
+    uint8_t *pu8Frame;
+    uint8_t *pu8Msg;
+    uint16_t u16Seq;
+
+    if (NULL == pstcBuf) {
+        m_stcStats.u32TxFail++;
+        return;
+    }
+
+    u16Seq = (uint16_t)(m_u16DelayReqSeq + 1U);
+    pu8Frame = pstcBuf->pu8Payload;
+    (void)memcpy(&pu8Frame[6], m_stcConfig.au8MacAddr, 6U);
+
+    if (PTP_TRANSPORT_L2 == m_stcConfig.u8Transport) {
+        (void)memcpy(pu8Frame, m_au8L2Mcast, 6U);
+        PTP_Put16(&pu8Frame[12], PTP_ETHERTYPE);
+        pu8Msg = &pu8Frame[PTP_ETH_HDR_LEN];
+        pstcBuf->u16Len = PTP_ETH_HDR_LEN + PTP_DELAY_REQ_LEN;
+    } else {
+        (void)memcpy(pu8Frame, m_au8Ip4Mcast, 6U);
+        PTP_Put16(&pu8Frame[12], PTP_ETHERTYPE_IPV4);
+        pu8Msg = &pu8Frame[PTP_ETH_HDR_LEN];
+        /* IPv4 头, 校验和由硬件填 */
+        (void)memset(pu8Msg, 0, PTP_IP_HDR_LEN + PTP_UDP_HDR_LEN);
+        pu8Msg[0] = 0x45U;
+        PTP_Put16(&pu8Msg[2], PTP_IP_HDR_LEN + PTP_UDP_HDR_LEN + PTP_DELAY_REQ_LEN);
+        PTP_Put16(&pu8Msg[4], u16Seq);
+        pu8Msg[8] = 1U;                         /* TTL, 只在本网段 */
+        pu8Msg[9] = 17U;                        /* UDP */
+        PTP_Put32(&pu8Msg[12], m_stcConfig.u32IpAddr);
+        PTP_Put32(&pu8Msg[16], PTP_IPV4_MCAST);
+        pu8Msg += PTP_IP_HDR_LEN;
+        /* UDP 头, 校验和由硬件填 */
+        PTP_Put16(&pu8Msg[0], PTP_EVENT_PORT);
+        PTP_Put16(&pu8Msg[2], PTP_EVENT_PORT);
+        PTP_Put16(&pu8Msg[4], PTP_UDP_HDR_LEN + PTP_DELAY_REQ_LEN);
+        pu8Msg += PTP_UDP_HDR_LEN;
+        pstcBuf->u16Len = PTP_ETH_HDR_LEN + PTP_IP_HDR_LEN + PTP_UDP_HDR_LEN + PTP_DELAY_REQ_LEN;
+    }
+
+    (void)memset(pu8Msg, 0, PTP_DELAY_REQ_LEN);
+    pu8Msg[0] = PTP_MSG_DELAY_REQ;
+    pu8Msg[1] = 2U;
+    PTP_Put16(&pu8Msg[2], PTP_DELAY_REQ_LEN);
+    pu8Msg[4] = m_stcConfig.u8Domain;
+    (void)memcpy(&pu8Msg[20], m_au8PortId, PTP_PORT_ID_LEN);
+    PTP_Put16(&pu8Msg[30], u16Seq);
+    pu8Msg[32] = 1U;                            /* controlField: Delay_Req */
+    pu8Msg[33] = 0x7FU;
+
+    pstcBuf->u16Flags = ETHIF_BUF_FLAG_TIMESTAMP;
+    m_u8T3Valid = 0U;
+    m_u8T4Valid = 0U;
+
+    if (LL_OK != ETHIF_Output(pstcBuf)) {
+        ETHIF_BufFree(pstcBuf);
+        m_stcStats.u32TxFail++;
+        return;
+    }
+
+    m_u16DelayReqSeq = u16Seq;
+    m_u8DelayReqPending = 1U;
+    m_stcStats.u32DelayReqTx++;
+}
+
+static void PTP_DelayDone(void) {
+    int64_t i64Raw;
+
+    if ((0U == m_u8T3Valid) || (0U == m_u8T4Valid) || (0U == m_u8MsValid)) {
+        return;
+    }
+
+    m_u8DelayReqPending = 0U;
+    i64Raw = (m_i64Ms + (m_i64T4 - m_i64T3)) / 2LL;
+
+    if (i64Raw < 0LL) {
+        return;
+    }
+
+    if (0U == m_u8DelayValid) {
+        m_i64Delay = i64Raw;
+        m_u8DelayValid = 1U;
+    } else {
+        m_i64Delay += (i64Raw - m_i64Delay) / PTP_DELAY_FILTER;
+    }
+
+    m_stcStats.i32Delay = (int32_t)m_i64Delay;
+}
+
+static void PTP_SyncDone(int64_t i64T1, int64_t i64T2) {
+    stc_ptp_sample_t stcSample;
+
+    m_i64Ms = i64T2 - i64T1;
+    m_u8MsValid = 1U;
+
+    if (0U != m_u8DelayValid) {
+        stcSample.i64T1 = i64T1;
+        stcSample.i64T2 = i64T2;
+        stcSample.i64Offset = m_i64Ms - m_i64Delay;
+        stcSample.i32Delay = (int32_t)m_i64Delay;
+        stcSample.u8State = m_u8State;
+        stcSample.i64Step = PTP_Servo(stcSample.i64Offset, i64T2);
+
+        if (0LL != stcSample.i64Step) {
+            PTP_StepTime(stcSample.i64Step);
+        }
+
+        stcSample.i32FreqPpb = (int32_t)m_fFreq;
+
+        if (stcSample.i32FreqPpb != m_stcStats.i32FreqPpb) {
+            PTP_SetFreq(stcSample.i32FreqPpb);
+        }
+
+        if (PTP_Abs(stcSample.i64Offset) < (int64_t)PTP_LOCK_NS) {
+            if (m_u8LockCnt < PTP_LOCK_COUNT) {
+                m_u8LockCnt++;
+            }
+        } else {
+            m_u8LockCnt = 0U;
+        }
+
+        m_stcStats.i64LastOffset = stcSample.i64Offset;
+        m_stcStats.i32FreqPpb = stcSample.i32FreqPpb;
+        m_stcStats.u8State = m_u8State;
+        m_stcStats.u8Locked = (m_u8LockCnt >= PTP_LOCK_COUNT) ? 1U : 0U;
+
+        if (NULL != m_stcConfig.pfnSample) {
+            m_stcConfig.pfnSample(&stcSample);
+        }
+    }
+
+    m_u8SyncCount++;
+
+    if ((0U != m_u8MsValid) && ((0U == m_u8DelayValid) || (m_u8SyncCount >= m_stcConfig.u8DelayReqRate))) {
+        m_u8SyncCount = 0U;
+        PTP_SendDelayReq();
+    }
+}
+
+static void PTP_HandleSync(const uint8_t *pu8Msg, const stc_ethif_buf_t *pstcBuf) {
+    int64_t i64T2;
+
+    if (0U == (pstcBuf->u16Flags & ETHIF_BUF_FLAG_TIMESTAMP)) {
+        m_stcStats.u32NoTimestamp++;
+        return;
+    }
+
+    i64T2 = ((int64_t)pstcBuf->u32TsSec * PTP_NS_PER_SEC) + (int64_t)pstcBuf->u32TsSubsec;
+
+    if (0 != memcmp(&pu8Msg[20], m_au8Parent, PTP_PORT_ID_LEN)) {
+        if ((0U != m_u8HaveParent) &&
+            ((i64T2 - m_i64ParentSeen) < ((int64_t)PTP_PARENT_TIMEOUT * PTP_NS_PER_SEC))) {
+            return;
+        }
+
+        (void)memcpy(m_au8Parent, &pu8Msg[20], PTP_PORT_ID_LEN);
+        m_u8HaveParent = 1U;
+        m_stcStats.u32ParentChanges++;
+        PTP_ServoReset();
+    }
+
+    m_i64ParentSeen = i64T2;
+    m_stcStats.u32SyncRx++;
+
+    if (0U != (pu8Msg[6] & PTP_FLAG_TWO_STEP)) {
+        m_u16SyncSeq = PTP_Get16(&pu8Msg[30]);
+        m_i64SyncT2 = i64T2;
+        m_i64SyncCorr = PTP_GetCorrection(&pu8Msg[8]);
+        m_u8SyncPending = 1U;
+    } else {
+        PTP_SyncDone(PTP_GetTimestamp(&pu8Msg[34]) + PTP_GetCorrection(&pu8Msg[8]), i64T2);
+    }
+}
+
+static void PTP_Handle(const uint8_t *pu8Msg, uint32_t u32Len, const stc_ethif_buf_t *pstcBuf) {
+    uint8_t u8Type;
+    uint16_t u16Seq;
+
+    if ((u32Len < PTP_HDR_LEN + 10U) || (2U != (pu8Msg[1] & 0x0FU)) || (m_stcConfig.u8Domain != pu8Msg[4])) {
+        return;
+    }
+
+    u8Type = pu8Msg[0] & 0x0FU;
+    u16Seq = PTP_Get16(&pu8Msg[30]);
+
+    if (PTP_MSG_SYNC == u8Type) {
+        PTP_HandleSync(pu8Msg, pstcBuf);
+        return;
+    }
+
+    if ((0U == m_u8HaveParent) || (0 != memcmp(&pu8Msg[20], m_au8Parent, PTP_PORT_ID_LEN))) {
+        return;
+    }
+
+    if (PTP_MSG_FOLLOW_UP == u8Type) {
+        if ((0U != m_u8SyncPending) && (u16Seq == m_u16SyncSeq)) {
+            m_u8SyncPending = 0U;
+            m_stcStats.u32FollowUpRx++;
+            PTP_SyncDone(PTP_GetTimestamp(&pu8Msg[34]) + m_i64SyncCorr + PTP_GetCorrection(&pu8Msg[8]),
+                         m_i64SyncT2);
+        }
+    } else if (PTP_MSG_DELAY_RESP == u8Type) {
+        if ((u32Len >= PTP_DELAY_RESP_LEN) && (0U != m_u8DelayReqPending) && (u16Seq == m_u16DelayReqSeq) &&
+            (0 == memcmp(&pu8Msg[44], m_au8PortId, PTP_PORT_ID_LEN))) {
+            m_i64T4 = PTP_GetTimestamp(&pu8Msg[34]) - PTP_GetCorrection(&pu8Msg[8]);
+            m_u8T4Valid = 1U;
+            m_stcStats.u32DelayRespRx++;
+            PTP_DelayDone();
+        }
+    } else {
+        /* Announce 等其他报文不处理 */
+    }
+}
+
+/* 找到 PTP 报文, 不是本传输方式的 PTP 报文时返回 NULL */
+static const uint8_t *PTP_Locate(const stc_ethif_buf_t *pstcBuf, uint32_t *pu32Len) {
+    const uint8_t *pu8Frame = pstcBuf->pu8Payload;
+    const uint8_t *pu8Udp;
+    uint32_t u32Len = pstcBuf->u16Len;
+    uint32_t u32Ihl;
+    uint16_t u16Port;
+
+    if (u32Len < PTP_ETH_HDR_LEN) {
+        return NULL;
+    }
+
+    if (PTP_TRANSPORT_L2 == m_stcConfig.u8Transport) {
+        if (PTP_ETHERTYPE != PTP_Get16(&pu8Frame[12])) {
+            return NULL;
+        }
+
+        *pu32Len = u32Len - PTP_ETH_HDR_LEN;
+        return &pu8Frame[PTP_ETH_HDR_LEN];
+    }
+
+    if ((PTP_ETHERTYPE_IPV4 != PTP_Get16(&pu8Frame[12])) ||
+        (u32Len < (PTP_ETH_HDR_LEN + PTP_IP_HDR_LEN + PTP_UDP_HDR_LEN))) {
+        return NULL;
+    }
+
+    u32Ihl = ((uint32_t)pu8Frame[PTP_ETH_HDR_LEN] & 0x0FUL) * 4UL;
+
+    /* UDP, 且不是分片 */
+    if ((17U != pu8Frame[PTP_ETH_HDR_LEN + 9U]) || (0U != (PTP_Get16(&pu8Frame[PTP_ETH_HDR_LEN + 6U]) & 0x3FFFU)) ||
+        (u32Len < (PTP_ETH_HDR_LEN + u32Ihl + PTP_UDP_HDR_LEN))) {
+        return NULL;
+    }
+
+    pu8Udp = &pu8Frame[PTP_ETH_HDR_LEN + u32Ihl];
+    u16Port = PTP_Get16(&pu8Udp[2]);
+
+    if ((PTP_EVENT_PORT != u16Port) && (PTP_GENERAL_PORT != u16Port)) {
+        return NULL;
+    }
+
+    *pu32Len = u32Len - (PTP_ETH_HDR_LEN + u32Ihl + PTP_UDP_HDR_LEN);
+    return &pu8Udp[PTP_UDP_HDR_LEN];
+}
+
+/**
+ * @brief  初始化 PTP 时钟、时间戳和组播过滤, 在 ETHIF_Init 之后、ETHIF_Start 之前调用
+ * @param  [in]  pstcConfig             初始化参数
+ * @retval int32_t:
+ *           - LL_OK: 成功
+ *           - LL_ERR_INVD_PARAM: 参数错误
+ *           - LL_ERR: PTP 寄存器更新失败
+ */
+int32_t PTP_Init(const stc_ptp_config_t *pstcConfig) {
+    stc_eth_ptp_init_t stcPtpInit;
+    stc_eth_mac_addr_config_t stcMacAddr;
+    stc_eth_pps_config_t stcPps;
+    uint32_t u32Hclk = HCLK_VALUE;
+    int32_t i32Ret;
+
+    if ((NULL == pstcConfig) || (pstcConfig->u8Transport > PTP_TRANSPORT_UDP4) ||
+        (0U == pstcConfig->u8DelayReqRate) || (pstcConfig->fKp < 0.0F) || (pstcConfig->fKi < 0.0F)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcConfig = *pstcConfig;
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    /* EUI-64 时钟 ID: MAC 前 3 字节 + FF FE + 后 3 字节, 端口号 1 */
+    (void)memcpy(m_au8PortId, pstcConfig->au8MacAddr, 3U);
+    m_au8PortId[3] = 0xFFU;
+    m_au8PortId[4] = 0xFEU;
+    (void)memcpy(&m_au8PortId[5], &pstcConfig->au8MacAddr[3], 3U);
+    m_au8PortId[8] = 0U;
+    m_au8PortId[9] = 1U;
+
+    m_u8Inc = (uint8_t)((2000000000UL + u32Hclk - 1UL) / u32Hclk);
+    m_u32AddendBase = (uint32_t)(((uint64_t)PTP_NS_PER_SEC << 32U) / ((uint64_t)m_u8Inc * u32Hclk));
+
+    (void)ETH_PTP_StructInit(&stcPtpInit);
+    stcPtpInit.u32SnapDatagramType = ETH_PTP_DATAGRAM_TYPE_SYNC_FOLLOW_DELAY;
+    stcPtpInit.u32SnapFrameType = (PTP_TRANSPORT_L2 == pstcConfig->u8Transport) ?
+                                  ETH_PTP_FRAME_TYPE_ETH_FRAME : ETH_PTP_FRAME_TYPE_IPV4_FRAME;
+    stcPtpInit.u32DatagramVersion = ETH_PTP_DATAGRAM_VER_IEEE1588V2;
+    stcPtpInit.u32SubsecScale = ETH_PTP_SUBSEC_SCALE_DEC;
+    stcPtpInit.u32CalibMode = ETH_PTP_CALIB_MD_FINE;
+    stcPtpInit.u32BasicAddend = m_u32AddendBase;
+    stcPtpInit.u8SubsecAddend = m_u8Inc;
+    i32Ret = ETH_PTP_Init(&stcPtpInit);
+
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    /* 组播默认完全过滤, 用地址寄存器 1 放行 PTP 组播 */
+    (void)ETH_MACADDR_StructInit(&stcMacAddr);
+    stcMacAddr.u32MacAddrFilter = ETH_MAC_ADDR_FILTER_PERFECT_DEST_ADDR;
+    (void)memcpy(stcMacAddr.au8MacAddr,
+                 (PTP_TRANSPORT_L2 == pstcConfig->u8Transport) ? m_au8L2Mcast : m_au8Ip4Mcast, 6U);
+    i32Ret = ETH_MACADDR_Init(ETH_MAC_ADDR_IDX1, &stcMacAddr);
+
+    if ((LL_OK == i32Ret) && (0U != pstcConfig->u8PpsEnable)) {
+        (void)ETH_PPS_StructInit(&stcPps);
+        stcPps.u32OutputMode = ETH_PPS_OUTPUT_MD_CONTINUE;
+        stcPps.u32OutputFreq = ETH_PPS_OUTPUT_FREQ_1HZ;
+        i32Ret = ETH_PPS_Init(ETH_PPS_CH0, &stcPps);
+    }
+
+    m_u8HaveParent = 0U;
+    m_fFreq = 0.0F;
+    m_fInteg = 0.0F;
+    PTP_ServoReset();
+
+    return i32Ret;
+}
+
+/**
+ * @brief  处理一帧, 在 ETHIF 接收回调里先调用
+ * @param  [in]  pstcBuf                接收缓冲区
+ * @retval int32_t:
+ *           - LL_OK: PTP 报文, 已处理并归还缓冲区
+ *           - LL_ERR: 不是 PTP 报文, 交给协议栈
+ */
+int32_t PTP_Input(stc_ethif_buf_t *pstcBuf) {
+    const uint8_t *pu8Msg;
+    uint32_t u32Len = 0UL;
+
+    pu8Msg = PTP_Locate(pstcBuf, &u32Len);
+
+    if (NULL == pu8Msg) {
+        return LL_ERR;
+    }
+
+    PTP_Handle(pu8Msg, u32Len, pstcBuf);
+    ETHIF_BufFree(pstcBuf);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Delay_Req 的发送时间戳, 作为 ETHIF 的 pfnTxTimestamp 登记
+ * @param  [in]  u32Sec                 秒
+ * @param  [in]  u32Subsec              ns
+ * @retval 无
+ */
+void PTP_TxTimestamp(uint32_t u32Sec, uint32_t u32Subsec) {
+    if (0U == m_u8DelayReqPending) {
+        return;
+    }
+
+    m_i64T3 = ((int64_t)u32Sec * PTP_NS_PER_SEC) + (int64_t)u32Subsec;
+    m_u8T3Valid = 1U;
+    PTP_DelayDone();
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] pstcStats              统计
+ * @retval 无
+ */
+void PTP_GetStats(stc_ptp_stats_t *pstcStats) {
+    *pstcStats = m_stcStats;
+}
@@ -0,0 +1,115 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : ptp_slave.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : IEEE 1588v2 从时钟
+                   只做从时钟(E2E 延迟测量, 一步/两步主时钟均可), 不跑 BMCA: 跟随本域内第一个
+                   听到 Sync 的主时钟, 该主时钟静默 PTP_PARENT_TIMEOUT 秒后才换到其他主时钟.
+                   时间戳全部由 MAC 硬件打: Sync 的接收时间戳取自接收描述符, Delay_Req 的发送
+                   时间戳经 ETHIF 的发送时间戳回调送回. 偏差超过 u32StepNs 时直接阶跃系统时间,
+                   否则由 PI 伺服调整 PTP 加数寄存器(精调模式)修正频率.
+                   PPS0 可输出与 PTP 秒对齐的 1Hz 脉冲, 用示波器对比各节点即可验证同步精度.
+                   伺服参数可先用 Tools/ptp_servo_sim.py 离线调整, pfnSample 输出的记录也可以直接回放.
+                   用法: ETHIF_Init(pfnTxTimestamp = PTP_TxTimestamp) -> PTP_Init -> ETHIF_Start,
+                   接收回调里先调用 PTP_Input, 返回 LL_OK 表示帧已被消费.
+  * Function List:
+                   PTP_Init
+                   PTP_Input
+                   PTP_TxTimestamp
+                   PTP_GetStats
+  ******************************************************
+**/
+
+#ifndef __PTP_SLAVE_H_
+#define __PTP_SLAVE_H_
+
+#include "hc32_ll.h"
+#include "eth_netif.h"
+
+#define PTP_PARENT_TIMEOUT          (4U)        /*!< 主时钟静默多少秒后可换主 */
+#define PTP_LOCK_NS                 (1000U)     /*!< 偏差小于此值算作锁定的样本 */
+#define PTP_LOCK_COUNT              (8U)        /*!< 连续这么多个锁定样本后 u8Locked 置 1 */
+#define PTP_DELAY_FILTER            (8)         /*!< 路径延迟一阶滤波系数, 新样本权重 1/PTP_DELAY_FILTER */
+
+/**
+ * @defgroup PTP_Transport 传输方式
+ */
+#define PTP_TRANSPORT_L2            (0U)        /*!< 以太网帧, 类型 0x88F7 */
+#define PTP_TRANSPORT_UDP4          (1U)        /*!< UDP/IPv4, 224.0.1.129:319/320 */
+
+/**
+ * @defgroup PTP_Servo_State 伺服状态
+ */
+#define PTP_SERVO_UNLOCKED          (0U)        /*!< 等第一个样本 */
+#define PTP_SERVO_FREQ_EST          (1U)        /*!< 用前两个样本估计频偏 */
+#define PTP_SERVO_TRACKING          (2U)        /*!< PI 跟踪 */
+
+/**
+ * @brief 一个伺服样本, 时间单位 ns
+ * 回放时 Tools/ptp_servo_sim.py 需要除 u8State 以外的六项.
+ */
+typedef struct {
+    int64_t i64T1;                  /*!< Sync 发出时刻(主时钟), 已加 correctionField */
+    int64_t i64T2;                  /*!< Sync 收到时刻(本地) */
+    int64_t i64Offset;              /*!< 本地 - 主时钟 */
+    int64_t i64Step;                /*!< 本样本后从本地时间减去的量, 未阶跃为 0 */
+    int32_t i32Delay;               /*!< 平均路径延迟 */
+    int32_t i32FreqPpb;             /*!< 本样本后的频率调整 */
+    uint8_t u8State;                /*!< @ref PTP_Servo_State, 本样本处理前的状态 */
+} stc_ptp_sample_t;
+
+/**
+ * @brief 样本回调, 在 ETHIF_Poll 的调用者上下文中执行
+ */
+typedef void (*func_ptp_sample_t)(const stc_ptp_sample_t *pstcSample);
+
+/**
+ * @brief 初始化参数
+ */
+typedef struct {
+    uint8_t au8MacAddr[6];          /*!< 与 ETHIF 相同, 时钟 ID 由它生成 */
+    uint8_t u8Transport;            /*!< @ref PTP_Transport */
+    uint8_t u8Domain;
+    uint32_t u32IpAddr;             /*!< UDP4 时本机 IPv4 地址, 如 192.168.1.10 为 0xC0A8010AUL */
+    uint8_t u8DelayReqRate;         /*!< 每几个 Sync 发一次 Delay_Req, >= 1 */
+    uint8_t u8PpsEnable;            /*!< 1: PPS0 输出 1Hz, 引脚复用由调用者配置 */
+    uint32_t u32StepNs;             /*!< 偏差超过此值时阶跃系统时间 */
+    uint32_t u32MaxPpb;             /*!< 频率调整上限 */
+    float fKp;                      /*!< 比例系数, ppb/ns, 按 1s 样本间隔, 其他间隔按实际间隔换算 */
+    float fKi;                      /*!< 积分系数, ppb/ns, 每个 Sync 样本累加一次, 换算同 fKp */
+    func_ptp_sample_t pfnSample;    /*!< 每个伺服样本回调一次, 可为 NULL */
+} stc_ptp_config_t;
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t u32SyncRx;
+    uint32_t u32FollowUpRx;
+    uint32_t u32DelayReqTx;
+    uint32_t u32DelayRespRx;
+    uint32_t u32NoTimestamp;        /*!< 收到 Sync 但描述符里没有时间戳 */
+    uint32_t u32TxFail;             /*!< Delay_Req 发不出去 */
+    uint32_t u32Steps;
+    uint32_t u32ParentChanges;
+    int64_t i64LastOffset;
+    int32_t i32Delay;
+    int32_t i32FreqPpb;
+    uint8_t u8State;                /*!< @ref PTP_Servo_State */
+    uint8_t u8Locked;
+} stc_ptp_stats_t;
+
+int32_t PTP_Init(const stc_ptp_config_t *pstcConfig);
+int32_t PTP_Input(stc_ethif_buf_t *pstcBuf);
+void PTP_TxTimestamp(uint32_t u32Sec, uint32_t u32Subsec);
+void PTP_GetStats(stc_ptp_stats_t *pstcStats);
+
+#endif
@@ -0,0 +1,206 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : reg_trace.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 寄存器访问跟踪
+                   1. 只在定义 LL_REG_TRACE 的构建中编译, 该构建下所有 DDL 寄存器宏调用本文件的
+                      REGTRACE_Read/REGTRACE_Write, 时序与正常构建不同, 只用于统计访问次数和顺序;
+                   2. 记录表写满后不再覆盖, 保证每次调用的序列完整, 丢弃数在输出首行给出;
+                   3. 输出格式(每行一条):
+                          # regtrace <条数> <丢弃数>
+                          @ <标记>
+                          <R|W><宽度> <地址> <值> <函数>
+                      地址、值和首行的计数均为 8 位十六进制;
+                   4. Dump 期间暂停记录, 输出函数本身访问的寄存器(如串口)不会混入记录;
+                   5. Tools/regtrace_test.py 在主机上编译本文件和部分 DDL 驱动, 寄存器访问接到
+                      寄存器表, 并与参考记录 Tools/regtrace_ref.txt 对比.
+  * Function List:
+
+  **********************************************************
+ */
+#include "reg_trace.h"
+
+#ifdef LL_REG_TRACE
+
+#define REGTRACE_LINE_MAX           (96U)
+
+static stc_regtrace_rec_t m_astcRec[REGTRACE_DEPTH];
+static uint32_t m_u32Num;
+static uint32_t m_u32Lost;
+static uint8_t m_u8Run;
+
+static void REGTRACE_Add(uint32_t u32Addr, uint32_t u32Val, const char *pcFunc, uint8_t u8Op) {
+    uint32_t u32Primask;
+
+    if (0U == m_u8Run) {
+        return;
+    }
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (m_u32Num < REGTRACE_DEPTH) {
+        m_astcRec[m_u32Num].u32Addr = u32Addr;
+        m_astcRec[m_u32Num].u32Val = u32Val;
+        m_astcRec[m_u32Num].pcFunc = pcFunc;
+        m_astcRec[m_u32Num].u8Op = u8Op;
+        m_u32Num++;
+    } else {
+        m_u32Lost++;
+    }
+
+    __set_PRIMASK(u32Primask);
+}
+
+static char *REGTRACE_Hex(char *pcOut, uint32_t u32Val) {
+    static const char acHex[16] = "0123456789ABCDEF";
+    int32_t i;
+
+    for (i = 7; i >= 0; i--) {
+        pcOut[i] = acHex[u32Val & 0xFUL];
+        u32Val >>= 4U;
+    }
+
+    return pcOut + 8;
+}
+
+static char *REGTRACE_Str(char *pcOut, const char *pcEnd, const char *pcStr) {
+    while ((pcOut < pcEnd) && ('\0' != *pcStr)) {
+        *pcOut++ = *pcStr++;
+    }
+
+    return pcOut;
+}
+
+/**
+ * @brief  寄存器读, 由 READ_REG 等宏调用
+ * @param  [in]  pvAddr                 寄存器地址
+ * @param  [in]  u32Size                宽度 1/2/4
+ * @param  [in]  pcFunc                 调用者 __func__
+ * @retval 读到的值
+ */
+uint32_t REGTRACE_Read(const volatile void *pvAddr, uint32_t u32Size, const char *pcFunc) {
+    uint32_t u32Val;
+
+    if (1UL == u32Size) {
+        u32Val = *(const volatile uint8_t *)pvAddr;
+    } else if (2UL == u32Size) {
+        u32Val = *(const volatile uint16_t *)pvAddr;
+    } else {
+        u32Val = *(const volatile uint32_t *)pvAddr;
+    }
+
+    REGTRACE_Add((uint32_t)pvAddr, u32Val, pcFunc, (uint8_t)(REGTRACE_OP_READ | u32Size));
+
+    return u32Val;
+}
+
+/**
+ * @brief  寄存器写, 由 WRITE_REG 等宏调用
+ * @param  [in]  pvAddr                 寄存器地址
+ * @param  [in]  u32Size                宽度 1/2/4
+ * @param  [in]  u32Val                 写入值
+ * @param  [in]  pcFunc                 调用者 __func__
+ * @retval 写入的值, SET_REG_BIT 等宏也作表达式使用
+ */
+uint32_t REGTRACE_Write(volatile void *pvAddr, uint32_t u32Size, uint32_t u32Val, const char *pcFunc) {
+    if (1UL == u32Size) {
+        *(volatile uint8_t *)pvAddr = (uint8_t)u32Val;
+        u32Val &= 0xFFUL;
+    } else if (2UL == u32Size) {
+        *(volatile uint16_t *)pvAddr = (uint16_t)u32Val;
+        u32Val &= 0xFFFFUL;
+    } else {
+        *(volatile uint32_t *)pvAddr = u32Val;
+    }
+
+    REGTRACE_Add((uint32_t)pvAddr, u32Val, pcFunc, (uint8_t)(REGTRACE_OP_WRITE | u32Size));
+
+    return u32Val;
+}
+
+/**
+ * @brief  清空记录并开始记录
+ * @param  无
+ * @retval 无
+ */
+void REGTRACE_Start(void) {
+    m_u8Run = 0U;
+    m_u32Num = 0UL;
+    m_u32Lost = 0UL;
+    m_u8Run = 1U;
+}
+
+/**
+ * @brief  停止记录, 已有记录保留
+ * @param  无
+ * @retval 无
+ */
+void REGTRACE_Stop(void) {
+    m_u8Run = 0U;
+}
+
+/**
+ * @brief  插入调用边界
+ * @param  [in]  pcTag                  标记名, 须为常量字符串, 对比时按标记名配对
+ * @retval 无
+ */
+void REGTRACE_Mark(const char *pcTag) {
+    REGTRACE_Add(0UL, 0UL, pcTag, REGTRACE_OP_MARK);
+}
+
+/**
+ * @brief  按行输出全部记录
+ * @param  [in]  pfnOut                 输出函数, 如串口发送一行并换行
+ * @retval 无
+ */
+void REGTRACE_Dump(func_regtrace_out_t pfnOut) {
+    char acLine[REGTRACE_LINE_MAX];
+    const char *pcEnd = &acLine[REGTRACE_LINE_MAX - 1U];
+    const stc_regtrace_rec_t *pstcRec;
+    uint8_t u8Run = m_u8Run;
+    char *pcPos;
+    uint32_t i;
+
+    m_u8Run = 0U;
+
+    pcPos = REGTRACE_Str(acLine, pcEnd, "# regtrace ");
+    pcPos = REGTRACE_Hex(pcPos, m_u32Num);
+    *pcPos++ = ' ';
+    pcPos = REGTRACE_Hex(pcPos, m_u32Lost);
+    *pcPos = '\0';
+    pfnOut(acLine);
+
+    for (i = 0UL; i < m_u32Num; i++) {
+        pstcRec = &m_astcRec[i];
+
+        if (REGTRACE_OP_MARK == pstcRec->u8Op) {
+            pcPos = REGTRACE_Str(acLine, pcEnd, "@ ");
+        } else {
+            acLine[0] = (0U != (pstcRec->u8Op & REGTRACE_OP_WRITE)) ? 'W' : 'R';
+            acLine[1] = (char)('0' + (pstcRec->u8Op & REGTRACE_OP_SIZE));
+            acLine[2] = ' ';
+            pcPos = REGTRACE_Hex(&acLine[3], pstcRec->u32Addr);
+            *pcPos++ = ' ';
+            pcPos = REGTRACE_Hex(pcPos, pstcRec->u32Val);
+            *pcPos++ = ' ';
+        }
+
+        pcPos = REGTRACE_Str(pcPos, pcEnd, pstcRec->pcFunc);
+        *pcPos = '\0';
+        pfnOut(acLine);
+    }
+
+    m_u8Run = u8Run;
+}
+
+#endif /* LL_REG_TRACE */
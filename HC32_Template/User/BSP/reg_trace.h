@@ -0,0 +1,70 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : reg_trace.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 寄存器访问跟踪
+                   全局定义 LL_REG_TRACE 编译时, hc32_ll_def.h 中的 READ_REG/WRITE_REG/MODIFY_REG/
+                   SET_REG_BIT 等宏都经 REGTRACE_Read/REGTRACE_Write 访问寄存器, 每次访问记录地址、
+                   宽度、值和发起访问的函数名. REGTRACE_Mark 在记录中插入一个调用边界,
+                   REGTRACE_Dump 按行输出文本, 在 PC 上用 Tools/regtrace.py 统计和对比两份记录.
+                   未定义 LL_REG_TRACE 时下列接口均为空宏, 调用处不用改动.
+                   直接用 CMx->REG 或位带别名访问的寄存器不经过这些宏, 不会被记录.
+  * Function List:
+                   REGTRACE_Start
+                   REGTRACE_Stop
+                   REGTRACE_Mark
+                   REGTRACE_Dump
+  ******************************************************
+**/
+
+#ifndef __REG_TRACE_H_
+#define __REG_TRACE_H_
+
+#include "hc32_ll.h"
+
+#define REGTRACE_DEPTH              (1024U)     /*!< 记录条数, 每条 16 字节, 满后丢弃新记录并计数 */
+
+/**
+ * @defgroup REGTRACE_Op 记录类型
+ */
+#define REGTRACE_OP_READ            (0x00U)
+#define REGTRACE_OP_WRITE           (0x80U)
+#define REGTRACE_OP_MARK            (0x40U)     /*!< 调用边界, pcFunc 为标记名 */
+#define REGTRACE_OP_SIZE            (0x07U)     /*!< 低 3 位为访问宽度(字节) */
+
+/**
+ * @brief 一条记录
+ */
+typedef struct {
+    uint32_t u32Addr;
+    uint32_t u32Val;
+    const char *pcFunc;             /*!< 发起访问的驱动函数(__func__) */
+    uint8_t u8Op;                   /*!< @ref REGTRACE_Op */
+} stc_regtrace_rec_t;
+
+/**
+ * @brief 按行输出, 每行不含换行符
+ */
+typedef void (*func_regtrace_out_t)(const char *pcLine);
+
+#ifdef LL_REG_TRACE
+void REGTRACE_Start(void);
+void REGTRACE_Stop(void);
+void REGTRACE_Mark(const char *pcTag);
+void REGTRACE_Dump(func_regtrace_out_t pfnOut);
+#else
+#define REGTRACE_Start()            ((void)0)
+#define REGTRACE_Stop()             ((void)0)
+#define REGTRACE_Mark(tag)          ((void)(tag))
+#define REGTRACE_Dump(out)          ((void)(out))
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TRNG 接到 Common/rng_pool 的随机数池
+                   1. TRNG_Start 启动一次转换, TRNG_END 中断里 TRNG_GetRandom 取出两个字交给 Rng_Feed,
+                      池未满就再启动一次;
+                   2. 池满或判定故障时不再启动, 记为空闲; 消费侧取数后经 Resume 重新启动.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rng_hw.h"
+
+static Rng_Pool m_stcPool;
+static volatile uint8_t m_u8Running = 0U;
+
+static uint32_t Rng_Lock(void) {
+    uint32_t u32Primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return u32Primask;
+}
+
+static void Rng_Unlock(uint32_t u32State) {
+    __set_PRIMASK(u32State);
+}
+
+/* 关中断时调用, TRNG 空闲时才启动, 转换中不重复启动 */
+static void Rng_Resume(void) {
+    if (0U == m_u8Running) {
+        m_u8Running = 1U;
+        TRNG_Start();
+    }
+}
+
+static void Rng_Halt(void) {
+    m_u8Running = 0U;
+    CLR_REG32_BIT(CM_TRNG->CR, TRNG_CR_RUN | TRNG_CR_EN);
+}
+
+static const Rng_Port m_stcPort = {&Rng_Lock, &Rng_Unlock, &Rng_Resume, &Rng_Halt};
+
+/**
+ * @brief  TRNG 转换结束中断, 由 Rng_Init 登记到 RNG_IRQn
+ * @param  无
+ * @retval 无
+ * @note   池满时第二个字被丢弃, 不影响随机性.
+ */
+void Rng_IRQHandler(void) {
+    uint32_t au32Data[2U];
+
+    (void)TRNG_GetRandom(au32Data, 2U);
+
+    if ((0U != Rng_Feed(au32Data[0U])) || (0U != Rng_Feed(au32Data[1U]))) {
+        m_u8Running = 0U;
+    } else {
+        TRNG_Start();
+    }
+}
+
+/**
+ * @brief  启动 TRNG, 登记转换结束中断, 等待启动检测完成并取得第一个种子
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK:                   已取得第一个种子
+ *           - LL_ERR_BUSY:             RNG_IRQn 已被其他代码占用
+ *           - LL_ERR:                  硬件反复检测失败或超时
+ * @note   Rng_IRQHandler 在这里用 INTC_IrqSignIn 登记, 不需要在中断向量中调用.
+ */
+int32_t Rng_Init(void) {
+    stc_irq_signin_config_t stcIrq;
+
+    Rng_PoolInit(&m_stcPool, &m_stcPort);
+    m_u8Running = 0U;
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_TRNG, ENABLE);
+    TRNG_Init(TRNG_SHIFT_CNT64, TRNG_RELOAD_INIT_VAL_ENABLE);
+
+    stcIrq.enIntSrc = RNG_INT_SRC;
+    stcIrq.enIRQn = RNG_IRQn;
+    stcIrq.pfnCallback = &Rng_IRQHandler;
+    if (LL_OK != INTC_IrqSignIn(&stcIrq)) {
+        return LL_ERR_BUSY;
+    }
+
+    NVIC_ClearPendingIRQ(RNG_IRQn);
+    NVIC_SetPriority(RNG_IRQn, RNG_IRQ_PRIO);
+    NVIC_EnableIRQ(RNG_IRQn);
+
+    Rng_Resume();
+
+    return (RNG_OK == Rng_PoolStart(SystemCoreClock / 100UL)) ? LL_OK : LL_ERR;
+}
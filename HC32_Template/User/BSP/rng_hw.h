@@ -0,0 +1,38 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : TRNG 接到 Common/rng_pool 的随机数池
+                   接口与 STM32/GD32 模板的 rng_hw.h 相同, 池、健康检测和 ChaCha20 在
+                   Common/rng_pool.c, 这里只管 TRNG 时钟、中断和取数;
+                   Rng_Fill / Rng_Raw / Rng_Available / Rng_TlsCallback / Rng_GetStats 见 rng_pool.h.
+                   HC32 的 TRNG 每启动一次产生 64 位, 结束时发 TRNG_END 中断, 没有种子/时钟错误标志,
+                   只靠 Common 中的 RCT/APT 检测, Rng_Stats.SeedErrors / ClockErrors 始终为 0.
+  * Function List:
+                   Rng_Init
+                   Rng_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __RNG_HW_H_
+#define __RNG_HW_H_
+
+#include "hc32_ll.h"
+#include "rng_pool.h"
+
+#define RNG_INT_SRC                 (INT_SRC_TRNG_END)
+#define RNG_IRQn                    (INT024_IRQn)       /*!< INT000~031 可登记任意中断源 */
+#define RNG_IRQ_PRIO                (DDL_IRQ_PRIO_06)   /*!< 后台补充, 优先级放低 */
+
+int32_t Rng_Init(void);
+void Rng_IRQHandler(void);
+
+#endif
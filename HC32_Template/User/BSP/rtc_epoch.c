@@ -0,0 +1,469 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rtc_epoch.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RTC 单调时间与事件时间戳
+                   1. 秒中断一进入就读自由计数器, 再进入读写模式读一次日历(BCD), 查表换成秒计数,
+                      两者作为一对锁存; 日历的读写模式握手和 BCD 转换每秒只做一次;
+                   2. 外推: 秒内 us = (计数器 - 锁存值) * 倍率 >> 31, 倍率 = 10^6 * 2^31 / 每秒计数,
+                      只在锁存时更新; 每秒计数先取标称值, 之后取相邻两次秒中断之间的实测值,
+                      偏离标称值 1/64 以上的不用(中断被挡住), 这样外推自动对齐到 RTC 晶振;
+                   3. 读锁存值和计数器在关中断下进行, 保证是同一对; 秒中断未及时执行时截断到 999999,
+                      不会越过下一秒;
+                   4. 锁存的秒对应秒中断进入的时刻, 整体比 RTC 进位晚一个中断时延, 所以中断优先级宜取最高;
+                   5. 事件: 时间戳寄存器只有月日时分秒, 年份取当前年, 得到的时刻比当前晚 1 秒以上
+                      (或当前年没有这一天, 如 2 月 29 日)时退一年; 两个通道共用一组时间戳寄存器,
+                      同时触发时记在同一个事件里, 未读走又被覆盖时硬件置溢出标志, 计入丢失.
+                   使用前需解除 INTC 寄存器写保护.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rtc_epoch.h"
+#include "string.h"
+
+#define RTCE_US_PER_SEC             (1000000UL)
+#define RTCE_US_MAX                 (RTCE_US_PER_SEC - 1UL)
+#define RTCE_MULT_SHIFT             (31U)
+#define RTCE_CALIB_TOL_SHIFT        (6U)        /* 实测每秒计数允许偏离标称值 1/64 */
+#define RTCE_COUNTER_HZ_MIN         (1000000UL) /* 低于 1MHz 时倍率超出 32 位 */
+
+static stc_rtce_config_t m_stcCfg;
+static uint32_t m_u32CounterHz;
+static stc_rtce_stats_t m_stcStats;
+static uint8_t m_u8Ready = 0U;
+
+/* 秒中断锁存, 读时关中断 */
+static volatile uint32_t m_u32Sec;
+static volatile uint32_t m_u32Base;         /* 锁存时的自由计数器 */
+static volatile uint32_t m_u32TicksPerSec;
+static volatile uint32_t m_u32UsMult;
+static uint8_t m_u8Year;                    /* 十进制, 给事件补年份 */
+static uint8_t m_u8Calib;                   /* 0: 下一次锁存不参与测频(刚初始化或重新同步) */
+
+/* 事件队列, 中断写 m_u8EventIn, 主循环写 m_u8EventOut */
+static stc_rtce_event_t m_astcEvent[RTCE_EVENT_NUM];
+static volatile uint8_t m_u8EventIn;
+static volatile uint8_t m_u8EventOut;
+
+static uint32_t RTCE_Counter(void) {
+    return (NULL != m_stcCfg.pfnCounter) ? m_stcCfg.pfnCounter() : DWT->CYCCNT;
+}
+
+static void RTCE_SetRate(uint32_t u32TicksPerSec) {
+    m_u32TicksPerSec = u32TicksPerSec;
+    m_u32UsMult = (uint32_t)(((uint64_t)RTCE_US_PER_SEC << RTCE_MULT_SHIFT) / u32TicksPerSec);
+}
+
+/* 调用方已关中断 */
+static uint32_t RTCE_SubUs(uint32_t u32Cnt) {
+    uint32_t u32Delta = u32Cnt - m_u32Base;
+
+    if (u32Delta >= m_u32TicksPerSec) {
+        m_stcStats.u32Clamp++;
+        return RTCE_US_MAX;
+    }
+
+    return (uint32_t)(((uint64_t)u32Delta * m_u32UsMult) >> RTCE_MULT_SHIFT);
+}
+
+/* 一次读写模式读出全部日历寄存器 */
+static int32_t RTCE_ReadRtc(uint32_t *pu32Sec, uint8_t *pu8Year) {
+    Cal_DateTime stcDt;
+    int32_t i32Ret = LL_OK;
+
+    if (LL_OK != RTC_EnterRwMode()) {
+        i32Ret = LL_ERR_TIMEOUT;
+    } else {
+        stcDt.Year   = READ_REG8(CM_RTC->YEAR);
+        stcDt.Month  = READ_REG8(CM_RTC->MON);
+        stcDt.Day    = READ_REG8(CM_RTC->DAY);
+        stcDt.Hour   = READ_REG8(CM_RTC->HOUR);
+        stcDt.Minute = READ_REG8(CM_RTC->MIN);
+        stcDt.Second = READ_REG8(CM_RTC->SEC);
+    }
+
+    if (LL_OK != RTC_ExitRwMode()) {
+        i32Ret = LL_ERR_TIMEOUT;
+    }
+
+    if (LL_OK == i32Ret) {
+        *pu32Sec = Cal_ToEpoch(CAL_FMT_BCD, &stcDt);
+        *pu8Year = Cal_Bcd2Dec(stcDt.Year);
+
+        if (CAL_EPOCH_INVD == *pu32Sec) {
+            i32Ret = LL_ERR;
+        }
+    }
+
+    return i32Ret;
+}
+
+static void RTCE_PrdIrqHandler(void) {
+    uint32_t u32Cnt = RTCE_Counter();
+    uint32_t u32Sec;
+    uint32_t u32Ticks;
+    uint32_t u32Tol;
+    uint8_t u8Year;
+
+    RTC_ClearStatus(RTC_FLAG_PERIOD);
+
+    if (LL_OK != RTCE_ReadRtc(&u32Sec, &u8Year)) {
+        m_stcStats.u32ReadFail++;
+        return;
+    }
+
+    if (u32Sec == m_u32Sec + 1UL) {
+        u32Ticks = u32Cnt - m_u32Base;
+        u32Tol = m_u32CounterHz >> RTCE_CALIB_TOL_SHIFT;
+
+        if ((0U != m_u8Calib) && (u32Ticks > m_u32CounterHz - u32Tol) && (u32Ticks < m_u32CounterHz + u32Tol)) {
+            RTCE_SetRate(u32Ticks);
+        }
+    } else if (u32Sec != m_u32Sec) {
+        m_stcStats.u32Skip++;
+    } else {
+        /* 同一秒内重复进入, 保留原锁存, 秒内时间不回退 */
+        return;
+    }
+
+    m_u32Sec = u32Sec;
+    m_u32Base = u32Cnt;
+    m_u8Year = u8Year;
+    m_u8Calib = 1U;
+    m_stcStats.u32Sync++;
+}
+
+static void RTCE_TpIrqHandler(void) {
+    uint32_t u32Cnt = RTCE_Counter();
+    Cal_DateTime stcDt;
+    stc_rtce_event_t *pstcEvent;
+    uint32_t u32Sec;
+    uint8_t u8Ch = 0U;
+
+    if (SET == RTC_GetStatus(RTC_FLAG_INTRU_CH0)) {
+        u8Ch |= RTCE_EVENT_CH0;
+    }
+
+    if (SET == RTC_GetStatus(RTC_FLAG_INTRU_CH1)) {
+        u8Ch |= RTCE_EVENT_CH1;
+    }
+
+    if (SET == RTC_GetStatus(RTC_FLAG_INTRU_OVF)) {
+        m_stcStats.u32EventLost++;
+    }
+
+    stcDt.Month  = Cal_Bcd2Dec(READ_REG8(CM_RTC->MONTP));
+    stcDt.Day    = Cal_Bcd2Dec(READ_REG8(CM_RTC->DAYTP));
+    stcDt.Hour   = Cal_Bcd2Dec(READ_REG8(CM_RTC->HOURTP));
+    stcDt.Minute = Cal_Bcd2Dec(READ_REG8(CM_RTC->MINTP));
+    stcDt.Second = Cal_Bcd2Dec(READ_REG8(CM_RTC->SECTP));
+    RTC_ClearStatus(RTC_FLAG_INTRU_OVF | RTC_FLAG_INTRU_CH0 | RTC_FLAG_INTRU_CH1);
+
+    if (0U == u8Ch) {
+        return;
+    }
+
+    stcDt.Year = m_u8Year;
+    u32Sec = Cal_ToEpoch(CAL_FMT_DEC, &stcDt);
+
+    if (((CAL_EPOCH_INVD == u32Sec) || (u32Sec > m_u32Sec + 1UL)) && (0U != m_u8Year)) {
+        stcDt.Year = m_u8Year - 1U;
+        u32Sec = Cal_ToEpoch(CAL_FMT_DEC, &stcDt);
+    }
+
+    if ((CAL_EPOCH_INVD == u32Sec) || ((uint8_t)(m_u8EventIn - m_u8EventOut) >= RTCE_EVENT_NUM)) {
+        m_stcStats.u32EventLost++;
+        return;
+    }
+
+    pstcEvent = &m_astcEvent[m_u8EventIn & (RTCE_EVENT_NUM - 1U)];
+    pstcEvent->u32Sec = u32Sec;
+    pstcEvent->u32SubUs = (u32Sec == m_u32Sec) ? RTCE_SubUs(u32Cnt) : RTCE_SUBUS_INVD;
+    pstcEvent->u8Ch = u8Ch;
+    m_u8EventIn++;
+}
+
+/**
+ * @brief  读一次 RTC 作为起点, 打开秒中断
+ * @param  [in]  pstcConfig             配置
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       参数错误, 或自由计数器低于 1MHz
+ *           - LL_ERR_NOT_RDY:          RTC 未启动
+ *           - LL_ERR_INVD_MD:          RTC 为 12 小时制
+ *           - LL_ERR_TIMEOUT:          进入 RTC 读写模式超时
+ *           - LL_ERR:                  RTC 日历非法
+ *           - LL_ERR_UNINIT:           中断号已登记其他中断源
+ * @note   使用默认的 DWT 计数时, 修改系统时钟后需重新调用. 调用后第一秒的秒内值从 0 起算, 偏小.
+ */
+int32_t RTCE_Init(const stc_rtce_config_t *pstcConfig) {
+    stc_irq_signin_config_t stcIrq;
+    uint32_t u32Sec;
+    uint8_t u8Year;
+    int32_t i32Ret;
+
+    if (NULL == pstcConfig) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (DISABLE == RTC_GetCounterState()) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    if (0UL == READ_REG32(bCM_RTC->CR1_b.AMPM)) {
+        return LL_ERR_INVD_MD;
+    }
+
+    m_u8Ready = 0U;
+    RTC_IntCmd(RTC_INT_PERIOD, DISABLE);
+
+    m_stcCfg = *pstcConfig;
+    m_u32CounterHz = (0UL != m_stcCfg.u32CounterHz) ? m_stcCfg.u32CounterHz : SystemCoreClock;
+
+    if (m_u32CounterHz < RTCE_COUNTER_HZ_MIN) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (NULL == m_stcCfg.pfnCounter) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+    RTCE_SetRate(m_u32CounterHz);
+
+    RTC_SetIntPeriod(RTC_INT_PERIOD_PER_SEC);
+
+    i32Ret = RTCE_ReadRtc(&u32Sec, &u8Year);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    m_u32Base = RTCE_Counter();
+    m_u32Sec = u32Sec;
+    m_u8Year = u8Year;
+    m_u8Calib = 0U;
+    RTC_ClearStatus(RTC_FLAG_PERIOD);
+
+    stcIrq.enIntSrc = INT_SRC_RTC_PRD;
+    stcIrq.enIRQn = m_stcCfg.enIRQn;
+    stcIrq.pfnCallback = &RTCE_PrdIrqHandler;
+    i32Ret = INTC_IrqSignIn(&stcIrq);
+
+    if (LL_OK == i32Ret) {
+        NVIC_ClearPendingIRQ(m_stcCfg.enIRQn);
+        NVIC_SetPriority(m_stcCfg.enIRQn, m_stcCfg.u32IrqPrio);
+        NVIC_EnableIRQ(m_stcCfg.enIRQn);
+        RTC_IntCmd(RTC_INT_PERIOD, ENABLE);
+        m_u8Ready = 1U;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  RTC 被改写后重新读一次日历
+ * @param  无
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_UNINIT:           未初始化
+ *           - LL_ERR_TIMEOUT:          进入 RTC 读写模式超时
+ *           - LL_ERR:                  RTC 日历非法
+ * @note   秒数不变时保留原锁存; 改变时从调用时刻起算, 时间可能后退.
+ */
+int32_t RTCE_Resync(void) {
+    uint32_t u32Sec;
+    uint32_t u32Primask;
+    uint8_t u8Year;
+    int32_t i32Ret;
+
+    if (0U == m_u8Ready) {
+        return LL_ERR_UNINIT;
+    }
+
+    NVIC_DisableIRQ(m_stcCfg.enIRQn);
+
+    i32Ret = RTCE_ReadRtc(&u32Sec, &u8Year);
+
+    if ((LL_OK == i32Ret) && (u32Sec != m_u32Sec)) {
+        u32Primask = __get_PRIMASK();
+        __disable_irq();
+        m_u32Base = RTCE_Counter();
+        m_u32Sec = u32Sec;
+        m_u8Year = u8Year;
+        m_u8Calib = 0U;
+        __set_PRIMASK(u32Primask);
+    }
+
+    NVIC_EnableIRQ(m_stcCfg.enIRQn);
+
+    return i32Ret;
+}
+
+/**
+ * @brief  当前秒计数
+ * @param  无
+ * @retval uint32_t:                    2000-01-01 00:00:00 起的秒数, 最近一次秒中断锁存的值
+ */
+uint32_t RTCE_GetSec(void) {
+    return m_u32Sec;
+}
+
+/**
+ * @brief  当前时刻, 秒 + 秒内 us
+ * @param  [out] pstcTime               时刻
+ * @retval 无
+ * @note   可在中断中调用; 未初始化时为 0.
+ */
+void RTCE_GetTime(stc_rtce_time_t *pstcTime) {
+    uint32_t u32Primask;
+
+    if (NULL == pstcTime) {
+        return;
+    }
+
+    if (0U == m_u8Ready) {
+        pstcTime->u32Sec = 0UL;
+        pstcTime->u32Us = 0UL;
+        return;
+    }
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+    pstcTime->u32Us = RTCE_SubUs(RTCE_Counter());
+    pstcTime->u32Sec = m_u32Sec;
+    __set_PRIMASK(u32Primask);
+}
+
+/**
+ * @brief  当前时刻, us
+ * @param  无
+ * @retval uint64_t:                    2000-01-01 00:00:00 起的 us, 单调不减(RTC 被改写时除外)
+ */
+uint64_t RTCE_GetUs(void) {
+    stc_rtce_time_t stcTime;
+
+    RTCE_GetTime(&stcTime);
+
+    return (uint64_t)stcTime.u32Sec * RTCE_US_PER_SEC + stcTime.u32Us;
+}
+
+/**
+ * @brief  配置入侵检测通道作为事件时间戳
+ * @param  [in]  pstcConfig             配置
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       参数错误
+ *           - LL_ERR_UNINIT:           未调用 RTCE_Init, 或中断号已登记其他中断源
+ * @note   通道引脚(RTCIC0/RTCIC1)需事先配置. 不复位备份寄存器.
+ */
+int32_t RTCE_EventInit(const stc_rtce_event_config_t *pstcConfig) {
+    stc_rtc_intrusion_t stcIntru;
+    stc_irq_signin_config_t stcIrq;
+    int32_t i32Ret;
+
+    if ((NULL == pstcConfig) || (0U == pstcConfig->u8Ch) ||
+            (0U != (pstcConfig->u8Ch & (uint8_t)~(RTCE_EVENT_CH0 | RTCE_EVENT_CH1)))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (0U == m_u8Ready) {
+        return LL_ERR_UNINIT;
+    }
+
+    RTC_IntCmd(RTC_INT_INTRU_CH0 | RTC_INT_INTRU_CH1, DISABLE);
+    RTC_INTRU_Cmd(RTC_INTRU_CH0, DISABLE);
+    RTC_INTRU_Cmd(RTC_INTRU_CH1, DISABLE);
+    m_u8EventIn = 0U;
+    m_u8EventOut = 0U;
+
+    (void)RTC_INTRU_StructInit(&stcIntru);
+    stcIntru.u8Timestamp = RTC_INTRU_TS_ENABLE;
+    stcIntru.u8Filter = pstcConfig->u8Filter;
+    stcIntru.u8TriggerEdge = pstcConfig->u8TriggerEdge;
+
+    if (0U != (pstcConfig->u8Ch & RTCE_EVENT_CH0)) {
+        (void)RTC_INTRU_Init(RTC_INTRU_CH0, &stcIntru);
+    }
+
+    if (0U != (pstcConfig->u8Ch & RTCE_EVENT_CH1)) {
+        (void)RTC_INTRU_Init(RTC_INTRU_CH1, &stcIntru);
+    }
+
+    RTC_ClearStatus(RTC_FLAG_INTRU_OVF | RTC_FLAG_INTRU_CH0 | RTC_FLAG_INTRU_CH1);
+
+    stcIrq.enIntSrc = INT_SRC_RTC_TP;
+    stcIrq.enIRQn = pstcConfig->enIRQn;
+    stcIrq.pfnCallback = &RTCE_TpIrqHandler;
+    i32Ret = INTC_IrqSignIn(&stcIrq);
+
+    if (LL_OK == i32Ret) {
+        NVIC_ClearPendingIRQ(pstcConfig->enIRQn);
+        NVIC_SetPriority(pstcConfig->enIRQn, pstcConfig->u32IrqPrio);
+        NVIC_EnableIRQ(pstcConfig->enIRQn);
+
+        if (0U != (pstcConfig->u8Ch & RTCE_EVENT_CH0)) {
+            RTC_IntCmd(RTC_INT_INTRU_CH0, ENABLE);
+            RTC_INTRU_Cmd(RTC_INTRU_CH0, ENABLE);
+        }
+
+        if (0U != (pstcConfig->u8Ch & RTCE_EVENT_CH1)) {
+            RTC_IntCmd(RTC_INT_INTRU_CH1, ENABLE);
+            RTC_INTRU_Cmd(RTC_INTRU_CH1, ENABLE);
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  取出一个事件
+ * @param  [out] pstcEvent              事件
+ * @retval int32_t:
+ *           - LL_OK:                   成功
+ *           - LL_ERR_INVD_PARAM:       pstcEvent 为 NULL
+ *           - LL_ERR_BUF_EMPTY:        没有事件
+ */
+int32_t RTCE_GetEvent(stc_rtce_event_t *pstcEvent) {
+    if (NULL == pstcEvent) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (m_u8EventIn == m_u8EventOut) {
+        return LL_ERR_BUF_EMPTY;
+    }
+
+    *pstcEvent = m_astcEvent[m_u8EventOut & (RTCE_EVENT_NUM - 1U)];
+    m_u8EventOut++;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  统计
+ * @param  [out] pstcStats              统计
+ * @retval 无
+ */
+void RTCE_GetStats(stc_rtce_stats_t *pstcStats) {
+    uint32_t u32Primask;
+
+    if (NULL == pstcStats) {
+        return;
+    }
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+    *pstcStats = m_stcStats;
+    pstcStats->u32TicksPerSec = m_u32TicksPerSec;
+    __set_PRIMASK(u32Primask);
+}
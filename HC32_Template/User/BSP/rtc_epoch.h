@@ -0,0 +1,92 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rtc_epoch.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RTC 单调时间与事件时间戳
+                   RTC 秒中断里读一次日历寄存器, 换成秒计数(calendar.h, 2000 年起), 同时锁存自由计数器;
+                   RTCE_GetTime/RTCE_GetUs 只读锁存值和自由计数器外推秒内 us, 不进入 RTC 读写模式,
+                   不做 BCD 转换和除法, 可在中断里大量调用. 外推结果在秒内截断到 999999,
+                   跨秒由秒中断推进, 所以单调不减.
+                   入侵检测的时间戳单元作为硬件事件时间戳: 引脚边沿由 RTC 锁存到秒,
+                   中断里补上年份和秒内上限, 放入队列.
+                   RTC 须已用 24 小时制初始化并启动; RTC_SetDate/RTC_SetTime 之后调用 RTCE_Resync.
+  * Function List:
+                   RTCE_Init
+                   RTCE_Resync
+                   RTCE_GetSec
+                   RTCE_GetTime
+                   RTCE_GetUs
+                   RTCE_EventInit
+                   RTCE_GetEvent
+                   RTCE_GetStats
+  ******************************************************
+**/
+
+#ifndef __RTC_EPOCH_H_
+#define __RTC_EPOCH_H_
+
+#include "hc32_ll.h"
+#include "calendar.h"
+
+#define RTCE_EVENT_NUM              (8U)            /*!< 事件队列长度, 2 的幂 */
+#define RTCE_SUBUS_INVD             (0xFFFFFFFFUL)
+
+/**
+ * @defgroup RTCE_Event_Channel 事件通道, 可组合
+ */
+#define RTCE_EVENT_CH0              (0x01U)         /*!< RTCIC0 */
+#define RTCE_EVENT_CH1              (0x02U)         /*!< RTCIC1 */
+
+typedef struct {
+    uint32_t u32Sec;                /*!< 2000-01-01 00:00:00 起的秒数 */
+    uint32_t u32Us;                 /*!< 秒内 us, 0~999999 */
+} stc_rtce_time_t;
+
+typedef struct {
+    uint32_t u32Sec;                /*!< 事件所在的秒, 由时间戳寄存器锁存 */
+    uint32_t u32SubUs;              /*!< 进入中断时的秒内 us, 是事件时刻的上限; 进入中断时已跨秒为 RTCE_SUBUS_INVD */
+    uint8_t u8Ch;                   /*!< 触发的通道 @ref RTCE_Event_Channel */
+} stc_rtce_event_t;
+
+typedef struct {
+    uint32_t u32Sync;               /*!< 秒中断次数 */
+    uint32_t u32Skip;               /*!< 两次秒中断之间 RTC 走了不止 1 秒, 中断被挡住过久 */
+    uint32_t u32ReadFail;           /*!< 进入读写模式超时或读到非法日历 */
+    uint32_t u32Clamp;              /*!< 外推到 1 秒以上被截断, 秒中断未及时执行 */
+    uint32_t u32TicksPerSec;        /*!< 实测自由计数器每秒计数, 用于外推 */
+    uint32_t u32EventLost;          /*!< 队列满或时间戳寄存器被覆盖 */
+} stc_rtce_stats_t;
+
+typedef struct {
+    IRQn_Type enIRQn;               /*!< 登记 INT_SRC_RTC_PRD */
+    uint32_t u32IrqPrio;            /*!< DDL_IRQ_PRIO_xx, 宜取最高: 锁存越及时外推越准 */
+    uint32_t u32CounterHz;          /*!< 自由计数器标称频率, 0 时取 SystemCoreClock */
+    uint32_t (*pfnCounter)(void);   /*!< 可为 NULL, 此时用 DWT 周期计数; 32 位向上计数, 回绕周期须大于 2 秒 */
+} stc_rtce_config_t;
+
+typedef struct {
+    IRQn_Type enIRQn;               /*!< 登记 INT_SRC_RTC_TP */
+    uint32_t u32IrqPrio;            /*!< DDL_IRQ_PRIO_xx */
+    uint8_t u8Ch;                   /*!< 使用的通道 @ref RTCE_Event_Channel */
+    uint8_t u8Filter;               /*!< RTC_INTRU_FILTER_xx */
+    uint8_t u8TriggerEdge;          /*!< RTC_INTRU_TRIG_EDGE_xx */
+} stc_rtce_event_config_t;
+
+int32_t RTCE_Init(const stc_rtce_config_t *pstcConfig);
+int32_t RTCE_Resync(void);
+uint32_t RTCE_GetSec(void);
+void RTCE_GetTime(stc_rtce_time_t *pstcTime);
+uint64_t RTCE_GetUs(void);
+int32_t RTCE_EventInit(const stc_rtce_event_config_t *pstcConfig);
+int32_t RTCE_GetEvent(stc_rtce_event_t *pstcEvent);
+void RTCE_GetStats(stc_rtce_stats_t *pstcStats);
+
+#endif
@@ -0,0 +1,215 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : EXMC_DMC 外部 SDRAM
+                   1. SDRAM 时钟就是 EXCLK, 由系统时钟配置决定, 这里不改分频; EXCLK 超过 MaxHz 时
+                      返回 SDRAM_ERR_CLOCK;
+                   2. 时序由 SDRAM_PlanTiming 换算; RCD/RP/RFC 分基本值和附加值两个字段, 附加值为
+                      基本值减 3; 超出寄存器范围时返回 SDRAM_ERR_TIMING;
+                   3. 刷新周期 = 刷新间隔 - 20, 20 个周期留给正在进行的访问;
+                   4. ReadBurst 为 1 时控制器和模式寄存器都用 4 拍突发, 否则为单拍.
+  * Function List:
+
+  **********************************************************
+ */
+#include "sdram.h"
+#include "stddef.h"
+
+#define SDRAM_BASE                  (EXMC_DMC_ADDR_MIN)
+#define SDRAM_WINDOW_MIN            (16UL << 20)    /* 片选译码的最小单位 */
+#define SDRAM_WINDOW_MAX            (128UL << 20)
+#define SDRAM_REFRESH_MAX           (0x7FFFUL)
+#define SDRAM_REFRESH_MARGIN        (20UL)
+
+/* 基本值大于 3 时附加值为基本值减 3 */
+#define SDRAM_APPEND(b)             ((uint8_t)(((b) > 3UL) ? ((b) - 3UL) : 0UL))
+
+static int32_t SDRAM_WaitReady(void) {
+    uint32_t u32Timeout = SDRAM_TIMEOUT;
+
+    while (EXMC_DMC_CURR_STATUS_RDY != EXMC_DMC_GetStatus()) {
+        if (0UL == --u32Timeout) {
+            return SDRAM_ERR_TIMEOUT;
+        }
+    }
+
+    return SDRAM_OK;
+}
+
+/**
+ * @brief  按器件参数初始化 SDRAM
+ * @param  [in]  Config                 器件参数, Device 0~3 对应 EXMC_DMC_CHIP0~3
+ * @param  [out] Info                   实际时钟、容量和刷新周期, 可以为 NULL
+ * @retval int32_t:
+ *           - SDRAM_OK:                成功
+ *           - SDRAM_ERR_PARAM:         器件参数超出 DMC 范围
+ *           - SDRAM_ERR_CLOCK:         EXCLK 超过 MaxHz
+ *           - SDRAM_ERR_TIMING:        时序超出寄存器范围
+ *           - SDRAM_ERR_REFRESH:       刷新间隔太短
+ *           - SDRAM_ERR_TIMEOUT:       DMC 未进入就绪状态
+ * @note   在系统时钟配置完成后调用, 改变 EXCLK 后须重新调用. 初始化会清空分配器.
+ *         支持列 8~12 位、行 11~16 位、16/32 位宽、4 个内部 bank、CAS 1~3, 单片不超过 128MB.
+ *         各片按相同容量排列, 片 n 的地址为 0x80000000 + n * max(容量, 16MB).
+ *         DMC 没有 tRRD 和 tWTR 参数对应的字段, tRRD 取 tRCD(不短于手册值), tWTR 取 1.
+ */
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info) {
+    stc_exmc_dmc_init_t stcInit;
+    stc_exmc_dmc_chip_config_t stcChip;
+    stc_clock_freq_t stcClk;
+    SDRAM_Timing stcT;
+    SDRAM_Info stcInfo;
+    uint32_t u32Window;
+    uint32_t u32Refresh;
+    uint32_t u32Burst;
+    int32_t i32Ret;
+
+    (void)SDRAM_Attach(NULL);
+
+    if ((Config->Device > 3U) || (Config->ColBits < 8U) || (Config->ColBits > 12U) || (Config->RowBits < 11U) ||
+        (Config->RowBits > 16U) || ((16U != Config->Width) && (32U != Config->Width)) || (4U != Config->InBanks) ||
+        (Config->Cas < 1U) || (Config->Cas > 3U) || (Config->tMRD < 1U) || (Config->tMRD > 0x7FU)) {
+        return SDRAM_ERR_PARAM;
+    }
+
+    stcInfo.RowSize = (1UL << Config->ColBits) * (Config->Width / 8UL);
+    stcInfo.BankSize = stcInfo.RowSize << Config->RowBits;
+
+    if (stcInfo.BankSize > SDRAM_WINDOW_MAX / 4UL) {
+        return SDRAM_ERR_PARAM;
+    }
+
+    stcInfo.Size = stcInfo.BankSize * 4UL;
+    u32Window = (stcInfo.Size > SDRAM_WINDOW_MIN) ? stcInfo.Size : SDRAM_WINDOW_MIN;
+
+    if (u32Window * (Config->Device + 1UL) > SDRAM_WINDOW_MAX) {
+        return SDRAM_ERR_PARAM;
+    }
+
+    (void)CLK_GetClockFreq(&stcClk);
+
+    if ((0UL == stcClk.u32ExclkFreq) || (stcClk.u32ExclkFreq > Config->MaxHz)) {
+        return SDRAM_ERR_CLOCK;
+    }
+
+    i32Ret = SDRAM_PlanTiming(Config, stcClk.u32ExclkFreq, &stcT);
+
+    if (SDRAM_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    if ((stcT.tRCD > 7UL) || (stcT.tRP > 7UL) || (stcT.tWR > 7UL) || (stcT.tRAS > 0x0FUL) || (stcT.tRC > 0x0FUL) ||
+        (stcT.tXSR > 0xFFUL)) {
+        return SDRAM_ERR_TIMING;
+    }
+
+    if (stcT.Refresh <= SDRAM_REFRESH_MARGIN) {
+        return SDRAM_ERR_REFRESH;
+    }
+
+    u32Refresh = stcT.Refresh - SDRAM_REFRESH_MARGIN;
+
+    if (u32Refresh > SDRAM_REFRESH_MAX) {
+        u32Refresh = SDRAM_REFRESH_MAX;
+    }
+
+    u32Burst = (0U != Config->ReadBurst) ? EXMC_DMC_BURST_4BEAT : EXMC_DMC_BURST_1BEAT;
+
+    FCG_Fcg3PeriphClockCmd(FCG3_PERIPH_DMC, ENABLE);
+    EXMC_DMC_Cmd(ENABLE);
+    EXMC_DMC_SetState(EXMC_DMC_CTRL_STATE_CONFIG);
+
+    (void)EXMC_DMC_StructInit(&stcInit);
+    stcInit.u32SampleClock = EXMC_DMC_SAMPLE_CLK_INTERNCLK;
+    stcInit.u32MemoryWidth = (32U == Config->Width) ? EXMC_DMC_MEMORY_WIDTH_32BIT : EXMC_DMC_MEMORY_WIDTH_16BIT;
+    stcInit.u32RefreshPeriod = u32Refresh;
+    stcInit.u32ColumnBitsNumber = ((uint32_t)Config->ColBits - 8UL) << DMC_CPCR_COLBS_POS;
+    stcInit.u32RowBitsNumber = ((uint32_t)Config->RowBits - 11UL) << DMC_CPCR_ROWBS_POS;
+    stcInit.u32AutoPrechargePin = EXMC_DMC_AUTO_PRECHARGE_A10;
+    stcInit.u32MemClockSel = EXMC_DMC_CLK_NORMAL_OUTPUT;
+    stcInit.u32CkeOutputSel = EXMC_DMC_CKE_OUTPUT_ENABLE;
+    stcInit.u32CkeDisablePeriod = 0UL;
+    stcInit.u32MemBurst = u32Burst;
+    stcInit.u32AutoRefreshChips = EXMC_DMC_AUTO_REFRESH_1CHIP;
+    stcInit.stcTimingConfig.u8CASL = Config->Cas;
+    stcInit.stcTimingConfig.u8DQSS = 0U;
+    stcInit.stcTimingConfig.u8MRD = Config->tMRD;
+    stcInit.stcTimingConfig.u8RAS = (uint8_t)stcT.tRAS;
+    stcInit.stcTimingConfig.u8RC = (uint8_t)stcT.tRC;
+    stcInit.stcTimingConfig.u8RCD_B = (uint8_t)stcT.tRCD;
+    stcInit.stcTimingConfig.u8RCD_P = SDRAM_APPEND(stcT.tRCD);
+    stcInit.stcTimingConfig.u8RFC_B = (uint8_t)stcT.tRC;
+    stcInit.stcTimingConfig.u8RFC_P = SDRAM_APPEND(stcT.tRC);
+    stcInit.stcTimingConfig.u8RP_B = (uint8_t)stcT.tRP;
+    stcInit.stcTimingConfig.u8RP_P = SDRAM_APPEND(stcT.tRP);
+    stcInit.stcTimingConfig.u8RRD = (uint8_t)stcT.tRCD;
+    stcInit.stcTimingConfig.u8WR = (uint8_t)stcT.tWR;
+    stcInit.stcTimingConfig.u8WTR = 1U;
+    stcInit.stcTimingConfig.u8XP = 1U;
+    stcInit.stcTimingConfig.u8XSR = (uint8_t)stcT.tXSR;
+    stcInit.stcTimingConfig.u8ESR = (uint8_t)stcT.tXSR;
+    (void)EXMC_DMC_Init(&stcInit);
+
+    stcInfo.Base = SDRAM_BASE + u32Window * Config->Device;
+    stcChip.u32AddrMatch = stcInfo.Base >> 24U;
+    stcChip.u32AddrMask = (0x100UL - (u32Window >> 24U)) & 0xFFUL;
+    stcChip.u32AddrDecodeMode = EXMC_DMC_CS_DECODE_BANKROWCOL;
+    (void)EXMC_DMC_ChipConfig(Config->Device, &stcChip);
+
+    /* JEDEC 上电序列: 时钟稳定至少 100us 后预充电, 至少 2 次自动刷新, 再装载模式寄存器 */
+    EXMC_DMC_SetCommand(Config->Device, EXMC_DMC_BANK0, EXMC_DMC_CMD_NOP, 0UL);
+    DDL_DelayUS(100UL);
+    EXMC_DMC_SetCommand(Config->Device, EXMC_DMC_BANK0, EXMC_DMC_CMD_PRECHARGE_ALL, 0UL);
+    EXMC_DMC_SetCommand(Config->Device, EXMC_DMC_BANK0, EXMC_DMC_CMD_AUTO_REFRESH, 0UL);
+    EXMC_DMC_SetCommand(Config->Device, EXMC_DMC_BANK0, EXMC_DMC_CMD_AUTO_REFRESH, 0UL);
+    EXMC_DMC_SetCommand(Config->Device, EXMC_DMC_BANK0, EXMC_DMC_CMD_MDREG_CONFIG,
+                        ((uint32_t)Config->Cas << 4U) | ((EXMC_DMC_BURST_4BEAT == u32Burst) ? 2UL : 0UL));
+
+    EXMC_DMC_SetState(EXMC_DMC_CTRL_STATE_GO);
+    i32Ret = SDRAM_WaitReady();
+
+    if (SDRAM_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    stcInfo.ClockHz = stcClk.u32ExclkFreq;
+    stcInfo.Refresh = (uint16_t)u32Refresh;
+    stcInfo.Div = (uint8_t)(stcClk.u32HclkFreq / stcClk.u32ExclkFreq);
+    stcInfo.InBanks = 4U;
+    stcInfo.Map = SDRAM_MAP_BANK_ROW_COL;
+
+    if (NULL != Info) {
+        *Info = stcInfo;
+    }
+
+    return SDRAM_Attach(&stcInfo);
+}
+
+/**
+ * @brief  测量当前配置的带宽
+ * @param  [in]  Buf                    测试缓冲, 顺序写会改写其内容
+ * @param  [in]  Bytes                  测试缓冲大小, 每项测试访问 Bytes 字节
+ * @param  [out] Result                 结果, 单位 KB/s
+ * @retval None
+ * @note   关中断后用 DWT 计数执行 SDRAM_BenchRun. 不同 ReadBurst/CAS 或 EXCLK 下分别初始化后调用,
+ *         比较结果选择配置.
+ */
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __disable_irq();
+
+    SDRAM_BenchRun(Buf, Bytes, &DWT->CYCCNT, SystemCoreClock, Result);
+
+    __enable_irq();
+}
@@ -0,0 +1,36 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : EXMC_DMC 外部 SDRAM 初始化和带宽测试
+                   时序换算、分配和测试过程在 Common/sdram_plan.c, 这里只写 DMC 寄存器并执行上电序列.
+                   DMC 按 [内部 bank][行][列] 译码(EXMC_DMC_CS_DECODE_BANKROWCOL), 用 SDRAM_Alloc 把同时
+                   访问的缓冲放在不同 bank.
+                   Device 0~3 对应 EXMC_DMC_CHIP0~3, 地址从 0x80000000 起按片号和容量排列.
+                   DMC 引脚复用和 EXCLK 分频由用户在调用 SDRAM_Setup 之前配置, 需开启 LL_DMC_ENABLE.
+  * Function List:
+                   SDRAM_Setup
+                   SDRAM_Bench
+  ******************************************************
+**/
+
+#ifndef __SDRAM_H_
+#define __SDRAM_H_
+
+#include "hc32_ll.h"
+#include "sdram_plan.h"
+
+#define SDRAM_TIMEOUT               (0xFFFFUL)
+
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info);
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result);
+
+#endif
@@ -0,0 +1,322 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC1 任意波形播放
+                   1. TMR0 计数到比较值时清零并产生比较事件, AOS 把该事件接到 DMA 通道的触发,
+                      每个事件搬一个样本到 DAC 数据寄存器; 连线在 Wave_Init 中用 AOSG_Apply 建立;
+                   2. 单通道 16 位写 DADR1 或 DADR2, 双通道 32 位写 DADR1 同时装入 DADR2;
+                   3. 分频只能取 2 的幂, 由 Wave_PlanRate 换算; 比较值没有缓冲, 播放中改小时
+                      若计数已超过新值则清零计数, 该样本间隔缩短一次, 不会等到 16 位回绕;
+                   4. 描述符用 DMA_LLP_WAIT: 一块结束后装入下一个描述符, 等下一个事件再搬,
+                      块与块之间不多不少一个采样周期;
+                   5. 流播放中 DMA 当前所在的块由源地址监视寄存器判断.
+  * Function List:
+
+  **********************************************************
+ */
+#include "wave_player.h"
+#include "stddef.h"
+
+static uint8_t m_u8Channels = 0U;
+static stc_aosg_link_t m_stcLink;
+static stc_aosg_plan_t m_stcPlan;
+static stc_dma_llp_descriptor_t m_astcDesc[2];
+static Wave_Stream m_stcStream;
+
+/* 描述符的通道控制字, 与 Wave_DMAStart 中 DMA_Init + DMA_LlpInit 写入的一致 */
+static uint32_t Wave_ChCtl(uint32_t u32IntEn) {
+    uint32_t u32Width = (WAVE_CH_BOTH == m_u8Channels) ? DMA_DATAWIDTH_32BIT : DMA_DATAWIDTH_16BIT;
+
+    return DMA_SRC_ADDR_INC | DMA_DEST_ADDR_FIX | u32Width | u32IntEn | DMA_LLP_ENABLE | DMA_LLP_WAIT;
+}
+
+static uint32_t Wave_DestAddr(void) {
+    return (WAVE_CH1 == m_u8Channels) ? (uint32_t)&CM_DAC1->DADR2 : (uint32_t)&CM_DAC1->DADR1;
+}
+
+static void Wave_SetDesc(stc_dma_llp_descriptor_t *pstcDesc, const void *pvSrc, uint32_t u32Samples,
+                         const stc_dma_llp_descriptor_t *pstcNext, uint32_t u32IntEn) {
+    pstcDesc->SARx = (uint32_t)pvSrc;
+    pstcDesc->DARx = Wave_DestAddr();
+    pstcDesc->DTCTLx = 1UL | (u32Samples << DMA_DTCTL_CNT_POS);
+    pstcDesc->RPTx = 0UL;
+    pstcDesc->SNSEQCTLx = 0UL;
+    pstcDesc->DNSEQCTLx = 0UL;
+    pstcDesc->LLPx = (uint32_t)pstcNext;
+    pstcDesc->CHCTLx = Wave_ChCtl(u32IntEn);
+}
+
+/**
+ * @brief  初始化引脚、DAC1、TMR0、DMA 和 AOS 连线, 登记 DMA 传输完成中断
+ * @param  [in]  Channels               WAVE_CH0 / WAVE_CH1 / WAVE_CH_BOTH
+ * @retval int32_t:
+ *           - WAVE_OK:                 成功
+ *           - WAVE_ERR_PARAM:          通道参数错误
+ *           - WAVE_ERR_BUSY:           DMA 通道的触发选择或 WAVE_DMA_IRQn 已被其他代码占用
+ * @note   Wave_DMA_IRQHandler 在这里用 INTC_IrqSignIn 登记, 不需要在中断向量中调用.
+ *         重复调用时先释放上一次的连线.
+ */
+int32_t Wave_Init(uint8_t Channels) {
+    stc_gpio_init_t stcGpio;
+    stc_dac_init_t stcDac;
+    stc_tmr0_init_t stcTmr0;
+    stc_irq_signin_config_t stcIrq;
+    uint16_t u16Pins = 0U;
+
+    if ((0U == Channels) || (0U != (Channels & (uint8_t)~WAVE_CH_BOTH))) {
+        return WAVE_ERR_PARAM;
+    }
+
+    if (0U != m_u8Channels) {
+        Wave_Stop();
+        AOSG_Release(&m_stcLink, 1U, &m_stcPlan);
+        m_u8Channels = 0U;
+    }
+
+    FCG_Fcg0PeriphClockCmd(WAVE_DMA_FCG, ENABLE);
+    FCG_Fcg2PeriphClockCmd(WAVE_TMR0_FCG, ENABLE);
+    FCG_Fcg3PeriphClockCmd(FCG3_PERIPH_DAC1, ENABLE);
+
+    if (0U != (Channels & WAVE_CH0)) {
+        u16Pins |= GPIO_PIN_04;
+    }
+    if (0U != (Channels & WAVE_CH1)) {
+        u16Pins |= GPIO_PIN_05;
+    }
+    (void)GPIO_StructInit(&stcGpio);
+    stcGpio.u16PinAttr = PIN_ATTR_ANALOG;
+    (void)GPIO_Init(GPIO_PORT_A, u16Pins, &stcGpio);
+
+    DAC_DeInit(CM_DAC1);
+    (void)DAC_StructInit(&stcDac);
+    stcDac.u16Src = DAC_DATA_SRC_DATAREG;
+    stcDac.enOutput = ENABLE;
+    if (0U != (Channels & WAVE_CH0)) {
+        (void)DAC_Init(CM_DAC1, DAC_CH1, &stcDac);
+    }
+    if (0U != (Channels & WAVE_CH1)) {
+        (void)DAC_Init(CM_DAC1, DAC_CH2, &stcDac);
+    }
+    DAC_DataRegAlignConfig(CM_DAC1, DAC_DATA_ALIGN_RIGHT);
+
+    if (WAVE_CH_BOTH == Channels) {
+        DAC_StartDualCh(CM_DAC1);
+    } else {
+        (void)DAC_Start(CM_DAC1, (WAVE_CH0 == Channels) ? DAC_CH1 : DAC_CH2);
+    }
+
+    TMR0_Stop(WAVE_TMR0, WAVE_TMR0_CH);
+    (void)TMR0_StructInit(&stcTmr0);
+    stcTmr0.u32ClockSrc = TMR0_CLK_SRC_INTERN_CLK;
+    stcTmr0.u32ClockDiv = TMR0_CLK_DIV1;
+    stcTmr0.u32Func = TMR0_FUNC_CMP;
+    stcTmr0.u16CompareValue = 0xFFFFU;
+    (void)TMR0_Init(WAVE_TMR0, WAVE_TMR0_CH, &stcTmr0);
+
+    DMA_Cmd(WAVE_DMA, ENABLE);
+    (void)DMA_ChCmd(WAVE_DMA, WAVE_DMA_CH, DISABLE);
+    DMA_TransCompleteIntCmd(WAVE_DMA, DMA_INT_BTC_CH0 << WAVE_DMA_CH, DISABLE);
+    DMA_TransCompleteIntCmd(WAVE_DMA, DMA_INT_TC_CH0 << WAVE_DMA_CH, ENABLE);
+
+    m_stcLink.enSrc = WAVE_TMR0_EVT;
+    m_stcLink.u32Target = ((CM_DMA1 == WAVE_DMA) ? AOS_DMA1_0 : AOS_DMA2_0) + 4UL * (uint32_t)WAVE_DMA_CH;
+    if (LL_OK != AOSG_Apply(&m_stcLink, 1U, &m_stcPlan)) {
+        return WAVE_ERR_BUSY;
+    }
+
+    stcIrq.enIntSrc = (en_int_src_t)((uint32_t)WAVE_DMA_INT_SRC + (uint32_t)WAVE_DMA_CH);
+    stcIrq.enIRQn = WAVE_DMA_IRQn;
+    stcIrq.pfnCallback = &Wave_DMA_IRQHandler;
+    if (LL_OK != INTC_IrqSignIn(&stcIrq)) {
+        AOSG_Release(&m_stcLink, 1U, &m_stcPlan);
+        return WAVE_ERR_BUSY;
+    }
+
+    NVIC_ClearPendingIRQ(WAVE_DMA_IRQn);
+    NVIC_SetPriority(WAVE_DMA_IRQn, WAVE_IRQ_PRIO);
+    NVIC_EnableIRQ(WAVE_DMA_IRQn);
+
+    m_stcStream.Callback = NULL;
+    m_stcStream.Stats.DacUnderruns = 0UL;
+    m_u8Channels = Channels;
+
+    return WAVE_OK;
+}
+
+/**
+ * @brief  设置采样率, 播放中也可调用
+ * @param  [in]  Rate                   采样率(Hz)
+ * @retval uint32_t:                    实际采样率(Hz, 向下取整)
+ * @note   TMR0 计数时钟为 PCLK1, 分频 1~1024 取 2 的幂.
+ */
+uint32_t Wave_SetRate(uint32_t Rate) {
+    stc_clock_freq_t stcClk;
+    uint32_t u32Div;
+    uint32_t u32Period;
+    uint32_t u32Shift = 0UL;
+    uint32_t u32Actual;
+
+    (void)CLK_GetClockFreq(&stcClk);
+    u32Actual = Wave_PlanRate(stcClk.u32Pclk1Freq, Rate, WAVE_TMR0_DIV_MAX, 1U, &u32Div, &u32Period);
+
+    while ((1UL << u32Shift) < u32Div) {
+        u32Shift++;
+    }
+
+    TMR0_SetClockDiv(WAVE_TMR0, WAVE_TMR0_CH, u32Shift << TMR0_BCONR_CKDIVA_POS);
+    TMR0_SetCompareValue(WAVE_TMR0, WAVE_TMR0_CH, (uint16_t)(u32Period - 1UL));
+    if (TMR0_GetCountValue(WAVE_TMR0, WAVE_TMR0_CH) >= (u32Period - 1UL)) {
+        TMR0_SetCountValue(WAVE_TMR0, WAVE_TMR0_CH, 0U);
+    }
+
+    return u32Actual;
+}
+
+/**
+ * @brief  装入第一段并启动 DMA 和 TMR0
+ * @param  [in]  pvBuf                  第一段的首地址
+ * @param  [in]  u32Samples             第一段的样本数
+ * @param  [in]  pstcNext               第一段结束后装入的描述符
+ * @param  [in]  u32IntEn               DMA_INT_ENABLE: 每段结束进传输完成中断
+ * @retval 无
+ */
+static void Wave_DMAStart(const void *pvBuf, uint32_t u32Samples, const stc_dma_llp_descriptor_t *pstcNext,
+                          uint32_t u32IntEn) {
+    stc_dma_init_t stcDma;
+    stc_dma_llp_init_t stcLlp;
+
+    DMA_DeInit(WAVE_DMA, WAVE_DMA_CH);
+    (void)DMA_StructInit(&stcDma);
+    stcDma.u32IntEn = u32IntEn;
+    stcDma.u32SrcAddr = (uint32_t)pvBuf;
+    stcDma.u32DestAddr = Wave_DestAddr();
+    stcDma.u32DataWidth = (WAVE_CH_BOTH == m_u8Channels) ? DMA_DATAWIDTH_32BIT : DMA_DATAWIDTH_16BIT;
+    stcDma.u32BlockSize = 1UL;
+    stcDma.u32TransCount = u32Samples;
+    stcDma.u32SrcAddrInc = DMA_SRC_ADDR_INC;
+    stcDma.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(WAVE_DMA, WAVE_DMA_CH, &stcDma);
+
+    (void)DMA_LlpStructInit(&stcLlp);
+    stcLlp.u32State = DMA_LLP_ENABLE;
+    stcLlp.u32Mode = DMA_LLP_WAIT;
+    stcLlp.u32Addr = (uint32_t)pstcNext;
+    (void)DMA_LlpInit(WAVE_DMA, WAVE_DMA_CH, &stcLlp);
+
+    DMA_ClearTransCompleteStatus(WAVE_DMA, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << WAVE_DMA_CH);
+    NVIC_ClearPendingIRQ(WAVE_DMA_IRQn);
+    (void)DMA_ChCmd(WAVE_DMA, WAVE_DMA_CH, ENABLE);
+
+    TMR0_SetCountValue(WAVE_TMR0, WAVE_TMR0_CH, 0U);
+    TMR0_Start(WAVE_TMR0, WAVE_TMR0_CH);
+}
+
+/**
+ * @brief  循环播放一张波形表
+ * @param  [in]  Table                  单通道 uint16_t[], 双通道 uint32_t[](Wave_Pack 生成), 播放期间不得修改
+ * @param  [in]  Samples                样本数, 1~WAVE_MAX_SAMPLES
+ * @param  [in]  Rate                   采样率(Hz), 输出频率 = Rate / Samples
+ * @retval uint32_t:                    实际采样率(Hz), 未初始化或参数错误时为 0
+ */
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate) {
+    uint32_t u32Actual;
+
+    if ((0U == m_u8Channels) || (NULL == Table) || (0UL == Samples) || (Samples > WAVE_MAX_SAMPLES)) {
+        return 0UL;
+    }
+
+    Wave_Stop();
+    m_stcStream.Callback = NULL;
+    Wave_SetDesc(&m_astcDesc[0], Table, Samples, &m_astcDesc[0], DMA_INT_DISABLE);
+    u32Actual = Wave_SetRate(Rate);
+    Wave_DMAStart(Table, Samples, &m_astcDesc[0], DMA_INT_DISABLE);
+
+    return u32Actual;
+}
+
+/**
+ * @brief  双缓冲流播放
+ * @param  [in]  Buf                    连续的两块, 共 2 * Samples 个样本
+ * @param  [in]  Samples                每块样本数, 1~WAVE_MAX_SAMPLES
+ * @param  [in]  Rate                   采样率(Hz)
+ * @param  [in]  Callback               填块回调, 启动前先调用两次填满两块
+ * @retval uint32_t:                    实际采样率(Hz), 未初始化或参数错误时为 0
+ * @note   回调必须在一块的播放时间(Samples / Rate)内返回.
+ */
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback) {
+    uint32_t u32Actual;
+    uint8_t *pu8Block1;
+
+    if ((0U == m_u8Channels) || (NULL == Buf) || (NULL == Callback) || (0UL == Samples) ||
+            (Samples > WAVE_MAX_SAMPLES)) {
+        return 0UL;
+    }
+
+    Wave_Stop();
+    Wave_StreamStart(&m_stcStream, Buf, Samples, WAVE_SAMPLE_BYTES(m_u8Channels), Callback);
+    pu8Block1 = m_stcStream.Buf + m_stcStream.BlockBytes;
+    Wave_SetDesc(&m_astcDesc[0], Buf, Samples, &m_astcDesc[1], DMA_INT_ENABLE);
+    Wave_SetDesc(&m_astcDesc[1], pu8Block1, Samples, &m_astcDesc[0], DMA_INT_ENABLE);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    u32Actual = Wave_SetRate(Rate);
+    Wave_DMAStart(Buf, Samples, &m_astcDesc[1], DMA_INT_ENABLE);
+
+    return u32Actual;
+}
+
+/**
+ * @brief  停止播放, 输出保持最后一个样本
+ * @param  无
+ * @retval 无
+ */
+void Wave_Stop(void) {
+    if (0U == m_u8Channels) {
+        return;
+    }
+
+    TMR0_Stop(WAVE_TMR0, WAVE_TMR0_CH);
+    (void)DMA_ChCmd(WAVE_DMA, WAVE_DMA_CH, DISABLE);
+    DMA_ClearTransCompleteStatus(WAVE_DMA, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << WAVE_DMA_CH);
+    NVIC_ClearPendingIRQ(WAVE_DMA_IRQn);
+}
+
+static uint8_t Wave_Playing(void) {
+    return (DMA_GetSrcAddr(WAVE_DMA, WAVE_DMA_CH) >= m_astcDesc[1].SARx) ? 1U : 0U;
+}
+
+/**
+ * @brief  流播放的块完成中断, 由 Wave_Init 登记到 WAVE_DMA_IRQn
+ * @param  无
+ * @retval 无
+ * @note   DMA 已装入另一块的描述符, 刚播完的一块交给 Wave_StreamDone 刷新.
+ */
+void Wave_DMA_IRQHandler(void) {
+    if (RESET == DMA_GetTransCompleteStatus(WAVE_DMA, DMA_FLAG_TC_CH0 << WAVE_DMA_CH)) {
+        return;
+    }
+
+    DMA_ClearTransCompleteStatus(WAVE_DMA, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << WAVE_DMA_CH);
+    Wave_StreamDone(&m_stcStream, Wave_Playing() ^ 1U, Wave_Playing, &DWT->CYCCNT);
+}
+
+/**
+ * @brief  读取运行统计
+ * @param  [out] Stats                  输出
+ * @retval 无
+ */
+void Wave_GetStats(Wave_Stats *Stats) {
+    *Stats = m_stcStream.Stats;
+}
@@ -0,0 +1,60 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC1 任意波形播放(TMR0_1 A 通道定采样率, 经 AOS 触发 DMA2 通道0 搬运)
+                   接口与 STM32/GD32/AT32 模板的 wave_player.h 相同, 波形表生成、采样率换算和
+                   流播放的块管理在 Common/wave_gen.c.
+                   表播放: 一个指向自己的链表描述符让 DMA 反复输出一张表, 不占 CPU, 不进中断;
+                   流播放: 两个描述符互相链接, 每播完一块进传输完成中断, 回调填这一块.
+                   HC32 的 DAC 没有外部触发, 由 TMR0 比较事件直接触发 DMA 写数据寄存器,
+                   DAC 立即转换; 双通道时两路样本打包成一个字写入 DADR1/DADR2, 两路同时更新.
+                   DAC 不发 DMA 请求, 也就没有 DAC 欠载, Wave_Stats.DacUnderruns 始终为 0.
+                   引脚: PA4 = DAC1_OUT1(WAVE_CH0), PA5 = DAC1_OUT2(WAVE_CH1).
+  * Function List:
+                   Wave_Init
+                   Wave_PlayTable
+                   Wave_PlayStream
+                   Wave_SetRate
+                   Wave_Stop
+                   Wave_DMA_IRQHandler
+                   Wave_GetStats
+  ******************************************************
+**/
+
+#ifndef __WAVE_PLAYER_H_
+#define __WAVE_PLAYER_H_
+
+#include "hc32_ll.h"
+#include "aos_graph.h"
+#include "wave_gen.h"
+
+#define WAVE_DMA                    (CM_DMA2)
+#define WAVE_DMA_CH                 (DMA_CH0)
+#define WAVE_DMA_FCG                (FCG0_PERIPH_DMA2)
+#define WAVE_DMA_INT_SRC            (INT_SRC_DMA2_TC0)
+#define WAVE_DMA_IRQn               (INT020_IRQn)       /*!< INT000~031 可登记任意中断源 */
+#define WAVE_IRQ_PRIO               (DDL_IRQ_PRIO_03)
+#define WAVE_TMR0                   (CM_TMR0_1)
+#define WAVE_TMR0_CH                (TMR0_CH_A)
+#define WAVE_TMR0_FCG               (FCG2_PERIPH_TMR0_1)
+#define WAVE_TMR0_EVT               (EVT_SRC_TMR0_1_CMP_A)
+#define WAVE_TMR0_DIV_MAX           (1024UL)            /*!< 分频 1~1024, 只能取 2 的幂 */
+
+int32_t Wave_Init(uint8_t Channels);
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate);
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback);
+uint32_t Wave_SetRate(uint32_t Rate);
+void Wave_Stop(void);
+void Wave_DMA_IRQHandler(void);
+void Wave_GetStats(Wave_Stats *Stats);
+
+#endif
@@ -51,29 +51,29 @@ extern "C"
 #define LL_UTILITY_ENABLE                           (DDL_ON)
 #define LL_PRINT_ENABLE                             (DDL_OFF)
 
-#define LL_ADC_ENABLE                               (DDL_OFF)
+#define LL_ADC_ENABLE                               (DDL_ON)
 #define LL_AES_ENABLE                               (DDL_OFF)
-#define LL_AOS_ENABLE                               (DDL_OFF)
-#define LL_CAN_ENABLE                               (DDL_OFF)
+#define LL_AOS_ENABLE                               (DDL_ON)
+#define LL_CAN_ENABLE                               (DDL_ON)
 #define LL_CLK_ENABLE                               (DDL_ON)
 #define LL_CMP_ENABLE                               (DDL_OFF)
 #define LL_CRC_ENABLE                               (DDL_OFF)
 #define LL_CTC_ENABLE                               (DDL_OFF)
-#define LL_DAC_ENABLE                               (DDL_OFF)
-#define LL_DCU_ENABLE                               (DDL_OFF)
-#define LL_DMA_ENABLE                               (DDL_OFF)
-#define LL_DMC_ENABLE                               (DDL_OFF)
-#define LL_DVP_ENABLE                               (DDL_OFF)
+#define LL_DAC_ENABLE                               (DDL_ON)
+#define LL_DCU_ENABLE                               (DDL_ON)
+#define LL_DMA_ENABLE                               (DDL_ON)
+#define LL_DMC_ENABLE                               (DDL_ON)
+#define LL_DVP_ENABLE                               (DDL_ON)
 #define LL_EFM_ENABLE                               (DDL_ON)
 #define LL_EMB_ENABLE                               (DDL_OFF)
-#define LL_ETH_ENABLE                               (DDL_OFF)
+#define LL_ETH_ENABLE                               (DDL_ON)
 #define LL_EVENT_PORT_ENABLE                        (DDL_OFF)
 #define LL_FCG_ENABLE                               (DDL_ON)
 #define LL_FCM_ENABLE                               (DDL_OFF)
 #define LL_FMAC_ENABLE                              (DDL_OFF)
 #define LL_GPIO_ENABLE                              (DDL_ON)
 #define LL_HASH_ENABLE                              (DDL_OFF)
-#define LL_HRPWM_ENABLE                             (DDL_OFF)
+#define LL_HRPWM_ENABLE                             (DDL_ON)
 #define LL_I2C_ENABLE                               (DDL_OFF)
 #define LL_I2S_ENABLE                               (DDL_OFF)
 #define LL_INTERRUPTS_ENABLE                        (DDL_ON)
@@ -81,27 +81,42 @@ extern "C"
 #define LL_KEYSCAN_ENABLE                           (DDL_ON)
 #define LL_MAU_ENABLE                               (DDL_OFF)
 #define LL_MPU_ENABLE                               (DDL_OFF)
-#define LL_NFC_ENABLE                               (DDL_OFF)
+#define LL_NFC_ENABLE                               (DDL_ON)
 #define LL_OTS_ENABLE                               (DDL_OFF)
 #define LL_PWC_ENABLE                               (DDL_ON)
 #define LL_QSPI_ENABLE                              (DDL_OFF)
 #define LL_RMU_ENABLE                               (DDL_OFF)
-#define LL_RTC_ENABLE                               (DDL_OFF)
+#define LL_RTC_ENABLE                               (DDL_ON)
 #define LL_SDIOC_ENABLE                             (DDL_OFF)
 #define LL_SMC_ENABLE                               (DDL_OFF)
 #define LL_SPI_ENABLE                               (DDL_OFF)
 #define LL_SRAM_ENABLE                              (DDL_OFF)
 #define LL_SWDT_ENABLE                              (DDL_OFF)
-#define LL_TMR0_ENABLE                              (DDL_OFF)
+#define LL_TMR0_ENABLE                              (DDL_ON)
 #define LL_TMR2_ENABLE                              (DDL_OFF)
 #define LL_TMR4_ENABLE                              (DDL_OFF)
-#define LL_TMR6_ENABLE                              (DDL_OFF)
+#define LL_TMR6_ENABLE                              (DDL_ON)
 #define LL_TMRA_ENABLE                              (DDL_OFF)
-#define LL_TRNG_ENABLE                              (DDL_OFF)
+#define LL_TRNG_ENABLE                              (DDL_ON)
 #define LL_USART_ENABLE                             (DDL_OFF)
 #define LL_USB_ENABLE                               (DDL_OFF)
 #define LL_WDT_ENABLE                               (DDL_OFF)
 
+/**
+ * @brief Driver build profile.
+ * Debug target defines __DEBUG: DDL_ASSERT checks every parameter and the
+ * register accessors stay out-of-line, so breakpoints on them still work.
+ * release target drops __DEBUG: DDL_ASSERT compiles to nothing and the
+ * DMA/GPIO register accessors listed in hc32_ll_dma.h / hc32_ll_gpio.h become
+ * static inline, folding into the caller together with their constant
+ * LL_OK return value.
+ */
+#ifdef __DEBUG
+#define LL_INLINE_ENABLE                            (DDL_OFF)
+#else
+#define LL_INLINE_ENABLE                            (DDL_ON)
+#endif
+
 /**
  * @brief The following is a list of currently supported BSP boards.
  */
@@ -131,6 +146,42 @@ extern "C"
 #define BSP_W25QXX_ENABLE                           (DDL_OFF)
 #define BSP_WM8731_ENABLE                           (DDL_OFF)
 
+/**
+ * @brief Ethernet and PHY configuration used by hc32_ll_eth.c.
+ * PHY register bits are the IEEE 802.3 clause 22 BCR/BSR bits, so they fit
+ * any standard MII/RMII PHY; change ETH_PHY_ADDR to the board strapping.
+ */
+/* MAC address loaded by ETH_CommStructInit, locally administered */
+#define ETH_MAC_ADDR0                               (0x02U)
+#define ETH_MAC_ADDR1                               (0x00U)
+#define ETH_MAC_ADDR2                               (0x00U)
+#define ETH_MAC_ADDR3                               (0x00U)
+#define ETH_MAC_ADDR4                               (0x00U)
+#define ETH_MAC_ADDR5                               (0x00U)
+
+/* PHY address and delays/timeouts, unit: ms */
+#define ETH_PHY_ADDR                                (0x00U)
+#define ETH_PHY_RST_DELAY                           (0x0080UL)
+#define ETH_PHY_CONFIG_DELAY                        (0x0800UL)
+#define ETH_PHY_RD_TIMEOUT                          (0x0005UL)
+#define ETH_PHY_WR_TIMEOUT                          (0x0005UL)
+
+/* PHY registers */
+#define PHY_BCR                                     (0x00U)     /*!< Basic control register */
+#define PHY_BSR                                     (0x01U)     /*!< Basic status register */
+
+/* PHY_BCR bits */
+#define PHY_SOFT_RESET                              (0x8000U)
+#define PHY_LOOPBACK                                (0x4000U)
+#define PHY_AUTONEGOTIATION                         (0x1000U)
+
+/* PHY_BSR bits */
+#define PHY_100BASE_TX_FD                           (0x4000U)
+#define PHY_100BASE_TX_HD                           (0x2000U)
+#define PHY_10BASE_T_FD                             (0x1000U)
+#define PHY_AUTONEGO_COMPLETE                       (0x0020U)
+#define PHY_LINK_STATUS                             (0x0004U)
+
 /*******************************************************************************
  * Global variable definitions ('extern')
  ******************************************************************************/
@@ -170,10 +170,13 @@ __Vectors_Size  EQU  __Vectors_End - __Vectors
 Reset_Handler    PROC
                  EXPORT  Reset_Handler             [WEAK]
         IMPORT  SystemInit
+        IMPORT  Mem_Init
         IMPORT  __main
 
                  LDR     R0, =SystemInit
                  BLX     R0
+                 LDR     R0, =Mem_Init           ; 初始化 Template.sct 中的 UNINIT 区
+                 BLX     R0
                  LDR     R0, =__main
                  BX      R0
                  ENDP
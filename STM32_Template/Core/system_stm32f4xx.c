@@ -335,6 +335,10 @@
 #endif /* USE_HSE_BYPASS */
 #endif /* STM32F410xx || STM32F411xE */
 
+/*!< 如果希望 SystemInit 只启动 HSE/PLL 而不等待，请取消注释以下行。之后由 SystemClock_Poll/SystemClock_Wait
+     完成切换，HSE 起振和 PLL 锁定期间可以执行 .data/.bss 初始化和其它初始化步骤(见 boot_seq.c)。 */
+/* #define SYSCLK_ASYNC */
+
 /*!< 如果需要在内部 SRAM 中重新定位矢量表，请取消注释以下行。 */
 /* #define VECT_TAB_SRAM */
 #define VECT_TAB_OFFSET  0x00 /*!< 矢量表基偏移字段。 
@@ -440,6 +444,11 @@ static void SystemInit_ExtMemCtl(void);
   * 返回值: 无
   */
 void SystemInit(void) {
+    /* 周期计数器从复位后立即开始计数, 供启动过程计时(boot_seq) */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     /* FPU 设置 ------------------------------------------------------------*/
 #if (__FPU_PRESENT == 1) && (__FPU_USED == 1)
     SCB->CPACR |= ((3UL << 10*2)|(3UL << 11*2));  /* 设置 CP10 和 CP11 完全访问 */
@@ -469,7 +478,11 @@ void SystemInit(void) {
 
     /* 配置系统时钟源 , PLL 乘法器和除法器因子，
        AHB/APBx 预分频器和 Flash 设置 ----------------------------------*/
+#ifdef SYSCLK_ASYNC
+    SystemClock_Start();
+#else
     SetSysClock();
+#endif /* SYSCLK_ASYNC */
 
     /* 配置矢量表位置添加偏移地址 ------------------*/
 #ifdef VECT_TAB_SRAM
@@ -580,116 +593,185 @@ void SystemCoreClockUpdate(void) {
     SystemCoreClock >>= tmp;
 }
 
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F401xx) || defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx)|| defined(STM32F469_479xx)
 /**
-  * 简介:  配置系统时钟源, PLL 乘法器和除法器因子，
-  *         AHB/APBx 预分频器和 Flash 设置
-  * @Note   这个函数应该只在 RCC 时钟配置重置为默认重置状态(在 SystemInit() 函数中完成)时调用。
+  * 简介:  配置调节器、AHB/APBx 预分频器和主 PLL
+  * @Note   由 SystemClock_Poll 在 HSE 就绪之后、打开 PLL 之前调用, 顺序与同步启动相同;
+  *         HSE 未起振时不会执行, 系统保持复位后的 HSI 和分频设置.
   * 参数:  无
   * 返回值: 无
   */
-static void SetSysClock(void) {
-#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F401xx) || defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx)|| defined(STM32F469_479xx)
-    /******************************************************************************/
-    /*            PLL (clocked by HSE) 用作系统时钟源                          */
-    /******************************************************************************/
-    __IO uint32_t StartUpCounter = 0, HSEStatus = 0;
-
-    /* Enable HSE */
-    RCC->CR |= ((uint32_t)RCC_CR_HSEON);
-
-    /* 等待HSE准备就绪，如果达到超时，则退出 */
-    do {
-        HSEStatus = RCC->CR & RCC_CR_HSERDY;
-        StartUpCounter++;
-    } while((HSEStatus == 0) && (StartUpCounter != HSE_STARTUP_TIMEOUT));
-
-    if ((RCC->CR & RCC_CR_HSERDY) != RESET) {
-        HSEStatus = (uint32_t)0x01;
-    } else {
-        HSEStatus = (uint32_t)0x00;
-    }
-
-    if (HSEStatus == (uint32_t)0x01) {
-        /* 选择调节器电压输出比例1模式 */
-        RCC->APB1ENR |= RCC_APB1ENR_PWREN;
-        PWR->CR |= PWR_CR_VOS;
+static void SystemClock_Config(void) {
+    /* 选择调节器电压输出比例1模式 */
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_VOS;
 
-        /* HCLK = SYSCLK / 1*/
-        RCC->CFGR |= RCC_CFGR_HPRE_DIV1;
+    /* HCLK = SYSCLK / 1*/
+    RCC->CFGR |= RCC_CFGR_HPRE_DIV1;
 
 #if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) ||  defined(STM32F412xG) || defined(STM32F446xx) || defined(STM32F469_479xx)
-        /* PCLK2 = HCLK / 2*/
-        RCC->CFGR |= RCC_CFGR_PPRE2_DIV2;
+    /* PCLK2 = HCLK / 2*/
+    RCC->CFGR |= RCC_CFGR_PPRE2_DIV2;
 
-        /* PCLK1 = HCLK / 4*/
-        RCC->CFGR |= RCC_CFGR_PPRE1_DIV4;
+    /* PCLK1 = HCLK / 4*/
+    RCC->CFGR |= RCC_CFGR_PPRE1_DIV4;
 #endif /* STM32F40_41xxx || STM32F427_437x || STM32F429_439xx  || STM32F412xG || STM32F446xx || STM32F469_479xx */
 
 #if defined(STM32F401xx) || defined(STM32F413_423xx)
-        /* PCLK2 = HCLK / 1*/
-        RCC->CFGR |= RCC_CFGR_PPRE2_DIV1;
+    /* PCLK2 = HCLK / 1*/
+    RCC->CFGR |= RCC_CFGR_PPRE2_DIV1;
 
-        /* PCLK1 = HCLK / 2*/
-        RCC->CFGR |= RCC_CFGR_PPRE1_DIV2;
+    /* PCLK1 = HCLK / 2*/
+    RCC->CFGR |= RCC_CFGR_PPRE1_DIV2;
 #endif /* STM32F401xx || STM32F413_423xx */
 
 #if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F401xx) || defined(STM32F469_479xx)
-        /* 配置main PLL */
-        RCC->PLLCFGR = PLL_M | (PLL_N << 6) | (((PLL_P >> 1) -1) << 16) |
-                       (RCC_PLLCFGR_PLLSRC_HSE) | (PLL_Q << 24);
+    /* 配置main PLL */
+    RCC->PLLCFGR = PLL_M | (PLL_N << 6) | (((PLL_P >> 1) -1) << 16) |
+                   (RCC_PLLCFGR_PLLSRC_HSE) | (PLL_Q << 24);
 #endif /* STM32F40_41xxx || STM32F401xx || STM32F427_437x || STM32F429_439xx || STM32F469_479xx */
 
 #if  defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx)
-        /* 配置main PLL */
-        RCC->PLLCFGR = PLL_M | (PLL_N << 6) | (((PLL_P >> 1) -1) << 16) |
-                       (RCC_PLLCFGR_PLLSRC_HSE) | (PLL_Q << 24) | (PLL_R << 28);
+    /* 配置main PLL */
+    RCC->PLLCFGR = PLL_M | (PLL_N << 6) | (((PLL_P >> 1) -1) << 16) |
+                   (RCC_PLLCFGR_PLLSRC_HSE) | (PLL_Q << 24) | (PLL_R << 28);
 #endif /* STM32F412xG || STM32F413_423xx || STM32F446xx */
+}
 
-        /* 启用主 PLL */
-        RCC->CR |= RCC_CR_PLLON;
+/**
+  * 简介:  启动 HSE, 不等待就绪
+  * @Note   定义 SYSCLK_ASYNC 时由 SystemInit 调用, 之后系统仍运行在 HSI 上, HSE 起振期间
+  *         可以继续执行 .data/.bss 初始化和不依赖高速时钟的初始化.
+  * 参数:  无
+  * 返回值: 无
+  */
+void SystemClock_Start(void) {
+    /* Enable HSE */
+    RCC->CR |= ((uint32_t)RCC_CR_HSEON);
+}
 
-        /* 等待主 PLL 准备就绪 */
-        while((RCC->CR & RCC_CR_PLLRDY) == 0) {
-        }
+/**
+  * 简介:  推进一步时钟切换, 不阻塞
+  * @Note   进度全部从 RCC/PWR 寄存器读出, 不读写 RAM 变量(包括 SystemCoreClock), 在 .data/.bss
+  *         初始化前后调用都可以; 返回 SYSCLK_READY 后由调用者在 .data 初始化之后调用 SystemCoreClockUpdate.
+  *         Over-drive 的建立与 PLL 锁定同时进行(参考手册允许在 PLLON 之后、PLL 锁定之前设置 ODEN/ODSWEN).
+  * 参数:  无
+  * 返回值: SYSCLK_BUSY: 还在等待某个就绪标志; SYSCLK_READY: 已切换到 PLL
+  */
+uint8_t SystemClock_Poll(void) {
+    if ((RCC->CFGR & (uint32_t)RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL) {
+        return SYSCLK_READY;
+    }
+
+    if ((RCC->CR & RCC_CR_HSERDY) == 0) {
+        return SYSCLK_BUSY;
+    }
+
+    /* HSE 就绪后再配置调节器、预分频器和 PLL, 然后启用主 PLL */
+    if ((RCC->CR & RCC_CR_PLLON) == 0) {
+        SystemClock_Config();
+        RCC->CR |= RCC_CR_PLLON;
+    }
 
 #if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
-        /* 启用 Over-drive 将时钟频率扩展到 180 Mhz */
+    /* 启用 Over-drive 将时钟频率扩展到 180 Mhz */
+    if ((PWR->CR & PWR_CR_ODEN) == 0) {
         PWR->CR |= PWR_CR_ODEN;
-        while((PWR->CSR & PWR_CSR_ODRDY) == 0) {
-        }
+    }
+
+    if ((PWR->CSR & PWR_CSR_ODRDY) == 0) {
+        return SYSCLK_BUSY;
+    }
+
+    if ((PWR->CR & PWR_CR_ODSWEN) == 0) {
         PWR->CR |= PWR_CR_ODSWEN;
-        while((PWR->CSR & PWR_CSR_ODSWRDY) == 0) {
-        }
-        /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
-        FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_5WS;
+    }
+
+    if ((PWR->CSR & PWR_CSR_ODSWRDY) == 0) {
+        return SYSCLK_BUSY;
+    }
 #endif /* STM32F427_437x || STM32F429_439xx || STM32F446xx || STM32F469_479xx */
 
-#if defined(STM32F40_41xxx)  || defined(STM32F412xG)
-        /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
-        FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_5WS;
-#endif /* STM32F40_41xxx  || STM32F412xG */
+    /* 等待主 PLL 准备就绪 */
+    if ((RCC->CR & RCC_CR_PLLRDY) == 0) {
+        return SYSCLK_BUSY;
+    }
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx) || defined(STM32F412xG)
+    /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
+    FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_5WS;
+#endif /* STM32F40_41xxx || STM32F427_437x || STM32F429_439xx || STM32F446xx || STM32F469_479xx || STM32F412xG */
 
 #if defined(STM32F413_423xx)
-        /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
-        FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_3WS;
+    /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
+    FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_3WS;
 #endif /* STM32F413_423xx */
 
 #if defined(STM32F401xx)
-        /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
-        FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_2WS;
+    /* 配置闪存预取、指令缓存、数据缓存和等待状态 */
+    FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN |FLASH_ACR_DCEN |FLASH_ACR_LATENCY_2WS;
 #endif /* STM32F401xx */
 
-        /* 选择主 PLL 作为系统时钟源           */
-        RCC->CFGR &= (uint32_t)((uint32_t)~(RCC_CFGR_SW));
-        RCC->CFGR |= RCC_CFGR_SW_PLL;
+    /* 选择主 PLL 作为系统时钟源           */
+    RCC->CFGR &= (uint32_t)((uint32_t)~(RCC_CFGR_SW));
+    RCC->CFGR |= RCC_CFGR_SW_PLL;
 
-        /* 等待主 PLL 用作系统时钟源           */
-        while ((RCC->CFGR & (uint32_t)RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL);
-        {
+    /* 等待主 PLL 用作系统时钟源           */
+    while ((RCC->CFGR & (uint32_t)RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL) {
+    }
+
+    return SYSCLK_READY;
+}
+
+/**
+  * 简介:  等待时钟切换完成
+  * 参数:  无
+  * @Note   与 SystemClock_Poll 一样不更新 SystemCoreClock.
+  * 返回值: SYSCLK_READY: 已切换到 PLL; SYSCLK_HSE_FAIL: HSE 在 HSE_STARTUP_TIMEOUT 次查询内未起振,
+  *         关闭 HSE, 系统继续运行在 HSI 上, 调节器和预分频器保持复位值
+  */
+uint8_t SystemClock_Wait(void) {
+    uint32_t StartUpCounter = 0;
+    uint8_t status;
+
+    while ((status = SystemClock_Poll()) == SYSCLK_BUSY) {
+        if ((RCC->CR & RCC_CR_HSERDY) == 0 && ++StartUpCounter == HSE_STARTUP_TIMEOUT) {
+            /* 如果 HSE未能启动，应用程序将具有错误的时钟配置。用户可以在此处添加一些代码来处理此错误 */
+            RCC->CR &= ~RCC_CR_HSEON;
+            return SYSCLK_HSE_FAIL;
         }
-    } else {
-        /* 如果 HSE未能启动，应用程序将具有错误的时钟配置。用户可以在此处添加一些代码来处理此错误 */
     }
+
+    return status;
+}
+#else
+void SystemClock_Start(void) {
+    SetSysClock();
+}
+
+uint8_t SystemClock_Poll(void) {
+    return SYSCLK_READY;
+}
+
+uint8_t SystemClock_Wait(void) {
+    return SYSCLK_READY;
+}
+#endif /* STM32F40_41xxx || STM32F427_437x || STM32F429_439xx || STM32F401xx || STM32F412xG || STM32F413_423xx || STM32F446xx || STM32F469_479xx */
+
+/**
+  * 简介:  配置系统时钟源, PLL 乘法器和除法器因子，
+  *         AHB/APBx 预分频器和 Flash 设置
+  * @Note   这个函数应该只在 RCC 时钟配置重置为默认重置状态(在 SystemInit() 函数中完成)时调用。
+  * 参数:  无
+  * 返回值: 无
+  */
+static void SetSysClock(void) {
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F401xx) || defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx)|| defined(STM32F469_479xx)
+    /******************************************************************************/
+    /*            PLL (clocked by HSE) 用作系统时钟源                          */
+    /******************************************************************************/
+    SystemClock_Start();
+    (void)SystemClock_Wait();
 #elif defined(STM32F410xx) || defined(STM32F411xE)
 #if defined(USE_HSE_BYPASS)
     /******************************************************************************/
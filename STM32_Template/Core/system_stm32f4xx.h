@@ -56,6 +56,10 @@ extern uint32_t SystemCoreClock;          /*!< 系统时钟频率(核心时钟)
 /** @addtogroup STM32F4xx_System_Exported_Constants
   */
 
+#define SYSCLK_BUSY         0   /*!< 还在等待 HSE/Over-drive/PLL 就绪 */
+#define SYSCLK_READY        1   /*!< 已切换到 PLL */
+#define SYSCLK_HSE_FAIL     2   /*!< HSE 未起振, 仍运行在 HSI 上 */
+
 
 /** @addtogroup STM32F4xx_System_Exported_Macros
   */
@@ -66,6 +70,9 @@ extern uint32_t SystemCoreClock;          /*!< 系统时钟频率(核心时钟)
 
 extern void SystemInit(void);
 extern void SystemCoreClockUpdate(void);
+extern void SystemClock_Start(void);
+extern uint8_t SystemClock_Poll(void);
+extern uint8_t SystemClock_Wait(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,296 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : audio_stream.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : I2S2 全双工低延迟音频流
+                   发送和接收 DMA 都工作在双缓冲模式, 同一时钟、同一时刻启动,
+                   只用接收完成中断驱动: 接收刚写满的一半 + 发送空闲的一半
+                   一起交给 DSP 回调, 不做任何拷贝.
+  * Function List:
+
+  **********************************************************
+ */
+#include "audio_stream.h"
+#include "mem_init.h"
+
+/* DMA 缓冲在 SRAM2, 中断中使用的状态在 CCM, 两者不争用同一总线从口 */
+static int16_t audio_rx_buf[2][AUDIO_PERIOD_SAMPLES] MEM_DMA_BUF;
+static int16_t audio_tx_buf[2][AUDIO_PERIOD_SAMPLES] MEM_DMA_BUF;
+
+static Audio_ProcessCallback audio_callback MEM_CCM;
+static Audio_Stats audio_stats MEM_CCM;
+static uint32_t audio_last_tx MEM_CCM;          //上一次写入的发送半缓冲
+static uint32_t audio_last_stamp MEM_CCM;       //上一次接收完成时的 DWT 计数
+static uint32_t audio_period_avg MEM_CCM;       //实测周期长度(CPU 周期), 放大 16 倍
+static uint32_t audio_period_nominal MEM_CCM;   //名义周期长度(CPU 周期)
+static uint8_t  audio_stamp_valid MEM_CCM;
+
+/**
+  * @Name    Audio_DMAConfig
+  * @brief   配置一个双缓冲 DMA 流
+  * @param   Stream: DMA 流
+  * @param   Channel: DMA 通道
+  * @param   Periph: 外设数据寄存器地址
+  * @param   Buf: 两个周期缓冲
+  * @param   Dir: DMA_DIR_MemoryToPeripheral / DMA_DIR_PeripheralToMemory
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void Audio_DMAConfig(DMA_Stream_TypeDef *Stream, uint32_t Channel, uint32_t Periph,
+                            int16_t (*Buf)[AUDIO_PERIOD_SAMPLES], uint32_t Dir) {
+    DMA_InitTypeDef dma;
+
+    DMA_DeInit(Stream);
+    DMA_StructInit(&dma);
+    dma.DMA_Channel = Channel;
+    dma.DMA_PeripheralBaseAddr = Periph;
+    dma.DMA_Memory0BaseAddr = (uint32_t)Buf[0];
+    dma.DMA_DIR = Dir;
+    dma.DMA_BufferSize = AUDIO_PERIOD_SAMPLES;
+    dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    dma.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    dma.DMA_Mode = DMA_Mode_Circular;
+    dma.DMA_Priority = DMA_Priority_VeryHigh;
+    dma.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_Init(Stream, &dma);
+    DMA_DoubleBufferModeConfig(Stream, (uint32_t)Buf[1], DMA_Memory_0);
+    DMA_DoubleBufferModeCmd(Stream, ENABLE);
+}
+
+/**
+  * @Name    Audio_Init
+  * @brief   初始化 I2S2 全双工、引脚和 DMA
+  * @param   Callback: DSP 回调, 在接收 DMA 中断中调用; NULL 时发送静音
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          I2S2 为主发送, 提供 CK/WS; I2S2ext 为从接收, 与主共用时钟,
+          因此收发采样严格同步, 不存在收发间漂移.
+ **/
+void Audio_Init(Audio_ProcessCallback Callback) {
+    GPIO_InitTypeDef gpio;
+    I2S_InitTypeDef i2s;
+    NVIC_InitTypeDef nvic;
+
+    audio_callback = Callback;
+
+    RCC_AHB1PeriphClockCmd(AUDIO_GPIO_CLK | RCC_AHB1Periph_DMA1, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_SPI2, ENABLE);
+
+#if defined(STM32F40_41xxx) || defined(STM32F401xx)
+    RCC_PLLI2SConfig(AUDIO_PLLI2S_N, AUDIO_PLLI2S_R);
+    RCC_I2SCLKConfig(RCC_I2S2CLKSource_PLLI2S);
+    RCC_PLLI2SCmd(ENABLE);
+
+    while(RCC_GetFlagStatus(RCC_FLAG_PLLI2SRDY) == RESET);
+
+#endif
+
+    gpio.GPIO_Mode = GPIO_Mode_AF;
+    gpio.GPIO_OType = GPIO_OType_PP;
+    gpio.GPIO_PuPd = GPIO_PuPd_NOPULL;
+    gpio.GPIO_Speed = GPIO_High_Speed;
+    gpio.GPIO_Pin = AUDIO_WS_PIN | AUDIO_CK_PIN | AUDIO_SD_PIN | AUDIO_EXT_SD_PIN;
+    GPIO_Init(AUDIO_GPIO, &gpio);
+    GPIO_PinAFConfig(AUDIO_GPIO, AUDIO_WS_SOURCE, AUDIO_AF);
+    GPIO_PinAFConfig(AUDIO_GPIO, AUDIO_CK_SOURCE, AUDIO_AF);
+    GPIO_PinAFConfig(AUDIO_GPIO, AUDIO_SD_SOURCE, AUDIO_AF);
+    GPIO_PinAFConfig(AUDIO_GPIO, AUDIO_EXT_SD_SOURCE, AUDIO_EXT_SD_AF);
+
+    SPI_I2S_DeInit(SPI2);
+    I2S_StructInit(&i2s);
+    i2s.I2S_Mode = I2S_Mode_MasterTx;
+    i2s.I2S_Standard = I2S_Standard_Phillips;
+    i2s.I2S_DataFormat = I2S_DataFormat_16b;
+    i2s.I2S_MCLKOutput = I2S_MCLKOutput_Disable;
+    i2s.I2S_AudioFreq = AUDIO_SAMPLE_RATE;
+    i2s.I2S_CPOL = I2S_CPOL_Low;
+    I2S_Init(SPI2, &i2s);
+    I2S_FullDuplexConfig(I2S2ext, &i2s);
+
+    Audio_DMAConfig(AUDIO_TX_STREAM, AUDIO_TX_CHANNEL, (uint32_t)&SPI2->DR,
+                    audio_tx_buf, DMA_DIR_MemoryToPeripheral);
+    Audio_DMAConfig(AUDIO_RX_STREAM, AUDIO_RX_CHANNEL, (uint32_t)&I2S2ext->DR,
+                    audio_rx_buf, DMA_DIR_PeripheralToMemory);
+    DMA_ITConfig(AUDIO_RX_STREAM, DMA_IT_TC, ENABLE);
+
+    nvic.NVIC_IRQChannel = AUDIO_RX_IRQn;
+    nvic.NVIC_IRQChannelPreemptionPriority = AUDIO_IRQ_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    audio_period_nominal = (uint32_t)((uint64_t)SystemCoreClock * AUDIO_PERIOD_FRAMES / AUDIO_SAMPLE_RATE);
+}
+
+/**
+  * @Name    Audio_Start
+  * @brief   同步启动收发
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          发送缓冲清零, 两路 DMA 都从 M0 开始; 先使能从机 I2S2ext,
+          再使能主机 I2S2, 主机输出第一个 WS 时收发同时开始.
+ **/
+void Audio_Start(void) {
+    uint32_t i;
+
+    for(i = 0; i < AUDIO_PERIOD_SAMPLES; i++) {
+        audio_tx_buf[0][i] = 0;
+        audio_tx_buf[1][i] = 0;
+    }
+
+    audio_stats.Periods = 0;
+    audio_stats.Overruns = 0;
+    audio_stats.Underruns = 0;
+    audio_stats.LastCycles = 0;
+    audio_stats.MaxCycles = 0;
+    audio_last_tx = 1;
+    audio_stamp_valid = 0;
+    audio_period_avg = audio_period_nominal << 4;
+
+    DMA_ClearITPendingBit(AUDIO_RX_STREAM, AUDIO_RX_IT_TC);
+    DMA_Cmd(AUDIO_RX_STREAM, ENABLE);
+    DMA_Cmd(AUDIO_TX_STREAM, ENABLE);
+    SPI_I2S_DMACmd(I2S2ext, SPI_I2S_DMAReq_Rx, ENABLE);
+    SPI_I2S_DMACmd(SPI2, SPI_I2S_DMAReq_Tx, ENABLE);
+
+    I2S_Cmd(I2S2ext, ENABLE);
+    I2S_Cmd(SPI2, ENABLE);
+}
+
+/**
+  * @Name    Audio_Stop
+  * @brief   停止收发, 可再次 Audio_Start
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Audio_Stop(void) {
+    I2S_Cmd(SPI2, DISABLE);
+    I2S_Cmd(I2S2ext, DISABLE);
+    SPI_I2S_DMACmd(SPI2, SPI_I2S_DMAReq_Tx, DISABLE);
+    SPI_I2S_DMACmd(I2S2ext, SPI_I2S_DMAReq_Rx, DISABLE);
+    DMA_Cmd(AUDIO_TX_STREAM, DISABLE);
+    DMA_Cmd(AUDIO_RX_STREAM, DISABLE);
+
+    while(DMA_GetCmdStatus(AUDIO_TX_STREAM) != DISABLE || DMA_GetCmdStatus(AUDIO_RX_STREAM) != DISABLE);
+
+    /* 下一次启动从 M0 开始 */
+    DMA_SetCurrDataCounter(AUDIO_TX_STREAM, AUDIO_PERIOD_SAMPLES);
+    DMA_SetCurrDataCounter(AUDIO_RX_STREAM, AUDIO_PERIOD_SAMPLES);
+    DMA_DoubleBufferModeConfig(AUDIO_TX_STREAM, (uint32_t)audio_tx_buf[1], DMA_Memory_0);
+    DMA_DoubleBufferModeConfig(AUDIO_RX_STREAM, (uint32_t)audio_rx_buf[1], DMA_Memory_0);
+}
+
+/**
+  * @Name    Audio_RX_IRQHandler
+  * @brief   接收 DMA 完成中断, 在 DMA1_Stream3_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          - 接收: CT 已切换, 刚写满的是另一半.
+          - 发送: 取当前没有在播放的一半; 如果和上次写的是同一半,
+            说明中间漏掉了一个周期, 发送端重复播放了旧数据.
+          - 回调结束后再检查 CT, 若 DMA 已切到正在处理的那一半则计一次 xrun.
+          - 同时用 DWT 测量相邻两次中断的间隔, 一阶低通后得到采样率漂移.
+ **/
+MEM_RAMFUNC void Audio_RX_IRQHandler(void) {
+    uint32_t rx, tx, now, cycles;
+
+    if(DMA_GetITStatus(AUDIO_RX_STREAM, AUDIO_RX_IT_TC) == RESET) return;
+
+    DMA_ClearITPendingBit(AUDIO_RX_STREAM, AUDIO_RX_IT_TC);
+
+    now = DWT->CYCCNT;
+
+    if(audio_stamp_valid) {
+        int32_t err = (int32_t)((now - audio_last_stamp) << 4) - (int32_t)audio_period_avg;
+        audio_period_avg += err >> 4;
+    }
+
+    audio_last_stamp = now;
+    audio_stamp_valid = 1;
+
+    rx = DMA_GetCurrentMemoryTarget(AUDIO_RX_STREAM) ^ 1;
+    tx = DMA_GetCurrentMemoryTarget(AUDIO_TX_STREAM) ^ 1;
+
+    if(tx == audio_last_tx) audio_stats.Underruns++;
+
+    audio_last_tx = tx;
+
+    if(audio_callback != 0) {
+        audio_callback(audio_rx_buf[rx], audio_tx_buf[tx], AUDIO_PERIOD_FRAMES);
+    } else {
+        uint32_t i;
+
+        for(i = 0; i < AUDIO_PERIOD_SAMPLES; i++) audio_tx_buf[tx][i] = 0;
+    }
+
+    if(DMA_GetCurrentMemoryTarget(AUDIO_RX_STREAM) == rx) audio_stats.Overruns++;
+
+    if(DMA_GetCurrentMemoryTarget(AUDIO_TX_STREAM) == tx) audio_stats.Underruns++;
+
+    cycles = DWT->CYCCNT - now;
+    audio_stats.LastCycles = cycles;
+
+    if(cycles > audio_stats.MaxCycles) audio_stats.MaxCycles = cycles;
+
+    audio_stats.Periods++;
+}
+
+/**
+  * @Name    Audio_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Audio_GetStats(Audio_Stats *Stats) {
+    *Stats = audio_stats;
+}
+
+/**
+  * @Name    Audio_GetRatePpm
+  * @brief   估计实际采样率相对名义值的偏差
+  * @param   None
+  * @retval  ppm, 正值表示音频时钟比名义值快(以 CPU 时钟为参考); Audio_Start 之前为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只做测量, 本模块不做任何补偿: 采样率由 PLLI2S 的整数分频决定, 运行中无法微调
+          (改 N/R 要先关 PLLI2S, 会打断音频). 跨时钟域的数据源/数据宿由调用者按此值补偿,
+          例如 USB 音频反馈端点上报, 或在回调中做异步重采样. 时间常数约 16 个周期.
+ **/
+int32_t Audio_GetRatePpm(void) {
+    int64_t nominal = (int64_t)audio_period_nominal << 4;
+
+    if(audio_period_avg == 0) return 0;
+
+    return (int32_t)((nominal - (int64_t)audio_period_avg) * 1000000 / (int64_t)audio_period_avg);
+}
@@ -0,0 +1,84 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : audio_stream.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : I2S2 全双工低延迟音频流(I2S2 主发送 + I2S2ext 从接收)
+  * Function List:
+                   Audio_Init
+                   Audio_Start
+                   Audio_Stop
+                   Audio_RX_IRQHandler
+                   Audio_GetStats
+                   Audio_GetRatePpm
+  ******************************************************
+**/
+
+#ifndef __AUDIO_STREAM_H_
+#define __AUDIO_STREAM_H_
+
+#include "stm32f4xx_conf.h"
+
+/* 周期长度(帧), 每帧左右声道各一个 16 位采样.
+   往返延迟约为 3 个周期: 接收 1 个 + 发送最多 2 个, 16 帧 @48kHz 约 1ms */
+#define AUDIO_PERIOD_FRAMES     16
+#define AUDIO_CHANNELS          2
+#define AUDIO_PERIOD_SAMPLES    (AUDIO_PERIOD_FRAMES * AUDIO_CHANNELS)
+#define AUDIO_SAMPLE_RATE       I2S_AudioFreq_48k
+
+/* PLLI2S: VCO 输入 1MHz 时 N=258, R=3 得到 86MHz, 48kHz 误差 -0.01% */
+#define AUDIO_PLLI2S_N          258
+#define AUDIO_PLLI2S_R          3
+
+/* 引脚: PB12 WS, PB13 CK, PB15 SD(发送), PB14 ext_SD(接收) */
+#define AUDIO_GPIO              GPIOB
+#define AUDIO_GPIO_CLK          RCC_AHB1Periph_GPIOB
+#define AUDIO_WS_PIN            GPIO_Pin_12
+#define AUDIO_CK_PIN            GPIO_Pin_13
+#define AUDIO_EXT_SD_PIN        GPIO_Pin_14
+#define AUDIO_SD_PIN            GPIO_Pin_15
+#define AUDIO_WS_SOURCE         GPIO_PinSource12
+#define AUDIO_CK_SOURCE         GPIO_PinSource13
+#define AUDIO_EXT_SD_SOURCE     GPIO_PinSource14
+#define AUDIO_SD_SOURCE         GPIO_PinSource15
+#define AUDIO_AF                GPIO_AF_SPI2
+#define AUDIO_EXT_SD_AF         ((uint8_t)0x06)     //I2S2ext_SD 为 AF6
+
+/* DMA1: Stream4 通道0 = SPI2_TX, Stream3 通道3 = I2S2_EXT_RX */
+#define AUDIO_TX_STREAM         DMA1_Stream4
+#define AUDIO_TX_CHANNEL        DMA_Channel_0
+#define AUDIO_RX_STREAM         DMA1_Stream3
+#define AUDIO_RX_CHANNEL        DMA_Channel_3
+#define AUDIO_RX_IT_TC          DMA_IT_TCIF3
+#define AUDIO_RX_IRQn           DMA1_Stream3_IRQn
+#define AUDIO_IRQ_PRIORITY      1
+
+/* DSP 回调: In 为刚接收完的一个周期, Out 为发送端空闲的一个周期,
+   均为交织的左右声道, 直接在 DMA 缓冲上处理, 回调内不得访问外设.
+   Audio_GetRatePpm 只给出采样率偏差的估计, 需要补偿时在回调中或数据源端自行处理 */
+typedef void (*Audio_ProcessCallback)(const int16_t *In, int16_t *Out, uint32_t Frames);
+
+/* 运行统计 */
+typedef struct {
+    uint32_t Periods;           //已处理的周期数
+    uint32_t Overruns;          //接收: 处理未完成时 DMA 已写回同一半
+    uint32_t Underruns;         //发送: 播放了未刷新的一半
+    uint32_t LastCycles;        //最近一次回调耗时(CPU 周期)
+    uint32_t MaxCycles;         //回调最大耗时
+} Audio_Stats;
+
+void Audio_Init(Audio_ProcessCallback Callback);
+void Audio_Start(void);
+void Audio_Stop(void);
+void Audio_RX_IRQHandler(void);
+void Audio_GetStats(Audio_Stats *Stats);
+int32_t Audio_GetRatePpm(void);
+
+#endif
@@ -0,0 +1,143 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : boot_seq.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 启动顺序与启动计时
+                   1. SystemInit 在复位后立即打开 DWT 周期计数器, 第一条记录"reset"覆盖
+                      SystemInit 和 .data/.bss 初始化, 即复位到 main 的时间;
+                   2. Boot_Run 先按表顺序执行 BOOT_ANY_CLOCK 步骤, 每步之后调用一次 SystemClock_Poll,
+                      再等待时钟切换完成(记录为"sysclk"), 最后执行 BOOT_NEED_CLOCK 步骤;
+                   3. 时钟切换前后 HCLK 不同, 每条记录保存执行时的 SystemCoreClock 以便换算;
+                   4. BOOT_LAZY 外设第一次 Boot_Require 时初始化, 耗时同样记入计时表.
+  * Function List:
+
+  **********************************************************
+ */
+#include "boot_seq.h"
+
+static Boot_Trace boot_trace[BOOT_TRACE_MAX];
+static uint8_t boot_num;
+
+static void Boot_Record(const char *Name, uint32_t Start, uint32_t Cycles) {
+    if(boot_num >= BOOT_TRACE_MAX) return;
+
+    boot_trace[boot_num].Name = Name;
+    boot_trace[boot_num].Start = Start;
+    boot_trace[boot_num].Cycles = Cycles;
+    boot_trace[boot_num].Hclk = SystemCoreClock;
+    boot_num++;
+}
+
+/**
+  * @Name    Boot_Run
+  * @brief   执行启动步骤
+  * @param   Steps: 步骤表
+  * @param   Num: 步骤数
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          应在 main 开头调用. 复位后 HCLK 为 HSI(16MHz), BOOT_ANY_CLOCK 步骤不能根据
+          SystemCoreClock 计算分频. HSE 起振失败时系统停在 HSI, "sysclk"记录的 Hclk 为 16MHz.
+ **/
+void Boot_Run(const Boot_Step *Steps, uint8_t Num) {
+    uint32_t t;
+    uint8_t i;
+
+    /* 复位到 main: SystemInit + .data/.bss 初始化, .data 把 SystemCoreClock 恢复成了编译时的值 */
+    SystemCoreClockUpdate();
+
+    if(boot_num == 0) Boot_Record("reset", 0, DWT->CYCCNT);
+
+    for(i = 0; i < Num; i++) {
+        if(Steps[i].Clock != BOOT_ANY_CLOCK) continue;
+
+        t = DWT->CYCCNT;
+        Steps[i].Func();
+        Boot_Record(Steps[i].Name, t, DWT->CYCCNT - t);
+
+        /* SystemClock_Poll 不写 SystemCoreClock, 切换完成后由这里更新, 之后的记录按新的 HCLK 换算 */
+        if(SystemClock_Poll() == SYSCLK_READY) SystemCoreClockUpdate();
+    }
+
+    t = DWT->CYCCNT;
+    (void)SystemClock_Wait();
+    SystemCoreClockUpdate();
+    Boot_Record("sysclk", t, DWT->CYCCNT - t);
+
+    for(i = 0; i < Num; i++) {
+        if(Steps[i].Clock == BOOT_ANY_CLOCK) continue;
+
+        t = DWT->CYCCNT;
+        Steps[i].Func();
+        Boot_Record(Steps[i].Name, t, DWT->CYCCNT - t);
+    }
+}
+
+/**
+  * @Name    Boot_Mark
+  * @brief   记录一个时间点, 如第一次进入控制循环
+  * @param   Name: 名称, 须为常量字符串
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Boot_Mark(const char *Name) {
+    Boot_Record(Name, DWT->CYCCNT, 0);
+}
+
+/**
+  * @Name    Boot_RequireSlow
+  * @brief   执行延迟初始化
+  * @param   Lazy: 外设
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          不要在中断里第一次使用延迟初始化的外设: 主循环正在初始化时中断再进入会重复初始化.
+ **/
+void Boot_RequireSlow(Boot_Lazy *Lazy) {
+    uint32_t t = DWT->CYCCNT;
+
+    Lazy->Init();
+    Lazy->Done = 1;
+    Boot_Record(Lazy->Name, t, DWT->CYCCNT - t);
+}
+
+/**
+  * @Name    Boot_GetTrace
+  * @brief   读取计时表
+  * @param   Trace: 输出表首地址
+  * @retval  记录数
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t Boot_GetTrace(const Boot_Trace **Trace) {
+    *Trace = boot_trace;
+    return boot_num;
+}
+
+/**
+  * @Name    Boot_CyclesToUs
+  * @brief   把一条记录的耗时换算成微秒
+  * @param   Trace: 记录
+  * @retval  微秒
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          "reset"和"sysclk"期间时钟有变化, 按记录时的 HCLK 换算只是近似值.
+ **/
+uint32_t Boot_CyclesToUs(const Boot_Trace *Trace) {
+    return (uint32_t)((uint64_t)Trace->Cycles * 1000000 / Trace->Hclk);
+}
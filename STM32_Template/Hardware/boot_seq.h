@@ -0,0 +1,74 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : boot_seq.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 启动顺序与启动计时
+                   按表执行初始化步骤: 不依赖系统时钟的步骤在 HSE 起振/PLL 锁定期间执行,
+                   每步之间推进一次时钟切换; 依赖系统时钟的步骤在切换完成后执行.
+                   每一步及任意标记点记录 DWT 周期计数(从复位开始), 外设可以用 BOOT_LAZY
+                   推迟到第一次使用时才初始化.
+                   system_stm32f4xx.c 中定义 SYSCLK_ASYNC 后才能与时钟切换并行, 否则 SystemInit
+                   已完成切换, 本模块只做计时.
+  * Function List:
+                   Boot_Run
+                   Boot_Mark
+                   Boot_RequireSlow
+                   Boot_GetTrace
+                   Boot_CyclesToUs
+  ******************************************************
+**/
+
+#ifndef __BOOT_SEQ_H_
+#define __BOOT_SEQ_H_
+
+#include "stm32f4xx_conf.h"
+
+#define BOOT_TRACE_MAX          32
+
+#define BOOT_ANY_CLOCK          0       //可以在 HSI 上运行: GPIO、DMA、RAM 表、软件初始化
+#define BOOT_NEED_CLOCK         1       //依赖最终系统时钟: 波特率、定时器、SysTick 等
+
+/* 初始化步骤 */
+typedef struct {
+    const char *Name;
+    void (*Func)(void);
+    uint8_t Clock;              //BOOT_ANY_CLOCK / BOOT_NEED_CLOCK
+} Boot_Step;
+
+/* 计时记录 */
+typedef struct {
+    const char *Name;
+    uint32_t Start;             //开始时的 DWT->CYCCNT
+    uint32_t Cycles;            //耗时(周期), 标记点为 0
+    uint32_t Hclk;              //执行时的 SystemCoreClock, 用于换算时间
+} Boot_Trace;
+
+/* 延迟初始化的外设 */
+typedef struct {
+    const char *Name;
+    void (*Init)(void);
+    volatile uint8_t Done;
+} Boot_Lazy;
+
+#define BOOT_LAZY(Var, Func)    Boot_Lazy Var = {#Func, Func, 0}
+
+void Boot_Run(const Boot_Step *Steps, uint8_t Num);
+void Boot_Mark(const char *Name);
+void Boot_RequireSlow(Boot_Lazy *Lazy);
+uint8_t Boot_GetTrace(const Boot_Trace **Trace);
+uint32_t Boot_CyclesToUs(const Boot_Trace *Trace);
+
+/* 第一次使用外设前调用, 已初始化时只有一次判断 */
+static __INLINE void Boot_Require(Boot_Lazy *Lazy) {
+    if(!Lazy->Done) Boot_RequireSlow(Lazy);
+}
+
+#endif
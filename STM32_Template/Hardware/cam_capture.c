@@ -0,0 +1,611 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : cam_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCMI 摄像头采集引擎
+                   1. 帧模式: DMA 普通模式, 一次传完一帧后在传输完成中断里切到另一块缓冲,
+                      帧消隐期内完成重装, 不丢数据; Cam_Process 正在使用的缓冲不会被 DMA 选中,
+                      两块都不可用时覆盖刚采完的帧并计一次丢帧;
+                   2. 行模式: DMA 双缓冲模式, 每完成一块就把空闲的地址寄存器改到环里的下一块,
+                      DMA 自身不停; 环满时改写到丢弃区, 不阻塞 DCMI;
+                   3. 每帧结束(DCMI FRAME)核对 DMA 位置, 帧长与配置不符时在消隐期重装 DMA,
+                      一帧错位不会带到后面的帧; FIFO 溢出丢了字, 本帧余下的数据整体错位,
+                      作废到帧结束再重装;
+                   4. 中断只做缓冲调度, 回调都在 Cam_Process(主循环)中执行.
+  * Function List:
+
+  **********************************************************
+ */
+#include "cam_capture.h"
+#include "mem_init.h"
+#include "string.h"
+
+/* 板级引脚: PA4 HSYNC, PA6 PCLK, PB7 VSYNC, PC6/PC7/PC8/PC9/PC11 D0~D4, PB6 D5, PE5/PE6 D6/D7 */
+static GPIO_TypeDef *const cam_pin_port[] = {GPIOA, GPIOA, GPIOB, GPIOC, GPIOC, GPIOC, GPIOC, GPIOC, GPIOB, GPIOE, GPIOE};
+static const uint8_t cam_pin_source[] = {4, 6, 7, 6, 7, 8, 9, 11, 6, 5, 6};
+
+static Cam_Config cam_cfg MEM_CCM;
+static Cam_Stats cam_stats MEM_CCM;
+static uint32_t cam_block_bytes MEM_CCM;
+static uint32_t cam_xfer_words MEM_CCM;         //一次 DMA 传输的字数: 帧模式一帧, 行模式一块
+static volatile uint8_t cam_skip MEM_CCM;       //FIFO 溢出后到帧结束前写满的数据作废
+static volatile uint8_t cam_snap MEM_CCM;       //帧进行中收到的快照请求, 帧结束时补发
+
+/* 帧模式 */
+static int8_t cam_filling MEM_CCM;              //DMA 正在写的缓冲
+static volatile int8_t cam_ready MEM_CCM;       //最新完整帧, -1 为无; 只由中断写
+static volatile uint32_t cam_ready_seq MEM_CCM;
+static volatile int8_t cam_held MEM_CCM;        //Cam_Process 正在使用的缓冲; 只由 Cam_Process 写
+static volatile uint32_t cam_taken_seq MEM_CCM; //最后交付的帧序号; 只由 Cam_Process 写
+
+/* 行模式: 块按编程顺序写完, cam_prog/cam_head/cam_tail 都是块序号(不取模) */
+static Cam_Block cam_block[CAM_RING_MAX] MEM_CCM;
+static uint32_t cam_prog MEM_CCM;               //已编程给 DMA 的块
+static volatile uint32_t cam_head MEM_CCM;      //已写满的块; 只由中断写
+static volatile uint32_t cam_tail MEM_CCM;      //已处理的块; 只由 Cam_Process 写
+static uint8_t cam_target[2] MEM_CCM;           //M0/M1 当前指向的块, RingBlocks 为丢弃区
+static uint16_t cam_line MEM_CCM;               //本帧已写入的行
+static uint32_t cam_frame MEM_CCM;
+static uint8_t cam_gap MEM_CCM;
+
+#define CAM_BLOCK_DROP          0x80    //作废的块, 保持块序号连续, Cam_Process 跳过
+
+MEM_RAMFUNC static uint8_t *Cam_BlockAddr(uint8_t Block) {
+    return cam_cfg.Ring + (uint32_t)Block * cam_block_bytes;
+}
+
+/**
+  * @Name    Cam_NextBlock
+  * @brief   取环中下一块给 DMA
+  * @param   None
+  * @retval  块号, 环满时为丢弃区
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          序号在 [cam_tail, cam_prog) 的块还没处理完, 个数不到 RingBlocks 时
+          cam_prog 对应的块一定空闲.
+ **/
+MEM_RAMFUNC static uint8_t Cam_NextBlock(void) {
+    uint8_t block;
+
+    if(cam_prog - cam_tail >= cam_cfg.RingBlocks) return cam_cfg.RingBlocks;
+
+    block = (uint8_t)(cam_prog % cam_cfg.RingBlocks);
+    cam_prog++;
+    return block;
+}
+
+/**
+  * @Name    Cam_DMAStop
+  * @brief   关闭 DMA 流并等待生效
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          重新使能前该流的全部标志都要清除, 半传输标志不开中断也会置位, 一并清掉.
+ **/
+MEM_RAMFUNC static void Cam_DMAStop(void) {
+    DMA_Cmd(CAM_DMA_STREAM, DISABLE);
+
+    while(DMA_GetCmdStatus(CAM_DMA_STREAM) != DISABLE);
+
+    DMA_ClearITPendingBit(CAM_DMA_STREAM, CAM_DMA_IT_ALL);
+}
+
+/**
+  * @Name    Cam_DMAArm
+  * @brief   从头装载 DMA, 调用前流已关闭
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧模式写 cam_filling; 行模式按 cam_target[0]、cam_target[1] 的顺序写, CT 清零.
+ **/
+MEM_RAMFUNC static void Cam_DMAArm(void) {
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        DMA_MemoryTargetConfig(CAM_DMA_STREAM, (uint32_t)cam_cfg.Frame[cam_filling], DMA_Memory_0);
+    } else {
+        DMA_MemoryTargetConfig(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[0]), DMA_Memory_0);
+        DMA_DoubleBufferModeConfig(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[1]), DMA_Memory_0);
+    }
+
+    DMA_SetCurrDataCounter(CAM_DMA_STREAM, (uint16_t)cam_xfer_words);
+    DMA_Cmd(CAM_DMA_STREAM, ENABLE);
+}
+
+/**
+  * @Name    Cam_Init
+  * @brief   初始化 DCMI、引脚和 DMA
+  * @param   Config: 采集配置, 内容被复制
+  * @retval  SUCCESS; 参数不合法时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DMA 使用 FIFO 和 4 拍突发写内存, 减少对总线矩阵的占用, 因此缓冲要 16 字节对齐、
+          每次传输长度是 16 字节的整数倍. DMA 访问不到 CCM, 缓冲在 CCM(含栈上的局部数组)时返回 ERROR.
+          DCMI 与 DMA 中断使用同一抢占优先级, 互不嵌套.
+ **/
+ErrorStatus Cam_Init(const Cam_Config *Config) {
+    GPIO_InitTypeDef gpio;
+    DCMI_InitTypeDef dcmi;
+    DCMI_CROPInitTypeDef crop;
+    DMA_InitTypeDef dma;
+    NVIC_InitTypeDef nvic;
+    uint32_t line_bytes, i;
+
+    line_bytes = (uint32_t)Config->Width * Config->BytesPerPixel;
+
+    if(Config->Width == 0 || Config->Height == 0 || (line_bytes & 3) != 0 ||
+            (Config->BytesPerPixel != 1 && Config->BytesPerPixel != 2)) return ERROR;
+
+    if(Config->Mode == CAM_MODE_FRAME) {
+        cam_xfer_words = line_bytes * Config->Height / 4;
+
+        if(Config->Frame[0] == 0 || Config->Frame[1] == 0 || Config->FrameCallback == 0 ||
+                (((uint32_t)Config->Frame[0] | (uint32_t)Config->Frame[1]) & 15) != 0 ||
+                MEM_IS_CCM(Config->Frame[0]) || MEM_IS_CCM(Config->Frame[1])) return ERROR;
+    } else if(Config->Mode == CAM_MODE_LINES) {
+        if(Config->LinesPerBlock == 0 || Config->Height % Config->LinesPerBlock != 0 ||
+                Config->RingBlocks < 3 || Config->RingBlocks > CAM_RING_MAX ||
+                Config->Ring == 0 || ((uint32_t)Config->Ring & 15) != 0 || MEM_IS_CCM(Config->Ring) ||
+                Config->LineCallback == 0) return ERROR;
+
+        cam_xfer_words = line_bytes * Config->LinesPerBlock / 4;
+    } else {
+        return ERROR;
+    }
+
+    if(cam_xfer_words > 0xFFFF || (cam_xfer_words & 3) != 0) return ERROR;
+
+    if(Config->Crop && line_bytes > 0x4000) return ERROR;
+
+    cam_cfg = *Config;
+    cam_block_bytes = cam_xfer_words * 4;
+
+    for(i = 0; i < cam_cfg.RingBlocks && cam_cfg.Mode == CAM_MODE_LINES; i++) {
+        cam_block[i].Data = Cam_BlockAddr((uint8_t)i);
+        cam_block[i].Lines = cam_cfg.LinesPerBlock;
+    }
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA | RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC |
+                           RCC_AHB1Periph_GPIOE | RCC_AHB1Periph_DMA2, ENABLE);
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_DCMI, ENABLE);
+
+    gpio.GPIO_Mode = GPIO_Mode_AF;
+    gpio.GPIO_OType = GPIO_OType_PP;
+    gpio.GPIO_PuPd = GPIO_PuPd_UP;
+    gpio.GPIO_Speed = GPIO_High_Speed;
+
+    for(i = 0; i < sizeof(cam_pin_source); i++) {
+        gpio.GPIO_Pin = (uint32_t)1 << cam_pin_source[i];
+        GPIO_Init(cam_pin_port[i], &gpio);
+        GPIO_PinAFConfig(cam_pin_port[i], cam_pin_source[i], GPIO_AF_DCMI);
+    }
+
+    DCMI_DeInit();
+    DCMI_StructInit(&dcmi);
+    dcmi.DCMI_CaptureMode = cam_cfg.Snapshot ? DCMI_CaptureMode_SnapShot : DCMI_CaptureMode_Continuous;
+    dcmi.DCMI_SynchroMode = DCMI_SynchroMode_Hardware;
+    dcmi.DCMI_PCKPolarity = cam_cfg.PCKPolarity;
+    dcmi.DCMI_VSPolarity = cam_cfg.VSPolarity;
+    dcmi.DCMI_HSPolarity = cam_cfg.HSPolarity;
+    dcmi.DCMI_CaptureRate = DCMI_CaptureRate_All_Frame;
+    dcmi.DCMI_ExtendedDataMode = DCMI_ExtendedDataMode_8b;
+    DCMI_Init(&dcmi);
+
+    if(cam_cfg.Crop) {
+        /* 8 位接口每个像素时钟一个字节, 水平方向按字节计 */
+        crop.DCMI_VerticalStartLine = cam_cfg.CropY;
+        crop.DCMI_HorizontalOffsetCount = (uint16_t)(cam_cfg.CropX * cam_cfg.BytesPerPixel);
+        crop.DCMI_VerticalLineCount = cam_cfg.Height - 1;
+        crop.DCMI_CaptureCount = (uint16_t)(line_bytes - 1);
+        DCMI_CROPConfig(&crop);
+        DCMI_CROPCmd(ENABLE);
+    }
+
+    DMA_DeInit(CAM_DMA_STREAM);
+    DMA_StructInit(&dma);
+    dma.DMA_Channel = CAM_DMA_CHANNEL;
+    dma.DMA_PeripheralBaseAddr = (uint32_t)&DCMI->DR;
+    dma.DMA_Memory0BaseAddr = cam_cfg.Mode == CAM_MODE_FRAME ? (uint32_t)cam_cfg.Frame[0] : (uint32_t)cam_cfg.Ring;
+    dma.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dma.DMA_BufferSize = cam_xfer_words;
+    dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    dma.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    dma.DMA_Mode = cam_cfg.Mode == CAM_MODE_FRAME ? DMA_Mode_Normal : DMA_Mode_Circular;
+    dma.DMA_Priority = DMA_Priority_High;
+    dma.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    dma.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    dma.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+    dma.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(CAM_DMA_STREAM, &dma);
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        DMA_DoubleBufferModeConfig(CAM_DMA_STREAM, (uint32_t)cam_cfg.Ring, DMA_Memory_0);
+        DMA_DoubleBufferModeCmd(CAM_DMA_STREAM, ENABLE);
+    }
+
+    DMA_ITConfig(CAM_DMA_STREAM, DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+    nvic.NVIC_IRQChannel = CAM_DMA_IRQn;
+    nvic.NVIC_IRQChannelPreemptionPriority = CAM_IRQ_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+    nvic.NVIC_IRQChannel = DCMI_IRQn;
+    NVIC_Init(&nvic);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    Cam_Start
+  * @brief   复位缓冲调度并开始采集
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          连续模式从下一个 VSYNC 开始采集; 快照模式只装好 DMA, 等 Cam_Snapshot.
+ **/
+void Cam_Start(void) {
+    memset(&cam_stats, 0, sizeof(cam_stats));
+    cam_filling = 0;
+    cam_ready = -1;
+    cam_ready_seq = 0;
+    cam_held = -1;
+    cam_taken_seq = 0;
+    cam_prog = 0;
+    cam_head = 0;
+    cam_tail = 0;
+    cam_line = 0;
+    cam_frame = 0;
+    cam_gap = 0;
+    cam_skip = 0;
+    cam_snap = 0;
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        cam_target[0] = Cam_NextBlock();
+        cam_target[1] = Cam_NextBlock();
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+
+    DCMI_ClearITPendingBit(DCMI_IT_FRAME | DCMI_IT_OVF);
+    DCMI_ITConfig(DCMI_IT_FRAME | DCMI_IT_OVF, ENABLE);
+    DCMI_Cmd(ENABLE);
+
+    if(!cam_cfg.Snapshot) DCMI_CaptureCmd(ENABLE);
+}
+
+/**
+  * @Name    Cam_Stop
+  * @brief   立即停止采集, 可再次 Cam_Start
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Cam_Stop(void) {
+    DCMI_CaptureCmd(DISABLE);
+    DCMI_ITConfig(DCMI_IT_FRAME | DCMI_IT_OVF, DISABLE);
+    DCMI_Cmd(DISABLE);
+    Cam_DMAStop();
+}
+
+/**
+  * @Name    Cam_Snapshot
+  * @brief   快照模式下采集下一帧
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DCMI 等到下一个 VSYNC 开始, 一帧结束后自动清除 CAPTURE.
+          裁剪时最后一块在帧结束前就已交付, 此时 CAPTURE 仍置位, 直接置位会被帧结束清掉,
+          所以记下请求由帧结束中断补发. 检查期间屏蔽帧中断.
+ **/
+void Cam_Snapshot(void) {
+    DCMI_ITConfig(DCMI_IT_FRAME, DISABLE);
+
+    if(DCMI->CR & DCMI_CR_CAPTURE) {
+        cam_snap = 1;
+    } else {
+        DCMI_CaptureCmd(ENABLE);
+    }
+
+    DCMI_ITConfig(DCMI_IT_FRAME, ENABLE);
+}
+
+/**
+  * @Name    Cam_Corrupted
+  * @brief   本次传输是否含溢出后的错位数据
+  * @param   None
+  * @retval  1: 作废
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          传输完成中断先于 DCMI 溢出中断处理时 cam_skip 还没置位, 直接看溢出原始标志.
+ **/
+MEM_RAMFUNC static uint8_t Cam_Corrupted(void) {
+    return cam_skip || DCMI_GetFlagStatus(DCMI_FLAG_OVFRI) != RESET;
+}
+
+/**
+  * @Name    Cam_FrameDone
+  * @brief   帧模式: 一帧传完, 选下一块缓冲并重装 DMA
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          另一块正被 Cam_Process 使用时只能覆盖刚采完的这块(丢弃它);
+          否则写另一块, 若那块是尚未交付的旧帧则它被丢弃. 溢出作废的帧原地重写.
+ **/
+MEM_RAMFUNC static void Cam_FrameDone(void) {
+    int8_t done = cam_filling;
+    int8_t other = done ^ 1;
+
+    cam_stats.Frames++;
+
+    if(cam_held == other || Cam_Corrupted()) {
+        cam_stats.FramesDropped++;
+    } else {
+        if(cam_ready == other && cam_ready_seq != cam_taken_seq) cam_stats.FramesDropped++;
+
+        cam_ready_seq = cam_stats.Frames;
+        cam_ready = done;
+        cam_filling = other;
+    }
+
+    Cam_DMAStop();
+    Cam_DMAArm();
+}
+
+/**
+  * @Name    Cam_BlockDone
+  * @brief   行模式: 一块写满, 登记并把空闲的地址寄存器改到下一块
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          CT 已切换, 刚写满的是另一个寄存器指向的块, DMA 此时正在写 cam_target[CT],
+          改写空闲寄存器是双缓冲模式允许的. 溢出作废的块照常登记(块按编程顺序写满),
+          带 CAM_BLOCK_DROP, 由 Cam_Process 跳过.
+ **/
+MEM_RAMFUNC static void Cam_BlockDone(void) {
+    uint32_t idle = DMA_GetCurrentMemoryTarget(CAM_DMA_STREAM) ^ 1;
+    uint8_t done = cam_target[idle];
+    uint8_t flags = cam_line == 0 ? CAM_BLOCK_FIRST : 0;
+    uint8_t bad = Cam_Corrupted();
+    uint32_t backlog;
+
+    cam_line += cam_cfg.LinesPerBlock;
+
+    if(cam_line >= cam_cfg.Height) flags |= CAM_BLOCK_LAST;
+
+    if(done < cam_cfg.RingBlocks) {
+        cam_block[done].Frame = cam_frame;
+        cam_block[done].Line = (uint16_t)(cam_line - cam_cfg.LinesPerBlock);
+        cam_block[done].Flags = bad ? CAM_BLOCK_DROP : flags | (cam_gap ? CAM_BLOCK_GAP : 0);
+        cam_head++;
+        backlog = cam_head - cam_tail;
+
+        if(backlog > cam_stats.MaxBacklog) cam_stats.MaxBacklog = backlog;
+    }
+
+    if(done >= cam_cfg.RingBlocks || bad) {
+        cam_stats.BlocksDropped++;
+
+        if(!cam_gap) cam_stats.FramesDropped++;
+
+        cam_gap = 1;
+    }
+
+    if(flags & CAM_BLOCK_LAST) {
+        cam_stats.Frames++;
+        cam_frame++;
+        cam_line = 0;
+        cam_gap = 0;
+    }
+
+    cam_target[idle] = Cam_NextBlock();
+    DMA_MemoryTargetConfig(CAM_DMA_STREAM, (uint32_t)Cam_BlockAddr(cam_target[idle]),
+                           idle ? DMA_Memory_1 : DMA_Memory_0);
+}
+
+/**
+  * @Name    Cam_DMA_IRQHandler
+  * @brief   DMA 中断, 在 DMA2_Stream1_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          传输错误只在缓冲地址不可访问时出现, 此时流已被硬件关闭, 计一次对齐错误后从头重装.
+ **/
+MEM_RAMFUNC void Cam_DMA_IRQHandler(void) {
+    if(DMA_GetITStatus(CAM_DMA_STREAM, CAM_DMA_IT_TE) != RESET) {
+        Cam_DMAStop();
+        cam_stats.SyncErrors++;
+        Cam_DMAArm();
+        return;
+    }
+
+    if(DMA_GetITStatus(CAM_DMA_STREAM, CAM_DMA_IT_TC) == RESET) return;
+
+    DMA_ClearITPendingBit(CAM_DMA_STREAM, CAM_DMA_IT_TC);
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        Cam_FrameDone();
+    } else {
+        Cam_BlockDone();
+    }
+}
+
+/**
+  * @Name    Cam_DCMI_IRQHandler
+  * @brief   DCMI 中断, 在 DCMI_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧结束时 DMA 应该刚好传完(最多还差 FIFO 中的几个字, 其完成中断随后到来)
+          或已经重装好等下一帧; 其他位置说明帧比配置短或长, 此时处于消隐期,
+          关掉 DMA 从本帧开头重装. 行模式下已交付的块保留, 下一块带 CAM_BLOCK_FIRST.
+          最后几个字常在进入本中断的过程中传完, 双缓冲模式的 NDTR 已重装, 所以先处理
+          挂起的传输完成再核对位置. 本帧溢出过时不核对, 直接重装.
+          重装时关一下 DCMI 清空其 FIFO, 否则上一帧残留的字会写到新缓冲开头.
+ **/
+MEM_RAMFUNC void Cam_DCMI_IRQHandler(void) {
+    uint32_t remain;
+    uint8_t ok;
+
+    if(DCMI_GetITStatus(DCMI_IT_OVF) != RESET) {
+        DCMI_ClearITPendingBit(DCMI_IT_OVF);
+        cam_stats.Overflows++;
+        cam_skip = 1;
+    }
+
+    if(DCMI_GetITStatus(DCMI_IT_FRAME) == RESET) return;
+
+    DCMI_ClearITPendingBit(DCMI_IT_FRAME);
+
+    if(cam_snap) {
+        cam_snap = 0;
+        DCMI_CaptureCmd(ENABLE);
+    }
+
+    if(DMA_GetITStatus(CAM_DMA_STREAM, CAM_DMA_IT_TC) != RESET) Cam_DMA_IRQHandler();
+
+    remain = DMA_GetCurrDataCounter(CAM_DMA_STREAM);
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        ok = remain == cam_xfer_words || remain <= CAM_FIFO_WORDS;
+    } else {
+        ok = (cam_line == 0 && remain == cam_xfer_words) ||
+             (cam_line == cam_cfg.Height - cam_cfg.LinesPerBlock && remain <= CAM_FIFO_WORDS);
+    }
+
+    if(ok && !cam_skip) return;
+
+    if(!cam_skip) cam_stats.SyncErrors++;
+
+    DCMI_Cmd(DISABLE);
+    Cam_DMAStop();
+
+    if(cam_cfg.Mode == CAM_MODE_LINES) {
+        /* 先编程的块放 M0, 保持块按编程顺序写满 */
+        uint32_t cur = DMA_GetCurrentMemoryTarget(CAM_DMA_STREAM);
+        uint8_t first = cam_target[cur];
+
+        cam_target[1] = cam_target[cur ^ 1];
+        cam_target[0] = first;
+
+        if(cam_gap == 0 && (cam_line != 0 || cam_skip)) cam_stats.FramesDropped++;
+
+        cam_line = 0;
+        cam_gap = 0;
+        cam_frame++;
+    }
+
+    cam_skip = 0;
+    Cam_DMAArm();
+    DCMI_Cmd(ENABLE);
+}
+
+/**
+  * @Name    Cam_Process
+  * @brief   把已采集的数据交给回调, 在主循环中调用
+  * @param   None
+  * @retval  交付的帧数(帧模式, 0 或 1)或块数(行模式)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          帧模式: 先登记 cam_held 再复查 cam_ready, 中断若在两者之间把这块选作 DMA 目标,
+          复查会发现 cam_ready 已变并重试; 登记之后中断不会再选它.
+          行模式: 回调返回后该块才归还, 回调期间 DMA 写的是环里的其他块;
+          只处理进入时已写满的块, 回调比传感器慢时也能回到主循环.
+ **/
+uint32_t Cam_Process(void) {
+    uint32_t n = 0, start, cycles, seq, head;
+    int8_t buf;
+
+    if(cam_cfg.Mode == CAM_MODE_FRAME) {
+        for(;;) {
+            buf = cam_ready;
+            seq = cam_ready_seq;
+
+            if(buf < 0 || seq == cam_taken_seq) return 0;
+
+            cam_held = buf;
+
+            if(cam_ready == buf && cam_ready_seq == seq) break;
+
+            cam_held = -1;
+        }
+
+        start = DWT->CYCCNT;
+        cam_cfg.FrameCallback(cam_cfg.Frame[buf], seq);
+        cycles = DWT->CYCCNT - start;
+        cam_taken_seq = seq;
+        cam_held = -1;
+        n = 1;
+    } else {
+        start = DWT->CYCCNT;
+        head = cam_head;
+
+        while(cam_tail != head) {
+            if(!(cam_block[cam_tail % cam_cfg.RingBlocks].Flags & CAM_BLOCK_DROP)) {
+                cam_cfg.LineCallback(&cam_block[cam_tail % cam_cfg.RingBlocks]);
+                n++;
+            }
+
+            cam_tail++;
+        }
+
+        if(n == 0) return 0;
+
+        cycles = DWT->CYCCNT - start;
+    }
+
+    cam_stats.Delivered += n;
+    cam_stats.LastCycles = cycles;
+
+    if(cycles > cam_stats.MaxCycles) cam_stats.MaxCycles = cycles;
+
+    return n;
+}
+
+/**
+  * @Name    Cam_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Cam_GetStats(Cam_Stats *Stats) {
+    *Stats = cam_stats;
+}
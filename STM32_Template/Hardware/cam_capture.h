@@ -0,0 +1,118 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : cam_capture.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCMI 摄像头采集引擎(DMA2 Stream1 通道1)
+                   CAM_MODE_FRAME: 两个整帧缓冲乒乓, Cam_Process 交出最新的完整帧;
+                   CAM_MODE_LINES: 帧大于内存时使用, DMA 双缓冲模式在行块环上循环,
+                   每写满一块(若干行)就交给行回调做流式处理(缩放、二值化、送压缩).
+                   摄像头寄存器(SCCB)由调用者配置, 本模块只管 DCMI/DMA.
+                   离线验证: Tools/cam_pipeline_sim.py 在主机上编译本文件和 DMA/DCMI 库,
+                   接到寄存器模型和合成传感器上运行.
+  * Function List:
+                   Cam_Init
+                   Cam_Start
+                   Cam_Stop
+                   Cam_Snapshot
+                   Cam_Process
+                   Cam_DCMI_IRQHandler
+                   Cam_DMA_IRQHandler
+                   Cam_GetStats
+  ******************************************************
+**/
+
+#ifndef __CAM_CAPTURE_H_
+#define __CAM_CAPTURE_H_
+
+#include "stm32f4xx_conf.h"
+
+/* DMA2: Stream1 通道1 = DCMI */
+#define CAM_DMA_STREAM          DMA2_Stream1
+#define CAM_DMA_CHANNEL         DMA_Channel_1
+#define CAM_DMA_IT_TC           DMA_IT_TCIF1
+#define CAM_DMA_IT_TE           DMA_IT_TEIF1
+#define CAM_DMA_IT_ALL          (DMA_IT_TCIF1 | DMA_IT_HTIF1 | DMA_IT_TEIF1 | DMA_IT_DMEIF1 | DMA_IT_FEIF1)
+#define CAM_DMA_IRQn            DMA2_Stream1_IRQn
+#define CAM_IRQ_PRIORITY        2
+
+#define CAM_RING_MAX            32      //行块环最多块数
+#define CAM_FIFO_WORDS          8       //DCMI FIFO 深度(字), 帧结束时 DMA 最多落后这么多
+
+#define CAM_MODE_FRAME          0
+#define CAM_MODE_LINES          1
+
+/* 行块标志 */
+#define CAM_BLOCK_FIRST         0x01    //帧的第一块
+#define CAM_BLOCK_LAST          0x02    //帧的最后一块, 该块被丢弃时以下一帧的 FIRST 为帧边界
+#define CAM_BLOCK_GAP           0x04    //本帧此前有块因环满或 FIFO 溢出被丢弃
+
+/* 行模式下环所需字节数: Blocks 块 + 1 块丢弃区 */
+#define CAM_RING_BYTES(LineBytes, LinesPerBlock, Blocks) \
+    ((uint32_t)(LineBytes) * (LinesPerBlock) * ((Blocks) + 1))
+
+/* 交给行回调的一块, Data 在回调返回后即交还 DMA */
+typedef struct {
+    const uint8_t *Data;
+    uint32_t Frame;             //帧序号
+    uint16_t Line;              //首行行号(裁剪后)
+    uint16_t Lines;
+    uint8_t  Flags;             //CAM_BLOCK_xxx
+} Cam_Block;
+
+typedef void (*Cam_FrameCallback)(const uint8_t *Frame, uint32_t Seq);
+typedef void (*Cam_LineCallback)(const Cam_Block *Block);
+
+/* 采集配置, 所有缓冲须 16 字节对齐且 DMA 可访问(不能放 CCM) */
+typedef struct {
+    uint16_t Width;             //像素, 开裁剪时为裁剪窗口宽度
+    uint16_t Height;            //行
+    uint8_t  BytesPerPixel;     //1: Y8/RAW, 2: RGB565/YUV422
+    uint8_t  Mode;              //CAM_MODE_FRAME / CAM_MODE_LINES
+    uint8_t  Snapshot;          //1: 快照, 每次 Cam_Snapshot 采一帧; 0: 连续
+    uint8_t  Crop;              //1: 按 CropX/CropY 开窗
+    uint16_t CropX;             //窗口左上角, 像素
+    uint16_t CropY;             //行
+    uint16_t PCKPolarity;       //DCMI_PCKPolarity_xxx
+    uint16_t VSPolarity;        //DCMI_VSPolarity_xxx
+    uint16_t HSPolarity;        //DCMI_HSPolarity_xxx
+    /* CAM_MODE_FRAME */
+    uint8_t *Frame[2];          //各 Width * Height * BytesPerPixel 字节, 不超过 256KB
+    Cam_FrameCallback FrameCallback;
+    /* CAM_MODE_LINES */
+    uint8_t *Ring;              //CAM_RING_BYTES 字节
+    uint16_t LinesPerBlock;     //Height 须为其整数倍
+    uint8_t  RingBlocks;        //3~CAM_RING_MAX
+    Cam_LineCallback LineCallback;
+} Cam_Config;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t Frames;            //完整采到的帧
+    uint32_t Delivered;         //交给回调的帧(帧模式)或块(行模式)
+    uint32_t FramesDropped;     //帧模式: 未交付即被覆盖或因溢出作废; 行模式: 有块被丢弃的帧
+    uint32_t BlocksDropped;     //行模式: 环满写入丢弃区或因溢出作废的块
+    uint32_t SyncErrors;        //帧长度与配置不符, 已重新对齐
+    uint32_t Overflows;         //DCMI FIFO 溢出, 本帧余下的数据作废
+    uint32_t MaxBacklog;        //行模式: 待处理块数最大值
+    uint32_t LastCycles;        //最近一次回调耗时(CPU 周期)
+    uint32_t MaxCycles;
+} Cam_Stats;
+
+ErrorStatus Cam_Init(const Cam_Config *Config);
+void Cam_Start(void);
+void Cam_Stop(void);
+void Cam_Snapshot(void);
+uint32_t Cam_Process(void);
+void Cam_DCMI_IRQHandler(void);
+void Cam_DMA_IRQHandler(void);
+void Cam_GetStats(Cam_Stats *Stats);
+
+#endif
@@ -0,0 +1,273 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_bus.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 中断驱动的 CAN 收发, bxCAN 寄存器部分
+                   1. 接收中断直接读邮箱寄存器, 一次把硬件 FIFO(3 级)读空, 每帧读进
+                      CANQueue_RxSlot 给出的环形缓冲区空位;
+                   2. 发送完成中断清标志后把完成的邮箱交给 CANQueue_TxDone, 写邮箱和中止请求
+                      由 Common/can_queue.c 经回调发起;
+                   3. 队列状态放 CCM, 中断路径用 MEM_RAMFUNC 从 SRAM1 执行
+                      (can_queue.o 由 Template.sct 放入 SRAM1).
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_bus.h"
+#include "mem_init.h"
+#include "string.h"
+
+/* 中断路径上的状态放 CCM, 函数用 MEM_RAMFUNC 从 SRAM1 执行 */
+static CANQueue cb_bus[2] MEM_CCM;
+static CAN_TypeDef *const cb_can[2] = {CAN1, CAN2};
+
+MEM_RAMFUNC static CANQueue *CANBus_Get(CAN_TypeDef *CANx) {
+    return &cb_bus[CANx == CAN2 ? 1 : 0];
+}
+
+/**
+  * @Name    CANBus_Write
+  * @brief   写发送邮箱并请求发送
+  * @param   Q: 队列
+  * @param   Mailbox: 0~2
+  * @param   Frame: 帧
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+MEM_RAMFUNC static void CANBus_Write(CANQueue *Q, uint8_t Mailbox, const CANBus_Frame *Frame) {
+    CAN_TxMailBox_TypeDef *box = &cb_can[Q - cb_bus]->sTxMailBox[Mailbox];
+    uint32_t word[2];
+
+    memcpy(word, Frame->Data, 8);
+
+    box->TDTR = Frame->Dlc & 0x0F;
+    box->TDLR = word[0];
+    box->TDHR = word[1];
+    box->TIR = (Frame->Ext ? ((Frame->Id << 3) | CAN_TI0R_IDE) : (Frame->Id << 21)) |
+               (Frame->Rtr ? CAN_TI0R_RTR : 0) | CAN_TI0R_TXRQ;
+}
+
+MEM_RAMFUNC static void CANBus_Abort(CANQueue *Q, uint8_t Mailbox) {
+    cb_can[Q - cb_bus]->TSR = CAN_TSR_ABRQ0 << (8 * Mailbox);
+}
+
+static const CANQueue_Port cb_port = {CANBus_Write, CANBus_Abort};
+
+/**
+  * @Name    CANBus_Init
+  * @brief   初始化 CAN、过滤器组和中断
+  * @param   CANx: CAN1 或 CAN2
+  * @param   InitStruct: 位时序等参数, 直接传给 CAN_Init
+  * @param   Table: CANFilter_Compile 的结果, NULL 时接收全部帧到类别 0
+  * @param   StartBank: 第一个过滤器组编号
+  * @retval  SUCCESS / ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器组由 CANFilter_Load 写入, CAN1 可用 StartBank ~ CAN2SB-1 组(复位值 14);
+          CAN2 会把 StartBank 写入 CAN2SB, 独占 StartBank ~ 27 组, 应先初始化 CAN1.
+ **/
+ErrorStatus CANBus_Init(CAN_TypeDef *CANx, CAN_InitTypeDef *InitStruct,
+                        const CANFilter_Table *Table, uint8_t StartBank) {
+    NVIC_InitTypeDef nvic;
+    uint8_t offset[2];
+    uint8_t irq[3];
+    uint8_t i;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    if(StartBank + Table->NumBanks > CANFILTER_MAX_BANKS) return ERROR;
+
+    /* 过滤器在 CAN1 中, 只用 CAN2 时也要打开 CAN1 时钟 */
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_CAN1, ENABLE);
+
+    if(CANx == CAN2) RCC_APB1PeriphClockCmd(RCC_APB1Periph_CAN2, ENABLE);
+
+    if(CAN_Init(CANx, InitStruct) != CAN_InitStatus_Success) return ERROR;
+
+    if(CANFilter_Load(CANx, Table, StartBank, offset) != SUCCESS) return ERROR;
+
+    CANQueue_Init(CANBus_Get(CANx), &cb_port, Table, offset);
+
+    if(CANx == CAN2) {
+        irq[0] = CAN2_RX0_IRQn;
+        irq[1] = CAN2_RX1_IRQn;
+        irq[2] = CAN2_TX_IRQn;
+    } else {
+        irq[0] = CAN1_RX0_IRQn;
+        irq[1] = CAN1_RX1_IRQn;
+        irq[2] = CAN1_TX_IRQn;
+    }
+
+    /* 三个中断同一优先级, 互不抢占 */
+    for(i = 0; i < 3; i++) {
+        nvic.NVIC_IRQChannel = irq[i];
+        nvic.NVIC_IRQChannelPreemptionPriority = CANBUS_IRQ_PRIORITY;
+        nvic.NVIC_IRQChannelSubPriority = 0;
+        nvic.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_Init(&nvic);
+    }
+
+    /* TMEIE 常开: 只有 RQCPx 置位时才进中断 */
+    CANx->IER |= CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1 | CAN_IER_TMEIE;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    CANBus_Send
+  * @brief   帧入发送队列
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Frame: 帧, Class 和 Time 不使用
+  * @retval  SUCCESS / ERROR(队列满)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只屏蔽本 CAN 的 TMEIE, 不关全局中断; 不可重入, 只能在一个上下文中调用.
+ **/
+ErrorStatus CANBus_Send(CAN_TypeDef *CANx, const CANBus_Frame *Frame) {
+    ErrorStatus status;
+
+    CANx->IER &= ~CAN_IER_TMEIE;
+    status = CANQueue_Send(CANBus_Get(CANx), Frame) ? SUCCESS : ERROR;
+    CANx->IER |= CAN_IER_TMEIE;
+
+    return status;
+}
+
+/**
+  * @Name    CANBus_Receive
+  * @brief   取一帧, 类别 0 优先
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Frame: 输出
+  * @retval  1: 取到; 0: 无数据
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint8_t CANBus_Receive(CAN_TypeDef *CANx, CANBus_Frame *Frame) {
+    return CANQueue_Receive(CANBus_Get(CANx), Frame);
+}
+
+/**
+  * @Name    CANBus_Drain
+  * @brief   读空一个接收 FIFO
+  * @param   CANx: CAN1 或 CAN2
+  * @param   FIFO: 0 或 1
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          环形缓冲区满时照样释放邮箱, 丢弃的帧由 CANQueue_RxSlot 计入 RxOverflow.
+ **/
+MEM_RAMFUNC static void CANBus_Drain(CAN_TypeDef *CANx, uint8_t FIFO) {
+    CANQueue *Q = CANBus_Get(CANx);
+    CAN_FIFOMailBox_TypeDef *box = &CANx->sFIFOMailBox[FIFO];
+    __IO uint32_t *rfr = FIFO ? &CANx->RF1R : &CANx->RF0R;
+    CANBus_Frame *f;
+    uint32_t rir, rdtr, word[2];
+
+    while(*rfr & CAN_RF0R_FMP0) {
+        rir = box->RIR;
+        rdtr = box->RDTR;
+        f = CANQueue_RxSlot(Q, FIFO, (uint8_t)((rdtr & CAN_RDT0R_FMI) >> 8));
+
+        if(f) {
+            f->Ext = (rir & CAN_RI0R_IDE) ? 1 : 0;
+            f->Id = f->Ext ? (rir >> 3) : (rir >> 21);
+            f->Rtr = (rir & CAN_RI0R_RTR) ? 1 : 0;
+            f->Dlc = (uint8_t)(rdtr & CAN_RDT0R_DLC);
+            f->Time = (uint16_t)(rdtr >> 16);
+            word[0] = box->RDLR;
+            word[1] = box->RDHR;
+            memcpy(f->Data, word, 8);
+
+            CANQueue_RxCommit(Q, f);
+        }
+
+        *rfr = CAN_RF0R_RFOM0;
+    }
+
+    if(*rfr & CAN_RF0R_FOVR0) {
+        CANQueue_FifoOverrun(Q, FIFO);
+        *rfr = CAN_RF0R_FOVR0;
+    }
+}
+
+/**
+  * @Name    CANBus_RX0_IRQHandler
+  * @brief   在 CANx_RX0_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+MEM_RAMFUNC void CANBus_RX0_IRQHandler(CAN_TypeDef *CANx) {
+    CANBus_Drain(CANx, 0);
+}
+
+/**
+  * @Name    CANBus_RX1_IRQHandler
+  * @brief   在 CANx_RX1_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+MEM_RAMFUNC void CANBus_RX1_IRQHandler(CAN_TypeDef *CANx) {
+    CANBus_Drain(CANx, 1);
+}
+
+/**
+  * @Name    CANBus_TX_IRQHandler
+  * @brief   在 CANx_TX_IRQHandler 中调用
+  * @param   CANx: CAN1 或 CAN2
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          清除完成标志后交给 CANQueue_TxDone, 被中止的帧在那里重新入队.
+ **/
+MEM_RAMFUNC void CANBus_TX_IRQHandler(CAN_TypeDef *CANx) {
+    uint32_t tsr = CANx->TSR;
+    uint8_t mb, done = 0, ok = 0;
+
+    for(mb = 0; mb < 3; mb++) {
+        if(!(tsr & (CAN_TSR_RQCP0 << (8 * mb)))) continue;
+
+        /* 清 RQCP 同时清 TXOK/ALST/TERR */
+        CANx->TSR = CAN_TSR_RQCP0 << (8 * mb);
+        done |= (uint8_t)(1U << mb);
+
+        if(tsr & (CAN_TSR_TXOK0 << (8 * mb))) ok |= (uint8_t)(1U << mb);
+    }
+
+    CANQueue_TxDone(CANBus_Get(CANx), done, ok);
+}
+
+/**
+  * @Name    CANBus_GetStats
+  * @brief   读取运行统计
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void CANBus_GetStats(CAN_TypeDef *CANx, CANBus_Stats *Stats) {
+    *Stats = CANBus_Get(CANx)->Stats;
+}
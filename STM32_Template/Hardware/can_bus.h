@@ -0,0 +1,50 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_bus.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 中断驱动的 CAN 收发
+                   接收: FIFO0/FIFO1 中断里把硬件 FIFO 读空, 按过滤器编号分类放入
+                         每个优先级类别一个的无锁环形缓冲区;
+                   发送: 按仲裁优先级排序的发送队列, 同时使用 3 个发送邮箱,
+                         更高优先级的帧到来时中止优先级最低的邮箱并重新排队.
+                   环形缓冲区、发送队列和邮箱调度在 Common/can_queue.c, 这里只管寄存器;
+                   CANBus_Frame / CANBus_Stats 见 can_queue.h.
+                   引脚复用由用户在调用 CANBus_Init 之前配置.
+  * Function List:
+                   CANBus_Init
+                   CANBus_Send
+                   CANBus_Receive
+                   CANBus_RX0_IRQHandler
+                   CANBus_RX1_IRQHandler
+                   CANBus_TX_IRQHandler
+                   CANBus_GetStats
+  ******************************************************
+**/
+
+#ifndef __CAN_BUS_H_
+#define __CAN_BUS_H_
+
+#include "stm32f4xx_conf.h"
+#include "can_filter_hw.h"
+#include "can_queue.h"
+
+#define CANBUS_IRQ_PRIORITY     1
+
+ErrorStatus CANBus_Init(CAN_TypeDef *CANx, CAN_InitTypeDef *InitStruct,
+                        const CANFilter_Table *Table, uint8_t StartBank);
+ErrorStatus CANBus_Send(CAN_TypeDef *CANx, const CANBus_Frame *Frame);
+uint8_t CANBus_Receive(CAN_TypeDef *CANx, CANBus_Frame *Frame);
+void CANBus_RX0_IRQHandler(CAN_TypeDef *CANx);
+void CANBus_RX1_IRQHandler(CAN_TypeDef *CANx);
+void CANBus_TX_IRQHandler(CAN_TypeDef *CANx);
+void CANBus_GetStats(CAN_TypeDef *CANx, CANBus_Stats *Stats);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : bxCAN 过滤器组写入
+  * Function List:
+
+  **********************************************************
+ */
+#include "can_filter_hw.h"
+#include "stddef.h"
+
+#define CANFILTER_FMR_CAN2SB    ((uint32_t)0x00003F00)
+
+/**
+  * @Name    CANFilter_Load
+  * @brief   装入过滤器组
+  * @param   CANx: CAN1 或 CAN2
+  * @param   Table: CANFilter_Compile 的结果, NULL 时用 CANFilter_AcceptAll
+  * @param   StartBank: 第一个过滤器组编号
+  * @param   FMIOffset: 输出, 每个 FIFO 中 StartBank 之前各组占用的过滤器编号数
+  * @retval  SUCCESS / ERROR(组数超出本 CAN 的范围)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          过滤器寄存器只在 CAN1 中. CAN1 可用 StartBank ~ CAN2SB-1 组(复位值 14);
+          CAN2 会把 StartBank 写入 CAN2SB, 独占 StartBank ~ 27 组, 应先装入 CAN1.
+          本 CAN 范围内未使用的组关闭.
+ **/
+ErrorStatus CANFilter_Load(CAN_TypeDef *CANx, const CANFilter_Table *Table, uint8_t StartBank,
+                           uint8_t FMIOffset[2]) {
+    const CANFilter_Bank *b;
+    uint8_t bank, end, fifo;
+    uint32_t bit;
+
+    if(Table == NULL) Table = &CANFilter_AcceptAll;
+
+    if(StartBank + Table->NumBanks > CANFILTER_MAX_BANKS) return ERROR;
+
+    CAN1->FMR |= CAN_FMR_FINIT;
+
+    if(CANx == CAN2) {
+        CAN1->FMR = (CAN1->FMR & ~CANFILTER_FMR_CAN2SB) | ((uint32_t)StartBank << 8);
+        end = CANFILTER_MAX_BANKS;
+    } else {
+        end = (uint8_t)((CAN1->FMR & CANFILTER_FMR_CAN2SB) >> 8);
+    }
+
+    if(StartBank + Table->NumBanks > end) {
+        CAN1->FMR &= ~CAN_FMR_FINIT;
+        return ERROR;
+    }
+
+    for(bank = StartBank; bank < end; bank++) {
+        bit = 1U << bank;
+        CAN1->FA1R &= ~bit;
+
+        if(bank >= StartBank + Table->NumBanks) continue;
+
+        b = &Table->Bank[bank - StartBank];
+
+        if(b->Mode == CANFILTER_MODE_LIST) CAN1->FM1R |= bit;
+        else CAN1->FM1R &= ~bit;
+
+        if(b->Scale == CANFILTER_SCALE_32BIT) CAN1->FS1R |= bit;
+        else CAN1->FS1R &= ~bit;
+
+        if(b->FIFO) CAN1->FFA1R |= bit;
+        else CAN1->FFA1R &= ~bit;
+
+        CAN1->sFilterRegister[bank].FR1 = b->FR1;
+        CAN1->sFilterRegister[bank].FR2 = b->FR2;
+        CAN1->FA1R |= bit;
+    }
+
+    /* FMI 在同一 FIFO 内跨所有组连续编号, 前面各组占用的编号:
+       32 位掩码 1 个, 32 位列表和 16 位掩码 2 个, 16 位列表 4 个 */
+    FMIOffset[0] = 0;
+    FMIOffset[1] = 0;
+
+    for(bank = 0; bank < StartBank; bank++) {
+        bit = 1U << bank;
+        fifo = (CAN1->FFA1R & bit) ? 1 : 0;
+
+        if(CAN1->FS1R & bit) FMIOffset[fifo] += (CAN1->FM1R & bit) ? 2 : 1;
+        else FMIOffset[fifo] += (CAN1->FM1R & bit) ? 4 : 2;
+    }
+
+    CAN1->FMR &= ~CAN_FMR_FINIT;
+
+    return SUCCESS;
+}
@@ -0,0 +1,29 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : can_filter_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 把 CANFilter_Compile 的结果写入 bxCAN 过滤器寄存器
+                   规则编译在 Common/can_filter.c, 这里只做寄存器写入.
+  * Function List:
+                   CANFilter_Load
+  ******************************************************
+**/
+
+#ifndef __CAN_FILTER_HW_H_
+#define __CAN_FILTER_HW_H_
+
+#include "stm32f4xx_conf.h"
+#include "can_filter.h"
+
+ErrorStatus CANFilter_Load(CAN_TypeDef *CANx, const CANFilter_Table *Table, uint8_t StartBank,
+                           uint8_t FMIOffset[2]);
+
+#endif
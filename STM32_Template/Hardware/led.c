@@ -18,6 +18,7 @@
  */
 
 #include "stm32f4xx_conf.h"
+#include "boot_seq.h"
 
 void Led_Init(void) {
     RCC_AHB1PeriphClockCmd(RCC_Periph, ENABLE);
@@ -31,3 +32,23 @@ void Led_Init(void) {
 
     GPIO_SetBits(LED_PORT, LED1_PIN | LED2_PIN);
 }
+
+static BOOT_LAZY(Led_Lazy, Led_Init);
+
+/**
+  * @Name    Led_Set
+  * @brief   点亮或熄灭 LED
+  * @param   Pin: LED1_PIN / LED2_PIN
+  * @param   On: 1 点亮, 0 熄灭
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          第一次调用时才执行 Led_Init, 启动时不再需要单独初始化 LED.
+ **/
+void Led_Set(uint16_t Pin, uint8_t On) {
+    Boot_Require(&Led_Lazy);
+
+    if(On) GPIO_ResetBits(LED_PORT, Pin);
+    else GPIO_SetBits(LED_PORT, Pin);
+}
@@ -26,5 +26,6 @@
 #define	RCC_Periph 	RCC_AHB1Periph_GPIOF
 
 void Led_Init(void);
+void Led_Set(uint16_t Pin, uint8_t On);
 
 #endif
@@ -0,0 +1,229 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 STM32F4 部分, 接到 Common/lp_gov
+                   1. 决定和进入都在关中断(PRIMASK)下进行, 期间到来的中断仍能唤醒 WFI;
+                   2. RTC 唤醒定时器用 RTCCLK/2 计数, 分辨率约 61us, 一次最长约 4s;
+                   3. 时钟恢复: Lp_Init 用 RCC_SnapshotSave 保存时钟快照, 唤醒后 RCC_SnapshotRestoreStart
+                      只启动 HSE, 起振期间执行 Wake 回调, 再由 RCC_SnapshotRestorePoll 打开 PLL 并切换;
+                   4. 进入耗时和恢复耗时用 DWT 周期计数实测, 恢复耗时按 HSI 周期计.
+  * Function List:
+
+  **********************************************************
+ */
+#include "lp_gov_hw.h"
+
+#define LP_HSI_MHZ              (HSI_VALUE / 1000000)
+#define LP_WUT_HZ               (LP_RTCCLK_HZ / 2)
+#define LP_WUT_MAX_US           ((uint32_t)(65536ULL * 1000000 / LP_WUT_HZ))
+
+static uint8_t lp_rtc_ok;
+
+/* 唤醒后要恢复的时钟 */
+static RCC_SnapshotTypeDef lp_clk;
+
+/* 默认时延: STOP 唤醒按数据手册 tWUSTOP, 恢复时间以 8MHz 晶振起振约 2ms 估计, 首次唤醒后由实测替换 */
+static const Lp_Latency lp_lat_default[LP_MODE_NUM] = {
+    {0, 0,   0,    0},
+    {1, 1,   0,    0},
+    {5, 15,  2100, 3000},
+    {5, 110, 2100, 10000},
+};
+
+static uint32_t lp_lock(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+}
+
+static void lp_unlock(uint32_t State) {
+    __set_PRIMASK(State);
+}
+
+static uint32_t lp_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+static uint32_t lp_cpu_mhz(void) {
+    return SystemCoreClock / 1000000;
+}
+
+static uint8_t lp_deepest(void) {
+    return lp_rtc_ok ? LP_MODE_STOP_LP : LP_MODE_SLEEP;
+}
+
+/**
+  * @Name    lp_wut_start
+  * @brief   启动 RTC 唤醒定时器
+  * @param   Mode: LP_MODE_STOP / LP_MODE_STOP_LP
+  * @param   Us: 定时, 超过一次能定的最长时间时截短
+  * @retval  实际定时的 us
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint32_t lp_wut_start(uint8_t Mode, uint32_t Us) {
+    uint32_t ticks;
+
+    (void)Mode;
+
+    if(Us > LP_WUT_MAX_US) Us = LP_WUT_MAX_US;
+
+    ticks = (uint32_t)((uint64_t)Us * LP_WUT_HZ / 1000000);
+    if(ticks == 0) ticks = 1;
+
+    RTC_WriteProtectionCmd(DISABLE);
+    RTC_WakeUpCmd(DISABLE);
+    RTC_SetWakeUpCounter(ticks - 1);
+    RTC_ClearFlag(RTC_FLAG_WUTF);
+    EXTI_ClearITPendingBit(EXTI_Line22);
+    RTC_WakeUpCmd(ENABLE);
+    RTC_WriteProtectionCmd(ENABLE);
+
+    return (uint32_t)((uint64_t)ticks * 1000000 / LP_WUT_HZ);
+}
+
+/* 返回 1: 定时已到 */
+static uint8_t lp_wut_stop(void) {
+    uint8_t fired = (RTC->ISR & RTC_FLAG_WUTF) != 0;
+
+    RTC_WriteProtectionCmd(DISABLE);
+    RTC_WakeUpCmd(DISABLE);
+    RTC_ClearFlag(RTC_FLAG_WUTF);
+    RTC_WriteProtectionCmd(ENABLE);
+    EXTI_ClearITPendingBit(EXTI_Line22);
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+    return fired;
+}
+
+/**
+  * @Name    lp_enter
+  * @brief   进入 Mode 直到唤醒, STOP 唤醒后恢复时钟
+  * @param   Mode: LP_MODE_SLEEP ~ LP_MODE_STOP_LP
+  * @param   Wake: 等待 HSE 起振时调用, 可为 NULL
+  * @param   Info: STOP 唤醒后填写
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          HSE 超时未起振时关掉 HSE, 留在 HSI, 恢复耗时按超时前用掉的周期计.
+ **/
+static void lp_enter(uint8_t Mode, void (*Wake)(uint8_t Mode), Lp_Wake *Info) {
+    uint32_t n;
+
+    if(Mode == LP_MODE_SLEEP) {
+        __WFI();
+        return;
+    }
+
+    if(Mode == LP_MODE_STOP_LP) PWR_FlashPowerDownCmd(ENABLE);
+
+    PWR_EnterSTOPMode(Mode == LP_MODE_STOP_LP ? PWR_LowPowerRegulator_ON : PWR_MainRegulator_ON,
+                      PWR_STOPEntry_WFI);
+
+    /* 此时运行在 HSI 上, HSE 起振期间执行 Wake */
+    RCC_SnapshotRestoreStart(&lp_clk);
+    if(Wake) Wake(Mode);
+
+    for(n = 0; n < HSE_STARTUP_TIMEOUT; n++) {
+        if(RCC_SnapshotRestorePoll(&lp_clk) == RCC_SNAPSHOT_READY) break;
+    }
+
+    if(n == HSE_STARTUP_TIMEOUT) {
+        /* 留在 HSI */
+        RCC->CR &= ~RCC_CR_HSEON;
+        SystemCoreClockUpdate();
+        Info->ClockFail = 1;
+        Info->RestoreCycles = DWT->CYCCNT - lp_clk.StartCycle;
+    } else {
+        Info->RestoreCycles = lp_clk.WakeCycles;
+    }
+
+    Info->RestoreMhz = LP_HSI_MHZ;
+
+    PWR_FlashPowerDownCmd(DISABLE);
+    Info->Fired = lp_wut_stop();
+}
+
+static const Lp_Port lp_port = {
+    LP_MODE_NUM, LP_MODE_STOP, lp_lat_default,
+    lp_lock, lp_unlock, lp_cycles, lp_cpu_mhz, lp_deepest, lp_wut_start, lp_enter
+};
+
+/**
+  * @Name    Lp_Init
+  * @brief   记录当前时钟设置, 配置 RTC 唤醒定时器
+  * @param   Cfg: 回调, NextDeadline 不能为 NULL
+  * @retval  SUCCESS; RTC 时钟未打开时也返回 SUCCESS, 但只使用 SLEEP
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在系统时钟和 RTC 时钟配置完成后调用. 之后修改系统时钟需重新调用.
+ **/
+ErrorStatus Lp_Init(const Lp_Config *Cfg) {
+    NVIC_InitTypeDef nvic;
+    EXTI_InitTypeDef exti;
+
+    if(Cfg == NULL || Cfg->NextDeadline == NULL) return ERROR;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    RCC_SnapshotSave(&lp_clk);
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+    lp_rtc_ok = (RCC->BDCR & RCC_BDCR_RTCEN) != 0;
+
+    if(lp_rtc_ok) {
+        PWR_BackupAccessCmd(ENABLE);
+        RTC_WriteProtectionCmd(DISABLE);
+        RTC_WakeUpCmd(DISABLE);
+        RTC_WakeUpClockConfig(RTC_WakeUpClock_RTCCLK_Div2);
+        RTC_ITConfig(RTC_IT_WUT, ENABLE);
+        RTC_ClearFlag(RTC_FLAG_WUTF);
+        RTC_WriteProtectionCmd(ENABLE);
+
+        exti.EXTI_Line = EXTI_Line22;
+        exti.EXTI_Mode = EXTI_Mode_Interrupt;
+        exti.EXTI_Trigger = EXTI_Trigger_Rising;
+        exti.EXTI_LineCmd = ENABLE;
+        EXTI_Init(&exti);
+        EXTI_ClearITPendingBit(EXTI_Line22);
+
+        nvic.NVIC_IRQChannel = RTC_WKUP_IRQn;
+        nvic.NVIC_IRQChannelPreemptionPriority = LP_IRQ_PRIORITY;
+        nvic.NVIC_IRQChannelSubPriority = 0;
+        nvic.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_Init(&nvic);
+    }
+
+    return Lp_GovInit(&lp_port, Cfg) == LP_OK ? SUCCESS : ERROR;
+}
+
+/**
+  * @Name    Lp_RtcWakeupIRQHandler
+  * @brief   RTC 唤醒中断, 在 RTC_WKUP_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          Lp_Idle 唤醒后已清除标志, 一般不会进入; 只处理在 Lp_Idle 之外到期的情况.
+ **/
+void Lp_RtcWakeupIRQHandler(void) {
+    RTC_ClearITPendingBit(RTC_IT_WUT);
+    EXTI_ClearITPendingBit(EXTI_Line22);
+}
@@ -0,0 +1,44 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 STM32F4 部分
+                   模式选择、时延学习、Lp_Block 计数和驻留统计在 Common/lp_gov.c, 这里只管
+                   SLEEP / STOP 的进入、RTC 唤醒定时器和唤醒后的时钟恢复;
+                   Lp_Idle / Lp_Block / Lp_SetMaxLatency / Lp_GetStats 等见 lp_gov.h.
+                   唤醒后按初始化时保存的时钟快照直接恢复时钟, 不走 SystemInit.
+                   STOP 需要 RTC 时钟已打开(LSE 或 LSI), 否则只用 SLEEP.
+                   待机模式唤醒即复位, 不作为空闲模式.
+  * Function List:
+                   Lp_Init
+                   Lp_RtcWakeupIRQHandler
+  ******************************************************
+**/
+
+#ifndef __LP_GOV_HW_H_
+#define __LP_GOV_HW_H_
+
+#include "stm32f4xx_conf.h"
+#include "lp_gov.h"
+
+#define LP_RTCCLK_HZ            32768   //RTC 时钟, LSI 时改为 32000
+#define LP_IRQ_PRIORITY         0       //RTC 唤醒中断, 只用来唤醒, 立即返回
+
+/* 模式, 数值越大越深 */
+#define LP_MODE_SLEEP           1       //WFI, 时钟不停, 任何中断唤醒
+#define LP_MODE_STOP            2       //STOP, 主调压器开
+#define LP_MODE_STOP_LP         3       //STOP, 低功耗调压器 + Flash 掉电
+#define LP_MODE_NUM             4
+
+ErrorStatus Lp_Init(const Lp_Config *Cfg);
+void Lp_RtcWakeupIRQHandler(void);
+
+#endif
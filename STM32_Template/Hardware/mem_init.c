@@ -0,0 +1,265 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : mem_init.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 多 RAM 区初始化表
+                   1. Mem_Init 在 __main 之前运行, 不能使用需要 __main 初始化的全局变量, 表为 const,
+                      结果保存在 MEM_NOINIT 区; 栈已在 CCM 的 RW_STACK 区, 不在任何清零项内;
+                   2. 表项的区间来自链接器符号 Image$$<执行区>$$ZI$$Base/Limit, 修改 Template.sct
+                      的执行区后这里自动跟随, 新增执行区时在 mem_table 中加一项;
+                   3. CPU 方式每次循环 8 字, armcc 生成 STM/LDM 多寄存器指令;
+                   4. DMA 方式用 DMA2 数据流 0 内存到内存, 字宽 + 4 拍突发, 首尾不满 16 字节的
+                      部分由 CPU 完成, 传输出错时剩余部分也由 CPU 完成;
+                   5. 外部 SDRAM 由 SystemInit_ExtMemCtl 在 SystemInit 中初始化, 因此 Mem_Init 可以直接清零.
+  * Function List:
+
+  **********************************************************
+ */
+#include "mem_init.h"
+#include "stddef.h"
+
+#define MEM_DMA_STREAM      DMA2_Stream0
+#define MEM_DMA_FLAGS       (DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 | DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0)
+#define MEM_DMA_CHUNK       0xFFFC      //NDTR 最大 65535, 取 4 的倍数以配合 4 拍突发
+
+extern uint32_t Image$$RW_CCM$$ZI$$Base[], Image$$RW_CCM$$ZI$$Limit[];
+extern uint32_t Image$$RW_SRAM2$$ZI$$Base[], Image$$RW_SRAM2$$ZI$$Limit[];
+extern uint8_t Image$$ER_IROM1$$Base[], Image$$ER_IROM1$$Length[], Image$$ER_IROM1$$ZI$$Length[];
+extern uint8_t Image$$RW_IRAM1$$Base[], Image$$RW_IRAM1$$Length[], Image$$RW_IRAM1$$ZI$$Length[];
+extern uint8_t Image$$RW_SRAM2$$Base[], Image$$RW_SRAM2$$Length[], Image$$RW_SRAM2$$ZI$$Length[];
+extern uint8_t Image$$RW_NOINIT$$Base[], Image$$RW_NOINIT$$Length[], Image$$RW_NOINIT$$ZI$$Length[];
+extern uint8_t Image$$RW_CCM$$Base[], Image$$RW_CCM$$Length[], Image$$RW_CCM$$ZI$$Length[];
+extern uint8_t Image$$RW_STACK$$Base[], Image$$RW_STACK$$Length[], Image$$RW_STACK$$ZI$$Length[];
+#if MEM_USE_SDRAM
+extern uint32_t Image$$RW_SDRAM$$ZI$$Base[], Image$$RW_SDRAM$$ZI$$Limit[];
+#endif
+
+/* 按顺序执行, 复制项放在清零项之后, 否则会被所在区的清零覆盖 */
+static const Mem_Region mem_table[] = {
+    {"ccm",   Image$$RW_CCM$$ZI$$Base,   Image$$RW_CCM$$ZI$$Limit,   NULL, MEM_ZERO, MEM_CPU},
+    {"sram2", Image$$RW_SRAM2$$ZI$$Base, Image$$RW_SRAM2$$ZI$$Limit, NULL, MEM_ZERO, MEM_DMA},
+#if MEM_USE_SDRAM
+    {"sdram", Image$$RW_SDRAM$$ZI$$Base, Image$$RW_SDRAM$$ZI$$Limit, NULL, MEM_ZERO, MEM_DMA},
+#endif
+    /* 把闪存中的常量表复制到快速 RAM, 例如:
+       {"sin", sin_Ram, sin_Ram + 1024, sin_Rom, MEM_COPY, MEM_CPU}, */
+};
+
+/* 执行区: 名称, 基址, 非 ZI 长度, ZI 长度(链接器把长度定义为符号地址) */
+static const struct {
+    const char *Name;
+    const uint8_t *Base;
+    const uint8_t *Length;
+    const uint8_t *ZiLength;
+} mem_usage[MEM_USAGE_NUM] = {
+    {"ER_IROM1",  Image$$ER_IROM1$$Base,  Image$$ER_IROM1$$Length,  Image$$ER_IROM1$$ZI$$Length},
+    {"RW_IRAM1",  Image$$RW_IRAM1$$Base,  Image$$RW_IRAM1$$Length,  Image$$RW_IRAM1$$ZI$$Length},
+    {"RW_SRAM2",  Image$$RW_SRAM2$$Base,  Image$$RW_SRAM2$$Length,  Image$$RW_SRAM2$$ZI$$Length},
+    {"RW_NOINIT", Image$$RW_NOINIT$$Base, Image$$RW_NOINIT$$Length, Image$$RW_NOINIT$$ZI$$Length},
+    {"RW_CCM",    Image$$RW_CCM$$Base,    Image$$RW_CCM$$Length,    Image$$RW_CCM$$ZI$$Length},
+    {"RW_STACK",  Image$$RW_STACK$$Base,  Image$$RW_STACK$$Length,  Image$$RW_STACK$$ZI$$Length},
+};
+
+static const uint32_t mem_zero = 0;
+
+static Mem_Stat mem_stat[MEM_REGION_MAX] MEM_NOINIT;
+static uint8_t mem_num MEM_NOINIT;
+
+/* Src 为 NULL 时清零 */
+static void Mem_CpuFill(uint32_t *Dst, const uint32_t *Src, uint32_t Words) {
+    uint32_t a, b, c, d;
+
+    if(Src == NULL) {
+        while(Words >= 8) {
+            Dst[0] = 0;
+            Dst[1] = 0;
+            Dst[2] = 0;
+            Dst[3] = 0;
+            Dst[4] = 0;
+            Dst[5] = 0;
+            Dst[6] = 0;
+            Dst[7] = 0;
+            Dst += 8;
+            Words -= 8;
+        }
+
+        while(Words--) *Dst++ = 0;
+
+        return;
+    }
+
+    while(Words >= 4) {
+        a = Src[0];
+        b = Src[1];
+        c = Src[2];
+        d = Src[3];
+        Dst[0] = a;
+        Dst[1] = b;
+        Dst[2] = c;
+        Dst[3] = d;
+        Src += 4;
+        Dst += 4;
+        Words -= 4;
+    }
+
+    while(Words--) *Dst++ = *Src++;
+}
+
+static void Mem_DmaFill(uint32_t *Dst, const uint32_t *Src, uint32_t Words) {
+    DMA_InitTypeDef DMA_InitStructure;
+    uint32_t n;
+
+    /* 首部对齐到 16 字节, 保证 4 拍突发不跨 1KB 边界 */
+    n = ((16 - ((uint32_t)Dst & 15)) & 15) / 4;
+
+    if(n > Words) n = Words;
+
+    Mem_CpuFill(Dst, Src, n);
+    Dst += n;
+    Src = Src ? Src + n : NULL;
+    Words -= n;
+
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = DMA_Channel_0;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToMemory;
+    DMA_InitStructure.DMA_PeripheralInc = Src ? DMA_PeripheralInc_Enable : DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+
+    while(Words >= 4) {
+        n = Words > MEM_DMA_CHUNK ? MEM_DMA_CHUNK : (Words & ~3UL);
+
+        DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)(Src ? Src : &mem_zero);
+        DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)Dst;
+        DMA_InitStructure.DMA_BufferSize = n;
+        DMA_Init(MEM_DMA_STREAM, &DMA_InitStructure);
+        DMA_Cmd(MEM_DMA_STREAM, ENABLE);
+
+        while(DMA_GetFlagStatus(MEM_DMA_STREAM, DMA_FLAG_TCIF0) == RESET) {
+            if(DMA_GetFlagStatus(MEM_DMA_STREAM, DMA_FLAG_TEIF0) != RESET) break;
+        }
+
+        if(DMA_GetFlagStatus(MEM_DMA_STREAM, DMA_FLAG_TEIF0) != RESET) {
+            /* 地址不在 DMA 总线上, 出错时数据流已自动关闭, 剩余部分交给 CPU */
+            DMA_ClearFlag(MEM_DMA_STREAM, MEM_DMA_FLAGS);
+            break;
+        }
+
+        DMA_ClearFlag(MEM_DMA_STREAM, MEM_DMA_FLAGS);
+        Dst += n;
+        Src = Src ? Src + n : NULL;
+        Words -= n;
+    }
+
+    Mem_CpuFill(Dst, Src, Words);
+}
+
+/**
+  * @Name    Mem_Init
+  * @brief   按表初始化 UNINIT 执行区
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          由 Reset_Handler 在 SystemInit 之后、__main 之前调用, 不要在 main 中再次调用.
+          使用过 DMA2 时结束后关闭 DMA2 时钟, 保持复位状态.
+ **/
+void Mem_Init(void) {
+    const Mem_Region *r;
+    uint32_t i, bytes, t, dma2;
+    uint8_t engine, *tail;
+    const uint8_t *src_Tail;
+
+    dma2 = RCC->AHB1ENR & RCC_AHB1Periph_DMA2;
+    mem_num = 0;
+
+    for(i = 0; i < sizeof(mem_table) / sizeof(mem_table[0]) && i < MEM_REGION_MAX; i++) {
+        r = &mem_table[i];
+        bytes = (uint32_t)r->Limit - (uint32_t)r->Base;
+        engine = r->Engine;
+
+        if(bytes < MEM_DMA_MIN || MEM_IS_CCM(r->Base) || (r->Op == MEM_COPY && MEM_IS_CCM(r->Src))) {
+            engine = MEM_CPU;
+        }
+
+        t = DWT->CYCCNT;
+
+        if(engine == MEM_DMA) {
+            RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+            Mem_DmaFill(r->Base, r->Op == MEM_COPY ? r->Src : NULL, bytes / 4);
+        } else {
+            Mem_CpuFill(r->Base, r->Op == MEM_COPY ? r->Src : NULL, bytes / 4);
+        }
+
+        /* 区长度不一定是 4 的倍数, 末尾按字节处理, 不能写到下一个区 */
+        tail = (uint8_t *)r->Base + (bytes & ~3UL);
+        src_Tail = r->Op == MEM_COPY ? (const uint8_t *)r->Src + (bytes & ~3UL) : (const uint8_t *)&mem_zero;
+
+        while(tail < (uint8_t *)r->Limit) {
+            *tail++ = *src_Tail;
+
+            if(r->Op == MEM_COPY) src_Tail++;
+        }
+
+        mem_stat[mem_num].Name = r->Name;
+        mem_stat[mem_num].Bytes = bytes;
+        mem_stat[mem_num].Cycles = DWT->CYCCNT - t;
+        mem_stat[mem_num].Engine = engine;
+        mem_num++;
+    }
+
+    if(dma2 == 0) RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, DISABLE);
+}
+
+/**
+  * @Name    Mem_GetStat
+  * @brief   读取各区初始化结果
+  * @param   Stat: 输出表首地址
+  * @retval  区个数
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          Cycles 按 SystemInit 之后的 HCLK 计数, 定义 SYSCLK_ASYNC 时为 HSI 16MHz.
+ **/
+uint8_t Mem_GetStat(const Mem_Stat **Stat) {
+    *Stat = mem_stat;
+    return mem_num;
+}
+
+/**
+  * @Name    Mem_GetUsage
+  * @brief   读取执行区的位置和占用
+  * @param   Index: 0 ~ MEM_USAGE_NUM-1, 顺序与 Template.sct 相同
+  * @param   Usage: 输出
+  * @retval  SUCCESS / ERROR(Index 超出范围)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          RW_IRAM1 的非 ZI 部分包括 .data 和 MEM_RAMFUNC 函数. 与 Template.sct 中各区的大小
+          比较可得剩余空间, 修改 Template.sct 的执行区时同步修改 mem_usage.
+ **/
+ErrorStatus Mem_GetUsage(uint8_t Index, Mem_Usage *Usage) {
+    if(Index >= MEM_USAGE_NUM) return ERROR;
+
+    Usage->Name = mem_usage[Index].Name;
+    Usage->Base = (uint32_t)mem_usage[Index].Base;
+    Usage->Bytes = (uint32_t)mem_usage[Index].Length + (uint32_t)mem_usage[Index].ZiLength;
+
+    return SUCCESS;
+}
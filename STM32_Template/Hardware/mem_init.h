@@ -0,0 +1,91 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : mem_init.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 多 RAM 区初始化表
+                   主 SRAM 的 .data/.bss 仍由 __main 初始化; Template.sct 中标为 UNINIT 的
+                   其它区(CCM、SRAM2、外部 SDRAM)由启动文件在 SystemInit 之后、__main 之前
+                   调用 Mem_Init 按表清零或从闪存复制, 按区选择 CPU 展开循环或 DMA2 内存到内存,
+                   每个区的耗时用 DWT 记录, main 中用 Mem_GetStat 读取.
+                   MEM_CCM/MEM_DMA_BUF/MEM_RAMFUNC 按性能分类放置变量和函数, Mem_GetUsage 在运行时
+                   给出每个执行区的位置和大小, 逐个文件的明细见链接生成的 .map(--info=sizes,totals).
+                   栈在 CCM(RW_STACK), 而 DMA 访问不到 CCM: 局部变量不能作 DMA 缓冲,
+                   DMA 缓冲用 MEM_DMA_BUF 或普通静态变量, 驱动收到外部缓冲时用 MEM_IS_CCM 拒绝.
+  * Function List:
+                   Mem_Init
+                   Mem_GetStat
+                   Mem_GetUsage
+  ******************************************************
+**/
+
+#ifndef __MEM_INIT_H_
+#define __MEM_INIT_H_
+
+#include "stm32f4xx_conf.h"
+
+/* 放置属性, 与 Template.sct 中的执行区对应, 变量均不带初值(由 Mem_Init 清零) */
+#define MEM_CCM         __attribute__((section(".bss.ccm"), zero_init))       //CCM 64KB, 0 等待, DMA 不可访问
+#define MEM_SRAM2       __attribute__((section(".bss.sram2"), zero_init))     //SRAM2 16KB, 与 SRAM1 分开的总线从口
+#define MEM_SDRAM       __attribute__((section(".bss.sdram"), zero_init))     //外部 SDRAM, 需 MEM_USE_SDRAM
+#define MEM_NOINIT      __attribute__((section(".bss.noinit"), zero_init))    //复位后不清零
+#define MEM_RAMFUNC     __attribute__((section(".RamFunc")))                  //函数在 SRAM1 执行, 无闪存等待
+
+/* 按用途放置: 中断/控制环状态放 CCM(只有 CPU 访问), DMA 缓冲单独放 SRAM2,
+   中断代码从 SRAM1 取指, 三者分别在不同的总线从口上, 互不等待 */
+#define MEM_DMA_BUF     MEM_SRAM2
+
+/* 地址在 CCM(含栈)中时为真, DMA 缓冲不能落在这里 */
+#define MEM_IS_CCM(Addr)    (((uint32_t)(Addr) & 0xFFFF0000) == 0x10000000)
+
+/* 置 1 前须在 system_stm32f4xx.c 中定义 DATA_IN_ExtSDRAM, 并打开 Template.sct 中的 RW_SDRAM 区 */
+#define MEM_USE_SDRAM   0
+
+#define MEM_ZERO        0
+#define MEM_COPY        1
+
+#define MEM_CPU         0
+#define MEM_DMA         1       //CCM 不在 DMA 总线上, 自动退回 CPU
+
+#define MEM_DMA_MIN     256     //小于该字节数时 DMA 配置开销大于收益, 使用 CPU
+
+#define MEM_REGION_MAX  8
+#define MEM_USAGE_NUM   6       //Mem_GetUsage 可查询的执行区个数
+
+/* 初始化表项 */
+typedef struct {
+    const char *Name;
+    uint32_t *Base;
+    uint32_t *Limit;            //结束地址(不含)
+    const uint32_t *Src;        //MEM_COPY 时的闪存源地址
+    uint8_t Op;                 //MEM_ZERO / MEM_COPY
+    uint8_t Engine;             //MEM_CPU / MEM_DMA
+} Mem_Region;
+
+/* 每个区的初始化结果 */
+typedef struct {
+    const char *Name;
+    uint32_t Bytes;
+    uint32_t Cycles;
+    uint8_t Engine;             //实际使用的方式
+} Mem_Stat;
+
+/* 执行区占用 */
+typedef struct {
+    const char *Name;
+    uint32_t Base;
+    uint32_t Bytes;             //代码/常量/RW/ZI 合计
+} Mem_Usage;
+
+void Mem_Init(void);
+uint8_t Mem_GetStat(const Mem_Stat **Stat);
+ErrorStatus Mem_GetUsage(uint8_t Index, Mem_Usage *Usage);
+
+#endif
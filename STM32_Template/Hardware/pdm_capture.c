@@ -0,0 +1,462 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : pdm_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DFSDM PDM 麦克风多通道采集流水线
+                   每一路麦克风占用一个 DFSDM 滤波器和一个 DMA 流,
+                   DMA 工作在双缓冲(乒乓)模式, 所有滤波器与 Filter0 同步启动,
+                   当所有路的同一半缓冲都写满后, 做 Q31 后处理并回调一次.
+  * Function List:
+
+  **********************************************************
+ */
+#include "pdm_capture.h"
+#include "mem_init.h"
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx)
+
+/* DFSDM_FLTxRDATAR: [31:8] 为 24 位有符号数据, [7:0] 为通道号和标志, 屏蔽低 8 位即得到 Q31 */
+#define PDM_DATA_MASK       ((int32_t)0xFFFFFF00)
+
+static PDM_PipelineDesc pdm_desc;
+static PDM_HPState pdm_hp[PDM_MAX_STREAMS];
+static int32_t *pdm_out[PDM_MAX_STREAMS];
+static volatile uint8_t pdm_ready[2];   //每一半缓冲已完成的路掩码
+static uint8_t pdm_all_mask;
+static PDM_Stats pdm_stats;
+
+/**
+  * @Name    PDM_DecimShift
+  * @brief   抽取倍数转为移位数
+  * @param   Decimation: 1/2/4/8
+  * @retval  移位数, 非法值返回 0xFF
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint32_t PDM_DecimShift(uint32_t Decimation) {
+    switch(Decimation) {
+        case 1:
+            return 0;
+
+        case 2:
+            return 1;
+
+        case 4:
+            return 2;
+
+        case 8:
+            return 3;
+
+        default:
+            return 0xFF;
+    }
+}
+
+/**
+  * @Name    PDM_DeliverBlock
+  * @brief   对所有路的同一半缓冲做后处理并回调
+  * @param   Half: 0 或 1, 刚写满的缓冲
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在 DMA 中断中执行, 处理结束时若 Streams[0] 的 DMA 已经切回这一半,
+          说明回调太慢, 数据已被覆盖, 计入 Overruns.
+ **/
+static void PDM_DeliverBlock(uint32_t Half) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles;
+    uint32_t outLen = pdm_desc.BlockSize / pdm_desc.Decimation;
+    uint8_t s;
+
+    for(s = 0; s < pdm_desc.NumStreams; s++) {
+        const int32_t *in = pdm_desc.DMABuffer + ((uint32_t)s * 2 + Half) * pdm_desc.BlockSize;
+
+        PDM_ProcessQ31(in, pdm_out[s], pdm_desc.BlockSize, pdm_desc.Decimation,
+                       pdm_desc.HighPassCoef, &pdm_hp[s]);
+    }
+
+    pdm_desc.Callback(pdm_out, pdm_desc.NumStreams, outLen);
+
+    if(DMA_GetCurrentMemoryTarget(pdm_desc.Streams[0].DMA_Stream) == Half) {
+        pdm_stats.Overruns++;
+    }
+
+    cycles = DWT->CYCCNT - start;
+    pdm_stats.LastCycles = cycles;
+
+    if(cycles > pdm_stats.MaxCycles) pdm_stats.MaxCycles = cycles;
+
+    pdm_stats.Blocks++;
+}
+
+/**
+  * @Name    PDM_Init
+  * @brief   按描述配置 DFSDM 收发器、滤波器和 DMA
+  * @param   Desc: 流水线描述, 内容会被复制, 但 Streams/缓冲区/回调必须一直有效
+  * @retval  SUCCESS: 配置完成; ERROR: 描述非法
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          - DMABuffer 由 DMA 写入, 不能在 CCM(含栈上的局部数组), 否则返回 ERROR; OutBuffer 只有 CPU 访问.
+          - 每一路: 收发器使用内部 CKOUT 时钟, 滤波器常规通道连续 + 快速模式,
+            DMA 外设到内存, 字宽, 循环 + 双缓冲, 只开传输完成中断.
+          - 除 Streams[0] 外的滤波器设置 RSYNC, 由 Filter0 的软件启动同步触发,
+            保证各路采样对齐, 波束形成时无需再做通道间对齐.
+ **/
+ErrorStatus PDM_Init(const PDM_PipelineDesc *Desc) {
+    DFSDM_TransceiverInitTypeDef transceiver;
+    DFSDM_FilterInitTypeDef filter;
+    DMA_InitTypeDef dma;
+    NVIC_InitTypeDef nvic;
+    uint32_t outLen;
+    uint8_t s;
+
+    if(Desc->NumStreams == 0 || Desc->NumStreams > PDM_MAX_STREAMS || Desc->Streams == 0 ||
+            Desc->DMABuffer == 0 || MEM_IS_CCM(Desc->DMABuffer) || Desc->OutBuffer == 0 || Desc->Callback == 0 ||
+            PDM_DecimShift(Desc->Decimation) == 0xFF || Desc->BlockSize == 0 ||
+            Desc->BlockSize > 0xFFFF || (Desc->BlockSize % Desc->Decimation) != 0) {
+        return ERROR;
+    }
+
+    pdm_desc = *Desc;
+    outLen = Desc->BlockSize / Desc->Decimation;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+#if defined(STM32F413_423xx)
+    RCC_APB2PeriphClockCmd(Desc->Instance == 2 ? RCC_APB2Periph_DFSDM2 : RCC_APB2Periph_DFSDM1, ENABLE);
+    DFSDM_ConfigClkOutputSource(Desc->Instance, Desc->ClkOutSource);
+    DFSDM_ConfigClkOutputDivider(Desc->Instance, Desc->ClkOutDivider);
+#else
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_DFSDM1, ENABLE);
+    DFSDM_ConfigClkOutputSource(Desc->ClkOutSource);
+    DFSDM_ConfigClkOutputDivider(Desc->ClkOutDivider);
+#endif
+
+    DFSDM_TransceiverStructInit(&transceiver);
+    DFSDM_FilterStructInit(&filter);
+    DMA_StructInit(&dma);
+
+    filter.DFSDM_SincOrder = Desc->SincOrder;
+    filter.DFSDM_FilterOversamplingRatio = Desc->FilterOversampling;
+    filter.DFSDM_IntegratorOversamplingRatio = Desc->IntegratorOversampling;
+
+    dma.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dma.DMA_BufferSize = Desc->BlockSize;
+    dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    dma.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    dma.DMA_Mode = DMA_Mode_Circular;
+    dma.DMA_Priority = DMA_Priority_High;
+    dma.DMA_FIFOMode = DMA_FIFOMode_Disable;
+
+    nvic.NVIC_IRQChannelPreemptionPriority = Desc->IRQPriority;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+
+    pdm_all_mask = 0;
+
+    for(s = 0; s < Desc->NumStreams; s++) {
+        const PDM_StreamDesc *sd = &Desc->Streams[s];
+        int32_t *buf = Desc->DMABuffer + (uint32_t)s * 2 * Desc->BlockSize;
+
+        /* 串行收发器 */
+        transceiver.DFSDM_Interface = sd->Interface;
+        transceiver.DFSDM_Clock = DFSDM_Clock_Internal;
+        transceiver.DFSDM_Input = DFSDM_Input_External;
+        transceiver.DFSDM_Redirection = sd->Redirection;
+        transceiver.DFSDM_PackingMode = DFSDM_PackingMode_Standard;
+        transceiver.DFSDM_DataRightShift = sd->RightShift;
+        transceiver.DFSDM_Offset = sd->Offset;
+        transceiver.DFSDM_CLKAbsenceDetector = DFSDM_CLKAbsenceDetector_Disable;
+        transceiver.DFSDM_ShortCircuitDetector = DFSDM_ShortCircuitDetector_Disable;
+        DFSDM_TransceiverInit(sd->Channel, &transceiver);
+
+        /* 滤波器: 常规通道连续转换, DMA 读取 */
+        DFSDM_FilterInit(sd->Filter, &filter);
+        DFSDM_SelectRegularChannel(sd->Filter, sd->RegularChannel);
+        DFSDM_RegularContinuousModeCmd(sd->Filter, ENABLE);
+        DFSDM_FastModeCmd(sd->Filter, ENABLE);
+        DFSDM_DMATransferConfig(sd->Filter, DFSDM_DMAConversionMode_Regular, ENABLE);
+
+        if(s != 0) DFSDM_SynchronousFilter0RegularStart(sd->Filter);
+
+        /* DMA: 乒乓缓冲, M0 = buf, M1 = buf + BlockSize */
+        DMA_DeInit(sd->DMA_Stream);
+        dma.DMA_Channel = sd->DMA_Channel;
+        dma.DMA_PeripheralBaseAddr = (uint32_t)&sd->Filter->FLTRDATAR;
+        dma.DMA_Memory0BaseAddr = (uint32_t)buf;
+        DMA_Init(sd->DMA_Stream, &dma);
+        DMA_DoubleBufferModeConfig(sd->DMA_Stream, (uint32_t)(buf + Desc->BlockSize), DMA_Memory_0);
+        DMA_DoubleBufferModeCmd(sd->DMA_Stream, ENABLE);
+        DMA_ITConfig(sd->DMA_Stream, DMA_IT_TC, ENABLE);
+
+        nvic.NVIC_IRQChannel = sd->DMA_IRQn;
+        NVIC_Init(&nvic);
+
+        DFSDM_ChannelCmd(sd->Channel, ENABLE);
+        DFSDM_FilterCmd(sd->Filter, ENABLE);
+
+        pdm_out[s] = Desc->OutBuffer + (uint32_t)s * outLen;
+        pdm_hp[s].PrevIn = 0;
+        pdm_hp[s].PrevOut = 0;
+        pdm_all_mask |= (uint8_t)(1 << s);
+    }
+
+#if defined(STM32F413_423xx)
+    DFSDM_Cmd(Desc->Instance, ENABLE);
+#else
+    DFSDM_Command(ENABLE);
+#endif
+
+    /* DWT 周期计数器用于统计后处理耗时 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    pdm_stats.Blocks = 0;
+    pdm_stats.Overruns = 0;
+    pdm_stats.LastCycles = 0;
+    pdm_stats.MaxCycles = 0;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    PDM_Start
+  * @brief   启动所有 DMA 流, 再由 Filter0 软件触发同步开始转换
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void PDM_Start(void) {
+    uint8_t s;
+
+    pdm_ready[0] = 0;
+    pdm_ready[1] = 0;
+
+    for(s = 0; s < pdm_desc.NumStreams; s++) {
+        const PDM_StreamDesc *sd = &pdm_desc.Streams[s];
+        int32_t *buf = pdm_desc.DMABuffer + (uint32_t)s * 2 * pdm_desc.BlockSize;
+
+        /* 重新从 M0 开始, 保证各路的半缓冲编号一致 */
+        DMA_SetCurrDataCounter(sd->DMA_Stream, (uint16_t)pdm_desc.BlockSize);
+        DMA_DoubleBufferModeConfig(sd->DMA_Stream, (uint32_t)(buf + pdm_desc.BlockSize), DMA_Memory_0);
+        DMA_ClearITPendingBit(sd->DMA_Stream, sd->DMA_TCFlag);
+        DMA_Cmd(sd->DMA_Stream, ENABLE);
+    }
+
+    DFSDM_StartSoftwareRegularConversion(pdm_desc.Streams[0].Filter);
+}
+
+/**
+  * @Name    PDM_Stop
+  * @brief   停止转换和 DMA, 配置保留, 可再次 PDM_Start
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          清除 DFEN 会终止正在进行的转换, 随后立即重新使能, 等待下一次软件启动.
+ **/
+void PDM_Stop(void) {
+    uint8_t s;
+
+    for(s = 0; s < pdm_desc.NumStreams; s++) {
+        const PDM_StreamDesc *sd = &pdm_desc.Streams[s];
+
+        DFSDM_FilterCmd(sd->Filter, DISABLE);
+        DMA_Cmd(sd->DMA_Stream, DISABLE);
+
+        while(DMA_GetCmdStatus(sd->DMA_Stream) != DISABLE);
+
+        DFSDM_FilterCmd(sd->Filter, ENABLE);
+    }
+}
+
+/**
+  * @Name    PDM_DMA_IRQHandler
+  * @brief   DMA 传输完成中断处理, 在对应的 DMA2_StreamX_IRQHandler 中调用
+  * @param   Stream: 该 DMA 流在 Streams[] 中的下标
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          双缓冲模式下 TC 中断时 CT 已切换, 刚写满的是另一半.
+          最后一个到达的路负责处理和回调.
+ **/
+void PDM_DMA_IRQHandler(uint8_t Stream) {
+    const PDM_StreamDesc *sd = &pdm_desc.Streams[Stream];
+    uint8_t bit = (uint8_t)(1 << Stream);
+    uint32_t half;
+
+    if(DMA_GetITStatus(sd->DMA_Stream, sd->DMA_TCFlag) == RESET) return;
+
+    DMA_ClearITPendingBit(sd->DMA_Stream, sd->DMA_TCFlag);
+
+    half = DMA_GetCurrentMemoryTarget(sd->DMA_Stream) ^ 1;
+
+    /* 上一轮这一半还没凑齐, 说明某一路丢了中断或回调过慢 */
+    if(pdm_ready[half] & bit) pdm_stats.Overruns++;
+
+    pdm_ready[half] |= bit;
+
+    if(pdm_ready[half] == pdm_all_mask) {
+        pdm_ready[half] = 0;
+        PDM_DeliverBlock(half);
+    }
+}
+
+/**
+  * @Name    PDM_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          MaxCycles / (SystemCoreClock / 块率) 即为采集链路的 CPU 占用.
+ **/
+void PDM_GetStats(PDM_Stats *Stats) {
+    *Stats = pdm_stats;
+}
+
+/**
+  * @Name    PDM_ProcessQ31
+  * @brief   24 位结果转 Q31, 可选均值抽取和直流阻断
+  * @param   In: DFSDM 原始数据(RDATAR 格式)
+  * @param   Out: 输出, 长度 Samples / Decimation, 可与 In 相同
+  * @param   Samples: 输入点数, 必须是 Decimation 的整数倍
+  * @param   Decimation: 1/2/4/8
+  * @param   HighPassCoef: 直流阻断极点 a (Q31), 0 为关闭
+  * @param   State: 该路的滤波器状态, 跨块保持
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          输出预留 6dB 余量(右移 1 位), 直流阻断 y = x - x' + a*y' 使用饱和加减.
+          抽取前的抗混叠已由 Sinc 滤波器完成, 这里只做均值, 用于把 Sinc 输出
+          降到处理速率. 不抽取且不滤波时按 4 点展开.
+ **/
+void PDM_ProcessQ31(const int32_t *In, int32_t *Out, uint32_t Samples, uint32_t Decimation,
+                    int32_t HighPassCoef, PDM_HPState *State) {
+    uint32_t shift = PDM_DecimShift(Decimation);
+    uint32_t n = Samples >> shift;
+    uint32_t i, k;
+    int32_t x, y;
+    int32_t xPrev = State->PrevIn;
+    int32_t yPrev = State->PrevOut;
+
+    if(shift == 0 && HighPassCoef == 0) {
+        for(i = n >> 2; i > 0; i--) {
+            Out[0] = (In[0] & PDM_DATA_MASK) >> 1;
+            Out[1] = (In[1] & PDM_DATA_MASK) >> 1;
+            Out[2] = (In[2] & PDM_DATA_MASK) >> 1;
+            Out[3] = (In[3] & PDM_DATA_MASK) >> 1;
+            In += 4;
+            Out += 4;
+        }
+
+        for(i = n & 3; i > 0; i--) {
+            *Out++ = (*In++ & PDM_DATA_MASK) >> 1;
+        }
+
+        return;
+    }
+
+    for(i = 0; i < n; i++) {
+        x = 0;
+
+        for(k = 0; k < Decimation; k++) {
+            x += (In[k] & PDM_DATA_MASK) >> (1 + shift);
+        }
+
+        In += Decimation;
+
+        if(HighPassCoef != 0) {
+            y = (int32_t)(((int64_t)HighPassCoef * yPrev) >> 31);
+            y = (int32_t)__QADD((int32_t)__QSUB(x, xPrev), y);
+            xPrev = x;
+            yPrev = y;
+            x = y;
+        }
+
+        Out[i] = x;
+    }
+
+    State->PrevIn = xPrev;
+    State->PrevOut = yPrev;
+}
+
+/**
+  * @Name    PDM_BeamformDelaySum
+  * @brief   延迟求和波束形成
+  * @param   In: 各麦克风 Q31 数据, 通常直接使用块回调的 Block
+  * @param   NumMics: 麦克风数 1~PDM_MAX_STREAMS
+  * @param   Delay: 各麦克风的整数采样延迟, 0~PDM_BEAM_MAX_DELAY-1
+  * @param   Out: 输出, Samples 点
+  * @param   Samples: 每路点数, 不小于 PDM_BEAM_MAX_DELAY
+  * @param   State: 跨块保存每路最后 PDM_BEAM_MAX_DELAY 个点
+  * @retval  SUCCESS: 完成; ERROR: 参数非法, Out 和 State 未改动
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          每路先右移 log2(NumMics) 再相加, 不会溢出.
+          延迟部分从历史缓冲取数, 其余直接顺序读输入, 内循环无分支,
+          每点每路只有一次读、移位和累加, 可放在块回调中直接执行.
+          参数在开始前全部检查, 不会只处理一部分麦克风.
+ **/
+ErrorStatus PDM_BeamformDelaySum(int32_t *const *In, uint8_t NumMics, const uint8_t *Delay,
+                                 int32_t *Out, uint32_t Samples, PDM_BeamState *State) {
+    uint32_t shift;
+    uint32_t d, i;
+    uint8_t m;
+
+    if(In == 0 || Delay == 0 || Out == 0 || State == 0 || NumMics == 0 || NumMics > PDM_MAX_STREAMS ||
+            Samples < PDM_BEAM_MAX_DELAY) {
+        return ERROR;
+    }
+
+    for(m = 0; m < NumMics; m++) {
+        if(In[m] == 0 || Delay[m] >= PDM_BEAM_MAX_DELAY) {
+            return ERROR;
+        }
+    }
+
+    shift = NumMics > 2 ? 2 : NumMics - 1;
+
+    for(m = 0; m < NumMics; m++) {
+        const int32_t *src = In[m];
+        int32_t *hist = State->History[m];
+
+        d = Delay[m];
+
+        if(m == 0) {
+            for(i = 0; i < d; i++) Out[i] = hist[PDM_BEAM_MAX_DELAY - d + i] >> shift;
+
+            for(i = d; i < Samples; i++) Out[i] = src[i - d] >> shift;
+        } else {
+            for(i = 0; i < d; i++) Out[i] += hist[PDM_BEAM_MAX_DELAY - d + i] >> shift;
+
+            for(i = d; i < Samples; i++) Out[i] += src[i - d] >> shift;
+        }
+
+        for(i = 0; i < PDM_BEAM_MAX_DELAY; i++) hist[i] = src[Samples - PDM_BEAM_MAX_DELAY + i];
+    }
+
+    return SUCCESS;
+}
+
+#endif /* STM32F412xG || STM32F413_423xx */
@@ -0,0 +1,106 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : pdm_capture.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DFSDM PDM 麦克风多通道采集流水线
+                   只有 STM32F412xG / STM32F413_423xx 有 DFSDM, 其它型号(包括本工程默认的
+                   STM32F40_41xxx)下本模块编译为空.
+  * Function List:
+                   PDM_Init
+                   PDM_Start
+                   PDM_Stop
+                   PDM_DMA_IRQHandler
+                   PDM_GetStats
+                   PDM_ProcessQ31
+                   PDM_BeamformDelaySum
+  ******************************************************
+**/
+
+#ifndef __PDM_CAPTURE_H_
+#define __PDM_CAPTURE_H_
+
+#include "stm32f4xx_conf.h"
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx)
+
+#define PDM_MAX_STREAMS         4       //最多同时采集的麦克风(滤波器)数
+#define PDM_BEAM_MAX_DELAY      16      //波束形成的延迟上限(采样点), 延迟须小于该值
+
+/* 每一路麦克风的声明式描述: 收发器 + 滤波器 + DMA 流 */
+typedef struct {
+    DFSDM_Channel_TypeDef *Channel;     //串行收发器, 例如 DFSDM2_Channel1
+    DFSDM_Filter_TypeDef  *Filter;      //滤波器, 例如 DFSDM2_1
+    uint32_t RegularChannel;            //DFSDM_RegularChannelx, 与 Channel 对应
+    uint32_t Interface;                 //DFSDM_Interface_SPI_RisingEdge/FallingEdge, 两个麦克风共线时分左右
+    uint32_t Redirection;               //DFSDM_Redirection_xxx, 共用一根数据线时第二路使用重定向
+    uint32_t RightShift;                //最终数据右移 0~31
+    uint32_t Offset;                    //校准偏移 0~0xFFFFFF
+    DMA_Stream_TypeDef *DMA_Stream;     //滤波器对应的 DMA 流
+    uint32_t DMA_Channel;               //DMA_Channel_x
+    uint32_t DMA_TCFlag;                //该流的传输完成中断标志, 例如 DMA_IT_TCIF0
+    uint8_t  DMA_IRQn;                  //该流的中断号, 例如 DMA2_Stream0_IRQn
+} PDM_StreamDesc;
+
+/* 块回调: 在最后一个完成的 DMA 中断中调用, Block[i] 为第 i 路处理后的 Q31 数据 */
+typedef void (*PDM_BlockCallback)(int32_t *const *Block, uint8_t NumStreams, uint32_t Samples);
+
+/* 整个采集流水线的描述 */
+typedef struct {
+    uint32_t Instance;                  //DFSDM 实例: 1 或 2 (2 仅 STM32F413_423xx)
+    uint32_t ClkOutSource;              //DFSDM_ClkOutSource_SysClock/AudioClock
+    uint32_t ClkOutDivider;             //CKOUT 分频 2~256, 即 PDM 时钟
+    uint32_t SincOrder;                 //DFSDM_SincOrder_xxx
+    uint32_t FilterOversampling;        //Sinc 过采样率 1~1024
+    uint32_t IntegratorOversampling;    //积分器过采样率 1~256
+    uint32_t BlockSize;                 //每块每路的采样数(DMA 半缓冲长度)
+    uint32_t Decimation;                //后级抽取倍数 1/2/4/8, 1 为不抽取
+    int32_t  HighPassCoef;              //直流阻断极点, Q31, 0 为关闭, 例如 0x7F000000
+    uint8_t  IRQPriority;               //所有 DMA 中断使用同一抢占优先级, 保证块同步不被嵌套打断
+    uint8_t  NumStreams;                //1~PDM_MAX_STREAMS, Streams[0] 必须是该实例的 Filter0
+    const PDM_StreamDesc *Streams;
+    int32_t *DMABuffer;                 //NumStreams * 2 * BlockSize 个字, 建议 4 字节对齐放在 SRAM1, 不能在 CCM
+    int32_t *OutBuffer;                 //NumStreams * BlockSize / Decimation 个字
+    PDM_BlockCallback Callback;
+} PDM_PipelineDesc;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t Blocks;                    //已交付的块数
+    uint32_t Overruns;                  //回调未及时完成导致的丢块数
+    uint32_t LastCycles;                //最近一次后处理+回调消耗的 CPU 周期
+    uint32_t MaxCycles;                 //后处理+回调的最大周期数
+} PDM_Stats;
+
+/* 单路后处理状态(直流阻断) */
+typedef struct {
+    int32_t PrevIn;
+    int32_t PrevOut;
+} PDM_HPState;
+
+/* 延迟求和波束形成状态 */
+typedef struct {
+    int32_t History[PDM_MAX_STREAMS][PDM_BEAM_MAX_DELAY];
+} PDM_BeamState;
+
+ErrorStatus PDM_Init(const PDM_PipelineDesc *Desc);
+void PDM_Start(void);
+void PDM_Stop(void);
+void PDM_DMA_IRQHandler(uint8_t Stream);
+void PDM_GetStats(PDM_Stats *Stats);
+
+void PDM_ProcessQ31(const int32_t *In, int32_t *Out, uint32_t Samples, uint32_t Decimation,
+                    int32_t HighPassCoef, PDM_HPState *State);
+ErrorStatus PDM_BeamformDelaySum(int32_t *const *In, uint8_t NumMics, const uint8_t *Delay,
+                                 int32_t *Out, uint32_t Samples, PDM_BeamState *State);
+
+#endif /* STM32F412xG || STM32F413_423xx */
+
+#endif
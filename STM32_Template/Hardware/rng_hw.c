@@ -0,0 +1,146 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RNG 外设接到 Common/rng_pool 的随机数池
+                   1. 中断每次取一个字交给 Rng_Feed, 池满关 RNG 中断, 消费侧取数后经 Resume 再打开;
+                   2. 池和生成器状态放 CCM, DMA 访问不到.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rng_hw.h"
+#include "mem_init.h"
+
+static Rng_Pool rng_state MEM_CCM;
+
+/**
+  * @Name    rng_lock
+  * @brief   关中断
+  * @param   None
+  * @retval  之前的 PRIMASK
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static uint32_t rng_lock(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+}
+
+/**
+  * @Name    rng_unlock
+  * @brief   恢复中断状态
+  * @param   State: rng_lock 的返回值
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_unlock(uint32_t State) {
+    __set_PRIMASK(State);
+}
+
+/**
+  * @Name    rng_resume
+  * @brief   池有空位, 重新打开 RNG 中断
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_resume(void) {
+    RNG_ITConfig(ENABLE);
+}
+
+/**
+  * @Name    rng_halt
+  * @brief   判定硬件故障, 关闭 RNG
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void rng_halt(void) {
+    RNG_ITConfig(DISABLE);
+    RNG_Cmd(DISABLE);
+}
+
+static const Rng_Port rng_port = {rng_lock, rng_unlock, rng_resume, rng_halt};
+
+/**
+  * @Name    Rng_IRQHandler
+  * @brief   RNG 中断, 在 HASH_RNG_IRQHandler(F410/F412/F413 为 RNG_IRQHandler)中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          种子错误按手册清标志并重启 RNG, 时钟错误由硬件自行恢复; 两者都交给 Rng_Fault.
+ **/
+void Rng_IRQHandler(void) {
+    uint32_t sr = RNG->SR;
+
+    if(sr & (RNG_SR_SEIS | RNG_SR_CEIS)) {
+        if(sr & RNG_SR_SEIS) {
+            RNG_ClearITPendingBit(RNG_IT_SEI);
+            RNG_Cmd(DISABLE);
+            RNG_Cmd(ENABLE);
+            Rng_Fault(RNG_FAULT_SEED);
+        }
+
+        if(sr & RNG_SR_CEIS) {
+            RNG_ClearITPendingBit(RNG_IT_CEI);
+            Rng_Fault(RNG_FAULT_CLOCK);
+        }
+
+        return;
+    }
+
+    if((sr & RNG_SR_DRDY) == 0) return;
+
+    if(Rng_Feed(RNG->DR)) RNG_ITConfig(DISABLE);
+}
+
+/**
+  * @Name    Rng_Init
+  * @brief   启动 RNG, 等待启动检测完成并取得第一个种子
+  * @param   None
+  * @retval  SUCCESS; 硬件反复检测失败或超时时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+ErrorStatus Rng_Init(void) {
+    NVIC_InitTypeDef nvic;
+
+    Rng_PoolInit(&rng_state, &rng_port);
+
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_RNG, ENABLE);
+    RNG_DeInit();
+
+    nvic.NVIC_IRQChannel = RNG_IRQ_CHANNEL;
+    nvic.NVIC_IRQChannelPreemptionPriority = RNG_IRQ_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+
+    RNG_Cmd(ENABLE);
+    RNG_ITConfig(ENABLE);
+
+    return Rng_PoolStart(SystemCoreClock / 100) == RNG_OK ? SUCCESS : ERROR;
+}
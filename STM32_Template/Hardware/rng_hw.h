@@ -0,0 +1,38 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rng_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RNG 外设接到 Common/rng_pool 的随机数池
+                   池、健康检测和 ChaCha20 在 Common/rng_pool.c, 这里只管 RNG 时钟、中断和取数;
+                   Rng_Fill / Rng_Raw / Rng_Available / Rng_TlsCallback / Rng_GetStats 见 rng_pool.h.
+  * Function List:
+                   Rng_Init
+                   Rng_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __RNG_HW_H_
+#define __RNG_HW_H_
+
+#include "stm32f4xx_conf.h"
+#include "rng_pool.h"
+
+#if defined(STM32F410xx) || defined(STM32F412xG) || defined(STM32F413_423xx)
+#define RNG_IRQ_CHANNEL         RNG_IRQn
+#else
+#define RNG_IRQ_CHANNEL         HASH_RNG_IRQn   //与 HASH 共用, 中断服务函数为 HASH_RNG_IRQHandler
+#endif
+#define RNG_IRQ_PRIORITY        6       //后台补充, 优先级放低
+
+ErrorStatus Rng_Init(void);
+void Rng_IRQHandler(void);
+
+#endif
@@ -0,0 +1,452 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : rtc_epoch.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RTC 单调时间与事件时间戳
+                   1. 闹钟 B 中断一进入就读自由计数器, 再等一次影子寄存器同步(RSF, 最多 2 个 RTCCLK),
+                      读 TR/DR 查表换成秒计数, 两者作为一对锁存; 同步等待和 BCD 转换每秒只做一次,
+                      每秒都等 RSF 是为了从 STOP 唤醒后不读到停止前的影子值;
+                   2. 外推: 秒内 us = (计数器 - 锁存值) * 倍率 >> 31, 倍率 = 10^6 * 2^31 / 每秒计数,
+                      只在锁存时更新; 每秒计数先取标称值, 之后取相邻两次闹钟中断之间的实测值,
+                      偏离标称值 1/64 以上的不用(中断被挡住), 这样外推自动对齐到 RTC 晶振;
+                   3. 读锁存值和计数器在关中断下进行, 保证是同一对; 闹钟中断未及时执行时截断到 999999,
+                      不会越过下一秒;
+                   4. 锁存的秒对应中断进入的时刻, 整体比 RTC 进位晚一个中断时延, 所以 RTCE_ALARM_PRIORITY 取最高;
+                   5. 事件: TSTR/TSDR 没有年, 年份取当前年, 得到的时刻比当前晚 1 秒以上(或当前年没有
+                      这一天, 如 2 月 29 日)时退一年; 子秒 TSSSR 向下计数, 按 Rtce_Init 时算好的倍率换成 us.
+                   闹钟 B 经 EXTI17 可唤醒 STOP, 与 Lp_Idle 同用时 STOP 每秒被唤醒一次.
+  * Function List:
+
+  **********************************************************
+ */
+#include "rtc_epoch.h"
+#include "string.h"
+
+#define RTCE_US_PER_SEC         1000000UL
+#define RTCE_US_MAX             (RTCE_US_PER_SEC - 1)
+#define RTCE_MULT_SHIFT         31
+#define RTCE_SS_SHIFT           16
+#define RTCE_CALIB_TOL_SHIFT    6           //实测每秒计数允许偏离标称值 1/64
+#define RTCE_COUNTER_HZ_MIN     1000000UL   //低于 1MHz 时倍率超出 32 位
+
+static Rtce_Config rtce_cfg;
+static uint32_t rtce_hz;
+static uint32_t rtce_prediv_s;
+static uint32_t rtce_ss_mult;               //子秒计数换 us 的倍率
+static Rtce_Stats rtce_stats;
+static uint8_t rtce_ready;
+
+/* 闹钟中断锁存, 读时关中断 */
+static volatile uint32_t rtce_sec;
+static volatile uint32_t rtce_base;         //锁存时的自由计数器
+static volatile uint32_t rtce_ticks;
+static volatile uint32_t rtce_mult;
+static uint8_t rtce_year;                   //十进制, 给事件补年份
+static uint8_t rtce_calib;                  //0: 下一次锁存不参与测频(刚初始化或重新同步)
+
+/* 事件队列, 中断写 rtce_ev_in, 主循环写 rtce_ev_out */
+static Rtce_Event rtce_ev[RTCE_EVENT_NUM];
+static volatile uint8_t rtce_ev_in;
+static volatile uint8_t rtce_ev_out;
+
+static uint32_t rtce_counter(void) {
+    return rtce_cfg.Counter ? rtce_cfg.Counter() : DWT->CYCCNT;
+}
+
+static void rtce_set_rate(uint32_t Ticks) {
+    rtce_ticks = Ticks;
+    rtce_mult = (uint32_t)(((uint64_t)RTCE_US_PER_SEC << RTCE_MULT_SHIFT) / Ticks);
+}
+
+/* 调用方已关中断 */
+static uint32_t rtce_sub_us(uint32_t Cnt) {
+    uint32_t delta = Cnt - rtce_base;
+
+    if(delta >= rtce_ticks) {
+        rtce_stats.Clamp++;
+        return RTCE_US_MAX;
+    }
+
+    return (uint32_t)(((uint64_t)delta * rtce_mult) >> RTCE_MULT_SHIFT);
+}
+
+/* 等一次影子寄存器同步, 读出日历 */
+static ErrorStatus rtce_read(uint32_t *Sec, uint8_t *Year) {
+    Cal_DateTime dt;
+    uint32_t tr, dr;
+
+    (void)RTC->DR;                          //解除之前只读 TR 留下的锁定, 否则 RSF 不会置位
+
+    if((RTC->CR & RTC_CR_BYPSHAD) == 0 && RTC_WaitForSynchro() == ERROR) return ERROR;
+
+    tr = RTC->TR;
+    dr = RTC->DR;
+
+    dt.Year = (dr & (RTC_DR_YT | RTC_DR_YU)) >> 16;
+    dt.Month = (dr & (RTC_DR_MT | RTC_DR_MU)) >> 8;
+    dt.Day = dr & (RTC_DR_DT | RTC_DR_DU);
+    dt.Hour = (tr & (RTC_TR_HT | RTC_TR_HU)) >> 16;
+    dt.Minute = (tr & (RTC_TR_MNT | RTC_TR_MNU)) >> 8;
+    dt.Second = tr & (RTC_TR_ST | RTC_TR_SU);
+
+    *Sec = Cal_ToEpoch(CAL_FMT_BCD, &dt);
+    *Year = Cal_Bcd2Dec(dt.Year);
+
+    return *Sec == CAL_EPOCH_INVD ? ERROR : SUCCESS;
+}
+
+/**
+  * @Name    Rtce_Init
+  * @brief   读一次 RTC 作为起点, 设置闹钟 B 每秒中断
+  * @param   Cfg: 自由计数器
+  * @retval  SUCCESS; RTC 未打开、为 12 小时制、计数器低于 1MHz 或读日历失败时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          在 RTC 初始化之后调用; 使用默认的 DWT 计数时, 修改系统时钟后需重新调用.
+          调用后第一秒的秒内值从 0 起算, 偏小. 在 RTC_Alarm_IRQHandler 中调用 Rtce_AlarmIRQHandler.
+ **/
+ErrorStatus Rtce_Init(const Rtce_Config *Cfg) {
+    NVIC_InitTypeDef nvic;
+    EXTI_InitTypeDef exti;
+    RTC_AlarmTypeDef alarm;
+    uint32_t sec;
+    uint8_t year;
+
+    if(Cfg == NULL) return ERROR;
+
+    if((RCC->BDCR & RCC_BDCR_RTCEN) == 0 || (RTC->CR & RTC_CR_FMT) != 0) return ERROR;
+
+    rtce_ready = 0;
+    rtce_cfg = *Cfg;
+    rtce_hz = Cfg->CounterHz ? Cfg->CounterHz : SystemCoreClock;
+
+    if(rtce_hz < RTCE_COUNTER_HZ_MIN) return ERROR;
+
+    if(rtce_cfg.Counter == NULL) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    memset(&rtce_stats, 0, sizeof(rtce_stats));
+    rtce_set_rate(rtce_hz);
+    rtce_prediv_s = RTC->PRER & RTC_PRER_PREDIV_S;
+    rtce_ss_mult = (uint32_t)(((uint64_t)RTCE_US_PER_SEC << RTCE_SS_SHIFT) / (rtce_prediv_s + 1));
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+    PWR_BackupAccessCmd(ENABLE);
+
+    /* 全部字段屏蔽, 子秒不比较: 每次秒进位置 ALRBF */
+    if(RTC_AlarmCmd(RTC_Alarm_B, DISABLE) == ERROR) return ERROR;
+
+    RTC_AlarmStructInit(&alarm);
+    alarm.RTC_AlarmMask = RTC_AlarmMask_All;
+    RTC_SetAlarm(RTC_Format_BIN, RTC_Alarm_B, &alarm);
+    RTC_AlarmSubSecondConfig(RTC_Alarm_B, 0, RTC_AlarmSubSecondMask_All);
+    RTC_ITConfig(RTC_IT_ALRB, ENABLE);
+    RTC_ClearFlag(RTC_FLAG_ALRBF);
+
+    if(rtce_read(&sec, &year) == ERROR) return ERROR;
+
+    rtce_base = rtce_counter();
+    rtce_sec = sec;
+    rtce_year = year;
+    rtce_calib = 0;
+
+    exti.EXTI_Line = EXTI_Line17;
+    exti.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti.EXTI_Trigger = EXTI_Trigger_Rising;
+    exti.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&exti);
+    EXTI_ClearITPendingBit(EXTI_Line17);
+
+    nvic.NVIC_IRQChannel = RTC_Alarm_IRQn;
+    nvic.NVIC_IRQChannelPreemptionPriority = RTCE_ALARM_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+
+    rtce_ready = 1;
+
+    return RTC_AlarmCmd(RTC_Alarm_B, ENABLE);
+}
+
+/**
+  * @Name    Rtce_Resync
+  * @brief   RTC 被改写后重新读一次日历
+  * @param   None
+  * @retval  SUCCESS; 未初始化或读日历失败时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          秒数不变时保留原锁存; 改变时从调用时刻起算, 时间可能后退.
+ **/
+ErrorStatus Rtce_Resync(void) {
+    uint32_t sec, primask;
+    uint8_t year;
+    ErrorStatus status;
+
+    if(!rtce_ready) return ERROR;
+
+    NVIC_DisableIRQ(RTC_Alarm_IRQn);
+
+    status = rtce_read(&sec, &year);
+
+    if(status == SUCCESS && sec != rtce_sec) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        rtce_base = rtce_counter();
+        rtce_sec = sec;
+        rtce_year = year;
+        rtce_calib = 0;
+        __set_PRIMASK(primask);
+    }
+
+    NVIC_EnableIRQ(RTC_Alarm_IRQn);
+
+    return status;
+}
+
+/**
+  * @Name    Rtce_GetSec
+  * @brief   当前秒计数
+  * @param   None
+  * @retval  2000-01-01 00:00:00 起的秒数, 最近一次闹钟中断锁存的值
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Rtce_GetSec(void) {
+    return rtce_sec;
+}
+
+/**
+  * @Name    Rtce_GetTime
+  * @brief   当前时刻, 秒 + 秒内 us
+  * @param   Time: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          可在中断中调用; 未初始化时为 0.
+ **/
+void Rtce_GetTime(Rtce_Time *Time) {
+    uint32_t primask;
+
+    if(Time == NULL) return;
+
+    if(!rtce_ready) {
+        Time->Sec = 0;
+        Time->Us = 0;
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    Time->Us = rtce_sub_us(rtce_counter());
+    Time->Sec = rtce_sec;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @Name    Rtce_GetUs
+  * @brief   当前时刻, us
+  * @param   None
+  * @retval  2000-01-01 00:00:00 起的 us, 单调不减(RTC 被改写时除外)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint64_t Rtce_GetUs(void) {
+    Rtce_Time t;
+
+    Rtce_GetTime(&t);
+
+    return (uint64_t)t.Sec * RTCE_US_PER_SEC + t.Us;
+}
+
+/**
+  * @Name    Rtce_EventInit
+  * @brief   打开时间戳单元作为事件时间戳
+  * @param   Edge: RTC_TimeStampEdge_Rising / RTC_TimeStampEdge_Falling
+  * @retval  SUCCESS; 未调用 Rtce_Init 时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          引脚由 RTC_TimeStampPinSelection 选择(默认 PC13), 无需配置 GPIO.
+          在 TAMP_STAMP_IRQHandler 中调用 Rtce_TimeStampIRQHandler.
+ **/
+ErrorStatus Rtce_EventInit(uint32_t Edge) {
+    NVIC_InitTypeDef nvic;
+    EXTI_InitTypeDef exti;
+
+    if(!rtce_ready) return ERROR;
+
+    RTC_ITConfig(RTC_IT_TS, DISABLE);
+    RTC_TimeStampCmd(Edge, DISABLE);
+    RTC_ClearFlag(RTC_FLAG_TSF);
+    RTC_ClearFlag(RTC_FLAG_TSOVF);
+    rtce_ev_in = rtce_ev_out = 0;
+
+    exti.EXTI_Line = EXTI_Line21;
+    exti.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti.EXTI_Trigger = EXTI_Trigger_Rising;
+    exti.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&exti);
+    EXTI_ClearITPendingBit(EXTI_Line21);
+
+    nvic.NVIC_IRQChannel = TAMP_STAMP_IRQn;
+    nvic.NVIC_IRQChannelPreemptionPriority = RTCE_TS_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+
+    RTC_ITConfig(RTC_IT_TS, ENABLE);
+    RTC_TimeStampCmd(Edge, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    Rtce_GetEvent
+  * @brief   取出一个事件
+  * @param   Event: 输出
+  * @retval  SUCCESS; 没有事件时 ERROR
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+ErrorStatus Rtce_GetEvent(Rtce_Event *Event) {
+    if(Event == NULL || rtce_ev_in == rtce_ev_out) return ERROR;
+
+    *Event = rtce_ev[rtce_ev_out & (RTCE_EVENT_NUM - 1)];
+    rtce_ev_out++;
+
+    return SUCCESS;
+}
+
+/**
+  * @Name    Rtce_GetStats
+  * @brief   统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Rtce_GetStats(Rtce_Stats *Stats) {
+    uint32_t primask;
+
+    if(Stats == NULL) return;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *Stats = rtce_stats;
+    Stats->TicksPerSec = rtce_ticks;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @Name    Rtce_AlarmIRQHandler
+  * @brief   闹钟 B 中断, 在 RTC_Alarm_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          只处理闹钟 B; 同时使用闹钟 A 时, 闹钟 A 的标志由调用方处理.
+ **/
+void Rtce_AlarmIRQHandler(void) {
+    uint32_t cnt = rtce_counter();
+    uint32_t sec, ticks, tol;
+    uint8_t year;
+
+    if(RTC_GetITStatus(RTC_IT_ALRB) == RESET) return;
+
+    RTC_ClearITPendingBit(RTC_IT_ALRB);
+    EXTI_ClearITPendingBit(EXTI_Line17);
+
+    if(rtce_read(&sec, &year) == ERROR) {
+        rtce_stats.ReadFail++;
+        return;
+    }
+
+    if(sec == rtce_sec + 1) {
+        ticks = cnt - rtce_base;
+        tol = rtce_hz >> RTCE_CALIB_TOL_SHIFT;
+
+        if(rtce_calib && ticks > rtce_hz - tol && ticks < rtce_hz + tol) rtce_set_rate(ticks);
+    } else if(sec != rtce_sec) {
+        rtce_stats.Skip++;
+    } else {
+        return;                             //同一秒内重复进入, 保留原锁存, 秒内时间不回退
+    }
+
+    rtce_sec = sec;
+    rtce_base = cnt;
+    rtce_year = year;
+    rtce_calib = 1;
+    rtce_stats.Sync++;
+}
+
+/**
+  * @Name    Rtce_TimeStampIRQHandler
+  * @brief   时间戳中断, 在 TAMP_STAMP_IRQHandler 中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          先清 TSF 再查 TSOVF(参考手册要求的顺序), 否则紧接着的第二个事件可能漏记溢出.
+ **/
+void Rtce_TimeStampIRQHandler(void) {
+    Cal_DateTime dt;
+    Rtce_Event *ev;
+    uint32_t tr, dr, ss, sec;
+
+    if(RTC_GetITStatus(RTC_IT_TS) == RESET) return;
+
+    tr = RTC->TSTR;
+    dr = RTC->TSDR;
+    ss = RTC->TSSSR;
+    RTC_ClearITPendingBit(RTC_IT_TS);
+
+    if(RTC_GetFlagStatus(RTC_FLAG_TSOVF) != RESET) {
+        RTC_ClearFlag(RTC_FLAG_TSOVF);
+        rtce_stats.EventLost++;
+    }
+
+    EXTI_ClearITPendingBit(EXTI_Line21);
+
+    dt.Month = Cal_Bcd2Dec((dr & (RTC_DR_MT | RTC_DR_MU)) >> 8);
+    dt.Day = Cal_Bcd2Dec(dr & (RTC_DR_DT | RTC_DR_DU));
+    dt.Hour = Cal_Bcd2Dec((tr & (RTC_TR_HT | RTC_TR_HU)) >> 16);
+    dt.Minute = Cal_Bcd2Dec((tr & (RTC_TR_MNT | RTC_TR_MNU)) >> 8);
+    dt.Second = Cal_Bcd2Dec(tr & (RTC_TR_ST | RTC_TR_SU));
+    dt.Year = rtce_year;
+    sec = Cal_ToEpoch(CAL_FMT_DEC, &dt);
+
+    if((sec == CAL_EPOCH_INVD || sec > rtce_sec + 1) && rtce_year != 0) {
+        dt.Year = rtce_year - 1;
+        sec = Cal_ToEpoch(CAL_FMT_DEC, &dt);
+    }
+
+    if(sec == CAL_EPOCH_INVD || (uint8_t)(rtce_ev_in - rtce_ev_out) >= RTCE_EVENT_NUM) {
+        rtce_stats.EventLost++;
+        return;
+    }
+
+    ev = &rtce_ev[rtce_ev_in & (RTCE_EVENT_NUM - 1)];
+    ev->Sec = sec;
+    ev->Us = ss > rtce_prediv_s ? 0 : (uint32_t)(((uint64_t)(rtce_prediv_s - ss) * rtce_ss_mult) >> RTCE_SS_SHIFT);
+    rtce_ev_in++;
+}
@@ -0,0 +1,81 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : rtc_epoch.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : RTC 单调时间与事件时间戳
+                   闹钟 B 屏蔽全部字段, 每秒触发一次, 中断里等一次影子寄存器同步, 读日历换成秒计数
+                   (calendar.h, 2000 年起), 同时锁存自由计数器; Rtce_GetTime/Rtce_GetUs 只读锁存值和
+                   自由计数器外推秒内 us, 不等 RSF, 不做 BCD 转换和除法, 可在中断里大量调用.
+                   外推结果在秒内截断到 999999, 跨秒由闹钟中断推进, 所以单调不减.
+                   时间戳单元(RTC_TS 引脚)作为硬件事件时间戳: 边沿由 RTC 锁存到子秒,
+                   中断里补上年份, 放入队列.
+                   RTC 须已用 24 小时制初始化; 闹钟 A 和唤醒定时器(Lp_Idle 使用)不受影响.
+                   RTC_SetDate/RTC_SetTime 之后调用 Rtce_Resync.
+  * Function List:
+                   Rtce_Init
+                   Rtce_Resync
+                   Rtce_GetSec
+                   Rtce_GetTime
+                   Rtce_GetUs
+                   Rtce_EventInit
+                   Rtce_GetEvent
+                   Rtce_GetStats
+                   Rtce_AlarmIRQHandler
+                   Rtce_TimeStampIRQHandler
+  ******************************************************
+**/
+
+#ifndef __RTC_EPOCH_H_
+#define __RTC_EPOCH_H_
+
+#include "stm32f4xx_conf.h"
+#include "calendar.h"
+
+#define RTCE_ALARM_PRIORITY     0       //闹钟 B 中断, 锁存越及时外推越准
+#define RTCE_TS_PRIORITY        5       //时间戳中断, 时刻已由硬件锁存, 优先级可放低
+#define RTCE_EVENT_NUM          8       //事件队列长度, 须为 2 的幂
+
+typedef struct {
+    uint32_t Sec;               //2000-01-01 00:00:00 起的秒数
+    uint32_t Us;                //秒内 us, 0~999999
+} Rtce_Time;
+
+typedef struct {
+    uint32_t Sec;               //事件所在的秒
+    uint32_t Us;                //秒内 us, 分辨率 1 / (PREDIV_S + 1) 秒
+} Rtce_Event;
+
+typedef struct {
+    uint32_t Sync;              //闹钟中断次数
+    uint32_t Skip;              //两次闹钟中断之间 RTC 走了不止 1 秒, 中断被挡住过久
+    uint32_t ReadFail;          //影子寄存器同步超时或读到非法日历
+    uint32_t Clamp;             //外推到 1 秒以上被截断, 闹钟中断未及时执行
+    uint32_t TicksPerSec;       //实测自由计数器每秒计数, 用于外推
+    uint32_t EventLost;         //队列满或时间戳溢出(TSOVF)
+} Rtce_Stats;
+
+typedef struct {
+    uint32_t CounterHz;             //自由计数器标称频率, 0 时取 SystemCoreClock
+    uint32_t (*Counter)(void);      //可为 NULL, 此时用 DWT 周期计数; 32 位向上计数, 回绕周期须大于 2 秒
+} Rtce_Config;
+
+ErrorStatus Rtce_Init(const Rtce_Config *Cfg);
+ErrorStatus Rtce_Resync(void);
+uint32_t Rtce_GetSec(void);
+void Rtce_GetTime(Rtce_Time *Time);
+uint64_t Rtce_GetUs(void);
+ErrorStatus Rtce_EventInit(uint32_t Edge);
+ErrorStatus Rtce_GetEvent(Rtce_Event *Event);
+void Rtce_GetStats(Rtce_Stats *Stats);
+void Rtce_AlarmIRQHandler(void);
+void Rtce_TimeStampIRQHandler(void);
+
+#endif
@@ -0,0 +1,335 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 任意波形播放
+                   1. TIM6 更新事件作 TRGO, 同时触发 DAC1/DAC2, 每次触发 DAC 发一次 DMA 请求;
+                   2. 双通道只用 DAC1 的 DMA 请求(Stream5), 32 位写 DHR12RD 同时装入两路数据;
+                   3. 改采样率只改预分频和自动重装载值, 两者都带影子寄存器, 在下一个更新事件生效,
+                      输出不中断;
+                   4. 流播放用 DMA 双缓冲模式, 两块是 Buf 的前后两半, 块完成后交给 Wave_StreamDone.
+  * Function List:
+
+  **********************************************************
+ */
+#include "wave_player.h"
+
+#define WAVE_TIMER              TIM6
+
+static uint8_t wave_channels;
+static DMA_Stream_TypeDef *wave_stream_dma;
+static uint32_t wave_it_tc;
+static uint32_t wave_dac;                       //发 DMA 请求的 DAC 通道
+static Wave_Stream wave_stream;
+
+/**
+  * @Name    Wave_TimerClock
+  * @brief   TIM6 计数时钟
+  * @param   None
+  * @retval  Hz
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          APB1 不分频时等于 PCLK1, 分频时为 PCLK1 的 2 倍.
+ **/
+static uint32_t Wave_TimerClock(void) {
+    RCC_ClocksTypeDef clocks;
+
+    RCC_GetClocksFreq(&clocks);
+
+    if((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) return clocks.PCLK1_Frequency;
+
+    return clocks.PCLK1_Frequency * 2;
+}
+
+/**
+  * @Name    Wave_CheckUnderrun
+  * @brief   检查并恢复 DAC DMA 欠载
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          欠载后 DAC 不再发 DMA 请求, 清标志并重新使能 DMA 请求后继续.
+ **/
+static void Wave_CheckUnderrun(void) {
+    if(wave_channels == 0 || DAC_GetFlagStatus(wave_dac, DAC_FLAG_DMAUDR) == RESET) return;
+
+    DAC_ClearFlag(wave_dac, DAC_FLAG_DMAUDR);
+    DAC_DMACmd(wave_dac, DISABLE);
+    DAC_DMACmd(wave_dac, ENABLE);
+    wave_stream.Stats.DacUnderruns++;
+}
+
+/**
+  * @Name    Wave_Init
+  * @brief   初始化引脚、DAC、TIM6 和 DMA 中断
+  * @param   Channels: WAVE_CH0 / WAVE_CH1 / WAVE_CH_BOTH
+  * @retval  WAVE_OK; 通道参数错误时 WAVE_ERR_PARAM
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+int32_t Wave_Init(uint8_t Channels) {
+    GPIO_InitTypeDef gpio;
+    DAC_InitTypeDef dac;
+    TIM_TimeBaseInitTypeDef timer;
+    NVIC_InitTypeDef nvic;
+
+    if(Channels == 0 || (Channels & ~WAVE_CH_BOTH) != 0) return WAVE_ERR_PARAM;
+
+    wave_channels = Channels;
+    wave_stream.Callback = 0;
+    wave_stream.Stats.DacUnderruns = 0;
+
+    if(Channels == WAVE_CH1) {
+        wave_dac = DAC_Channel_2;
+        wave_stream_dma = WAVE_CH1_STREAM;
+        wave_it_tc = WAVE_CH1_IT_TC;
+    } else {
+        wave_dac = DAC_Channel_1;
+        wave_stream_dma = WAVE_CH0_STREAM;
+        wave_it_tc = WAVE_CH0_IT_TC;
+    }
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA | RCC_AHB1Periph_DMA1, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_DAC | RCC_APB1Periph_TIM6, ENABLE);
+
+    GPIO_StructInit(&gpio);
+    gpio.GPIO_Pin = 0;
+
+    if(Channels & WAVE_CH0) gpio.GPIO_Pin |= GPIO_Pin_4;
+
+    if(Channels & WAVE_CH1) gpio.GPIO_Pin |= GPIO_Pin_5;
+
+    gpio.GPIO_Mode = GPIO_Mode_AN;
+    gpio.GPIO_PuPd = GPIO_PuPd_NOPULL;
+    GPIO_Init(GPIOA, &gpio);
+
+    DAC_DeInit();
+    DAC_StructInit(&dac);
+    dac.DAC_Trigger = DAC_Trigger_T6_TRGO;
+    dac.DAC_WaveGeneration = DAC_WaveGeneration_None;
+    dac.DAC_OutputBuffer = DAC_OutputBuffer_Enable;
+
+    if(Channels & WAVE_CH0) {
+        DAC_Init(DAC_Channel_1, &dac);
+        DAC_Cmd(DAC_Channel_1, ENABLE);
+    }
+
+    if(Channels & WAVE_CH1) {
+        DAC_Init(DAC_Channel_2, &dac);
+        DAC_Cmd(DAC_Channel_2, ENABLE);
+    }
+
+    TIM_DeInit(WAVE_TIMER);
+    TIM_TimeBaseStructInit(&timer);
+    timer.TIM_Period = 0xFFFF;
+    TIM_TimeBaseInit(WAVE_TIMER, &timer);
+    TIM_ARRPreloadConfig(WAVE_TIMER, ENABLE);
+    TIM_SelectOutputTrigger(WAVE_TIMER, TIM_TRGOSource_Update);
+
+    nvic.NVIC_IRQChannel = Channels == WAVE_CH1 ? WAVE_CH1_IRQn : WAVE_CH0_IRQn;
+    nvic.NVIC_IRQChannelPreemptionPriority = WAVE_IRQ_PRIORITY;
+    nvic.NVIC_IRQChannelSubPriority = 0;
+    nvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&nvic);
+
+    return WAVE_OK;
+}
+
+/**
+  * @Name    Wave_SetRate
+  * @brief   设置采样率, 播放中也可调用
+  * @param   Rate: 采样率(Hz)
+  * @retval  实际采样率(Hz, 向下取整)
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          预分频 1~65536 任意, 由 Wave_PlanRate 换算.
+ **/
+uint32_t Wave_SetRate(uint32_t Rate) {
+    uint32_t div, period, actual;
+
+    actual = Wave_PlanRate(Wave_TimerClock(), Rate, 65536, 0, &div, &period);
+    TIM_PrescalerConfig(WAVE_TIMER, (uint16_t)(div - 1), TIM_PSCReloadMode_Update);
+    TIM_SetAutoreload(WAVE_TIMER, period - 1);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_DMAStart
+  * @brief   配置并启动 DMA 和 TIM6
+  * @param   Buf0: 第一块
+  * @param   Buf1: 第二块, 为 0 时只在 Buf0 上循环
+  * @param   Samples: 每块样本数
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+static void Wave_DMAStart(const void *Buf0, const void *Buf1, uint32_t Samples) {
+    DMA_InitTypeDef dma;
+
+    DMA_DeInit(wave_stream_dma);
+    DMA_StructInit(&dma);
+    dma.DMA_Channel = WAVE_DMA_CHANNEL;
+
+    if(wave_channels == WAVE_CH_BOTH) {
+        dma.DMA_PeripheralBaseAddr = (uint32_t)&DAC->DHR12RD;
+        dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+        dma.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    } else {
+        dma.DMA_PeripheralBaseAddr = wave_channels == WAVE_CH0 ? (uint32_t)&DAC->DHR12R1 : (uint32_t)&DAC->DHR12R2;
+        dma.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+        dma.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    }
+
+    dma.DMA_Memory0BaseAddr = (uint32_t)Buf0;
+    dma.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    dma.DMA_BufferSize = Samples;
+    dma.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma.DMA_Mode = DMA_Mode_Circular;
+    dma.DMA_Priority = DMA_Priority_VeryHigh;
+    dma.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_Init(wave_stream_dma, &dma);
+
+    if(Buf1) {
+        DMA_DoubleBufferModeConfig(wave_stream_dma, (uint32_t)Buf1, DMA_Memory_0);
+        DMA_DoubleBufferModeCmd(wave_stream_dma, ENABLE);
+        DMA_ClearITPendingBit(wave_stream_dma, wave_it_tc);
+        DMA_ITConfig(wave_stream_dma, DMA_IT_TC, ENABLE);
+    }
+
+    DAC_ClearFlag(wave_dac, DAC_FLAG_DMAUDR);
+    DMA_Cmd(wave_stream_dma, ENABLE);
+    DAC_DMACmd(wave_dac, ENABLE);
+
+    TIM_SetCounter(WAVE_TIMER, 0);
+    TIM_Cmd(WAVE_TIMER, ENABLE);
+}
+
+/**
+  * @Name    Wave_PlayTable
+  * @brief   循环播放一张波形表
+  * @param   Table: 单通道 uint16_t[], 双通道 uint32_t[](Wave_Pack 生成), 播放期间不得修改
+  * @param   Samples: 样本数, 1~WAVE_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz), 输出频率 = Rate / Samples
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Table == 0 || Samples == 0 || Samples > WAVE_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    wave_stream.Callback = 0;
+    actual = Wave_SetRate(Rate);
+    TIM_GenerateEvent(WAVE_TIMER, TIM_EventSource_Update);
+    Wave_DMAStart(Table, 0, Samples);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_PlayStream
+  * @brief   双缓冲流播放
+  * @param   Buf: 连续的两块, 共 2 * Samples 个样本
+  * @param   Samples: 每块样本数, 1~WAVE_MAX_SAMPLES
+  * @param   Rate: 采样率(Hz)
+  * @param   Callback: 填块回调, 启动前先调用两次填满两块
+  * @retval  实际采样率(Hz), 参数错误时为 0
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          回调必须在一块的播放时间(Samples / Rate)内返回.
+ **/
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback) {
+    uint32_t actual;
+
+    if(wave_channels == 0 || Buf == 0 || Callback == 0 || Samples == 0 || Samples > WAVE_MAX_SAMPLES) return 0;
+
+    Wave_Stop();
+    Wave_StreamStart(&wave_stream, Buf, Samples, WAVE_SAMPLE_BYTES(wave_channels), Callback);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    actual = Wave_SetRate(Rate);
+    TIM_GenerateEvent(WAVE_TIMER, TIM_EventSource_Update);
+    Wave_DMAStart(wave_stream.Buf, wave_stream.Buf + wave_stream.BlockBytes, Samples);
+
+    return actual;
+}
+
+/**
+  * @Name    Wave_Stop
+  * @brief   停止播放, 输出保持最后一个样本
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+ **/
+void Wave_Stop(void) {
+    if(wave_channels == 0) return;
+
+    TIM_Cmd(WAVE_TIMER, DISABLE);
+    DAC_DMACmd(wave_dac, DISABLE);
+    DMA_ITConfig(wave_stream_dma, DMA_IT_TC, DISABLE);
+    DMA_Cmd(wave_stream_dma, DISABLE);
+
+    while(DMA_GetCmdStatus(wave_stream_dma) != DISABLE);
+}
+
+static uint8_t Wave_Playing(void) {
+    return (uint8_t)DMA_GetCurrentMemoryTarget(wave_stream_dma);
+}
+
+/**
+  * @Name    Wave_DMA_IRQHandler
+  * @brief   流播放的块完成中断, 在 DMA1_Stream5_IRQHandler(只用 CH1 时为 Stream6)中调用
+  * @param   None
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          DMA 已切到另一块, 刚播完的一块交给 Wave_StreamDone 刷新.
+ **/
+void Wave_DMA_IRQHandler(void) {
+    if(DMA_GetITStatus(wave_stream_dma, wave_it_tc) == RESET) return;
+
+    DMA_ClearITPendingBit(wave_stream_dma, wave_it_tc);
+    Wave_CheckUnderrun();
+    Wave_StreamDone(&wave_stream, Wave_Playing() ^ 1, Wave_Playing, &DWT->CYCCNT);
+}
+
+/**
+  * @Name    Wave_GetStats
+  * @brief   读取运行统计
+  * @param   Stats: 输出
+  * @retval  None
+  * @author  txt1994
+  * @Data    2026-10-19
+  * <description> :
+          表播放不进中断, DAC 欠载在这里检查并恢复.
+ **/
+void Wave_GetStats(Wave_Stats *Stats) {
+    if(wave_stream.Callback == 0) Wave_CheckUnderrun();
+
+    *Stats = wave_stream.Stats;
+}
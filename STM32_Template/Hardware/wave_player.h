@@ -0,0 +1,56 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : wave_player.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DAC 任意波形播放(TIM6 定采样率, DMA1 Stream5/6 搬运)
+                   接口与 GD32/AT32/HC32 模板的 wave_player.h 相同, 波形表生成、采样率换算和
+                   流播放的块管理在 Common/wave_gen.c.
+                   表播放: 循环 DMA 反复输出一张预先算好的表, 不占 CPU, 不进中断;
+                   流播放: DMA 双缓冲, 每播完一块在中断里回调填下一块, 用于长于内存的信号.
+                   双通道时两路样本打包成一个字写入 DHR12RD, 由同一个 TRGO 触发,
+                   两路输出在同一时钟沿更新, 没有通道间偏移.
+                   引脚: PA4 = DAC_OUT1(WAVE_CH0), PA5 = DAC_OUT2(WAVE_CH1).
+  * Function List:
+                   Wave_Init
+                   Wave_PlayTable
+                   Wave_PlayStream
+                   Wave_SetRate
+                   Wave_Stop
+                   Wave_DMA_IRQHandler
+                   Wave_GetStats
+  ******************************************************
+**/
+
+#ifndef __WAVE_PLAYER_H_
+#define __WAVE_PLAYER_H_
+
+#include "stm32f4xx_conf.h"
+#include "wave_gen.h"
+
+/* DMA1: Stream5 通道7 = DAC1, Stream6 通道7 = DAC2; 双通道只用 DAC1 的请求 */
+#define WAVE_CH0_STREAM         DMA1_Stream5
+#define WAVE_CH0_IT_TC          DMA_IT_TCIF5
+#define WAVE_CH0_IRQn           DMA1_Stream5_IRQn
+#define WAVE_CH1_STREAM         DMA1_Stream6
+#define WAVE_CH1_IT_TC          DMA_IT_TCIF6
+#define WAVE_CH1_IRQn           DMA1_Stream6_IRQn
+#define WAVE_DMA_CHANNEL        DMA_Channel_7
+#define WAVE_IRQ_PRIORITY       1
+
+int32_t Wave_Init(uint8_t Channels);
+uint32_t Wave_PlayTable(const void *Table, uint32_t Samples, uint32_t Rate);
+uint32_t Wave_PlayStream(void *Buf, uint32_t Samples, uint32_t Rate, Wave_RefillCallback Callback);
+uint32_t Wave_SetRate(uint32_t Rate);
+void Wave_Stop(void);
+void Wave_DMA_IRQHandler(void);
+void Wave_GetStats(Wave_Stats *Stats);
+
+#endif
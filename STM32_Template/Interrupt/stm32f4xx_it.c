@@ -28,6 +28,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_it.h"
+#include "mem_init.h"
 
 /** @addtogroup Template_Project
   */
@@ -121,10 +122,11 @@ void PendSV_Handler(void) {
 
 /**
   * 简介:  This function handles SysTick Handler.
+  *         周期性中断放在 RAM 中执行(MEM_RAMFUNC), 避免闪存预取缓存未命中时的等待周期.
   * @param  无
   * @retval 无
   */
-void SysTick_Handler(void) {
+MEM_RAMFUNC void SysTick_Handler(void) {
     // TimingDelay_Decrement();
 }
 
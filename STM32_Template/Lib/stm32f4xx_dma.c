@@ -805,7 +805,7 @@ FunctionalState DMA_GetCmdStatus(DMA_Stream_TypeDef* DMAy_Streamx) {
         /* 设置了所选的 DMAy Streamx EN 位(DMA仍在传输) */
         state = ENABLE;
     } else {
-        /* 选中的 DMAy Streamx EN 位被清除(DMA被禁用，所有传输都完成)
+        /* 选中的 DMAy Streamx EN 位被清除(DMA被禁用，所有传输都完成) */
     }
 
     return state;
@@ -51,14 +51,10 @@ extern "C" {
 #if defined ( __CC_ARM   )
 /* ARM 编译器
    ------------
-   RAM functions are defined using the toolchain options.
-   Functions that are executed in RAM should reside in a separate source module.
-   Using the 'Options for File' dialog you can simply change the 'Code / Const'
-   area of a module to a memory space in physical RAM.
-   Available memory areas are declared in the 'Target' tab of the 'Options for Target'
-   dialog.
+   RAM 函数放在 ".RamFunc" 段, 由 Template.sct 放入 RW_IRAM1, __main 从闪存复制到 RAM.
+   与 mem_init.h 中的 MEM_RAMFUNC 相同.
 */
-#define __RAM_FUNC void
+#define __RAM_FUNC void  __attribute__((section(".RamFunc")))
 
 #elif defined ( __ICCARM__ )
 /* ICCARM 编译器
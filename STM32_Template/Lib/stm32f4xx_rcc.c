@@ -2864,4 +2864,189 @@ void RCC_ClearITPendingBit(uint8_t RCC_IT) {
     *(__IO uint8_t *) CIR_BYTE3_ADDRESS = RCC_IT;
 }
 
+/** @defgroup RCC_Group5 时钟快照与唤醒快速恢复函数
+ *  简介   时钟快照与唤醒快速恢复函数
+ *
+@verbatim
+ ===============================================================================
+                ##### 时钟快照与唤醒快速恢复函数 #####
+ ===============================================================================
+    [..]
+      STOP 模式唤醒后系统时钟为 HSI, HSE 和各 PLL 已关闭, 但 PLL 参数和总线预分频仍保留.
+      RCC_SnapshotSave 在时钟配置完成后保存一次当前配置, 唤醒后按快照只重放必要的寄存器写入,
+      不重新校验 PLL 参数, 也不再走 RCC_WaitForHSEStartUp 的阻塞等待.
+
+      (#) RCC_SnapshotRestoreStart 只启动 HSE(或 PLL 源为 HSI 时直接启动 PLL)后立即返回,
+          调用者可在振荡器起振期间恢复外设状态;
+      (#) 之后反复调用 RCC_SnapshotRestorePoll, 每次只检查就绪标志并推进一步,
+          返回 RCC_SNAPSHOT_READY 时已切回原系统时钟;
+      (#) WakeCycles 记录从 RCC_SnapshotRestoreStart 到切回原系统时钟的 DWT 周期数.
+
+      -@- Flash 等待周期在 STOP 中保持不变, 恢复时不修改 FLASH->ACR.
+@endverbatim
+  */
+
+/**
+  * 简介:  保存当前运行的时钟配置。
+  * 参数:  Snapshot: 快照
+  * 返回值: 无
+  * @note   修改系统时钟配置后需重新保存。
+  */
+void RCC_SnapshotSave(RCC_SnapshotTypeDef *Snapshot) {
+    Snapshot->CR = RCC->CR & (RCC_CR_HSEON | RCC_CR_HSEBYP | RCC_CR_CSSON | RCC_CR_PLLON | RCC_CR_PLLI2SON
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+                              | RCC_CR_PLLSAION
+#endif
+                             );
+    Snapshot->CFGR = RCC->CFGR;
+    Snapshot->PLLCFGR = RCC->PLLCFGR;
+    Snapshot->PLLI2SCFGR = RCC->PLLI2SCFGR;
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+    Snapshot->PLLSAICFGR = RCC->PLLSAICFGR;
+    Snapshot->OverDrive = (PWR->CR & PWR_CR_ODEN) ? 1 : 0;
+#else
+    Snapshot->PLLSAICFGR = 0;
+    Snapshot->OverDrive = 0;
+#endif
+    Snapshot->StartCycle = 0;
+    Snapshot->WakeCycles = 0;
+}
+
+/* 按快照打开 PLL, 关闭状态下参数与快照不同时先写入参数 */
+static void RCC_SnapshotPLLOn(const RCC_SnapshotTypeDef *Snapshot) {
+    if ((Snapshot->CR & RCC_CR_PLLON) && (RCC->CR & RCC_CR_PLLON) == 0) {
+        /* PLL 参数只能在 PLL 关闭时写入 */
+        if (RCC->PLLCFGR != Snapshot->PLLCFGR) {
+            RCC->PLLCFGR = Snapshot->PLLCFGR;
+        }
+
+        RCC->CR |= RCC_CR_PLLON;
+    }
+
+    if ((Snapshot->CR & RCC_CR_PLLI2SON) && (RCC->CR & RCC_CR_PLLI2SON) == 0) {
+        if (RCC->PLLI2SCFGR != Snapshot->PLLI2SCFGR) {
+            RCC->PLLI2SCFGR = Snapshot->PLLI2SCFGR;
+        }
+
+        RCC->CR |= RCC_CR_PLLI2SON;
+    }
+
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+    if ((Snapshot->CR & RCC_CR_PLLSAION) && (RCC->CR & RCC_CR_PLLSAION) == 0) {
+        if (RCC->PLLSAICFGR != Snapshot->PLLSAICFGR) {
+            RCC->PLLSAICFGR = Snapshot->PLLSAICFGR;
+        }
+
+        RCC->CR |= RCC_CR_PLLSAION;
+    }
+#endif
+}
+
+/**
+  * 简介:  开始恢复快照, 只启动振荡器, 不等待。
+  * 参数:  Snapshot: RCC_SnapshotSave 保存的快照
+  * 返回值: 无
+  * @note   DWT 周期计数器未打开时会打开它。
+  */
+void RCC_SnapshotRestoreStart(RCC_SnapshotTypeDef *Snapshot) {
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    Snapshot->StartCycle = DWT->CYCCNT;
+    Snapshot->WakeCycles = 0;
+
+    if (Snapshot->CR & RCC_CR_HSEON) {
+        RCC->CR |= Snapshot->CR & (RCC_CR_HSEON | RCC_CR_HSEBYP);
+    } else {
+        /* PLL 源为 HSI, 已在运行 */
+        RCC_SnapshotPLLOn(Snapshot);
+    }
+}
+
+/**
+  * 简介:  推进一步恢复, 不阻塞。
+  * 参数:  Snapshot: 已调用 RCC_SnapshotRestoreStart 的快照
+  * 返回值: RCC_SNAPSHOT_BUSY: 还在等待某个就绪标志; RCC_SNAPSHOT_READY: 已运行在快照的系统时钟上
+  * @note   进度从 RCC/PWR 寄存器读出. STOP 中保留的寄存器只在与快照不同时重写;
+  *         Over-drive 的建立与 PLL 锁定同时进行, 与 SystemClock_Poll 相同。
+  */
+uint8_t RCC_SnapshotRestorePoll(RCC_SnapshotTypeDef *Snapshot) {
+    uint32_t sw = Snapshot->CFGR & RCC_CFGR_SW;
+
+    if (((RCC->CFGR & RCC_CFGR_SWS) >> 2) == sw) {
+        return RCC_SNAPSHOT_READY;
+    }
+
+    if ((Snapshot->CR & RCC_CR_HSEON) && (RCC->CR & RCC_CR_HSERDY) == 0) {
+        return RCC_SNAPSHOT_BUSY;
+    }
+
+    RCC_SnapshotPLLOn(Snapshot);
+
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+    if (Snapshot->OverDrive) {
+        if ((PWR->CR & PWR_CR_ODEN) == 0) {
+            PWR->CR |= PWR_CR_ODEN;
+        }
+
+        if ((PWR->CSR & PWR_CSR_ODRDY) == 0) {
+            return RCC_SNAPSHOT_BUSY;
+        }
+
+        if ((PWR->CR & PWR_CR_ODSWEN) == 0) {
+            PWR->CR |= PWR_CR_ODSWEN;
+        }
+
+        if ((PWR->CSR & PWR_CSR_ODSWRDY) == 0) {
+            return RCC_SNAPSHOT_BUSY;
+        }
+    }
+#endif /* STM32F427_437x || STM32F429_439xx || STM32F446xx || STM32F469_479xx */
+
+    if ((Snapshot->CR & RCC_CR_PLLON) && (RCC->CR & RCC_CR_PLLRDY) == 0) {
+        return RCC_SNAPSHOT_BUSY;
+    }
+
+    /* 预分频和 MCO 设置保留在 CFGR 中, 不同时先写入再切换 */
+    if ((RCC->CFGR & ~(RCC_CFGR_SW | RCC_CFGR_SWS)) != (Snapshot->CFGR & ~(RCC_CFGR_SW | RCC_CFGR_SWS))) {
+        RCC->CFGR = (Snapshot->CFGR & ~(RCC_CFGR_SW | RCC_CFGR_SWS)) | (RCC->CFGR & RCC_CFGR_SW);
+    }
+
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | sw;
+    while (((RCC->CFGR & RCC_CFGR_SWS) >> 2) != sw);
+
+    Snapshot->WakeCycles = DWT->CYCCNT - Snapshot->StartCycle;
+
+    if (Snapshot->CR & RCC_CR_CSSON) {
+        RCC->CR |= RCC_CR_CSSON;
+    }
+
+    SystemCoreClockUpdate();
+
+    return RCC_SNAPSHOT_READY;
+}
+
+/**
+  * 简介:  恢复快照并等待完成。
+  * 参数:  Snapshot: RCC_SnapshotSave 保存的快照
+  * 返回值: SUCCESS: 已运行在快照的系统时钟上;
+  *         ERROR: HSE 或 PLL 在 HSE_STARTUP_TIMEOUT 次查询内未就绪, 系统时钟保持不变
+  */
+ErrorStatus RCC_SnapshotRestore(RCC_SnapshotTypeDef *Snapshot) {
+    __IO uint32_t n = 0;
+
+    RCC_SnapshotRestoreStart(Snapshot);
+
+    while (RCC_SnapshotRestorePoll(Snapshot) == RCC_SNAPSHOT_BUSY) {
+        if (++n == HSE_STARTUP_TIMEOUT) {
+            SystemCoreClockUpdate();
+            return ERROR;
+        }
+    }
+
+    return SUCCESS;
+}
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
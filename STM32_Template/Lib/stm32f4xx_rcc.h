@@ -50,6 +50,18 @@ typedef struct {
     uint32_t PCLK2_Frequency;  /*!<  PCLK2 时钟频率，单位为 Hz  */
 } RCC_ClocksTypeDef;
 
+/* 时钟快照, 由 RCC_SnapshotSave 填写 */
+typedef struct {
+    uint32_t CR;            /*!< HSEON/HSEBYP/CSSON/PLLON/PLLI2SON/PLLSAION 位 */
+    uint32_t CFGR;          /*!< 系统时钟源和总线预分频 */
+    uint32_t PLLCFGR;
+    uint32_t PLLI2SCFGR;
+    uint32_t PLLSAICFGR;    /*!< 没有 PLLSAI 的型号为 0 */
+    uint32_t OverDrive;     /*!< 1: Over-drive 已打开 */
+    uint32_t StartCycle;    /*!< RCC_SnapshotRestoreStart 时的 DWT 周期计数 */
+    uint32_t WakeCycles;    /*!< 从 RCC_SnapshotRestoreStart 到切回原系统时钟的周期数(按唤醒时钟 HSI 计) */
+} RCC_SnapshotTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
 
 /** @defgroup RCC_Exported_Constants
@@ -882,6 +894,15 @@ void        RCC_ClearFlag(void); // 清除 RCC 重置标志。
 ITStatus    RCC_GetITStatus(uint8_t RCC_IT); // 检查是否发生了指定的 RCC 中断。
 void        RCC_ClearITPendingBit(uint8_t RCC_IT); // 清除 RCC 的中断挂起位。
 
+/* 时钟快照与唤醒快速恢复功能 **************************/
+#define RCC_SNAPSHOT_BUSY   0   /* RCC_SnapshotRestorePoll: 还在等待某个就绪标志 */
+#define RCC_SNAPSHOT_READY  1   /* RCC_SnapshotRestorePoll: 已运行在快照的系统时钟上 */
+
+void        RCC_SnapshotSave(RCC_SnapshotTypeDef *Snapshot); // 保存当前运行的时钟配置。
+void        RCC_SnapshotRestoreStart(RCC_SnapshotTypeDef *Snapshot); // 开始恢复快照, 只启动振荡器, 不等待。
+uint8_t     RCC_SnapshotRestorePoll(RCC_SnapshotTypeDef *Snapshot); // 推进一步恢复, 不阻塞。
+ErrorStatus RCC_SnapshotRestore(RCC_SnapshotTypeDef *Snapshot); // 恢复快照并等待完成。
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1088 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Hardware/cam_capture.c 的主机仿真: 用主机编译器编译 cam_capture.c 和库里的 stm32f4xx_dma.c、
+stm32f4xx_dcmi.c, DMA2/DCMI 的寄存器换成主机数组, 由寄存器模型按时钟推进:
+
+    传感器  按像素时钟(一个时钟一个字节)输出行和场消隐, 每个字节由(传感器帧号, 行号, 列号)生成,
+            回调拿到的数据可以反推出来自哪一帧哪一行; 可按 --bad 随机输出行数不对的坏帧;
+    DCMI    帧开始时 CAPTURE 置位才采这一帧, 按 CWSTRTR/CWSIZER 裁剪, 4 字节打包进 8 字 FIFO,
+            FIFO 满时丢字并置 OVR; 帧结束置 FRAME, 快照模式清 CAPTURE; 关闭时清空 FIFO;
+    DMA     Stream1 每个时钟最多从 FIFO 搬一个字(可按 --stall 随机停顿, 轮询仲裁保证停顿后至少
+            有同样长的时间占用总线), NDTR 到 0 置 TCIF,
+            普通模式停流、双缓冲模式切 CT 并从新的地址寄存器开始; 流使能时改写正在使用的
+            地址寄存器置 TEIF 并停流;
+    中断    DMA2_Stream1 与 DCMI 同一抢占优先级互不嵌套, 挂起后随机延迟 0~--irq-lat-us 进入,
+            每次占用 --irq-us; 回调在主循环中执行, 耗时期间模型照常推进, 中断可以插进来.
+
+    cam_pipeline_sim.py lines [--ring 6 --lpb 8 --block-us 300 --frame-ms 1 ...] [--sweep]
+        行模式: 报告交付块数、丢块/丢帧、最大积压和 CPU 占用; --sweep 给出不丢块所需的最少环块数
+    cam_pipeline_sim.py frame [--frame-ms 5 ...]
+        帧模式: 报告交付帧率和丢帧
+    两者都可加 --snapshot(快照模式, 上一帧交付后隔 --snap-us 再要下一帧)、
+    --crop X Y --sensor W H(传感器输出 WxH, 开窗取 --width x --height).
+    按给定配置有丢帧、丢块、FIFO 溢出或同步错误时返回 1: 这组参数下管线跟不上.
+
+    cam_pipeline_sim.py ctest [--cases 40 --seed 1]
+        随机组合模式、快照、裁剪、像素宽度、消隐、环大小、回调耗时、中断延迟、DMA 停顿和坏帧,
+        其中留有余量的配置(回调和中断都远快于数据)必须不丢数据、没有同步错误.
+
+每次运行都检查(违反即失败):
+    1. 使能 DMA 流前已打开时钟、清除该流全部标志; 配置为通道 1、外设到存储器、字宽、FIFO 满阈值、
+       存储器 4 拍突发, PAR 指向 DCMI->DR, NDTR 为配置的一帧/一块字数, 地址 16 字节对齐且在缓冲内;
+       流使能期间不改受保护的 CR 位、NDTR, 不写正在使用的地址寄存器; DCMI 使能期间不改配置;
+    2. 回调拿到的帧/块的每一行都来自同一传感器帧, 行号与裁剪后的位置一致, 字节逐一正确;
+       回调执行期间 DMA 不写这块数据(回调前后内容相同);
+    3. 帧序号递增, 不交付比上次更旧的传感器帧; 行模式块的 FIRST/LAST 与行号一致,
+       同一帧的块行号递增, 不带 GAP 时连续;
+    4. Frames = 交付 + 丢帧(帧模式), 传输完成次数 = 交付块 + 丢块(行模式), 无坏帧和溢出时没有同步错误;
+       坏帧之后管线恢复, 快照模式每次 Cam_Snapshot 恰好得到一帧;
+    5. Cam_Init 拒绝 CCM 缓冲、未对齐缓冲和非法的块参数, 且拒绝时不碰外设;
+       Cam_Stop 后 DCMI 和 DMA 流都已关闭.
+修改 cam_capture.c 后运行一次 ctest.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'Hardware', 'cam_capture.c')
+LIBS = [os.path.join(ROOT, 'Lib', 'stm32f4xx_dma.c'), os.path.join(ROOT, 'Lib', 'stm32f4xx_dcmi.c')]
+INCLUDES = ['User', 'Lib', 'Interrupt', 'Core', 'Hardware']
+MAX_REPORT = 20
+CPU_MHZ = 168.0
+RUN_TIMEOUT = 120
+
+# 库函数里写寄存器的改名, 驱动里同名的包装先调库函数再让模型处理这次写入
+WRAPPED = ['DMA_DeInit', 'DMA_Init', 'DMA_Cmd', 'DMA_ClearITPendingBit', 'DMA_MemoryTargetConfig',
+           'DMA_DoubleBufferModeConfig', 'DMA_DoubleBufferModeCmd', 'DMA_SetCurrDataCounter',
+           'DMA_ITConfig', 'DMA_GetCmdStatus', 'DCMI_DeInit', 'DCMI_Init', 'DCMI_CROPConfig',
+           'DCMI_CROPCmd', 'DCMI_ClearITPendingBit', 'DCMI_ITConfig', 'DCMI_Cmd', 'DCMI_CaptureCmd']
+
+# 强制包含在 stm32f4xx.h 之后: DMA1/DMA2/DCMI/DWT/CoreDebug 指到主机数组
+HOST_REGS = r'''
+#ifndef __HOST_REGS_H
+#define __HOST_REGS_H
+#include "stm32f4xx.h"
+extern uint32_t HOST_au32Dma[2][64];
+extern DCMI_TypeDef HOST_stcDcmi;
+extern DWT_Type HOST_stcDwt;
+extern CoreDebug_Type HOST_stcCoreDebug;
+#undef DMA1_BASE
+#define DMA1_BASE   ((uint32_t)(uintptr_t)HOST_au32Dma[0])
+#undef DMA2_BASE
+#define DMA2_BASE   ((uint32_t)(uintptr_t)HOST_au32Dma[1])
+#undef DCMI_BASE
+#define DCMI_BASE   ((uint32_t)(uintptr_t)&HOST_stcDcmi)
+#undef DWT
+#define DWT         (&HOST_stcDwt)
+#undef CoreDebug
+#define CoreDebug   (&HOST_stcCoreDebug)
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cam_capture.c"
+
+#define HOST_MEM_BYTES      (4UL << 20)
+#define HOST_NONE           (~(uint64_t)0)
+#define HOST_STREAM_FLAGS   (DMA_LISR_FEIF1 | DMA_LISR_DMEIF1 | DMA_LISR_TEIF1 | DMA_LISR_HTIF1 | DMA_LISR_TCIF1)
+#define HOST_CR_PROTECTED   (~(DMA_SxCR_EN | DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE))
+#define HOST_IRQ_DMA        0
+#define HOST_IRQ_DCMI       1
+
+uint32_t HOST_au32Dma[2][64];
+DCMI_TypeDef HOST_stcDcmi;
+DWT_Type HOST_stcDwt;
+CoreDebug_Type HOST_stcCoreDebug;
+static uint8_t host_mem[HOST_MEM_BYTES] __attribute__((aligned(64)));
+
+#define X(name, ret, args, call) ret HOST_##name##_ args;
+#define WRAP_LIST \
+    X(DMA_DeInit, void, (DMA_Stream_TypeDef *s), (s)) \
+    X(DMA_Init, void, (DMA_Stream_TypeDef *s, DMA_InitTypeDef *i), (s, i)) \
+    X(DMA_Cmd, void, (DMA_Stream_TypeDef *s, FunctionalState n), (s, n)) \
+    X(DMA_ClearITPendingBit, void, (DMA_Stream_TypeDef *s, uint32_t it), (s, it)) \
+    X(DMA_MemoryTargetConfig, void, (DMA_Stream_TypeDef *s, uint32_t a, uint32_t m), (s, a, m)) \
+    X(DMA_DoubleBufferModeConfig, void, (DMA_Stream_TypeDef *s, uint32_t a, uint32_t m), (s, a, m)) \
+    X(DMA_DoubleBufferModeCmd, void, (DMA_Stream_TypeDef *s, FunctionalState n), (s, n)) \
+    X(DMA_SetCurrDataCounter, void, (DMA_Stream_TypeDef *s, uint16_t c), (s, c)) \
+    X(DMA_ITConfig, void, (DMA_Stream_TypeDef *s, uint32_t it, FunctionalState n), (s, it, n)) \
+    X(DCMI_DeInit, void, (void), ()) \
+    X(DCMI_Init, void, (DCMI_InitTypeDef *i), (i)) \
+    X(DCMI_CROPConfig, void, (DCMI_CROPInitTypeDef *i), (i)) \
+    X(DCMI_CROPCmd, void, (FunctionalState n), (n)) \
+    X(DCMI_ClearITPendingBit, void, (uint16_t it), (it)) \
+    X(DCMI_ITConfig, void, (uint16_t it, FunctionalState n), (it, n)) \
+    X(DCMI_Cmd, void, (FunctionalState n), (n)) \
+    X(DCMI_CaptureCmd, void, (FunctionalState n), (n))
+WRAP_LIST
+FunctionalState HOST_DMA_GetCmdStatus_(DMA_Stream_TypeDef *s);
+#undef X
+
+/* 参数, 时间单位为像素时钟 */
+static struct {
+    uint32_t mode, snapshot, width, height, bpp, crop, cropx, cropy, sensorw, sensorh;
+    uint32_t hblank, vblank, frames, lpb, ring, cblock, cframe, jitter, poll, isr, lat;
+    uint32_t stall, stallrate, bad, cpu, snapgap, seed;
+} P;
+
+static const struct {
+    const char *name;
+    uint32_t *val;
+} params[] = {
+    {"mode", &P.mode}, {"snapshot", &P.snapshot}, {"width", &P.width}, {"height", &P.height},
+    {"bpp", &P.bpp}, {"crop", &P.crop}, {"cropx", &P.cropx}, {"cropy", &P.cropy},
+    {"sensorw", &P.sensorw}, {"sensorh", &P.sensorh}, {"hblank", &P.hblank}, {"vblank", &P.vblank},
+    {"frames", &P.frames}, {"lpb", &P.lpb}, {"ring", &P.ring}, {"cblock", &P.cblock},
+    {"cframe", &P.cframe}, {"jitter", &P.jitter}, {"poll", &P.poll}, {"isr", &P.isr},
+    {"lat", &P.lat}, {"stall", &P.stall}, {"stallrate", &P.stallrate}, {"bad", &P.bad},
+    {"cpu", &P.cpu}, {"snapgap", &P.snapgap}, {"seed", &P.seed},
+};
+
+static unsigned long errors;
+static uint64_t rs, now, busy;
+
+/* 传感器与 DCMI */
+static uint32_t sen_frame, sen_pos, sen_lines, sen_lb, sen_capturing, sen_captured;
+static int32_t sen_line;
+static uint32_t pack_word, pack_bytes;
+static uint32_t fifo[CAM_FIFO_WORDS], fifo_head, fifo_count;
+static uint8_t bad_frame[4096];
+static int32_t last_bad = -1;
+static uint32_t bad_captured;                   /* 最后一个坏帧开始时已采的帧数 */
+
+/* DMA */
+static DMA_Stream_TypeDef sh_stream;
+static uint32_t sh_dcmi_cr, dma_n0, dma_base, dma_stall, dma_hold, tc_count, arms, cmd_polls;
+
+/* 外设时钟、引脚、中断 */
+static uint32_t ahb1enr, ahb2enr, periph_calls, pins_af;
+static uint8_t nvic_en[2], nvic_prio[2];
+static uint64_t irq_due = HOST_NONE;
+static int in_isr;
+static unsigned long storms;
+
+/* 回调侧 */
+static uint8_t *fb[2], *ring;
+static uint32_t lb, bb, x0, y0;
+static unsigned long callbacks, frames_ok, snaps, snaps_done;
+static uint32_t last_seq, have_last, last_cam_frame, last_line, last_sen;
+static int32_t last_good = -1;
+static int snap_pending;
+static uint64_t snap_at, snap_req;
+static uint32_t snap_lost;
+static uint8_t *copy;
+
+static uint32_t Rnd(void) {
+    rs ^= rs << 13;
+    rs ^= rs >> 7;
+    rs ^= rs << 17;
+    return (uint32_t)(rs >> 16);
+}
+
+static void Fail(const char *msg, unsigned long a, unsigned long b) {
+    if (errors < 20) printf("fail: %s (%lu, %lu) t=%llu\n", msg, a, b, (unsigned long long)now);
+    errors++;
+}
+
+static uint8_t Gen(uint32_t f, uint32_t l, uint32_t x) {
+    uint32_t w = ((f & 0xFFFU) << 20) | ((l & 0x3FFU) << 10) | ((x >> 2) & 0x3FFU);
+    return (uint8_t)(w >> (8 * (x & 3)));
+}
+
+static int InMem(uint32_t addr, uint32_t bytes) {
+    uintptr_t a = (uintptr_t)addr, b = (uintptr_t)host_mem;
+    return a >= b && a + bytes <= b + HOST_MEM_BYTES;
+}
+
+static void DcmiFlag(uint32_t bit) {
+    DCMI->RISR |= bit;
+    DCMI->MISR = DCMI->RISR & DCMI->IER;
+}
+
+static void FifoFlush(void) {
+    fifo_head = fifo_count = 0;
+    pack_word = pack_bytes = 0;
+}
+
+/* 流使能: 按 RM0090 的使能条件和 cam_capture 的固定配置检查 */
+static void StreamStart(void) {
+    DMA_Stream_TypeDef *s = DMA2_Stream1;
+    uint32_t cr = s->CR, want = P.mode == CAM_MODE_FRAME ? lb * P.height / 4 : lb * P.lpb / 4;
+
+    arms++;
+    if ((ahb1enr & RCC_AHB1Periph_DMA2) == 0) Fail("DMA2 时钟未打开就使能流", 0, 0);
+    if (DMA2->LISR & HOST_STREAM_FLAGS) Fail("使能流前未清除全部标志", DMA2->LISR & HOST_STREAM_FLAGS, 0);
+    if ((cr & DMA_SxCR_CHSEL) != DMA_Channel_1 || (cr & DMA_SxCR_DIR) != DMA_DIR_PeripheralToMemory ||
+            (cr & DMA_SxCR_PINC) || !(cr & DMA_SxCR_MINC) ||
+            (cr & DMA_SxCR_PSIZE) != DMA_PeripheralDataSize_Word ||
+            (cr & DMA_SxCR_MSIZE) != DMA_MemoryDataSize_Word ||
+            (cr & DMA_SxCR_MBURST) != DMA_MemoryBurst_INC4 || (cr & DMA_SxCR_PBURST) != 0 ||
+            (s->FCR & (DMA_SxFCR_DMDIS | DMA_SxFCR_FTH)) != (DMA_FIFOMode_Enable | DMA_FIFOThreshold_Full)) {
+        Fail("DMA 配置不是通道1外设到存储器字宽 FIFO 4 拍突发", cr, s->FCR);
+    }
+    if (s->PAR != (uint32_t)(uintptr_t)&DCMI->DR) Fail("PAR 不是 DCMI->DR", s->PAR, 0);
+    if ((cr & (DMA_SxCR_TCIE | DMA_SxCR_TEIE)) != (DMA_SxCR_TCIE | DMA_SxCR_TEIE)) Fail("未开 TC/TE 中断", cr, 0);
+    if (P.mode == CAM_MODE_FRAME ? (cr & (DMA_SxCR_DBM | DMA_SxCR_CIRC)) != 0 : !(cr & DMA_SxCR_DBM)) {
+        Fail("DMA 模式与采集模式不符", cr, P.mode);
+    }
+    if (s->NDTR != want) Fail("NDTR 不是一帧/一块的字数", s->NDTR, want);
+    if (s->NDTR == 0 || (s->NDTR & 3)) Fail("4 拍突发时 NDTR 须为 4 的非零倍数", s->NDTR, 0);
+    if ((s->M0AR & 15) || !InMem(s->M0AR, s->NDTR * 4)) Fail("M0AR 未对齐或越界", s->M0AR, 0);
+    if ((cr & DMA_SxCR_DBM) && ((s->M1AR & 15) || !InMem(s->M1AR, s->NDTR * 4))) Fail("M1AR 未对齐或越界", s->M1AR, 0);
+    if (P.mode == CAM_MODE_LINES) {
+        if ((s->M0AR - (uint32_t)(uintptr_t)ring) % bb || (s->M0AR - (uint32_t)(uintptr_t)ring) / bb > P.ring ||
+                (s->M1AR - (uint32_t)(uintptr_t)ring) % bb || (s->M1AR - (uint32_t)(uintptr_t)ring) / bb > P.ring) {
+            Fail("地址寄存器不指向环中的块", s->M0AR, s->M1AR);
+        }
+        if (s->M0AR == s->M1AR && s->M0AR != (uint32_t)(uintptr_t)ring + P.ring * bb) Fail("M0AR 与 M1AR 指向同一块", s->M0AR, 0);
+    }
+    dma_n0 = s->NDTR ? s->NDTR : 1;
+    dma_base = (cr & DMA_SxCR_CT) ? s->M1AR : s->M0AR;
+}
+
+/* 软件写寄存器之后调用: 处理写 1 清零、使能沿和使能期间不允许的写 */
+static void HOST_Sync(void) {
+    DMA_Stream_TypeDef *s = DMA2_Stream1;
+    uint32_t was = sh_stream.CR, cr;
+
+    if (DMA2->LIFCR) {
+        DMA2->LISR &= ~DMA2->LIFCR;
+        DMA2->LIFCR = 0;
+    }
+    if (DMA2->HIFCR) {
+        DMA2->HISR &= ~DMA2->HIFCR;
+        DMA2->HIFCR = 0;
+    }
+
+    if (was & DMA_SxCR_EN) {
+        if ((s->CR ^ was) & HOST_CR_PROTECTED) {
+            Fail("流使能时改写受保护的 CR 位", was, s->CR);
+            s->CR = (s->CR & ~HOST_CR_PROTECTED) | (was & HOST_CR_PROTECTED);
+        }
+        if (s->NDTR != sh_stream.NDTR) {
+            Fail("流使能时写 NDTR", sh_stream.NDTR, s->NDTR);
+            s->NDTR = sh_stream.NDTR;
+        }
+        if (s->PAR != sh_stream.PAR || s->FCR != sh_stream.FCR) Fail("流使能时改 PAR/FCR", s->PAR, s->FCR);
+        if ((s->M0AR != sh_stream.M0AR && (!(was & DMA_SxCR_DBM) || !(was & DMA_SxCR_CT))) ||
+                (s->M1AR != sh_stream.M1AR && (was & DMA_SxCR_DBM) && (was & DMA_SxCR_CT))) {
+            /* 硬件: 置 TEIF 并关闭流 */
+            Fail("流使能时写正在使用的地址寄存器", s->M0AR, s->M1AR);
+            DMA2->LISR |= DMA_LISR_TEIF1;
+            s->CR &= ~DMA_SxCR_EN;
+        }
+    }
+    cr = s->CR;
+    if (!(was & DMA_SxCR_EN) && (cr & DMA_SxCR_EN)) StreamStart();
+    sh_stream = *s;
+
+    if (DCMI->ICR) {
+        DCMI->RISR &= ~DCMI->ICR;
+        DCMI->ICR = 0;
+    }
+    if ((sh_dcmi_cr & DCMI_CR_ENABLE) && ((DCMI->CR ^ sh_dcmi_cr) & ~(DCMI_CR_CAPTURE | DCMI_CR_ENABLE))) {
+        Fail("DCMI 使能时改配置", sh_dcmi_cr, DCMI->CR);
+    }
+    if (!(sh_dcmi_cr & DCMI_CR_ENABLE) && (DCMI->CR & DCMI_CR_ENABLE)) {
+        if ((ahb2enr & RCC_AHB2Periph_DCMI) == 0) Fail("DCMI 时钟未打开就使能", 0, 0);
+        if (pins_af != 0x7FF) Fail("DCMI 引脚未全部配置为 AF13", pins_af, 0);
+    }
+    if ((sh_dcmi_cr & DCMI_CR_ENABLE) && !(DCMI->CR & DCMI_CR_ENABLE)) {
+        sen_capturing = 0;
+        FifoFlush();
+    }
+    sh_dcmi_cr = DCMI->CR;
+    DCMI->MISR = DCMI->RISR & DCMI->IER;
+}
+
+#define X(name, ret, args, call) ret name args { HOST_##name##_ call; HOST_Sync(); }
+WRAP_LIST
+#undef X
+
+FunctionalState DMA_GetCmdStatus(DMA_Stream_TypeDef *s) {
+    FunctionalState st = HOST_DMA_GetCmdStatus_(s);
+
+    if (st == DISABLE) {
+        cmd_polls = 0;
+    } else if (++cmd_polls > 1000000UL) {
+        printf("fail: 等待流关闭卡死\n");
+        exit(1);
+    }
+    return st;
+}
+
+void RCC_AHB1PeriphClockCmd(uint32_t p, FunctionalState n) {
+    periph_calls++;
+    ahb1enr = n ? ahb1enr | p : ahb1enr & ~p;
+}
+
+void RCC_AHB2PeriphClockCmd(uint32_t p, FunctionalState n) {
+    periph_calls++;
+    ahb2enr = n ? ahb2enr | p : ahb2enr & ~p;
+}
+
+void GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *g) {
+    periph_calls++;
+    if (g->GPIO_Mode != GPIO_Mode_AF) Fail("DCMI 引脚不是复用模式", g->GPIO_Mode, 0);
+    (void)port;
+}
+
+void GPIO_PinAFConfig(GPIO_TypeDef *port, uint16_t src, uint8_t af) {
+    static const uint32_t want[] = {GPIOA_BASE, 4, GPIOA_BASE, 6, GPIOB_BASE, 7, GPIOC_BASE, 6, GPIOC_BASE, 7,
+                                    GPIOC_BASE, 8, GPIOC_BASE, 9, GPIOC_BASE, 11, GPIOB_BASE, 6,
+                                    GPIOE_BASE, 5, GPIOE_BASE, 6};
+    uint32_t i;
+
+    periph_calls++;
+    for (i = 0; i < 22; i += 2) {
+        if ((uint32_t)(uintptr_t)port == want[i] && src == want[i + 1] && af == GPIO_AF_DCMI) pins_af |= 1U << (i / 2);
+    }
+    if (af != GPIO_AF_DCMI) Fail("引脚复用不是 AF13", src, af);
+    if ((ahb1enr & (RCC_AHB1Periph_GPIOA | RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC | RCC_AHB1Periph_GPIOE)) !=
+            (RCC_AHB1Periph_GPIOA | RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC | RCC_AHB1Periph_GPIOE)) {
+        Fail("GPIO 时钟未打开", ahb1enr, 0);
+    }
+}
+
+void NVIC_Init(NVIC_InitTypeDef *n) {
+    int i = n->NVIC_IRQChannel == DMA2_Stream1_IRQn ? HOST_IRQ_DMA : n->NVIC_IRQChannel == DCMI_IRQn ? HOST_IRQ_DCMI : -1;
+
+    periph_calls++;
+    if (i < 0) {
+        Fail("使能了无关的中断", n->NVIC_IRQChannel, 0);
+        return;
+    }
+    nvic_en[i] = n->NVIC_IRQChannelCmd == ENABLE;
+    nvic_prio[i] = n->NVIC_IRQChannelPreemptionPriority;
+}
+
+/* 一个像素时钟 */
+static void DmaTick(void) {
+    DMA_Stream_TypeDef *s = DMA2_Stream1;
+    uint32_t addr, w;
+
+    if (dma_stall) {
+        dma_stall--;
+        return;
+    }
+    if (dma_hold) {
+        dma_hold--;
+    } else if (P.stall && Rnd() % 1000000U < P.stallrate) {
+        dma_stall = Rnd() % P.stall;
+        dma_hold = P.stall;
+        return;
+    }
+    if (!(s->CR & DMA_SxCR_EN) || fifo_count == 0) return;
+
+    w = fifo[fifo_head];
+    fifo_head = (fifo_head + 1) % CAM_FIFO_WORDS;
+    fifo_count--;
+    addr = dma_base + 4 * (dma_n0 - s->NDTR);
+    if (!InMem(addr, 4)) {
+        Fail("DMA 写到缓冲外", addr, 0);
+        DMA2->LISR |= DMA_LISR_TEIF1;
+        s->CR &= ~DMA_SxCR_EN;
+        sh_stream = *s;
+        return;
+    }
+    memcpy((void *)(uintptr_t)addr, &w, 4);
+    s->NDTR--;
+    if (s->NDTR == dma_n0 / 2) DMA2->LISR |= DMA_LISR_HTIF1;
+    if (s->NDTR == 0) {
+        DMA2->LISR |= DMA_LISR_TCIF1;
+        tc_count++;
+        if (s->CR & DMA_SxCR_DBM) {
+            s->CR ^= DMA_SxCR_CT;
+            s->NDTR = dma_n0;
+            dma_base = (s->CR & DMA_SxCR_CT) ? s->M1AR : s->M0AR;
+        } else if (s->CR & DMA_SxCR_CIRC) {
+            s->NDTR = dma_n0;
+        } else {
+            s->CR &= ~DMA_SxCR_EN;
+        }
+    }
+    sh_stream = *s;
+}
+
+static void DcmiByte(uint32_t x) {
+    uint32_t vst, hoff;
+
+    if (!sen_capturing) return;
+    if (DCMI->CR & DCMI_CR_CROP) {
+        vst = (DCMI->CWSTRTR >> 16) & 0x1FFF;
+        hoff = DCMI->CWSTRTR & 0x3FFF;
+        if ((uint32_t)sen_line < vst || (uint32_t)sen_line > vst + ((DCMI->CWSIZER >> 16) & 0x3FFF) ||
+                x < hoff || x > hoff + (DCMI->CWSIZER & 0x3FFF)) return;
+    }
+    pack_word |= (uint32_t)Gen(sen_frame, (uint32_t)sen_line, x) << (8 * pack_bytes);
+    if (++pack_bytes < 4) return;
+    if (fifo_count == CAM_FIFO_WORDS) {
+        DcmiFlag(DCMI_RISR_OVR_RIS);
+    } else {
+        fifo[(fifo_head + fifo_count) % CAM_FIFO_WORDS] = pack_word;
+        fifo_count++;
+    }
+    pack_word = pack_bytes = 0;
+}
+
+static void Tick(void) {
+    now++;
+    if (sen_line >= 0 && sen_pos >= P.hblank) DcmiByte(sen_pos - P.hblank);
+    if (++sen_pos == P.hblank + sen_lb) {
+        sen_pos = 0;
+        if (++sen_line == (int32_t)sen_lines) {
+            /* 场同步: 帧结束 */
+            if (sen_capturing) {
+                DcmiFlag(DCMI_RISR_FRAME_RIS);
+                if (DCMI->CR & DCMI_CR_CM) DCMI->CR &= ~DCMI_CR_CAPTURE;
+                sh_dcmi_cr = DCMI->CR;
+            }
+            sen_capturing = 0;
+            pack_word = pack_bytes = 0;
+            sen_line = -(int32_t)P.vblank;
+            sen_frame++;
+        } else if (sen_line == 0) {
+            sen_lines = P.sensorh;
+            if (P.bad && Rnd() % 1000U < P.bad) {
+                sen_lines = Rnd() & 1 ? sen_lines + 1 + Rnd() % 5 : sen_lines - 1 - Rnd() % (sen_lines / 2 + 1);
+                if (sen_lines == 0) sen_lines = 1;
+                bad_frame[sen_frame & 0xFFF] = 1;
+                last_bad = (int32_t)sen_frame;
+                bad_captured = sen_captured;
+            }
+            sen_capturing = (DCMI->CR & (DCMI_CR_ENABLE | DCMI_CR_CAPTURE)) == (DCMI_CR_ENABLE | DCMI_CR_CAPTURE);
+            if (sen_capturing) sen_captured++;
+            pack_word = pack_bytes = 0;
+        }
+    }
+    DmaTick();
+    HOST_stcDwt.CYCCNT = (uint32_t)(now * P.cpu / 1000U);
+}
+
+static int Pending(int irq) {
+    DMA_Stream_TypeDef *s = DMA2_Stream1;
+
+    if (irq == HOST_IRQ_DCMI) return DCMI->MISR != 0;
+    return ((DMA2->LISR & DMA_LISR_TCIF1) && (s->CR & DMA_SxCR_TCIE)) ||
+           ((DMA2->LISR & DMA_LISR_TEIF1) && (s->CR & DMA_SxCR_TEIE)) ||
+           ((DMA2->LISR & DMA_LISR_HTIF1) && (s->CR & DMA_SxCR_HTIE));
+}
+
+/* 同一抢占优先级: 挂起后经随机延迟进中断, 进入时选编号小的(DMA2_Stream1 先于 DCMI),
+   入栈的一两个时钟里 DMA 照常传输, 之后才执行处理函数 */
+static void Dispatch(void) {
+    int irq;
+    uint64_t end;
+
+    if (!(nvic_en[HOST_IRQ_DMA] && Pending(HOST_IRQ_DMA)) && !(nvic_en[HOST_IRQ_DCMI] && Pending(HOST_IRQ_DCMI))) {
+        irq_due = HOST_NONE;
+        return;
+    }
+    if (irq_due == HOST_NONE) irq_due = now + Rnd() % (P.lat + 1);
+    if (irq_due > now) return;
+    irq_due = HOST_NONE;
+    irq = nvic_en[HOST_IRQ_DMA] && Pending(HOST_IRQ_DMA) ? HOST_IRQ_DMA : HOST_IRQ_DCMI;
+
+    in_isr = 1;
+    end = now + P.isr;
+    busy += P.isr;
+    Tick();
+    if (Rnd() & 1) Tick();
+    if (irq == HOST_IRQ_DMA) Cam_DMA_IRQHandler();
+    else Cam_DCMI_IRQHandler();
+    if (Pending(irq) && ++storms > 100000UL) {
+        printf("fail: 中断返回后仍挂起, 中断风暴\n");
+        exit(1);
+    }
+    if (!Pending(irq)) storms = 0;
+    while (now < end) Tick();
+    in_isr = 0;
+}
+
+static void HOST_Run(uint64_t n) {
+    uint64_t end = now + n;
+
+    while (now < end) {
+        Tick();
+        if (!in_isr) Dispatch();
+    }
+}
+
+static uint64_t Cost(uint32_t base) {
+    uint32_t j = P.jitter > 999 ? 999 : P.jitter;
+
+    if (base == 0) return 0;
+    return (uint64_t)base * (1000U - j + Rnd() % (2 * j + 1)) / 1000U;
+}
+
+/* 一行: 反推传感器帧号和行号, 全行字节都对返回 1 */
+static int Decode(const uint8_t *p, uint32_t *f, uint32_t *l) {
+    uint32_t b = (4 - (x0 & 3)) & 3, w, x;
+
+    w = p[b] | (uint32_t)p[b + 1] << 8 | (uint32_t)p[b + 2] << 16 | (uint32_t)p[b + 3] << 24;
+    *f = w >> 20;
+    *l = (w >> 10) & 0x3FF;
+    for (x = 0; x < lb; x++) {
+        if (p[x] != Gen(*f, *l, x0 + x)) return 0;
+    }
+    return 1;
+}
+
+/* 帧模式: 整帧来自同一传感器帧且行号连续, 返回传感器帧号, 不对返回 -1 */
+static int32_t CheckFrame(const uint8_t *p) {
+    uint32_t y, f, l, f0 = 0;
+
+    for (y = 0; y < P.height; y++) {
+        if (!Decode(p + y * lb, &f, &l)) {
+            Fail("帧中有字节不属于任何传感器行", y, 0);
+            return -1;
+        }
+        if (y == 0) f0 = f;
+        if (f != f0 || l != y0 + y) {
+            Fail("帧撕裂或行错位: 行/传感器帧", y, f);
+            return -1;
+        }
+    }
+    return (int32_t)f0;
+}
+
+static void FrameCallback(const uint8_t *Frame, uint32_t Seq) {
+    int32_t f = -1, g;
+
+    callbacks++;
+    if (Frame != fb[0] && Frame != fb[1]) Fail("回调的帧不是两块缓冲之一", 0, 0);
+    else f = CheckFrame(Frame);
+    if (have_last && Seq <= last_seq) Fail("帧序号未递增", last_seq, Seq);
+    if (f >= 0 && last_good >= 0 && f <= last_good) Fail("交付了不比上次新的传感器帧", (unsigned long)last_good, (unsigned long)f);
+    if (f >= 0) {
+        last_good = f;
+        frames_ok++;
+    }
+    have_last = 1;
+    last_seq = Seq;
+    busy += Cost(P.cframe);
+    HOST_Run(Cost(P.cframe));
+    if (f >= 0 && (g = CheckFrame(Frame)) != f) Fail("回调期间帧被 DMA 改写", (unsigned long)f, (unsigned long)g);
+    if (P.snapshot) {
+        snap_pending = 0;
+        snaps_done++;
+        snap_at = now + P.snapgap;
+    }
+}
+
+static void LineCallback(const Cam_Block *B) {
+    uint32_t off = (uint32_t)(B->Data - ring), k, f, l, f0 = 0, bad = 0;
+    uint64_t c;
+
+    callbacks++;
+    if (B->Data < ring || off % bb || off / bb >= P.ring) {
+        Fail("回调的块不在环中(或是丢弃区)", off, bb);
+        return;
+    }
+    if (B->Lines != P.lpb || B->Line % P.lpb || B->Line + P.lpb > P.height) Fail("块行号/行数不对", B->Line, B->Lines);
+    if (!(B->Flags & CAM_BLOCK_FIRST) != (B->Line != 0)) Fail("FIRST 与行号不符", B->Line, B->Flags);
+    if (!(B->Flags & CAM_BLOCK_LAST) != (B->Line + P.lpb != P.height)) Fail("LAST 与行号不符", B->Line, B->Flags);
+    for (k = 0; k < P.lpb; k++) {
+        if (!Decode(B->Data + k * lb, &f, &l)) {
+            Fail("块中有字节不属于任何传感器行", B->Line, k);
+            bad = 1;
+            break;
+        }
+        if (k == 0) f0 = f;
+        if (f != f0) {
+            Fail("块中的行来自不同传感器帧", f0, f);
+            bad = 1;
+            break;
+        }
+        if (!bad_frame[f] && l != y0 + B->Line + k) {
+            Fail("块中行号与位置不符", y0 + B->Line + k, l);
+            bad = 1;
+            break;
+        }
+    }
+    if (B->Flags & CAM_BLOCK_FIRST) {
+        if (have_last && B->Frame <= last_cam_frame) Fail("新帧序号未递增", last_cam_frame, B->Frame);
+    } else if (!(B->Flags & CAM_BLOCK_GAP) && (!have_last || B->Frame != last_cam_frame)) {
+        Fail("帧的前几块没有交付却没有 GAP", last_cam_frame, B->Frame);
+    } else if (have_last && B->Frame != last_cam_frame) {
+        if (B->Frame < last_cam_frame) Fail("帧序号回退", last_cam_frame, B->Frame);
+    } else if (B->Line <= last_line) {
+        Fail("同一帧的块乱序", last_line, B->Line);
+    } else {
+        if (!(B->Flags & CAM_BLOCK_GAP) && B->Line != last_line + P.lpb) Fail("块不连续却没有 GAP", last_line, B->Line);
+        if (!bad && !bad_frame[f0] && f0 != last_sen) Fail("同一帧的块来自不同传感器帧", last_sen, f0);
+    }
+    if (!bad && have_last && f0 < last_sen) Fail("交付了更旧传感器帧的块", last_sen, f0);
+    if (!bad && !bad_frame[f0]) last_good = (int32_t)f0;
+    have_last = 1;
+    last_cam_frame = B->Frame;
+    last_line = B->Line;
+    if (!bad) last_sen = f0;
+
+    memcpy(copy, B->Data, bb);
+    c = Cost(P.cblock) + ((B->Flags & CAM_BLOCK_LAST) ? Cost(P.cframe) : 0);
+    busy += c;
+    HOST_Run(c);
+    if (memcmp(copy, B->Data, bb) != 0) Fail("回调期间块被 DMA 改写", B->Line, off / bb);
+    if (B->Flags & CAM_BLOCK_LAST) {
+        if (!(B->Flags & CAM_BLOCK_GAP)) frames_ok++;
+        if (P.snapshot) {
+            snap_pending = 0;
+            snaps_done++;
+            snap_at = now + P.snapgap;
+        }
+    }
+}
+
+/* 非法配置: 返回 ERROR 且不碰外设 */
+static void CheckReject(void) {
+    static const char *const what[] = {"CCM 缓冲", "未对齐缓冲", "块行数不整除", "环少于 3 块", "行字节不是 4 的倍数", "无回调"};
+    Cam_Config c;
+    uint32_t i, calls = periph_calls;
+
+    for (i = 0; i < 6; i++) {
+        memset(&c, 0, sizeof(c));
+        c.Width = 64;
+        c.Height = 16;
+        c.BytesPerPixel = 2;
+        c.Mode = i < 2 ? CAM_MODE_FRAME : CAM_MODE_LINES;
+        c.Frame[0] = host_mem;
+        c.Frame[1] = host_mem + 4096;
+        c.FrameCallback = FrameCallback;
+        c.Ring = host_mem;
+        c.LinesPerBlock = 4;
+        c.RingBlocks = 4;
+        c.LineCallback = LineCallback;
+        if (i == 0) c.Frame[1] = (uint8_t *)(uintptr_t)0x10000100UL;
+        if (i == 1) c.Frame[0] = host_mem + 8;
+        if (i == 2) c.LinesPerBlock = 3;
+        if (i == 3) c.RingBlocks = 2;
+        if (i == 4) c.Width = 63;
+        if (i == 5) c.LineCallback = 0;
+        if (Cam_Init(&c) != ERROR) Fail(what[i], i, 0);
+    }
+    if (periph_calls != calls || sh_dcmi_cr || sh_stream.CR) Fail("Cam_Init 拒绝参数时碰了外设", periph_calls - calls, 0);
+}
+
+int main(int argc, char **argv) {
+    Cam_Config c;
+    Cam_Stats st;
+    uint64_t period, limit;
+    uint32_t i, j, n;
+    int k;
+
+    for (k = 1; k < argc; k++) {
+        for (j = 0; j < sizeof(params) / sizeof(params[0]); j++) {
+            n = (uint32_t)strlen(params[j].name);
+            if (strncmp(argv[k], params[j].name, n) == 0 && argv[k][n] == '=') *params[j].val = (uint32_t)strtoul(argv[k] + n + 1, 0, 0);
+        }
+    }
+    rs = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)P.seed << 17);
+    lb = P.width * P.bpp;
+    bb = P.mode == CAM_MODE_FRAME ? lb * P.height : lb * P.lpb;
+    x0 = P.crop ? P.cropx * P.bpp : 0;
+    y0 = P.crop ? P.cropy : 0;
+    if (!P.crop) {
+        P.sensorw = P.width;
+        P.sensorh = P.height;
+    }
+    sen_lb = P.sensorw * P.bpp;
+    sen_lines = P.sensorh;
+    sen_line = -(int32_t)P.vblank;
+    if (P.frames > 4000 || lb < 8 || (P.mode == CAM_MODE_FRAME ? 2 * bb + 64 : (P.ring + 1) * bb + 64) > HOST_MEM_BYTES) {
+        printf("fail: 参数超出仿真范围\n");
+        return 1;
+    }
+
+    CheckReject();
+
+    memset(&c, 0, sizeof(c));
+    c.Width = (uint16_t)P.width;
+    c.Height = (uint16_t)P.height;
+    c.BytesPerPixel = (uint8_t)P.bpp;
+    c.Mode = (uint8_t)P.mode;
+    c.Snapshot = (uint8_t)P.snapshot;
+    c.Crop = (uint8_t)P.crop;
+    c.CropX = (uint16_t)P.cropx;
+    c.CropY = (uint16_t)P.cropy;
+    c.PCKPolarity = DCMI_PCKPolarity_Rising;
+    c.VSPolarity = DCMI_VSPolarity_High;
+    c.HSPolarity = DCMI_HSPolarity_Low;
+    /* 缓冲放在模型内存里, 两块帧缓冲之间留 16 字节 */
+    fb[0] = host_mem;
+    fb[1] = host_mem + ((bb + 31) & ~15U);
+    ring = host_mem;
+    c.Frame[0] = fb[0];
+    c.Frame[1] = fb[1];
+    c.FrameCallback = FrameCallback;
+    c.Ring = ring;
+    c.LinesPerBlock = (uint16_t)P.lpb;
+    c.RingBlocks = (uint8_t)P.ring;
+    c.LineCallback = LineCallback;
+    copy = malloc(bb);
+    memset(host_mem, 0xEE, sizeof(host_mem));
+
+    if (Cam_Init(&c) != SUCCESS) {
+        printf("fail: Cam_Init 拒绝了合法配置\n");
+        return 1;
+    }
+    if (!nvic_en[0] || !nvic_en[1] || nvic_prio[0] != nvic_prio[1]) Fail("DMA/DCMI 中断未以同一优先级使能", nvic_prio[0], nvic_prio[1]);
+    if (!(HOST_stcCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) || !(HOST_stcDwt.CTRL & DWT_CTRL_CYCCNTENA_Msk)) Fail("未打开 DWT 周期计数", 0, 0);
+    if (!!(DCMI->CR & DCMI_CR_CROP) != !!P.crop || !!(DCMI->CR & DCMI_CR_CM) != !!P.snapshot) Fail("DCMI 裁剪/快照配置不对", DCMI->CR, 0);
+
+    Cam_Start();
+    period = (uint64_t)(P.hblank + sen_lb) * (P.sensorh + P.vblank);
+    limit = period * (P.frames + 4) * 2 + 100000;
+    while (sen_frame < P.frames && now < limit) {
+        if (P.snapshot) {
+            if (snap_pending && now - snap_req > 3 * period + 4 * (uint64_t)(P.cframe + P.cblock * (P.height / (P.lpb ? P.lpb : 1)))) {
+                /* 溢出作废或丢了最后一块的快照帧不会交付, 只查没丢过数据的请求 */
+                Cam_GetStats(&st);
+                if (last_bad < 0 && st.Overflows + st.BlocksDropped == snap_lost) Fail("快照超时未交付", snaps, snaps_done);
+                snap_pending = 0;
+            }
+            if (!snap_pending && now >= snap_at) {
+                Cam_Snapshot();
+                snaps++;
+                snap_pending = 1;
+                snap_req = now;
+                Cam_GetStats(&st);
+                snap_lost = st.Overflows + st.BlocksDropped;
+            }
+        }
+        Cam_Process();
+        HOST_Run(1 + Rnd() % (2 * P.poll + 1));
+    }
+    Cam_Stop();
+    if ((DCMI->CR & DCMI_CR_ENABLE) || (DMA2_Stream1->CR & DMA_SxCR_EN)) Fail("Cam_Stop 后 DCMI 或流仍使能", DCMI->CR, DMA2_Stream1->CR);
+    Cam_Process();
+    Cam_GetStats(&st);
+
+    if (st.Delivered != callbacks) Fail("Delivered 与回调次数不符", st.Delivered, callbacks);
+    if (P.mode == CAM_MODE_FRAME) {
+        if (st.Frames != st.Delivered + st.FramesDropped) Fail("Frames != 交付 + 丢帧", st.Frames, st.Delivered + st.FramesDropped);
+        if (st.SyncErrors == 0 && (tc_count < st.Frames || tc_count > st.Frames + 1)) Fail("传输完成次数与 Frames 不符", tc_count, st.Frames);
+    } else if (st.SyncErrors == 0 && (tc_count < st.Delivered + st.BlocksDropped || tc_count > st.Delivered + st.BlocksDropped + 1)) {
+        Fail("传输完成次数 != 交付块 + 丢块", tc_count, st.Delivered + st.BlocksDropped);
+    }
+    if (P.bad == 0 && st.Overflows == 0 && st.SyncErrors) Fail("无坏帧和溢出时出现同步错误", st.SyncErrors, 0);
+    /* 持续溢出或丢块时每帧都不完整, 不算不恢复 */
+    if (last_bad >= 0 && st.Overflows == 0 && st.BlocksDropped == 0 && sen_captured >= bad_captured + 6 && last_good <= last_bad) {
+        Fail("坏帧之后管线没有恢复", (unsigned long)last_bad, (unsigned long)last_good);
+    }
+    if (P.snapshot && last_bad < 0 && st.Overflows == 0 && (st.Frames + 1 < snaps || st.Frames > snaps)) {
+        Fail("快照请求数与采到的帧数不符", snaps, st.Frames);
+    }
+    for (i = 0, n = 0; i < 4096; i++) n += bad_frame[i];
+
+    printf("sensor_frames=%u\n", sen_frame);
+    printf("captured=%u\n", sen_captured);
+    printf("bad_frames=%u\n", n);
+    printf("frames=%u\n", st.Frames);
+    printf("delivered=%u\n", st.Delivered);
+    printf("frames_ok=%lu\n", frames_ok);
+    printf("frames_dropped=%u\n", st.FramesDropped);
+    printf("blocks_dropped=%u\n", st.BlocksDropped);
+    printf("sync_errors=%u\n", st.SyncErrors);
+    printf("overflows=%u\n", st.Overflows);
+    printf("max_backlog=%u\n", st.MaxBacklog);
+    printf("max_cycles=%u\n", st.MaxCycles);
+    printf("arms=%u\n", arms);
+    printf("snapshots=%lu\n", snaps);
+    printf("load=%.4f\n", now ? (double)busy / (double)now : 0.0);
+    printf("time=%.1f\n", (double)now);
+    free(copy);
+    return errors ? 1 : 0;
+}
+'''
+
+
+def build(args, tmp):
+    with open(os.path.join(tmp, 'host_regs.h'), 'w', encoding='utf-8') as f:
+        f.write(HOST_REGS)
+    driver = os.path.join(tmp, 'driver.c')
+    with open(driver, 'w', encoding='utf-8') as f:
+        f.write(DRIVER)
+    exe = os.path.join(tmp, 'cam_pipeline_sim')
+    base = [args.cc, '-std=gnu99', '-O1', '-g', '-no-pie', '-fno-pie', '-fsanitize=address,undefined',
+            '-fno-sanitize-recover=undefined', '-Wall', '-Wno-attributes', '-Wno-pointer-to-int-cast',
+            '-Wno-int-to-pointer-cast', '-Wno-unused-function',
+            '-DUSE_STDPERIPH_DRIVER', '-DSTM32F40_41xxx', '-I', tmp]
+    for d in INCLUDES:
+        base += ['-I', os.path.join(ROOT, d)]
+    base += ['-include', 'host_regs.h']
+    objs = []
+    for src in LIBS:
+        obj = os.path.join(tmp, os.path.basename(src) + '.o')
+        cmd = base + ['-D%s=HOST_%s_' % (n, n) for n in WRAPPED] + ['-c', src, '-o', obj]
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if r.returncode != 0:
+            print(' '.join(cmd))
+            print(r.stdout)
+            return None
+        objs.append(obj)
+    cmd = base + [driver] + objs + ['-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+def run(exe, params):
+    cmd = [exe] + ['%s=%d' % kv for kv in sorted(params.items())]
+    env = dict(os.environ, ASAN_OPTIONS='detect_leaks=0')
+    try:
+        r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True,
+                           env=env, timeout=RUN_TIMEOUT)
+    except subprocess.TimeoutExpired:
+        return {}, ['驱动 %d 秒未结束, 可能卡在等待或回调循环中' % RUN_TIMEOUT]
+    res, fails = {}, []
+    for line in r.stdout.splitlines():
+        if line.startswith('fail: '):
+            fails.append(line[6:])
+        elif '=' in line and ' ' not in line:
+            k, v = line.split('=', 1)
+            try:
+                res[k] = float(v) if '.' in v else int(v)
+            except ValueError:
+                fails.append(line)
+    if r.returncode != 0 and not fails:
+        fails.append('驱动异常退出: 返回 %d %s' % (r.returncode, r.stdout.strip()[-300:]))
+    return res, fails
+
+
+def params_of(args, ring=None):
+    """命令行参数换成驱动参数, 时间换算为像素时钟"""
+    us = args.pclk
+    p = dict(mode=1 if args.cmd == 'lines' else 0, snapshot=int(args.snapshot), width=args.width,
+             height=args.height, bpp=args.bpp, hblank=args.hblank, vblank=args.vblank,
+             frames=args.frames, cframe=int(args.frame_ms * 1000 * us), jitter=int(args.jitter * 1000),
+             poll=int(args.poll_us * us), isr=max(2, int(args.irq_us * us)), lat=int(args.irq_lat_us * us),
+             stall=args.stall, stallrate=args.stall_rate, bad=0, cpu=int(CPU_MHZ / args.pclk * 1000),
+             snapgap=int(args.snap_us * us), seed=args.seed, crop=0, lpb=1, ring=3, cblock=0)
+    if args.crop:
+        p.update(crop=1, cropx=args.crop[0], cropy=args.crop[1], sensorw=args.sensor[0], sensorh=args.sensor[1])
+    if args.cmd == 'lines':
+        p.update(lpb=args.lpb, ring=ring or args.ring, cblock=int(args.block_us * us))
+    return p
+
+
+def describe(args):
+    sw, sh = args.sensor if args.crop else (args.width, args.height)
+    line_us = (sw * args.bpp + args.hblank) / args.pclk
+    frame_us = (sh + args.vblank) * line_us
+    return '%dx%d%s, line %.1f us, frame %.2f ms (%.1f fps)' % (
+        args.width, args.height, ' (crop of %dx%d)' % (sw, sh) if args.crop else '',
+        line_us, frame_us / 1000, 1e6 / frame_us)
+
+
+def dropped(res):
+    return res['frames_dropped'] + res['blocks_dropped'] + res['overflows'] + res['sync_errors']
+
+
+def show_fails(fails):
+    for msg in fails[:MAX_REPORT]:
+        print('  fail: ' + msg)
+    if len(fails) > MAX_REPORT:
+        print('  ... %d more' % (len(fails) - MAX_REPORT))
+
+
+def check(args):
+    if args.crop and not args.sensor:
+        print('--crop needs --sensor W H')
+        return False
+    if args.crop and (args.crop[0] + args.width > args.sensor[0] or args.crop[1] + args.height > args.sensor[1]):
+        print('crop window exceeds the sensor frame')
+        return False
+    if args.cmd == 'lines' and args.height % args.lpb:
+        print('height must be a multiple of --lpb')
+        return False
+    return True
+
+
+def report(args, res, ring=None):
+    print(describe(args))
+    if args.cmd == 'lines':
+        print('ring %d x %d lines (%d bytes)' % (ring, args.lpb, (ring + 1) * args.lpb * args.width * args.bpp))
+    secs = res['time'] / args.pclk / 1e6
+    print('frames %d, delivered %d %s (%.1f fps complete), frames dropped %d, blocks dropped %d' % (
+        res['frames'], res['delivered'], 'blocks' if args.cmd == 'lines' else 'frames',
+        res['frames_ok'] / secs if secs else 0, res['frames_dropped'], res['blocks_dropped']))
+    print('sync errors %d, fifo overflows %d, max backlog %d, max callback %.0f us' % (
+        res['sync_errors'], res['overflows'], res['max_backlog'], res['max_cycles'] / CPU_MHZ))
+    print('cpu load %.1f%%' % (100.0 * res['load']))
+
+
+def lines(args, exe):
+    if args.sweep:
+        for ring in range(3, 33):
+            res, fails = run(exe, params_of(args, ring))
+            if fails:
+                print('ring %d: FAILED' % ring)
+                show_fails(fails)
+                return 1
+            if dropped(res) == 0:
+                print('minimum ring without drops: %d blocks' % ring)
+                report(args, res, ring)
+                return 0
+        print('drops even with 32 blocks, consumer is too slow')
+        return 1
+    return single(args, exe, args.ring)
+
+
+def single(args, exe, ring=None):
+    res, fails = run(exe, params_of(args, ring))
+    if fails:
+        print('FAILED:')
+        show_fails(fails)
+        return 1
+    report(args, res, ring)
+    if dropped(res):
+        print('DROPS: this configuration loses data')
+        return 1
+    return 0
+
+
+def random_case(rnd, i, args):
+    mode = rnd.randrange(2)
+    bpp = rnd.choice((1, 2))
+    # 一次传输是 16 字节的整数倍; 行不短于 DCMI FIFO, 少一行的坏帧才看得出来
+    lb = rnd.randrange(40, 321, 4)
+    width = lb // bpp
+    lpb = rnd.choice((1, 2, 4, 8))
+    if lb * lpb % 16:
+        lpb = 4
+    height = lpb * rnd.randrange(3, 24) if mode else 4 * rnd.randrange(1, 20)
+    p = dict(mode=mode, snapshot=int(rnd.random() < 0.2), width=width, height=height, bpp=bpp,
+             hblank=rnd.randrange(4, 160), vblank=rnd.randrange(1, 24), frames=rnd.randrange(8, 30),
+             lpb=lpb, ring=rnd.randrange(3, 12), jitter=rnd.randrange(0, 500), poll=rnd.randrange(0, 200),
+             isr=rnd.randrange(2, 40), lat=rnd.randrange(0, 60), stall=rnd.choice((0, 8, 24, 64)),
+             stallrate=rnd.randrange(0, 3000), bad=rnd.choice((0, 0, 60)), cpu=14000,
+             snapgap=rnd.randrange(0, 5000), seed=args.seed * 1000 + i, crop=0)
+    if rnd.random() < 0.4:
+        cx, cy = rnd.randrange(0, 20), rnd.randrange(0, 10)
+        p.update(crop=1, cropx=cx, cropy=cy, sensorw=width + cx + rnd.randrange(0, 20),
+                 sensorh=height + cy + rnd.randrange(0, 10))
+    sw = p.get('sensorw', width) * bpp
+    line = p['hblank'] + sw
+    block = line * (lpb if mode else height)
+    frame = line * (p.get('sensorh', height) + p['vblank'])
+    headroom = rnd.random() < 0.5
+    if headroom:
+        # 回调、中断和总线停顿都远快于数据, 必须不丢
+        span = min(block, line * p['vblank'])
+        p.update(bad=0, stall=min(p['stall'], 16), isr=max(2, min(p['isr'], span // 8)),
+                 lat=min(p['lat'], span // 8), ring=max(p['ring'], 4))
+        # 主循环两次轮询之间 DMA 写不满环里的空闲块
+        p['poll'] = min(p['poll'], block * (p['ring'] - 3) // 8)
+        if mode:
+            p.update(cblock=rnd.randrange(0, block // 4 + 1), cframe=rnd.randrange(0, block // 4 + 1))
+        else:
+            p.update(cblock=0, cframe=rnd.randrange(0, frame // 4 + 1))
+    else:
+        p.update(cblock=rnd.randrange(0, 2 * block), cframe=rnd.randrange(0, 3 * frame))
+    return p, headroom
+
+
+def ctest(args, exe):
+    rnd = random.Random(args.seed)
+    bad = 0
+    stats = dict(cases=0, headroom=0, dropped=0, sync=0, bad=0, snapshot=0, crop=0, lines=0)
+    for i in range(args.cases):
+        p, headroom = random_case(rnd, i, args)
+        res, fails = run(exe, p)
+        if not fails and headroom and dropped(res):
+            fails.append('有余量的配置丢了数据: 丢帧 %d 丢块 %d 溢出 %d 同步错误 %d' % (
+                res['frames_dropped'], res['blocks_dropped'], res['overflows'], res['sync_errors']))
+        if not fails and headroom and res['delivered'] == 0:
+            fails.append('没有交付任何数据')
+        stats['cases'] += 1
+        stats['headroom'] += headroom
+        stats['lines'] += p['mode']
+        stats['snapshot'] += p['snapshot']
+        stats['crop'] += p['crop']
+        if not fails:
+            stats['dropped'] += dropped(res) > 0
+            stats['sync'] += res['sync_errors'] > 0
+            stats['bad'] += res['bad_frames'] > 0
+        if fails:
+            bad += 1
+            if bad <= MAX_REPORT:
+                print('case %d: %s' % (i, ' '.join('%s=%d' % kv for kv in sorted(p.items()))))
+                show_fails(fails)
+    print('%d cases (%d lines, %d snapshot, %d crop, %d with headroom): %d with drops, %d with sync errors, '
+          '%d with bad frames; %d failed' % (stats['cases'], stats['lines'], stats['snapshot'], stats['crop'],
+                                              stats['headroom'], stats['dropped'], stats['sync'], stats['bad'], bad))
+    return 1 if bad else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description='DCMI capture pipeline simulation on the compiled cam_capture.c')
+    ap.add_argument('--cc', default='gcc')
+    sub = ap.add_subparsers(dest='cmd')
+    for name in ('lines', 'frame'):
+        p = sub.add_parser(name)
+        p.add_argument('--width', type=int, default=320)
+        p.add_argument('--height', type=int, default=240)
+        p.add_argument('--bpp', type=int, default=2, help='bytes per pixel')
+        p.add_argument('--crop', type=int, nargs=2, metavar=('X', 'Y'), help='crop window origin, pixels/lines')
+        p.add_argument('--sensor', type=int, nargs=2, metavar=('W', 'H'), help='sensor frame size when cropping')
+        p.add_argument('--snapshot', action='store_true')
+        p.add_argument('--snap-us', type=float, default=1000.0, help='gap before the next snapshot request')
+        p.add_argument('--pclk', type=float, default=12.0, help='pixel clock, MHz (one byte per clock)')
+        p.add_argument('--hblank', type=int, default=144, help='horizontal blanking, clocks')
+        p.add_argument('--vblank', type=int, default=20, help='vertical blanking, lines')
+        p.add_argument('--frames', type=int, default=60)
+        p.add_argument('--jitter', type=float, default=0.2, help='relative spread of callback cost')
+        p.add_argument('--poll-us', type=float, default=50.0, help='main loop latency before Cam_Process runs')
+        p.add_argument('--irq-us', type=float, default=2.0, help='cost of one interrupt')
+        p.add_argument('--irq-lat-us', type=float, default=5.0, help='worst interrupt entry latency')
+        p.add_argument('--stall', type=int, default=16, help='longest DMA bus stall, clocks')
+        p.add_argument('--stall-rate', type=int, default=200, help='stalls per million clocks')
+        p.add_argument('--seed', type=int, default=1)
+    sub.choices['frame'].add_argument('--frame-ms', type=float, default=5.0, help='per-frame callback work')
+    p = sub.choices['lines']
+    p.add_argument('--frame-ms', type=float, default=1.0, help='end-of-frame work after the LAST block')
+    p.add_argument('--ring', type=int, default=6, help='RingBlocks')
+    p.add_argument('--lpb', type=int, default=8, help='LinesPerBlock')
+    p.add_argument('--block-us', type=float, default=300.0, help='line callback cost per block')
+    p.add_argument('--sweep', action='store_true', help='find the smallest ring without drops')
+    p = sub.add_parser('ctest')
+    p.add_argument('--cases', type=int, default=40)
+    p.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+    if args.cmd is None:
+        ap.print_help()
+        return 2
+    if args.cmd != 'ctest' and not check(args):
+        return 2
+    if not shutil.which(args.cc):
+        print('compiler %s not found' % args.cc)
+        return 2
+    tmp = tempfile.mkdtemp(prefix='cam_sim_')
+    try:
+        exe = build(args, tmp)
+        if exe is None:
+            return 1
+        if args.cmd == 'ctest':
+            return ctest(args, exe)
+        return lines(args, exe) if args.cmd == 'lines' else single(args, exe)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
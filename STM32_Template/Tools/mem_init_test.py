@@ -0,0 +1,505 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Hardware/mem_init.c 和 Project/Template.sct 的主机测试.
+
+    mem_init_test.py [--cc gcc] [--seed 1] [--layouts 40] [--fills 400]
+        1. 静态核对 Template.sct 与 mem_init.c/mem_init.h:
+           - 每个 UNINIT 执行区要么在 mem_table 中有清零项, 要么是 RW_NOINIT/RW_STACK(不清零);
+             mem_table 引用的执行区都存在; RW_SDRAM 只在 MEM_USE_SDRAM 时出现;
+           - mem_table 中选 MEM_DMA 的执行区不在 CCM(0x10000000~0x1000FFFF);
+           - MEM_CCM/MEM_SRAM2/MEM_SDRAM/MEM_NOINIT/MEM_RAMFUNC 的段名都被对应执行区选中;
+           - mem_usage 的执行区名和顺序与 Template.sct 一致, 个数等于 MEM_USAGE_NUM.
+        2. 主机上链接 mem_init.c: 模拟的 CCM 和 SRAM2 用 --section-start 放到 Template.sct 中的真实地址,
+           Image$$<区>$$ZI$$Base/Limit 用 --defsym 给出(ZI 长度随机, 含不满 4 字节的尾部、小于 MEM_DMA_MIN、
+           为 0 和占满整个区的情况). DMA2 数据流 0 按寄存器语义建模:
+           - 使能前必须打开 DMA2 时钟、清除全部标志, 配置为字宽内存到内存、FIFO 模式、普通模式;
+           - 4 拍突发时 NDTR 为 4 的倍数且存储器地址 16 字节对齐(突发不跨 1KB 边界), NDTR 不超过 65535;
+           - 访问 CCM 的传输立即置 TEIF 且不写任何数据, 另按 --faults 随机在中途置 TEIF;
+           检查 Mem_Init 后 ZI 区间全为 0、区间外的字节不变、CCM 只用 CPU、DMA2 时钟恢复原状,
+           Mem_GetStat 的区名、字节数和实际方式正确.
+        3. 直接调用 Mem_DmaFill/Mem_CpuFill 做清零和复制: 目的地址任意字对齐、长度 0~300000 字
+           (跨过 MEM_DMA_CHUNK 分块)、随机传输错误、目的在 CCM, 结果必须与期望一致且不越界.
+    全部通过返回 0, 否则打印前若干处差异并返回 1. 修改 mem_init.c 或 Template.sct 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SOURCE = os.path.join(ROOT, 'Hardware', 'mem_init.c')
+HEADER = os.path.join(ROOT, 'Hardware', 'mem_init.h')
+SCATTER = os.path.join(ROOT, 'Project', 'Template.sct')
+DMA_LIB = os.path.join(ROOT, 'Lib', 'stm32f4xx_dma.h')
+RCC_LIB = os.path.join(ROOT, 'Lib', 'stm32f4xx_rcc.h')
+MAX_REPORT = 20
+CCM_BASE, CCM_END = 0x10000000, 0x10010000
+NO_CLEAR = ('RW_NOINIT', 'RW_STACK')
+
+# 代替 stm32f4xx_conf.h: DMA 初始化结构和常量从库头文件中摘出, 寄存器接到模型上
+STUB = r'''
+#ifndef __STM32F4xx_CONF_H
+#define __STM32F4xx_CONF_H
+#include <stdint.h>
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrorStatus;
+%s
+typedef struct {
+    uint32_t EN;
+    uint32_t Flags;
+    DMA_InitTypeDef Cfg;
+} DMA_Stream_TypeDef;
+typedef struct {
+    volatile uint32_t AHB1ENR;
+} RCC_TypeDef;
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+extern DMA_Stream_TypeDef g_stcSimDma;
+extern RCC_TypeDef g_stcSimRcc;
+extern DWT_Type g_stcSimDwt;
+#define DMA2_Stream0    (&g_stcSimDma)
+#define RCC             (&g_stcSimRcc)
+#define DWT             (&g_stcSimDwt)
+void DMA_StructInit(DMA_InitTypeDef *DMA_InitStruct);
+void DMA_Init(DMA_Stream_TypeDef *DMAy_Streamx, DMA_InitTypeDef *DMA_InitStruct);
+void DMA_Cmd(DMA_Stream_TypeDef *DMAy_Streamx, FunctionalState NewState);
+FlagStatus DMA_GetFlagStatus(DMA_Stream_TypeDef *DMAy_Streamx, uint32_t DMA_FLAG);
+void DMA_ClearFlag(DMA_Stream_TypeDef *DMAy_Streamx, uint32_t DMA_FLAG);
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState);
+#endif
+'''
+
+DRIVER = r'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mem_init.c"
+
+#define SIM_BIG_WORDS       300000UL
+#define SIM_GUARD           64UL
+#define SIM_FILL            0xA5U
+
+uint8_t g_au8SimCcm[0x10000] __attribute__((section(".simccm"), aligned(4096)));
+uint8_t g_au8SimSram[0x4000] __attribute__((section(".simsram"), aligned(4096)));
+static uint32_t dst_Big[SIM_BIG_WORDS + 2 * SIM_GUARD];
+static uint32_t src_Big[SIM_BIG_WORDS + 2 * SIM_GUARD];
+static uint32_t exp_Big[SIM_BIG_WORDS + 2 * SIM_GUARD];
+
+DMA_Stream_TypeDef g_stcSimDma;
+RCC_TypeDef g_stcSimRcc;
+DWT_Type g_stcSimDwt;
+
+static unsigned long errors, transfers, faults, ccmHits, chunks;
+static unsigned long pFault, polls;
+static uint64_t rs;
+
+static uint32_t Rnd(void) {
+    rs ^= rs << 13;
+    rs ^= rs >> 7;
+    rs ^= rs << 17;
+    return (uint32_t)(rs >> 16);
+}
+
+static void Fail(const char *msg, unsigned long a, unsigned long b) {
+    if (errors < 20) printf("fail: %s (0x%lx, 0x%lx)\n", msg, a, b);
+    errors++;
+}
+
+static int InCcm(uint32_t addr, uint32_t bytes) {
+    return addr < 0x10010000UL && addr + bytes > 0x10000000UL;
+}
+
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState) {
+    if (NewState == ENABLE) RCC->AHB1ENR |= RCC_AHB1Periph;
+    else RCC->AHB1ENR &= ~RCC_AHB1Periph;
+}
+
+void DMA_StructInit(DMA_InitTypeDef *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void DMA_Init(DMA_Stream_TypeDef *d, DMA_InitTypeDef *s) {
+    g_stcSimDwt.CYCCNT += 20;
+    if (d->EN) Fail("数据流使能时调用 DMA_Init", 0, 0);
+    d->Cfg = *s;
+}
+
+void DMA_Cmd(DMA_Stream_TypeDef *d, FunctionalState NewState) {
+    const DMA_InitTypeDef *c = &d->Cfg;
+    uint32_t n = c->DMA_BufferSize, i, done;
+    uint32_t *dst = (uint32_t *)(uintptr_t)c->DMA_Memory0BaseAddr;
+    const uint32_t *src = (const uint32_t *)(uintptr_t)c->DMA_PeripheralBaseAddr;
+
+    if (NewState != ENABLE) {
+        d->EN = 0;
+        return;
+    }
+
+    if ((RCC->AHB1ENR & RCC_AHB1Periph_DMA2) == 0) Fail("DMA2 时钟未打开", 0, 0);
+    if (d->Flags != 0) Fail("使能前标志未清除", d->Flags, 0);
+    if (c->DMA_DIR != DMA_DIR_MemoryToMemory || c->DMA_Mode != DMA_Mode_Normal ||
+            c->DMA_FIFOMode != DMA_FIFOMode_Enable || c->DMA_MemoryInc != DMA_MemoryInc_Enable ||
+            c->DMA_PeripheralDataSize != DMA_PeripheralDataSize_Word ||
+            c->DMA_MemoryDataSize != DMA_MemoryDataSize_Word) {
+        Fail("DMA 配置不是字宽 FIFO 内存到内存", c->DMA_DIR, c->DMA_FIFOMode);
+    }
+    if (n == 0 || n > 0xFFFF) Fail("NDTR 超出 1~65535", n, 0);
+    if ((c->DMA_Memory0BaseAddr & 3) || (c->DMA_PeripheralBaseAddr & 3)) {
+        Fail("地址未字对齐", c->DMA_Memory0BaseAddr, c->DMA_PeripheralBaseAddr);
+    }
+    if (c->DMA_MemoryBurst == DMA_MemoryBurst_INC4 && ((n & 3) || (c->DMA_Memory0BaseAddr & 15))) {
+        Fail("4 拍突发时 NDTR 或存储器地址未对齐", n, c->DMA_Memory0BaseAddr);
+    }
+
+    d->EN = 1;
+    polls = 0;
+    transfers++;
+    g_stcSimDwt.CYCCNT += n;
+
+    if (InCcm(c->DMA_Memory0BaseAddr, n * 4) ||
+            InCcm(c->DMA_PeripheralBaseAddr, c->DMA_PeripheralInc == DMA_PeripheralInc_Enable ? n * 4 : 4)) {
+        /* CCM 不在 DMA 总线上, 第一次访问就出错 */
+        ccmHits++;
+        d->Flags |= DMA_FLAG_TEIF0 & 0x0FFFFFFFUL;
+        d->EN = 0;
+        return;
+    }
+
+    done = n;
+    if (pFault && Rnd() % 1000U < pFault) {
+        done = Rnd() % n;
+        faults++;
+    }
+
+    for (i = 0; i < done; i++) {
+        dst[i] = c->DMA_PeripheralInc == DMA_PeripheralInc_Enable ? src[i] : src[0];
+    }
+
+    d->Flags |= (done == n ? (DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0) : DMA_FLAG_TEIF0) & 0x0FFFFFFFUL;
+    d->EN = 0;
+}
+
+FlagStatus DMA_GetFlagStatus(DMA_Stream_TypeDef *d, uint32_t f) {
+    g_stcSimDwt.CYCCNT++;
+
+    if (!d->EN && ++polls > 1000000UL) {
+        /* 数据流已停止, 标志不会再变, 调用方卡在轮询中 */
+        printf("fail: 数据流停止后仍在轮询标志 0x%lx\n", (unsigned long)f);
+        exit(1);
+    }
+
+    return (d->Flags & f & 0x0FFFFFFFUL) ? SET : RESET;
+}
+
+void DMA_ClearFlag(DMA_Stream_TypeDef *d, uint32_t f) {
+    d->Flags &= ~(f & 0x0FFFFFFFUL);
+}
+
+static void CheckRegion(const char *name, const uint8_t *area, uint32_t size, uint32_t base, uint32_t limit) {
+    uint32_t a0 = (uint32_t)(uintptr_t)area, i;
+
+    for (i = 0; i < size; i++) {
+        uint32_t addr = a0 + i;
+        uint8_t want = (addr >= base && addr < limit) ? 0U : SIM_FILL;
+
+        if (area[i] != want) {
+            printf("fail: %s 0x%lx 为 0x%02x, 应为 0x%02x\n", name, (unsigned long)addr, area[i], want);
+            errors++;
+            return;
+        }
+    }
+}
+
+static void TestInit(uint32_t dma2On) {
+    const Mem_Stat *st;
+    uint8_t n;
+    uint32_t ccmBytes = (uint32_t)Image$$RW_CCM$$ZI$$Limit - (uint32_t)Image$$RW_CCM$$ZI$$Base;
+    uint32_t sramBytes = (uint32_t)Image$$RW_SRAM2$$ZI$$Limit - (uint32_t)Image$$RW_SRAM2$$ZI$$Base;
+
+    memset(g_au8SimCcm, SIM_FILL, sizeof(g_au8SimCcm));
+    memset(g_au8SimSram, SIM_FILL, sizeof(g_au8SimSram));
+    RCC->AHB1ENR = dma2On ? RCC_AHB1Periph_DMA2 : 0;
+
+    Mem_Init();
+
+    CheckRegion("CCM", g_au8SimCcm, sizeof(g_au8SimCcm), (uint32_t)Image$$RW_CCM$$ZI$$Base,
+                (uint32_t)Image$$RW_CCM$$ZI$$Limit);
+    CheckRegion("SRAM2", g_au8SimSram, sizeof(g_au8SimSram), (uint32_t)Image$$RW_SRAM2$$ZI$$Base,
+                (uint32_t)Image$$RW_SRAM2$$ZI$$Limit);
+
+    if ((RCC->AHB1ENR & RCC_AHB1Periph_DMA2) != (dma2On ? RCC_AHB1Periph_DMA2 : 0)) {
+        Fail("DMA2 时钟没有恢复原状", RCC->AHB1ENR, dma2On);
+    }
+
+    n = Mem_GetStat(&st);
+
+    if (n != 2 || strcmp(st[0].Name, "ccm") != 0 || strcmp(st[1].Name, "sram2") != 0) {
+        Fail("Mem_GetStat 区个数或区名不对", n, 0);
+        return;
+    }
+
+    if (st[0].Bytes != ccmBytes || st[1].Bytes != sramBytes) Fail("Mem_GetStat 字节数不对", st[0].Bytes, st[1].Bytes);
+    if (st[0].Engine != MEM_CPU) Fail("CCM 没有使用 CPU", st[0].Engine, 0);
+    if (st[1].Engine != (sramBytes >= MEM_DMA_MIN ? MEM_DMA : MEM_CPU)) Fail("SRAM2 方式不对", st[1].Engine, sramBytes);
+}
+
+static void TestFill(unsigned long count) {
+    unsigned long k;
+    uint32_t i;
+
+    RCC->AHB1ENR = RCC_AHB1Periph_DMA2;
+
+    for (k = 0; k < count; k++) {
+        uint32_t r = Rnd() % 16U;
+        uint32_t words = r == 0 ? (uint32_t)(0xFFFCUL * (1 + Rnd() % 4U) + Rnd() % 9U) % SIM_BIG_WORDS :
+                         r < 4 ? Rnd() % 8U : Rnd() % 5000U;
+        uint32_t off = SIM_GUARD + Rnd() % 8U;
+        uint32_t *dst = dst_Big;
+        uint32_t dstLen = SIM_BIG_WORDS + 2 * SIM_GUARD;
+        int copy = (int)(Rnd() & 1U);
+        int dma = (int)(Rnd() % 4U != 0);
+        uint32_t srcOff = SIM_GUARD + Rnd() % 8U;
+
+        if (Rnd() % 16U == 0) {
+            /* 目的在 CCM, DMA 必然出错, 全部由 CPU 完成 */
+            dst = (uint32_t *)(void *)g_au8SimCcm;
+            dstLen = sizeof(g_au8SimCcm) / 4;
+            words %= dstLen - 2 * SIM_GUARD;
+        }
+
+        if (words + off + SIM_GUARD > dstLen || words + srcOff > SIM_BIG_WORDS + 2 * SIM_GUARD) continue;
+
+        for (i = 0; i < dstLen; i++) dst[i] = 0xA5A5A5A5UL ^ i;
+        for (i = 0; i < words; i++) src_Big[srcOff + i] = Rnd();
+        memcpy(exp_Big, dst, dstLen * 4);
+        for (i = 0; i < words; i++) exp_Big[off + i] = copy ? src_Big[srcOff + i] : 0;
+
+        if (dma) Mem_DmaFill(dst + off, copy ? src_Big + srcOff : NULL, words);
+        else Mem_CpuFill(dst + off, copy ? src_Big + srcOff : NULL, words);
+
+        if (words > MEM_DMA_CHUNK) chunks++;
+
+        if (memcmp(dst, exp_Big, dstLen * 4) != 0) {
+            for (i = 0; i < dstLen && dst[i] == exp_Big[i]; i++);
+            printf("fail: %s%s %lu 字(偏移 %lu)在第 %lu 字处不同\n", dma ? "Mem_DmaFill" : "Mem_CpuFill",
+                   copy ? " 复制" : " 清零", (unsigned long)words, (unsigned long)off, (unsigned long)(i - off));
+            errors++;
+        }
+
+        if (g_stcSimDma.EN) Fail("DMA 数据流结束后仍在使能", 0, 0);
+    }
+}
+
+int main(int argc, char **argv) {
+    Mem_Usage u;
+    unsigned long count = argc > 2 ? strtoul(argv[2], NULL, 0) : 0;
+
+    rs = 0x9E3779B97F4A7C15ULL ^ (argc > 1 ? strtoul(argv[1], NULL, 0) : 1);
+    pFault = argc > 3 ? strtoul(argv[3], NULL, 0) : 0;
+
+    TestInit(0);
+    TestInit(1);
+    TestFill(count);
+
+    if (Mem_GetUsage(MEM_USAGE_NUM, &u) != ERROR) Fail("Mem_GetUsage 越界未返回 ERROR", MEM_USAGE_NUM, 0);
+    if (Mem_GetUsage(MEM_USAGE_NUM - 1, &u) != SUCCESS) Fail("Mem_GetUsage 最后一项失败", 0, 0);
+
+    printf("transfers=%lu\nfaults=%lu\nccm=%lu\nchunked=%lu\nerrors=%lu\n", transfers, faults, ccmHits, chunks, errors);
+    return errors ? 1 : 0;
+}
+'''
+
+
+def parse_scatter():
+    """返回 [(区名, 地址, 大小, UNINIT, [选择器])], 注释掉的区带 commented 标记"""
+    with open(SCATTER, encoding='utf-8') as f:
+        lines = f.read().splitlines()
+    regions = []
+    cur = None
+    for line in lines:
+        commented = line.lstrip().startswith(';')
+        body = line.lstrip().lstrip(';').split(';')[0].strip()
+        m = re.match(r'(\w+)\s+(0x[0-9A-Fa-f]+)\s+(UNINIT\s+)?(0x[0-9A-Fa-f]+)\s*\{', body)
+        if m and not m.group(1).startswith('LR_'):
+            cur = dict(name=m.group(1), addr=int(m.group(2), 16), size=int(m.group(4), 16),
+                       uninit=bool(m.group(3)), sel=[], commented=commented)
+            regions.append(cur)
+        elif cur is not None and body.startswith('}'):
+            cur = None
+        elif cur is not None and body:
+            cur['sel'].append(body)
+    return regions
+
+
+def static_checks():
+    errs = []
+    regions = parse_scatter()
+    by_name = {r['name']: r for r in regions}
+    with open(SOURCE, encoding='utf-8') as f:
+        src = f.read()
+    with open(HEADER, encoding='utf-8') as f:
+        hdr = f.read()
+
+    table = src[src.index('mem_table[] = {'):]
+    table = table[:table.index('};')]
+    entries = re.findall(r'^\s*\{"(\w+)",\s*Image\$\$(\w+)\$\$ZI\$\$Base,\s*Image\$\$(\w+)\$\$ZI\$\$Limit,'
+                         r'\s*NULL,\s*(MEM_\w+),\s*(MEM_\w+)\}', table, re.M)
+    in_table = {}
+    for name, base, limit, op, engine in entries:
+        if base != limit:
+            errs.append('mem_table 项 %s 的 Base/Limit 属于不同执行区' % name)
+        in_table[base] = engine
+    guarded = re.search(r'#if MEM_USE_SDRAM\s*\n[^#]*RW_SDRAM', table) is not None
+    use_sdram = re.search(r'#define\s+MEM_USE_SDRAM\s+(\d+)', hdr)
+    use_sdram = use_sdram is not None and use_sdram.group(1) != '0'
+
+    for r in regions:
+        if not r['uninit'] or r['name'] in NO_CLEAR:
+            continue
+        if r['name'] not in in_table:
+            errs.append('UNINIT 执行区 %s 没有清零项' % r['name'])
+        elif r['name'] == 'RW_SDRAM' and not guarded:
+            errs.append('RW_SDRAM 清零项没有用 MEM_USE_SDRAM 包起来')
+        if r['commented'] and use_sdram and r['name'] == 'RW_SDRAM':
+            errs.append('MEM_USE_SDRAM 为 1 但 Template.sct 中 RW_SDRAM 被注释')
+    for name, engine in in_table.items():
+        if name not in by_name:
+            errs.append('mem_table 引用了不存在的执行区 %s' % name)
+            continue
+        r = by_name[name]
+        if r['name'] in NO_CLEAR:
+            errs.append('%s 不应清零' % name)
+        if engine == 'MEM_DMA' and r['addr'] < CCM_END and r['addr'] + r['size'] > CCM_BASE:
+            errs.append('%s 在 CCM 中却选了 MEM_DMA' % name)
+
+    for macro, section in re.findall(r'#define\s+(MEM_\w+)\s+__attribute__\(\(section\("([.\w]+)"', hdr):
+        owners = [r['name'] for r in regions if any(('(%s)' % section) in s for s in r['sel'])]
+        if len(owners) != 1:
+            errs.append('%s 的段 %s 被 %d 个执行区选中' % (macro, section, len(owners)))
+
+    usage = re.findall(r'^\s*\{"(\w+)",\s*Image\$\$(\w+)\$\$Base,', src, re.M)
+    live = [r['name'] for r in regions if not r['commented']]
+    num = int(re.search(r'#define\s+MEM_USAGE_NUM\s+(\d+)', hdr).group(1))
+    if [u[0] for u in usage] != live or any(a != b for a, b in usage) or num != len(live):
+        errs.append('mem_usage %s 与 Template.sct 执行区 %s 不一致(MEM_USAGE_NUM=%d)' % (
+            [u[0] for u in usage], live, num))
+    return errs, by_name, [u[0] for u in usage]
+
+
+def build_object(args, tmp):
+    with open(DMA_LIB, encoding='utf-8') as f:
+        dma = f.read()
+    with open(RCC_LIB, encoding='utf-8') as f:
+        rcc = f.read()
+    struct = re.search(r'typedef struct\s*\{(?:(?!typedef).)*?\}\s*DMA_InitTypeDef;', dma, re.S).group(0)
+    consts = re.findall(r'#define\s+DMA_\w+\s+\(\(uint32_t\)0x[0-9A-Fa-f]+\)', dma)
+    consts += re.findall(r'#define\s+RCC_AHB1Periph_DMA2\s+\(\(uint32_t\)0x[0-9A-Fa-f]+\)', rcc)
+    with open(os.path.join(tmp, 'stm32f4xx_conf.h'), 'w', encoding='utf-8') as f:
+        f.write(STUB % '\n'.join([struct] + consts))
+    driver = os.path.join(tmp, 'driver.c')
+    with open(driver, 'w', encoding='utf-8') as f:
+        f.write(DRIVER)
+    obj = os.path.join(tmp, 'driver.o')
+    # zero_init 是 armcc 的属性; 地址在主机上也按 32 位处理, 用 -no-pie 保证模拟内存在低 4GB
+    cmd = [args.cc, '-std=gnu99', '-O2', '-Wall', '-Wextra', '-Werror', '-Wno-attributes',
+           '-Wno-pointer-to-int-cast', '-Wno-int-to-pointer-cast', '-fno-pie', '-I', tmp,
+           '-I', os.path.dirname(SOURCE), '-c', driver, '-o', obj]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return obj
+
+
+def layouts(rnd, by_name, count):
+    """(CCM ZI 基址, 长度, SRAM2 ZI 基址, 长度)"""
+    ccm, sram = by_name['RW_CCM'], by_name['RW_SRAM2']
+    out = [(ccm['addr'], ccm['size'], sram['addr'], sram['size']),
+           (ccm['addr'], 0, sram['addr'], 0),
+           (ccm['addr'] + 8, 13, sram['addr'] + 4, 255),
+           (ccm['addr'], 256, sram['addr'], 256),
+           (ccm['addr'] + 4, 1027, sram['addr'] + 12, 4099)]
+    while len(out) < count:
+        cb = ccm['addr'] + 4 * rnd.randrange(0, 64)
+        sb = sram['addr'] + 4 * rnd.randrange(0, 64)
+        out.append((cb, rnd.randrange(0, ccm['addr'] + ccm['size'] - cb + 1),
+                    sb, rnd.randrange(0, sram['addr'] + sram['size'] - sb + 1)))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--layouts', type=int, default=40)
+    ap.add_argument('--fills', type=int, default=400, help='每个布局直接调用填充函数的次数')
+    ap.add_argument('--faults', type=int, default=50, help='每千次 DMA 传输中途出错的次数')
+    args = ap.parse_args()
+
+    errs, by_name, usage = static_checks()
+    for e in errs[:MAX_REPORT]:
+        print(e)
+    print('静态核对: 执行区 %d 个, 差异 %d 项' % (len(by_name), len(errs)))
+    bad = len(errs)
+    if 'RW_CCM' not in by_name or 'RW_SRAM2' not in by_name:
+        return 1
+
+    rnd = random.Random(args.seed)
+    tmp = tempfile.mkdtemp()
+    tot = {}
+    fails = 0
+    try:
+        obj = build_object(args, tmp)
+        if obj is None:
+            return 1
+        sims = ('.simccm', by_name['RW_CCM']['addr'] & ~0xFFFF), ('.simsram', by_name['RW_SRAM2']['addr'] & ~0x3FFF)
+        for k, (cb, cl, sb, sl) in enumerate(layouts(rnd, by_name, args.layouts)):
+            syms = {'RW_CCM$$ZI$$Base': cb, 'RW_CCM$$ZI$$Limit': cb + cl,
+                    'RW_SRAM2$$ZI$$Base': sb, 'RW_SRAM2$$ZI$$Limit': sb + sl}
+            for i, name in enumerate(usage):
+                r = by_name[name]
+                syms['%s$$Base' % name] = r['addr']
+                syms['%s$$Length' % name] = 0
+                syms['%s$$ZI$$Length' % name] = i
+            exe = os.path.join(tmp, 'mem%d' % k)
+            cmd = [args.cc, '-no-pie', obj, '-o', exe]
+            cmd += ['-Wl,--section-start=%s=0x%x' % s for s in sims]
+            cmd += ['-Wl,--defsym=Image$$%s=0x%x' % kv for kv in sorted(syms.items())]
+            r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+            if r.returncode != 0:
+                print(r.stdout)
+                return 1
+            r = subprocess.run([exe, str(args.seed * 1000 + k), str(args.fills), str(args.faults)],
+                               stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+            out = r.stdout.splitlines()
+            msgs = [l[6:] for l in out if l.startswith('fail: ')]
+            for l in out:
+                if '=' in l:
+                    key, v = l.split('=', 1)
+                    tot[key] = tot.get(key, 0) + int(v)
+            if msgs or r.returncode != 0:
+                if fails < MAX_REPORT:
+                    print('布局 CCM 0x%x+%d, SRAM2 0x%x+%d: %s' % (cb, cl, sb, sl,
+                          '; '.join(msgs[:3]) or '返回 %d' % r.returncode))
+                fails += 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    print('主机运行: 布局 %d 个, DMA 传输 %d 次(中途出错 %d, 访问 CCM %d), 跨分块 %d 次, 差异 %d 项' % (
+        args.layouts, tot.get('transfers', 0), tot.get('faults', 0), tot.get('ccm', 0), tot.get('chunked', 0), fails))
+    return 1 if bad or fails else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
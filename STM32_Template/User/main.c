@@ -19,7 +19,21 @@
  */
 #include "stm32f4xx.h"                  // Device header
 #include "stm32f4xx_conf.h"
+#include "boot_seq.h"
+#include "delay.h"
+
+static void Boot_Delay(void) {
+    delay_init(SystemCoreClock / 1000000);
+}
+
+/* 启动步骤: BOOT_ANY_CLOCK 的步骤与 HSE/PLL 启动并行执行 */
+static const Boot_Step boot_steps[] = {
+    {"delay", Boot_Delay, BOOT_NEED_CLOCK},
+};
+
 int main(void) {
+    Boot_Run(boot_steps, sizeof(boot_steps) / sizeof(boot_steps[0]));
+    Boot_Mark("loop");
 
     while(1) {
     }
@@ -0,0 +1,142 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 SWM341 部分, 接到 Common/lp_gov
+                   1. SLEEP 由 RTC 秒中断按时唤醒, 相位未知, 一次驻留 0 ~ 1 秒, 所以要求空闲时间
+                      不少于 1 秒 + 唤醒时延 (SLEEP 的 MinUs 默认 1 秒), 驻留时间只能由 NowUs 计;
+                   2. 时钟恢复: 进入前把系统时钟切到 HRC, 唤醒后 PLL 使用中时等待重新锁定, 再恢复
+                      CLKSEL 的系统时钟选择, 分频设置不变;
+                   3. 进入耗时和恢复耗时用 DWT 周期计数实测, 恢复耗时按 HRC 周期计.
+                   RTC 需已启动, 否则只用 WFI.
+  * Function List:
+
+  **********************************************************
+ */
+#include "lp_gov_hw.h"
+#include "SWM341_sleep.h"
+
+static uint32_t lp_sec_ie;
+
+/* 默认时延: SLEEP 唤醒按 HRC 起振估计, 恢复时间按 PLL 锁定估计, 首次唤醒后由实测替换 */
+static const Lp_Latency lp_lat_default[LP_MODE_NUM] = {
+    {0, 0,  0,   0},
+    {1, 1,  0,   0},
+    {5, 20, 200, 1000000},
+};
+
+static uint32_t LP_Lock(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+}
+
+static void LP_Unlock(uint32_t state) {
+    __set_PRIMASK(state);
+}
+
+static uint32_t LP_Cycles(void) {
+    return DWT->CYCCNT;
+}
+
+static uint32_t LP_CpuMhz(void) {
+    return CyclesPerUs;
+}
+
+static uint8_t LP_Deepest(void) {
+    return (RTC->EN & 1) ? LP_MODE_SLEEP : LP_MODE_WFI;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	LP_Arm()
+* 功能说明:	打开 RTC 秒中断作为 SLEEP 的唤醒源
+* 输    入: uint8_t mode				LP_MODE_SLEEP
+*			uint32_t us				定时, 秒中断无法设置, 不使用
+* 输    出: uint32_t					0, 秒中断相位未知, 驻留时间由 NowUs 计
+* 注意事项: 秒中断只作唤醒用, 原来没开时唤醒后关掉
+******************************************************************************************************************************************/
+static uint32_t LP_Arm(uint8_t mode, uint32_t us) {
+    (void)mode;
+    (void)us;
+
+    lp_sec_ie = RTC->IE & (1 << RTC_IE_SEC_Pos);
+    RTC_IntSecondClr(RTC);
+    RTC_IntSecondEn(RTC);
+    SYS->RTCWKSR = SYS_RTCWKSR_FLAG_Msk;
+    SYS->RTCWKCR = SYS_RTCWKCR_EN_Msk;
+
+    return 0;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	LP_Enter()
+* 功能说明:	进入 mode 直到唤醒, SLEEP 唤醒后恢复时钟
+* 输    入: uint8_t mode				LP_MODE_WFI、LP_MODE_SLEEP
+*			void (*wake)(uint8_t)	在 HRC 上等待 PLL 锁定前调用, 可为 NULL
+*			Lp_Wake *info			SLEEP 唤醒后填写
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+static void LP_Enter(uint8_t mode, void (*wake)(uint8_t mode), Lp_Wake *info) {
+    uint32_t clksel, start;
+
+    if(mode == LP_MODE_WFI) {
+        __WFI();
+        return;
+    }
+
+    clksel = SYS->CLKSEL;
+    SYS->HRCCR |= SYS_HRCCR_ON_Msk;
+    SYS->CLKSEL |= SYS_CLKSEL_SYS_Msk;
+
+    EnterSleepMode();
+
+    /* 此时运行在 HRC 上 */
+    start = DWT->CYCCNT;
+    if(wake) wake(mode);
+    if((clksel & SYS_CLKSEL_SYS_Msk) == 0 && (SYS->PLLCR & SYS_PLLCR_OFF_Msk) == 0) {
+        while((SYS->PLLLOCK & 1) == 0);
+    }
+    SYS->CLKSEL = clksel;
+
+    info->RestoreCycles = DWT->CYCCNT - start;
+    info->RestoreMhz = (SYS->HRCCR & SYS_HRCCR_DBL_Msk) ? 40 : 20;
+
+    info->Fired = (SYS->RTCWKSR & SYS_RTCWKSR_FLAG_Msk) && RTC_IntSecondStat(RTC);
+    SYS->RTCWKCR = 0;
+    SYS->RTCWKSR = SYS_RTCWKSR_FLAG_Msk;
+    if(!lp_sec_ie) {
+        RTC_IntSecondDis(RTC);
+        RTC_IntSecondClr(RTC);
+    }
+}
+
+static const Lp_Port lp_port = {
+    LP_MODE_NUM, LP_MODE_SLEEP, lp_lat_default,
+    LP_Lock, LP_Unlock, LP_Cycles, LP_CpuMhz, LP_Deepest, LP_Arm, LP_Enter
+};
+
+/******************************************************************************************************************************************
+* 函数名称:	Lp_Init()
+* 功能说明:	打开 DWT 周期计数, 装入默认时延表
+* 输    入: const Lp_Config *cfg	回调, NextDeadline 不能为 NULL
+* 输    出: int32_t					LP_OK; 参数错误时 LP_ERR_PARAM
+* 注意事项: RTC 需已启动才会使用 SLEEP
+******************************************************************************************************************************************/
+int32_t Lp_Init(const Lp_Config *cfg) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return Lp_GovInit(&lp_port, cfg);
+}
@@ -0,0 +1,39 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : lp_gov_hw.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 空闲低功耗调度的 SWM341 部分
+                   接口与 STM32/HC32 模板的 lp_gov_hw.h 相同, 模式选择、时延学习、Lp_Block 计数和
+                   驻留统计在 Common/lp_gov.c, 这里只管内核 WFI / 芯片 SLEEP 的进入、RTC 秒中断唤醒和
+                   唤醒后的时钟恢复; Lp_Idle / Lp_Block / Lp_SetMaxLatency / Lp_GetStats 等见 lp_gov.h.
+                   SLEEP 只能由唤醒源唤醒, 按时唤醒用 RTC 秒中断, 所以只在空闲超过 1 秒时使用;
+                   唤醒后按进入前记下的时钟选择直接恢复, 不重新初始化 PLL.
+                   等待 PLL 锁定不设超时, Lp_Stats.ClockFail 始终为 0.
+                   STOP 模式唤醒后芯片复位, 不作为空闲模式.
+  * Function List:
+                   Lp_Init
+  ******************************************************
+**/
+
+#ifndef __LP_GOV_HW_H_
+#define __LP_GOV_HW_H_
+
+#include "SWM341.h"
+#include "lp_gov.h"
+
+/* 模式, 数值越大越深 */
+#define LP_MODE_WFI             1       //内核 WFI, 时钟不停, 任何中断唤醒
+#define LP_MODE_SLEEP           2       //芯片 SLEEP, RTC 秒中断或其他已使能的唤醒源唤醒
+#define LP_MODE_NUM             3
+
+int32_t Lp_Init(const Lp_Config *cfg);
+
+#endif
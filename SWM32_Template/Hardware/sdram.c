@@ -0,0 +1,131 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SDRAMC 外部 SDRAM
+                   1. SDRAM 时钟 = 系统时钟 / 分频(1/2), 取不超过 MaxHz 的最小分频;
+                   2. 时序由 SDRAM_PlanTiming 换算; tRP/tRCD 可设 1~4 个周期, tRFC(用 tRC)可设 4~16 个周期,
+                      不足 4 个周期按 4 设置, 超出时返回 SDRAM_ERR_TIMING; tRAS/tWR/tXSR/tMRD 由控制器
+                      固定, 不可设置;
+                   3. 库函数按 64ms 固定计算刷新间隔且向上取整, 这里按 RefreshMs/RefreshRows 重新写入
+                      T64, 减 20 个周期留给正在进行的访问.
+  * Function List:
+
+  **********************************************************
+ */
+#include "sdram.h"
+#include "SWM341_sdram.h"
+#include "stddef.h"
+
+#define SDRAM_REFRESH_MARGIN    20
+
+/* SDRAMC 支持的 4 种器件 */
+static const struct {
+    uint8_t size;
+    uint8_t col;
+    uint8_t row;
+    uint8_t inbk;
+} sd_geo[] = {
+    {SDRAM_SIZE_2MB,  8, 11, 2},
+    {SDRAM_SIZE_8MB,  8, 12, 4},
+    {SDRAM_SIZE_16MB, 9, 12, 4},
+    {SDRAM_SIZE_32MB, 9, 13, 4},
+};
+
+/******************************************************************************************************************************************
+* 函数名称:	SDRAM_Setup()
+* 功能说明:	按器件参数初始化 SDRAM
+* 输    入: const SDRAM_Config *Config	器件参数, Device 只能为 0
+*			SDRAM_Info *Info			输出实际时钟、容量和刷新间隔, 可以为 NULL
+* 输    出: int32_t					SDRAM_OK / SDRAM_ERR_xxx
+* 注意事项: 在系统时钟配置完成后调用, 改变系统时钟后须重新调用. 初始化会清空分配器.
+*			只支持 16 位宽、CAS 2~3, 行列位数和内部 bank 数须与 sd_geo 中的一种相同.
+*			ReadBurst、ReadDelay 不使用. 库函数 SDRAM_Init 等待上电序列完成, 没有超时.
+******************************************************************************************************************************************/
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info) {
+    SDRAM_InitStructure init;
+    SDRAM_Timing t;
+    SDRAM_Info info;
+    uint32_t hz, refresh, i;
+    int32_t ret;
+    uint8_t div;
+
+    (void)SDRAM_Attach(NULL);
+
+    for(i = 0; i < sizeof(sd_geo) / sizeof(sd_geo[0]); i++) {
+        if(sd_geo[i].col == Config->ColBits && sd_geo[i].row == Config->RowBits && sd_geo[i].inbk == Config->InBanks) break;
+    }
+
+    if(i == sizeof(sd_geo) / sizeof(sd_geo[0]) || Config->Device != 0 || Config->Width != 16 || Config->Cas < 2 ||
+            Config->Cas > 3) return SDRAM_ERR_PARAM;
+
+    div = SDRAM_PickDiv(SystemCoreClock, Config->MaxHz, 1, 2);
+
+    if(div == 0) return SDRAM_ERR_CLOCK;
+
+    hz = SystemCoreClock / div;
+    ret = SDRAM_PlanTiming(Config, hz, &t);
+
+    if(ret != SDRAM_OK) return ret;
+
+    if(t.tRP > 4 || t.tRCD > 4 || t.tRC > 16) return SDRAM_ERR_TIMING;
+
+    if(t.tRC < 4) t.tRC = 4;
+
+    if(t.Refresh <= SDRAM_REFRESH_MARGIN) return SDRAM_ERR_REFRESH;
+
+    refresh = t.Refresh - SDRAM_REFRESH_MARGIN;
+
+    init.Size = sd_geo[i].size;
+    init.ClkDiv = div == 1 ? SDRAM_CLKDIV_1 : SDRAM_CLKDIV_2;
+    init.CASLatency = Config->Cas == 2 ? SDRAM_CASLATENCY_2 : SDRAM_CASLATENCY_3;
+    init.TimeTRP = (uint8_t)(t.tRP - 1);
+    init.TimeTRCD = (uint8_t)(t.tRCD - 1);
+    init.TimeTRFC = (uint8_t)(t.tRC - 1);
+    SDRAM_Init(&init);
+
+    SDRAMC->T64 = refresh;
+
+    info.Base = SDRAMM_BASE;
+    info.RowSize = (1UL << Config->ColBits) * 2;
+    info.BankSize = info.RowSize << Config->RowBits;
+    info.Size = info.BankSize * Config->InBanks;
+    info.ClockHz = hz;
+    info.Refresh = (uint16_t)refresh;
+    info.Div = div;
+    info.InBanks = Config->InBanks;
+    info.Map = SDRAM_MAP_ROW_BANK_COL;
+
+    if(Info) *Info = info;
+
+    return SDRAM_Attach(&info);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	SDRAM_Bench()
+* 功能说明:	测量当前配置的带宽
+* 输    入: void *Buf					测试缓冲, 顺序写会改写其内容
+*			uint32_t Bytes				测试缓冲大小, 每项测试访问 Bytes 字节
+*			SDRAM_BenchResult *Result	输出, 单位 KB/s
+* 输    出: 无
+* 注意事项: 关中断后用 DWT 计数执行 SDRAM_BenchRun
+******************************************************************************************************************************************/
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __disable_irq();
+
+    SDRAM_BenchRun(Buf, Bytes, &DWT->CYCCNT, SystemCoreClock, Result);
+
+    __enable_irq();
+}
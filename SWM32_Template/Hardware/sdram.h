@@ -0,0 +1,35 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : sdram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SDRAMC 外部 SDRAM 初始化和带宽测试
+                   时序换算、分配和测试过程在 Common/sdram_plan.c, 这里按器件参数选 SDRAMC 的容量和
+                   分频, 调用库函数 SDRAM_Init 执行上电序列, 再写入实际的刷新间隔.
+                   SDRAMC 的地址映射固定为 [行][内部 bank][列], 每行大小的一段轮流落在各个 bank,
+                   SDRAM_Alloc 返回的缓冲从所选 bank 的行段开头开始, 两个起点在不同 bank 的缓冲按
+                   相同偏移访问时始终在不同 bank.
+                   SDRAMC 引脚复用由用户在调用 SDRAM_Setup 之前配置.
+  * Function List:
+                   SDRAM_Setup
+                   SDRAM_Bench
+  ******************************************************
+**/
+
+#ifndef __SDRAM_H_
+#define __SDRAM_H_
+
+#include "SWM341.h"
+#include "sdram_plan.h"
+
+int32_t SDRAM_Setup(const SDRAM_Config *Config, SDRAM_Info *Info);
+void SDRAM_Bench(void *Buf, uint32_t Bytes, SDRAM_BenchResult *Result);
+
+#endif
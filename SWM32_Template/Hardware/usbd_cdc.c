@@ -0,0 +1,688 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@icloud.com
+  *
+  * FileName     : usbd_cdc.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : USB 全速设备 CDC-ACM + 厂商 Bulk 类驱动
+                   1. 发送: USBD_CDC_Write 把数据写入包缓冲区, 端点空闲时立即装入 FIFO;
+                      每包发送完成的中断里装入下一包, 没有整包时把未满的包也发出去,
+                      最后一包正好为 USBD_CDC_PKSZ 字节时自动补一个零长度包结束传输;
+                   2. 接收: 中断里把 RXBUF 按字拷贝到包缓冲区后立即重新使能端点,
+                      缓冲区满时暂停使能, 端点回 NAK 实现流控, USBD_CDC_Read 腾出空间后恢复;
+                   3. 应用与中断共享的状态只在屏蔽该端点中断(USBD->EPIE 对应位)时修改; EPIE 中断里也会改写,
+                      它的读改写由 USBD_EPIntMask/USBD_EPIntRestore 在关中断下完成, 只有几条指令,
+                      拷贝和队列操作期间不关全局中断. IN 端点只在有包在 FIFO 中时开中断, 空闲时不会被 NAK 中断打扰;
+                   4. 零拷贝: USBD_CDC_TxAcquire/TxCommit 直接在包缓冲区里组包, USBD_CDC_RxAcquire/RxRelease
+                      直接读包缓冲区, 数据只在包缓冲区和端点 FIFO 之间按字搬一次.
+                   Tools/usbd_cdc_test.py 在主机上用录制的 SETUP/OUT 包回放驱动本文件和 SWM341_usbd.c.
+                   系统时钟需满足 USB PHY 的要求, 见 SystemInit.
+  * Function List:
+
+  **********************************************************
+ */
+#include <string.h>
+#include "usbd_cdc.h"
+
+#define USBD_CDC_VID            0x1234  //测试用, 产品需换成自己的 VID/PID
+#define USBD_CDC_PID            0x5741
+
+#define USBD_CDC_NOTIFY_EP      1
+#define USBD_CDC_ACM_EP         2
+#define USBD_CDC_VENDOR_EP      3
+
+#define USBD_CDC_SET_LINE_CODING        0x20
+#define USBD_CDC_GET_LINE_CODING        0x21
+#define USBD_CDC_SET_CONTROL_LINE_STATE 0x22
+
+#define USBD_CDC_SLOT_MASK      (USBD_CDC_SLOTS - 1)
+#define USBD_CDC_PKWORDS        (USBD_CDC_PKSZ / 4)
+
+typedef struct {
+    uint32_t Buf[USBD_CDC_SLOTS][USBD_CDC_PKWORDS];
+    uint16_t Len[USBD_CDC_SLOTS];
+    volatile uint8_t Head;          //发送: 正在填的包; 接收: 中断写入的下一包
+    volatile uint8_t Tail;          //发送: 下一个装入 FIFO 的包; 接收: 应用读取的包
+} USBD_CDC_Ring_t;
+
+typedef struct {
+    USBD_CDC_Ring_t Tx;
+    USBD_CDC_Ring_t Rx;
+    uint8_t  Ep;
+    uint8_t  TxBusy;                //FIFO 中有包
+    uint8_t  TxZLP;                 //上一包为满包, 队列空时要补零长度包
+    uint8_t  RxPaused;              //接收缓冲区满, 端点未使能
+    uint16_t RxOffset;              //Tail 包中已读出的字节数
+} USBD_CDC_Port_t;
+
+static USBD_CDC_Port_t cdc_port[USBD_CDC_PORT_NUM];
+static USBD_CDC_Stats_t cdc_stats;
+static volatile uint8_t cdc_configured;
+static uint8_t cdc_line_state;
+static USBD_CDC_LineCoding_t cdc_line_coding = {115200, 0, 0, 8};
+
+
+static uint8_t cdc_desc_device[] = {
+    18,                             //bLength
+    USB_DESC_DEVICE,
+    0x00, 0x02,                     //bcdUSB 2.00
+    0xEF, 0x02, 0x01,               //Miscellaneous, 使用 IAD 的复合设备
+    64,                             //bMaxPacketSize0
+    USBD_CDC_VID & 0xFF, USBD_CDC_VID >> 8,
+    USBD_CDC_PID & 0xFF, USBD_CDC_PID >> 8,
+    0x00, 0x01,                     //bcdDevice
+    1, 2, 3,                        //iManufacturer, iProduct, iSerialNumber
+    1                               //bNumConfigurations
+};
+
+#define USBD_CDC_CFG_LEN        98
+
+static uint8_t cdc_desc_config[USBD_CDC_CFG_LEN] = {
+    9, USB_DESC_CONFIG, USBD_CDC_CFG_LEN & 0xFF, USBD_CDC_CFG_LEN >> 8,
+    3,                              //bNumInterfaces
+    1,                              //bConfigurationValue
+    0, 0x80, 50,                    //总线供电, 100mA
+
+    /* IAD: 接口 0、1 组成一个 CDC 功能 */
+    8, 0x0B, 0, 2, USB_CDC_CTRL_CLASS, USB_CDC_ACM, USB_CDC_ATCMD, 0,
+
+    /* 接口 0: CDC 通信接口 */
+    9, USB_DESC_INTERFACE, 0, 0, 1, USB_CDC_CTRL_CLASS, USB_CDC_ACM, USB_CDC_ATCMD, 0,
+    5, 0x24, 0x00, 0x10, 0x01,      //Header, CDC 1.10
+    5, 0x24, 0x01, 0x00, 1,         //Call Management, 数据接口 1
+    4, 0x24, 0x02, 0x02,            //ACM, 支持 Line Coding 和 Control Line State
+    5, 0x24, 0x06, 0, 1,            //Union, 主接口 0, 从接口 1
+    7, USB_DESC_ENDPOINT, USB_EP_IN | USBD_CDC_NOTIFY_EP, USB_EP_INT, 8, 0, 16,
+
+    /* 接口 1: CDC 数据接口 */
+    9, USB_DESC_INTERFACE, 1, 0, 2, USB_CDC_DATA_CLASS, 0, 0, 0,
+    7, USB_DESC_ENDPOINT, USB_EP_OUT | USBD_CDC_ACM_EP, USB_EP_BULK, USBD_CDC_PKSZ, 0, 0,
+    7, USB_DESC_ENDPOINT, USB_EP_IN  | USBD_CDC_ACM_EP, USB_EP_BULK, USBD_CDC_PKSZ, 0, 0,
+
+    /* 接口 2: 厂商 Bulk */
+    9, USB_DESC_INTERFACE, 2, 0, 2, 0xFF, 0, 0, 0,
+    7, USB_DESC_ENDPOINT, USB_EP_OUT | USBD_CDC_VENDOR_EP, USB_EP_BULK, USBD_CDC_PKSZ, 0, 0,
+    7, USB_DESC_ENDPOINT, USB_EP_IN  | USBD_CDC_VENDOR_EP, USB_EP_BULK, USBD_CDC_PKSZ, 0, 0,
+};
+
+static uint8_t cdc_str_lang[] = {4, USB_DESC_STRING, 0x09, 0x04};
+static uint8_t cdc_str_vendor[] = {
+    16, USB_DESC_STRING, 't', 0, 'x', 0, 't', 0, '1', 0, '9', 0, '9', 0, '4', 0
+};
+static uint8_t cdc_str_product[] = {
+    22, USB_DESC_STRING, 'S', 0, 'W', 0, 'M', 0, '3', 0, '4', 0, '1', 0, ' ', 0, 'C', 0, 'D', 0, 'C', 0
+};
+static uint8_t cdc_str_serial[] = {
+    14, USB_DESC_STRING, '0', 0, '0', 0, '0', 0, '0', 0, '0', 0, '1', 0
+};
+
+/* USBD_GetDescriptor 接受 0~5 号字符串, 未用的序号也要指向有效的描述符 */
+static uint8_t *cdc_desc_string[6] = {
+    cdc_str_lang, cdc_str_vendor, cdc_str_product, cdc_str_serial, cdc_str_product, cdc_str_product
+};
+
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_TxPacket()
+* 功能说明:	把一包数据按字写入 IN 端点 FIFO 并启动发送
+* 输    入: uint8_t ep				端点号
+*			const uint32_t *buf		字对齐的数据, 长度按 4 字节向上取整读取
+*			uint32_t size			包长
+* 输    出: 无
+* 注意事项: 调用者保证该端点中断已屏蔽或在该端点的中断中调用
+******************************************************************************************************************************************/
+static void USBD_CDC_TxPacket(uint8_t ep, const uint32_t *buf, uint32_t size) {
+    volatile uint32_t *fifo = USBD->TXBUF[ep];
+    uint32_t i;
+
+    USBD->INEP[ep].TXCR = USBD_TXCR_FLUSHFF_Msk;
+    USBD->INEP[ep].TXTRSZ = size;
+
+    for(i = 0; i < (size + 3) / 4; i++) {
+        fifo[i] = buf[i];
+    }
+
+    USBD->INEP[ep].TXCR = USBD_TXCR_FFRDY_Msk;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_TxNext()
+* 功能说明:	端点空闲时装入下一包
+* 输    入: USBD_CDC_Port_t *p	端口
+* 输    出: 无
+* 注意事项: 没有可发送的包时标记空闲并关闭该 IN 端点中断
+******************************************************************************************************************************************/
+static void USBD_CDC_TxNext(USBD_CDC_Port_t *p) {
+    USBD_CDC_Ring_t *r = &p->Tx;
+    uint8_t  slot;
+    uint16_t size;
+    uint8_t  port = (uint8_t)(p - cdc_port);
+
+    if(r->Head == r->Tail && r->Len[r->Head & USBD_CDC_SLOT_MASK] != 0) {
+        /* 没有整包, 把正在填的包也发出去 */
+        r->Head++;
+    }
+
+    if(r->Head != r->Tail) {
+        slot = r->Tail & USBD_CDC_SLOT_MASK;
+        size = r->Len[slot];
+        USBD_CDC_TxPacket(p->Ep, r->Buf[slot], size);
+        r->Len[slot] = 0;
+        r->Tail++;
+
+        p->TxZLP = (size == USBD_CDC_PKSZ);
+        cdc_stats.TxPackets[port]++;
+    } else if(p->TxZLP) {
+        USBD_CDC_TxPacket(p->Ep, 0, 0);
+        p->TxZLP = 0;
+        cdc_stats.TxZLP[port]++;
+    } else {
+        p->TxBusy = 0;
+        USBD_EPIntMask(1u << p->Ep);
+        return;
+    }
+
+    p->TxBusy = 1;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_RxPacket()
+* 功能说明:	OUT 端点收到一包, 按字拷贝到包缓冲区
+* 输    入: USBD_CDC_Port_t *p	端口
+* 输    出: 无
+* 注意事项: 缓冲区还有空位时立即重新使能端点, 否则暂停, 主机收到 NAK 后重试
+******************************************************************************************************************************************/
+static void USBD_CDC_RxPacket(USBD_CDC_Port_t *p) {
+    USBD_CDC_Ring_t *r = &p->Rx;
+    uint32_t size = (USBD->RXSR & USBD_RXSR_TRSZ_Msk) >> USBD_RXSR_TRSZ_Pos;
+    uint32_t *buf;
+    uint32_t i;
+    uint8_t  port = (uint8_t)(p - cdc_port);
+
+    if(size > USBD_CDC_PKSZ) size = USBD_CDC_PKSZ;
+
+    if(size != 0 && (uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        buf = r->Buf[r->Head & USBD_CDC_SLOT_MASK];
+
+        for(i = 0; i < (size + 3) / 4; i++) {
+            buf[i] = USBD->RXBUF[i];
+        }
+
+        r->Len[r->Head & USBD_CDC_SLOT_MASK] = size;
+        r->Head++;
+        cdc_stats.RxPackets[port]++;
+    }
+
+    USBD_RxIntClr();
+
+    if((uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        USBD_RxReady(p->Ep);
+    } else {
+        p->RxPaused = 1;
+        cdc_stats.RxPaused[port]++;
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_RxResume()
+* 功能说明:	应用腾出包缓冲区后恢复被暂停的 OUT 端点
+* 输    入: USBD_CDC_Port_t *p	端口
+* 输    出: 无
+* 注意事项: 中断在缓冲区满时才置 RxPaused, 检查和恢复要屏蔽该端点
+******************************************************************************************************************************************/
+static void USBD_CDC_RxResume(USBD_CDC_Port_t *p) {
+    USBD_CDC_Ring_t *r = &p->Rx;
+    uint32_t epie = USBD_EPIntMask(1u << (p->Ep + 16));
+
+    if(p->RxPaused && (uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        p->RxPaused = 0;
+        USBD_RxReady(p->Ep);
+    }
+
+    USBD_EPIntRestore(epie);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_Reset()
+* 功能说明:	总线复位或 Set Configuration 时清空所有端口
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 在 USB 中断中调用
+******************************************************************************************************************************************/
+static void USBD_CDC_Reset(void) {
+    uint8_t i;
+
+    for(i = 0; i < USBD_CDC_PORT_NUM; i++) {
+        USBD_EPIntMask(1u << cdc_port[i].Ep);
+        memset(&cdc_port[i].Tx, 0, sizeof(USBD_CDC_Ring_t));
+        memset(&cdc_port[i].Rx, 0, sizeof(USBD_CDC_Ring_t));
+        cdc_port[i].TxBusy = 0;
+        cdc_port[i].TxZLP = 0;
+        cdc_port[i].RxPaused = 0;
+        cdc_port[i].RxOffset = 0;
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_ClassRequest()
+* 功能说明:	CDC 类请求
+* 输    入: USB_Setup_Packet_t * pSetup
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+static void USBD_CDC_ClassRequest(USB_Setup_Packet_t * pSetup) {
+    if(pSetup->wIndex != 0) {
+        USBD_Stall0();
+        return;
+    }
+
+    switch(pSetup->bRequest) {
+        case USBD_CDC_SET_LINE_CODING:
+            USBD_PrepareCtrlOut((uint8_t *)&cdc_line_coding, sizeof(cdc_line_coding));
+
+            /* Status stage */
+            USBD_TxWrite(0, 0, 0);
+            break;
+
+        case USBD_CDC_GET_LINE_CODING:
+            USBD_PrepareCtrlIn((uint8_t *)&cdc_line_coding, sizeof(cdc_line_coding));
+
+            /* Status stage */
+            USBD_RxReady(0);
+            break;
+
+        case USBD_CDC_SET_CONTROL_LINE_STATE:
+            cdc_line_state = pSetup->wValue & 0x03;
+
+            /* Status stage */
+            USBD_TxWrite(0, 0, 0);
+            break;
+
+        default:
+            USBD_Stall0();
+            break;
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_VendorRequest()
+* 功能说明:	厂商接口没有自定义控制请求, 一律 STALL
+* 输    入: USB_Setup_Packet_t * pSetup
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+static void USBD_CDC_VendorRequest(USB_Setup_Packet_t * pSetup) {
+    USBD_Stall0();
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_Init()
+* 功能说明:	初始化 USB 设备并连接主机
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void USBD_CDC_Init(void) {
+    cdc_port[USBD_CDC_PORT_ACM].Ep = USBD_CDC_ACM_EP;
+    cdc_port[USBD_CDC_PORT_VENDOR].Ep = USBD_CDC_VENDOR_EP;
+    cdc_configured = 0;
+
+    USBD_Info.Mode = USBD_MODE_DEV;
+    USBD_Info.Speed = USBD_SPEED_FS;
+    USBD_Info.CtrlPkSiz = 64;
+    USBD_Info.DescDevice = cdc_desc_device;
+    USBD_Info.DescConfig = cdc_desc_config;
+    USBD_Info.DescString = cdc_desc_string;
+    USBD_Info.pClassRequest_Callback = USBD_CDC_ClassRequest;
+    USBD_Info.pVendorRequest_Callback = USBD_CDC_VendorRequest;
+
+    USBD_Init();
+
+    /* IN 端点只在 FIFO 中有包时开中断; 通知端点不使用 */
+    USBD_EPIntMask((1u << USBD_CDC_NOTIFY_EP) | (1u << USBD_CDC_ACM_EP) | (1u << USBD_CDC_VENDOR_EP));
+
+    USBD_Open();
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_IsConfigured()
+* 功能说明:	主机是否已完成枚举
+* 输    入: 无
+* 输    出: uint8_t				1 已配置   0 未配置
+* 注意事项: 无
+******************************************************************************************************************************************/
+uint8_t USBD_CDC_IsConfigured(void) {
+    return cdc_configured;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_Write()
+* 功能说明:	写入要发送给主机的数据
+* 输    入: uint8_t port			USBD_CDC_PORT_ACM、USBD_CDC_PORT_VENDOR
+*			const uint8_t *data		数据
+*			uint32_t size			字节数
+* 输    出: uint32_t				实际写入的字节数, 缓冲区满时小于 size
+* 注意事项: 不需要凑整包, 端点空闲时未满的包也会立即发出
+******************************************************************************************************************************************/
+uint32_t USBD_CDC_Write(uint8_t port, const uint8_t *data, uint32_t size) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Tx;
+    uint32_t bit = 1u << p->Ep;
+    uint32_t done = 0;
+    uint32_t n;
+    uint8_t  slot;
+
+    if(!cdc_configured) return 0;
+
+    USBD_EPIntMask(bit);
+
+    while(done < size && (uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        slot = r->Head & USBD_CDC_SLOT_MASK;
+        n = USBD_CDC_PKSZ - r->Len[slot];
+
+        if(n > size - done) n = size - done;
+
+        memcpy((uint8_t *)r->Buf[slot] + r->Len[slot], data + done, n);
+        r->Len[slot] += n;
+        done += n;
+
+        if(r->Len[slot] == USBD_CDC_PKSZ) r->Head++;
+    }
+
+    if(!p->TxBusy) USBD_CDC_TxNext(p);
+
+    if(p->TxBusy) USBD_EPIntRestore(bit);
+
+    return done;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_TxAcquire()
+* 功能说明:	取一个空的包缓冲区, 由应用直接填入数据
+* 输    入: uint8_t port
+* 输    出: uint8_t *				字对齐的 USBD_CDC_PKSZ 字节缓冲区, 没有空位时为 NULL
+* 注意事项: 之前 USBD_CDC_Write 留下的未满包先排入发送队列; 取到后到 USBD_CDC_TxCommit 之前不要调用 USBD_CDC_Write
+******************************************************************************************************************************************/
+uint8_t *USBD_CDC_TxAcquire(uint8_t port) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Tx;
+    uint32_t bit = 1u << p->Ep;
+    uint8_t *buf = NULL;
+
+    if(!cdc_configured) return NULL;
+
+    USBD_EPIntMask(bit);
+
+    if(r->Len[r->Head & USBD_CDC_SLOT_MASK] != 0 && (uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        r->Head++;
+    }
+
+    if((uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS && r->Len[r->Head & USBD_CDC_SLOT_MASK] == 0) {
+        buf = (uint8_t *)r->Buf[r->Head & USBD_CDC_SLOT_MASK];
+    }
+
+    if(p->TxBusy) USBD_EPIntRestore(bit);
+
+    return buf;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_TxCommit()
+* 功能说明:	把 USBD_CDC_TxAcquire 取到的包排入发送队列
+* 输    入: uint8_t port
+*			uint32_t size			包长, 1 ~ USBD_CDC_PKSZ
+* 输    出: 无
+* 注意事项: size 为 0 时放弃该包
+******************************************************************************************************************************************/
+void USBD_CDC_TxCommit(uint8_t port, uint32_t size) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Tx;
+    uint32_t bit = 1u << p->Ep;
+
+    if(size == 0) return;
+
+    if(size > USBD_CDC_PKSZ) size = USBD_CDC_PKSZ;
+
+    USBD_EPIntMask(bit);
+
+    if((uint8_t)(r->Head - r->Tail) < USBD_CDC_SLOTS) {
+        r->Len[r->Head & USBD_CDC_SLOT_MASK] = size;
+        r->Head++;
+    }
+
+    if(!p->TxBusy) USBD_CDC_TxNext(p);
+
+    if(p->TxBusy) USBD_EPIntRestore(bit);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_TxFree()
+* 功能说明:	发送缓冲区剩余空间
+* 输    入: uint8_t port
+* 输    出: uint32_t				至少可以写入的字节数
+* 注意事项: 无
+******************************************************************************************************************************************/
+uint32_t USBD_CDC_TxFree(uint8_t port) {
+    USBD_CDC_Ring_t *r = &cdc_port[port].Tx;
+    uint8_t used = r->Head - r->Tail;
+
+    if(used >= USBD_CDC_SLOTS) return 0;
+
+    return (USBD_CDC_SLOTS - used) * USBD_CDC_PKSZ - r->Len[r->Head & USBD_CDC_SLOT_MASK];
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_Read()
+* 功能说明:	读取主机发来的数据
+* 输    入: uint8_t port
+*			uint8_t *buff			读取到的数据存入buff
+*			uint32_t size			buff大小
+* 输    出: uint32_t				实际读取的字节数
+* 注意事项: 腾出包缓冲区后恢复被暂停的端点
+******************************************************************************************************************************************/
+uint32_t USBD_CDC_Read(uint8_t port, uint8_t *buff, uint32_t size) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Rx;
+    uint32_t done = 0;
+    uint32_t n;
+    uint8_t  slot;
+
+    while(done < size && r->Tail != r->Head) {
+        slot = r->Tail & USBD_CDC_SLOT_MASK;
+        n = r->Len[slot] - p->RxOffset;
+
+        if(n > size - done) n = size - done;
+
+        memcpy(buff + done, (uint8_t *)r->Buf[slot] + p->RxOffset, n);
+        p->RxOffset += n;
+        done += n;
+
+        if(p->RxOffset == r->Len[slot]) {
+            p->RxOffset = 0;
+            r->Tail++;
+        }
+    }
+
+    USBD_CDC_RxResume(p);
+
+    return done;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_RxAcquire()
+* 功能说明:	取最早收到的一包, 由应用直接读取
+* 输    入: uint8_t port
+*			uint32_t *size			返回包中未读的字节数
+* 输    出: const uint8_t *		包数据, 没有数据时为 NULL
+* 注意事项: 读完后调用 USBD_CDC_RxRelease; 之前用 USBD_CDC_Read 读过一部分时从剩余部分开始
+******************************************************************************************************************************************/
+const uint8_t *USBD_CDC_RxAcquire(uint8_t port, uint32_t *size) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Rx;
+    uint8_t  slot = r->Tail & USBD_CDC_SLOT_MASK;
+
+    if(r->Tail == r->Head) {
+        *size = 0;
+        return NULL;
+    }
+
+    *size = r->Len[slot] - p->RxOffset;
+
+    return (const uint8_t *)r->Buf[slot] + p->RxOffset;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_RxRelease()
+* 功能说明:	归还 USBD_CDC_RxAcquire 取到的包
+* 输    入: uint8_t port
+* 输    出: 无
+* 注意事项: 腾出包缓冲区后恢复被暂停的端点
+******************************************************************************************************************************************/
+void USBD_CDC_RxRelease(uint8_t port) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Rx;
+
+    if(r->Tail == r->Head) return;
+
+    p->RxOffset = 0;
+    r->Tail++;
+
+    USBD_CDC_RxResume(p);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_RxAvail()
+* 功能说明:	已接收未读取的字节数
+* 输    入: uint8_t port
+* 输    出: uint32_t
+* 注意事项: 无
+******************************************************************************************************************************************/
+uint32_t USBD_CDC_RxAvail(uint8_t port) {
+    USBD_CDC_Port_t *p = &cdc_port[port];
+    USBD_CDC_Ring_t *r = &p->Rx;
+    uint32_t sum = 0;
+    uint8_t  i;
+
+    for(i = r->Tail; i != r->Head; i++) {
+        sum += r->Len[i & USBD_CDC_SLOT_MASK];
+    }
+
+    return (sum > p->RxOffset) ? sum - p->RxOffset : 0;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_GetLineCoding()
+* 功能说明:	读取主机设置的串口参数
+* 输    入: USBD_CDC_LineCoding_t *coding
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void USBD_CDC_GetLineCoding(USBD_CDC_LineCoding_t *coding) {
+    *coding = cdc_line_coding;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_GetLineState()
+* 功能说明:	读取 SET_CONTROL_LINE_STATE 设置的状态
+* 输    入: 无
+* 输    出: uint8_t				bit0 DTR   bit1 RTS
+* 注意事项: 串口终端打开端口时一般会置 DTR
+******************************************************************************************************************************************/
+uint8_t USBD_CDC_GetLineState(void) {
+    return cdc_line_state;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_CDC_GetStats()
+* 功能说明:	读取运行统计
+* 输    入: USBD_CDC_Stats_t *stats
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void USBD_CDC_GetStats(USBD_CDC_Stats_t *stats) {
+    *stats = cdc_stats;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USB_Handler()
+* 功能说明:	USB 中断服务程序
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 被屏蔽的端点不处理, 其标志保留到解除屏蔽后再进中断
+******************************************************************************************************************************************/
+void USB_Handler(void) {
+    uint32_t devif = USBD->DEVIF;
+    uint32_t epif  = USBD->EPIF & USBD->EPIE;
+    uint32_t epnr;
+    uint8_t  i;
+    bool     ok;
+
+    if(devif & USBD_DEVIF_RST_Msk) {
+        USBD->DEVIF = USBD_DEVIF_RST_Msk;
+
+        cdc_configured = 0;
+        USBD_CDC_Reset();
+    } else if(devif & USBD_DEVIF_SETCFG_Msk) {
+        USBD->DEVIF = USBD_DEVIF_SETCFG_Msk;
+
+        USBD_CDC_Reset();
+
+        for(i = 0; i < USBD_CDC_PORT_NUM; i++) {
+            USBD_RxReady(cdc_port[i].Ep);
+        }
+
+        cdc_configured = 1;
+    } else if(devif & USBD_DEVIF_SETUP_Msk) {
+        USBD->SETUPSR = USBD_SETUPSR_DONE_Msk;
+
+        if(USBD->SETUPSR & USBD_SETUPSR_SUCC_Msk) {
+            USBD_ProcessSetupPacket();
+        }
+    } else if(epif & USBD_EPIF_INEP0_Msk) {
+        if(USBD_TxSuccess(0)) {
+            USBD_CtrlIn();
+        }
+
+        USBD_TxIntClr(0);
+    } else if(epif & 0xFFFF0000) {
+        /* RXBUF 所有 OUT 端点共用, 以 RXSR 中的端点号为准 */
+        epnr = (USBD->RXSR & USBD_RXSR_EPNR_Msk) >> USBD_RXSR_EPNR_Pos;
+
+        if(epnr == 0) {
+            if(USBD_RxSuccess()) {
+                USBD_CtrlOut();
+            }
+
+            USBD_RxIntClr();
+        } else {
+            for(i = 0; i < USBD_CDC_PORT_NUM; i++) {
+                if(cdc_port[i].Ep == epnr && (epif & (1u << (epnr + 16)))) {
+                    if(USBD_RxSuccess()) {
+                        USBD_CDC_RxPacket(&cdc_port[i]);
+                    } else {
+                        USBD_RxIntClr();
+                        USBD_RxReady(epnr);
+                    }
+                }
+            }
+        }
+    } else {
+        for(i = 0; i < USBD_CDC_PORT_NUM; i++) {
+            if(epif & (1u << cdc_port[i].Ep)) {
+                ok = USBD_TxSuccess(cdc_port[i].Ep);
+                USBD_TxIntClr(cdc_port[i].Ep);
+
+                if(ok) {
+                    USBD_CDC_TxNext(&cdc_port[i]);
+                }
+            }
+        }
+    }
+}
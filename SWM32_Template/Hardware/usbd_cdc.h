@@ -0,0 +1,77 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@icloud.com
+  *
+  * FileName     : usbd_cdc.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : USB 全速设备 CDC-ACM 虚拟串口 + 厂商自定义 Bulk 接口
+                   每个 Bulk 端点在 RAM 中有 USBD_CDC_SLOTS 个按字对齐的包缓冲区,
+                   与端点 FIFO 组成乒乓: 一包在 FIFO 中发送/接收时, 下一包已在 RAM 中准备好.
+                   接口 0/1: CDC-ACM(端点 0x81 通知, 0x02/0x82 数据);
+                   接口 2:   厂商 Bulk(端点 0x03/0x83).
+  * Function List:
+                   USBD_CDC_Init
+                   USBD_CDC_IsConfigured
+                   USBD_CDC_Write
+                   USBD_CDC_TxFree
+                   USBD_CDC_TxAcquire
+                   USBD_CDC_TxCommit
+                   USBD_CDC_Read
+                   USBD_CDC_RxAcquire
+                   USBD_CDC_RxRelease
+                   USBD_CDC_RxAvail
+                   USBD_CDC_GetLineCoding
+                   USBD_CDC_GetLineState
+                   USBD_CDC_GetStats
+  ******************************************************
+**/
+
+#ifndef __USBD_CDC_H_
+#define __USBD_CDC_H_
+
+#include "SWM341.h"
+
+#define USBD_CDC_PKSZ           64      //Bulk 端点包长
+#define USBD_CDC_SLOTS          4       //每个方向的包缓冲区个数, 2 的幂, 至少为 2
+
+#define USBD_CDC_PORT_ACM       0       //CDC-ACM 虚拟串口
+#define USBD_CDC_PORT_VENDOR    1       //厂商 Bulk 接口
+#define USBD_CDC_PORT_NUM       2
+
+/* CDC 线路编码, 主机用 SET_LINE_CODING 设置 */
+typedef struct __attribute__((packed)) {
+    uint32_t dwDTERate;
+    uint8_t  bCharFormat;               //0: 1 位停止位, 1: 1.5 位, 2: 2 位
+    uint8_t  bParityType;               //0: 无, 1: 奇, 2: 偶, 3: Mark, 4: Space
+    uint8_t  bDataBits;
+} USBD_CDC_LineCoding_t;
+
+/* 运行统计 */
+typedef struct {
+    uint32_t TxPackets[USBD_CDC_PORT_NUM];
+    uint32_t TxZLP[USBD_CDC_PORT_NUM];      //自动补发的零长度包
+    uint32_t RxPackets[USBD_CDC_PORT_NUM];
+    uint32_t RxPaused[USBD_CDC_PORT_NUM];   //接收缓冲区满, 端点回 NAK 的次数
+} USBD_CDC_Stats_t;
+
+void USBD_CDC_Init(void);
+uint8_t USBD_CDC_IsConfigured(void);
+uint32_t USBD_CDC_Write(uint8_t port, const uint8_t *data, uint32_t size);
+uint32_t USBD_CDC_TxFree(uint8_t port);
+uint8_t *USBD_CDC_TxAcquire(uint8_t port);
+void USBD_CDC_TxCommit(uint8_t port, uint32_t size);
+uint32_t USBD_CDC_Read(uint8_t port, uint8_t *buff, uint32_t size);
+const uint8_t *USBD_CDC_RxAcquire(uint8_t port, uint32_t *size);
+void USBD_CDC_RxRelease(uint8_t port);
+uint32_t USBD_CDC_RxAvail(uint8_t port);
+void USBD_CDC_GetLineCoding(USBD_CDC_LineCoding_t *coding);
+uint8_t USBD_CDC_GetLineState(void);
+void USBD_CDC_GetStats(USBD_CDC_Stats_t *stats);
+
+#endif
@@ -395,6 +395,42 @@ void USBD_CtrlOut(void) {
 }
 
 
+/******************************************************************************************************************************************
+* 函数名称:	USBD_EPIntMask()
+* 功能说明:	屏蔽端点中断
+* 输    入: uint32_t mask			USBD->EPIE 中的位, IN 端点为 1 << epnr, OUT 端点为 1 << (epnr + 16)
+* 输    出: uint32_t				屏蔽前 mask 中已使能的位, 交给 USBD_EPIntRestore
+* 注意事项: EPIE 没有置位/清零寄存器, 中断服务程序也会改写它, 读改写只在关中断下进行, 只有几条指令;
+*			返回后被屏蔽的端点中断不会再进入
+******************************************************************************************************************************************/
+uint32_t USBD_EPIntMask(uint32_t mask) {
+    uint32_t primask = __get_PRIMASK();
+    uint32_t epie;
+
+    __disable_irq();
+    epie = USBD->EPIE;
+    USBD->EPIE = epie & ~mask;
+    __DSB();
+    __set_PRIMASK(primask);
+
+    return epie & mask;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_EPIntRestore()
+* 功能说明:	使能端点中断
+* 输    入: uint32_t mask			要使能的 USBD->EPIE 位
+* 输    出: 无
+* 注意事项: 同 USBD_EPIntMask
+******************************************************************************************************************************************/
+void USBD_EPIntRestore(uint32_t mask) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    USBD->EPIE |= mask;
+    __set_PRIMASK(primask);
+}
+
 /******************************************************************************************************************************************
 * 函数名称:	USBD_TxWrite()
 * 功能说明:	将要发送到主机的数据写入端点的 FIFO
@@ -402,20 +438,20 @@ void USBD_CtrlOut(void) {
 *			uint8_t *data			要写入FIFO 的数据
 *			uint16_t size			要写入数据的个数
 * 输    出: 无
-* 注意事项: 无
+* 注意事项: 拷贝期间只屏蔽该 IN 端点的中断
 ******************************************************************************************************************************************/
 void USBD_TxWrite(uint8_t epnr, uint8_t *data, uint16_t size) {
-    __disable_irq();
+    uint32_t epie = USBD_EPIntMask(1 << epnr);
 
     USBD->INEP[epnr].TXCR = (1 << USBD_TXCR_FLUSHFF_Pos);
 
     USBD->INEP[epnr].TXTRSZ = size;
 
-    if(size) USBD_memcpy((uint8_t *)USBD->TXBUF[epnr], data, size);
+    if(size) USBD_FifoWrite(USBD->TXBUF[epnr], data, size);
 
     USBD->INEP[epnr].TXCR = (1 << USBD_TXCR_FFRDY_Pos);
 
-    __enable_irq();
+    USBD_EPIntRestore(epie);
 }
 
 /******************************************************************************************************************************************
@@ -424,23 +460,73 @@ void USBD_TxWrite(uint8_t epnr, uint8_t *data, uint16_t size) {
 * 输    入: uint8_t *buff			读取到的数据存入buff
 *			uint16_t size			buff大小
 * 输    出: uint16_t				实际读取到数据的个数
-* 注意事项: 无
+* 注意事项: RXBUF 由所有 OUT 端点共用, 拷贝期间屏蔽全部 OUT 端点中断
 ******************************************************************************************************************************************/
 uint16_t USBD_RxRead(uint8_t *buff, uint16_t size) {
-    __disable_irq();
+    uint32_t epie = USBD_EPIntMask(0xFFFF0000);
 
     uint16_t real_size = (USBD->RXSR & USBD_RXSR_TRSZ_Msk) >> USBD_RXSR_TRSZ_Pos;
 
     if(size > real_size)
         size = real_size;
 
-    USBD_memcpy(buff, (uint8_t *)USBD->RXBUF, size);
+    USBD_FifoRead(buff, USBD->RXBUF, size);
 
-    __enable_irq();
+    USBD_EPIntRestore(epie);
 
     return size;
 }
 
+/******************************************************************************************************************************************
+* 函数名称:	USBD_FifoWrite()
+* 功能说明:	把数据按字写入 USB Buffer
+* 输    入: volatile uint32_t *fifo	USBD->TXBUF[epnr]
+*			const uint8_t *data		数据, 可不对齐
+*			uint32_t nByte			字节数
+* 输    出: 无
+* 注意事项: 末尾不足 4 字节的部分拼成一个字写入, USB Buffer 只有字访问
+******************************************************************************************************************************************/
+void USBD_FifoWrite(volatile uint32_t *fifo, const uint8_t *data, uint32_t nByte) {
+    uint32_t word, i;
+
+    if(((uintptr_t)data & 3) == 0) {
+        for(; nByte > 3; nByte -= 4, data += 4) *fifo++ = *((const uint32_t *)data);
+    } else {
+        for(; nByte > 3; nByte -= 4, data += 4) *fifo++ = __UNALIGNED_UINT32_READ(data);
+    }
+
+    if(nByte) {
+        for(word = 0, i = 0; i < nByte; i++) word |= (uint32_t)data[i] << (i * 8);
+
+        *fifo = word;
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	USBD_FifoRead()
+* 功能说明:	从 USB Buffer 按字读出数据
+* 输    入: uint8_t *buff			目的地址, 可不对齐
+*			volatile uint32_t *fifo	USBD->RXBUF
+*			uint32_t nByte			字节数
+* 输    出: 无
+* 注意事项: 末尾不足 4 字节时读一个字拆开, 不会写过 buff + nByte
+******************************************************************************************************************************************/
+void USBD_FifoRead(uint8_t *buff, volatile uint32_t *fifo, uint32_t nByte) {
+    uint32_t word;
+
+    if(((uintptr_t)buff & 3) == 0) {
+        for(; nByte > 3; nByte -= 4, buff += 4) *((uint32_t *)buff) = *fifo++;
+    } else {
+        for(; nByte > 3; nByte -= 4, buff += 4) __UNALIGNED_UINT32_WRITE(buff, *fifo++);
+    }
+
+    if(nByte) {
+        word = *fifo;
+
+        for(; nByte > 0; nByte--, word >>= 8) *buff++ = (uint8_t)word;
+    }
+}
+
 /******************************************************************************************************************************************
 * 函数名称:	USBD_memcpy()
 * 功能说明:	访问 USB Buffer 的 memcpy
@@ -448,7 +534,7 @@ uint16_t USBD_RxRead(uint8_t *buff, uint16_t size) {
 *			void *source			源地址
 *			uint32_t nByte			拷贝字节数
 * 输    出: 无
-* 注意事项: 访问 USB Buffer 必须使用 USBD_memcpy，不能使用库函数 memcpy
+* 注意事项: 访问 USB Buffer 必须使用 USBD_memcpy，不能使用库函数 memcpy; 收发 FIFO 优先用 USBD_FifoWrite/USBD_FifoRead
 ******************************************************************************************************************************************/
 void USBD_memcpy(uint8_t *destin, uint8_t *source, uint32_t nByte) {
     while(nByte > 3) {
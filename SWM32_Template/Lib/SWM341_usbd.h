@@ -109,6 +109,12 @@ void USBD_EPConfig(uint8_t ep_reg, uint8_t ep_nbr, uint8_t ep_dir, uint8_t ep_ty
 void USBD_TxWrite(uint8_t epnr, uint8_t *data, uint16_t size);
 uint16_t USBD_RxRead(uint8_t *buff, uint16_t size);
 
+uint32_t USBD_EPIntMask(uint32_t mask);
+void USBD_EPIntRestore(uint32_t mask);
+
+void USBD_FifoWrite(volatile uint32_t *fifo, const uint8_t *data, uint32_t nByte);
+void USBD_FifoRead(uint8_t *buff, volatile uint32_t *fifo, uint32_t nByte);
+
 void USBD_memcpy(uint8_t *destin, uint8_t *source, uint32_t nByte);
 
 #endif //__SWM341_USBD_H__
@@ -0,0 +1,787 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Hardware/usbd_cdc.c 的主机回放测试: 用主机编译器把 usbd_cdc.c 和 Lib/SWM341_usbd.c 与一个
+寄存器桩一起编译, 桩里 USBD/SYS 是 RAM 中的结构体(类型和位定义从 Core/SWM341.h 中提取),
+驱动程序扮演 USB 控制器和主机: 把 SETUP/OUT 包写进寄存器、置中断标志、调用 USB_Handler,
+从 TXBUF 取回 IN 包. EPIE 屏蔽的端点标志保留, 解除屏蔽后再进中断, 与硬件的电平中断一致.
+
+    usbd_cdc_test.py [--cc gcc] [--steps 20000] [--seed 1]
+        1. 按录制的 Windows usbser 枚举顺序回放 SETUP 包, 检查设备/配置/字符串描述符的结构,
+           不支持的标准、类、厂商请求必须 STALL;
+        2. SET/GET_LINE_CODING 往返, SET_CONTROL_LINE_STATE;
+        3. 两个 Bulk 端口: 各种长度的发送分包和自动零长度包, 零拷贝收发, 接收缓冲区满时 NAK
+           并在应用读走后恢复, 空闲 IN 端点被主机 NAK 时不进中断;
+        4. 随机交错主机 IN/OUT 和应用读写 --steps 步, 对照收发字节流和流控时机;
+        5. 总线复位后未配置, 重新配置后恢复.
+    usbd_cdc_test.py record > enum.txt
+        输出枚举和一次收发的命令与应答, 可手工编辑或换成抓包得到的 SETUP/OUT 序列
+    usbd_cdc_test.py replay enum.txt
+        逐行回放, 行中 "=>" 之后为期望应答, 不一致时报错
+
+命令(每行一条, 每条一行应答):
+    R                           总线复位
+    S rt rq wValue wIndex wLen  SETUP 包; SET_ADDRESS/SET_CONFIGURATION 由硬件处理, 这里按硬件行为模拟
+    I ep                        主机 IN 令牌: DATA n hex | NAK | STALL
+    O ep hex|-                  主机 OUT 包, - 为零长度包: ACK | NAK | STALL
+    W port hex                  USBD_CDC_Write, 应答实际写入的字节数
+    Z port hex                  USBD_CDC_TxAcquire + 填数据 + USBD_CDC_TxCommit: OK | NULL
+    D port max                  USBD_CDC_Read: DATA n hex
+    Q port                      USBD_CDC_RxAcquire + USBD_CDC_RxRelease: DATA n hex | NULL
+    F port / V port             USBD_CDC_TxFree / USBD_CDC_RxAvail
+    L / C / N                   线路编码和控制线状态 / 是否已配置 / 中断次数和中断风暴标志
+全部通过返回 0. 修改 usbd_cdc.c 或 SWM341_usbd.c 后运行一次.
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+DEVICE_HEADER = os.path.join(ROOT, 'Core', 'SWM341.h')
+SOURCES = [os.path.join(ROOT, 'Hardware', 'usbd_cdc.c'), os.path.join(ROOT, 'Lib', 'SWM341_usbd.c')]
+INCLUDES = [os.path.join(ROOT, 'Hardware'), os.path.join(ROOT, 'Lib')]
+
+PKSZ = 64
+PORT_EP = (2, 3)                # USBD_CDC_ACM_EP, USBD_CDC_VENDOR_EP
+MAX_REPORT = 20
+HW_REQUESTS = ((0x00, 0x05), (0x00, 0x09))     # SET_ADDRESS、SET_CONFIGURATION 连同状态阶段由硬件完成
+
+# 录制的 Windows usbser 枚举顺序: (bmRequestType, bRequest, wValue, wIndex, wLength, OUT 数据)
+ENUM_TRACE = [
+    (0x80, 0x06, 0x0100, 0x0000, 64, None),     # GET_DESCRIPTOR 设备, 先取 64 字节
+    'R',
+    (0x00, 0x05, 0x0011, 0x0000, 0, None),      # SET_ADDRESS
+    (0x80, 0x06, 0x0100, 0x0000, 18, None),
+    (0x80, 0x06, 0x0200, 0x0000, 9, None),      # 配置描述符头
+    (0x80, 0x06, 0x0200, 0x0000, 255, None),
+    (0x80, 0x06, 0x0300, 0x0000, 255, None),    # 语言
+    (0x80, 0x06, 0x0303, 0x0409, 255, None),    # 序列号
+    (0x80, 0x06, 0x0302, 0x0409, 255, None),    # 产品
+    (0x00, 0x09, 0x0001, 0x0000, 0, None),      # SET_CONFIGURATION 1
+    (0xA1, 0x21, 0x0000, 0x0000, 7, None),      # GET_LINE_CODING
+    (0x21, 0x22, 0x0000, 0x0000, 0, None),      # SET_CONTROL_LINE_STATE
+    (0x21, 0x20, 0x0000, 0x0000, 7, bytes([0x00, 0xC2, 0x01, 0x00, 0, 0, 8])),  # SET_LINE_CODING 115200
+    (0x21, 0x22, 0x0003, 0x0000, 0, None),      # DTR | RTS
+]
+
+STUB_HEAD = r'''
+#ifndef __SWM341_H__
+#define __SWM341_H__
+/* 主机测试用寄存器桩, 由 usbd_cdc_test.py 生成 */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+#define __INLINE inline
+
+extern uint32_t sim_primask;
+extern uint32_t CyclesPerUs;
+#define __NOP()                 ((void)0)
+#define __DSB()                 ((void)0)
+#define __get_PRIMASK()         (sim_primask)
+#define __set_PRIMASK(x)        (sim_primask = (x))
+#define __disable_irq()         (sim_primask = 1)
+#define __enable_irq()          (sim_primask = 0)
+static inline uint32_t __UNALIGNED_UINT32_READ(const void *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+#define __UNALIGNED_UINT32_WRITE(p, v)  do { uint32_t _v = (v); memcpy((p), &_v, 4); } while(0)
+#define USB_IRQn                77
+#define NVIC_EnableIRQ(n)       ((void)(n))
+#define NVIC_DisableIRQ(n)      ((void)(n))
+'''
+
+STUB_TAIL = r'''
+/* RAM 不能模拟写 1 清零: 处理程序写 DONE 后紧接着读 SUCC, 这里让写入的值保留 SUCC */
+#undef  USBD_SETUPSR_DONE_Msk
+#define USBD_SETUPSR_DONE_Msk   ((0x01 << USBD_SETUPSR_DONE_Pos) | USBD_SETUPSR_SUCC_Msk)
+
+extern USBD_TypeDef usbd_sim;
+extern SYS_TypeDef sys_sim;
+#define USBD    (&usbd_sim)
+#define SYS     (&sys_sim)
+
+#include "SWM341_usb.h"
+#include "SWM341_usbd.h"
+
+#endif
+'''
+
+DRIVER = r'''
+#include "SWM341.h"
+#include "usbd_cdc.h"
+
+USBD_TypeDef usbd_sim;
+SYS_TypeDef sys_sim;
+uint32_t sim_primask;
+uint32_t CyclesPerUs = 1;
+
+void USB_Handler(void);
+
+static unsigned irq_count, irq_storm;
+
+/* 有已使能的端点标志就进中断; 处理程序改写了状态寄存器即视为清除了标志 */
+static void sim_irq(void) {
+    uint32_t txsr[16], rxsr, ep;
+    int n;
+
+    for(n = 0; (USBD->EPIF & USBD->EPIE) != 0; n++) {
+        if(n == 64) { irq_storm = 1; return; }
+
+        for(ep = 0; ep < 16; ep++) txsr[ep] = USBD->INEP[ep].TXSR;
+        rxsr = USBD->RXSR;
+
+        irq_count++;
+        USB_Handler();
+
+        for(ep = 0; ep < 16; ep++) {
+            if((USBD->EPIF & (1u << ep)) && USBD->INEP[ep].TXSR != txsr[ep]) {
+                USBD->EPIF &= ~(1u << ep);
+                USBD->INEP[ep].TXSR = 0;
+            }
+        }
+
+        if((USBD->EPIF & 0xFFFF0000) && USBD->RXSR != rxsr) {
+            USBD->EPIF &= 0x0000FFFF;
+            USBD->RXSR = 0;
+        }
+    }
+}
+
+static void sim_dev_event(uint32_t flag) {
+    USBD->DEVIF = flag;
+    irq_count++;
+    USB_Handler();
+    USBD->DEVIF = 0;
+}
+
+static int parse_hex(const char *s, uint8_t *buf) {
+    int n = 0;
+    unsigned v;
+
+    if(s[0] == '-') return 0;
+
+    while(sscanf(s, "%2x", &v) == 1 && n < 1024) {
+        buf[n++] = (uint8_t)v;
+        s += 2;
+        if(*s == 0 || *s == '\n' || *s == ' ') break;
+    }
+
+    return n;
+}
+
+static void print_data(const uint8_t *buf, uint32_t n) {
+    uint32_t i;
+
+    printf("DATA %u ", (unsigned)n);
+    if(n == 0) printf("-");
+    for(i = 0; i < n; i++) printf("%02x", buf[i]);
+    printf("\n");
+}
+
+static int ep0_stalled(void) {
+    return (USBD->INEP[0].TXCR & USBD_TXCR_SNDSTALL_Msk) || (USBD->OUTEP[0].RXCR & USBD_RXCR_SNDSTALL_Msk);
+}
+
+int main(void) {
+    char line[2300], hex[2100];
+    uint8_t buf[1024];
+    unsigned a[5];
+    uint32_t n, i;
+    uint8_t *p;
+    const uint8_t *q;
+    USBD_CDC_LineCoding_t lc;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    USBD_CDC_Init();
+
+    while(fgets(line, sizeof(line), stdin)) {
+        hex[0] = 0;
+
+        switch(line[0]) {
+            case 'R':
+                sim_dev_event(USBD_DEVIF_RST_Msk);
+                printf("OK\n");
+                break;
+
+            case 'S':
+                if(sscanf(line + 1, "%i %i %i %i %i", &a[0], &a[1], &a[2], &a[3], &a[4]) != 5) return 2;
+
+                /* 新的 SETUP 清除端点 0 的 STALL */
+                USBD->INEP[0].TXCR &= ~USBD_TXCR_SNDSTALL_Msk;
+                USBD->OUTEP[0].RXCR &= ~USBD_RXCR_SNDSTALL_Msk;
+
+                if(a[0] == 0x00 && (a[1] == 0x05 || a[1] == 0x09)) {
+                    if(a[1] == 0x09) sim_dev_event(USBD_DEVIF_SETCFG_Msk);
+                    printf("OK\n");
+                    break;
+                }
+
+                USBD->SETUPD1 = a[0] | (a[1] << 8) | (a[2] << 16);
+                USBD->SETUPD2 = a[3] | (a[4] << 16);
+                USBD->SETUPSR = USBD_SETUPSR_SUCC_Msk | (0x01 << USBD_SETUPSR_DONE_Pos);
+                sim_dev_event(USBD_DEVIF_SETUP_Msk);
+                printf(ep0_stalled() ? "STALL\n" : "OK\n");
+                break;
+
+            case 'I':
+                if(sscanf(line + 1, "%u", &a[0]) != 1 || a[0] > 15) return 2;
+
+                if(USBD->INEP[a[0]].TXCR & USBD_TXCR_SNDSTALL_Msk) {
+                    printf("STALL\n");
+                } else if(USBD->INEP[a[0]].TXCR & USBD_TXCR_FFRDY_Msk) {
+                    n = USBD->INEP[a[0]].TXTRSZ;
+                    memcpy(buf, (const void *)USBD->TXBUF[a[0]], n);
+                    USBD->INEP[a[0]].TXCR = 0;
+                    USBD->INEP[a[0]].TXSR |= USBD_TXSR_SUCC_Msk | USBD_TXSR_DATSNT_Msk;
+                    USBD->EPIF |= 1u << a[0];
+                    print_data(buf, n);
+                } else {
+                    USBD->INEP[a[0]].TXSR |= USBD_TXSR_NAKSNT_Msk;
+                    USBD->EPIF |= 1u << a[0];
+                    printf("NAK\n");
+                }
+
+                sim_irq();
+                break;
+
+            case 'O':
+                if(sscanf(line + 1, "%u %2099s", &a[0], hex) != 2 || a[0] > 15) return 2;
+
+                n = parse_hex(hex, buf);
+
+                if(USBD->OUTEP[a[0]].RXCR & USBD_RXCR_SNDSTALL_Msk) {
+                    printf("STALL\n");
+                } else if((USBD->OUTEP[a[0]].RXCR & USBD_RXCR_FFRDY_Msk) && (USBD->EPIF & 0xFFFF0000) == 0) {
+                    memset((void *)USBD->RXBUF, 0xEE, 128);
+                    memcpy((void *)USBD->RXBUF, buf, n);
+                    USBD->OUTEP[a[0]].RXCR = 0;
+                    USBD->RXSR = (n << USBD_RXSR_TRSZ_Pos) | (a[0] << USBD_RXSR_EPNR_Pos) |
+                                 USBD_RXSR_SUCC_Msk | USBD_RXSR_DONE_Msk;
+                    USBD->EPIF |= 1u << (a[0] + 16);
+                    printf("ACK\n");
+                } else {
+                    printf("NAK\n");
+                }
+
+                sim_irq();
+                break;
+
+            case 'W':
+                if(sscanf(line + 1, "%u %2099s", &a[0], hex) != 2) return 2;
+
+                n = parse_hex(hex, buf);
+                printf("%u\n", (unsigned)USBD_CDC_Write(a[0], buf, n));
+                sim_irq();
+                break;
+
+            case 'Z':
+                if(sscanf(line + 1, "%u %2099s", &a[0], hex) != 2) return 2;
+
+                n = parse_hex(hex, buf);
+                p = USBD_CDC_TxAcquire(a[0]);
+
+                if(p == NULL) {
+                    printf("NULL\n");
+                } else if(((uintptr_t)p & 3) != 0) {
+                    printf("UNALIGNED\n");
+                } else {
+                    memcpy(p, buf, n);
+                    USBD_CDC_TxCommit(a[0], n);
+                    printf("OK\n");
+                }
+
+                sim_irq();
+                break;
+
+            case 'D':
+                if(sscanf(line + 1, "%u %u", &a[0], &a[1]) != 2 || a[1] > sizeof(buf)) return 2;
+
+                print_data(buf, USBD_CDC_Read(a[0], buf, a[1]));
+                sim_irq();
+                break;
+
+            case 'Q':
+                if(sscanf(line + 1, "%u", &a[0]) != 1) return 2;
+
+                q = USBD_CDC_RxAcquire(a[0], &n);
+
+                if(q == NULL) {
+                    printf("NULL\n");
+                } else {
+                    print_data(q, n);
+                    USBD_CDC_RxRelease(a[0]);
+                }
+
+                sim_irq();
+                break;
+
+            case 'F':
+            case 'V':
+                if(sscanf(line + 1, "%u", &a[0]) != 1) return 2;
+
+                printf("%u\n", (unsigned)(line[0] == 'F' ? USBD_CDC_TxFree(a[0]) : USBD_CDC_RxAvail(a[0])));
+                break;
+
+            case 'L':
+                USBD_CDC_GetLineCoding(&lc);
+                printf("%u %u %u %u %u\n", (unsigned)lc.dwDTERate, lc.bCharFormat, lc.bParityType, lc.bDataBits,
+                       USBD_CDC_GetLineState());
+                break;
+
+            case 'C':
+                printf("%u\n", USBD_CDC_IsConfigured());
+                break;
+
+            case 'N':
+                printf("%u %u %u\n", irq_count, irq_storm, (unsigned)sim_primask);
+                break;
+
+            default:
+                for(i = 0; line[i] == ' ' || line[i] == '\n'; i++);
+                if(line[i] == 0) break;
+                return 2;
+        }
+    }
+
+    return 0;
+}
+'''
+
+
+def build_stub(tmp):
+    text = open(DEVICE_HEADER, encoding='utf-8', errors='replace').read()
+    out = [STUB_HEAD]
+    for name in ('SYS_TypeDef', 'USBD_TypeDef'):
+        end = text.index('} %s;' % name)
+        start = text.rindex('typedef struct {', 0, end)
+        out.append(text[start:end] + '} %s;\n' % name)
+    for m in re.finditer(r'^#define\s+(USBD|SYS)_\w+\s+.*$', text, re.M):
+        if '_BASE' not in m.group(0):
+            out.append(m.group(0))
+    out.append(STUB_TAIL)
+    with open(os.path.join(tmp, 'SWM341.h'), 'w', encoding='utf-8') as f:
+        f.write('\n'.join(out))
+
+
+def build(cc, tmp):
+    build_stub(tmp)
+    driver = os.path.join(tmp, 'driver.c')
+    exe = os.path.join(tmp, 'usbd_cdc_test')
+    with open(driver, 'w') as f:
+        f.write(DRIVER)
+    cmd = [cc, '-std=gnu99', '-O1', '-Wall', '-Wno-unused-function', '-Wno-sign-compare', '-I', tmp]
+    for inc in INCLUDES:
+        cmd += ['-I', inc]
+    cmd += SOURCES + [driver, '-o', exe]
+    r = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if r.returncode != 0:
+        print(' '.join(cmd))
+        print(r.stdout)
+        return None
+    return exe
+
+
+class Device:
+    def __init__(self, exe, log=None):
+        self.p = subprocess.Popen([exe], stdin=subprocess.PIPE, stdout=subprocess.PIPE, universal_newlines=True)
+        self.log = log
+
+    def cmd(self, line):
+        self.p.stdin.write(line + '\n')
+        self.p.stdin.flush()
+        r = self.p.stdout.readline().strip()
+        if not r:
+            raise RuntimeError('驱动异常退出, 命令: %s' % line)
+        if self.log is not None:
+            self.log.append('%-40s => %s' % (line, r))
+        return r
+
+    def close(self):
+        self.p.stdin.close()
+        self.p.wait()
+
+    @staticmethod
+    def data(r):
+        if not r.startswith('DATA '):
+            return None
+        h = r.split()[2]
+        return b'' if h == '-' else bytes.fromhex(h)
+
+    def setup(self, rt, rq, wv, wi, wl):
+        return self.cmd('S %#x %#x %#x %#x %d' % (rt, rq, wv, wi, wl))
+
+    def inp(self, ep):
+        return self.cmd('I %d' % ep)
+
+    def out(self, ep, data):
+        return self.cmd('O %d %s' % (ep, data.hex() if data else '-'))
+
+    def write(self, port, data):
+        return int(self.cmd('W %d %s' % (port, data.hex() if data else '-')))
+
+    def read(self, port, n):
+        buf = b''
+        while n > 0:
+            d = self.data(self.cmd('D %d %d' % (port, min(n, 1024))))
+            buf += d
+            n -= len(d)
+            if not d:
+                break
+        return buf
+
+    def value(self, c, port=None):
+        return self.cmd(c if port is None else '%s %d' % (c, port))
+
+
+class Checker:
+    def __init__(self):
+        self.total = 0
+        self.bad = 0
+
+    def __call__(self, ok, what):
+        self.total += 1
+        if not ok:
+            if self.bad < MAX_REPORT:
+                print('失败: %s' % what)
+            self.bad += 1
+        return ok
+
+
+def control(dev, chk, rt, rq, wv, wi, wl, data=None):
+    """一次控制传输, 返回 IN 数据; STALL 时返回 None"""
+    what = 'SETUP %02x %02x %04x %04x %d' % (rt, rq, wv, wi, wl)
+    if dev.setup(rt, rq, wv, wi, wl) == 'STALL':
+        return None
+    if (rt, rq) in HW_REQUESTS:
+        return b''
+    if rt & 0x80:
+        buf = b''
+        while len(buf) < wl:
+            pkt = dev.data(dev.inp(0))
+            if not chk(pkt is not None, what + ': 数据阶段没有数据'):
+                return buf
+            buf += pkt
+            if len(pkt) < PKSZ:
+                break
+        chk(dev.out(0, b'') == 'ACK', what + ': 状态阶段 OUT 未应答')
+        return buf
+    for i in range(0, len(data or b''), PKSZ):
+        chk(dev.out(0, data[i:i + PKSZ]) == 'ACK', what + ': 数据阶段 OUT 未应答')
+    chk(dev.data(dev.inp(0)) == b'', what + ': 状态阶段不是零长度包')
+    return b''
+
+
+def check_descriptors(chk, dev_desc, cfg, strings):
+    chk(len(dev_desc) == 18 and dev_desc[0] == 18 and dev_desc[1] == 1, '设备描述符长度或类型错误: %s' % dev_desc.hex())
+    if len(dev_desc) == 18:
+        chk(dev_desc[4:7] == bytes([0xEF, 0x02, 0x01]), '复合设备须为 EF/02/01')
+        chk(dev_desc[7] == PKSZ, 'bMaxPacketSize0 应为 64')
+        chk(dev_desc[17] == 1, 'bNumConfigurations 应为 1')
+
+    chk(len(cfg) >= 9 and cfg[1] == 2, '配置描述符类型错误')
+    total = cfg[2] | (cfg[3] << 8) if len(cfg) >= 4 else 0
+    chk(total == len(cfg), 'wTotalLength %d 与收到的 %d 字节不符' % (total, len(cfg)))
+    pos, intfs, eps, iad = 0, set(), {}, []
+    while pos < len(cfg):
+        n = cfg[pos]
+        if not chk(n >= 2 and pos + n <= len(cfg), '描述符链在偏移 %d 处断开' % pos):
+            break
+        t = cfg[pos + 1]
+        if t == 4:
+            intfs.add(cfg[pos + 2])
+        elif t == 5:
+            eps[cfg[pos + 2]] = (cfg[pos + 3], cfg[pos + 4] | (cfg[pos + 5] << 8))
+        elif t == 0x0B:
+            iad.append((cfg[pos + 2], cfg[pos + 3]))
+        pos += n
+    chk(cfg[4] == len(intfs) == 3, 'bNumInterfaces %d, 接口 %s' % (cfg[4], sorted(intfs)))
+    chk(iad == [(0, 2)], 'IAD 应把接口 0、1 组成一个功能: %s' % iad)
+    want = {0x81: 3, 0x02: 2, 0x82: 2, 0x03: 2, 0x83: 2}
+    chk({k: v[0] for k, v in eps.items()} == want, '端点表 %s' % eps)
+    for addr, (typ, size) in eps.items():
+        if typ == 2:
+            chk(size == PKSZ, '端点 %02x 包长 %d' % (addr, size))
+
+    for idx, s in strings.items():
+        if chk(s is not None and len(s) >= 2 and s[0] == len(s) and s[1] == 3, '字符串 %d 格式错误' % idx) and idx:
+            chk(len(s) % 2 == 0, '字符串 %d 不是 UTF-16' % idx)
+    chk(strings.get(0) == bytes([4, 3, 0x09, 0x04]), '语言 ID 应为 0x0409')
+
+
+def enumerate_dev(dev, chk):
+    dev_desc, cfg, strings = b'', b'', {}
+    for step in ENUM_TRACE:
+        if step == 'R':
+            dev.cmd('R')
+            continue
+        rt, rq, wv, wi, wl, data = step
+        r = control(dev, chk, rt, rq, wv, wi, wl, data)
+        chk(r is not None, '枚举请求 %02x %02x %04x 被 STALL' % (rt, rq, wv))
+        if (rt, rq) == (0x80, 0x06):
+            kind, idx = wv >> 8, wv & 0xFF
+            if kind == 1:
+                dev_desc = r
+            elif kind == 2 and wl > 9:
+                cfg = r
+            elif kind == 3:
+                strings[idx] = r
+        elif (rt, rq) == (0xA1, 0x21):
+            chk(r is not None and len(r) == 7, 'GET_LINE_CODING 应返回 7 字节')
+    for idx in (1, 2):
+        strings[idx] = control(dev, chk, 0x80, 0x06, 0x0300 | idx, 0x0409, 255)
+    check_descriptors(chk, dev_desc, cfg, strings)
+    chk(dev.value('C') == '1', 'SET_CONFIGURATION 后未进入已配置状态')
+
+
+def test_requests(dev, chk):
+    chk(control(dev, chk, 0x80, 0x06, 0x0307, 0x0409, 255) is None, '不存在的字符串 7 应 STALL')
+    chk(control(dev, chk, 0x80, 0x06, 0x0600, 0, 10) is None, 'Device Qualifier 应 STALL')
+    chk(control(dev, chk, 0x21, 0x20, 0, 2, 7, bytes(7)) is None, '发给接口 2 的 CDC 类请求应 STALL')
+    chk(control(dev, chk, 0x41, 0x01, 0, 2, 0) is None, '厂商请求应 STALL')
+    chk(control(dev, chk, 0x21, 0x7F, 0, 0, 0) is None, '未知 CDC 请求应 STALL')
+
+    coding = bytes([0x00, 0x10, 0x0E, 0x00, 2, 2, 7])       # 921600 2 停止位 偶校验 7 位
+    control(dev, chk, 0x21, 0x20, 0, 0, 7, coding)
+    chk(dev.value('L').split()[:4] == ['921600', '2', '2', '7'], 'SET_LINE_CODING 后 %s' % dev.value('L'))
+    chk(control(dev, chk, 0xA1, 0x21, 0, 0, 7) == coding, 'GET_LINE_CODING 与设置值不同')
+    control(dev, chk, 0x21, 0x22, 0x0001, 0, 0)
+    chk(dev.value('L').split()[4] == '1', 'SET_CONTROL_LINE_STATE 后状态 %s' % dev.value('L'))
+    control(dev, chk, 0x21, 0x22, 0x0003, 0, 0)
+
+
+def drain_in(dev, port, limit=1000):
+    """IN 直到 NAK, 返回包列表"""
+    pkts = []
+    for _ in range(limit):
+        d = dev.data(dev.inp(PORT_EP[port]))
+        if d is None:
+            break
+        pkts.append(d)
+    return pkts
+
+
+def check_packets(chk, pkts, what):
+    for i, p in enumerate(pkts):
+        if i + 1 < len(pkts) and len(p) < PKSZ and len(pkts[i + 1]) == 0:
+            chk(False, '%s: 短包后不应补零长度包' % what)
+        if len(p) == 0:
+            chk(i > 0 and len(pkts[i - 1]) == PKSZ, '%s: 零长度包前一包不是满包' % what)
+    if pkts:
+        chk(len(pkts[-1]) < PKSZ, '%s: 以满包结束时没有补零长度包' % what)
+
+
+def test_bulk(dev, chk, rnd):
+    for port in (0, 1):
+        ep = PORT_EP[port]
+        irq = int(dev.value('N').split()[0])
+        for _ in range(5):
+            chk(dev.inp(ep) == 'NAK', '端口 %d 空闲时 IN 应 NAK' % port)
+        chk(int(dev.value('N').split()[0]) == irq, '端口 %d 空闲 IN 端点被 NAK 时进了中断' % port)
+
+        for size in (1, 3, 63, 64, 65, 127, 128, 200, 256):
+            data = bytes(rnd.randrange(256) for _ in range(size))
+            chk(dev.write(port, data) == size, '端口 %d 写 %d 字节未全部接受' % (port, size))
+            pkts = drain_in(dev, port)
+            chk(b''.join(pkts) == data, '端口 %d 发送 %d 字节内容不符' % (port, size))
+            check_packets(chk, pkts, '端口 %d 发送 %d 字节' % (port, size))
+            chk(all(len(p) == PKSZ for p in pkts[:-2]), '端口 %d 发送 %d 字节时中间出现短包' % (port, size))
+
+        free = int(dev.value('F', port))
+        data = bytes(rnd.randrange(256) for _ in range(1000))
+        n = dev.write(port, data)
+        chk(n == free, '端口 %d 缓冲区可写 %d, 实际接受 %d' % (port, free, n))
+        chk(b''.join(drain_in(dev, port)) == data[:n], '端口 %d 写满后发送内容不符' % port)
+
+        for size in (10, 64):
+            data = bytes(range(size))
+            chk(dev.cmd('Z %d %s' % (port, data.hex())) == 'OK', '端口 %d 零拷贝取不到包缓冲区' % port)
+            pkts = drain_in(dev, port)
+            chk(b''.join(pkts) == data, '端口 %d 零拷贝发送内容不符' % port)
+            check_packets(chk, pkts, '端口 %d 零拷贝 %d 字节' % (port, size))
+
+        sent, acks = b'', 0
+        for i in range(20):
+            pkt = bytes((i * 7 + k) & 0xFF for k in range(PKSZ))
+            if dev.out(ep, pkt) != 'ACK':
+                break
+            sent += pkt
+            acks += 1
+        chk(acks == 4, '端口 %d 接收缓冲区应容纳 4 包后 NAK, 实际 %d' % (port, acks))
+        chk(int(dev.value('V', port)) == len(sent), '端口 %d RxAvail 与收到的字节数不符' % port)
+        chk(dev.out(ep, bytes(8)) == 'NAK', '端口 %d 缓冲区满时应 NAK' % port)
+        got = dev.data(dev.cmd('Q %d' % port))
+        chk(dev.out(ep, b'\x55' * 5) == 'ACK', '端口 %d 归还一包后未恢复接收' % port)
+        got += dev.read(port, 1000)
+        chk(got == sent + b'\x55' * 5, '端口 %d 接收内容不符' % port)
+        chk(dev.cmd('Q %d' % port) == 'NULL', '端口 %d 读空后 RxAcquire 应为 NULL' % port)
+
+
+def test_random(dev, chk, rnd, steps):
+    """随机交错, 对照字节流和流控"""
+    tx_model = [b'', b'']           # 应用已写入, 主机未收到
+    rx_pkts = [[], []]              # 设备中未读完的包, 与 USBD_CDC_SLOTS 比较
+    rx_expect = [b'', b'']
+    rx_got = [b'', b'']
+    prev_len = [None, None]
+    for step in range(steps):
+        port = rnd.randrange(2)
+        ep = PORT_EP[port]
+        op = rnd.randrange(7)
+        where = '第 %d 步 端口 %d' % (step, port)
+        if op == 0:
+            d = dev.data(dev.inp(ep))
+            if d is None:
+                chk(tx_model[port] == b'' and prev_len[port] != PKSZ, where + ': 有未发数据或待补零长度包时 NAK')
+                continue
+            chk(tx_model[port].startswith(d), where + ': IN 数据与写入的不符')
+            if len(d) == 0:
+                chk(prev_len[port] == PKSZ, where + ': 多余的零长度包')
+            tx_model[port] = tx_model[port][len(d):]
+            prev_len[port] = len(d)
+        elif op == 1:
+            n = rnd.choice((0, 1, 17, 63, 64, rnd.randrange(1, PKSZ + 1)))
+            d = bytes(rnd.randrange(256) for _ in range(n))
+            r = dev.out(ep, d)
+            full = len(rx_pkts[port]) >= 4
+            chk((r == 'NAK') == full, where + ': OUT 应答 %s, 缓冲区 %d 包' % (r, len(rx_pkts[port])))
+            if r == 'ACK' and n:
+                rx_pkts[port].append(n)
+                rx_expect[port] += d
+        elif op == 2:
+            d = bytes(rnd.randrange(256) for _ in range(rnd.randrange(300)))
+            n = dev.write(port, d)
+            chk(n <= len(d), where + ': Write 返回值过大')
+            tx_model[port] += d[:n]
+        elif op == 3:
+            d = bytes(rnd.randrange(256) for _ in range(rnd.randrange(1, PKSZ + 1)))
+            if dev.cmd('Z %d %s' % (port, d.hex())) == 'OK':
+                tx_model[port] += d
+        elif op in (4, 5):
+            d = dev.read(port, rnd.randrange(1, 200)) if op == 4 else dev.data(dev.cmd('Q %d' % port)) or b''
+            rx_got[port] += d
+            left = len(d)
+            while left and rx_pkts[port]:
+                take = min(left, rx_pkts[port][0])
+                rx_pkts[port][0] -= take
+                left -= take
+                if rx_pkts[port][0] == 0:
+                    rx_pkts[port].pop(0)
+        else:
+            chk(int(dev.value('V', port)) == sum(rx_pkts[port]), where + ': RxAvail 与未读字节数不符')
+    for port in (0, 1):
+        pkts = drain_in(dev, port)
+        data = b''.join(pkts)
+        chk(data == tx_model[port], '端口 %d 结束时剩余发送数据不符' % port)
+        if pkts:
+            chk(len(pkts[-1]) < PKSZ, '端口 %d 结束时以满包结束' % port)
+        rx_got[port] += dev.read(port, 100000)
+        chk(rx_got[port] == rx_expect[port], '端口 %d 接收字节流不符' % port)
+
+
+def test_reset(dev, chk):
+    dev.write(0, b'abc')
+    dev.cmd('R')
+    chk(dev.value('C') == '0', '总线复位后仍为已配置')
+    chk(dev.write(0, b'x') == 0, '未配置时 Write 应返回 0')
+    chk(dev.inp(PORT_EP[0]) in ('NAK', 'DATA 3 616263'), '复位后 IN 端点状态异常')
+    control(dev, chk, 0x00, 0x09, 1, 0, 0)
+    chk(dev.value('C') == '1', '重新配置失败')
+    chk(dev.write(0, b'ok') == 2 and drain_in(dev, 0) == [b'ok'], '重新配置后发送失败')
+
+
+def run_tests(exe, args):
+    chk = Checker()
+    rnd = random.Random(args.seed)
+    dev = Device(exe)
+    try:
+        enumerate_dev(dev, chk)
+        test_requests(dev, chk)
+        test_bulk(dev, chk, rnd)
+        test_random(dev, chk, rnd, args.steps)
+        test_reset(dev, chk)
+        irq, storm, primask = (int(v) for v in dev.value('N').split())
+        chk(storm == 0, '出现中断风暴: 已使能的端点标志没有被清除')
+        chk(primask == 0, 'PRIMASK 未恢复')
+    finally:
+        dev.close()
+    print('%d 项, 失败 %d 项, 中断 %d 次' % (chk.total, chk.bad, irq))
+    return 1 if chk.bad else 0
+
+
+def record(exe, args):
+    log = []
+    dev = Device(exe, log)
+    chk = Checker()
+    try:
+        enumerate_dev(dev, chk)
+        dev.write(0, b'hello')
+        drain_in(dev, 0)
+        dev.out(PORT_EP[1], b'\x01\x02\x03')
+        dev.read(1, 64)
+    finally:
+        dev.close()
+    print('# usbd_cdc_test.py record 生成, 可用 usbd_cdc_test.py replay 回放')
+    print('\n'.join(log))
+    return 1 if chk.bad else 0
+
+
+def replay(exe, path):
+    dev = Device(exe)
+    bad = total = 0
+    try:
+        for no, line in enumerate(open(path, encoding='utf-8'), 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            cmd, _, want = (s.strip() for s in line.partition('=>'))
+            r = dev.cmd(cmd)
+            total += 1
+            if want and r != want:
+                bad += 1
+                if bad <= MAX_REPORT:
+                    print('%s:%d: %s => %s, 应为 %s' % (path, no, cmd, r, want))
+            elif not want:
+                print('%-40s => %s' % (cmd, r))
+    finally:
+        dev.close()
+    print('%d 条, 不一致 %d 条' % (total, bad))
+    return 1 if bad else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('mode', nargs='?', default='test', choices=('test', 'record', 'replay'))
+    ap.add_argument('file', nargs='?')
+    ap.add_argument('--cc', default=os.environ.get('CC', 'gcc'))
+    ap.add_argument('--steps', type=int, default=20000)
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(args.cc, tmp)
+        if exe is None:
+            return 1
+        if args.mode == 'record':
+            return record(exe, args)
+        if args.mode == 'replay':
+            if not args.file:
+                ap.error('replay 需要文件')
+            return replay(exe, args.file)
+        return run_tests(exe, args)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())